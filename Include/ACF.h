@@ -1120,6 +1120,11 @@ Contributions are welcome! To contribute:
 	- Write to a memory block - iser::CMemoryWriteArchive
 	- Read from a binary file - ifile::CFileReadArchive
 	- Write to a binary file - ifile::CFileWriteArchive
+	- Read from a memory mapped binary file - ifile::CMappedFileReadArchive
+	- Read from a block compressed binary file - ifile::CBlockCompressedFileReadArchive
+	- Write to a block compressed binary file - ifile::CBlockCompressedFileWriteArchive
+	- Read from an encoded binary file - ifile::CFileReadSecureArchive
+	- Write to an encoded binary file - ifile::CFileWriteSecureArchive
 	- Read from a fast parsed XML document given as a string - iser::CXmlStringReadArchive
 	- Write to a fast parsed XML-string - iser::CXmlStringWriteArchive
 	- Read from a fast parsed XML file - ifile::CSimpleXmlFileReadArchive
@@ -2,10 +2,14 @@
 #pragma once
 
 
+// Qt includes
+#include <QtCore/QVector>
+
 // ACF includes
 #include <iser/IArchive.h>
 #include <iser/ISerializable.h>
 #include <iser/CArchiveTag.h>
+#include <iser/CParallelSerializer.h>
 #include <ibase/TContainer.h>
 
 
@@ -16,6 +20,9 @@ namespace ibase
 /**
 	Common implementation for an abstract serializable container.
 	Derived class must only reimplement the SerializeItem().
+
+	Optionally the items can be serialized in parallel using iser::CParallelSerializer,
+	in this case SerializeItem() must be thread-safe for different items.
 */
 template <typename ItemClass, class ContainerType = typename TContainer<ItemClass>::Container>
 class TSerializableContainer: public TContainer<ItemClass, ContainerType>, virtual public iser::ISerializable
@@ -23,6 +30,19 @@ class TSerializableContainer: public TContainer<ItemClass, ContainerType>, virtu
 public:
 	typedef TContainer<ItemClass, ContainerType> BaseClass;
 
+	TSerializableContainer();
+
+	/**
+		Enable or disable parallel serialization of the items.
+		The archive layout differs in this mode, so the same mode must be used for writing and reading.
+	*/
+	void SetParallelSerializationEnabled(bool isEnabled);
+
+	/**
+		Check if the items are serialized in parallel.
+	*/
+	bool IsParallelSerializationEnabled() const;
+
 	// reimplemented (iser::Serializable)
 	virtual bool Serialize(iser::IArchive& archive) override;
 
@@ -33,11 +53,35 @@ protected:
 		Serialize a single item in the container.
 	*/
 	virtual bool SerializeItem(ItemClass& item, iser::IArchive& archive, iser::CArchiveTag* parentTagPtr = NULL) = 0;
+
+private:
+	bool m_isParallelSerializationEnabled;
 };
 
 
 // public methods
 
+template <typename ItemClass, class ContainerType>
+TSerializableContainer<ItemClass, ContainerType>::TSerializableContainer()
+:	m_isParallelSerializationEnabled(false)
+{
+}
+
+
+template <typename ItemClass, class ContainerType>
+void TSerializableContainer<ItemClass, ContainerType>::SetParallelSerializationEnabled(bool isEnabled)
+{
+	m_isParallelSerializationEnabled = isEnabled;
+}
+
+
+template <typename ItemClass, class ContainerType>
+bool TSerializableContainer<ItemClass, ContainerType>::IsParallelSerializationEnabled() const
+{
+	return m_isParallelSerializationEnabled;
+}
+
+
 // reimplemented (iser::Serializable)
 
 template <typename ItemClass, class ContainerType>
@@ -56,7 +100,27 @@ bool TSerializableContainer<ItemClass, ContainerType>::Serialize(iser::IArchive&
 		return false;
 	}
 
-	if (!archive.IsStoring()){
+	if (m_isParallelSerializationEnabled){
+		if (!archive.IsStoring()){
+			BaseClass::Reset();
+
+			for (int index = 0; index < itemCount; index++){
+				BaseClass::PushBack(ItemClass());
+			}
+		}
+
+		// addresses of the items are collected before, the container is not accessed from other threads
+		QVector<ItemClass*> itemPtrs;
+		itemPtrs.reserve(itemCount);
+		for (int index = 0; index < itemCount; index++){
+			itemPtrs.push_back(&BaseClass::GetAt(index));
+		}
+
+		retVal = iser::CParallelSerializer::SerializeElements(archive, itemTag, itemCount, [this, &itemPtrs](int index, iser::IArchive& itemArchive){
+			return SerializeItem(*itemPtrs[index], itemArchive);
+		});
+	}
+	else if (!archive.IsStoring()){
 		BaseClass::Reset();
 
 #if QT_VERSION >= 0x040700
@@ -117,6 +117,35 @@ void TSerializableContainerTest::testSerializeEmpty()
 }
 
 
+void TSerializableContainerTest::testSerializeParallel()
+{
+	CStringSerializableContainer container1;
+	container1.SetParallelSerializationEnabled(true);
+	for (int i = 0; i < 1000; ++i){
+		container1.PushBack(QString("Item %1").arg(i));
+	}
+	
+	// Serialize to memory
+	iser::CMemoryWriteArchive writeArchive;
+	bool result = container1.Serialize(writeArchive);
+	QVERIFY(result);
+	
+	// Deserialize from memory using the same mode
+	CStringSerializableContainer container2;
+	container2.SetParallelSerializationEnabled(true);
+	container2.PushBack("Old item");
+	iser::CMemoryReadArchive readArchive(writeArchive);
+	result = container2.Serialize(readArchive);
+	QVERIFY(result);
+	
+	// Verify contents
+	QCOMPARE(container2.GetItemsCount(), 1000);
+	for (int i = 0; i < 1000; ++i){
+		QCOMPARE(container2.GetAt(i), QString("Item %1").arg(i));
+	}
+}
+
+
 I_ADD_TEST(TSerializableContainerTest);
 
 
@@ -25,6 +25,7 @@ private Q_SLOTS:
 	void testSerializeInt();
 	void testSerializeString();
 	void testSerializeEmpty();
+	void testSerializeParallel();
 	
 	void cleanupTestCase();
 };
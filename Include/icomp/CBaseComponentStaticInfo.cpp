@@ -28,6 +28,7 @@ CBaseComponentStaticInfo::CBaseComponentStaticInfo(const IRealComponentStaticInf
 void CBaseComponentStaticInfo::RegisterInterfaceExtractor(const QByteArray& interfaceName, InterfaceExtractorPtr extractorPtr)
 {
 	m_interfaceExtractors[interfaceName] = extractorPtr;
+	m_interfaceExtractorIds[istd::CClassInfo::GetTypeId(interfaceName)] = extractorPtr;
 }
 
 
@@ -74,8 +75,8 @@ void* CBaseComponentStaticInfo::GetComponentInterface(
 			return &component;
 		}
 
-		InterfaceExtractors::ConstIterator foundIter = m_interfaceExtractors.constFind(interfaceType.GetName());
-		if (foundIter != m_interfaceExtractors.constEnd()){
+		InterfaceExtractorIds::ConstIterator foundIter = m_interfaceExtractorIds.constFind(interfaceType.GetTypeId());
+		if (foundIter != m_interfaceExtractorIds.constEnd()){
 			InterfaceExtractorPtr extractorPtr = foundIter.value();
 
 			return extractorPtr(component);
@@ -84,8 +85,8 @@ void* CBaseComponentStaticInfo::GetComponentInterface(
 		if (interfaceType.IsConst()){
 			istd::CClassInfo nonConstType = interfaceType.GetConstCasted(false);
 
-			foundIter = m_interfaceExtractors.constFind(nonConstType.GetName());
-			if (foundIter != m_interfaceExtractors.constEnd()){
+			foundIter = m_interfaceExtractorIds.constFind(nonConstType.GetTypeId());
+			if (foundIter != m_interfaceExtractorIds.constEnd()){
 				InterfaceExtractorPtr extractorPtr = foundIter.value();
 
 				return extractorPtr(component);
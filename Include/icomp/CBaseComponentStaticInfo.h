@@ -2,6 +2,9 @@
 #pragma once
 
 
+// Qt includes
+#include <QtCore/QHash>
+
 // ACF includes
 #include <icomp/IRealComponentStaticInfo.h>
 #include <icomp/CComponentStaticInfoBase.h>
@@ -74,6 +77,12 @@ private:
 	typedef QMap<QByteArray, InterfaceExtractorPtr> InterfaceExtractors;
 	InterfaceExtractors m_interfaceExtractors;
 
+	/**
+		Interface extractors indexed by interned type ID, used for fast interface lookup.
+	*/
+	typedef QHash<int, InterfaceExtractorPtr> InterfaceExtractorIds;
+	InterfaceExtractorIds m_interfaceExtractorIds;
+
 	typedef QMap<QByteArray, const IElementStaticInfo*> SubelementInfos;
 	SubelementInfos m_subelementInfos;
 
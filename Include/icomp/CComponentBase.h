@@ -515,7 +515,7 @@ Dest* CompCastPtr(istd::IPolymorphic* objectPtr)
 		icomp::ICompositeComponent* parentComponentPtr = const_cast<icomp::ICompositeComponent*>(dynamic_cast<const icomp::ICompositeComponent*>(componentPtr->GetParentComponent(true)));
 
 		if (parentComponentPtr != nullptr){
-			Dest* retVal = (Dest*)parentComponentPtr->GetInterface(istd::CClassInfo(typeid(Dest)));
+			Dest* retVal = (Dest*)parentComponentPtr->GetInterface(istd::CClassInfo::GetInfo<Dest>());
 
 			if (retVal != nullptr){
 				return retVal;
@@ -540,7 +540,7 @@ const Dest* CompCastPtr(const istd::IPolymorphic* objectPtr)
 	if (componentPtr != nullptr){
 		icomp::ICompositeComponent* parentComponentPtr = const_cast<icomp::ICompositeComponent*>(dynamic_cast<const icomp::ICompositeComponent*>(componentPtr->GetParentComponent(true)));
 		if (parentComponentPtr != nullptr){
-			const Dest* retVal = (const Dest*)parentComponentPtr->GetInterface(istd::CClassInfo(typeid(Dest)));
+			const Dest* retVal = (const Dest*)parentComponentPtr->GetInterface(istd::CClassInfo::GetInfo<Dest>());
 
 			if (retVal != nullptr){
 				return retVal;
@@ -564,7 +564,7 @@ Dest* QueryInterface(istd::IPolymorphic* objectPtr, const QByteArray& componentI
 	if (componentPtr != nullptr) {
 		icomp::ICompositeComponent* parentComponentPtr = const_cast<icomp::ICompositeComponent*>(dynamic_cast<const icomp::ICompositeComponent*>(componentPtr->GetParentComponent(true)));
 		if (parentComponentPtr != nullptr) {
-			Dest* retVal = (Dest*)parentComponentPtr->GetInterface(istd::CClassInfo(typeid(Dest)), componentId);
+			Dest* retVal = (Dest*)parentComponentPtr->GetInterface(istd::CClassInfo::GetInfo<Dest>(), componentId);
 			if (retVal != nullptr) {
 				return retVal;
 			}
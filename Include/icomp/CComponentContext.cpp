@@ -26,6 +26,8 @@ CComponentContext::CComponentContext(
 {
 	Q_ASSERT(elementPtr != NULL);
 	Q_ASSERT(staticInfoPtr != NULL);
+
+	BuildAttributeTable();
 }
 
 
@@ -70,6 +72,15 @@ const IComponentContext* CComponentContext::GetParentContext() const
 
 const iser::IObject* CComponentContext::GetAttribute(const QByteArray& attributeId, int* definitionLevelPtr) const
 {
+	const AttributeInfo* tableInfoPtr = FindTableAttribute(attributeId);
+	if (tableInfoPtr != NULL){
+		if (definitionLevelPtr != NULL){
+			*definitionLevelPtr = tableInfoPtr->definitionLevel;
+		}
+
+		return tableInfoPtr->attributePtr;
+	}
+
 	QMutexLocker attributeMapLock(&m_attributeMapMutex);
 
 	AttributeMap::ConstIterator findIter = m_attributeMap.constFind(attributeId);
@@ -116,7 +127,7 @@ QByteArray CComponentContext::GetHierarchyAddress(const IComponentContext* conte
 
 // protected methods
 
-bool CComponentContext::CalcAttributeInfo(const QByteArray& attributeId, AttributeInfo& result) const
+bool CComponentContext::CalcAttributeInfo(const QByteArray& attributeId, AttributeInfo& result, bool reportErrors) const
 {
 	const IRegistryElement::AttributeInfo* infoPtr = m_registryElement.GetAttributeInfo(attributeId);
 
@@ -159,13 +170,13 @@ bool CComponentContext::CalcAttributeInfo(const QByteArray& attributeId, Attribu
 			}
 		}
 
-		if ((attributeFlags & IAttributeStaticInfo::AF_NULLABLE) == 0){
+		if (reportErrors && ((attributeFlags & IAttributeStaticInfo::AF_NULLABLE) == 0)){
 			qCritical(	"Component %s: Attribute %s was not set!",
 						GetCompleteContextId().constData(),
 						attributeId.constData());
 		}
 	}
-	else{
+	else if (reportErrors){
 		qCritical(	"Component %s: Internal attribute logic for %s failed!",
 					GetCompleteContextId().constData(),
 					attributeId.constData());
@@ -178,6 +189,56 @@ bool CComponentContext::CalcAttributeInfo(const QByteArray& attributeId, Attribu
 }
 
 
+// private methods
+
+void CComponentContext::BuildAttributeTable()
+{
+	const iattr::IAttributesProvider::AttributeIds attributeIds = m_staticInfo.GetAttributeMetaIds();
+
+	m_attributeSlotIndices.reserve(attributeIds.size());
+	m_attributeSlots.reserve(attributeIds.size());
+
+	for (		iattr::IAttributesProvider::AttributeIds::ConstIterator iter = attributeIds.constBegin();
+				iter != attributeIds.constEnd();
+				++iter){
+		const QByteArray& attributeId = *iter;
+
+		AttributeInfo data;
+
+		const IRegistryElement::AttributeInfo* infoPtr = m_registryElement.GetAttributeInfo(attributeId);
+		if ((infoPtr != NULL) && !infoPtr->exportId.isEmpty() && (m_parentPtr != NULL)){
+			// exported attributes are taken only from the table of the parent, other parent lookups could report errors
+			const CComponentContext* parentContextPtr = dynamic_cast<const CComponentContext*>(m_parentPtr);
+			const AttributeInfo* parentInfoPtr = (parentContextPtr != NULL)? parentContextPtr->FindTableAttribute(infoPtr->exportId): NULL;
+			if ((parentInfoPtr == NULL) || (parentInfoPtr->attributePtr == NULL)){
+				continue;
+			}
+
+			data.definitionLevel = parentInfoPtr->definitionLevel + 1;
+			data.attributePtr = parentInfoPtr->attributePtr;
+		}
+		// unresolved attributes are left for on demand resolving to report the errors only if they are really used
+		else if (!CalcAttributeInfo(attributeId, data, false)){
+			continue;
+		}
+
+		m_attributeSlotIndices.insert(attributeId, int(m_attributeSlots.size()));
+		m_attributeSlots.append(data);
+	}
+}
+
+
+const CComponentContext::AttributeInfo* CComponentContext::FindTableAttribute(const QByteArray& attributeId) const
+{
+	AttributeSlotIndices::ConstIterator slotIter = m_attributeSlotIndices.constFind(attributeId);
+	if (slotIter != m_attributeSlotIndices.constEnd()){
+		return &m_attributeSlots[slotIter.value()];
+	}
+
+	return NULL;
+}
+
+
 } // namespace icomp
 
 
@@ -5,6 +5,8 @@
 // Qt includes
 #include <QtCore/QByteArray>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 #include <QtCore/QMutex>
 
 // ACF includes
@@ -22,6 +24,10 @@ class IRegistryElement;
 	Base implementation of component session context.
 	This implementation uses icomp::IRegistryElement to generate lilst of attributes.
 	Please note that resolving of exported attribute is done.
+	All attributes declared in the component static info are resolved once during construction of the context
+	and stored in an immutable table, so they can be accessed without locking.
+	Exported attributes are taken into this table only if they are already in the table of the parent context,
+	all other attributes are resolved on demand.
 */
 class CComponentContext: virtual public IComponentContext
 {
@@ -54,14 +60,41 @@ protected:
 		int definitionLevel;
 	};
 
-	bool CalcAttributeInfo(const QByteArray& attributeId, AttributeInfo& result) const;
+	/**
+		Calculate attribute info for specified attribute ID.
+		\param	attributeId		ID of attribute.
+		\param	result			calculated attribute info.
+		\param	reportErrors	if true, missing attributes will be reported as critical errors.
+	*/
+	bool CalcAttributeInfo(const QByteArray& attributeId, AttributeInfo& result, bool reportErrors = true) const;
 
 private:
+	/**
+		Resolve all attributes declared in the static info and store them in the attribute table.
+	*/
+	void BuildAttributeTable();
+
+	/**
+		Find attribute in the table of attributes resolved during construction.
+		\return	pointer to the attribute info or NULL, if the attribute is not in the table.
+	*/
+	const AttributeInfo* FindTableAttribute(const QByteArray& attributeId) const;
+
 	const IRegistryElement& m_registryElement;
 	const IComponentStaticInfo& m_staticInfo;
 
 	const IComponentContext* m_parentPtr;
 
+	/**
+		Table of attributes resolved during construction, it is never changed later.
+	*/
+	typedef QHash<QByteArray, int> AttributeSlotIndices;
+	AttributeSlotIndices m_attributeSlotIndices;
+	QVector<AttributeInfo> m_attributeSlots;
+
+	/**
+		Attributes not resolved during construction, they are resolved on demand.
+	*/
 	typedef QMap<QByteArray, AttributeInfo> AttributeMap;
 	mutable AttributeMap m_attributeMap;
 
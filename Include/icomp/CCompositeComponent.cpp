@@ -2,16 +2,60 @@
 #include <icomp/CCompositeComponent.h>
 
 
-#ifndef QT_NO_DEBUG
 // Qt includes
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#ifndef QT_NO_DEBUG
 #include <QtCore/QThread>
 #include <QtCore/QCoreApplication>
 #endif //QT_NO_DEBUG
 
+// STL includes
+#include <functional>
+
 // ACF includes
 #include <istd/CClassInfo.h>
 #include <icomp/IComponentEnvironmentManager.h>
 #include <icomp/CBaseComponentStaticInfo.h>
+#include <icomp/CReferenceAttribute.h>
+#include <icomp/CMultiReferenceAttribute.h>
+
+
+namespace
+{
+
+
+/**
+	Runnable executing a function object, it is used for parallel initialization of subcomponents.
+*/
+class CFunctionRunnable: public QRunnable
+{
+public:
+	explicit CFunctionRunnable(const std::function<void()>& function)
+	:	m_function(function)
+	{
+	}
+
+	// reimplemented (QRunnable)
+	virtual void run() override
+	{
+		m_function();
+	}
+
+private:
+	std::function<void()> m_function;
+};
+
+
+/**
+	Number of subcomponent initializations running in the current thread.
+	Such threads can hold mutexes of the compositions, so they must not wait for other threads.
+*/
+thread_local int s_initializationDepth = 0;
+
+
+} // namespace
 
 
 namespace icomp
@@ -20,10 +64,13 @@ namespace icomp
 
 CCompositeComponent::CCompositeComponent(bool manualAutoInit)
 	:m_contextPtr(nullptr),
+	m_compositeContextPtr(nullptr),
 	m_parentPtr(nullptr),
 	m_isParentOwner(false),
 	m_manualAutoInit(manualAutoInit),
-	m_autoInitialized(false)
+	m_autoInitialized(false),
+	m_isParallelInstantiationEnabled(false),
+	m_maxThreadsCount(0)
 #if QT_VERSION < 0x060000
 	,m_mutex(QMutex::Recursive)
 #endif
@@ -49,6 +96,13 @@ bool CCompositeComponent::EnsureAutoInitComponentsCreated() const
 {
 	QMutexLocker writeLock(&m_mutex);
 
+	// waiting for the thread pool inside of another initialization could block threads needing the locked compositions
+	if (m_isParallelInstantiationEnabled && (s_initializationDepth == 0)){
+		writeLock.unlock();
+
+		return EnsureAutoInitComponentsCreatedParallel();
+	}
+
 	bool retVal = false;
 
 	if ((m_contextPtr != nullptr) && !m_autoInitialized){
@@ -69,30 +123,39 @@ bool CCompositeComponent::EnsureAutoInitComponentsCreated() const
 				retVal = true;
 			}
 		}
-		
-		QList<icomp::CCompositeComponent*> subComponentsList;
 
-		for (		ComponentMap::iterator iter = m_componentMap.begin();
-					iter != m_componentMap.end();
-					++iter){
-			ComponentInfo& info = iter.value();
-			icomp::CCompositeComponent* compositeComponentPtr = dynamic_cast<icomp::CCompositeComponent*>(info.componentPtr.get());
-			if (compositeComponentPtr != NULL){
-				subComponentsList.push_back(compositeComponentPtr);
-			}
-		}
-
-		for (		QList<icomp::CCompositeComponent*>::const_iterator iter = subComponentsList.cbegin();
-					iter != subComponentsList.cend();
-					++iter){
-			retVal = (*iter)->EnsureAutoInitComponentsCreated() || retVal;
-		}
+		retVal = EnsureSubcompositionsAutoInit() || retVal;
 	}
 
 	return retVal;
 }
 
 
+void CCompositeComponent::SetParallelInstantiationEnabled(bool isEnabled, int maxThreadsCount)
+{
+	QMutexLocker lock(&m_mutex);
+
+	m_isParallelInstantiationEnabled = isEnabled;
+	m_maxThreadsCount = maxThreadsCount;
+}
+
+
+bool CCompositeComponent::IsParallelInstantiationEnabled() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_isParallelInstantiationEnabled;
+}
+
+
+CCompositeComponent::CreationProfile CCompositeComponent::GetCreationProfile() const
+{
+	QMutexLocker lock(&m_creationProfileMutex);
+
+	return m_creationProfile;
+}
+
+
 // reimplemented (icomp::ICompositeComponent)
 
 IComponentSharedPtr CCompositeComponent::GetSubcomponent(const QByteArray& componentId) const
@@ -100,29 +163,32 @@ IComponentSharedPtr CCompositeComponent::GetSubcomponent(const QByteArray& compo
 	QMutexLocker lock(&m_mutex);
 
 	if (m_contextPtr != nullptr){
-		ComponentMap::ConstIterator iter = m_componentMap.constFind(componentId);
-		if (iter == m_componentMap.constEnd()){
-			ComponentInfo& componentInfo = m_componentMap[componentId];
-			componentInfo.componentState = CS_INIT;
+		ComponentInfo* componentInfoPtr = &m_componentMap[componentId];
 
-			componentInfo.isContextInitialized = true;
- 
-			InitializeSubcomponentInfo(componentId, componentInfo, true);
+		// component is being initialized by a thread of the parallel instantiation
+		while ((componentInfoPtr->componentState == CS_INITIALIZING) && (s_initializationDepth == 0)){
+			QMutexLocker initializationLock(&m_initializationMutex);
+
+			lock.unlock();
+
+			m_initializationCondition.wait(&m_initializationMutex);
 
-			return componentInfo.componentPtr;
+			initializationLock.unlock();
+
+			lock.relock();
+
+			componentInfoPtr = &m_componentMap[componentId];
 		}
-		else {
-			ComponentInfo& componentInfo = m_componentMap[componentId];
-			if (componentInfo.componentState < CS_READY){
-				componentInfo.componentState = CS_INIT;
 
-				componentInfo.isContextInitialized = true;
+		if (componentInfoPtr->componentState < CS_INITIALIZING){
+			componentInfoPtr->componentState = CS_INIT;
 
-				InitializeSubcomponentInfo(componentId, componentInfo, true);
-			}
+			componentInfoPtr->isContextInitialized = true;
 
-			return componentInfo.componentPtr;
+			InitializeSubcomponentInfo(componentId, *componentInfoPtr, true);
 		}
+
+		return componentInfoPtr->componentPtr;
 	}
 	else{
 		ComponentMap::ConstIterator iter = m_componentMap.constFind(componentId);
@@ -224,8 +290,10 @@ const icomp::IComponent* CCompositeComponent::GetParentComponent(bool ownerOnly)
 
 void* CCompositeComponent::GetInterface(const istd::CClassInfo& interfaceType, const QByteArray& subId)
 {
-	const CCompositeComponentContext* contextPtr = dynamic_cast<const CCompositeComponentContext*>(GetComponentContext().get());
-	if (contextPtr == NULL){
+	// keep the context alive during the whole lookup
+	IComponentContextSharedPtr contextHolderPtr = GetComponentContext();
+	const CCompositeComponentContext* contextPtr = m_compositeContextPtr;
+	if ((contextHolderPtr == nullptr) || (contextPtr == NULL)){
 		qCritical("Composite component doesn't use corresponding context");
 
 		return NULL;
@@ -233,36 +301,18 @@ void* CCompositeComponent::GetInterface(const istd::CClassInfo& interfaceType, c
 
 	const IRegistry& registry = contextPtr->GetRegistry();
 
-	if (subId.isEmpty()){
-		// Make a copy to avoid holding the lock during iteration
-		const IRegistry::ExportedInterfacesMap interfaceInfos = registry.GetExportedInterfacesMap();
-
-		IRegistry::ExportedInterfacesMap::const_iterator iter;
-		if (interfaceType.IsVoid()){
-			iter = interfaceInfos.constBegin();
-		}
-		else{
-			iter = interfaceInfos.constFind(interfaceType.GetName());
-			if ((iter == interfaceInfos.constEnd()) && interfaceType.IsConst()){
-				istd::CClassInfo nonConstInterfaceType = interfaceType.GetConstCasted(false);
+	ResolvedAddress address;
 
-				iter = interfaceInfos.constFind(nonConstInterfaceType.GetName());
-			}
-		}
-
-		if (iter != interfaceInfos.constEnd()){
-			QByteArray componentId;
-			QByteArray restId;
-			SplitId(iter.value(), componentId, restId);
-
-			IComponentSharedPtr subComponentPtr = GetSubcomponent(componentId);
+	if (subId.isEmpty()){
+		if (FindResolvedAddress(registry, &interfaceType, QByteArray(), address)){
+			IComponentSharedPtr subComponentPtr = GetSubcomponent(address.componentId);
 			if (subComponentPtr != nullptr){
-				return subComponentPtr->GetInterface(interfaceType, restId);
+				return subComponentPtr->GetInterface(interfaceType, address.restId);
 			}
 			else{
 				qCritical(	"Component %s: Component %s cannot be accessed (interface %s)!",
 							contextPtr->GetCompleteContextId().constData(),
-							componentId.constData(),
+							address.componentId.constData(),
 							interfaceType.GetName().constData());
 			}
 		}
@@ -272,24 +322,15 @@ void* CCompositeComponent::GetInterface(const istd::CClassInfo& interfaceType, c
 		QByteArray restId;
 		SplitId(subId, componentId, restId);
 
-		// Make a copy to avoid holding the lock during iteration
-		const IRegistry::ExportedElementsMap subcomponentMap = registry.GetExportedElementsMap();
-
-		IRegistry::ExportedElementsMap::ConstIterator iter = subcomponentMap.constFind(componentId);
-		if (iter != subcomponentMap.constEnd()){
-			const QByteArray& realComponentId = iter.value();
-			QByteArray subComponentId;
-			QByteArray subRestId;
-			SplitId(realComponentId, subComponentId, subRestId);
-
-			IComponentSharedPtr subComponentPtr = GetSubcomponent(subComponentId);
+		if (FindResolvedAddress(registry, NULL, componentId, address)){
+			IComponentSharedPtr subComponentPtr = GetSubcomponent(address.componentId);
 			if (subComponentPtr != nullptr){
-				return subComponentPtr->GetInterface(interfaceType, JoinId(subRestId, restId));
+				return subComponentPtr->GetInterface(interfaceType, JoinId(address.restId, restId));
 			}
 			else{
 				qCritical("Component %s: Subcomponent %s is registered as %s, but it cannot be accessed (interface %s)!",
 							contextPtr->GetCompleteContextId().constData(),
-							subComponentId.constData(),
+							address.componentId.constData(),
 							componentId.constData(),
 							interfaceType.GetName().constData());
 			}
@@ -326,8 +367,16 @@ void CCompositeComponent::SetComponentContext(
 	m_autoInitComponentIds.clear();
 
 	const CCompositeComponentContext* compositeContextPtr = dynamic_cast<const CCompositeComponentContext*>(contextPtr.get());
+
+	{
+		QWriteLocker tableLock(&m_resolutionTableLock);
+
+		m_resolutionTable = ResolutionTable();
+	}
+
 	if (compositeContextPtr != NULL){
 		m_contextPtr = contextPtr;
+		m_compositeContextPtr = compositeContextPtr;
 
 		const IRegistry& registry = compositeContextPtr->GetRegistry();
 
@@ -347,6 +396,7 @@ void CCompositeComponent::SetComponentContext(
 	}
 	else{
 		m_contextPtr.reset();
+		m_compositeContextPtr = nullptr;
 
 		for (		ComponentMap::iterator iter = m_componentMap.begin();
 					iter != m_componentMap.end();
@@ -469,6 +519,27 @@ bool CCompositeComponent::InitializeSubcomponentInfo(
 			const QByteArray& componentId,
 			ComponentInfo& componentInfo,
 			bool isOwned) const
+{
+	QElapsedTimer creationTimer;
+	creationTimer.start();
+
+	if (!CreateSubcomponentInstance(componentId, componentInfo)){
+		return false;
+	}
+
+	if (componentInfo.componentState == CS_INITIALIZING){
+		FinishSubcomponentCreation(componentInfo.componentPtr, componentInfo.contextPtr, isOwned);
+
+		SetSubcomponentReady(componentInfo);
+
+		AddCreationProfileEntry(componentId, creationTimer.nsecsElapsed(), -1);
+	}
+
+	return true;
+}
+
+
+bool CCompositeComponent::CreateSubcomponentInstance(const QByteArray& componentId, ComponentInfo& componentInfo) const
 {
 	IComponentContextSharedPtr myContextPtr = GetComponentContext();
 	if (myContextPtr == nullptr) {
@@ -561,19 +632,447 @@ bool CCompositeComponent::InitializeSubcomponentInfo(
 			return false;
 		}
 
-		componentInfo.componentState = CS_READY;
+		componentInfo.componentState = CS_INITIALIZING;
+	}
+
+	return true;
+}
+
+
+void CCompositeComponent::FinishSubcomponentCreation(
+			const IComponentSharedPtr& componentPtr,
+			const IComponentContextSharedPtr& contextPtr,
+			bool isOwned) const
+{
+	Q_ASSERT(componentPtr != nullptr);
+
+	++s_initializationDepth;
+
+	componentPtr->SetComponentContext(contextPtr, this, isOwned);
+
+	if (!m_manualAutoInit || m_autoInitialized){
+		icomp::CCompositeComponent* compositeComponentPtr = dynamic_cast<icomp::CCompositeComponent*>(componentPtr.get());
+		if (compositeComponentPtr != NULL){
+			compositeComponentPtr->EnsureAutoInitComponentsCreated();
+		}
+	}
+
+	--s_initializationDepth;
+}
+
+
+void CCompositeComponent::SetSubcomponentReady(ComponentInfo& componentInfo) const
+{
+	componentInfo.componentState = CS_READY;
+
+	QMutexLocker initializationLock(&m_initializationMutex);
+
+	m_initializationCondition.wakeAll();
+}
+
+
+// private methods
+
+bool CCompositeComponent::FindResolvedAddress(
+			const IRegistry& registry,
+			const istd::CClassInfo* interfaceTypePtr,
+			const QByteArray& elementId,
+			ResolvedAddress& result) const
+{
+	QReadLocker readLock(&m_resolutionTableLock);
+
+	if (!IsResolutionTableValid(registry)){
+		readLock.unlock();
+
+		QWriteLocker writeLock(&m_resolutionTableLock);
+
+		// table could be rebuilt by another thread in the meantime
+		if (!IsResolutionTableValid(registry)){
+			BuildResolutionTable(registry);
+		}
+
+		writeLock.unlock();
+
+		readLock.relock();
+	}
+
+	if (interfaceTypePtr != NULL){
+		if (interfaceTypePtr->IsVoid()){
+			if (m_resolutionTable.hasFirstInterface){
+				result = m_resolutionTable.firstInterface;
+
+				return true;
+			}
+
+			return false;
+		}
+
+		InterfaceAddressMap::ConstIterator iter = m_resolutionTable.interfaces.constFind(interfaceTypePtr->GetTypeId());
+		if (iter != m_resolutionTable.interfaces.constEnd()){
+			result = iter.value();
+
+			return true;
+		}
+	}
+	else{
+		ElementAddressMap::ConstIterator iter = m_resolutionTable.elements.constFind(elementId);
+		if (iter != m_resolutionTable.elements.constEnd()){
+			result = iter.value();
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool CCompositeComponent::IsResolutionTableValid(const IRegistry& registry) const
+{
+	if (!m_resolutionTable.isValid){
+		return false;
+	}
+
+	// copying of the maps is cheap, only reference counter will be incremented
+	const IRegistry::ExportedInterfacesMap interfacesMap = registry.GetExportedInterfacesMap();
+	const IRegistry::ExportedElementsMap elementsMap = registry.GetExportedElementsMap();
+
+	return		interfacesMap.isSharedWith(m_resolutionTable.registryInterfacesMap) &&
+				elementsMap.isSharedWith(m_resolutionTable.registryElementsMap);
+}
+
+
+void CCompositeComponent::BuildResolutionTable(const IRegistry& registry) const
+{
+	static const QByteArray constPrefix("const ");
+
+	ResolutionTable table;
+	table.registryInterfacesMap = registry.GetExportedInterfacesMap();
+	table.registryElementsMap = registry.GetExportedElementsMap();
+
+	table.interfaces.reserve(table.registryInterfacesMap.size() * 2);
+
+	for (		IRegistry::ExportedInterfacesMap::ConstIterator iter = table.registryInterfacesMap.constBegin();
+				iter != table.registryInterfacesMap.constEnd();
+				++iter){
+		ResolvedAddress address;
+		SplitId(iter.value(), address.componentId, address.restId);
 
-		componentInfo.componentPtr->SetComponentContext(componentInfo.contextPtr, this, isOwned);
+		table.interfaces.insert(istd::CClassInfo::GetTypeId(iter.key()), address);
 
-		if (!m_manualAutoInit || m_autoInitialized){
-			icomp::CCompositeComponent* compositeComponentPtr = dynamic_cast<icomp::CCompositeComponent*>(componentInfo.componentPtr.get());
+		if (!table.hasFirstInterface){
+			table.firstInterface = address;
+			table.hasFirstInterface = true;
+		}
+	}
+
+	// const interface can be taken from exported non-const one, if no explicit const export exists
+	for (		IRegistry::ExportedInterfacesMap::ConstIterator iter = table.registryInterfacesMap.constBegin();
+				iter != table.registryInterfacesMap.constEnd();
+				++iter){
+		const QByteArray& interfaceName = iter.key();
+		if (interfaceName.startsWith(constPrefix)){
+			continue;
+		}
+
+		int constInterfaceId = istd::CClassInfo::GetTypeId(constPrefix + interfaceName);
+		if (!table.interfaces.contains(constInterfaceId)){
+			table.interfaces.insert(constInterfaceId, table.interfaces.value(istd::CClassInfo::GetTypeId(interfaceName)));
+		}
+	}
+
+	table.elements.reserve(table.registryElementsMap.size());
+
+	for (		IRegistry::ExportedElementsMap::ConstIterator iter = table.registryElementsMap.constBegin();
+				iter != table.registryElementsMap.constEnd();
+				++iter){
+		ResolvedAddress address;
+		SplitId(iter.value(), address.componentId, address.restId);
+
+		table.elements.insert(iter.key(), address);
+	}
+
+	table.isValid = true;
+
+	m_resolutionTable = table;
+}
+
+
+bool CCompositeComponent::EnsureSubcompositionsAutoInit() const
+{
+	QList<icomp::CCompositeComponent*> subComponentsList;
+
+	{
+		QMutexLocker lock(&m_mutex);
+
+		for (		ComponentMap::iterator iter = m_componentMap.begin();
+					iter != m_componentMap.end();
+					++iter){
+			ComponentInfo& info = iter.value();
+			icomp::CCompositeComponent* compositeComponentPtr = dynamic_cast<icomp::CCompositeComponent*>(info.componentPtr.get());
 			if (compositeComponentPtr != NULL){
-				compositeComponentPtr->EnsureAutoInitComponentsCreated();
+				subComponentsList.push_back(compositeComponentPtr);
 			}
 		}
 	}
 
-	return true;
+	bool retVal = false;
+
+	for (		QList<icomp::CCompositeComponent*>::const_iterator iter = subComponentsList.cbegin();
+				iter != subComponentsList.cend();
+				++iter){
+		retVal = (*iter)->EnsureAutoInitComponentsCreated() || retVal;
+	}
+
+	return retVal;
+}
+
+
+bool CCompositeComponent::EnsureAutoInitComponentsCreatedParallel() const
+{
+	QVector<ComponentIds> levels;
+	ComponentIds cyclicComponentIds;
+	int maxThreadsCount = 0;
+
+	{
+		QMutexLocker lock(&m_mutex);
+
+		if ((m_contextPtr == nullptr) || m_autoInitialized){
+			return false;
+		}
+
+		m_autoInitialized = true;
+		maxThreadsCount = m_maxThreadsCount;
+
+		levels = CalcDependencyLevels(m_compositeContextPtr->GetRegistry(), m_autoInitComponentIds, cyclicComponentIds);
+
+		m_autoInitComponentIds.clear();
+	}
+
+	bool retVal = false;
+
+	QThreadPool threadPool;
+	if (maxThreadsCount > 0){
+		threadPool.setMaxThreadCount(maxThreadsCount);
+	}
+
+	for (int levelIndex = 0; levelIndex < levels.size(); ++levelIndex){
+		const ComponentIds& levelComponentIds = levels[levelIndex];
+
+		for (		ComponentIds::ConstIterator iter = levelComponentIds.constBegin();
+					iter != levelComponentIds.constEnd();
+					++iter){
+			const QByteArray& componentId = *iter;
+
+			QElapsedTimer creationTimer;
+			creationTimer.start();
+
+			IComponentSharedPtr componentPtr;
+			IComponentContextSharedPtr contextPtr;
+
+			{
+				QMutexLocker lock(&m_mutex);
+
+				ComponentInfo& componentInfo = m_componentMap[componentId];
+				if (componentInfo.componentState != CS_NONE){
+					// component was already created on demand
+					continue;
+				}
+
+				componentInfo.componentState = CS_INIT;
+				componentInfo.isContextInitialized = true;
+
+				retVal = true;
+
+				if (!CreateSubcomponentInstance(componentId, componentInfo) || (componentInfo.componentState != CS_INITIALIZING)){
+					continue;
+				}
+
+				componentPtr = componentInfo.componentPtr;
+				contextPtr = componentInfo.contextPtr;
+			}
+
+			qint64 instanceCreationTime = creationTimer.nsecsElapsed();
+
+			threadPool.start(new CFunctionRunnable([this, componentId, componentPtr, contextPtr, instanceCreationTime, levelIndex](){
+				QElapsedTimer initTimer;
+				initTimer.start();
+
+				FinishSubcomponentCreation(componentPtr, contextPtr, true);
+
+				{
+					QMutexLocker lock(&m_mutex);
+
+					ComponentInfo& componentInfo = m_componentMap[componentId];
+					if (componentInfo.componentState == CS_INITIALIZING){
+						SetSubcomponentReady(componentInfo);
+					}
+				}
+
+				AddCreationProfileEntry(componentId, instanceCreationTime + initTimer.nsecsElapsed(), levelIndex);
+			}));
+		}
+
+		// components of the next level can depend on all components of this level
+		threadPool.waitForDone();
+	}
+
+	for (		ComponentIds::ConstIterator iter = cyclicComponentIds.constBegin();
+				iter != cyclicComponentIds.constEnd();
+				++iter){
+		const QByteArray& componentId = *iter;
+
+		QMutexLocker lock(&m_mutex);
+
+		ComponentInfo& componentInfo = m_componentMap[componentId];
+		if (componentInfo.componentState == CS_NONE){
+			componentInfo.componentState = CS_INIT;
+			componentInfo.isContextInitialized = true;
+
+			InitializeSubcomponentInfo(componentId, componentInfo, true);
+
+			retVal = true;
+		}
+	}
+
+	retVal = EnsureSubcompositionsAutoInit() || retVal;
+
+	return retVal;
+}
+
+
+QVector<CCompositeComponent::ComponentIds> CCompositeComponent::CalcDependencyLevels(
+			const IRegistry& registry,
+			const IRegistry::Ids& componentIds,
+			ComponentIds& cyclicComponentIds)
+{
+	QVector<ComponentIds> retVal;
+
+	DependencyLevelsMap levelsMap;
+
+	for (		IRegistry::Ids::ConstIterator iter = componentIds.constBegin();
+				iter != componentIds.constEnd();
+				++iter){
+		const QByteArray& componentId = *iter;
+
+		int level = CalcDependencyLevel(registry, componentId, levelsMap);
+		if (level < 0){
+			cyclicComponentIds.append(componentId);
+
+			continue;
+		}
+
+		if (level >= retVal.size()){
+			retVal.resize(level + 1);
+		}
+
+		retVal[level].append(componentId);
+	}
+
+	return retVal;
+}
+
+
+int CCompositeComponent::CalcDependencyLevel(
+			const IRegistry& registry,
+			const QByteArray& elementId,
+			DependencyLevelsMap& levelsMap)
+{
+	// marks element whose dependencies are just being calculated
+	static const int visitingLevel = -2;
+
+	DependencyLevelsMap::ConstIterator foundIter = levelsMap.constFind(elementId);
+	if (foundIter != levelsMap.constEnd()){
+		// element being visited again means a dependency cycle
+		return (foundIter.value() == visitingLevel)? -1: foundIter.value();
+	}
+
+	levelsMap[elementId] = visitingLevel;
+
+	int level = 0;
+
+	const IRegistry::Ids dependencies = GetElementDependencies(registry, elementId);
+	for (		IRegistry::Ids::ConstIterator iter = dependencies.constBegin();
+				iter != dependencies.constEnd();
+				++iter){
+		int dependencyLevel = CalcDependencyLevel(registry, *iter, levelsMap);
+		if (dependencyLevel < 0){
+			level = -1;
+
+			break;
+		}
+
+		level = qMax(level, dependencyLevel + 1);
+	}
+
+	levelsMap[elementId] = level;
+
+	return level;
+}
+
+
+IRegistry::Ids CCompositeComponent::GetElementDependencies(const IRegistry& registry, const QByteArray& elementId)
+{
+	IRegistry::Ids retVal;
+
+	const IRegistry::ElementInfo* elementInfoPtr = registry.GetElementInfo(elementId);
+	if ((elementInfoPtr == NULL) || !elementInfoPtr->elementPtr.IsValid()){
+		return retVal;
+	}
+
+	const IRegistryElement& registryElement = *elementInfoPtr->elementPtr;
+
+	QByteArray componentId;
+	QByteArray restId;
+
+	const iattr::IAttributesProvider::AttributeIds attributeIds = registryElement.GetAttributeIds();
+	for (		iattr::IAttributesProvider::AttributeIds::ConstIterator iter = attributeIds.constBegin();
+				iter != attributeIds.constEnd();
+				++iter){
+		const IRegistryElement::AttributeInfo* attributeInfoPtr = registryElement.GetAttributeInfo(*iter);
+		if ((attributeInfoPtr == NULL) || !attributeInfoPtr->attributePtr.IsValid()){
+			continue;
+		}
+
+		// factory attributes are derived from the reference ones
+		const CReferenceAttribute* referencePtr = dynamic_cast<const CReferenceAttribute*>(attributeInfoPtr->attributePtr.GetPtr());
+		if (referencePtr != NULL){
+			SplitId(referencePtr->GetValue(), componentId, restId);
+
+			if ((componentId != elementId) && (registry.GetElementInfo(componentId) != NULL)){
+				retVal.insert(componentId);
+			}
+
+			continue;
+		}
+
+		const CMultiReferenceAttribute* multiReferencePtr = dynamic_cast<const CMultiReferenceAttribute*>(attributeInfoPtr->attributePtr.GetPtr());
+		if (multiReferencePtr != NULL){
+			int referencesCount = multiReferencePtr->GetValuesCount();
+			for (int i = 0; i < referencesCount; ++i){
+				SplitId(multiReferencePtr->GetValueAt(i), componentId, restId);
+
+				if ((componentId != elementId) && (registry.GetElementInfo(componentId) != NULL)){
+					retVal.insert(componentId);
+				}
+			}
+		}
+	}
+
+	return retVal;
+}
+
+
+void CCompositeComponent::AddCreationProfileEntry(const QByteArray& componentId, qint64 creationTime, int dependencyLevel) const
+{
+	CreationProfileEntry entry;
+	entry.componentId = componentId;
+	entry.creationTime = creationTime;
+	entry.dependencyLevel = dependencyLevel;
+
+	QMutexLocker lock(&m_creationProfileMutex);
+
+	m_creationProfile.append(entry);
 }
 
 
@@ -5,6 +5,10 @@
 // Qt includes
 #include <QtCore/QByteArray>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QRecursiveMutex>
 #include <QtCore/QWaitCondition>
@@ -30,6 +34,25 @@ class CCompositeComponent:
 			virtual public ICompositeComponent
 {
 public:
+	/**
+		Creation time profile of a single subcomponent.
+	*/
+	struct CreationProfileEntry
+	{
+		QByteArray componentId;
+		/**
+			Creation time in nanoseconds.
+			It includes the creation of all components created during initialization of this one.
+		*/
+		qint64 creationTime;
+		/**
+			Level of the component in the dependency graph if it was created in parallel mode, otherwise -1.
+		*/
+		int dependencyLevel;
+	};
+
+	typedef QVector<CreationProfileEntry> CreationProfile;
+
 	CCompositeComponent(bool manualAutoInit);
 	virtual ~CCompositeComponent();
 
@@ -45,6 +68,31 @@ public:
 	*/
 	bool EnsureAutoInitComponentsCreated() const;
 
+	/**
+		Enable parallel creation of components with flag 'AutoInit'.
+		Auto-init components are ordered using the dependency graph built from reference and factory attributes in the registry.
+		Components of the same dependency level are initialized concurrently on a thread pool,
+		component instances themselves are still created in the calling thread.
+		Components with cyclic dependencies are created serially at the end.
+		Use this mode only if the components access other components of this composition through their references only
+		and do not create thread bound objects during their initialization.
+		Nested compositions are always created serially, also the parallel mode is not used
+		if the auto-init components are created during initialization of another component.
+		\param	isEnabled			if true, parallel mode will be used.
+		\param	maxThreadsCount		maximal number of threads used for a composition, 0 means the ideal thread count.
+	*/
+	void SetParallelInstantiationEnabled(bool isEnabled, int maxThreadsCount = 0);
+
+	/**
+		Check if parallel creation of auto-init components is enabled.
+	*/
+	bool IsParallelInstantiationEnabled() const;
+
+	/**
+		Get creation time profile of subcomponents created by this composition.
+	*/
+	CreationProfile GetCreationProfile() const;
+
 	// reimplemented (icomp::ICompositeComponent)
 	virtual IComponentSharedPtr GetSubcomponent(const QByteArray& componentId) const override;
 	virtual IComponentContextSharedPtr GetSubcomponentContext(const QByteArray& componentId) const override;
@@ -77,18 +125,108 @@ protected:
 
 private:
 	struct ComponentInfo;
+	struct ResolvedAddress;
 
 	bool InitializeSubcomponentInfo(
 				const QByteArray& componentId,
 				ComponentInfo& componentInfo,
 				bool isOwned) const;
 
+	/**
+		Create context and instance of subcomponent without initialization of the instance.
+		If the instance was created, the component state will be set to \c CS_INITIALIZING.
+	*/
+	bool CreateSubcomponentInstance(const QByteArray& componentId, ComponentInfo& componentInfo) const;
+
+	/**
+		Initialize created subcomponent instance by setting its context.
+	*/
+	void FinishSubcomponentCreation(
+				const IComponentSharedPtr& componentPtr,
+				const IComponentContextSharedPtr& contextPtr,
+				bool isOwned) const;
+
+	/**
+		Mark initialized subcomponent as ready and wake up threads waiting for it.
+		Caller must hold the component mutex.
+	*/
+	void SetSubcomponentReady(ComponentInfo& componentInfo) const;
+
+	/**
+		Make sure, auto-init components of all created subcompositions are initialized.
+	*/
+	bool EnsureSubcompositionsAutoInit() const;
+
+	/**
+		Parallel variant of EnsureAutoInitComponentsCreated().
+	*/
+	bool EnsureAutoInitComponentsCreatedParallel() const;
+
+	typedef QList<QByteArray> ComponentIds;
+	typedef QHash<QByteArray, int> DependencyLevelsMap;
+
+	/**
+		Split components into the levels of the dependency graph.
+		Components of each level depend only on components of previous levels.
+		\param	cyclicComponentIds	will be filled with components having cyclic dependencies.
+	*/
+	static QVector<ComponentIds> CalcDependencyLevels(
+				const IRegistry& registry,
+				const IRegistry::Ids& componentIds,
+				ComponentIds& cyclicComponentIds);
+
+	/**
+		Calculate dependency level of the element.
+		\return	level of the element or negative value, if the element has cyclic dependencies.
+	*/
+	static int CalcDependencyLevel(
+				const IRegistry& registry,
+				const QByteArray& elementId,
+				DependencyLevelsMap& levelsMap);
+
+	/**
+		Get IDs of registry elements referenced by reference or factory attributes of the element.
+	*/
+	static IRegistry::Ids GetElementDependencies(const IRegistry& registry, const QByteArray& elementId);
+
+	void AddCreationProfileEntry(const QByteArray& componentId, qint64 creationTime, int dependencyLevel) const;
+
+	/**
+		Find the address of exported interface or exported element using the precomputed resolution table.
+		The table is rebuilt if the registry exports were changed since the last build.
+		\param	registry			registry of this composition.
+		\param	interfaceTypePtr	requested interface type for interface lookup or NULL for element lookup.
+									For void interface the first exported interface will be taken.
+		\param	elementId			exported element ID, it is used only for element lookup.
+		\param	result				resolved address.
+		\return						true, if the address was found.
+	*/
+	bool FindResolvedAddress(
+				const IRegistry& registry,
+				const istd::CClassInfo* interfaceTypePtr,
+				const QByteArray& elementId,
+				ResolvedAddress& result) const;
+	/**
+		Check if the resolution table corresponds to the current registry exports.
+		Caller must hold the resolution table lock.
+	*/
+	bool IsResolutionTableValid(const IRegistry& registry) const;
+	/**
+		Build the resolution table from the registry exports.
+		Caller must hold the resolution table lock for writing.
+	*/
+	void BuildResolutionTable(const IRegistry& registry) const;
+
 
 private:
 	enum ComponentState
 	{
 		CS_NONE,
 		CS_INIT,
+		/**
+			Instance was created, but its context was not set yet.
+		*/
+		CS_INITIALIZING,
 		CS_READY,
 		CS_DESTROYED
 	};
@@ -127,7 +265,59 @@ private:
 
 	mutable ComponentMap m_componentMap;
 
+	/**
+		Exported ID already split into ID of the subcomponent and rest ID inside of this subcomponent.
+	*/
+	struct ResolvedAddress
+	{
+		QByteArray componentId;
+		QByteArray restId;
+	};
+
+	typedef QHash<int, ResolvedAddress> InterfaceAddressMap;
+	typedef QHash<QByteArray, ResolvedAddress> ElementAddressMap;
+
+	/**
+		Lookup table for exported interfaces and elements built from the registry exports.
+	*/
+	struct ResolutionTable
+	{
+		ResolutionTable()
+			:hasFirstInterface(false),
+			isValid(false)
+		{
+		}
+
+		/**
+			Copies of the registry export maps used to build this table.
+			They share the data with the registry, every change in the registry detaches its map and invalidates this table.
+		*/
+		IRegistry::ExportedInterfacesMap registryInterfacesMap;
+		IRegistry::ExportedElementsMap registryElementsMap;
+
+		/**
+			Interface addresses indexed by interned type ID, for non-const interfaces the const variant is also registered.
+		*/
+		InterfaceAddressMap interfaces;
+		ElementAddressMap elements;
+
+		/**
+			Address of the first exported interface, it is used for void interface requests.
+		*/
+		ResolvedAddress firstInterface;
+		bool hasFirstInterface;
+
+		bool isValid;
+	};
+
+	mutable ResolutionTable m_resolutionTable;
+	mutable QReadWriteLock m_resolutionTableLock;
+
 	IComponentContextSharedPtr m_contextPtr;
+	/**
+		Composite context casted once during context setting.
+	*/
+	const CCompositeComponentContext* m_compositeContextPtr;
 	const icomp::ICompositeComponent* m_parentPtr;
 	bool m_isParentOwner;
 
@@ -136,6 +326,18 @@ private:
 	mutable bool m_autoInitialized;
 	mutable IRegistry::Ids m_autoInitComponentIds;
 
+	bool m_isParallelInstantiationEnabled;
+	int m_maxThreadsCount;
+
+	mutable CreationProfile m_creationProfile;
+	mutable QMutex m_creationProfileMutex;
+
+	/**
+		Signals finished initialization of subcomponents created in parallel mode.
+	*/
+	mutable QMutex m_initializationMutex;
+	mutable QWaitCondition m_initializationCondition;
+
 #if QT_VERSION >= 0x060000
 	mutable QRecursiveMutex m_mutex;
 #else
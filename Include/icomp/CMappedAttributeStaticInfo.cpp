@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <icomp/CMappedAttributeStaticInfo.h>
+
+
+// Qt includes
+#include <QtCore/QtEndian>
+
+// ACF includes
+#include <iser/CMemoryReadArchive.h>
+#include <icomp/CMappedPackageStaticInfo.h>
+#include <icomp/CPackageMetaInfoCache.h>
+
+
+namespace icomp
+{
+
+
+// public methods
+
+CMappedAttributeStaticInfo::CMappedAttributeStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset)
+:	m_packageInfo(packageInfo),
+	m_recordOffset(recordOffset),
+	m_attributeFlags(0),
+	m_isDefaultValueLoaded(false)
+{
+	m_typeId = m_packageInfo.GetString(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::AW_TYPE_ID));
+
+	quint32 flags = m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::AW_FLAGS);
+	if (flags != CMappedPackageStaticInfo::NO_RECORD){
+		m_attributeFlags = int(flags);
+	}
+}
+
+
+// reimplemented (icomp::IAttributeStaticInfo)
+
+IElementStaticInfo::Ids CMappedAttributeStaticInfo::GetRelatedMetaIds(int metaGroupId, int flags, int flagsMask) const
+{
+	IElementStaticInfo::Ids retVal;
+
+	quint32 relatedIdsCount = m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::AW_RELATED_IDS_COUNT);
+	if (relatedIdsCount == CMappedPackageStaticInfo::NO_RECORD){
+		return retVal;
+	}
+
+	quint32 relatedIdsOffset = m_recordOffset + CMappedPackageStaticInfo::AW_COUNT * sizeof(quint32);
+	const char* relatedIdsPtr = m_packageInfo.GetRecordData(relatedIdsOffset, relatedIdsCount * 3 * sizeof(quint32));
+	if (relatedIdsPtr == NULL){
+		return retVal;
+	}
+
+	for (quint32 i = 0; i < relatedIdsCount; ++i){
+		const char* entryPtr = relatedIdsPtr + i * 3 * sizeof(quint32);
+
+		int entryMetaGroupId = int(qFromLittleEndian<quint32>(entryPtr));
+		int entryFlags = int(qFromLittleEndian<quint32>(entryPtr + 2 * sizeof(quint32)));
+
+		if ((entryMetaGroupId == metaGroupId) && ((entryFlags & flagsMask) == flags)){
+			retVal.insert(m_packageInfo.GetString(qFromLittleEndian<quint32>(entryPtr + sizeof(quint32))));
+		}
+	}
+
+	return retVal;
+}
+
+
+// reimplemented (iattr::IAttributeMetaInfo)
+
+QString CMappedAttributeStaticInfo::GetAttributeDescription() const
+{
+	return QString::fromUtf8(m_packageInfo.GetRawString(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::AW_DESCRIPTION)));
+}
+
+
+const iser::IObject* CMappedAttributeStaticInfo::GetAttributeDefaultValue() const
+{
+	QMutexLocker lock(&m_defaultValueMutex);
+
+	if (!m_isDefaultValueLoaded){
+		m_isDefaultValueLoaded = true;
+
+		quint32 valueOffset = m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::AW_DEFAULT_VALUE);
+		quint32 valueSize = m_packageInfo.GetRecordWord(valueOffset, 0);
+		if ((valueSize != CMappedPackageStaticInfo::NO_RECORD) && (valueSize > 0)){
+			const char* valueDataPtr = m_packageInfo.GetRecordData(valueOffset + sizeof(quint32), valueSize);
+			if (valueDataPtr != NULL){
+				std::unique_ptr<iser::IObject> defaultValuePtr(CPackageMetaInfoCache::CreateAttribute(m_typeId));
+				if (defaultValuePtr){
+					iser::CMemoryReadArchive readArchive(valueDataPtr, int(valueSize));
+					if (defaultValuePtr->Serialize(readArchive)){
+						m_defaultValuePtr = std::move(defaultValuePtr);
+					}
+				}
+			}
+		}
+	}
+
+	return m_defaultValuePtr.get();
+}
+
+
+QByteArray CMappedAttributeStaticInfo::GetAttributeTypeId() const
+{
+	return m_typeId;
+}
+
+
+int CMappedAttributeStaticInfo::GetAttributeFlags() const
+{
+	return m_attributeFlags;
+}
+
+
+} // namespace icomp
+
+
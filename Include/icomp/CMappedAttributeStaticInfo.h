@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// STL includes
+#include <memory>
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+// ACF includes
+#include <icomp/IAttributeStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+class CMappedPackageStaticInfo;
+
+
+/**
+	Attribute static info reading its meta-information in place from the mapped package cache file.
+	The default value is deserialized first time it is requested.
+	\sa CMappedPackageStaticInfo
+*/
+class CMappedAttributeStaticInfo: virtual public IAttributeStaticInfo
+{
+public:
+	/**
+		Create attribute info for some record in the mapped cache file.
+		The package info must exist during whole lifetime of this object.
+	*/
+	CMappedAttributeStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset);
+
+	// reimplemented (icomp::IAttributeStaticInfo)
+	virtual IElementStaticInfo::Ids GetRelatedMetaIds(int metaGroupId, int flags, int flagsMask) const override;
+
+	// reimplemented (iattr::IAttributeMetaInfo)
+	virtual QString GetAttributeDescription() const override;
+	virtual const iser::IObject* GetAttributeDefaultValue() const override;
+	virtual QByteArray GetAttributeTypeId() const override;
+	virtual int GetAttributeFlags() const override;
+
+private:
+	const CMappedPackageStaticInfo& m_packageInfo;
+	quint32 m_recordOffset;
+
+	QByteArray m_typeId;
+	int m_attributeFlags;
+
+	mutable std::unique_ptr<iser::IObject> m_defaultValuePtr;
+	mutable bool m_isDefaultValueLoaded;
+	mutable QMutex m_defaultValueMutex;
+};
+
+
+} // namespace icomp
+
+
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <icomp/CMappedComponentStaticInfo.h>
+
+
+// ACF includes
+#include <icomp/CMappedPackageStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+// public methods
+
+CMappedComponentStaticInfo::CMappedComponentStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset)
+:	m_packageInfo(packageInfo),
+	m_recordOffset(recordOffset),
+	m_componentType(CT_NONE)
+{
+	m_description = QString::fromUtf8(m_packageInfo.GetRawString(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_DESCRIPTION)));
+	m_keywords = QString::fromUtf8(m_packageInfo.GetRawString(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_KEYWORDS)));
+
+	quint32 componentType = m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_COMPONENT_TYPE);
+	if (componentType != CMappedPackageStaticInfo::NO_RECORD){
+		m_componentType = int(componentType);
+	}
+}
+
+
+// reimplemented (icomp::IComponentStaticInfo)
+
+int CMappedComponentStaticInfo::GetComponentType() const
+{
+	return m_componentType;
+}
+
+
+const IAttributeStaticInfo* CMappedComponentStaticInfo::GetAttributeInfo(const QByteArray& attributeId) const
+{
+	QMutexLocker lock(&m_infosMutex);
+
+	AttributeInfos::ConstIterator foundIter = m_attributeInfos.constFind(attributeId);
+	if (foundIter != m_attributeInfos.constEnd()){
+		return foundIter.value().GetPtr();
+	}
+
+	quint32 recordOffset = m_packageInfo.FindEntry(
+				m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_ATTRIBUTES),
+				attributeId);
+	if (recordOffset == CMappedPackageStaticInfo::NO_RECORD){
+		return NULL;
+	}
+
+	CMappedAttributeStaticInfo* infoPtr = new CMappedAttributeStaticInfo(m_packageInfo, recordOffset);
+	m_attributeInfos[attributeId].SetPtr(infoPtr);
+
+	return infoPtr;
+}
+
+
+const IComponentStaticInfo* CMappedComponentStaticInfo::GetEmbeddedComponentInfo(const QByteArray& embeddedId) const
+{
+	QMutexLocker lock(&m_infosMutex);
+
+	EmbeddedComponentInfos::ConstIterator foundIter = m_embeddedComponentInfos.constFind(embeddedId);
+	if (foundIter != m_embeddedComponentInfos.constEnd()){
+		return foundIter.value().GetPtr();
+	}
+
+	quint32 recordOffset = m_packageInfo.FindEntry(
+				m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_EMBEDDED_COMPONENTS),
+				embeddedId);
+	if (recordOffset == CMappedPackageStaticInfo::NO_RECORD){
+		return NULL;
+	}
+
+	CMappedComponentStaticInfo* infoPtr = new CMappedComponentStaticInfo(m_packageInfo, recordOffset);
+	m_embeddedComponentInfos[embeddedId].SetPtr(infoPtr);
+
+	return infoPtr;
+}
+
+
+const QString& CMappedComponentStaticInfo::GetDescription() const
+{
+	return m_description;
+}
+
+
+const QString& CMappedComponentStaticInfo::GetKeywords() const
+{
+	return m_keywords;
+}
+
+
+// reimplemented (icomp::IElementStaticInfo)
+
+IElementStaticInfo::Ids CMappedComponentStaticInfo::GetMetaIds(int metaGroupId) const
+{
+	if (metaGroupId == MGI_INTERFACES){
+		return m_packageInfo.GetIdList(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_INTERFACES));
+	}
+	else if (metaGroupId == MGI_SUBELEMENTS){
+		return m_packageInfo.GetEntryIds(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_SUBELEMENTS));
+	}
+	else if (metaGroupId == MGI_EMBEDDED_COMPONENTS){
+		return m_packageInfo.GetEntryIds(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_EMBEDDED_COMPONENTS));
+	}
+
+	return Ids();
+}
+
+
+const IElementStaticInfo* CMappedComponentStaticInfo::GetSubelementInfo(const QByteArray& subcomponentId) const
+{
+	QMutexLocker lock(&m_infosMutex);
+
+	SubelementInfos::ConstIterator foundIter = m_subelementInfos.constFind(subcomponentId);
+	if (foundIter != m_subelementInfos.constEnd()){
+		return foundIter.value().GetPtr();
+	}
+
+	quint32 recordOffset = m_packageInfo.FindEntry(
+				m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_SUBELEMENTS),
+				subcomponentId);
+	if (recordOffset == CMappedPackageStaticInfo::NO_RECORD){
+		return NULL;
+	}
+
+	CMappedElementStaticInfo* infoPtr = new CMappedElementStaticInfo(m_packageInfo, recordOffset);
+	m_subelementInfos[subcomponentId].SetPtr(infoPtr);
+
+	return infoPtr;
+}
+
+
+// reimplemented (iattr::IAttributesMetaInfoProvider)
+
+iattr::IAttributesProvider::AttributeIds CMappedComponentStaticInfo::GetAttributeMetaIds() const
+{
+	return m_packageInfo.GetEntryIds(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::CW_ATTRIBUTES));
+}
+
+
+const iattr::IAttributeMetaInfo* CMappedComponentStaticInfo::GetAttributeMetaInfo(const QByteArray& attributeId) const
+{
+	return CMappedComponentStaticInfo::GetAttributeInfo(attributeId);
+}
+
+
+} // namespace icomp
+
+
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+// ACF includes
+#include <istd/TDelPtr.h>
+#include <icomp/CComponentStaticInfoBase.h>
+#include <icomp/CMappedElementStaticInfo.h>
+#include <icomp/CMappedAttributeStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+class CMappedPackageStaticInfo;
+
+
+/**
+	Component static info reading its meta-information in place from the mapped package cache file.
+	Static info objects of subelements, embedded components and attributes are created first on demand.
+
+	\note This class does not support component instantiation (CreateComponent)
+	as it only provides meta-information for display purposes (e.g. Compositor UI).
+	\sa CMappedPackageStaticInfo
+*/
+class CMappedComponentStaticInfo: public CComponentStaticInfoBase
+{
+public:
+	typedef CComponentStaticInfoBase BaseClass;
+
+	/**
+		Create component info for some record in the mapped cache file.
+		The package info must exist during whole lifetime of this object.
+	*/
+	CMappedComponentStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset);
+
+	// reimplemented (icomp::IComponentStaticInfo)
+	virtual int GetComponentType() const override;
+	virtual const IAttributeStaticInfo* GetAttributeInfo(const QByteArray& attributeId) const override;
+	virtual const IComponentStaticInfo* GetEmbeddedComponentInfo(const QByteArray& embeddedId) const override;
+	virtual const QString& GetDescription() const override;
+	virtual const QString& GetKeywords() const override;
+
+	// reimplemented (icomp::IElementStaticInfo)
+	virtual Ids GetMetaIds(int metaGroupId) const override;
+	virtual const IElementStaticInfo* GetSubelementInfo(const QByteArray& subcomponentId) const override;
+
+	// reimplemented (iattr::IAttributesMetaInfoProvider)
+	virtual iattr::IAttributesProvider::AttributeIds GetAttributeMetaIds() const override;
+	virtual const iattr::IAttributeMetaInfo* GetAttributeMetaInfo(const QByteArray& attributeId) const override;
+
+private:
+	const CMappedPackageStaticInfo& m_packageInfo;
+	quint32 m_recordOffset;
+
+	QString m_description;
+	QString m_keywords;
+	int m_componentType;
+
+	typedef QMap<QByteArray, istd::TDelPtr<CMappedElementStaticInfo>> SubelementInfos;
+	mutable SubelementInfos m_subelementInfos;
+
+	typedef QMap<QByteArray, istd::TDelPtr<CMappedComponentStaticInfo>> EmbeddedComponentInfos;
+	mutable EmbeddedComponentInfos m_embeddedComponentInfos;
+
+	typedef QMap<QByteArray, istd::TDelPtr<CMappedAttributeStaticInfo>> AttributeInfos;
+	mutable AttributeInfos m_attributeInfos;
+
+	mutable QMutex m_infosMutex;
+};
+
+
+} // namespace icomp
+
+
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <icomp/CMappedElementStaticInfo.h>
+
+
+// ACF includes
+#include <icomp/CMappedPackageStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+// public methods
+
+CMappedElementStaticInfo::CMappedElementStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset)
+:	m_packageInfo(packageInfo),
+	m_recordOffset(recordOffset)
+{
+}
+
+
+// reimplemented (icomp::IElementStaticInfo)
+
+IElementStaticInfo::Ids CMappedElementStaticInfo::GetMetaIds(int metaGroupId) const
+{
+	if (metaGroupId == MGI_INTERFACES){
+		return m_packageInfo.GetIdList(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::EW_INTERFACES));
+	}
+	else if (metaGroupId == MGI_SUBELEMENTS){
+		return m_packageInfo.GetEntryIds(m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::EW_SUBELEMENTS));
+	}
+
+	return Ids();
+}
+
+
+const IElementStaticInfo* CMappedElementStaticInfo::GetSubelementInfo(const QByteArray& subcomponentId) const
+{
+	QMutexLocker lock(&m_subelementInfosMutex);
+
+	SubelementInfos::ConstIterator foundIter = m_subelementInfos.constFind(subcomponentId);
+	if (foundIter != m_subelementInfos.constEnd()){
+		return foundIter.value().GetPtr();
+	}
+
+	quint32 recordOffset = m_packageInfo.FindEntry(
+				m_packageInfo.GetRecordWord(m_recordOffset, CMappedPackageStaticInfo::EW_SUBELEMENTS),
+				subcomponentId);
+	if (recordOffset == CMappedPackageStaticInfo::NO_RECORD){
+		return NULL;
+	}
+
+	CMappedElementStaticInfo* infoPtr = new CMappedElementStaticInfo(m_packageInfo, recordOffset);
+	m_subelementInfos[subcomponentId].SetPtr(infoPtr);
+
+	return infoPtr;
+}
+
+
+} // namespace icomp
+
+
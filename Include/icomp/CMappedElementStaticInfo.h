@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+
+// ACF includes
+#include <istd/TDelPtr.h>
+#include <icomp/IElementStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+class CMappedPackageStaticInfo;
+
+
+/**
+	Subelement static info reading its meta-information in place from the mapped package cache file.
+	\sa CMappedPackageStaticInfo
+*/
+class CMappedElementStaticInfo: virtual public IElementStaticInfo
+{
+public:
+	/**
+		Create subelement info for some record in the mapped cache file.
+		The package info must exist during whole lifetime of this object.
+	*/
+	CMappedElementStaticInfo(const CMappedPackageStaticInfo& packageInfo, quint32 recordOffset);
+
+	// reimplemented (icomp::IElementStaticInfo)
+	virtual Ids GetMetaIds(int metaGroupId) const override;
+	virtual const IElementStaticInfo* GetSubelementInfo(const QByteArray& subcomponentId) const override;
+
+private:
+	const CMappedPackageStaticInfo& m_packageInfo;
+	quint32 m_recordOffset;
+
+	typedef QMap<QByteArray, istd::TDelPtr<CMappedElementStaticInfo>> SubelementInfos;
+	mutable SubelementInfos m_subelementInfos;
+	mutable QMutex m_subelementInfosMutex;
+};
+
+
+} // namespace icomp
+
+
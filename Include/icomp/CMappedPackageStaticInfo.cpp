@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <icomp/CMappedPackageStaticInfo.h>
+
+
+// Qt includes
+#include <QtCore/QtEndian>
+
+// ACF includes
+#include <icomp/CMappedComponentStaticInfo.h>
+#include <icomp/CPackageMetaInfoCache.h>
+
+
+namespace icomp
+{
+
+
+// public methods
+
+CMappedPackageStaticInfo::CMappedPackageStaticInfo()
+:	m_dataPtr(NULL),
+	m_dataSize(0),
+	m_stringsCount(0),
+	m_stringsOffset(0),
+	m_recordsOffset(0),
+	m_recordsSize(0),
+	m_packageFileSize(0),
+	m_packageModificationTime(0)
+{
+}
+
+
+CMappedPackageStaticInfo::~CMappedPackageStaticInfo()
+{
+	// component infos refer to the mapped data, they must be removed before the file is unmapped
+	BaseClass::Reset();
+
+	CloseFile();
+}
+
+
+bool CMappedPackageStaticInfo::OpenFile(const QString& filePath)
+{
+	BaseClass::Reset();
+
+	CloseFile();
+
+	m_file.setFileName(filePath);
+	if (!m_file.open(QIODevice::ReadOnly)){
+		return false;
+	}
+
+	qint64 fileSize = m_file.size();
+	if ((fileSize < qint64(HW_COUNT * sizeof(quint32))) || (fileSize > qint64(NO_RECORD))){
+		CloseFile();
+
+		return false;
+	}
+
+	m_dataPtr = m_file.map(0, fileSize);
+	if (m_dataPtr == NULL){
+		// some file systems don't support mapping, use the file content instead
+		m_fileContent = m_file.readAll();
+		if (m_fileContent.size() != fileSize){
+			CloseFile();
+
+			return false;
+		}
+
+		m_dataPtr = reinterpret_cast<const uchar*>(m_fileContent.constData());
+	}
+
+	m_dataSize = quint32(fileSize);
+
+	if ((GetWord(HW_MAGIC * sizeof(quint32)) != CPackageMetaInfoCache::CACHE_MAGIC) || (GetWord(HW_VERSION * sizeof(quint32)) != FORMAT_VERSION)){
+		CloseFile();
+
+		return false;
+	}
+
+	m_packageFileSize = qint64(GetWord(HW_PACKAGE_SIZE_LOW * sizeof(quint32))) | (qint64(GetWord(HW_PACKAGE_SIZE_HIGH * sizeof(quint32))) << 32);
+	m_packageModificationTime = qint64(GetWord(HW_PACKAGE_TIME_LOW * sizeof(quint32))) | (qint64(GetWord(HW_PACKAGE_TIME_HIGH * sizeof(quint32))) << 32);
+
+	m_stringsCount = GetWord(HW_STRINGS_COUNT * sizeof(quint32));
+	m_stringsOffset = GetWord(HW_STRINGS_OFFSET * sizeof(quint32));
+	m_recordsOffset = GetWord(HW_RECORDS_OFFSET * sizeof(quint32));
+	m_recordsSize = GetWord(HW_RECORDS_SIZE * sizeof(quint32));
+
+	if (		(m_stringsCount > (m_dataSize / (2 * sizeof(quint32)))) ||
+				!IsFileRangeValid(m_stringsOffset, m_stringsCount * 2 * sizeof(quint32)) ||
+				!IsFileRangeValid(m_recordsOffset, m_recordsSize)){
+		CloseFile();
+
+		return false;
+	}
+
+	// validate all string entries once, so strings can be accessed without further checks
+	for (quint32 stringIndex = 0; stringIndex < m_stringsCount; ++stringIndex){
+		quint32 entryOffset = m_stringsOffset + stringIndex * 2 * sizeof(quint32);
+		if (!IsFileRangeValid(GetWord(entryOffset), GetWord(entryOffset + sizeof(quint32)))){
+			CloseFile();
+
+			return false;
+		}
+	}
+
+	m_description = QString::fromUtf8(GetRawString(GetWord(HW_DESCRIPTION * sizeof(quint32))));
+	m_keywords = QString::fromUtf8(GetRawString(GetWord(HW_KEYWORDS * sizeof(quint32))));
+
+	quint32 componentsOffset = GetWord(HW_COMPONENTS * sizeof(quint32));
+	quint32 componentsCount = GetRecordWord(componentsOffset, 0);
+	if (componentsCount == NO_RECORD){
+		CloseFile();
+
+		return false;
+	}
+
+	for (quint32 i = 0; i < componentsCount; ++i){
+		quint32 idIndex = GetRecordWord(componentsOffset, 1 + i * 2);
+		quint32 recordOffset = GetRecordWord(componentsOffset, 2 + i * 2);
+		if ((idIndex >= m_stringsCount) || (recordOffset == NO_RECORD)){
+			BaseClass::Reset();
+
+			CloseFile();
+
+			return false;
+		}
+
+		RegisterCachedComponentInfo(GetString(idIndex), new CMappedComponentStaticInfo(*this, recordOffset));
+	}
+
+	return true;
+}
+
+
+qint64 CMappedPackageStaticInfo::GetPackageFileSize() const
+{
+	return m_packageFileSize;
+}
+
+
+qint64 CMappedPackageStaticInfo::GetPackageModificationTime() const
+{
+	return m_packageModificationTime;
+}
+
+
+QByteArray CMappedPackageStaticInfo::GetRawString(quint32 stringIndex) const
+{
+	if (stringIndex >= m_stringsCount){
+		return QByteArray();
+	}
+
+	quint32 entryOffset = m_stringsOffset + stringIndex * 2 * sizeof(quint32);
+
+	return QByteArray::fromRawData(reinterpret_cast<const char*>(m_dataPtr + GetWord(entryOffset)), int(GetWord(entryOffset + sizeof(quint32))));
+}
+
+
+QByteArray CMappedPackageStaticInfo::GetString(quint32 stringIndex) const
+{
+	if (stringIndex >= m_stringsCount){
+		return QByteArray();
+	}
+
+	quint32 entryOffset = m_stringsOffset + stringIndex * 2 * sizeof(quint32);
+
+	return QByteArray(reinterpret_cast<const char*>(m_dataPtr + GetWord(entryOffset)), int(GetWord(entryOffset + sizeof(quint32))));
+}
+
+
+quint32 CMappedPackageStaticInfo::GetRecordWord(quint32 recordOffset, int wordIndex) const
+{
+	quint64 wordOffset = quint64(recordOffset) + quint64(wordIndex) * sizeof(quint32);
+	if ((recordOffset == NO_RECORD) || (wordOffset + sizeof(quint32) > m_recordsSize)){
+		return NO_RECORD;
+	}
+
+	return GetWord(m_recordsOffset + quint32(wordOffset));
+}
+
+
+const char* CMappedPackageStaticInfo::GetRecordData(quint32 recordOffset, quint32 size) const
+{
+	if ((recordOffset == NO_RECORD) || (quint64(recordOffset) + size > m_recordsSize)){
+		return NULL;
+	}
+
+	return reinterpret_cast<const char*>(m_dataPtr + m_recordsOffset + recordOffset);
+}
+
+
+IElementStaticInfo::Ids CMappedPackageStaticInfo::GetIdList(quint32 listOffset) const
+{
+	IElementStaticInfo::Ids retVal;
+
+	quint32 count = GetRecordWord(listOffset, 0);
+	if ((count == NO_RECORD) || (GetRecordData(listOffset, (count + 1) * sizeof(quint32)) == NULL)){
+		return retVal;
+	}
+
+	retVal.reserve(int(count));
+
+	for (quint32 i = 0; i < count; ++i){
+		retVal.insert(GetString(GetRecordWord(listOffset, 1 + i)));
+	}
+
+	return retVal;
+}
+
+
+IElementStaticInfo::Ids CMappedPackageStaticInfo::GetEntryIds(quint32 listOffset) const
+{
+	IElementStaticInfo::Ids retVal;
+
+	quint32 count = GetRecordWord(listOffset, 0);
+	if ((count == NO_RECORD) || (GetRecordData(listOffset, (count * 2 + 1) * sizeof(quint32)) == NULL)){
+		return retVal;
+	}
+
+	retVal.reserve(int(count));
+
+	for (quint32 i = 0; i < count; ++i){
+		retVal.insert(GetString(GetRecordWord(listOffset, 1 + i * 2)));
+	}
+
+	return retVal;
+}
+
+
+quint32 CMappedPackageStaticInfo::FindEntry(quint32 listOffset, const QByteArray& id) const
+{
+	quint32 count = GetRecordWord(listOffset, 0);
+	if ((count == NO_RECORD) || (GetRecordData(listOffset, (count * 2 + 1) * sizeof(quint32)) == NULL)){
+		return NO_RECORD;
+	}
+
+	// entries are sorted by ID
+	quint32 lowerIndex = 0;
+	quint32 upperIndex = count;
+	while (lowerIndex < upperIndex){
+		quint32 middleIndex = lowerIndex + (upperIndex - lowerIndex) / 2;
+
+		QByteArray middleId = GetRawString(GetRecordWord(listOffset, 1 + middleIndex * 2));
+		if (middleId < id){
+			lowerIndex = middleIndex + 1;
+		}
+		else if (id < middleId){
+			upperIndex = middleIndex;
+		}
+		else{
+			return GetRecordWord(listOffset, 2 + middleIndex * 2);
+		}
+	}
+
+	return NO_RECORD;
+}
+
+
+// reimplemented (icomp::IComponentStaticInfo)
+
+const QString& CMappedPackageStaticInfo::GetDescription() const
+{
+	return m_description;
+}
+
+
+const QString& CMappedPackageStaticInfo::GetKeywords() const
+{
+	return m_keywords;
+}
+
+
+// private methods
+
+quint32 CMappedPackageStaticInfo::GetWord(quint32 fileOffset) const
+{
+	Q_ASSERT(fileOffset + sizeof(quint32) <= m_dataSize);
+
+	return qFromLittleEndian<quint32>(m_dataPtr + fileOffset);
+}
+
+
+bool CMappedPackageStaticInfo::IsFileRangeValid(quint32 offset, quint32 size) const
+{
+	return quint64(offset) + size <= m_dataSize;
+}
+
+
+void CMappedPackageStaticInfo::CloseFile()
+{
+	if (m_file.isOpen()){
+		if (m_dataPtr != NULL && m_fileContent.isEmpty()){
+			m_file.unmap(const_cast<uchar*>(m_dataPtr));
+		}
+
+		m_file.close();
+	}
+
+	m_fileContent.clear();
+	m_dataPtr = NULL;
+	m_dataSize = 0;
+	m_stringsCount = 0;
+	m_stringsOffset = 0;
+	m_recordsOffset = 0;
+	m_recordsSize = 0;
+	m_packageFileSize = 0;
+	m_packageModificationTime = 0;
+	m_description.clear();
+	m_keywords.clear();
+}
+
+
+} // namespace icomp
+
+
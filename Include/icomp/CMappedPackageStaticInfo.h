@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+// ACF includes
+#include <icomp/CPackageStaticInfo.h>
+
+
+namespace icomp
+{
+
+
+/**
+	Package static info working directly on the flat binary cache file of package meta-information.
+	The cache file is mapped into memory and all meta-information is read in place,
+	the static info objects of components, subelements and attributes are created first on demand.
+
+	The file consists of a header, a string table and a section of records.
+	All numbers are stored as little endian 32-bit words and all references are offsets,
+	so the file content is relocatable and needs no parsing on load.
+	String table entries contain offset and size of UTF-8 encoded string data relative to the file begin.
+	Record offsets are relative to the begin of the records section.
+	Lists of IDs and lists of named entries are sorted by ID to allow binary search in place.
+*/
+class CMappedPackageStaticInfo: public CPackageStaticInfo
+{
+public:
+	typedef CPackageStaticInfo BaseClass;
+
+	enum
+	{
+		/**
+			Version of the flat cache file format.
+		*/
+		FORMAT_VERSION = 5,
+		/**
+			Offset used for not existing record.
+		*/
+		NO_RECORD = 0xffffffff
+	};
+
+	/**
+		Word indices in the file header.
+	*/
+	enum HeaderWord
+	{
+		HW_MAGIC,
+		HW_VERSION,
+		HW_PACKAGE_SIZE_LOW,
+		HW_PACKAGE_SIZE_HIGH,
+		HW_PACKAGE_TIME_LOW,
+		HW_PACKAGE_TIME_HIGH,
+		HW_STRINGS_COUNT,
+		HW_STRINGS_OFFSET,
+		HW_RECORDS_OFFSET,
+		HW_RECORDS_SIZE,
+		HW_DESCRIPTION,
+		HW_KEYWORDS,
+		/**
+			Entry list of the package components.
+		*/
+		HW_COMPONENTS,
+		HW_COUNT
+	};
+
+	/**
+		Word indices in the component record.
+	*/
+	enum ComponentWord
+	{
+		CW_DESCRIPTION,
+		CW_KEYWORDS,
+		CW_COMPONENT_TYPE,
+		/**
+			ID list of interfaces.
+		*/
+		CW_INTERFACES,
+		/**
+			Entry list of subelement records.
+		*/
+		CW_SUBELEMENTS,
+		/**
+			Entry list of embedded component records.
+		*/
+		CW_EMBEDDED_COMPONENTS,
+		/**
+			Entry list of attribute records.
+		*/
+		CW_ATTRIBUTES,
+		CW_COUNT
+	};
+
+	/**
+		Word indices in the subelement record.
+	*/
+	enum ElementWord
+	{
+		EW_INTERFACES,
+		EW_SUBELEMENTS,
+		EW_COUNT
+	};
+
+	/**
+		Word indices in the attribute record.
+		Attribute record is followed by the related IDs, each of them stored as triple of meta group ID, string index and flags.
+	*/
+	enum AttributeWord
+	{
+		AW_DESCRIPTION,
+		AW_TYPE_ID,
+		AW_FLAGS,
+		/**
+			Record of the serialized default value, it is stored as size followed by data.
+		*/
+		AW_DEFAULT_VALUE,
+		AW_RELATED_IDS_COUNT,
+		AW_COUNT
+	};
+
+	CMappedPackageStaticInfo();
+	virtual ~CMappedPackageStaticInfo();
+
+	/**
+		Open the cache file and register all package components.
+		Only the header and the string table are validated, the records are checked on access.
+		\return	true, if the file is a valid cache file.
+	*/
+	bool OpenFile(const QString& filePath);
+
+	/**
+		Get size of the package file stored in the cache header.
+	*/
+	qint64 GetPackageFileSize() const;
+
+	/**
+		Get modification time of the package file stored in the cache header, in milliseconds since epoch (UTC).
+	*/
+	qint64 GetPackageModificationTime() const;
+
+	/**
+		Get string from the string table, the returned array points directly to the mapped data.
+	*/
+	QByteArray GetRawString(quint32 stringIndex) const;
+
+	/**
+		Get string from the string table as a deep copy.
+	*/
+	QByteArray GetString(quint32 stringIndex) const;
+
+	/**
+		Get some word of the record.
+		\return	word value or \c NO_RECORD, if the record is out of range.
+	*/
+	quint32 GetRecordWord(quint32 recordOffset, int wordIndex) const;
+
+	/**
+		Get pointer to data of the record.
+		\return	pointer to data or NULL, if the record is out of range.
+	*/
+	const char* GetRecordData(quint32 recordOffset, quint32 size) const;
+
+	/**
+		Get all IDs stored in ID list.
+	*/
+	IElementStaticInfo::Ids GetIdList(quint32 listOffset) const;
+
+	/**
+		Get IDs of all entries stored in entry list.
+	*/
+	IElementStaticInfo::Ids GetEntryIds(quint32 listOffset) const;
+
+	/**
+		Find record offset of some entry in entry list.
+		\return	record offset or \c NO_RECORD, if no entry was found.
+	*/
+	quint32 FindEntry(quint32 listOffset, const QByteArray& id) const;
+
+	// reimplemented (icomp::IComponentStaticInfo)
+	virtual const QString& GetDescription() const override;
+	virtual const QString& GetKeywords() const override;
+
+private:
+	quint32 GetWord(quint32 fileOffset) const;
+	bool IsFileRangeValid(quint32 offset, quint32 size) const;
+	void CloseFile();
+
+	QFile m_file;
+	QByteArray m_fileContent;
+	const uchar* m_dataPtr;
+	quint32 m_dataSize;
+
+	quint32 m_stringsCount;
+	quint32 m_stringsOffset;
+	quint32 m_recordsOffset;
+	quint32 m_recordsSize;
+
+	qint64 m_packageFileSize;
+	qint64 m_packageModificationTime;
+
+	QString m_description;
+	QString m_keywords;
+};
+
+
+} // namespace icomp
+
+
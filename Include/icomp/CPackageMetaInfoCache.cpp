@@ -2,18 +2,20 @@
 #include <icomp/CPackageMetaInfoCache.h>
 
 
+// STL includes
+#include <algorithm>
+
 // Qt includes
 #include <QtCore/QDir>
-#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
-#include <QtCore/QDataStream>
+#include <QtCore/QHash>
 #include <QtCore/QPair>
 #include <QtCore/QSaveFile>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
 
 // ACF includes
-#include <icomp/CCachedComponentStaticInfo.h>
-#include <icomp/CCachedElementStaticInfo.h>
-#include <icomp/CCachedAttributeStaticInfo.h>
+#include <icomp/CMappedPackageStaticInfo.h>
 #include <icomp/IAttributeStaticInfo.h>
 #include <icomp/CReferenceAttribute.h>
 #include <icomp/CFactoryAttribute.h>
@@ -24,601 +26,452 @@
 #include <iattr/TAttribute.h>
 #include <iattr/TMultiAttribute.h>
 #include <iser/CMemoryWriteArchive.h>
-#include <iser/CMemoryReadArchive.h>
 
 
-namespace icomp
+namespace
 {
 
 
-// static constants
+/**
+	Writer of the flat cache file format.
+	Records of children are written before records of their parents, so each record refers only to already known offsets.
+	\sa icomp::CMappedPackageStaticInfo
+*/
+class CCacheFileWriter
+{
+public:
+	QByteArray CreateFileData(const icomp::CPackageStaticInfo& packageInfo, qint64 packageFileSize, qint64 packageModificationTime)
+	{
+		quint32 componentsOffset = WriteEmbeddedComponents(packageInfo);
+		quint32 descriptionIndex = AddString(packageInfo.GetDescription().toUtf8());
+		quint32 keywordsIndex = AddString(packageInfo.GetKeywords().toUtf8());
+
+		QVector<quint32> header(icomp::CMappedPackageStaticInfo::HW_COUNT, 0);
+		header[icomp::CMappedPackageStaticInfo::HW_MAGIC] = icomp::CPackageMetaInfoCache::CACHE_MAGIC;
+		header[icomp::CMappedPackageStaticInfo::HW_VERSION] = icomp::CMappedPackageStaticInfo::FORMAT_VERSION;
+		header[icomp::CMappedPackageStaticInfo::HW_PACKAGE_SIZE_LOW] = quint32(quint64(packageFileSize) & 0xffffffff);
+		header[icomp::CMappedPackageStaticInfo::HW_PACKAGE_SIZE_HIGH] = quint32(quint64(packageFileSize) >> 32);
+		header[icomp::CMappedPackageStaticInfo::HW_PACKAGE_TIME_LOW] = quint32(quint64(packageModificationTime) & 0xffffffff);
+		header[icomp::CMappedPackageStaticInfo::HW_PACKAGE_TIME_HIGH] = quint32(quint64(packageModificationTime) >> 32);
+		header[icomp::CMappedPackageStaticInfo::HW_DESCRIPTION] = descriptionIndex;
+		header[icomp::CMappedPackageStaticInfo::HW_KEYWORDS] = keywordsIndex;
+		header[icomp::CMappedPackageStaticInfo::HW_COMPONENTS] = componentsOffset;
+
+		quint32 stringsOffset = quint32(header.size() * sizeof(quint32));
+		quint32 stringsDataOffset = stringsOffset + quint32(m_strings.size() * 2 * sizeof(quint32));
+
+		QByteArray stringsTable;
+		QByteArray stringsData;
+		for (		QVector<QByteArray>::ConstIterator iter = m_strings.constBegin();
+					iter != m_strings.constEnd();
+					++iter){
+			AppendWord(stringsTable, stringsDataOffset + quint32(stringsData.size()));
+			AppendWord(stringsTable, quint32(iter->size()));
+
+			stringsData.append(*iter);
+		}
 
-static const quint32 s_cacheMagic = 0x41434643; // "ACFC"
-static const qint32 s_cacheVersion = 4;
+		AlignData(stringsData);
 
+		header[icomp::CMappedPackageStaticInfo::HW_STRINGS_COUNT] = quint32(m_strings.size());
+		header[icomp::CMappedPackageStaticInfo::HW_STRINGS_OFFSET] = stringsOffset;
+		header[icomp::CMappedPackageStaticInfo::HW_RECORDS_OFFSET] = stringsDataOffset + quint32(stringsData.size());
+		header[icomp::CMappedPackageStaticInfo::HW_RECORDS_SIZE] = quint32(m_records.size());
 
-static iser::IObject* CreateAttributeByTypeId(const QByteArray& typeId)
-{
-	if (typeId == iattr::CIntegerAttribute::GetTypeName()){
-		return new iattr::CIntegerAttribute();
-	}
-	else if (typeId == iattr::CRealAttribute::GetTypeName()){
-		return new iattr::CRealAttribute();
-	}
-	else if (typeId == iattr::CBooleanAttribute::GetTypeName()){
-		return new iattr::CBooleanAttribute();
-	}
-	else if (typeId == iattr::CStringAttribute::GetTypeName()){
-		return new iattr::CStringAttribute();
-	}
-	else if (typeId == iattr::CIdAttribute::GetTypeName()){
-		return new iattr::CIdAttribute();
-	}
-	else if (typeId == icomp::CTextAttribute::GetTypeName()){
-		return new icomp::CTextAttribute();
-	}
-	else if (typeId == iattr::CIntegerListAttribute::GetTypeName()){
-		return new iattr::CIntegerListAttribute();
-	}
-	else if (typeId == iattr::CRealListAttribute::GetTypeName()){
-		return new iattr::CRealListAttribute();
-	}
-	else if (typeId == iattr::CBooleanListAttribute::GetTypeName()){
-		return new iattr::CBooleanListAttribute();
-	}
-	else if (typeId == iattr::CStringListAttribute::GetTypeName()){
-		return new iattr::CStringListAttribute();
-	}
-	else if (typeId == iattr::CIdListAttribute::GetTypeName()){
-		return new iattr::CIdListAttribute();
-	}
-	else if (typeId == icomp::CMultiTextAttribute::GetTypeName()){
-		return new icomp::CMultiTextAttribute();
-	}
-	else if (typeId == icomp::CReferenceAttribute::GetTypeName()){
-		return new icomp::CReferenceAttribute();
-	}
-	else if (typeId == icomp::CMultiReferenceAttribute::GetTypeName()){
-		return new icomp::CMultiReferenceAttribute();
-	}
-	else if (typeId == icomp::CFactoryAttribute::GetTypeName()){
-		return new icomp::CFactoryAttribute();
-	}
-	else if (typeId == icomp::CMultiFactoryAttribute::GetTypeName()){
-		return new icomp::CMultiFactoryAttribute();
-	}
-
-	return NULL;
-}
+		QByteArray retVal;
+		retVal.reserve(int(header[icomp::CMappedPackageStaticInfo::HW_RECORDS_OFFSET]) + m_records.size());
 
+		for (int i = 0; i < header.size(); ++i){
+			AppendWord(retVal, header[i]);
+		}
 
-// public static methods
+		retVal.append(stringsTable);
+		retVal.append(stringsData);
+		retVal.append(m_records);
 
-CPackageStaticInfo* CPackageMetaInfoCache::LoadFromCacheIfValid(const QString& packageFilePath, const QString& cacheFilePath)
-{
-	// Strategy 5: Fast filesystem-based pre-check using modification times.
-	// This avoids opening the cache file at all when the package is newer.
-	QFileInfo cacheFileInfo(cacheFilePath);
-	if (!cacheFileInfo.exists()){
-		return NULL;
+		return retVal;
 	}
 
-	QFileInfo packageFileInfo(packageFilePath);
-	if (!packageFileInfo.exists()){
-		return NULL;
-	}
+private:
+	typedef QPair<QByteArray, quint32> Entry;
+	typedef QVector<Entry> Entries;
 
-	if (packageFileInfo.lastModified() > cacheFileInfo.lastModified()){
-		return NULL;
-	}
+	static void AppendWord(QByteArray& data, quint32 word)
+	{
+		char buffer[sizeof(quint32)];
+		qToLittleEndian<quint32>(word, buffer);
 
-	// Strategy 1 + 3: Single file open with binary format for combined validation + loading.
-	QFile cacheFile(cacheFilePath);
-	if (!cacheFile.open(QIODevice::ReadOnly)){
-		return NULL;
+		data.append(buffer, sizeof(quint32));
 	}
 
-	QDataStream stream(&cacheFile);
-	stream.setVersion(QDataStream::Qt_5_0);
+	static void AlignData(QByteArray& data)
+	{
+		while ((data.size() % sizeof(quint32)) != 0){
+			data.append('\0');
+		}
+	}
 
-	// Read and validate header
-	quint32 magic;
-	qint32 version;
-	stream >> magic >> version;
-	if (magic != s_cacheMagic || version != s_cacheVersion){
-		return NULL;
+	static bool IsEntryLess(const Entry& entry1, const Entry& entry2)
+	{
+		return entry1.first < entry2.first;
 	}
 
-	// Read stored validation data
-	QString storedLastModified;
-	qint64 storedFileSize;
-	stream >> storedLastModified >> storedFileSize;
+	quint32 AddString(const QByteArray& text)
+	{
+		QHash<QByteArray, quint32>::ConstIterator foundIter = m_stringIndices.constFind(text);
+		if (foundIter != m_stringIndices.constEnd()){
+			return foundIter.value();
+		}
 
-	if (stream.status() != QDataStream::Ok){
-		return NULL;
-	}
+		quint32 retVal = quint32(m_strings.size());
 
-	// Validate against current package file
-	QString currentLastModified = packageFileInfo.lastModified().toUTC().toString(Qt::ISODate);
-	qint64 currentFileSize = packageFileInfo.size();
+		m_strings.append(text);
+		m_stringIndices[text] = retVal;
 
-	if (storedLastModified != currentLastModified || storedFileSize != currentFileSize){
-		return NULL;
+		return retVal;
 	}
 
-	// Read package-level info
-	QString packageDescription;
-	QString packageKeywords;
-	stream >> packageDescription >> packageKeywords;
+	quint32 WriteWords(const QVector<quint32>& words)
+	{
+		quint32 retVal = quint32(m_records.size());
 
-	if (stream.status() != QDataStream::Ok){
-		return NULL;
-	}
+		for (int i = 0; i < words.size(); ++i){
+			AppendWord(m_records, words[i]);
+		}
 
-	CPackageStaticInfo* packageInfo = new CPackageStaticInfo(packageDescription, packageKeywords);
+		return retVal;
+	}
 
-	// Read components
-	qint32 componentCount;
-	stream >> componentCount;
+	quint32 WriteIdList(const icomp::IElementStaticInfo::Ids& ids)
+	{
+		QList<QByteArray> sortedIds = ids.values();
+		std::sort(sortedIds.begin(), sortedIds.end());
 
-	for (qint32 i = 0; i < componentCount; ++i){
-		QByteArray componentId;
-		stream >> componentId;
+		QVector<quint32> words;
+		words.reserve(sortedIds.size() + 1);
+		words.append(quint32(sortedIds.size()));
 
-		CCachedComponentStaticInfo* componentInfo = DeserializeComponent(stream);
-		if (componentInfo != NULL && stream.status() == QDataStream::Ok){
-			packageInfo->RegisterCachedComponentInfo(componentId, componentInfo);
+		for (		QList<QByteArray>::ConstIterator iter = sortedIds.constBegin();
+					iter != sortedIds.constEnd();
+					++iter){
+			words.append(AddString(*iter));
 		}
-		else{
-			delete componentInfo;
-			delete packageInfo;
-			return NULL;
-		}
-	}
 
-	if (stream.status() != QDataStream::Ok){
-		delete packageInfo;
-		return NULL;
+		return WriteWords(words);
 	}
 
-	return packageInfo;
-}
+	quint32 WriteEntryList(Entries entries)
+	{
+		std::sort(entries.begin(), entries.end(), IsEntryLess);
 
+		QVector<quint32> words;
+		words.reserve(entries.size() * 2 + 1);
+		words.append(quint32(entries.size()));
 
-bool CPackageMetaInfoCache::SaveToCache(const QString& cacheFilePath, const QString& packageFilePath, const CPackageStaticInfo* packageInfo)
-{
-	if (packageInfo == NULL){
-		return false;
+		for (		Entries::ConstIterator iter = entries.constBegin();
+					iter != entries.constEnd();
+					++iter){
+			words.append(AddString(iter->first));
+			words.append(iter->second);
+		}
+
+		return WriteWords(words);
 	}
 
-	QFileInfo packageFileInfo(packageFilePath);
+	quint32 WriteEmbeddedComponents(const icomp::IComponentStaticInfo& componentInfo)
+	{
+		Entries entries;
 
-	// Ensure cache directory exists
-	QFileInfo cacheFileInfo(cacheFilePath);
-	QDir cacheDir = cacheFileInfo.absoluteDir();
-	if (!cacheDir.exists()){
-		if (!cacheDir.mkpath(".")){
-			return false;
+		icomp::IElementStaticInfo::Ids embeddedIds = componentInfo.GetMetaIds(icomp::IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS);
+		for (		icomp::IElementStaticInfo::Ids::ConstIterator iter = embeddedIds.constBegin();
+					iter != embeddedIds.constEnd();
+					++iter){
+			const icomp::IComponentStaticInfo* embeddedInfoPtr = componentInfo.GetEmbeddedComponentInfo(*iter);
+			if (embeddedInfoPtr != NULL){
+				entries.append(Entry(*iter, WriteComponent(*embeddedInfoPtr)));
+			}
 		}
-	}
 
-	// Write atomically using QSaveFile
-	QSaveFile saveFile(cacheFilePath);
-	if (!saveFile.open(QIODevice::WriteOnly)){
-		return false;
+		return WriteEntryList(entries);
 	}
 
-	QDataStream stream(&saveFile);
-	stream.setVersion(QDataStream::Qt_5_0);
+	quint32 WriteComponent(const icomp::IComponentStaticInfo& componentInfo)
+	{
+		QVector<quint32> words(icomp::CMappedPackageStaticInfo::CW_COUNT, 0);
 
-	// Write header
-	stream << s_cacheMagic << s_cacheVersion;
+		words[icomp::CMappedPackageStaticInfo::CW_INTERFACES] = WriteIdList(componentInfo.GetMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES));
+		words[icomp::CMappedPackageStaticInfo::CW_SUBELEMENTS] = WriteSubelements(&componentInfo);
+		words[icomp::CMappedPackageStaticInfo::CW_EMBEDDED_COMPONENTS] = WriteEmbeddedComponents(componentInfo);
 
-	// Write validation data
-	stream << packageFileInfo.lastModified().toUTC().toString(Qt::ISODate);
-	stream << packageFileInfo.size();
+		Entries attributeEntries;
 
-	// Write package-level info
-	stream << packageInfo->GetDescription();
-	stream << packageInfo->GetKeywords();
+		iattr::IAttributesProvider::AttributeIds attributeIds = componentInfo.GetAttributeMetaIds();
+		for (		iattr::IAttributesProvider::AttributeIds::ConstIterator iter = attributeIds.constBegin();
+					iter != attributeIds.constEnd();
+					++iter){
+			const icomp::IAttributeStaticInfo* attributeInfoPtr = componentInfo.GetAttributeInfo(*iter);
+			if (attributeInfoPtr != NULL){
+				attributeEntries.append(Entry(*iter, WriteAttribute(*attributeInfoPtr)));
+			}
+		}
 
-	// Write components - only count non-NULL entries
-	IElementStaticInfo::Ids componentIds = packageInfo->GetMetaIds(IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS);
+		words[icomp::CMappedPackageStaticInfo::CW_ATTRIBUTES] = WriteEntryList(attributeEntries);
+		words[icomp::CMappedPackageStaticInfo::CW_DESCRIPTION] = AddString(componentInfo.GetDescription().toUtf8());
+		words[icomp::CMappedPackageStaticInfo::CW_KEYWORDS] = AddString(componentInfo.GetKeywords().toUtf8());
+		words[icomp::CMappedPackageStaticInfo::CW_COMPONENT_TYPE] = quint32(componentInfo.GetComponentType());
 
-	// Pre-collect valid components to write accurate count
-	QList<QPair<QByteArray, const IComponentStaticInfo*>> validComponents;
-	for (		IElementStaticInfo::Ids::const_iterator it = componentIds.constBegin();
-				it != componentIds.constEnd();
-				++it){
-		const IComponentStaticInfo* componentInfo = packageInfo->GetEmbeddedComponentInfo(*it);
-		if (componentInfo != NULL){
-			validComponents.append(qMakePair(*it, componentInfo));
-		}
+		return WriteWords(words);
 	}
 
-	stream << qint32(validComponents.size());
+	quint32 WriteSubelements(const icomp::IElementStaticInfo* elementInfoPtr)
+	{
+		Entries entries;
 
-	for (		QList<QPair<QByteArray, const IComponentStaticInfo*>>::const_iterator it = validComponents.constBegin();
-				it != validComponents.constEnd();
-				++it){
-		stream << it->first;
-		SerializeComponent(stream, it->second);
-	}
+		if (elementInfoPtr != NULL){
+			icomp::IElementStaticInfo::Ids subelementIds = elementInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_SUBELEMENTS);
+			for (		icomp::IElementStaticInfo::Ids::ConstIterator iter = subelementIds.constBegin();
+						iter != subelementIds.constEnd();
+						++iter){
+				entries.append(Entry(*iter, WriteElement(elementInfoPtr->GetSubelementInfo(*iter))));
+			}
+		}
 
-	if (stream.status() != QDataStream::Ok){
-		return false;
+		return WriteEntryList(entries);
 	}
 
-	return saveFile.commit();
-}
+	quint32 WriteElement(const icomp::IElementStaticInfo* elementInfoPtr)
+	{
+		QVector<quint32> words(icomp::CMappedPackageStaticInfo::EW_COUNT, 0);
 
+		icomp::IElementStaticInfo::Ids interfaceIds;
+		if (elementInfoPtr != NULL){
+			interfaceIds = elementInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES);
+		}
 
-QString CPackageMetaInfoCache::GetCacheFilePath(const QString& packageFilePath, const QString& cacheDir)
-{
-	QFileInfo fileInfo(packageFilePath);
-	QString cacheFileName = fileInfo.fileName() + ".cache.bin";
+		words[icomp::CMappedPackageStaticInfo::EW_INTERFACES] = WriteIdList(interfaceIds);
+		words[icomp::CMappedPackageStaticInfo::EW_SUBELEMENTS] = WriteSubelements(elementInfoPtr);
 
-	if (cacheDir.isEmpty()){
-		return fileInfo.absolutePath() + QDir::separator() + ".acf.cache" + QDir::separator() + cacheFileName;
-	}
-	else{
-		return cacheDir + QDir::separator() + cacheFileName;
+		return WriteWords(words);
 	}
-}
-
 
-// private static methods
-
-void CPackageMetaInfoCache::SerializeComponent(QDataStream& stream, const IComponentStaticInfo* componentInfo)
-{
-	stream << componentInfo->GetDescription();
-	stream << componentInfo->GetKeywords();
-	stream << qint32(componentInfo->GetComponentType());
-
-	// Interfaces
-	IElementStaticInfo::Ids interfaceIds = componentInfo->GetMetaIds(IElementStaticInfo::MGI_INTERFACES);
-	stream << qint32(interfaceIds.size());
-	for (		IElementStaticInfo::Ids::const_iterator it = interfaceIds.constBegin();
-				it != interfaceIds.constEnd();
-				++it){
-		stream << *it;
-	}
-
-	// Subelements (IDs and their info)
-	IElementStaticInfo::Ids subelementIds = componentInfo->GetMetaIds(IElementStaticInfo::MGI_SUBELEMENTS);
-	stream << qint32(subelementIds.size());
-	for (		IElementStaticInfo::Ids::const_iterator it = subelementIds.constBegin();
-				it != subelementIds.constEnd();
-				++it){
-		stream << *it;
-		const IElementStaticInfo* subelementInfo = componentInfo->GetSubelementInfo(*it);
-		SerializeSubelement(stream, subelementInfo);
-	}
-
-	// Embedded components (IDs and their info)
-	IElementStaticInfo::Ids embeddedIds = componentInfo->GetMetaIds(IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS);
-
-	QList<QPair<QByteArray, const IComponentStaticInfo*>> validEmbedded;
-	for (		IElementStaticInfo::Ids::const_iterator it = embeddedIds.constBegin();
-				it != embeddedIds.constEnd();
-				++it){
-		const IComponentStaticInfo* embeddedInfo = componentInfo->GetEmbeddedComponentInfo(*it);
-		if (embeddedInfo != NULL){
-			validEmbedded.append(qMakePair(*it, embeddedInfo));
-		}
-	}
+	quint32 WriteAttribute(const icomp::IAttributeStaticInfo& attributeInfo)
+	{
+		quint32 defaultValueOffset = icomp::CMappedPackageStaticInfo::NO_RECORD;
 
-	stream << qint32(validEmbedded.size());
-	for (		QList<QPair<QByteArray, const IComponentStaticInfo*>>::const_iterator it = validEmbedded.constBegin();
-				it != validEmbedded.constEnd();
-				++it){
-		stream << it->first;
-		SerializeComponent(stream, it->second);
-	}
+		iser::IObject* defaultValuePtr = const_cast<iser::IObject*>(attributeInfo.GetAttributeDefaultValue());
+		if (defaultValuePtr != NULL){
+			iser::CMemoryWriteArchive writeArchive;
+			if (defaultValuePtr->Serialize(writeArchive)){
+				defaultValueOffset = quint32(m_records.size());
 
-	// Attributes - only write non-NULL entries
-	iattr::IAttributesProvider::AttributeIds attributeIds = componentInfo->GetAttributeMetaIds();
+				AppendWord(m_records, quint32(writeArchive.GetBufferSize()));
+				m_records.append(reinterpret_cast<const char*>(writeArchive.GetBuffer()), writeArchive.GetBufferSize());
 
-	QList<QPair<QByteArray, const IAttributeStaticInfo*>> validAttributes;
-	for (		iattr::IAttributesProvider::AttributeIds::const_iterator it = attributeIds.constBegin();
-				it != attributeIds.constEnd();
-				++it){
-		const IAttributeStaticInfo* attrInfo = componentInfo->GetAttributeInfo(*it);
-		if (attrInfo != NULL){
-			validAttributes.append(qMakePair(*it, attrInfo));
+				AlignData(m_records);
+			}
 		}
-	}
 
-	stream << qint32(validAttributes.size());
-	for (		QList<QPair<QByteArray, const IAttributeStaticInfo*>>::const_iterator it = validAttributes.constBegin();
-				it != validAttributes.constEnd();
-				++it){
-		stream << it->first;
-		SerializeAttribute(stream, it->second);
-	}
-}
+		QVector<quint32> relatedWords;
 
+		for (int metaGroupId = icomp::IElementStaticInfo::MGI_INTERFACES; metaGroupId <= icomp::IComponentStaticInfo::MGI_LAST; ++metaGroupId){
+			icomp::IElementStaticInfo::Ids relatedIds = attributeInfo.GetRelatedMetaIds(metaGroupId, 0, 0);
+			if (relatedIds.isEmpty()){
+				continue;
+			}
 
-void CPackageMetaInfoCache::SerializeAttribute(QDataStream& stream, const IAttributeStaticInfo* attributeInfo)
-{
-	stream << attributeInfo->GetAttributeDescription();
-	stream << attributeInfo->GetAttributeTypeId();
-	stream << qint32(attributeInfo->GetAttributeFlags());
-
-	// Default value
-	const iser::IObject* defaultValuePtr = attributeInfo->GetAttributeDefaultValue();
-	bool hasDefaultValue = (defaultValuePtr != NULL);
-	stream << hasDefaultValue;
-
-	if (hasDefaultValue){
-		iser::CMemoryWriteArchive writeArchive;
-		bool serialized = const_cast<iser::IObject*>(defaultValuePtr)->Serialize(writeArchive);
-
-		if (serialized){
-			QByteArray blob(reinterpret_cast<const char*>(writeArchive.GetBuffer()), writeArchive.GetBufferSize());
-			stream << blob;
-		}
-		else{
-			QByteArray emptyBlob;
-			stream << emptyBlob;
-		}
-	}
+			// flags of each ID can be only queried using the flag filter
+			icomp::IElementStaticInfo::Ids referenceIds = attributeInfo.GetRelatedMetaIds(metaGroupId, icomp::IAttributeStaticInfo::AF_REFERENCE, icomp::IAttributeStaticInfo::AF_REFERENCE);
+			icomp::IElementStaticInfo::Ids factoryIds = attributeInfo.GetRelatedMetaIds(metaGroupId, icomp::IAttributeStaticInfo::AF_FACTORY, icomp::IAttributeStaticInfo::AF_FACTORY);
+			icomp::IElementStaticInfo::Ids obligatoryIds = attributeInfo.GetRelatedMetaIds(metaGroupId, iattr::IAttributeMetaInfo::AF_OBLIGATORY, iattr::IAttributeMetaInfo::AF_OBLIGATORY);
+			icomp::IElementStaticInfo::Ids nullableIds = attributeInfo.GetRelatedMetaIds(metaGroupId, iattr::IAttributeMetaInfo::AF_NULLABLE, iattr::IAttributeMetaInfo::AF_NULLABLE);
+
+			for (		icomp::IElementStaticInfo::Ids::ConstIterator iter = relatedIds.constBegin();
+						iter != relatedIds.constEnd();
+						++iter){
+				int idFlags = 0;
+				if (referenceIds.contains(*iter)){
+					idFlags |= icomp::IAttributeStaticInfo::AF_REFERENCE;
+				}
+				if (factoryIds.contains(*iter)){
+					idFlags |= icomp::IAttributeStaticInfo::AF_FACTORY;
+				}
+				if (obligatoryIds.contains(*iter)){
+					idFlags |= iattr::IAttributeMetaInfo::AF_OBLIGATORY;
+				}
+				if (nullableIds.contains(*iter)){
+					idFlags |= iattr::IAttributeMetaInfo::AF_NULLABLE;
+				}
 
-	// Collect related meta groups that have data
-	QList<int> activeGroups;
-	for (int metaGroupId = IElementStaticInfo::MGI_INTERFACES; metaGroupId <= IComponentStaticInfo::MGI_LAST; ++metaGroupId){
-		IElementStaticInfo::Ids relatedIds = attributeInfo->GetRelatedMetaIds(metaGroupId, 0, 0);
-		if (!relatedIds.isEmpty()){
-			activeGroups.append(metaGroupId);
+				relatedWords.append(quint32(metaGroupId));
+				relatedWords.append(AddString(*iter));
+				relatedWords.append(quint32(idFlags));
+			}
 		}
-	}
 
-	stream << qint32(activeGroups.size());
+		QVector<quint32> words(icomp::CMappedPackageStaticInfo::AW_COUNT, 0);
+		words[icomp::CMappedPackageStaticInfo::AW_DESCRIPTION] = AddString(attributeInfo.GetAttributeDescription().toUtf8());
+		words[icomp::CMappedPackageStaticInfo::AW_TYPE_ID] = AddString(attributeInfo.GetAttributeTypeId());
+		words[icomp::CMappedPackageStaticInfo::AW_FLAGS] = quint32(attributeInfo.GetAttributeFlags());
+		words[icomp::CMappedPackageStaticInfo::AW_DEFAULT_VALUE] = defaultValueOffset;
+		words[icomp::CMappedPackageStaticInfo::AW_RELATED_IDS_COUNT] = quint32(relatedWords.size() / 3);
 
-	for (		QList<int>::const_iterator groupIt = activeGroups.constBegin();
-				groupIt != activeGroups.constEnd();
-				++groupIt){
-		int metaGroupId = *groupIt;
-		stream << qint32(metaGroupId);
+		// related IDs must directly follow the attribute record
+		words += relatedWords;
 
-		IElementStaticInfo::Ids relatedIds = attributeInfo->GetRelatedMetaIds(metaGroupId, 0, 0);
+		return WriteWords(words);
+	}
 
-		// Pre-fetch flag-specific ID sets for this meta group
-		IElementStaticInfo::Ids refIds = attributeInfo->GetRelatedMetaIds(metaGroupId, IAttributeStaticInfo::AF_REFERENCE, IAttributeStaticInfo::AF_REFERENCE);
-		IElementStaticInfo::Ids factIds = attributeInfo->GetRelatedMetaIds(metaGroupId, IAttributeStaticInfo::AF_FACTORY, IAttributeStaticInfo::AF_FACTORY);
-		IElementStaticInfo::Ids oblIds = attributeInfo->GetRelatedMetaIds(metaGroupId, iattr::IAttributeMetaInfo::AF_OBLIGATORY, iattr::IAttributeMetaInfo::AF_OBLIGATORY);
-		IElementStaticInfo::Ids nullIds = attributeInfo->GetRelatedMetaIds(metaGroupId, iattr::IAttributeMetaInfo::AF_NULLABLE, iattr::IAttributeMetaInfo::AF_NULLABLE);
+	QHash<QByteArray, quint32> m_stringIndices;
+	QVector<QByteArray> m_strings;
+	QByteArray m_records;
+};
 
-		stream << qint32(relatedIds.size());
 
-		for (		IElementStaticInfo::Ids::const_iterator it = relatedIds.constBegin();
-					it != relatedIds.constEnd();
-					++it){
-			int idFlags = 0;
+} // namespace
 
-			if (refIds.contains(*it)){
-				idFlags |= IAttributeStaticInfo::AF_REFERENCE;
-			}
-			if (factIds.contains(*it)){
-				idFlags |= IAttributeStaticInfo::AF_FACTORY;
-			}
-			if (oblIds.contains(*it)){
-				idFlags |= iattr::IAttributeMetaInfo::AF_OBLIGATORY;
-			}
-			if (nullIds.contains(*it)){
-				idFlags |= iattr::IAttributeMetaInfo::AF_NULLABLE;
-			}
 
-			stream << *it << qint32(idFlags);
-		}
-	}
-}
+namespace icomp
+{
 
 
-CCachedComponentStaticInfo* CPackageMetaInfoCache::DeserializeComponent(QDataStream& stream)
-{
-	QString description;
-	QString keywords;
-	qint32 componentType;
-	stream >> description >> keywords >> componentType;
+// public static methods
 
-	if (stream.status() != QDataStream::Ok){
+CPackageStaticInfo* CPackageMetaInfoCache::LoadFromCacheIfValid(const QString& packageFilePath, const QString& cacheFilePath)
+{
+	// Fast filesystem-based pre-check using modification times.
+	// This avoids opening the cache file at all when the package is newer.
+	QFileInfo cacheFileInfo(cacheFilePath);
+	if (!cacheFileInfo.exists()){
 		return NULL;
 	}
 
-	CCachedComponentStaticInfo* componentInfo = new CCachedComponentStaticInfo(description, keywords, componentType);
-
-	// Interfaces
-	qint32 interfaceCount;
-	stream >> interfaceCount;
-	for (qint32 i = 0; i < interfaceCount; ++i){
-		QByteArray interfaceId;
-		stream >> interfaceId;
-		componentInfo->AddInterfaceId(interfaceId);
+	QFileInfo packageFileInfo(packageFilePath);
+	if (!packageFileInfo.exists()){
+		return NULL;
 	}
 
-	// Subelements (IDs and their info)
-	qint32 subelementCount;
-	stream >> subelementCount;
-	for (qint32 i = 0; i < subelementCount; ++i){
-		QByteArray subelementId;
-		stream >> subelementId;
-
-		CCachedElementStaticInfo* subelementInfo = DeserializeSubelement(stream);
-		if (subelementInfo != NULL && stream.status() == QDataStream::Ok){
-			componentInfo->RegisterSubelementInfo(subelementId, subelementInfo);
-		}
-		else{
-			delete subelementInfo;
-			delete componentInfo;
-			return NULL;
-		}
+	if (packageFileInfo.lastModified() > cacheFileInfo.lastModified()){
+		return NULL;
 	}
 
-	// Embedded components
-	qint32 embeddedCount;
-	stream >> embeddedCount;
-	for (qint32 i = 0; i < embeddedCount; ++i){
-		QByteArray embeddedId;
-		stream >> embeddedId;
-
-		CCachedComponentStaticInfo* embeddedInfo = DeserializeComponent(stream);
-		if (embeddedInfo != NULL && stream.status() == QDataStream::Ok){
-			componentInfo->RegisterEmbeddedComponentInfo(embeddedId, embeddedInfo);
-		}
-		else{
-			delete embeddedInfo;
-			delete componentInfo;
-			return NULL;
-		}
+	// Only the header and the string table are checked here, all records are read in place on demand.
+	istd::TDelPtr<CMappedPackageStaticInfo> packageInfoPtr(new CMappedPackageStaticInfo());
+	if (!packageInfoPtr->OpenFile(cacheFilePath)){
+		return NULL;
 	}
 
-	// Attributes
-	qint32 attributeCount;
-	stream >> attributeCount;
-	for (qint32 i = 0; i < attributeCount; ++i){
-		QByteArray attributeId;
-		stream >> attributeId;
-
-		CCachedAttributeStaticInfo* attrInfo = DeserializeAttribute(stream, attributeId);
-		if (attrInfo != NULL && stream.status() == QDataStream::Ok){
-			componentInfo->RegisterAttributeInfo(attributeId, attrInfo);
-		}
-		else{
-			delete attrInfo;
-			delete componentInfo;
-			return NULL;
-		}
+	// Validate against current package file
+	if (		(packageInfoPtr->GetPackageFileSize() != packageFileInfo.size()) ||
+				(packageInfoPtr->GetPackageModificationTime() != packageFileInfo.lastModified().toMSecsSinceEpoch())){
+		return NULL;
 	}
 
-	return componentInfo;
+	return packageInfoPtr.PopPtr();
 }
 
 
-CCachedAttributeStaticInfo* CPackageMetaInfoCache::DeserializeAttribute(QDataStream& stream, const QByteArray& attributeId)
+bool CPackageMetaInfoCache::SaveToCache(const QString& cacheFilePath, const QString& packageFilePath, const CPackageStaticInfo* packageInfo)
 {
-	QString description;
-	QByteArray typeId;
-	qint32 flags;
-	stream >> description >> typeId >> flags;
-
-	if (stream.status() != QDataStream::Ok){
-		return NULL;
+	if (packageInfo == NULL){
+		return false;
 	}
 
-	CCachedAttributeStaticInfo* attrInfo = new CCachedAttributeStaticInfo(attributeId, description, typeId, flags);
-
-	// Default value
-	bool hasDefaultValue;
-	stream >> hasDefaultValue;
-
-	if (hasDefaultValue){
-		QByteArray blob;
-		stream >> blob;
+	QFileInfo packageFileInfo(packageFilePath);
 
-		if (stream.status() == QDataStream::Ok && !blob.isEmpty()){
-			iser::IObject* defaultValue = CreateAttributeByTypeId(typeId);
-			if (defaultValue != NULL){
-				iser::CMemoryReadArchive readArchive(blob.constData(), blob.size());
-				if (defaultValue->Serialize(readArchive)){
-					attrInfo->SetDefaultValue(defaultValue);
-				}
-				else{
-					delete defaultValue;
-				}
-			}
+	// Ensure cache directory exists
+	QFileInfo cacheFileInfo(cacheFilePath);
+	QDir cacheDir = cacheFileInfo.absoluteDir();
+	if (!cacheDir.exists()){
+		if (!cacheDir.mkpath(".")){
+			return false;
 		}
 	}
 
-	// Related meta groups
-	qint32 groupCount;
-	stream >> groupCount;
+	CCacheFileWriter writer;
+	QByteArray fileData = writer.CreateFileData(*packageInfo, packageFileInfo.size(), packageFileInfo.lastModified().toMSecsSinceEpoch());
 
-	for (qint32 g = 0; g < groupCount; ++g){
-		qint32 metaGroupId;
-		qint32 idCount;
-		stream >> metaGroupId >> idCount;
+	// Write atomically using QSaveFile
+	QSaveFile saveFile(cacheFilePath);
+	if (!saveFile.open(QIODevice::WriteOnly)){
+		return false;
+	}
 
-		for (qint32 j = 0; j < idCount; ++j){
-			QByteArray id;
-			qint32 idFlags;
-			stream >> id >> idFlags;
+	if (saveFile.write(fileData) != fileData.size()){
+		saveFile.cancelWriting();
 
-			attrInfo->AddRelatedMetaId(metaGroupId, id, idFlags);
-		}
+		return false;
 	}
 
-	return attrInfo;
+	return saveFile.commit();
 }
 
 
-void CPackageMetaInfoCache::SerializeSubelement(QDataStream& stream, const IElementStaticInfo* subelementInfo)
+QString CPackageMetaInfoCache::GetCacheFilePath(const QString& packageFilePath, const QString& cacheDir)
 {
-	// Interfaces
-	IElementStaticInfo::Ids interfaceIds;
-	if (subelementInfo != NULL){
-		interfaceIds = subelementInfo->GetMetaIds(IElementStaticInfo::MGI_INTERFACES);
-	}
-	stream << qint32(interfaceIds.size());
-	for (		IElementStaticInfo::Ids::const_iterator it = interfaceIds.constBegin();
-				it != interfaceIds.constEnd();
-				++it){
-		stream << *it;
-	}
-
-	// Nested subelements
-	IElementStaticInfo::Ids nestedSubelementIds;
-	if (subelementInfo != NULL){
-		nestedSubelementIds = subelementInfo->GetMetaIds(IElementStaticInfo::MGI_SUBELEMENTS);
-	}
-	stream << qint32(nestedSubelementIds.size());
-	for (		IElementStaticInfo::Ids::const_iterator it = nestedSubelementIds.constBegin();
-				it != nestedSubelementIds.constEnd();
-				++it){
-		stream << *it;
-		const IElementStaticInfo* nestedInfo = (subelementInfo != NULL) ? subelementInfo->GetSubelementInfo(*it) : NULL;
-		SerializeSubelement(stream, nestedInfo);
+	QFileInfo fileInfo(packageFilePath);
+	QString cacheFileName = fileInfo.fileName() + ".cache.bin";
+
+	if (cacheDir.isEmpty()){
+		return fileInfo.absolutePath() + QDir::separator() + ".acf.cache" + QDir::separator() + cacheFileName;
+	}
+	else{
+		return cacheDir + QDir::separator() + cacheFileName;
 	}
 }
 
 
-CCachedElementStaticInfo* CPackageMetaInfoCache::DeserializeSubelement(QDataStream& stream)
+iser::IObject* CPackageMetaInfoCache::CreateAttribute(const QByteArray& typeId)
 {
-	CCachedElementStaticInfo* subelementInfo = new CCachedElementStaticInfo();
-
-	// Interfaces
-	qint32 interfaceCount;
-	stream >> interfaceCount;
-	for (qint32 i = 0; i < interfaceCount; ++i){
-		QByteArray interfaceId;
-		stream >> interfaceId;
-		subelementInfo->AddInterfaceId(interfaceId);
-	}
-
-	// Nested subelements
-	qint32 nestedCount;
-	stream >> nestedCount;
-	for (qint32 i = 0; i < nestedCount; ++i){
-		QByteArray nestedId;
-		stream >> nestedId;
-
-		CCachedElementStaticInfo* nestedInfo = DeserializeSubelement(stream);
-		if (nestedInfo != NULL && stream.status() == QDataStream::Ok){
-			subelementInfo->RegisterSubelementInfo(nestedId, nestedInfo);
-		}
-		else{
-			delete nestedInfo;
-			delete subelementInfo;
-			return NULL;
-		}
+	if (typeId == iattr::CIntegerAttribute::GetTypeName()){
+		return new iattr::CIntegerAttribute();
 	}
-
-	if (stream.status() != QDataStream::Ok){
-		delete subelementInfo;
-		return NULL;
+	else if (typeId == iattr::CRealAttribute::GetTypeName()){
+		return new iattr::CRealAttribute();
+	}
+	else if (typeId == iattr::CBooleanAttribute::GetTypeName()){
+		return new iattr::CBooleanAttribute();
+	}
+	else if (typeId == iattr::CStringAttribute::GetTypeName()){
+		return new iattr::CStringAttribute();
+	}
+	else if (typeId == iattr::CIdAttribute::GetTypeName()){
+		return new iattr::CIdAttribute();
+	}
+	else if (typeId == icomp::CTextAttribute::GetTypeName()){
+		return new icomp::CTextAttribute();
+	}
+	else if (typeId == iattr::CIntegerListAttribute::GetTypeName()){
+		return new iattr::CIntegerListAttribute();
+	}
+	else if (typeId == iattr::CRealListAttribute::GetTypeName()){
+		return new iattr::CRealListAttribute();
+	}
+	else if (typeId == iattr::CBooleanListAttribute::GetTypeName()){
+		return new iattr::CBooleanListAttribute();
+	}
+	else if (typeId == iattr::CStringListAttribute::GetTypeName()){
+		return new iattr::CStringListAttribute();
+	}
+	else if (typeId == iattr::CIdListAttribute::GetTypeName()){
+		return new iattr::CIdListAttribute();
+	}
+	else if (typeId == icomp::CMultiTextAttribute::GetTypeName()){
+		return new icomp::CMultiTextAttribute();
+	}
+	else if (typeId == icomp::CReferenceAttribute::GetTypeName()){
+		return new icomp::CReferenceAttribute();
+	}
+	else if (typeId == icomp::CMultiReferenceAttribute::GetTypeName()){
+		return new icomp::CMultiReferenceAttribute();
+	}
+	else if (typeId == icomp::CFactoryAttribute::GetTypeName()){
+		return new icomp::CFactoryAttribute();
+	}
+	else if (typeId == icomp::CMultiFactoryAttribute::GetTypeName()){
+		return new icomp::CMultiFactoryAttribute();
 	}
 
-	return subelementInfo;
+	return NULL;
 }
 
 
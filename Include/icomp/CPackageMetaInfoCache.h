@@ -10,24 +10,23 @@
 #include <icomp/CPackageStaticInfo.h>
 
 
-class QDataStream;
+namespace iser
+{
+	class IObject;
+}
 
 
 namespace icomp
 {
 
 
-class CCachedComponentStaticInfo;
-class CCachedAttributeStaticInfo;
-class CCachedElementStaticInfo;
-
-
 /**
 	Provides file-based binary caching of package meta-information.
 	This cache allows skipping DLL loading when only component
 	meta-information (descriptions, keywords, interfaces, attributes) is needed.
 
-	Uses QDataStream binary format for fast serialization/deserialization.
+	The cache uses flat binary format described in \c CMappedPackageStaticInfo,
+	the cache file is mapped into memory and queried in place without parsing.
 	The cache is invalidated when the DLL file's timestamp or size changes.
 	A fast filesystem-based pre-check (modification time comparison) is used
 	before opening the cache file for full validation.
@@ -35,12 +34,20 @@ class CCachedElementStaticInfo;
 class CPackageMetaInfoCache
 {
 public:
+	enum
+	{
+		/**
+			Magic number at the begin of each cache file ("ACFC").
+		*/
+		CACHE_MAGIC = 0x41434643
+	};
+
 	/**
 		Load package meta-info from cache if the cache is valid.
 		Combines validation and loading in a single pass to avoid
 		opening and parsing the cache file twice.
 		Uses a fast filesystem timestamp pre-check before reading cache contents.
-		Returns a newly created CPackageStaticInfo with CCachedComponentStaticInfo instances,
+		Returns a newly created CPackageStaticInfo working directly on the mapped cache file,
 		or NULL if the cache is invalid or loading fails.
 		The caller takes ownership of the returned object.
 	*/
@@ -48,7 +55,7 @@ public:
 
 	/**
 		Save package meta-info to a binary cache file.
-		Serializes the package and its embedded components using QDataStream.
+		Writes the package and its embedded components in the flat cache format.
 		Uses atomic write (temp file + rename) for safety.
 	*/
 	static bool SaveToCache(const QString& cacheFilePath, const QString& packageFilePath, const CPackageStaticInfo* packageInfo);
@@ -60,14 +67,12 @@ public:
 	*/
 	static QString GetCacheFilePath(const QString& packageFilePath, const QString& cacheDir = QString());
 
-private:
-	static void SerializeComponent(QDataStream& stream, const IComponentStaticInfo* componentInfo);
-	static void SerializeAttribute(QDataStream& stream, const IAttributeStaticInfo* attributeInfo);
-	static void SerializeSubelement(QDataStream& stream, const IElementStaticInfo* subelementInfo);
-
-	static CCachedComponentStaticInfo* DeserializeComponent(QDataStream& stream);
-	static CCachedAttributeStaticInfo* DeserializeAttribute(QDataStream& stream, const QByteArray& attributeId);
-	static CCachedElementStaticInfo* DeserializeSubelement(QDataStream& stream);
+	/**
+		Create attribute object for some attribute type ID.
+		It is used to deserialize default values of cached attributes.
+		\return	new attribute object or NULL, if this type is not supported.
+	*/
+	static iser::IObject* CreateAttribute(const QByteArray& typeId);
 };
 
 
@@ -5,6 +5,7 @@
 // Qt includes
 #include <QtCore/QByteArray>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
 
 // ACF includes
 #include <icomp/IElementStaticInfo.h>
@@ -48,6 +49,9 @@ public:
 private:
 	typedef QMap<QByteArray, InterfaceExtractorPtr> InterfaceExtractors;
 	InterfaceExtractors m_interfaceExtractors;
+
+	typedef QHash<int, InterfaceExtractorPtr> InterfaceExtractorIds;
+	InterfaceExtractorIds m_interfaceExtractorIds;
 };
 
 
@@ -80,6 +84,7 @@ template <class ComponentType>
 void TSubelementStaticInfo<ComponentType>::RegisterInterfaceExtractor(const QByteArray& interfaceName, InterfaceExtractorPtr extractorPtr)
 {
 	m_interfaceExtractors[interfaceName] = extractorPtr;
+	m_interfaceExtractorIds[istd::CClassInfo::GetTypeId(interfaceName)] = extractorPtr;
 }
 
 
@@ -123,8 +128,8 @@ void* TSubelementStaticInfo<ComponentType>::GetComponentInterface(
 			return &component;
 		}
 
-		typename InterfaceExtractors::ConstIterator foundIter = m_interfaceExtractors.constFind(interfaceType.GetName());
-		if (foundIter != m_interfaceExtractors.constEnd()){
+		typename InterfaceExtractorIds::ConstIterator foundIter = m_interfaceExtractorIds.constFind(interfaceType.GetTypeId());
+		if (foundIter != m_interfaceExtractorIds.constEnd()){
 			InterfaceExtractorPtr extractorPtr = foundIter.value();
 
 			return extractorPtr(*nativeTypePtr);
@@ -133,8 +138,8 @@ void* TSubelementStaticInfo<ComponentType>::GetComponentInterface(
 		if (interfaceType.IsConst()){
 			istd::CClassInfo nonConstType = interfaceType.GetConstCasted(false);
 
-			foundIter = m_interfaceExtractors.constFind(nonConstType.GetName());
-			if (foundIter != m_interfaceExtractors.constEnd()){
+			foundIter = m_interfaceExtractorIds.constFind(nonConstType.GetTypeId());
+			if (foundIter != m_interfaceExtractorIds.constEnd()){
 				InterfaceExtractorPtr extractorPtr = foundIter.value();
 
 				return extractorPtr(*nativeTypePtr);
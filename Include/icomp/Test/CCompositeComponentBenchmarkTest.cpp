@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CCompositeComponentBenchmarkTest.h"
+
+
+// ACF includes
+#include <istd/IPolymorphic.h>
+#include <iattr/TAttribute.h>
+#include <icomp/CComponentBase.h>
+#include <icomp/CComponentContext.h>
+#include <icomp/CCompositeComponent.h>
+#include <icomp/CCompositeComponentContext.h>
+#include <icomp/CCompositeComponentStaticInfo.h>
+#include <icomp/CEnvironmentManagerBase.h>
+#include <icomp/CRegistry.h>
+#include <icomp/CRegistryElement.h>
+
+// STL includes
+#include <memory>
+
+
+namespace
+{
+
+
+static const int s_lookupsCount = 10000;
+static const int s_nestingLevelsCount = 5;
+
+
+class IBenchmarkLeaf: virtual public istd::IPolymorphic
+{
+public:
+	virtual int GetValue() const = 0;
+};
+
+
+class CBenchmarkLeafComp:
+			public icomp::CComponentBase,
+			virtual public IBenchmarkLeaf
+{
+public:
+	typedef icomp::CComponentBase BaseClass;
+
+	I_BEGIN_COMPONENT(CBenchmarkLeafComp);
+		I_REGISTER_INTERFACE(IBenchmarkLeaf);
+	I_END_COMPONENT;
+
+	// reimplemented (IBenchmarkLeaf)
+	virtual int GetValue() const override
+	{
+		return 42;
+	}
+};
+
+
+class CAttributeLeafComp: public icomp::CComponentBase
+{
+public:
+	typedef icomp::CComponentBase BaseClass;
+
+	I_BEGIN_COMPONENT(CAttributeLeafComp);
+		I_ASSIGN(m_valueAttrPtr, "Value", "Value exported from the parent", true, 1);
+		I_ASSIGN(m_optionalAttrPtr, "Optional", "Optional value exported from the parent", false, 0);
+	I_END_COMPONENT;
+
+private:
+	I_ATTR(int, m_valueAttrPtr);
+	I_ATTR(int, m_optionalAttrPtr);
+};
+
+
+static int s_criticalMessagesCount = 0;
+
+
+void CountCriticalMessages(QtMsgType type, const QMessageLogContext& /*context*/, const QString& /*message*/)
+{
+	if (type == QtCriticalMsg){
+		++s_criticalMessagesCount;
+	}
+}
+
+
+/**
+	Environment providing the package with the leaf component.
+*/
+class CBenchmarkEnvironmentManager: public icomp::CEnvironmentManagerBase
+{
+public:
+	CBenchmarkEnvironmentManager()
+	{
+		m_packageInfo.RegisterEmbeddedComponentInfo("Leaf", &CBenchmarkLeafComp::InitStaticInfo(NULL));
+
+		RegisterEmbeddedComponentInfo("BenchmarkPck", &m_packageInfo);
+	}
+
+private:
+	icomp::CPackageStaticInfo m_packageInfo;
+};
+
+
+/**
+	Composition nested in \c s_nestingLevelsCount levels of embedded composite components.
+	Each level exports the leaf interface and the leaf element of the next level.
+*/
+struct DeepComposition
+{
+	DeepComposition()
+	:	component(false)
+	{
+		const QByteArray interfaceName = istd::CClassInfo::GetName<IBenchmarkLeaf>();
+
+		icomp::IRegistry* registryPtr = &registry;
+		for (int level = 0; level < s_nestingLevelsCount; ++level){
+			registryPtr->InsertElementInfo("Sub", icomp::CComponentAddress("", "Level"));
+			registryPtr->SetElementInterfaceExported("Sub", interfaceName);
+			registryPtr->SetElementExported("Leaf", "Sub/Leaf");
+
+			registryPtr = registryPtr->InsertEmbeddedRegistry("Level");
+			Q_ASSERT(registryPtr != NULL);
+		}
+
+		registryPtr->InsertElementInfo("Leaf", icomp::CComponentAddress("BenchmarkPck", "Leaf"));
+		registryPtr->SetElementInterfaceExported("Leaf", interfaceName);
+		registryPtr->SetElementExported("Leaf", "Leaf");
+
+		staticInfoPtr.reset(new icomp::CCompositeComponentStaticInfo(registry, environmentManager, NULL));
+
+		contextPtr.reset(new icomp::CCompositeComponentContext(
+					&rootElement,
+					staticInfoPtr.get(),
+					&registry,
+					&environmentManager,
+					NULL,
+					""));
+
+		component.SetComponentContext(contextPtr, NULL, false);
+	}
+
+	CBenchmarkEnvironmentManager environmentManager;
+	icomp::CRegistry registry;
+	icomp::CRegistryElement rootElement;
+	std::unique_ptr<icomp::CCompositeComponentStaticInfo> staticInfoPtr;
+	icomp::IComponentContextSharedPtr contextPtr;
+	icomp::CCompositeComponent component;
+};
+
+
+static std::unique_ptr<DeepComposition> s_compositionPtr;
+
+
+} // namespace
+
+
+// protected slots
+
+void CCompositeComponentBenchmarkTest::initTestCase()
+{
+	s_compositionPtr.reset(new DeepComposition);
+}
+
+
+void CCompositeComponentBenchmarkTest::ResolveInterfaceTest()
+{
+	IBenchmarkLeaf* leafPtr = s_compositionPtr->component.GetComponentInterface<IBenchmarkLeaf>();
+	QVERIFY(leafPtr != NULL);
+	QCOMPARE(leafPtr->GetValue(), 42);
+
+	// second lookup uses the already resolved table and created subcomponents
+	QVERIFY(s_compositionPtr->component.GetComponentInterface<IBenchmarkLeaf>() == leafPtr);
+}
+
+
+void CCompositeComponentBenchmarkTest::ResolveSubelementTest()
+{
+	IBenchmarkLeaf* leafPtr = s_compositionPtr->component.GetComponentInterface<IBenchmarkLeaf>();
+	QVERIFY(leafPtr != NULL);
+
+	QVERIFY(s_compositionPtr->component.GetComponentInterface<IBenchmarkLeaf>("Leaf") == leafPtr);
+}
+
+
+void CCompositeComponentBenchmarkTest::RegistryChangeTest()
+{
+	icomp::CCompositeComponent& component = s_compositionPtr->component;
+	icomp::CRegistry& registry = s_compositionPtr->registry;
+
+	IBenchmarkLeaf* leafPtr = component.GetComponentInterface<IBenchmarkLeaf>("Leaf");
+	QVERIFY(leafPtr != NULL);
+
+	// new export must be visible without any explicit invalidation
+	registry.SetElementExported("Alias", "Sub/Leaf");
+	QVERIFY(component.GetComponentInterface<IBenchmarkLeaf>("Alias") == leafPtr);
+
+	registry.SetElementExported("Alias", "");
+	QVERIFY(component.GetComponentInterface<IBenchmarkLeaf>("Leaf") == leafPtr);
+}
+
+
+void CCompositeComponentBenchmarkTest::ExportedAttributeTest()
+{
+	const icomp::IComponentStaticInfo& staticInfo = CAttributeLeafComp::InitStaticInfo(NULL);
+
+	const QByteArray integerTypeName = iattr::CIntegerAttribute::GetTypeName();
+
+	icomp::CRegistryElement parentElement;
+	icomp::IRegistryElement::AttributeInfo* parentValueInfoPtr = parentElement.InsertAttributeInfo("Value", integerTypeName);
+	QVERIFY(parentValueInfoPtr != NULL);
+	parentValueInfoPtr->attributePtr.SetPtr(new iattr::CIntegerAttribute(7));
+
+	icomp::CComponentContext parentContext(&parentElement, &staticInfo, NULL, "Parent");
+
+	int parentLevel = -1;
+	const iser::IObject* parentValuePtr = parentContext.GetAttribute("Value", &parentLevel);
+	QVERIFY(parentValuePtr != NULL);
+	QCOMPARE(parentLevel, 0);
+
+	// the optional attribute is exported to an attribute unknown for the parent
+	icomp::CRegistryElement childElement;
+	icomp::IRegistryElement::AttributeInfo* childValueInfoPtr = childElement.InsertAttributeInfo("Value", integerTypeName);
+	QVERIFY(childValueInfoPtr != NULL);
+	childValueInfoPtr->exportId = "Value";
+	icomp::IRegistryElement::AttributeInfo* childOptionalInfoPtr = childElement.InsertAttributeInfo("Optional", integerTypeName);
+	QVERIFY(childOptionalInfoPtr != NULL);
+	childOptionalInfoPtr->exportId = "Missing";
+
+	// construction must not report anything, the unresolved exports are resolved on demand only
+	s_criticalMessagesCount = 0;
+	QtMessageHandler previousHandler = qInstallMessageHandler(CountCriticalMessages);
+	icomp::CComponentContext childContext(&childElement, &staticInfo, &parentContext, "Child");
+	qInstallMessageHandler(previousHandler);
+
+	QCOMPARE(s_criticalMessagesCount, 0);
+
+	int childLevel = -1;
+	QVERIFY(childContext.GetAttribute("Value", &childLevel) == parentValuePtr);
+	QCOMPARE(childLevel, 1);
+
+	const iattr::CIntegerAttribute* childValuePtr = dynamic_cast<const iattr::CIntegerAttribute*>(childContext.GetAttribute("Value"));
+	QVERIFY(childValuePtr != NULL);
+	QCOMPARE(childValuePtr->GetValue(), 7);
+}
+
+
+void CCompositeComponentBenchmarkTest::ResolveInterfaceBenchmark()
+{
+	icomp::CCompositeComponent& component = s_compositionPtr->component;
+
+	int foundCount = 0;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_lookupsCount; ++i){
+			if (component.GetComponentInterface<IBenchmarkLeaf>() != NULL){
+				++foundCount;
+			}
+		}
+	}
+
+	QVERIFY(foundCount >= s_lookupsCount);
+}
+
+
+void CCompositeComponentBenchmarkTest::ResolveSubelementBenchmark()
+{
+	icomp::CCompositeComponent& component = s_compositionPtr->component;
+
+	static const QByteArray subId("Leaf");
+
+	int foundCount = 0;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_lookupsCount; ++i){
+			if (component.GetComponentInterface<IBenchmarkLeaf>(subId) != NULL){
+				++foundCount;
+			}
+		}
+	}
+
+	QVERIFY(foundCount >= s_lookupsCount);
+}
+
+
+void CCompositeComponentBenchmarkTest::cleanupTestCase()
+{
+	s_compositionPtr.reset();
+}
+
+
+I_ADD_TEST(CCompositeComponentBenchmarkTest);
+
+
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Micro-benchmark of the interface resolution through nested composite components.
+	The composition used by this test has five nested levels, the only real component is placed on the deepest level.
+*/
+class CCompositeComponentBenchmarkTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void ResolveInterfaceTest();
+	void ResolveSubelementTest();
+	void RegistryChangeTest();
+	void ExportedAttributeTest();
+
+	void ResolveInterfaceBenchmark();
+	void ResolveSubelementBenchmark();
+
+	void cleanupTestCase();
+};
+
+
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CPackageMetaInfoCacheTest.h"
+
+
+// Qt includes
+#include <QtCore/QFile>
+
+// ACF includes
+#include <istd/TDelPtr.h>
+#include <iattr/TAttribute.h>
+#include <iser/CMemoryWriteArchive.h>
+#include <icomp/CPackageMetaInfoCache.h>
+#include <icomp/CCachedComponentStaticInfo.h>
+#include <icomp/CCachedElementStaticInfo.h>
+#include <icomp/CCachedAttributeStaticInfo.h>
+
+
+namespace
+{
+
+
+static const int s_componentsCount = 50;
+
+
+icomp::CCachedComponentStaticInfo* CreateComponentInfo(int index)
+{
+	icomp::CCachedComponentStaticInfo* componentInfoPtr = new icomp::CCachedComponentStaticInfo(
+				QString("Component %1").arg(index),
+				QString("Keyword%1 Test").arg(index),
+				icomp::IComponentStaticInfo::CT_REAL);
+
+	componentInfoPtr->AddInterfaceId("istd::IChangeable");
+	componentInfoPtr->AddInterfaceId("iser::ISerializable");
+
+	icomp::CCachedElementStaticInfo* subelementInfoPtr = new icomp::CCachedElementStaticInfo();
+	subelementInfoPtr->AddInterfaceId("iprm::ISelectionParam");
+
+	icomp::CCachedElementStaticInfo* nestedInfoPtr = new icomp::CCachedElementStaticInfo();
+	nestedInfoPtr->AddInterfaceId("iprm::IOptionsList");
+	subelementInfoPtr->RegisterSubelementInfo("Nested", nestedInfoPtr);
+
+	componentInfoPtr->RegisterSubelementInfo("Selection", subelementInfoPtr);
+
+	icomp::CCachedAttributeStaticInfo* valueInfoPtr = new icomp::CCachedAttributeStaticInfo(
+				"Value",
+				QString::fromUtf8("Value description \xc3\xa4"),
+				iattr::CIntegerAttribute::GetTypeName(),
+				iattr::IAttributeMetaInfo::AF_OBLIGATORY);
+	valueInfoPtr->SetDefaultValue(new iattr::CIntegerAttribute(index));
+	componentInfoPtr->RegisterAttributeInfo("Value", valueInfoPtr);
+
+	icomp::CCachedAttributeStaticInfo* referenceInfoPtr = new icomp::CCachedAttributeStaticInfo(
+				"Model",
+				"Model reference",
+				"Reference",
+				iattr::IAttributeMetaInfo::AF_NULLABLE | icomp::IAttributeStaticInfo::AF_REFERENCE);
+	referenceInfoPtr->AddRelatedMetaId(icomp::IElementStaticInfo::MGI_INTERFACES, "imod::IModel", icomp::IAttributeStaticInfo::AF_REFERENCE | iattr::IAttributeMetaInfo::AF_OBLIGATORY);
+	referenceInfoPtr->AddRelatedMetaId(icomp::IElementStaticInfo::MGI_INTERFACES, "istd::IChangeable", icomp::IAttributeStaticInfo::AF_REFERENCE);
+	componentInfoPtr->RegisterAttributeInfo("Model", referenceInfoPtr);
+
+	return componentInfoPtr;
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CPackageMetaInfoCacheTest::initTestCase()
+{
+	QVERIFY(m_tempDir.isValid());
+
+	m_packageFilePath = m_tempDir.path() + "/TestPck.arp";
+	m_cacheFilePath = icomp::CPackageMetaInfoCache::GetCacheFilePath(m_packageFilePath, m_tempDir.path());
+
+	CreatePackageFile("Package binary");
+
+	for (int i = 0; i < s_componentsCount; ++i){
+		icomp::CCachedComponentStaticInfo* componentInfoPtr = CreateComponentInfo(i);
+		if (i == 0){
+			componentInfoPtr->RegisterEmbeddedComponentInfo("Embedded", CreateComponentInfo(1000));
+		}
+
+		m_packageInfo.RegisterCachedComponentInfo(QByteArray("Component") + QByteArray::number(i), componentInfoPtr);
+	}
+
+	QVERIFY(icomp::CPackageMetaInfoCache::SaveToCache(m_cacheFilePath, m_packageFilePath, &m_packageInfo));
+}
+
+
+void CPackageMetaInfoCacheTest::SaveLoadTest()
+{
+	istd::TDelPtr<icomp::CPackageStaticInfo> loadedInfoPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(m_packageFilePath, m_cacheFilePath));
+	QVERIFY(loadedInfoPtr.IsValid());
+
+	QCOMPARE(loadedInfoPtr->GetMetaIds(icomp::IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS), m_packageInfo.GetMetaIds(icomp::IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS));
+	QVERIFY(loadedInfoPtr->GetEmbeddedComponentInfo("NotExisting") == NULL);
+
+	const icomp::IComponentStaticInfo* componentInfoPtr = loadedInfoPtr->GetEmbeddedComponentInfo("Component7");
+	QVERIFY(componentInfoPtr != NULL);
+	QCOMPARE(componentInfoPtr->GetDescription(), QString("Component 7"));
+	QCOMPARE(componentInfoPtr->GetKeywords(), QString("Keyword7 Test"));
+	QCOMPARE(componentInfoPtr->GetComponentType(), int(icomp::IComponentStaticInfo::CT_REAL));
+	QCOMPARE(componentInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES), icomp::IElementStaticInfo::Ids({"istd::IChangeable", "iser::ISerializable"}));
+	QCOMPARE(componentInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_SUBELEMENTS), icomp::IElementStaticInfo::Ids({"Selection"}));
+	QVERIFY(componentInfoPtr->GetMetaIds(icomp::IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS).isEmpty());
+
+	const icomp::IElementStaticInfo* subelementInfoPtr = componentInfoPtr->GetSubelementInfo("Selection");
+	QVERIFY(subelementInfoPtr != NULL);
+	QCOMPARE(subelementInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES), icomp::IElementStaticInfo::Ids({"iprm::ISelectionParam"}));
+	QVERIFY(componentInfoPtr->GetSubelementInfo("Selection") == subelementInfoPtr);
+
+	const icomp::IElementStaticInfo* nestedInfoPtr = subelementInfoPtr->GetSubelementInfo("Nested");
+	QVERIFY(nestedInfoPtr != NULL);
+	QCOMPARE(nestedInfoPtr->GetMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES), icomp::IElementStaticInfo::Ids({"iprm::IOptionsList"}));
+	QVERIFY(nestedInfoPtr->GetSubelementInfo("Selection") == NULL);
+
+	const icomp::IComponentStaticInfo* parentInfoPtr = loadedInfoPtr->GetEmbeddedComponentInfo("Component0");
+	QVERIFY(parentInfoPtr != NULL);
+	QCOMPARE(parentInfoPtr->GetMetaIds(icomp::IComponentStaticInfo::MGI_EMBEDDED_COMPONENTS), icomp::IElementStaticInfo::Ids({"Embedded"}));
+
+	const icomp::IComponentStaticInfo* embeddedInfoPtr = parentInfoPtr->GetEmbeddedComponentInfo("Embedded");
+	QVERIFY(embeddedInfoPtr != NULL);
+	QCOMPARE(embeddedInfoPtr->GetDescription(), QString("Component 1000"));
+}
+
+
+void CPackageMetaInfoCacheTest::AttributeInfoTest()
+{
+	istd::TDelPtr<icomp::CPackageStaticInfo> loadedInfoPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(m_packageFilePath, m_cacheFilePath));
+	QVERIFY(loadedInfoPtr.IsValid());
+
+	const icomp::IComponentStaticInfo* componentInfoPtr = loadedInfoPtr->GetEmbeddedComponentInfo("Component7");
+	QVERIFY(componentInfoPtr != NULL);
+	QCOMPARE(componentInfoPtr->GetAttributeMetaIds(), iattr::IAttributesProvider::AttributeIds({"Value", "Model"}));
+	QVERIFY(componentInfoPtr->GetAttributeInfo("NotExisting") == NULL);
+
+	const icomp::IAttributeStaticInfo* valueInfoPtr = componentInfoPtr->GetAttributeInfo("Value");
+	QVERIFY(valueInfoPtr != NULL);
+	QCOMPARE(valueInfoPtr->GetAttributeDescription(), QString::fromUtf8("Value description \xc3\xa4"));
+	QCOMPARE(valueInfoPtr->GetAttributeTypeId(), iattr::CIntegerAttribute::GetTypeName());
+	QCOMPARE(valueInfoPtr->GetAttributeFlags(), int(iattr::IAttributeMetaInfo::AF_OBLIGATORY));
+
+	const iattr::CIntegerAttribute* defaultValuePtr = dynamic_cast<const iattr::CIntegerAttribute*>(valueInfoPtr->GetAttributeDefaultValue());
+	QVERIFY(defaultValuePtr != NULL);
+	QCOMPARE(defaultValuePtr->GetValue(), 7);
+	QVERIFY(valueInfoPtr->GetAttributeDefaultValue() == defaultValuePtr);
+
+	const icomp::IAttributeStaticInfo* referenceInfoPtr = componentInfoPtr->GetAttributeInfo("Model");
+	QVERIFY(referenceInfoPtr != NULL);
+	QVERIFY(referenceInfoPtr->GetAttributeDefaultValue() == NULL);
+	QCOMPARE(
+				referenceInfoPtr->GetRelatedMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES, 0, 0),
+				icomp::IElementStaticInfo::Ids({"imod::IModel", "istd::IChangeable"}));
+	QCOMPARE(
+				referenceInfoPtr->GetRelatedMetaIds(icomp::IElementStaticInfo::MGI_INTERFACES, iattr::IAttributeMetaInfo::AF_OBLIGATORY, iattr::IAttributeMetaInfo::AF_OBLIGATORY),
+				icomp::IElementStaticInfo::Ids({"imod::IModel"}));
+	QVERIFY(referenceInfoPtr->GetRelatedMetaIds(icomp::IElementStaticInfo::MGI_SUBELEMENTS, 0, 0).isEmpty());
+}
+
+
+void CPackageMetaInfoCacheTest::InvalidationTest()
+{
+	QString packageFilePath = m_tempDir.path() + "/ChangedPck.arp";
+	QString cacheFilePath = icomp::CPackageMetaInfoCache::GetCacheFilePath(packageFilePath, m_tempDir.path());
+
+	QFile packageFile(packageFilePath);
+	QVERIFY(packageFile.open(QIODevice::WriteOnly));
+	packageFile.write("Package binary");
+	packageFile.close();
+
+	QVERIFY(icomp::CPackageMetaInfoCache::SaveToCache(cacheFilePath, packageFilePath, &m_packageInfo));
+
+	istd::TDelPtr<icomp::CPackageStaticInfo> loadedInfoPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(packageFilePath, cacheFilePath));
+	QVERIFY(loadedInfoPtr.IsValid());
+	loadedInfoPtr.Reset();
+
+	// changed size of the package must invalidate the cache
+	QVERIFY(packageFile.open(QIODevice::Append));
+	packageFile.write(" changed");
+	packageFile.close();
+
+	loadedInfoPtr.SetPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(packageFilePath, cacheFilePath));
+	QVERIFY(!loadedInfoPtr.IsValid());
+}
+
+
+void CPackageMetaInfoCacheTest::CorruptedCacheTest()
+{
+	QString corruptedPackagePath = m_tempDir.path() + "/CorruptedPck.arp";
+	QString corruptedCachePath = icomp::CPackageMetaInfoCache::GetCacheFilePath(corruptedPackagePath, m_tempDir.path());
+
+	QFile packageFile(corruptedPackagePath);
+	QVERIFY(packageFile.open(QIODevice::WriteOnly));
+	packageFile.write("Package binary");
+	packageFile.close();
+
+	QVERIFY(icomp::CPackageMetaInfoCache::SaveToCache(corruptedCachePath, corruptedPackagePath, &m_packageInfo));
+
+	// truncated file must be rejected
+	QFile corruptedFile(corruptedCachePath);
+	QVERIFY(corruptedFile.open(QIODevice::ReadWrite));
+	QVERIFY(corruptedFile.resize(corruptedFile.size() / 4));
+	corruptedFile.close();
+
+	istd::TDelPtr<icomp::CPackageStaticInfo> loadedInfoPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(corruptedPackagePath, corruptedCachePath));
+	QVERIFY(!loadedInfoPtr.IsValid());
+}
+
+
+void CPackageMetaInfoCacheTest::LoadBenchmark()
+{
+	QBENCHMARK{
+		istd::TDelPtr<icomp::CPackageStaticInfo> loadedInfoPtr(icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(m_packageFilePath, m_cacheFilePath));
+		QVERIFY(loadedInfoPtr.IsValid());
+		QVERIFY(loadedInfoPtr->GetEmbeddedComponentInfo("Component42") != NULL);
+	}
+}
+
+
+void CPackageMetaInfoCacheTest::cleanupTestCase()
+{
+	m_packageInfo.Reset();
+}
+
+
+// private methods
+
+void CPackageMetaInfoCacheTest::CreatePackageFile(const QByteArray& content)
+{
+	QFile packageFile(m_packageFilePath);
+	QVERIFY(packageFile.open(QIODevice::WriteOnly));
+	packageFile.write(content);
+	packageFile.close();
+}
+
+
+I_ADD_TEST(CPackageMetaInfoCacheTest);
+
+
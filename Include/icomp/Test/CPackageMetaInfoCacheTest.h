@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+#include <icomp/CPackageStaticInfo.h>
+
+
+/**
+	Test of the flat binary cache of package meta-information.
+*/
+class CPackageMetaInfoCacheTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void SaveLoadTest();
+	void AttributeInfoTest();
+	void InvalidationTest();
+	void CorruptedCacheTest();
+
+	void LoadBenchmark();
+
+	void cleanupTestCase();
+
+private:
+	void CreatePackageFile(const QByteArray& content);
+
+	QTemporaryDir m_tempDir;
+	QString m_packageFilePath;
+	QString m_cacheFilePath;
+	icomp::CPackageStaticInfo m_packageInfo;
+};
+
+
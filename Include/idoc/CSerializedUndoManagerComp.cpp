@@ -2,8 +2,12 @@
 #include <idoc/CSerializedUndoManagerComp.h>
 
 
+// STL includes
+#include <cstring>
+
 // ACF includes
 #include <istd/CChangeNotifier.h>
+#include <istd/CBinaryDelta.h>
 #include <iser/CMemoryReadArchive.h>
 #include <icomp/CComponentBase.h>
 
@@ -15,9 +19,15 @@ namespace idoc
 // static attributes
 static const istd::IChangeable::ChangeSet s_undoChangeSet(istd::IChangeable::CF_NO_UNDO, "UNDO");
 
+/**
+	Minimal size of undo step difference to be compressed.
+*/
+static const int s_minCompressedDeltaSize = 256;
+
 
 CSerializedUndoManagerComp::CSerializedUndoManagerComp()
-:	m_hasStoredDocumentState(false),
+:	m_isCurrentStateValid(false),
+	m_hasStoredDocumentState(false),
 	m_isBlocked(false),
 	m_stateChangedFlag(DCF_UNKNOWN),
 	m_isStateChangedFlagValid(false)
@@ -66,7 +76,6 @@ void CSerializedUndoManagerComp::ResetUndo()
 
 	m_undoList.clear();
 	m_redoList.clear();
-	m_beginStateArchivePtr.Reset();
 }
 
 
@@ -92,6 +101,9 @@ bool CSerializedUndoManagerComp::OnModelAttached(imod::IModel* modelPtr, istd::I
 
 		m_stateChangedFlag = DCF_UNKNOWN;
 
+		// existing steps have to reference the state of the new object
+		RebaseSteps();
+
 		return true;
 	}
 
@@ -118,67 +130,70 @@ bool CSerializedUndoManagerComp::OnModelDetached(imod::IModel* modelPtr)
 
 bool CSerializedUndoManagerComp::DoListShift(int steps, UndoList& fromList, UndoList& toList)
 {
-	bool retVal = false;
-
-	UndoArchivePtr currentStateArchivePtr(new iser::CMemoryWriteArchive());
-	if ((steps > 0) && (fromList.size() >= steps) && currentStateArchivePtr.IsValid()){
-		istd::CChangeNotifier notifier(this);
-		Q_UNUSED(notifier);
+	if ((steps <= 0) || (fromList.size() < steps)){
+		return false;
+	}
 
-		iser::ISerializable* objectPtr = GetObservedObject();
+	iser::ISerializable* objectPtr = GetObservedObject();
+	if ((objectPtr == NULL) || (!m_isCurrentStateValid && !UpdateCurrentState())){
+		return false;
+	}
 
-		if (objectPtr != NULL){
-			Q_ASSERT(!m_isBlocked);
-			m_isBlocked = true;
+	// reconstruct the requested state step by step, the differences for the opposite direction are collected at the same time
+	QByteArray state = m_currentState;
+	UndoList shiftedSteps;
 
-			istd::CChangeNotifier objectNotifier(objectPtr, &s_undoChangeSet);
-			Q_UNUSED(objectNotifier);
+	for (int i = 0; i < steps; ++i){
+		const UndoStepInfo& step = fromList[fromList.size() - 1 - i];
 
-			// stores pointer to last processed description container, necessary due of description shift
-			// in undo list the state corresponds to state before changes, in redo - after changes. It causes description shift.
-			QString* lastDescriptionPtr = NULL;
+		QByteArray nextState;
+		if (!istd::CBinaryDelta::ApplyDelta(state.constData(), state.size(), GetStepDelta(step), nextState)){
+			qDebug("Undo Manager: Object state cannot be reconstructed");
 
-			if (objectPtr->Serialize(*currentStateArchivePtr)){
-				toList.push_back(UndoStepInfo());
+			return false;
+		}
 
-				UndoStepInfo& currentStep = toList.back();
+		// description stays by the change, in undo list the state corresponds to state before changes, in redo - after changes
+		shiftedSteps.push_back(UndoStepInfo());
+		shiftedSteps.back().delta = istd::CBinaryDelta::CreateDelta(nextState.constData(), nextState.size(), state.constData(), state.size());
+		shiftedSteps.back().description = step.description;
 
-				currentStep.archivePtr.TakeOver(currentStateArchivePtr);
-				lastDescriptionPtr = &currentStep.description;
-			}
+		state = nextState;
+	}
 
-			const UndoArchivePtr& writeArchivePtr = fromList[fromList.size() - steps].archivePtr;
-			Q_ASSERT(writeArchivePtr.IsValid());
+	istd::CChangeNotifier notifier(this);
+	Q_UNUSED(notifier);
 
-			iser::CMemoryReadArchive readArchive(*writeArchivePtr);
+	Q_ASSERT(!m_isBlocked);
+	m_isBlocked = true;
 
-			if (objectPtr->Serialize(readArchive)){
-				for (int i = 1; i < steps; ++i){
-					if (lastDescriptionPtr != NULL){
-						*lastDescriptionPtr = fromList.back().description;
-					}
+	istd::CChangeNotifier objectNotifier(objectPtr, &s_undoChangeSet);
+	Q_UNUSED(objectNotifier);
 
-					toList.push_back(UndoStepInfo());
-					toList.back().archivePtr.TakeOver(fromList.back().archivePtr);
-					lastDescriptionPtr = &toList.back().description;
+	iser::CMemoryReadArchive readArchive(state.constData(), state.size());
 
-					fromList.pop_back();
-				}
+	bool retVal = objectPtr->Serialize(readArchive);
+	if (retVal){
+		fromList.erase(fromList.end() - steps, fromList.end());
+		toList.append(shiftedSteps);
 
-				if (lastDescriptionPtr != NULL){
-					*lastDescriptionPtr = fromList.back().description;
-				}
+		m_currentState = state;
 
-				fromList.pop_back();
+		if (&toList == &m_undoList){
+			CompressOlderSteps(steps);
+		}
+	}
+	else{
+		// the object state is unknown, the steps cannot be applied anymore
+		m_undoList.clear();
+		m_redoList.clear();
 
-				retVal = true;
-			}
+		m_isCurrentStateValid = false;
+	}
 
-			objectNotifier.Reset();
+	objectNotifier.Reset();
 
-			m_isBlocked = false;
-		}
-	}
+	m_isBlocked = false;
 
 	return retVal;
 }
@@ -198,17 +213,9 @@ void CSerializedUndoManagerComp::BeforeUpdate(imod::IModel* modelPtr)
 {
 	BaseClass2::BeforeUpdate(modelPtr);
 
-	if (!m_isBlocked && !m_beginStateArchivePtr.IsValid()){
-		iser::ISerializable* objectPtr = GetObservedObject();
-		if (objectPtr != NULL){
-			UndoArchivePtr archivePtr(new iser::CMemoryWriteArchive());
-
-			if (		archivePtr.IsValid() &&
-						objectPtr->Serialize(*archivePtr) &&
-						(m_undoList.isEmpty() || *archivePtr != *(m_undoList.back().archivePtr))){
-				m_beginStateArchivePtr.TakeOver(archivePtr);
-			}
-		}
+	// the state before the change is normally known from the previous change
+	if (!m_isBlocked && !m_isCurrentStateValid){
+		UpdateCurrentState();
 	}
 }
 
@@ -221,35 +228,40 @@ void CSerializedUndoManagerComp::AfterUpdate(imod::IModel* modelPtr, const istd:
 
 	bool skipUndo = changeSet.ContainsExplicit(istd::IChangeable::CF_NO_UNDO, true);
 
-	if (		!m_isBlocked &&
-				!skipUndo &&
-				m_beginStateArchivePtr.IsValid()){
-		iser::ISerializable* objectPtr = GetObservedObject();
-		if (objectPtr != NULL){
-			UndoArchivePtr archivePtr(new iser::CMemoryWriteArchive());
+	if (!m_isBlocked){
+		if (skipUndo || !m_isCurrentStateValid){
+			RebaseSteps();
+		}
+		else if (SerializeObject()){
+			const char* newStatePtr = static_cast<const char*>(m_serializationArchive.GetBuffer());
+			int newStateSize = m_serializationArchive.GetBufferSize();
+
+			if ((newStateSize != m_currentState.size()) || (std::memcmp(newStatePtr, m_currentState.constData(), size_t(newStateSize)) != 0)){
+				istd::CChangeNotifier notifier(this);
+				Q_UNUSED(notifier);
+
+				m_undoList.push_back(UndoStepInfo());
+				m_undoList.back().delta = istd::CBinaryDelta::CreateDelta(newStatePtr, newStateSize, m_currentState.constData(), m_currentState.size());
+				m_undoList.back().description = changeSet.GetDescription();
+
+				m_currentState = QByteArray(newStatePtr, newStateSize);
 
-			if (objectPtr->Serialize(*archivePtr)){
-				if (*archivePtr != *m_beginStateArchivePtr){
-					istd::CChangeNotifier notifier(this);
-					Q_UNUSED(notifier);
+				m_redoList.clear();
 
-					m_undoList.push_back(UndoStepInfo());
-					m_undoList.back().archivePtr.TakeOver(m_beginStateArchivePtr);
-					m_undoList.back().description = changeSet.GetDescription();
+				CompressOlderSteps(1);
 
-					if (m_maxBufferSizeAttrPtr.IsValid() && (GetUsedMemorySize() > *m_maxBufferSizeAttrPtr * (1 << 20))){
+				if (m_maxBufferSizeAttrPtr.IsValid()){
+					while (!m_undoList.isEmpty() && (GetUsedMemorySize() > *m_maxBufferSizeAttrPtr * qint64(1 << 20))){
 						m_undoList.pop_front();
 					}
-
-					m_redoList.clear();
 				}
 			}
-			else{
-				qDebug("Undo Manager: Object serialization failed");
-			}
 		}
+		else{
+			qDebug("Undo Manager: Object serialization failed");
 
-		m_beginStateArchivePtr.Reset();
+			RebaseSteps();
+		}
 	}
 
 	BaseClass2::AfterUpdate(modelPtr, changeSet);
@@ -305,6 +317,8 @@ bool CSerializedUndoManagerComp::RestoreDocumentState()
 
 				m_isBlocked = false;
 
+				RebaseSteps();
+
 				return true;
 			}
 
@@ -316,6 +330,8 @@ bool CSerializedUndoManagerComp::RestoreDocumentState()
 
 		m_undoList.clear();
 		m_redoList.clear();
+
+		m_isCurrentStateValid = false;
 	}
 
 	return false;
@@ -328,11 +344,21 @@ IDocumentStateComparator::DocumentChangeFlag CSerializedUndoManagerComp::GetDocu
 		m_stateChangedFlag = DCF_UNKNOWN;
 
 		if (m_hasStoredDocumentState){
-			iser::CMemoryWriteArchive compareArchive;
+			// the current state is always up to date if it is valid
+			if (m_isCurrentStateValid){
+				bool isEqual =
+							(m_currentState.size() == m_storedStateArchive.GetBufferSize()) &&
+							(std::memcmp(m_currentState.constData(), m_storedStateArchive.GetBuffer(), size_t(m_currentState.size())) == 0);
 
-			iser::ISerializable* serializablePtr = GetObservedObject();
-			if ((serializablePtr != NULL) && const_cast<iser::ISerializable*>(serializablePtr)->Serialize(compareArchive)){
-				m_stateChangedFlag = (compareArchive != m_storedStateArchive)? DCF_DIFFERENT: DCF_EQUAL;
+				m_stateChangedFlag = isEqual? DCF_EQUAL: DCF_DIFFERENT;
+			}
+			else{
+				iser::CMemoryWriteArchive compareArchive;
+
+				iser::ISerializable* serializablePtr = GetObservedObject();
+				if ((serializablePtr != NULL) && const_cast<iser::ISerializable*>(serializablePtr)->Serialize(compareArchive)){
+					m_stateChangedFlag = (compareArchive != m_storedStateArchive)? DCF_DIFFERENT: DCF_EQUAL;
+				}
 			}
 		}
 
@@ -360,13 +386,116 @@ qint64 CSerializedUndoManagerComp::GetUsedMemorySize() const
 	qint64 memorySize = 0;
 
 	for (UndoList::ConstIterator iter = m_undoList.constBegin(); iter != m_undoList.constEnd(); ++iter){
-		memorySize += iter->archivePtr->GetBufferSize();
+		memorySize += iter->delta.size();
 	}
 
 	return memorySize;
 }
 
 
+bool CSerializedUndoManagerComp::SerializeObject()
+{
+	m_serializationArchive.Reset();
+
+	iser::ISerializable* objectPtr = GetObservedObject();
+
+	return (objectPtr != NULL) && objectPtr->Serialize(m_serializationArchive);
+}
+
+
+bool CSerializedUndoManagerComp::UpdateCurrentState()
+{
+	m_isCurrentStateValid = SerializeObject();
+
+	if (m_isCurrentStateValid){
+		m_currentState = QByteArray(static_cast<const char*>(m_serializationArchive.GetBuffer()), m_serializationArchive.GetBufferSize());
+	}
+	else{
+		m_currentState.clear();
+	}
+
+	return m_isCurrentStateValid;
+}
+
+
+void CSerializedUndoManagerComp::RebaseSteps()
+{
+	if (m_undoList.isEmpty() && m_redoList.isEmpty()){
+		// no step references the current state, it will be serialized again before the next change
+		m_isCurrentStateValid = false;
+		m_currentState.clear();
+
+		return;
+	}
+
+	QByteArray previousState = m_currentState;
+
+	if (		m_isCurrentStateValid &&
+				UpdateCurrentState() &&
+				RebaseLastStep(previousState, m_undoList) &&
+				RebaseLastStep(previousState, m_redoList)){
+		return;
+	}
+
+	istd::CChangeNotifier notifier(this);
+	Q_UNUSED(notifier);
+
+	m_undoList.clear();
+	m_redoList.clear();
+}
+
+
+bool CSerializedUndoManagerComp::RebaseLastStep(const QByteArray& previousState, UndoList& stepList) const
+{
+	if (stepList.isEmpty()){
+		return true;
+	}
+
+	UndoStepInfo& step = stepList.back();
+
+	QByteArray stepState;
+	if (!istd::CBinaryDelta::ApplyDelta(previousState.constData(), previousState.size(), GetStepDelta(step), stepState)){
+		return false;
+	}
+
+	step.delta = istd::CBinaryDelta::CreateDelta(m_currentState.constData(), m_currentState.size(), stepState.constData(), stepState.size());
+	step.isCompressed = false;
+
+	return true;
+}
+
+
+void CSerializedUndoManagerComp::CompressOlderSteps(int addedStepsCount)
+{
+	if (!m_uncompressedStepsCountAttrPtr.IsValid()){
+		return;
+	}
+
+	// only the steps which have just crossed the limit of uncompressed steps are processed
+	int lastStepIndex = m_undoList.size() - 1 - qMax(*m_uncompressedStepsCountAttrPtr, 0);
+
+	for (int stepIndex = qMax(lastStepIndex - addedStepsCount + 1, 0); stepIndex <= lastStepIndex; ++stepIndex){
+		UndoStepInfo& step = m_undoList[stepIndex];
+
+		if (!step.isCompressed && (step.delta.size() >= s_minCompressedDeltaSize)){
+			QByteArray compressedDelta = qCompress(step.delta);
+			if (compressedDelta.size() < step.delta.size()){
+				step.delta = compressedDelta;
+				step.isCompressed = true;
+			}
+		}
+	}
+}
+
+
+// private static methods
+
+QByteArray CSerializedUndoManagerComp::GetStepDelta(const UndoStepInfo& step)
+{
+	return step.isCompressed? qUncompress(step.delta): step.delta;
+}
+
+
 } // namespace idoc
 
 
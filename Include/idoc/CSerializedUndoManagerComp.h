@@ -3,10 +3,10 @@
 
 
 // Qt includes
+#include <QtCore/QByteArray>
 #include <QtCore/QList>
 
 // ACF includes
-#include <istd/TDelPtr.h>
 #include <iser/ISerializable.h>
 #include <iser/CMemoryWriteArchive.h>
 #include <imod/TSingleModelObserverBase.h>
@@ -19,11 +19,12 @@ namespace idoc
 
 
 /**
-	Implements multi-level UNDO mechanism based on storing complete object state at each step using serialization.
+	Implements multi-level UNDO mechanism based on storing object state differences at each step using serialization.
 	
 	This component provides a complete undo/redo implementation by serializing the entire
-	document state before each change. It maintains separate undo and redo stacks and
-	automatically manages memory usage by limiting the buffer size.
+	document state after each change. Only the serialized current state is kept completely,
+	the undo and redo steps store binary differences to the neighbouring states (see \c istd::CBinaryDelta).
+	It maintains separate undo and redo stacks and automatically manages memory usage by limiting the buffer size.
 	
 	The undo manager observes the document model and automatically captures state snapshots
 	when changes occur. It integrates with the ACF model/observer pattern to track when
@@ -31,6 +32,7 @@ namespace idoc
 	
 	\par Component Attributes
 	- \b MaxBufferSize - Maximum memory size for undo buffer in megabytes (default: 100 MB)
+	- \b UncompressedStepsCount - Number of the newest undo steps kept uncompressed (default: 8)
 	
 	\par Registered Interfaces
 	- idoc::IUndoManager - Provides undo/redo operations
@@ -58,10 +60,10 @@ namespace idoc
 	\par How It Works
 	The undo manager:
 	1. Attaches to a serializable document as an observer
-	2. Before each document change, serializes current state to memory
-	3. Stores serialized state in undo stack with a description
-	4. On undo, deserializes previous state from stack
-	5. Manages memory by removing oldest undo steps when buffer is full
+	2. Keeps the serialized current state, it is created before the first change only
+	3. After each document change stores difference to the previous state in undo stack with a description
+	4. On undo, reconstructs previous state from the differences and deserializes it
+	5. Compresses older undo steps and removes oldest undo steps when buffer is full
 	
 	\par Usage Example
 	\code
@@ -96,7 +98,7 @@ namespace idoc
 	
 	\note The document must implement iser::ISerializable for this undo manager to work.
 	\note Memory usage is automatically managed based on MaxBufferSize setting.
-	\note Each undo step stores the complete document state, so large documents may use significant memory.
+	\note Each undo step stores only the changed part of the document state, but every change still serializes the complete document.
 	
 	\sa IUndoManager, IDocumentStateComparator
 	\ingroup DocumentBasedFramework
@@ -115,6 +117,7 @@ public:
 		I_REGISTER_INTERFACE(idoc::IDocumentStateComparator);
 		I_REGISTER_INTERFACE(imod::IObserver);
 		I_ASSIGN(m_maxBufferSizeAttrPtr, "MaxBufferSize", "Maximal memory size of the Undo-buffer in MByte", false, 100);
+		I_ASSIGN(m_uncompressedStepsCountAttrPtr, "UncompressedStepsCount", "Number of the newest undo steps kept uncompressed, older steps will be compressed", false, 8);
 	I_END_COMPONENT;
 
 	CSerializedUndoManagerComp();
@@ -133,10 +136,19 @@ public:
 	virtual bool OnModelDetached(imod::IModel* modelPtr) override;
 
 protected:
-	typedef istd::TDelPtr<iser::CMemoryWriteArchive> UndoArchivePtr;
 	struct UndoStepInfo
 	{
-		UndoArchivePtr archivePtr;
+		UndoStepInfo()
+		:	isCompressed(false)
+		{
+		}
+
+		/**
+			Difference transforming the neighbouring state to the state of this step.
+			For undo steps it is based on the state after the change, for redo steps on the state before the change.
+		*/
+		QByteArray delta;
+		bool isCompressed;
 		QString description;
 	};
 	typedef QList<UndoStepInfo> UndoList;
@@ -162,10 +174,44 @@ protected:
 private:
 	qint64 GetUsedMemorySize() const;
 
+	/**
+		Serialize the observed object into the reused serialization archive.
+	*/
+	bool SerializeObject();
+
+	/**
+		Serialize the observed object into the current state buffer.
+	*/
+	bool UpdateCurrentState();
+
+	/**
+		Update the current state after a change which is not stored as undo step.
+		The last undo and redo steps are recalculated to reference the new state.
+		If it is not possible, all steps will be removed.
+	*/
+	void RebaseSteps();
+	bool RebaseLastStep(const QByteArray& previousState, UndoList& stepList) const;
+
+	/**
+		Compress undo steps which became older than the uncompressed steps after adding of new steps.
+	*/
+	void CompressOlderSteps(int addedStepsCount);
+
+	static QByteArray GetStepDelta(const UndoStepInfo& step);
+
 	UndoList m_undoList;
 	UndoList m_redoList;
 
-	UndoArchivePtr m_beginStateArchivePtr;
+	/**
+		Serialized state of the observed object, all steps are related to this state.
+	*/
+	QByteArray m_currentState;
+	bool m_isCurrentStateValid;
+
+	/**
+		Archive reused for serialization of the observed object.
+	*/
+	iser::CMemoryWriteArchive m_serializationArchive;
 
 	bool m_hasStoredDocumentState;
 	bool m_isBlocked;
@@ -176,6 +222,7 @@ private:
 	mutable bool m_isStateChangedFlagValid;
 
 	I_ATTR(int, m_maxBufferSizeAttrPtr);
+	I_ATTR(int, m_uncompressedStepsCountAttrPtr);
 };
 
 
@@ -2,6 +2,9 @@
 #include <ifile/CAutoPersistenceComp.h>
 
 
+// STL includes
+#include <cstring>
+
 // Qt includes
 #include <QtCore/QtGlobal>
 #include <QtCore/QCoreApplication>
@@ -13,9 +16,11 @@
 #include <QtCore>
 #endif
 #include <QtCore/QTemporaryDir>
+#include <QtCore/QElapsedTimer>
 
 // ACF includes
 #include <istd/CSystem.h>
+#include <iser/CMemoryReadArchive.h>
 #include <ifile/IFileNameParam.h>
 
 
@@ -41,22 +46,40 @@ void CAutoPersistenceComp::SaveObjectSnapshot()
 		return;
 	}
 
+	QElapsedTimer timer;
+	timer.start();
+
 	iser::ISerializable* serializablePtr = dynamic_cast<iser::ISerializable*>(m_objectShadowPtr.GetPtr());
 
+	bool isStored = false;
+
 	// For the serializable objects memory comparison can be done:
 	if (serializablePtr != NULL){
-		iser::CMemoryWriteArchive currentState;
+		m_snapshotArchive.Reset();
 
-		if (serializablePtr->Serialize(currentState)){
-			if (currentState == m_lastStoredObjectState){
+		if (serializablePtr->Serialize(m_snapshotArchive)){
+			const char* statePtr = static_cast<const char*>(m_snapshotArchive.GetBuffer());
+			int stateSize = m_snapshotArchive.GetBufferSize();
+
+			if ((stateSize == m_lastStoredObjectState.size()) && (std::memcmp(statePtr, m_lastStoredObjectState.constData(), size_t(stateSize)) == 0)){
 				return;
 			}
 
-			m_lastStoredObjectState = currentState;
+			m_lastStoredObjectState = QByteArray(statePtr, stateSize);
+
+			if (*m_useJournalAttrPtr){
+				isStored = StoreObjectToJournal(*m_objectShadowPtr.GetPtr(), m_lastStoredObjectState);
+			}
 		}
 	}
 
-	StoreObject(*m_objectShadowPtr.GetPtr());
+	if (!isStored){
+		StoreObject(*m_objectShadowPtr.GetPtr());
+	}
+
+	if (IsVerboseEnabled()){
+		SendVerboseMessage(tr("Object snapshot stored in %1 ms").arg(timer.elapsed()));
+	}
 }
 
 
@@ -148,6 +171,124 @@ bool CAutoPersistenceComp::StoreObject(const istd::IChangeable& object)
 }
 
 
+bool CAutoPersistenceComp::StoreObjectToJournal(const istd::IChangeable& object, const QByteArray& objectState)
+{
+	QString filePath;
+	if (m_filePathCompPtr.IsValid()){
+		filePath = m_filePathCompPtr->GetPath();
+	}
+
+	if (filePath.isEmpty()){
+		return false;
+	}
+
+	m_journal.SetFilePath(GetJournalFilePath(filePath));
+	m_journal.SetBaseFilePath(filePath);
+
+	// the journal must not continue the state of the working file changed by someone else
+	bool isCompactionRequired =
+				!m_journal.IsValid() ||
+				m_journal.IsBaseFileChanged() ||
+				(m_journal.GetDeltasSize() > objectState.size() * *m_journalCompactionFactorAttrPtr);
+	if (!isCompactionRequired && m_journal.Append(objectState)){
+		return true;
+	}
+
+	// the new journal contains complete object state, so it stays valid also if the storing of the working file fails
+	if (!m_journal.Reset(objectState)){
+		SendWarningMessage(0, tr("Journal %1 could not be written").arg(m_journal.GetFilePath()));
+
+		return false;
+	}
+
+	if (IsVerboseEnabled()){
+		SendVerboseMessage(tr("Compact journal %1").arg(m_journal.GetFilePath()));
+	}
+
+	// the journal is bound to the old working file until the new one is completely stored
+	if (StoreObject(object) && !m_journal.UpdateBaseFileStamp()){
+		SendWarningMessage(0, tr("Journal %1 could not be bound to the working file").arg(m_journal.GetFilePath()));
+	}
+
+	return true;
+}
+
+
+bool CAutoPersistenceComp::RestoreObjectFromJournal(const QString& filePath)
+{
+	if (!*m_useJournalAttrPtr || !m_serializeableObjectCompPtr.IsValid() || filePath.isEmpty()){
+		return false;
+	}
+
+	m_journal.SetFilePath(GetJournalFilePath(filePath));
+	m_journal.SetBaseFilePath(filePath);
+
+	if (!QFile::exists(m_journal.GetFilePath())){
+		return false;
+	}
+
+	if (!m_journal.Replay()){
+		// outdated journal is removed during the replaying
+		if (!QFile::exists(m_journal.GetFilePath())){
+			SendWarningMessage(0, tr("Journal %1 is older than the working file and was discarded").arg(m_journal.GetFilePath()));
+		}
+
+		return false;
+	}
+
+	const QByteArray& objectState = m_journal.GetLastState();
+
+	iser::CMemoryReadArchive archive(objectState.constData(), objectState.size());
+	if (!m_serializeableObjectCompPtr->Serialize(archive)){
+		SendWarningMessage(0, tr("Object could not be restored from journal %1").arg(m_journal.GetFilePath()));
+
+		return false;
+	}
+
+	m_lastStoredObjectState = objectState;
+
+	SendInfoMessage(0, tr("Object restored from journal %1").arg(m_journal.GetFilePath()));
+
+	return true;
+}
+
+
+void CAutoPersistenceComp::CompactJournal()
+{
+	if (!m_journal.IsValid()){
+		return;
+	}
+
+	// the shadow object corresponds to the last journal state, without snapshot the journal state was restored into the object
+	const istd::IChangeable* objectPtr = m_objectShadowPtr.IsValid()? m_objectShadowPtr.GetPtr(): m_objectCompPtr.GetPtr();
+
+	if ((objectPtr != NULL) && StoreObject(*objectPtr)){
+		m_journal.Remove();
+	}
+}
+
+
+bool CAutoPersistenceComp::IsRelevantChange(const istd::IChangeable::ChangeSet& changeSet) const
+{
+	if (!m_ignoredChangeIdsAttrPtr.IsValid()){
+		return true;
+	}
+
+	QSet<int> changeIds = changeSet.GetIds();
+	if (changeIds.isEmpty()){
+		return true;
+	}
+
+	for (QSet<int>::ConstIterator iter = changeIds.constBegin(); iter != changeIds.constEnd(); ++iter){
+		if (m_ignoredChangeIdsAttrPtr.FindValue(*iter) < 0){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
 // reimplemented (icomp::CComponentBase)
 
 void CAutoPersistenceComp::OnComponentCreated()
@@ -162,6 +303,8 @@ void CAutoPersistenceComp::OnComponentCreated()
 	if (*m_restoreOnBeginAttrPtr){
 		if (m_fileLoaderCompPtr.IsValid() && m_objectCompPtr.IsValid()){
 			LoadObject(filePath);
+
+			RestoreObjectFromJournal(filePath);
 		}
 	}
 
@@ -211,7 +354,12 @@ void CAutoPersistenceComp::OnComponentDestroyed()
 
 		bool storeOnEnd = *m_storeOnEndAttrPtr || (!m_isLoadedFromFile && *m_storeOnChangeAttrPtr);
 		if (storeOnEnd && m_objectCompPtr.IsValid()){
-			StoreObject(*m_objectCompPtr.GetPtr());
+			if (StoreObject(*m_objectCompPtr.GetPtr())){
+				m_journal.Remove();
+			}
+		}
+		else{
+			CompactJournal();
 		}
 	}
 
@@ -227,7 +375,7 @@ void CAutoPersistenceComp::OnModelChanged(int modelId, const istd::IChangeable::
 	{
 		case MI_OBJECT:
 		{
-			if (changeSet.Contains(istd::IChangeable::CF_NO_UNDO)){
+			if (changeSet.Contains(istd::IChangeable::CF_NO_UNDO) || !IsRelevantChange(changeSet)){
 				return;
 			}
 
@@ -261,6 +409,11 @@ void CAutoPersistenceComp::OnModelChanged(int modelId, const istd::IChangeable::
 
 					LoadObject(filePath);
 
+					// the journal can be used by the storing thread
+					m_storingFuture.waitForFinished();
+
+					RestoreObjectFromJournal(filePath);
+
 					if (*m_reloadOnFileChangeAttrPtr){
 						m_fileWatcher.addPath(filePath);
 					}
@@ -278,7 +431,12 @@ void CAutoPersistenceComp::OnModelChanged(int modelId, const istd::IChangeable::
 
 				bool storeOnEnd = *m_storeOnEndAttrPtr || (!m_isLoadedFromFile && *m_storeOnChangeAttrPtr);
 				if (storeOnEnd && m_objectCompPtr.IsValid()){
-					StoreObject(*m_objectCompPtr.GetPtr());
+					if (StoreObject(*m_objectCompPtr.GetPtr())){
+						m_journal.Remove();
+					}
+				}
+				else{
+					CompactJournal();
 				}
 			}
 			break;
@@ -442,6 +600,14 @@ void CAutoPersistenceComp::UnlockFile() const
 }
 
 
+// private static methods
+
+QString CAutoPersistenceComp::GetJournalFilePath(const QString& filePath)
+{
+	return filePath + ".journal";
+}
+
+
 } // namespace ifile
 
 
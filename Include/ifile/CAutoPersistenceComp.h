@@ -16,6 +16,7 @@
 #include <iser/CMemoryWriteArchive.h>
 #include <ifile/IFilePersistence.h>
 #include <ifile/IFileNameParam.h>
+#include <ifile/CStateJournal.h>
 #include <ibase/IRuntimeStatusProvider.h>
 
 #if QT_VERSION >= 0x050000
@@ -36,6 +37,11 @@ namespace ifile
 	Also you can specify some time interval for permanently data storing.
 	If this parameter is set, then the object will be stored to the file in the given time interval, but only if the object data was changed.
 	\note If the time interval for the object storing is set, the \c StoreOnChange attribute will be ignored.
+	Enable \c UseJournal attribute to store the changes of serializable objects in the given time interval as differences to an append-only journal file
+	placed next to the data file. The data file is written only if the journal is compacted or at the end.
+	If the application was not terminated correctly, the object state will be restored from the journal on the next start.
+	The journal is bound to the size and modification time of the data file, if the data file was changed after that, the journal is discarded.
+	Changes with IDs listed in \c IgnoredChangeIds attribute don't trigger storing of the object.
 	\note Please note, that this component doesn't provide any public interfaces. The data object will be attached to the internal observer during the initialization phase of the component.
 	To enforce the instantiation of this component, you should activate 'Automatically create instance' flag in the Compositor.
 
@@ -91,6 +97,9 @@ public:
 		I_ASSIGN(m_enableLockForLoadAttrPtr, "EnableLockForRead", "When enabled lock is also set when reading from file."
 					"\nNOTE: On NTFS file systems, ownership and permissions checking is disabled (in QT) by default for performance reasons."
 					"\nEnable this flag when you are known what you are doing.", true, false);
+		I_ASSIGN(m_useJournalAttrPtr, "UseJournal", "If enabled, changes of serializable object stored in time interval will be appended to journal file", true, false);
+		I_ASSIGN(m_journalCompactionFactorAttrPtr, "JournalCompactionFactor", "Size of journal related to the object data size, after that the journal will be compacted into the data file", true, 1.0);
+		I_ASSIGN_MULTI_0(m_ignoredChangeIdsAttrPtr, "IgnoredChangeIds", "List of change IDs which don't trigger storing of the object", false);
 	I_END_COMPONENT;
 
 	/**
@@ -113,6 +122,27 @@ protected:
 	*/
 	virtual bool StoreObject(const istd::IChangeable& object);
 
+	/**
+		Store serialized object state to the journal file.
+		If the journal is too large, it will be compacted and the object will be stored to the working file.
+	*/
+	bool StoreObjectToJournal(const istd::IChangeable& object, const QByteArray& objectState);
+
+	/**
+		Restore object from the journal, if it was not compacted on the last run.
+	*/
+	bool RestoreObjectFromJournal(const QString& filePath);
+
+	/**
+		Store the last journal state to the working file and remove the journal.
+	*/
+	void CompactJournal();
+
+	/**
+		Check if the change should trigger storing of the object.
+	*/
+	bool IsRelevantChange(const istd::IChangeable::ChangeSet& changeSet) const;
+
 	// reimplemented (icomp::CComponentBase)
 	virtual void OnComponentCreated() override;
 	virtual void OnComponentDestroyed() override;
@@ -137,6 +167,8 @@ private:
 	bool LockFile(const QString& filePath, bool store) const;
 	void UnlockFile() const;
 
+	static QString GetJournalFilePath(const QString& filePath);
+
 private:
 	I_REF(ibase::IRuntimeStatusProvider, m_runtimeStatusCompPtr);
 	I_REF(imod::IModel, m_runtimeStatusModelCompPtr);
@@ -212,7 +244,35 @@ private:
 	*/
 	I_ATTR(bool, m_enableLockForLoadAttrPtr);
 
-	iser::CMemoryWriteArchive m_lastStoredObjectState;
+	/**
+		Enable storing of the changes to the journal file.
+	*/
+	I_ATTR(bool, m_useJournalAttrPtr);
+
+	/**
+		Maximal size of the journal differences related to the object state size.
+	*/
+	I_ATTR(double, m_journalCompactionFactorAttrPtr);
+
+	/**
+		List of change IDs ignored by the change tracking.
+	*/
+	I_MULTIATTR(int, m_ignoredChangeIdsAttrPtr);
+
+	/**
+		Serialized object state of the last storing, used to skip storing of unchanged data.
+	*/
+	QByteArray m_lastStoredObjectState;
+
+	/**
+		Archive reused for serialization of the object snapshots.
+	*/
+	iser::CMemoryWriteArchive m_snapshotArchive;
+
+	/**
+		Journal of the object states stored in the time interval.
+	*/
+	CStateJournal m_journal;
 
 	/**
 		Flag indicating that object has been changed.
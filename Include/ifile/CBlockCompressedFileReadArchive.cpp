@@ -0,0 +1,412 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/CBlockCompressedFileReadArchive.h>
+
+
+// STL includes
+#include <climits>
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtConcurrent/QtConcurrent>
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+
+
+namespace ifile
+{
+
+
+namespace
+{
+
+
+static const int s_maxPrefetchBlocksCount = 8;
+
+
+QByteArray DecompressBlock(const QByteArray& compressedData)
+{
+	return qUncompress(compressedData);
+}
+
+
+} // namespace
+
+
+CBlockCompressedFileReadArchive::CBlockCompressedFileReadArchive(const QString& filePath, bool serializeHeader)
+:	BaseClass2(filePath),
+	m_isSkipIndexUsed(false),
+	m_nextTagIndex(0),
+	m_currentBlockIndex(-1),
+	m_currentBlockPosition(0),
+	m_readPosition(0),
+	m_prefetchBlocksCount(qBound(1, QThread::idealThreadCount(), s_maxPrefetchBlocksCount)),
+	m_decompressedBlocksCount(0)
+{
+	std::memset(&m_trailer, 0, sizeof(m_trailer));
+
+	if (!filePath.isEmpty() && OpenFile(filePath)){
+		if (serializeHeader){
+			SerializeAcfHeader();
+		}
+	}
+}
+
+
+qint64 CBlockCompressedFileReadArchive::GetDataSize() const
+{
+	return qint64(m_trailer.dataSize);
+}
+
+
+int CBlockCompressedFileReadArchive::GetDecompressedBlocksCount() const
+{
+	return m_decompressedBlocksCount;
+}
+
+
+bool CBlockCompressedFileReadArchive::OpenFile(const QString& filePath)
+{
+	if (m_file.isOpen()){
+		m_file.close();
+	}
+
+	std::memset(&m_trailer, 0, sizeof(m_trailer));
+	m_blockIndex.clear();
+	m_skipIndex.clear();
+	m_isSkipIndexUsed = false;
+	m_nextTagIndex = 0;
+	m_tagStack.clear();
+	m_currentBlock.clear();
+	m_currentBlockIndex = -1;
+	m_currentBlockPosition = 0;
+	m_readPosition = 0;
+	m_prefetchedBlocks.clear();
+	m_decompressedBlocksCount = 0;
+
+	m_filePath = filePath;
+	m_file.setFileName(filePath);
+	if (!m_file.open(QIODevice::ReadOnly)){
+		if (IsLogConsumed()){
+			SendLogMessage(
+						istd::IInformationProvider::IC_ERROR,
+						MI_FILE_OPEN_ERROR,
+						QString("Cannot open file: %1").arg(m_file.errorString()),
+						"BlockCompressedReader",
+						istd::IInformationProvider::ITF_SYSTEM);
+		}
+
+		return false;
+	}
+
+	if (!LoadIndex()){
+		if (IsLogConsumed()){
+			SendLogMessage(
+						istd::IInformationProvider::IC_ERROR,
+						MI_FILE_OPEN_ERROR,
+						QString("File has no valid block index"),
+						"BlockCompressedReader",
+						istd::IInformationProvider::ITF_SYSTEM);
+		}
+
+		m_file.close();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+// reimplemented (ifile::IArchive)
+
+bool CBlockCompressedFileReadArchive::IsOpen() const
+{
+	return m_file.isOpen();
+}
+
+
+bool CBlockCompressedFileReadArchive::IsTagSkippingSupported() const
+{
+	return true;
+}
+
+
+bool CBlockCompressedFileReadArchive::BeginTag(const iser::CArchiveTag& tag)
+{
+	bool retVal = BaseClass::BeginTag(tag);
+
+	if (!retVal){
+		return false;
+	}
+
+	m_tagStack.push_back(TagStackElement());
+	TagStackElement& element = m_tagStack.back();
+
+	element.tagBinaryId = tag.GetBinaryId();
+
+	// the end position is stored in the skip index only
+	quint32 dummyPos = 0;
+	retVal = retVal && Process(dummyPos);
+
+	element.useTagSkipping = tag.IsTagSkippingUsed();
+	element.skipIndex = 0;
+
+	// skippable tags are numbered in the same order as by writing
+	if (element.useTagSkipping){
+		element.skipIndex = m_nextTagIndex++;
+	}
+
+	return retVal;
+}
+
+
+bool CBlockCompressedFileReadArchive::EndTag(const iser::CArchiveTag& tag)
+{
+	TagStackElement& element = m_tagStack.back();
+
+	bool retVal = (element.tagBinaryId == tag.GetBinaryId());
+
+	if (!retVal){
+		qFatal("BeginTag and EndTag have to use the same tag");
+
+		return false;
+	}
+
+	if (element.useTagSkipping && m_isSkipIndexUsed){
+		if ((element.skipIndex < quint32(m_skipIndex.size())) && (m_skipIndex[int(element.skipIndex)].tagBinaryId == element.tagBinaryId)){
+			const SkipIndexEntry& entry = m_skipIndex[int(element.skipIndex)];
+
+			// only the read position is changed, the block will be loaded on the next reading
+			m_readPosition = qint64(entry.endPosition);
+			m_nextTagIndex = entry.nextTagIndex;
+		}
+		else{
+			// the tags don't correspond to the index, skipping is not possible anymore
+			m_isSkipIndexUsed = false;
+		}
+	}
+
+	m_tagStack.pop_back();
+
+	retVal = retVal && BaseClass::EndTag(tag);
+
+	return retVal;
+}
+
+
+bool CBlockCompressedFileReadArchive::ProcessData(void* data, int size)
+{
+	if (size <= 0){
+		return true;
+	}
+
+	if (data == nullptr){
+		return false;
+	}
+
+	if (size > GetDataSize() - m_readPosition){
+		return false;
+	}
+
+	char* buffer = static_cast<char*>(data);
+
+	while (size > 0){
+		qint64 blockOffset = m_readPosition - m_currentBlockPosition;
+		if ((m_currentBlockIndex < 0) || (blockOffset < 0) || (blockOffset >= m_currentBlock.size())){
+			if (!LoadBlock(int(m_readPosition / m_trailer.blockSize))){
+				return false;
+			}
+
+			blockOffset = m_readPosition - m_currentBlockPosition;
+		}
+
+		int copySize = int(qMin(qint64(size), qint64(m_currentBlock.size()) - blockOffset));
+
+		std::memcpy(buffer, m_currentBlock.constData() + blockOffset, size_t(copySize));
+
+		buffer += copySize;
+		size -= copySize;
+		m_readPosition += copySize;
+	}
+
+	return true;
+}
+
+
+// protected methods
+
+// reimplemented (istd::ILogger)
+
+void CBlockCompressedFileReadArchive::DecorateMessage(
+			istd::IInformationProvider::InformationCategory /*category*/,
+			int /*id*/,
+			int /*flags*/,
+			QString& message,
+			QString& /*messageSource*/) const
+{
+	message = m_filePath + " : " + message;
+}
+
+
+// reimplemented (iser::CArchiveBase)
+
+int CBlockCompressedFileReadArchive::GetMaxStringLength() const
+{
+	return int(qMin(GetDataSize() - m_readPosition, qint64(INT_MAX)));
+}
+
+
+// private methods
+
+bool CBlockCompressedFileReadArchive::LoadIndex()
+{
+	qint64 trailerPosition = m_file.size() - qint64(sizeof(BlockIndexTrailer));
+	if (trailerPosition < 0){
+		return false;
+	}
+
+	bool retVal = m_file.seek(trailerPosition);
+	retVal = retVal && (m_file.read(reinterpret_cast<char*>(&m_trailer), qint64(sizeof(m_trailer))) == qint64(sizeof(m_trailer)));
+	retVal = retVal && IsBlockIndexTrailerValid(m_trailer, trailerPosition);
+	retVal = retVal && m_file.seek(qint64(m_trailer.blockIndexPosition));
+
+	if (retVal && (m_trailer.blocksCount > 0)){
+		m_blockIndex.resize(int(m_trailer.blocksCount));
+
+		qint64 indexSize = qint64(m_trailer.blocksCount) * qint64(sizeof(BlockIndexEntry));
+
+		retVal = (m_file.read(reinterpret_cast<char*>(m_blockIndex.data()), indexSize) == indexSize);
+	}
+
+	for (int i = 0; retVal && (i < m_blockIndex.size()); ++i){
+		retVal = IsBlockIndexEntryValid(m_blockIndex[i], i, m_trailer);
+	}
+
+	if (retVal && (m_trailer.skipEntriesCount > 0)){
+		m_skipIndex.resize(int(m_trailer.skipEntriesCount));
+
+		qint64 indexSize = qint64(m_trailer.skipEntriesCount) * qint64(sizeof(SkipIndexEntry));
+
+		retVal = (m_file.read(reinterpret_cast<char*>(m_skipIndex.data()), indexSize) == indexSize);
+	}
+
+	// the end positions are related to the uncompressed data
+	SkipIndexTrailer skipIndexTrailer;
+	skipIndexTrailer.indexPosition = m_trailer.dataSize;
+	skipIndexTrailer.entriesCount = m_trailer.skipEntriesCount;
+	skipIndexTrailer.magic = SKIP_INDEX_MAGIC;
+
+	for (int i = 0; retVal && (i < m_skipIndex.size()); ++i){
+		retVal = IsSkipIndexEntryValid(m_skipIndex[i], skipIndexTrailer);
+	}
+
+	if (!retVal){
+		std::memset(&m_trailer, 0, sizeof(m_trailer));
+		m_blockIndex.clear();
+		m_skipIndex.clear();
+	}
+
+	m_isSkipIndexUsed = retVal;
+
+	return retVal;
+}
+
+
+bool CBlockCompressedFileReadArchive::LoadBlock(int blockIndex)
+{
+	if (blockIndex == m_currentBlockIndex){
+		return true;
+	}
+
+	if ((blockIndex < 0) || (blockIndex >= m_blockIndex.size())){
+		return false;
+	}
+
+	bool isSequential = (m_currentBlockIndex >= 0) && (blockIndex == m_currentBlockIndex + 1);
+
+	QByteArray block;
+
+	PrefetchedBlocks::Iterator foundIter = m_prefetchedBlocks.find(blockIndex);
+	if (foundIter != m_prefetchedBlocks.end()){
+		block = foundIter.value().result();
+	}
+	else{
+		block = DecompressBlock(ReadCompressedBlock(blockIndex));
+
+		++m_decompressedBlocksCount;
+	}
+
+	// the blocks decompressed in advance are useful only for the sequential reading
+	if (isSequential){
+		while (!m_prefetchedBlocks.isEmpty() && (m_prefetchedBlocks.firstKey() <= blockIndex)){
+			m_prefetchedBlocks.erase(m_prefetchedBlocks.begin());
+		}
+	}
+	else{
+		m_prefetchedBlocks.clear();
+	}
+
+	if (block.size() != int(m_blockIndex[blockIndex].uncompressedSize)){
+		if (IsLogConsumed()){
+			SendLogMessage(
+						istd::IInformationProvider::IC_ERROR,
+						MI_BLOCK_ERROR,
+						QString("Block %1 cannot be decompressed").arg(blockIndex),
+						"BlockCompressedReader",
+						istd::IInformationProvider::ITF_SYSTEM);
+		}
+
+		return false;
+	}
+
+	m_currentBlock = block;
+	m_currentBlockIndex = blockIndex;
+	m_currentBlockPosition = qint64(blockIndex) * m_trailer.blockSize;
+
+	if (isSequential){
+		PrefetchBlocks(blockIndex + 1);
+	}
+
+	return true;
+}
+
+
+QByteArray CBlockCompressedFileReadArchive::ReadCompressedBlock(int blockIndex)
+{
+	const BlockIndexEntry& entry = m_blockIndex[blockIndex];
+
+	if (!m_file.seek(qint64(entry.position))){
+		return QByteArray();
+	}
+
+	return m_file.read(qint64(entry.compressedSize));
+}
+
+
+void CBlockCompressedFileReadArchive::PrefetchBlocks(int blockIndex)
+{
+	int lastBlockIndex = qMin(blockIndex + m_prefetchBlocksCount, int(m_blockIndex.size()));
+
+	for (int i = blockIndex; i < lastBlockIndex; ++i){
+		if (m_prefetchedBlocks.contains(i)){
+			continue;
+		}
+
+		QByteArray compressedBlock = ReadCompressedBlock(i);
+		if (compressedBlock.isEmpty()){
+			break;
+		}
+
+		m_prefetchedBlocks[i] = QtConcurrent::run(DecompressBlock, compressedBlock);
+
+		++m_decompressedBlocksCount;
+	}
+}
+
+
+} // namespace ifile
+
+
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+#include <QtCore/QFile>
+#include <QtCore/QFuture>
+
+// ACF includes
+#include <iser/CBinaryReadArchiveBase.h>
+#include <ifile/CFileArchiveInfo.h>
+
+
+namespace ifile
+{
+
+
+/**
+	Implementation of archive reading from files created by \c ifile::CBlockCompressedFileWriteArchive.
+
+	The blocks are decompressed on demand, only the current block is kept in memory.
+	During sequential reading the following blocks are decompressed in advance using the global thread pool.
+	Skipped tags are mapped onto the block index, so the blocks containing only skipped data are not loaded.
+	The skipping is known first at the end of the tag, so up to the prefetch count of skipped blocks following the last read block
+	can still be decompressed in advance.
+
+	\ingroup Persistence
+*/
+class CBlockCompressedFileReadArchive:
+			public iser::CBinaryReadArchiveBase,
+			public CFileArchiveInfo
+{
+public:
+	/**
+		Message IDs generated by this archive.
+	*/
+	enum MessageId
+	{
+		MI_FILE_OPEN_ERROR = 0x3f320c2,
+		MI_BLOCK_ERROR
+	};
+
+	typedef iser::CBinaryReadArchiveBase BaseClass;
+	typedef CFileArchiveInfo BaseClass2;
+
+	/**
+		Contructor.
+		\param	filePath			name of file.
+		\param	serializeHeader		if it is true (default) archive header will be serialized.
+	*/
+	CBlockCompressedFileReadArchive(const QString& filePath = "", bool serializeHeader = true);
+
+	/**
+		Get size of the uncompressed archive data.
+	*/
+	qint64 GetDataSize() const;
+
+	/**
+		Get number of blocks decompressed since opening of the file, including the blocks decompressed in advance.
+	*/
+	int GetDecompressedBlocksCount() const;
+
+	// reimplemented (ifile::IArchive)
+	virtual bool IsOpen() const override;
+	virtual bool IsTagSkippingSupported() const override;
+	virtual bool BeginTag(const iser::CArchiveTag& tag) override;
+	virtual bool EndTag(const iser::CArchiveTag& tag) override;
+	virtual bool ProcessData(void* data, int size) override;
+
+protected:
+	bool OpenFile(const QString& filePath);
+
+	struct TagStackElement
+	{
+		quint32 tagBinaryId;
+		bool useTagSkipping;
+		/**
+			Index of the tag in the skip index.
+		*/
+		quint32 skipIndex;
+	};
+
+	// reimplemented (istd::ILogger)
+	virtual void DecorateMessage(
+				istd::IInformationProvider::InformationCategory category,
+				int id,
+				int flags,
+				QString& message,
+				QString& messageSource) const override;
+
+	// reimplemented (iser::CArchiveBase)
+	virtual int GetMaxStringLength() const override;
+
+private:
+	/**
+		Load block index and skip index from the end of the file.
+	*/
+	bool LoadIndex();
+
+	/**
+		Make the block containing the current read position to the current one.
+	*/
+	bool LoadBlock(int blockIndex);
+
+	QByteArray ReadCompressedBlock(int blockIndex);
+
+	/**
+		Start decompression of blocks following the given one.
+	*/
+	void PrefetchBlocks(int blockIndex);
+
+	QFile m_file;
+
+	BlockIndexTrailer m_trailer;
+
+	typedef QVector<BlockIndexEntry> BlockIndex;
+
+	BlockIndex m_blockIndex;
+
+	typedef QVector<SkipIndexEntry> SkipIndex;
+
+	SkipIndex m_skipIndex;
+	bool m_isSkipIndexUsed;
+	quint32 m_nextTagIndex;
+
+	typedef QVector<TagStackElement> TagStack;
+
+	TagStack m_tagStack;
+
+	QByteArray m_currentBlock;
+	int m_currentBlockIndex;
+	qint64 m_currentBlockPosition;
+	qint64 m_readPosition;
+
+	typedef QMap<int, QFuture<QByteArray> > PrefetchedBlocks;
+
+	PrefetchedBlocks m_prefetchedBlocks;
+	int m_prefetchBlocksCount;
+	int m_decompressedBlocksCount;
+};
+
+
+} // namespace ifile
+
+
@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/CBlockCompressedFileWriteArchive.h>
+
+
+// STL includes
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QThread>
+#include <QtConcurrent/QtConcurrent>
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+
+
+namespace ifile
+{
+
+
+namespace
+{
+
+
+QByteArray CompressBlock(const QByteArray& data, int compressionLevel)
+{
+	return qCompress(data, compressionLevel);
+}
+
+
+} // namespace
+
+
+CBlockCompressedFileWriteArchive::CBlockCompressedFileWriteArchive(
+			const QString& filePath,
+			const iser::IVersionInfo* versionInfoPtr,
+			bool serializeHeader,
+			int blockSize,
+			int compressionLevel)
+:	BaseClass(versionInfoPtr),
+	BaseClass2(filePath),
+	m_file(filePath),
+	m_blockSize(qMax(blockSize, 1)),
+	m_compressionLevel(compressionLevel),
+	m_dataSize(0),
+	m_maxPendingBlocksCount(2 * qMax(QThread::idealThreadCount(), 1)),
+	m_isValid(false),
+	m_isClosed(false)
+{
+	m_blockBuffer.reserve(m_blockSize);
+
+	m_isValid = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+	if (serializeHeader){
+		SerializeAcfHeader(iser::CArchiveHeaderInfo::AFV_SKIP_INDEX);
+	}
+}
+
+
+CBlockCompressedFileWriteArchive::~CBlockCompressedFileWriteArchive()
+{
+	Close();
+}
+
+
+bool CBlockCompressedFileWriteArchive::Close()
+{
+	if (m_isClosed){
+		return m_isValid;
+	}
+
+	m_isClosed = true;
+
+	if (!m_isValid){
+		return false;
+	}
+
+	if (!m_blockBuffer.isEmpty()){
+		SubmitBlock();
+	}
+
+	bool retVal = WriteCompressedBlocks(0) && WriteIndex();
+
+	// the buffered data are written on closing, all write errors are kept in the file error state
+	m_file.close();
+
+	m_isValid = retVal && (m_file.error() == QFile::NoError);
+	if (!m_isValid){
+		SendWriteErrorMessage();
+	}
+
+	return m_isValid;
+}
+
+
+// reimplemented (iser::IArchive)
+
+bool CBlockCompressedFileWriteArchive::IsTagSkippingSupported() const
+{
+	return true;
+}
+
+
+bool CBlockCompressedFileWriteArchive::BeginTag(const iser::CArchiveTag& tag)
+{
+	bool retVal = m_isValid && !m_isClosed && BaseClass::BeginTag(tag);
+
+	if (!retVal){
+		return false;
+	}
+
+	m_tagStack.push_back(TagStackElement());
+	TagStackElement& element = m_tagStack.back();
+
+	element.tagBinaryId = tag.GetBinaryId();
+	element.skipIndex = -1;
+
+	if (tag.IsTagSkippingUsed()){
+		element.skipIndex = m_skipIndex.size();
+
+		SkipIndexEntry entry;
+		entry.endPosition = 0;
+		entry.tagBinaryId = element.tagBinaryId;
+		entry.nextTagIndex = 0;
+
+		m_skipIndex.push_back(entry);
+	}
+
+	// the end position is stored in the skip index, this field is kept for compatibility with the binary format
+	quint32 dummyPos = 0;
+	retVal = retVal && Process(dummyPos);
+
+	return retVal;
+}
+
+
+bool CBlockCompressedFileWriteArchive::EndTag(const iser::CArchiveTag& tag)
+{
+	TagStackElement& element = m_tagStack.back();
+
+	bool retVal = (element.tagBinaryId == tag.GetBinaryId());
+
+	if (!retVal){
+		qFatal("BeginTag and EndTag have to use the same tag");
+
+		return false;
+	}
+
+	if (element.skipIndex >= 0){
+		SkipIndexEntry& entry = m_skipIndex[element.skipIndex];
+
+		entry.endPosition = m_dataSize;
+		entry.nextTagIndex = quint32(m_skipIndex.size());
+	}
+
+	m_tagStack.pop_back();
+
+	return retVal && BaseClass::EndTag(tag);
+}
+
+
+bool CBlockCompressedFileWriteArchive::ProcessData(void* data, int size)
+{
+	if (size <= 0){
+		return true;
+	}
+
+	if ((data == nullptr) || !m_isValid || m_isClosed){
+		return false;
+	}
+
+	const char* dataPtr = static_cast<const char*>(data);
+
+	while (size > 0){
+		int copySize = qMin(size, m_blockSize - int(m_blockBuffer.size()));
+
+		m_blockBuffer.append(dataPtr, copySize);
+
+		dataPtr += copySize;
+		size -= copySize;
+		m_dataSize += quint64(copySize);
+
+		if (m_blockBuffer.size() >= m_blockSize){
+			SubmitBlock();
+
+			if (!WriteCompressedBlocks(m_maxPendingBlocksCount)){
+				m_isValid = false;
+
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// private methods
+
+void CBlockCompressedFileWriteArchive::SubmitBlock()
+{
+	PendingBlock pendingBlock;
+	pendingBlock.uncompressedSize = quint32(m_blockBuffer.size());
+	pendingBlock.compressedFuture = QtConcurrent::run(CompressBlock, m_blockBuffer, m_compressionLevel);
+
+	m_pendingBlocks.push_back(pendingBlock);
+
+	// the previous buffer is owned by the compression task now
+	m_blockBuffer = QByteArray();
+	m_blockBuffer.reserve(m_blockSize);
+}
+
+
+bool CBlockCompressedFileWriteArchive::WriteCompressedBlocks(int maxPendingCount)
+{
+	while (!m_pendingBlocks.isEmpty()){
+		PendingBlock& pendingBlock = m_pendingBlocks.front();
+
+		// finished blocks are written immediately, the others only if there are too many pending blocks
+		if ((m_pendingBlocks.size() <= maxPendingCount) && !pendingBlock.compressedFuture.isFinished()){
+			break;
+		}
+
+		QByteArray compressedBlock = pendingBlock.compressedFuture.result();
+		if (compressedBlock.isEmpty()){
+			return false;
+		}
+
+		BlockIndexEntry entry;
+		entry.position = quint64(m_file.pos());
+		entry.compressedSize = quint32(compressedBlock.size());
+		entry.uncompressedSize = pendingBlock.uncompressedSize;
+
+		if (m_file.write(compressedBlock) != compressedBlock.size()){
+			return false;
+		}
+
+		m_blockIndex.push_back(entry);
+
+		m_pendingBlocks.pop_front();
+	}
+
+	return true;
+}
+
+
+bool CBlockCompressedFileWriteArchive::WriteIndex()
+{
+	BlockIndexTrailer trailer;
+	trailer.blockIndexPosition = quint64(m_file.pos());
+	trailer.dataSize = m_dataSize;
+	trailer.blocksCount = quint32(m_blockIndex.size());
+	trailer.blockSize = quint32(m_blockSize);
+	trailer.skipEntriesCount = quint32(m_skipIndex.size());
+	trailer.magic = BLOCK_INDEX_MAGIC;
+
+	qint64 blockIndexSize = qint64(m_blockIndex.size()) * qint64(sizeof(BlockIndexEntry));
+	if ((blockIndexSize > 0) && (m_file.write(reinterpret_cast<const char*>(m_blockIndex.constData()), blockIndexSize) != blockIndexSize)){
+		return false;
+	}
+
+	qint64 skipIndexSize = qint64(m_skipIndex.size()) * qint64(sizeof(SkipIndexEntry));
+	if ((skipIndexSize > 0) && (m_file.write(reinterpret_cast<const char*>(m_skipIndex.constData()), skipIndexSize) != skipIndexSize)){
+		return false;
+	}
+
+	return (m_file.write(reinterpret_cast<const char*>(&trailer), qint64(sizeof(trailer))) == qint64(sizeof(trailer)));
+}
+
+
+void CBlockCompressedFileWriteArchive::SendWriteErrorMessage()
+{
+	if (IsLogConsumed()){
+		SendLogMessage(
+					istd::IInformationProvider::IC_ERROR,
+					MI_FILE_WRITE_ERROR,
+					QString("Cannot write file: %1").arg(m_file.errorString()),
+					"BlockCompressedWriter",
+					istd::IInformationProvider::ITF_SYSTEM);
+	}
+}
+
+
+} // namespace ifile
+
+
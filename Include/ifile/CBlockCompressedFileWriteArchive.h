@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtCore/QFile>
+#include <QtCore/QFuture>
+
+// ACF includes
+#include <iser/CBinaryWriteArchiveBase.h>
+#include <ifile/CFileArchiveInfo.h>
+
+
+namespace ifile
+{
+
+
+/**
+	Implementation of archive writing to own ACF format binary file compressed in independent blocks.
+
+	The archive data has the same format as of \c ifile::CFileWriteArchive, but it is split into blocks of fixed size,
+	which are compressed in parallel using the global thread pool.
+	At the end of the file the block index and the skip index related to the uncompressed data are stored,
+	so \c ifile::CBlockCompressedFileReadArchive can skip tags without decompression of most of the skipped blocks.
+
+	\ingroup Persistence
+*/
+class CBlockCompressedFileWriteArchive:
+			public iser::CBinaryWriteArchiveBase,
+			public CFileArchiveInfo
+{
+public:
+	/**
+		Message IDs generated by this archive.
+	*/
+	enum MessageId
+	{
+		MI_FILE_WRITE_ERROR = 0x3f320c3
+	};
+
+	typedef iser::CBinaryWriteArchiveBase BaseClass;
+	typedef CFileArchiveInfo BaseClass2;
+
+	enum
+	{
+		DEFAULT_BLOCK_SIZE = 256 * 1024
+	};
+
+	/**
+		Contructor.
+		\param	filePath			name of file.
+		\param	serializeHeader		if it is true (default) archive header will be serialized.
+		\param	blockSize			size of the uncompressed blocks.
+		\param	compressionLevel	zlib compression level, -1 for the default one.
+	*/
+	CBlockCompressedFileWriteArchive(
+					const QString& filePath,
+					const iser::IVersionInfo* versionInfoPtr = NULL,
+					bool serializeHeader = true,
+					int blockSize = DEFAULT_BLOCK_SIZE,
+					int compressionLevel = -1);
+
+	virtual ~CBlockCompressedFileWriteArchive();
+
+	/**
+		Return \c true if the archive is valid (e.g. the file medium can be accessed)
+	*/
+	bool IsArchiveValid() const;
+
+	/**
+		Compress the rest of data, write the indices and close the file.
+		It is called automatically on archive destruction.
+	*/
+	bool Close();
+
+	// reimplemented (iser::IArchive)
+	virtual bool IsTagSkippingSupported() const override;
+	virtual bool BeginTag(const iser::CArchiveTag& tag) override;
+	virtual bool EndTag(const iser::CArchiveTag& tag) override;
+	virtual bool ProcessData(void* data, int size) override;
+
+protected:
+	struct TagStackElement
+	{
+		quint32 tagBinaryId;
+		/**
+			Index of the tag in the skip index or -1, if the tag is not skippable.
+		*/
+		int skipIndex;
+	};
+
+private:
+	/**
+		Start compression of the current block.
+	*/
+	void SubmitBlock();
+
+	/**
+		Write compressed blocks to the file in order, until at most \c maxPendingCount blocks are pending.
+	*/
+	bool WriteCompressedBlocks(int maxPendingCount);
+
+	/**
+		Write block index, skip index and the trailer at the end of the file.
+	*/
+	bool WriteIndex();
+
+	/**
+		Send error message with the file error description.
+	*/
+	void SendWriteErrorMessage();
+
+	QFile m_file;
+
+	QByteArray m_blockBuffer;
+	int m_blockSize;
+	int m_compressionLevel;
+
+	/**
+		Size of the uncompressed data written so far.
+	*/
+	quint64 m_dataSize;
+
+	struct PendingBlock
+	{
+		QFuture<QByteArray> compressedFuture;
+		quint32 uncompressedSize;
+	};
+
+	QList<PendingBlock> m_pendingBlocks;
+	int m_maxPendingBlocksCount;
+
+	typedef QVector<BlockIndexEntry> BlockIndex;
+
+	BlockIndex m_blockIndex;
+
+	typedef QVector<TagStackElement> TagStack;
+
+	TagStack m_tagStack;
+
+	typedef QVector<SkipIndexEntry> SkipIndex;
+
+	SkipIndex m_skipIndex;
+
+	bool m_isValid;
+	bool m_isClosed;
+};
+
+
+// public inline methods
+
+inline bool CBlockCompressedFileWriteArchive::IsArchiveValid() const
+{
+	return m_isValid;
+}
+
+
+} // namespace ifile
+
+
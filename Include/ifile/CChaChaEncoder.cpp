@@ -0,0 +1,514 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/CChaChaEncoder.h>
+
+
+// STL includes
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtConcurrent/QtConcurrent>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define ACF_CHACHA_SSE2
+	#include <emmintrin.h>
+
+	#if defined(_MSC_VER)
+		#define ACF_CHACHA_AVX2
+		#define ACF_CHACHA_AVX2_TARGET
+		#include <immintrin.h>
+		#include <intrin.h>
+	#elif defined(__GNUC__)
+		#define ACF_CHACHA_AVX2
+		#define ACF_CHACHA_AVX2_TARGET __attribute__((target("avx2")))
+		#include <immintrin.h>
+	#endif
+#endif
+
+
+namespace ifile
+{
+
+
+namespace
+{
+
+
+/**
+	Minimal number of blocks processed by a single thread.
+*/
+static const qint64 s_minBlocksPerThread = 16384;
+
+static const quint8 s_defaultKey[CChaChaEncoder::KEY_SIZE] = {
+			0x3a, 0xc1, 0x5f, 0x92, 0x07, 0xe4, 0x6b, 0xd8,
+			0x21, 0x9c, 0x4e, 0xb3, 0x70, 0x15, 0xaf, 0x68,
+			0xd2, 0x3f, 0x84, 0x5b, 0xe9, 0x06, 0x7d, 0xc0,
+			0x1b, 0xa6, 0x53, 0xf8, 0x34, 0x8d, 0xe2, 0x49};
+
+
+inline quint32 ReadWord(const quint8* dataPtr)
+{
+	return quint32(dataPtr[0]) | (quint32(dataPtr[1]) << 8) | (quint32(dataPtr[2]) << 16) | (quint32(dataPtr[3]) << 24);
+}
+
+
+inline quint32 RotateLeft(quint32 value, int shift)
+{
+	return (value << shift) | (value >> (32 - shift));
+}
+
+
+inline void QuarterRound(quint32* x, int a, int b, int c, int d)
+{
+	x[a] += x[b]; x[d] = RotateLeft(x[d] ^ x[a], 16);
+	x[c] += x[d]; x[b] = RotateLeft(x[b] ^ x[c], 12);
+	x[a] += x[b]; x[d] = RotateLeft(x[d] ^ x[a], 8);
+	x[c] += x[d]; x[b] = RotateLeft(x[b] ^ x[c], 7);
+}
+
+
+#if defined(ACF_CHACHA_SSE2)
+
+inline __m128i RotateLeft(__m128i value, int shift)
+{
+	return _mm_or_si128(_mm_slli_epi32(value, shift), _mm_srli_epi32(value, 32 - shift));
+}
+
+
+inline void QuarterRound(__m128i* x, int a, int b, int c, int d)
+{
+	x[a] = _mm_add_epi32(x[a], x[b]); x[d] = RotateLeft(_mm_xor_si128(x[d], x[a]), 16);
+	x[c] = _mm_add_epi32(x[c], x[d]); x[b] = RotateLeft(_mm_xor_si128(x[b], x[c]), 12);
+	x[a] = _mm_add_epi32(x[a], x[b]); x[d] = RotateLeft(_mm_xor_si128(x[d], x[a]), 8);
+	x[c] = _mm_add_epi32(x[c], x[d]); x[b] = RotateLeft(_mm_xor_si128(x[b], x[c]), 7);
+}
+
+
+/**
+	Encode four consecutive blocks, each of 16 state words holds the values of four blocks.
+*/
+void ProcessFourBlocks(const quint32* state, quint64 blockIndex, const quint8* dataPtr, quint8* resultPtr)
+{
+	__m128i initial[16];
+	for (int i = 0; i < 16; ++i){
+		initial[i] = _mm_set1_epi32(int(state[i]));
+	}
+
+	quint64 counters[4] = {blockIndex, blockIndex + 1, blockIndex + 2, blockIndex + 3};
+	initial[12] = _mm_setr_epi32(int(quint32(counters[0])), int(quint32(counters[1])), int(quint32(counters[2])), int(quint32(counters[3])));
+	initial[13] = _mm_setr_epi32(int(quint32(counters[0] >> 32)), int(quint32(counters[1] >> 32)), int(quint32(counters[2] >> 32)), int(quint32(counters[3] >> 32)));
+
+	__m128i x[16];
+	for (int i = 0; i < 16; ++i){
+		x[i] = initial[i];
+	}
+
+	for (int i = 0; i < 10; ++i){
+		QuarterRound(x, 0, 4, 8, 12);
+		QuarterRound(x, 1, 5, 9, 13);
+		QuarterRound(x, 2, 6, 10, 14);
+		QuarterRound(x, 3, 7, 11, 15);
+		QuarterRound(x, 0, 5, 10, 15);
+		QuarterRound(x, 1, 6, 11, 12);
+		QuarterRound(x, 2, 7, 8, 13);
+		QuarterRound(x, 3, 4, 9, 14);
+	}
+
+	for (int i = 0; i < 16; ++i){
+		x[i] = _mm_add_epi32(x[i], initial[i]);
+	}
+
+	// transpose each group of four words to get 16 bytes of each block
+	for (int wordIndex = 0; wordIndex < 16; wordIndex += 4){
+		__m128i t0 = _mm_unpacklo_epi32(x[wordIndex], x[wordIndex + 1]);
+		__m128i t1 = _mm_unpacklo_epi32(x[wordIndex + 2], x[wordIndex + 3]);
+		__m128i t2 = _mm_unpackhi_epi32(x[wordIndex], x[wordIndex + 1]);
+		__m128i t3 = _mm_unpackhi_epi32(x[wordIndex + 2], x[wordIndex + 3]);
+
+		__m128i blockWords[4] = {
+					_mm_unpacklo_epi64(t0, t1),
+					_mm_unpackhi_epi64(t0, t1),
+					_mm_unpacklo_epi64(t2, t3),
+					_mm_unpackhi_epi64(t2, t3)};
+
+		for (int blockOffset = 0; blockOffset < 4; ++blockOffset){
+			int byteOffset = blockOffset * CChaChaEncoder::BLOCK_SIZE + wordIndex * 4;
+
+			__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + byteOffset));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(resultPtr + byteOffset), _mm_xor_si128(data, blockWords[blockOffset]));
+		}
+	}
+}
+
+#endif // ACF_CHACHA_SSE2
+
+
+#if defined(ACF_CHACHA_AVX2)
+
+bool IsAvx2Supported()
+{
+#if defined(_MSC_VER)
+	int cpuInfo[4] = {0};
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7){
+		return false;
+	}
+
+	// the operating system has to save the AVX registers
+	__cpuid(cpuInfo, 1);
+	const int osxsaveBit = 1 << 27;
+	if (((cpuInfo[2] & osxsaveBit) == 0) || ((_xgetbv(0) & 0x6) != 0x6)){
+		return false;
+	}
+
+	__cpuidex(cpuInfo, 7, 0);
+	const int avx2Bit = 1 << 5;
+
+	return (cpuInfo[1] & avx2Bit) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+
+ACF_CHACHA_AVX2_TARGET
+inline __m256i RotateLeft(__m256i value, int shift)
+{
+	return _mm256_or_si256(_mm256_slli_epi32(value, shift), _mm256_srli_epi32(value, 32 - shift));
+}
+
+
+ACF_CHACHA_AVX2_TARGET
+inline void QuarterRound(__m256i* x, int a, int b, int c, int d)
+{
+	x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = RotateLeft(_mm256_xor_si256(x[d], x[a]), 16);
+	x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = RotateLeft(_mm256_xor_si256(x[b], x[c]), 12);
+	x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = RotateLeft(_mm256_xor_si256(x[d], x[a]), 8);
+	x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = RotateLeft(_mm256_xor_si256(x[b], x[c]), 7);
+}
+
+
+/**
+	Encode eight consecutive blocks, each of 16 state words holds the values of eight blocks.
+*/
+ACF_CHACHA_AVX2_TARGET
+void ProcessEightBlocks(const quint32* state, quint64 blockIndex, const quint8* dataPtr, quint8* resultPtr)
+{
+	__m256i initial[16];
+	for (int i = 0; i < 16; ++i){
+		initial[i] = _mm256_set1_epi32(int(state[i]));
+	}
+
+	int counterLow[8];
+	int counterHigh[8];
+	for (int i = 0; i < 8; ++i){
+		quint64 counter = blockIndex + quint64(i);
+
+		counterLow[i] = int(quint32(counter));
+		counterHigh[i] = int(quint32(counter >> 32));
+	}
+
+	initial[12] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counterLow));
+	initial[13] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counterHigh));
+
+	__m256i x[16];
+	for (int i = 0; i < 16; ++i){
+		x[i] = initial[i];
+	}
+
+	for (int i = 0; i < 10; ++i){
+		QuarterRound(x, 0, 4, 8, 12);
+		QuarterRound(x, 1, 5, 9, 13);
+		QuarterRound(x, 2, 6, 10, 14);
+		QuarterRound(x, 3, 7, 11, 15);
+		QuarterRound(x, 0, 5, 10, 15);
+		QuarterRound(x, 1, 6, 11, 12);
+		QuarterRound(x, 2, 7, 8, 13);
+		QuarterRound(x, 3, 4, 9, 14);
+	}
+
+	for (int i = 0; i < 16; ++i){
+		x[i] = _mm256_add_epi32(x[i], initial[i]);
+	}
+
+	// transpose each group of eight words to get 32 bytes of each block
+	for (int wordIndex = 0; wordIndex < 16; wordIndex += 8){
+		__m256i* w = x + wordIndex;
+
+		__m256i t0 = _mm256_unpacklo_epi32(w[0], w[1]);
+		__m256i t1 = _mm256_unpackhi_epi32(w[0], w[1]);
+		__m256i t2 = _mm256_unpacklo_epi32(w[2], w[3]);
+		__m256i t3 = _mm256_unpackhi_epi32(w[2], w[3]);
+		__m256i t4 = _mm256_unpacklo_epi32(w[4], w[5]);
+		__m256i t5 = _mm256_unpackhi_epi32(w[4], w[5]);
+		__m256i t6 = _mm256_unpacklo_epi32(w[6], w[7]);
+		__m256i t7 = _mm256_unpackhi_epi32(w[6], w[7]);
+
+		// words 0-3 and 4-7 of blocks n and n + 4 in the lower and upper lane
+		__m256i lowWords[4] = {
+					_mm256_unpacklo_epi64(t0, t2),
+					_mm256_unpackhi_epi64(t0, t2),
+					_mm256_unpacklo_epi64(t1, t3),
+					_mm256_unpackhi_epi64(t1, t3)};
+		__m256i highWords[4] = {
+					_mm256_unpacklo_epi64(t4, t6),
+					_mm256_unpackhi_epi64(t4, t6),
+					_mm256_unpacklo_epi64(t5, t7),
+					_mm256_unpackhi_epi64(t5, t7)};
+
+		for (int blockOffset = 0; blockOffset < 4; ++blockOffset){
+			__m256i blockWords[2] = {
+						_mm256_permute2x128_si256(lowWords[blockOffset], highWords[blockOffset], 0x20),
+						_mm256_permute2x128_si256(lowWords[blockOffset], highWords[blockOffset], 0x31)};
+
+			for (int laneIndex = 0; laneIndex < 2; ++laneIndex){
+				int byteOffset = (blockOffset + laneIndex * 4) * CChaChaEncoder::BLOCK_SIZE + wordIndex * 4;
+
+				__m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dataPtr + byteOffset));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(resultPtr + byteOffset), _mm256_xor_si256(data, blockWords[laneIndex]));
+			}
+		}
+	}
+}
+
+
+static const bool s_isAvx2Supported = IsAvx2Supported();
+
+#endif // ACF_CHACHA_AVX2
+
+
+} // namespace
+
+
+// public methods
+
+CChaChaEncoder::CChaChaEncoder()
+:	m_cacheBlockIndex(0),
+	m_isCacheValid(false)
+{
+	// "expand 32-byte k"
+	m_state[0] = 0x61707865;
+	m_state[1] = 0x3320646e;
+	m_state[2] = 0x79622d32;
+	m_state[3] = 0x6b206574;
+
+	SetKey(s_defaultKey);
+
+	quint8 nonce[NONCE_SIZE] = {0};
+	SetNonce(nonce);
+
+	m_state[12] = 0;
+	m_state[13] = 0;
+}
+
+
+void CChaChaEncoder::SetKey(const quint8* keyPtr)
+{
+	for (int i = 0; i < 8; ++i){
+		m_state[4 + i] = ReadWord(keyPtr + i * 4);
+	}
+
+	m_isCacheValid = false;
+}
+
+
+void CChaChaEncoder::SetNonce(const quint8* noncePtr)
+{
+	m_state[14] = ReadWord(noncePtr);
+	m_state[15] = ReadWord(noncePtr + 4);
+
+	m_isCacheValid = false;
+}
+
+
+void CChaChaEncoder::Process(const quint8* dataPtr, quint8* resultPtr, qint64 size, quint64 streamPosition) const
+{
+	if (size <= 0){
+		return;
+	}
+
+	quint64 blockIndex = streamPosition / BLOCK_SIZE;
+	int blockOffset = int(streamPosition % BLOCK_SIZE);
+
+	quint8 keyStream[BLOCK_SIZE];
+
+	// begin of the data inside of a block
+	if (blockOffset != 0){
+		CalculateKeyStreamBlock(blockIndex, keyStream);
+
+		int partSize = int(qMin(qint64(BLOCK_SIZE - blockOffset), size));
+		for (int i = 0; i < partSize; ++i){
+			resultPtr[i] = dataPtr[i] ^ keyStream[blockOffset + i];
+		}
+
+		dataPtr += partSize;
+		resultPtr += partSize;
+		size -= partSize;
+		++blockIndex;
+	}
+
+	qint64 blocksCount = size / BLOCK_SIZE;
+	if (blocksCount > 0){
+		int threadsCount = int(qMin(qint64(QThread::idealThreadCount()), blocksCount / s_minBlocksPerThread));
+		if (threadsCount > 1){
+			qint64 threadBlocksCount = (blocksCount + threadsCount - 1) / threadsCount;
+
+			QVector<QFuture<void> > futures;
+
+			for (qint64 firstBlock = threadBlocksCount; firstBlock < blocksCount; firstBlock += threadBlocksCount){
+				qint64 rangeBlocksCount = qMin(threadBlocksCount, blocksCount - firstBlock);
+				qint64 byteOffset = firstBlock * BLOCK_SIZE;
+				quint64 rangeBlockIndex = blockIndex + quint64(firstBlock);
+
+				futures.push_back(QtConcurrent::run([this, dataPtr, resultPtr, byteOffset, rangeBlocksCount, rangeBlockIndex](){
+					ProcessBlocks(dataPtr + byteOffset, resultPtr + byteOffset, rangeBlocksCount, rangeBlockIndex);
+				}));
+			}
+
+			// the first range is processed by the calling thread
+			ProcessBlocks(dataPtr, resultPtr, threadBlocksCount, blockIndex);
+
+			for (int i = 0; i < futures.size(); ++i){
+				futures[i].waitForFinished();
+			}
+		}
+		else{
+			ProcessBlocks(dataPtr, resultPtr, blocksCount, blockIndex);
+		}
+
+		qint64 processedSize = blocksCount * BLOCK_SIZE;
+
+		dataPtr += processedSize;
+		resultPtr += processedSize;
+		size -= processedSize;
+		blockIndex += quint64(blocksCount);
+	}
+
+	// rest of the data in the last block
+	if (size > 0){
+		CalculateKeyStreamBlock(blockIndex, keyStream);
+
+		for (int i = 0; i < size; ++i){
+			resultPtr[i] = dataPtr[i] ^ keyStream[i];
+		}
+	}
+}
+
+
+void CChaChaEncoder::ProcessCached(const quint8* dataPtr, quint8* resultPtr, qint64 size, quint64 streamPosition)
+{
+	if (size >= CACHE_SIZE / 2){
+		Process(dataPtr, resultPtr, size, streamPosition);
+
+		return;
+	}
+
+	while (size > 0){
+		quint64 blockIndex = streamPosition / BLOCK_SIZE;
+
+		if (!m_isCacheValid || (blockIndex < m_cacheBlockIndex) || (blockIndex >= m_cacheBlockIndex + CACHE_BLOCKS_COUNT)){
+			std::memset(m_keyStreamCache, 0, sizeof(m_keyStreamCache));
+
+			ProcessBlocks(m_keyStreamCache, m_keyStreamCache, CACHE_BLOCKS_COUNT, blockIndex);
+
+			m_cacheBlockIndex = blockIndex;
+			m_isCacheValid = true;
+		}
+
+		int cacheOffset = int(streamPosition - m_cacheBlockIndex * BLOCK_SIZE);
+		int partSize = int(qMin(qint64(CACHE_SIZE - cacheOffset), size));
+
+		const quint8* keyStreamPtr = m_keyStreamCache + cacheOffset;
+		for (int i = 0; i < partSize; ++i){
+			resultPtr[i] = dataPtr[i] ^ keyStreamPtr[i];
+		}
+
+		dataPtr += partSize;
+		resultPtr += partSize;
+		size -= partSize;
+		streamPosition += quint64(partSize);
+	}
+}
+
+
+// protected methods
+
+void CChaChaEncoder::ProcessBlocks(const quint8* dataPtr, quint8* resultPtr, qint64 blocksCount, quint64 blockIndex) const
+{
+#if defined(ACF_CHACHA_AVX2)
+	if (s_isAvx2Supported){
+		while (blocksCount >= 8){
+			ProcessEightBlocks(m_state, blockIndex, dataPtr, resultPtr);
+
+			dataPtr += 8 * BLOCK_SIZE;
+			resultPtr += 8 * BLOCK_SIZE;
+			blocksCount -= 8;
+			blockIndex += 8;
+		}
+	}
+#endif
+
+#if defined(ACF_CHACHA_SSE2)
+	while (blocksCount >= 4){
+		ProcessFourBlocks(m_state, blockIndex, dataPtr, resultPtr);
+
+		dataPtr += 4 * BLOCK_SIZE;
+		resultPtr += 4 * BLOCK_SIZE;
+		blocksCount -= 4;
+		blockIndex += 4;
+	}
+#endif
+
+	quint8 keyStream[BLOCK_SIZE];
+
+	for (qint64 i = 0; i < blocksCount; ++i){
+		CalculateKeyStreamBlock(blockIndex, keyStream);
+
+		for (int byteIndex = 0; byteIndex < BLOCK_SIZE; ++byteIndex){
+			resultPtr[byteIndex] = dataPtr[byteIndex] ^ keyStream[byteIndex];
+		}
+
+		dataPtr += BLOCK_SIZE;
+		resultPtr += BLOCK_SIZE;
+		++blockIndex;
+	}
+}
+
+
+void CChaChaEncoder::CalculateKeyStreamBlock(quint64 blockIndex, quint8* keyStreamPtr) const
+{
+	quint32 initial[16];
+	std::memcpy(initial, m_state, sizeof(initial));
+
+	initial[12] = quint32(blockIndex);
+	initial[13] = quint32(blockIndex >> 32);
+
+	quint32 x[16];
+	std::memcpy(x, initial, sizeof(x));
+
+	for (int i = 0; i < 10; ++i){
+		QuarterRound(x, 0, 4, 8, 12);
+		QuarterRound(x, 1, 5, 9, 13);
+		QuarterRound(x, 2, 6, 10, 14);
+		QuarterRound(x, 3, 7, 11, 15);
+		QuarterRound(x, 0, 5, 10, 15);
+		QuarterRound(x, 1, 6, 11, 12);
+		QuarterRound(x, 2, 7, 8, 13);
+		QuarterRound(x, 3, 4, 9, 14);
+	}
+
+	for (int i = 0; i < 16; ++i){
+		quint32 value = x[i] + initial[i];
+
+		keyStreamPtr[i * 4] = quint8(value);
+		keyStreamPtr[i * 4 + 1] = quint8(value >> 8);
+		keyStreamPtr[i * 4 + 2] = quint8(value >> 16);
+		keyStreamPtr[i * 4 + 3] = quint8(value >> 24);
+	}
+}
+
+
+} // namespace ifile
+
+
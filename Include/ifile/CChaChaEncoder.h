@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// ACF includes
+#include <ifile/ifile.h>
+
+
+namespace ifile
+{
+
+
+/**
+	Stream encoder based on ChaCha20 cipher (D. J. Bernstein) with 64-bit block counter and 64-bit nonce.
+
+	The key stream is addressed by the stream position, so each part of the data can be encoded independently.
+	Encoding and decoding are the same operation.
+	On x86 processors eight key stream blocks are calculated at once using AVX2, if the processor supports it,
+	otherwise four blocks are calculated at once using SSE2. The remaining blocks are calculated one by one.
+	Large data blocks are processed by multiple threads.
+*/
+class CChaChaEncoder
+{
+public:
+	enum
+	{
+		KEY_SIZE = 32,
+		NONCE_SIZE = 8,
+		BLOCK_SIZE = 64
+	};
+
+	/**
+		Construct encoder using built-in key and zero nonce.
+	*/
+	CChaChaEncoder();
+
+	/**
+		Set key used by the encoder.
+		\param	keyPtr	pointer to \c KEY_SIZE bytes of the key.
+	*/
+	void SetKey(const quint8* keyPtr);
+
+	/**
+		Set nonce used by the encoder.
+		\param	noncePtr	pointer to \c NONCE_SIZE bytes of the nonce.
+	*/
+	void SetNonce(const quint8* noncePtr);
+
+	/**
+		Encode or decode data block.
+		\param	dataPtr			input data.
+		\param	resultPtr		output data, it can be the same as input data.
+		\param	size			size of data in bytes.
+		\param	streamPosition	position of the first data byte in the key stream.
+	*/
+	void Process(const quint8* dataPtr, quint8* resultPtr, qint64 size, quint64 streamPosition) const;
+
+	/**
+		Encode or decode data block using cached key stream.
+		It is intended for many small data blocks at near positions, e.g. serialization of single values.
+		Unlike \c Process this method is not thread-safe.
+	*/
+	void ProcessCached(const quint8* dataPtr, quint8* resultPtr, qint64 size, quint64 streamPosition);
+
+protected:
+	/**
+		Encode or decode whole blocks beginning at given block index using a single thread.
+	*/
+	void ProcessBlocks(const quint8* dataPtr, quint8* resultPtr, qint64 blocksCount, quint64 blockIndex) const;
+
+	/**
+		Calculate single key stream block.
+	*/
+	void CalculateKeyStreamBlock(quint64 blockIndex, quint8* keyStreamPtr) const;
+
+private:
+	enum
+	{
+		CACHE_BLOCKS_COUNT = 64,
+		CACHE_SIZE = CACHE_BLOCKS_COUNT * BLOCK_SIZE
+	};
+
+	quint32 m_state[16];
+
+	quint8 m_keyStreamCache[CACHE_SIZE];
+	quint64 m_cacheBlockIndex;
+	bool m_isCacheValid;
+};
+
+
+} // namespace ifile
+
+
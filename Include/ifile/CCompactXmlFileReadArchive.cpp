@@ -2,13 +2,6 @@
 #include <ifile/CCompactXmlFileReadArchive.h>
 
 
-// include STL
-#include <cstring>
-
-// Qt includes
-#include <QtCore/QFile>
-#include <QtXml/QDomNodeList>
-
 
 namespace ifile
 {
@@ -31,13 +24,15 @@ bool CCompactXmlFileReadArchive::OpenFile(const QString& filePath)
 {
 	m_openFileName = filePath;
 
-	QFile file(filePath);
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)){
+	// the file is read on demand, it must be kept opened
+	m_file.close();
+	m_file.setFileName(filePath);
+	if (!m_file.open(QIODevice::ReadOnly | QIODevice::Text)){
 		if (IsLogConsumed()){
 			SendLogMessage(
 						istd::IInformationProvider::IC_ERROR,
 						MI_FILE_OPEN_ERROR,
-						QString("Cannot open file: %1").arg(file.errorString()),
+						QString("Cannot open file: %1").arg(m_file.errorString()),
 						"CompactXmlReader",
 						istd::IInformationProvider::ITF_SYSTEM);
 		}
@@ -47,8 +42,8 @@ bool CCompactXmlFileReadArchive::OpenFile(const QString& filePath)
 		return false;
 	}
 
-	if (!BaseClass::SetContent(&file)){
-		file.close();
+	if (!BaseClass::SetContent(&m_file)){
+		m_file.close();
 		m_openFileName = "";
 
 		return false;
@@ -77,7 +72,7 @@ void CCompactXmlFileReadArchive::DecorateMessage(
 {
 	BaseClass::DecorateMessage(category, id, flags, message, messageSource);
 
-	int lineNumber = m_currentParent.lineNumber();
+	int lineNumber = GetCurrentLineNumber();
 	if (lineNumber >= 0){
 		message = QObject::tr("%2(%3) : %1").arg(message).arg(m_openFileName).arg(lineNumber);
 	}
@@ -3,8 +3,7 @@
 
 
 // Qt includes
-#include <QtXml/QDomDocument>
-#include <QtXml/QDomNode>
+#include <QtCore/QFile>
 
 // ACF includes
 #include <iser/CCompactXmlReadArchiveBase.h>
@@ -58,6 +57,7 @@ protected:
 
 private:
 	QString m_openFileName;
+	QFile m_file;
 };
 
 
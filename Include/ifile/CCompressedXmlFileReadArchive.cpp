@@ -2,12 +2,8 @@
 #include <ifile/CCompressedXmlFileReadArchive.h>
 
 
-// include STL
-#include <cstring>
-
 // Qt includes
 #include <QtCore/QFile>
-#include <QtXml/QDomNodeList>
 
 
 namespace ifile
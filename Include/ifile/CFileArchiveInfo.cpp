@@ -2,6 +2,10 @@
 #include <ifile/CFileArchiveInfo.h>
 
 
+// STL includes
+#include <climits>
+
+
 namespace ifile
 {
 
@@ -20,6 +24,70 @@ const QString& CFileArchiveInfo::GetCurrentFilePath() const
 }
 
 
+// protected static methods
+
+bool CFileArchiveInfo::IsSkipIndexTrailerValid(const SkipIndexTrailer& trailer, qint64 dataPosition, qint64 trailerPosition)
+{
+	if ((trailer.magic != SKIP_INDEX_MAGIC) || (dataPosition < 0) || (trailerPosition < dataPosition)){
+		return false;
+	}
+
+	if ((trailer.indexPosition < quint64(dataPosition)) || (trailer.indexPosition > quint64(trailerPosition))){
+		return false;
+	}
+
+	if (trailer.entriesCount > quint32(INT_MAX / int(sizeof(SkipIndexEntry)))){
+		return false;
+	}
+
+	return (quint64(trailerPosition) - trailer.indexPosition == quint64(trailer.entriesCount) * sizeof(SkipIndexEntry));
+}
+
+
+bool CFileArchiveInfo::IsSkipIndexEntryValid(const SkipIndexEntry& entry, const SkipIndexTrailer& trailer)
+{
+	// all end positions must be placed in the archive data
+	return (entry.endPosition <= trailer.indexPosition) && (entry.nextTagIndex <= trailer.entriesCount);
+}
+
+
+bool CFileArchiveInfo::IsBlockIndexTrailerValid(const BlockIndexTrailer& trailer, qint64 trailerPosition)
+{
+	if ((trailer.magic != BLOCK_INDEX_MAGIC) || (trailer.blockSize == 0) || (trailerPosition < 0)){
+		return false;
+	}
+
+	if ((trailer.blocksCount > quint32(INT_MAX / int(sizeof(BlockIndexEntry)))) || (trailer.skipEntriesCount > quint32(INT_MAX / int(sizeof(SkipIndexEntry))))){
+		return false;
+	}
+
+	// all blocks except of the last one are full
+	quint64 blocksCount = (trailer.dataSize + trailer.blockSize - 1) / trailer.blockSize;
+	if (blocksCount != trailer.blocksCount){
+		return false;
+	}
+
+	quint64 indexSize = quint64(trailer.blocksCount) * sizeof(BlockIndexEntry) + quint64(trailer.skipEntriesCount) * sizeof(SkipIndexEntry);
+
+	return (trailer.blockIndexPosition <= quint64(trailerPosition)) && (quint64(trailerPosition) - trailer.blockIndexPosition == indexSize);
+}
+
+
+bool CFileArchiveInfo::IsBlockIndexEntryValid(const BlockIndexEntry& entry, int blockIndex, const BlockIndexTrailer& trailer)
+{
+	quint64 blockBegin = quint64(blockIndex) * trailer.blockSize;
+	if (blockBegin >= trailer.dataSize){
+		return false;
+	}
+
+	quint64 expectedSize = qMin(quint64(trailer.blockSize), trailer.dataSize - blockBegin);
+
+	return	(entry.uncompressedSize == expectedSize) &&
+			(entry.position <= trailer.blockIndexPosition) &&
+			(trailer.blockIndexPosition - entry.position >= entry.compressedSize);
+}
+
+
 } // namespace ifile
 
 
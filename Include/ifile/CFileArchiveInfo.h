@@ -18,12 +18,139 @@ namespace ifile
 class CFileArchiveInfo: virtual public IFileArchiveInfo
 {
 public:
+	/**
+		Encoding of the secure file archives.
+		The encoding is stored in the archive header using the reserved version ID \c iser::IVersionInfo::SecureFormatVersionId.
+	*/
+	enum SecureFormat
+	{
+		/**
+			Data encoded using ifile::CSimpleEncoder, the files have no secure header and no format entry in the archive header.
+			This format can be read also by older versions.
+		*/
+		SF_SIMPLE = 0,
+		/**
+			Data encoded using ifile::CChaChaEncoder, the nonce is stored in the secure header.
+		*/
+		SF_CHACHA20 = 1
+	};
+
 	explicit CFileArchiveInfo(const QString& filePath);
 
 	// reimplemented (ifile::IFileArchiveInfo)
 	virtual const QString& GetCurrentFilePath() const override;
 
 protected:
+	enum
+	{
+		/**
+			Magic number closing the skip index of binary file archives.
+		*/
+		SKIP_INDEX_MAGIC = 0x4653414b,
+		/**
+			Magic number closing the block index of block compressed archives.
+		*/
+		BLOCK_INDEX_MAGIC = 0x4253414b,
+		/**
+			Magic number opening the header of secure archives.
+		*/
+		SECURE_HEADER_MAGIC = 0x5353414b
+	};
+
+	/**
+		Header of secure archives, it follows the archive header and it is not encoded.
+	*/
+	struct SecureHeader
+	{
+		quint32 magic;
+		/**
+			Encoding of the data, one of \c SecureFormat values.
+		*/
+		quint32 format;
+		quint8 nonce[8];
+	};
+
+	/**
+		Entry of the skip index of binary file archives.
+		There is one entry for each skippable tag, in order of the tag begins.
+	*/
+	struct SkipIndexEntry
+	{
+		/**
+			Position of the tag end in the file.
+		*/
+		quint64 endPosition;
+		quint32 tagBinaryId;
+		/**
+			Index of the first skippable tag following the tag end.
+		*/
+		quint32 nextTagIndex;
+	};
+
+	/**
+		Trailer stored at the end of binary file archives, it follows directly the skip index entries.
+	*/
+	struct SkipIndexTrailer
+	{
+		quint64 indexPosition;
+		quint32 entriesCount;
+		quint32 magic;
+	};
+
+	/**
+		Entry of the block index of block compressed archives.
+		The uncompressed archive data is split into blocks of the same size, only the last block can be smaller.
+	*/
+	struct BlockIndexEntry
+	{
+		/**
+			Position of the compressed block in the file.
+		*/
+		quint64 position;
+		quint32 compressedSize;
+		quint32 uncompressedSize;
+	};
+
+	/**
+		Trailer stored at the end of block compressed archives.
+		It follows the block index entries and the skip index entries, the end positions in the skip index are related to the uncompressed data.
+	*/
+	struct BlockIndexTrailer
+	{
+		quint64 blockIndexPosition;
+		/**
+			Size of the uncompressed archive data.
+		*/
+		quint64 dataSize;
+		quint32 blocksCount;
+		quint32 blockSize;
+		quint32 skipEntriesCount;
+		quint32 magic;
+	};
+
+	/**
+		Check if the skip index trailer is consistent with the file layout.
+		\param	dataPosition		position of the archive data begin.
+		\param	trailerPosition		position of the trailer in the file.
+	*/
+	static bool IsSkipIndexTrailerValid(const SkipIndexTrailer& trailer, qint64 dataPosition, qint64 trailerPosition);
+
+	/**
+		Check if the skip index entry refers to the archive data.
+	*/
+	static bool IsSkipIndexEntryValid(const SkipIndexEntry& entry, const SkipIndexTrailer& trailer);
+
+	/**
+		Check if the block index trailer is consistent with the file layout.
+		\param	trailerPosition		position of the trailer in the file.
+	*/
+	static bool IsBlockIndexTrailerValid(const BlockIndexTrailer& trailer, qint64 trailerPosition);
+
+	/**
+		Check if the block index entry refers to the compressed data and it has the expected size.
+	*/
+	static bool IsBlockIndexEntryValid(const BlockIndexEntry& entry, int blockIndex, const BlockIndexTrailer& trailer);
+
 	QString m_filePath;
 };
 
@@ -2,6 +2,9 @@
 #include <ifile/CFileReadArchive.h>
 
 
+// STL includes
+#include <climits>
+
 // Qt includes
 #include <QtCore/QString>
 
@@ -16,10 +19,18 @@ namespace ifile
 
 CFileReadArchive::CFileReadArchive(const QString& filePath, bool supportTagSkipping, bool serializeHeader)
 :	BaseClass2(filePath),
-	m_supportTagSkipping(supportTagSkipping)
+	m_supportTagSkipping(supportTagSkipping),
+	m_isSkipIndexUsed(false),
+	m_nextTagIndex(0)
 {
-	if (!filePath.isEmpty() && OpenFile(filePath) && serializeHeader){
-		SerializeAcfHeader();
+	if (!filePath.isEmpty() && OpenFile(filePath)){
+		if (serializeHeader){
+			SerializeAcfHeader();
+		}
+
+		if (m_supportTagSkipping && (!serializeHeader || (GetArchiveFormatVersion() >= iser::CArchiveHeaderInfo::AFV_SKIP_INDEX))){
+			LoadSkipIndex();
+		}
 	}
 }
 
@@ -30,6 +41,11 @@ bool CFileReadArchive::OpenFile(const QString& filePath)
 		m_file.close();
 	}
 
+	m_tagStack.clear();
+	m_skipIndex.clear();
+	m_isSkipIndexUsed = false;
+	m_nextTagIndex = 0;
+
 	m_filePath = filePath;
 	m_file.setFileName(filePath);
 	if (!m_file.open(QIODevice::ReadOnly)){
@@ -49,6 +65,18 @@ bool CFileReadArchive::OpenFile(const QString& filePath)
 }
 
 
+qint64 CFileReadArchive::GetFilePosition() const
+{
+	return m_file.pos();
+}
+
+
+bool CFileReadArchive::SetFilePosition(qint64 position)
+{
+	return m_file.seek(position);
+}
+
+
 bool CFileReadArchive::IsOpen() const
 {
 	return m_file.isOpen();
@@ -76,6 +104,12 @@ bool CFileReadArchive::BeginTag(const iser::CArchiveTag& tag)
 
 	retVal = retVal && Process(element.endPosition);
 	element.useTagSkipping = tag.IsTagSkippingUsed() && m_supportTagSkipping;
+	element.skipIndex = 0;
+
+	// skippable tags are numbered in the same order as by writing
+	if (element.useTagSkipping){
+		element.skipIndex = m_nextTagIndex++;
+	}
 
 	return retVal;
 }
@@ -93,8 +127,26 @@ bool CFileReadArchive::EndTag(const iser::CArchiveTag& tag)
 		return false;
 	}
 
-	if (element.useTagSkipping && (element.endPosition != 0)){
-		retVal = retVal && m_file.seek(element.endPosition);
+	if (element.useTagSkipping){
+		qint64 endPosition = element.endPosition;
+
+		if (m_isSkipIndexUsed){
+			if ((element.skipIndex < quint32(m_skipIndex.size())) && (m_skipIndex[int(element.skipIndex)].tagBinaryId == element.tagBinaryId)){
+				const SkipIndexEntry& entry = m_skipIndex[int(element.skipIndex)];
+
+				endPosition = qint64(entry.endPosition);
+				m_nextTagIndex = entry.nextTagIndex;
+			}
+			else{
+				// the tags don't correspond to the index, skipping is not possible anymore
+				m_isSkipIndexUsed = false;
+			}
+		}
+
+		// seek only if the tag was not read completely, seeking discards the read buffer
+		if ((endPosition != 0) && (endPosition != m_file.pos())){
+			retVal = retVal && m_file.seek(endPosition);
+		}
 	}
 
 	m_tagStack.pop_back();
@@ -150,7 +202,48 @@ void CFileReadArchive::DecorateMessage(
 
 int CFileReadArchive::GetMaxStringLength() const
 {
-	return int(m_file.size() - m_file.pos());
+	return int(qMin(m_file.size() - m_file.pos(), qint64(INT_MAX)));
+}
+
+
+// private methods
+
+bool CFileReadArchive::LoadSkipIndex()
+{
+	m_skipIndex.clear();
+	m_isSkipIndexUsed = false;
+
+	qint64 dataPosition = m_file.pos();
+	qint64 trailerPosition = m_file.size() - qint64(sizeof(SkipIndexTrailer));
+	if (trailerPosition < dataPosition){
+		return false;
+	}
+
+	SkipIndexTrailer trailer;
+	bool retVal = m_file.seek(trailerPosition);
+	retVal = retVal && (m_file.read(reinterpret_cast<char*>(&trailer), qint64(sizeof(trailer))) == qint64(sizeof(trailer)));
+	retVal = retVal && IsSkipIndexTrailerValid(trailer, dataPosition, trailerPosition);
+
+	if (retVal && (trailer.entriesCount > 0)){
+		m_skipIndex.resize(int(trailer.entriesCount));
+
+		qint64 indexSize = qint64(trailer.entriesCount) * qint64(sizeof(SkipIndexEntry));
+
+		retVal = m_file.seek(qint64(trailer.indexPosition));
+		retVal = retVal && (m_file.read(reinterpret_cast<char*>(m_skipIndex.data()), indexSize) == indexSize);
+	}
+
+	for (int i = 0; retVal && (i < m_skipIndex.size()); ++i){
+		retVal = IsSkipIndexEntryValid(m_skipIndex[i], trailer);
+	}
+
+	if (!retVal){
+		m_skipIndex.clear();
+	}
+
+	m_isSkipIndexUsed = retVal;
+
+	return m_file.seek(dataPosition) && retVal;
 }
 
 
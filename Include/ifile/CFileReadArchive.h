@@ -19,6 +19,11 @@ namespace ifile
 	Simple implementation of archive reading from own ACF format binary file.
 	This imlementation is very fast and efficient and should be used if any standardized file format is needed.
 
+	Both archive formats are supported, the format is detected using the archive header.
+	For files of \c iser::CArchiveHeaderInfo::AFV_SKIP_INDEX format the skip index is loaded on opening,
+	so the rest of a skippable tag is skipped by a single seek, if it was not read completely.
+	Files written without header are checked for the skip index directly.
+
 	\ingroup Persistence
 */
 class CFileReadArchive:
@@ -58,11 +63,28 @@ public:
 protected:
 	bool OpenFile(const QString& filePath);
 
+	/**
+		Get current position in the file.
+	*/
+	qint64 GetFilePosition() const;
+
+	/**
+		Set current position in the file.
+	*/
+	bool SetFilePosition(qint64 position);
+
 	struct TagStackElement
 	{
 		quint32 tagBinaryId;
+		/**
+			End position of the tag stored in the classic format, or 0.
+		*/
 		quint32 endPosition;
 		bool useTagSkipping;
+		/**
+			Index of the tag in the skip index.
+		*/
+		quint32 skipIndex;
 	};
 
 	// reimplemented (istd::ILogger)
@@ -77,6 +99,12 @@ protected:
 	virtual int GetMaxStringLength() const override;
 
 private:
+	/**
+		Load skip index from the end of the file, current file position will be kept.
+		\return	true, if the skip index was found.
+	*/
+	bool LoadSkipIndex();
+
 	QFile m_file;
 
 	bool m_supportTagSkipping;
@@ -84,6 +112,12 @@ private:
 	typedef QVector<TagStackElement> TagStack;
 
 	TagStack m_tagStack;
+
+	typedef QVector<SkipIndexEntry> SkipIndex;
+
+	SkipIndex m_skipIndex;
+	bool m_isSkipIndexUsed;
+	quint32 m_nextTagIndex;
 };
 
 
@@ -10,8 +10,35 @@ CFileReadSecureArchive::CFileReadSecureArchive(
 			const QString& filePath,
 			bool supportTagSkipping,
 			bool serializeHeader)
-	:BaseClass(filePath, supportTagSkipping, serializeHeader)
+	:BaseClass(filePath, supportTagSkipping, serializeHeader),
+	m_secureFormat(SF_SIMPLE),
+	m_isFormatSupported(true)
 {
+	if (IsOpen()){
+		if (serializeHeader){
+			// the format is recorded in the archive header, archives without this entry have the simple format
+			quint32 formatNumber = SF_SIMPLE;
+			if (GetVersionInfo().GetVersionNumber(iser::IVersionInfo::SecureFormatVersionId, formatNumber) && (formatNumber != SF_SIMPLE)){
+				if (!ReadSecureHeader() || (quint32(m_secureFormat) != formatNumber)){
+					m_isFormatSupported = false;
+				}
+			}
+		}
+		else{
+			qint64 dataPosition = GetFilePosition();
+
+			// without the archive header the format can be recognized by the secure header only
+			if (!ReadSecureHeader()){
+				SetFilePosition(dataPosition);
+			}
+		}
+	}
+}
+
+
+CFileArchiveInfo::SecureFormat CFileReadSecureArchive::GetSecureFormat() const
+{
+	return m_secureFormat;
 }
 
 
@@ -23,11 +50,48 @@ bool CFileReadSecureArchive::ProcessData(void* data, int size)
 		return true;
 	}
 
+	if (!m_isFormatSupported){
+		return false;
+	}
+
 	quint8* dataPtr = (quint8*)data;
 
-	QVector<quint8> buffer(size);
+	qint64 position = GetFilePosition();
+
+	if (!BaseClass::ProcessData(dataPtr, size)){
+		return false;
+	}
+
+	if (m_secureFormat == SF_CHACHA20){
+		m_encoder.ProcessCached(dataPtr, dataPtr, size, quint64(position));
+
+		return true;
+	}
+
+	return Decode(dataPtr, dataPtr, size);
+}
+
+
+// private methods
+
+bool CFileReadSecureArchive::ReadSecureHeader()
+{
+	SecureHeader header;
+	if (!BaseClass::ProcessData(&header, int(sizeof(header))) || (header.magic != SECURE_HEADER_MAGIC)){
+		return false;
+	}
+
+	if (header.format == SF_CHACHA20){
+		m_secureFormat = SF_CHACHA20;
+
+		m_encoder.SetNonce(header.nonce);
+	}
+	else{
+		// unknown format of newer version
+		m_isFormatSupported = false;
+	}
 
-	return BaseClass::ProcessData(&buffer[0], size) && Decode(&buffer[0], dataPtr, size);
+	return true;
 }
 
 
@@ -7,12 +7,21 @@
 
 // QSF includes
 #include <ifile/CSimpleEncoder.h>
+#include <ifile/CChaChaEncoder.h>
 
 
 namespace ifile
 {
 
 
+/**
+	Binary file archive decoding the read data.
+
+	The encoding is taken from the archive header (\c iser::IVersionInfo::SecureFormatVersionId entry),
+	archives without this entry are decoded using ifile::CSimpleEncoder.
+	Files written without the archive header are checked for the secure header directly.
+	\sa CFileWriteSecureArchive
+*/
 class CFileReadSecureArchive:
 			public ifile::CFileReadArchive,
 			protected CSimpleEncoder
@@ -25,8 +34,27 @@ public:
 				bool supportTagSkipping = true,
 				bool serializeHeader = true);
 
+	/**
+		Get encoding of the archive data.
+	*/
+	SecureFormat GetSecureFormat() const;
+
 	// reimplemented (ifile::CFileReadArchive)
 	virtual bool ProcessData(void* data, int size) override;
+
+private:
+	/**
+		Read the secure header following the archive header and set the format according to it.
+		\return	true, if the header was found.
+	*/
+	bool ReadSecureHeader();
+
+	SecureFormat m_secureFormat;
+	/**
+		It is false if the data encoding is unknown or the secure header is damaged, no data can be read then.
+	*/
+	bool m_isFormatSupported;
+	CChaChaEncoder m_encoder;
 };
 
 
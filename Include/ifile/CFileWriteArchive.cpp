@@ -5,6 +5,9 @@
 // Qt includes
 #include <QtCore/QString>
 
+// ACF includes
+#include <iser/CArchiveTag.h>
+
 
 namespace ifile
 {
@@ -19,19 +22,62 @@ CFileWriteArchive::CFileWriteArchive(
 	BaseClass2(filePath),
 	m_file(filePath),
 	m_supportTagSkipping(supportTagSkipping),
-	m_isValid(false)
+	m_isValid(false),
+	m_isClosed(false)
 {
 	m_isValid = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
 
 	if (serializeHeader){
-		SerializeAcfHeader();
+		SerializeAcfHeader(m_supportTagSkipping? iser::CArchiveHeaderInfo::AFV_SKIP_INDEX: iser::CArchiveHeaderInfo::AFV_CLASSIC);
 	}
 }
 
 
-void CFileWriteArchive::Flush()
+CFileWriteArchive::~CFileWriteArchive()
 {
-	m_file.flush();
+	Close();
+}
+
+
+bool CFileWriteArchive::Flush()
+{
+	if (!m_isValid || m_isClosed){
+		return false;
+	}
+
+	if (!m_file.flush()){
+		SendWriteErrorMessage();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+bool CFileWriteArchive::Close()
+{
+	if (m_isClosed){
+		return m_isValid;
+	}
+
+	m_isClosed = true;
+
+	if (!m_isValid){
+		return false;
+	}
+
+	bool retVal = !m_supportTagSkipping || WriteSkipIndex();
+
+	// the buffered data are written on closing, all write errors are kept in the file error state
+	m_file.close();
+
+	m_isValid = retVal && (m_file.error() == QFile::NoError);
+	if (!m_isValid){
+		SendWriteErrorMessage();
+	}
+
+	return m_isValid;
 }
 
 
@@ -45,7 +91,7 @@ bool CFileWriteArchive::IsTagSkippingSupported() const
 
 bool CFileWriteArchive::BeginTag(const iser::CArchiveTag& tag)
 {
-	bool retVal = m_isValid && BaseClass::BeginTag(tag);
+	bool retVal = m_isValid && !m_isClosed && BaseClass::BeginTag(tag);
 
 	if (!retVal){
 		return false;
@@ -55,10 +101,20 @@ bool CFileWriteArchive::BeginTag(const iser::CArchiveTag& tag)
 	TagStackElement& element = m_tagStack.back();
 
 	element.tagBinaryId = tag.GetBinaryId();
-	element.endFieldPosition = (tag.IsTagSkippingUsed() && m_supportTagSkipping)?
-				quint32(m_file.pos()):
-				quint32(0);
+	element.skipIndex = -1;
+
+	if (tag.IsTagSkippingUsed() && m_supportTagSkipping){
+		element.skipIndex = m_skipIndex.size();
+
+		SkipIndexEntry entry;
+		entry.endPosition = 0;
+		entry.tagBinaryId = element.tagBinaryId;
+		entry.nextTagIndex = 0;
 
+		m_skipIndex.push_back(entry);
+	}
+
+	// the end position is stored in the skip index, this field is kept for compatibility with the classic format
 	quint32 dummyPos = 0;
 	retVal = retVal && Process(dummyPos);
 
@@ -78,14 +134,11 @@ bool CFileWriteArchive::EndTag(const iser::CArchiveTag& tag)
 		return false;
 	}
 
-	if (element.endFieldPosition != 0){	// add position of the file tag end to the tag begin
-		quint32 endPosition = m_file.pos();
-
-		retVal = retVal && m_file.seek(element.endFieldPosition);
+	if (element.skipIndex >= 0){
+		SkipIndexEntry& entry = m_skipIndex[element.skipIndex];
 
-		retVal = retVal && Process(endPosition);
-
-		retVal = retVal && m_file.seek(endPosition);
+		entry.endPosition = quint64(m_file.pos());
+		entry.nextTagIndex = quint32(m_skipIndex.size());
 	}
 
 	m_tagStack.pop_back();
@@ -100,8 +153,8 @@ bool CFileWriteArchive::ProcessData(void* data, int size)
 		return true; // Nothing to write, not an error
 	}
 
-	if (data == nullptr) {
-		return false; // Invalid data pointer
+	if ((data == nullptr) || m_isClosed) {
+		return false; // Invalid data pointer or closed file
 	}
 
 	const char* buffer = static_cast<const char*>(data);
@@ -120,6 +173,45 @@ bool CFileWriteArchive::ProcessData(void* data, int size)
 }
 
 
+// protected methods
+
+qint64 CFileWriteArchive::GetFilePosition() const
+{
+	return m_file.pos();
+}
+
+
+// private methods
+
+bool CFileWriteArchive::WriteSkipIndex()
+{
+	SkipIndexTrailer trailer;
+	trailer.indexPosition = quint64(m_file.pos());
+	trailer.entriesCount = quint32(m_skipIndex.size());
+	trailer.magic = SKIP_INDEX_MAGIC;
+
+	// the index is written directly to the file, it is not part of the archive data
+	qint64 indexSize = qint64(m_skipIndex.size()) * qint64(sizeof(SkipIndexEntry));
+	if ((indexSize > 0) && (m_file.write(reinterpret_cast<const char*>(m_skipIndex.constData()), indexSize) != indexSize)){
+		return false;
+	}
+
+	return (m_file.write(reinterpret_cast<const char*>(&trailer), qint64(sizeof(trailer))) == qint64(sizeof(trailer)));
+}
+
+
+void CFileWriteArchive::SendWriteErrorMessage()
+{
+	if (IsLogConsumed()){
+		SendLogMessage(
+					istd::IInformationProvider::IC_ERROR,
+					MI_FILE_WRITE_ERROR,
+					QString("Cannot write file: %1").arg(m_file.errorString()),
+					"BinaryWriter",
+					istd::IInformationProvider::ITF_SYSTEM);
+	}
+}
+
 
 } // namespace ifile
 
@@ -19,6 +19,11 @@ namespace ifile
 	Simple implementation of archive writing to own ACF format binary file.
 	This imlementation is very fast and efficient and should be used if any standarized file format is needed.
 
+	If tag skipping is supported, the end positions of skippable tags are collected during writing
+	and stored as 64-bit offsets in a skip index at the end of the file (\c iser::CArchiveHeaderInfo::AFV_SKIP_INDEX format).
+	The file is written strictly sequentially, the skip index is written by \c Close().
+	It is called on archive destruction, but write errors can be detected only if it is called explicitly.
+
 	\ingroup Persistence
 */
 class CFileWriteArchive:
@@ -26,6 +31,14 @@ class CFileWriteArchive:
 			public CFileArchiveInfo
 {
 public:
+	/**
+		Message IDs generated by this archive.
+	*/
+	enum MessageId
+	{
+		MI_FILE_WRITE_ERROR = 0x3f320c3
+	};
+
 	typedef iser::CBinaryWriteArchiveBase BaseClass;
 	typedef CFileArchiveInfo BaseClass2;
 
@@ -44,6 +57,8 @@ public:
 					bool supportTagSkipping = true,
 					bool serializeHeader = true);
 
+	virtual ~CFileWriteArchive();
+
 	/**
 		Return \c true if the archive is valid (e.g. the file medium can be accessed)
 	*/
@@ -51,8 +66,16 @@ public:
 
 	/**
 		Force internal stream object to flush.
+		\return	true, if all data written so far was passed to the file system.
 	*/
-	void Flush();
+	bool Flush();
+
+	/**
+		Write the skip index and close the file.
+		It is called automatically on archive destruction, no data can be written after closing.
+		\return	true, if the whole archive was successfully written.
+	*/
+	bool Close();
 
 	// reimplemented (iser::IArchive)
 	virtual bool IsTagSkippingSupported() const override;
@@ -61,13 +84,31 @@ public:
 	virtual bool ProcessData(void* data, int size) override;
 
 protected:
+	/**
+		Get current position in the file.
+	*/
+	qint64 GetFilePosition() const;
+
 	struct TagStackElement
 	{
 		quint32 tagBinaryId;
-		quint32 endFieldPosition;
+		/**
+			Index of the tag in the skip index or -1, if the tag is not skippable.
+		*/
+		int skipIndex;
 	};
 	
 private:
+	/**
+		Write skip index and its trailer at the end of the file.
+	*/
+	bool WriteSkipIndex();
+
+	/**
+		Send message about failed writing to the file.
+	*/
+	void SendWriteErrorMessage();
+
 	QFile m_file;
 
 	bool m_supportTagSkipping;
@@ -76,7 +117,12 @@ private:
 
 	TagStack m_tagStack;
 
+	typedef QVector<SkipIndexEntry> SkipIndex;
+
+	SkipIndex m_skipIndex;
+
 	bool m_isValid;
+	bool m_isClosed;
 };
 
 
@@ -2,6 +2,14 @@
 #include <ifile/CFileWriteSecureArchive.h>
 
 
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QUuid>
+
+// ACF includes
+#include <iser/CArchiveHeaderInfo.h>
+
+
 namespace ifile
 {
 
@@ -10,9 +18,23 @@ CFileWriteSecureArchive::CFileWriteSecureArchive(
 			const QString& filePath,
 			const iser::IVersionInfo* versionInfoPtr,
 			bool supportTagSkipping ,
-			bool serializeHeader)
-:	BaseClass(filePath, versionInfoPtr, supportTagSkipping, serializeHeader)
+			bool serializeHeader,
+			SecureFormat secureFormat)
+:	BaseClass(filePath, versionInfoPtr, supportTagSkipping, false),
+	m_secureFormat(secureFormat),
+	m_isEncodingEnabled(false)
+{
+	if (IsArchiveValid()){
+		WriteHeaders(versionInfoPtr, serializeHeader);
+	}
+
+	m_isEncodingEnabled = true;
+}
+
+
+CFileArchiveInfo::SecureFormat CFileWriteSecureArchive::GetSecureFormat() const
 {
+	return m_secureFormat;
 }
 
 
@@ -20,15 +42,79 @@ CFileWriteSecureArchive::CFileWriteSecureArchive(
 
 bool CFileWriteSecureArchive::ProcessData(void* data, int size)
 {
-	if (size == 0){
+	if (size <= 0){
 		return true;
 	}
 
+	if (!m_isEncodingEnabled){
+		return BaseClass::ProcessData(data, size);
+	}
+
 	quint8* dataPtr = (quint8*)data;
 
-	QVector<quint8> buffer(size);
+	if (m_buffer.size() < size){
+		m_buffer.resize(size);
+	}
+
+	quint8* bufferPtr = m_buffer.data();
+
+	if (m_secureFormat == SF_CHACHA20){
+		m_encoder.ProcessCached(dataPtr, bufferPtr, size, quint64(GetFilePosition()));
+
+		return BaseClass::ProcessData(bufferPtr, size);
+	}
+
+	return Encode(dataPtr, bufferPtr, size) && BaseClass::ProcessData(bufferPtr, size);
+}
+
+
+// private methods
+
+bool CFileWriteSecureArchive::WriteHeaders(const iser::IVersionInfo* versionInfoPtr, bool serializeHeader)
+{
+	bool retVal = true;
+
+	if (serializeHeader){
+		// the secure format is added to the version list of the header, a format entry of the given version info is not taken over
+		iser::CArchiveHeaderInfo headerVersionInfo;
+
+		if (versionInfoPtr != NULL){
+			const iser::IVersionInfo::VersionIds ids = versionInfoPtr->GetVersionIds();
+			for (int id : ids){
+				quint32 versionNumber = 0;
+				if ((id != iser::IVersionInfo::SecureFormatVersionId) && versionInfoPtr->GetVersionNumber(id, versionNumber)){
+					headerVersionInfo.InsertVersionId(id, versionNumber, versionInfoPtr->GetVersionIdDescription(id));
+				}
+			}
+		}
+
+		// files of the simple format have the same header as of older versions
+		if (m_secureFormat != SF_SIMPLE){
+			headerVersionInfo.InsertVersionId(iser::IVersionInfo::SecureFormatVersionId, quint32(m_secureFormat), "Secure archive format");
+		}
+
+		quint32 archiveFormatVersion = IsTagSkippingSupported()? iser::CArchiveHeaderInfo::AFV_SKIP_INDEX: iser::CArchiveHeaderInfo::AFV_CLASSIC;
+
+		retVal = iser::CArchiveHeaderInfo::WriteArchiveHeader(*this, &headerVersionInfo, archiveFormatVersion);
+	}
+
+	if (m_secureFormat == SF_CHACHA20){
+		SecureHeader header;
+		header.magic = SECURE_HEADER_MAGIC;
+		header.format = quint32(m_secureFormat);
+
+		// random nonce, each file uses another key stream
+		QByteArray uuid = QUuid::createUuid().toRfc4122();
+		for (int i = 0; i < int(sizeof(header.nonce)); ++i){
+			header.nonce[i] = quint8(uuid[i] ^ uuid[i + int(sizeof(header.nonce))]);
+		}
+
+		m_encoder.SetNonce(header.nonce);
+
+		retVal = retVal && BaseClass::ProcessData(&header, int(sizeof(header)));
+	}
 
-	return Encode(dataPtr, &buffer[0], size) && BaseClass::ProcessData(&buffer[0], size);
+	return retVal;
 }
 
 
@@ -2,17 +2,30 @@
 #pragma once
 
 
+// Qt includes
+#include <QtCore/QVector>
+
 // ACF includes
 #include <ifile/CFileWriteArchive.h>
 
 // QSF includes
 #include <ifile/CSimpleEncoder.h>
+#include <ifile/CChaChaEncoder.h>
 
 
 namespace ifile
 {
 
 
+/**
+	Binary file archive encoding the written data.
+
+	By default the data is encoded using ifile::CSimpleEncoder (\c SF_SIMPLE format), these files are compatible with older versions of this archive.
+	Files of the \c SF_CHACHA20 format are encoded using ChaCha20 key stream addressed by the file position,
+	they can be read by versions supporting this format only.
+	The format is recorded in the not encoded archive header using the reserved version ID \c iser::IVersionInfo::SecureFormatVersionId,
+	the nonce is stored in a not encoded secure header following the archive header.
+*/
 class CFileWriteSecureArchive:
 			public ifile::CFileWriteArchive,
 			protected ifile::CSimpleEncoder
@@ -24,10 +37,28 @@ public:
 				const QString& filePath,
 				const iser::IVersionInfo* versionInfoPtr = NULL,
 				bool supportTagSkipping = true,
-				bool serializeHeader = true);
+				bool serializeHeader = true,
+				SecureFormat secureFormat = SF_SIMPLE);
+
+	/**
+		Get encoding of the archive data.
+	*/
+	SecureFormat GetSecureFormat() const;
 
 	// reimplemented (ifile::CFileWriteArchive)
 	virtual bool ProcessData(void* data, int size) override;
+
+private:
+	/**
+		Write the archive header with the secure format and the secure header, both are not encoded.
+	*/
+	bool WriteHeaders(const iser::IVersionInfo* versionInfoPtr, bool serializeHeader);
+
+	SecureFormat m_secureFormat;
+	bool m_isEncodingEnabled;
+	CChaChaEncoder m_encoder;
+
+	QVector<quint8> m_buffer;
 };
 
 
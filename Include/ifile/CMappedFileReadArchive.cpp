@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/CMappedFileReadArchive.h>
+
+
+// STL includes
+#include <climits>
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QString>
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+
+
+namespace ifile
+{
+
+
+CMappedFileReadArchive::CMappedFileReadArchive(const QString& filePath, bool supportTagSkipping, bool serializeHeader)
+:	BaseClass2(filePath),
+	m_dataPtr(NULL),
+	m_dataSize(0),
+	m_readPosition(0),
+	m_supportTagSkipping(supportTagSkipping),
+	m_skipIndexPtr(NULL),
+	m_skipIndexSize(0),
+	m_nextTagIndex(0)
+{
+	if (!filePath.isEmpty() && OpenFile(filePath)){
+		if (serializeHeader){
+			SerializeAcfHeader();
+		}
+
+		if (m_supportTagSkipping && (!serializeHeader || (GetArchiveFormatVersion() >= iser::CArchiveHeaderInfo::AFV_SKIP_INDEX))){
+			LoadSkipIndex();
+		}
+	}
+}
+
+
+CMappedFileReadArchive::~CMappedFileReadArchive()
+{
+	CloseFile();
+}
+
+
+const void* CMappedFileReadArchive::ProcessSpan(qint64 size)
+{
+	if ((size < 0) || (size > m_dataSize - m_readPosition)){
+		return NULL;
+	}
+
+	const void* retVal = m_dataPtr + m_readPosition;
+
+	m_readPosition += size;
+
+	return retVal;
+}
+
+
+qint64 CMappedFileReadArchive::GetAvailableSize() const
+{
+	return m_dataSize - m_readPosition;
+}
+
+
+// reimplemented (ifile::IArchive)
+
+bool CMappedFileReadArchive::IsOpen() const
+{
+	return (m_dataPtr != NULL);
+}
+
+
+bool CMappedFileReadArchive::IsTagSkippingSupported() const
+{
+	return m_supportTagSkipping;
+}
+
+
+bool CMappedFileReadArchive::BeginTag(const iser::CArchiveTag& tag)
+{
+	bool retVal = BaseClass::BeginTag(tag);
+
+	if (!retVal){
+		return false;
+	}
+
+	m_tagStack.push_back(TagStackElement());
+	TagStackElement& element = m_tagStack.back();
+
+	element.tagBinaryId = tag.GetBinaryId();
+
+	retVal = retVal && Process(element.endPosition);
+	element.useTagSkipping = tag.IsTagSkippingUsed() && m_supportTagSkipping;
+	element.skipIndex = 0;
+
+	// skippable tags are numbered in the same order as by writing
+	if (element.useTagSkipping){
+		element.skipIndex = m_nextTagIndex++;
+	}
+
+	return retVal;
+}
+
+
+bool CMappedFileReadArchive::EndTag(const iser::CArchiveTag& tag)
+{
+	TagStackElement& element = m_tagStack.back();
+
+	bool retVal = (element.tagBinaryId == tag.GetBinaryId());
+
+	if (!retVal){
+		qFatal("BeginTag and EndTag have to use the same tag");
+
+		return false;
+	}
+
+	if (element.useTagSkipping){
+		qint64 endPosition = element.endPosition;
+
+		if (m_skipIndexPtr != NULL){
+			SkipIndexEntry entry = GetSkipIndexEntry(element.skipIndex);
+			if (entry.tagBinaryId == element.tagBinaryId){
+				endPosition = qint64(entry.endPosition);
+				m_nextTagIndex = entry.nextTagIndex;
+			}
+			else{
+				// the tags don't correspond to the index, skipping is not possible anymore
+				m_skipIndexPtr = NULL;
+				m_skipIndexSize = 0;
+			}
+		}
+
+		if (endPosition != 0){
+			if (endPosition > m_dataSize){
+				retVal = false;
+			}
+			else{
+				m_readPosition = endPosition;
+			}
+		}
+	}
+
+	m_tagStack.pop_back();
+
+	retVal = retVal && BaseClass::EndTag(tag);
+
+	return retVal;
+}
+
+
+bool CMappedFileReadArchive::ProcessData(void* data, int size)
+{
+	if (size <= 0){
+		return true;
+	}
+
+	if (data == NULL){
+		return false;
+	}
+
+	const void* sourcePtr = ProcessSpan(size);
+	if (sourcePtr == NULL){
+		return false;
+	}
+
+	std::memcpy(data, sourcePtr, size_t(size));
+
+	return true;
+}
+
+
+// protected methods
+
+bool CMappedFileReadArchive::OpenFile(const QString& filePath)
+{
+	CloseFile();
+
+	m_filePath = filePath;
+	m_file.setFileName(filePath);
+	if (!m_file.open(QIODevice::ReadOnly)){
+		if (IsLogConsumed()){
+			SendLogMessage(
+						istd::IInformationProvider::IC_ERROR,
+						MI_FILE_OPEN_ERROR,
+						QString("Cannot open file: %1").arg(m_file.errorString()),
+						"BinaryReader",
+						istd::IInformationProvider::ITF_SYSTEM);
+		}
+
+		return false;
+	}
+
+	qint64 fileSize = m_file.size();
+	if (fileSize <= 0){
+		// empty file cannot be mapped, use valid pointer to empty data
+		m_dataPtr = reinterpret_cast<const uchar*>(m_fileContent.constData());
+
+		return true;
+	}
+
+	m_dataPtr = m_file.map(0, fileSize);
+	if (m_dataPtr == NULL){
+		// some file systems don't support mapping, use the file content instead
+		m_fileContent = m_file.readAll();
+		if (m_fileContent.size() != fileSize){
+			CloseFile();
+
+			return false;
+		}
+
+		m_dataPtr = reinterpret_cast<const uchar*>(m_fileContent.constData());
+	}
+
+	m_dataSize = fileSize;
+
+	return true;
+}
+
+
+// reimplemented (istd::ILogger)
+
+void CMappedFileReadArchive::DecorateMessage(
+			istd::IInformationProvider::InformationCategory /*category*/,
+			int /*id*/,
+			int /*flags*/,
+			QString& message,
+			QString& /*messageSource*/) const
+{
+	message = m_filePath + " : " + message;
+}
+
+
+// reimplemented (iser::CArchiveBase)
+
+int CMappedFileReadArchive::GetMaxStringLength() const
+{
+	return int(qMin(m_dataSize - m_readPosition, qint64(INT_MAX)));
+}
+
+
+// private methods
+
+bool CMappedFileReadArchive::LoadSkipIndex()
+{
+	m_skipIndexPtr = NULL;
+	m_skipIndexSize = 0;
+
+	qint64 trailerPosition = m_dataSize - qint64(sizeof(SkipIndexTrailer));
+	if (trailerPosition < m_readPosition){
+		return false;
+	}
+
+	SkipIndexTrailer trailer;
+	std::memcpy(&trailer, m_dataPtr + trailerPosition, sizeof(trailer));
+
+	if (!IsSkipIndexTrailerValid(trailer, m_readPosition, trailerPosition)){
+		return false;
+	}
+
+	// the entries are not copied, they are validated once and accessed in place
+	const uchar* indexPtr = m_dataPtr + trailer.indexPosition;
+	for (quint32 i = 0; i < trailer.entriesCount; ++i){
+		SkipIndexEntry entry;
+		std::memcpy(&entry, indexPtr + i * sizeof(SkipIndexEntry), sizeof(entry));
+
+		if (!IsSkipIndexEntryValid(entry, trailer)){
+			return false;
+		}
+	}
+
+	m_skipIndexPtr = indexPtr;
+	m_skipIndexSize = trailer.entriesCount;
+
+	return true;
+}
+
+
+CFileArchiveInfo::SkipIndexEntry CMappedFileReadArchive::GetSkipIndexEntry(quint32 index) const
+{
+	SkipIndexEntry retVal;
+
+	if ((m_skipIndexPtr != NULL) && (index < m_skipIndexSize)){
+		std::memcpy(&retVal, m_skipIndexPtr + index * sizeof(SkipIndexEntry), sizeof(retVal));
+	}
+	else{
+		retVal.endPosition = 0;
+		retVal.tagBinaryId = 0;
+		retVal.nextTagIndex = 0;
+	}
+
+	return retVal;
+}
+
+
+void CMappedFileReadArchive::CloseFile()
+{
+	if (m_file.isOpen()){
+		if ((m_dataPtr != NULL) && (m_dataSize > 0) && m_fileContent.isEmpty()){
+			m_file.unmap(const_cast<uchar*>(m_dataPtr));
+		}
+
+		m_file.close();
+	}
+
+	m_fileContent.clear();
+	m_dataPtr = NULL;
+	m_dataSize = 0;
+	m_readPosition = 0;
+
+	m_tagStack.clear();
+	m_skipIndexPtr = NULL;
+	m_skipIndexSize = 0;
+	m_nextTagIndex = 0;
+}
+
+
+} // namespace ifile
+
+
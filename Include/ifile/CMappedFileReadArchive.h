@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <QtCore/QFile>
+
+// ACF includes
+#include <iser/CBinaryReadArchiveBase.h>
+#include <ifile/CFileArchiveInfo.h>
+
+
+namespace ifile
+{
+
+
+/**
+	Implementation of archive reading from own ACF format binary file mapped into memory.
+	The file format is the same as of \c ifile::CFileReadArchive, but there are no file system calls during reading,
+	all data is copied directly from the mapped file.
+	It should be used for large files, the data can be read with the memory bandwidth.
+
+	Using of \c ProcessSpan the data can be accessed without copying, e.g. to fill bitmap lines directly.
+	If the file system doesn't support mapping, the whole file will be read into memory.
+
+	\ingroup Persistence
+*/
+class CMappedFileReadArchive:
+			public iser::CBinaryReadArchiveBase,
+			public CFileArchiveInfo
+{
+public:
+	/**
+		Message IDs generated by this archive.
+	*/
+	enum MessageId
+	{
+		MI_FILE_OPEN_ERROR = 0x3f320c1
+	};
+
+	typedef iser::CBinaryReadArchiveBase BaseClass;
+	typedef CFileArchiveInfo BaseClass2;
+
+	/**
+		Contructor.
+		\param	filePath			name of file.
+		\param	supportTagSkipping	if it is true skipping of tags on EndTag is supported.
+									\sa	EndTag and IsTagSkippingSupported.
+		\param	serializeHeader		if it is true (default) archive header will be serialized.
+	*/
+	CMappedFileReadArchive(const QString& filePath = "", bool supportTagSkipping = true, bool serializeHeader = true);
+	virtual ~CMappedFileReadArchive();
+
+	/**
+		Get the next \c size bytes of the archive without copying and move the read position behind them.
+		The returned pointer stays valid as long as the archive exists, it has no special alignment.
+		\return	pointer to the data or NULL, if there is not enough data in the archive.
+	*/
+	const void* ProcessSpan(qint64 size);
+
+	/**
+		Get number of bytes which were not read yet.
+	*/
+	qint64 GetAvailableSize() const;
+
+	// reimplemented (ifile::IArchive)
+	virtual bool IsOpen() const override;
+	virtual bool IsTagSkippingSupported() const override;
+	virtual bool BeginTag(const iser::CArchiveTag& tag) override;
+	virtual bool EndTag(const iser::CArchiveTag& tag) override;
+	virtual bool ProcessData(void* data, int size) override;
+
+protected:
+	bool OpenFile(const QString& filePath);
+
+	struct TagStackElement
+	{
+		quint32 tagBinaryId;
+		/**
+			End position of the tag stored in the classic format, or 0.
+		*/
+		quint32 endPosition;
+		bool useTagSkipping;
+		/**
+			Index of the tag in the skip index.
+		*/
+		quint32 skipIndex;
+	};
+
+	// reimplemented (istd::ILogger)
+	virtual void DecorateMessage(
+				istd::IInformationProvider::InformationCategory category,
+				int id,
+				int flags,
+				QString& message,
+				QString& messageSource) const override;
+
+	// reimplemented (iser::CArchiveBase)
+	virtual int GetMaxStringLength() const override;
+
+private:
+	/**
+		Find the skip index at the end of the mapped data.
+		\return	true, if the skip index was found.
+	*/
+	bool LoadSkipIndex();
+
+	/**
+		Get entry of the skip index.
+	*/
+	SkipIndexEntry GetSkipIndexEntry(quint32 index) const;
+
+	void CloseFile();
+
+	QFile m_file;
+	QByteArray m_fileContent;
+	const uchar* m_dataPtr;
+	qint64 m_dataSize;
+	qint64 m_readPosition;
+
+	bool m_supportTagSkipping;
+
+	typedef QVector<TagStackElement> TagStack;
+
+	TagStack m_tagStack;
+
+	/**
+		Skip index entries are accessed directly in the mapped data.
+	*/
+	const uchar* m_skipIndexPtr;
+	quint32 m_skipIndexSize;
+	quint32 m_nextTagIndex;
+};
+
+
+} // namespace ifile
+
+
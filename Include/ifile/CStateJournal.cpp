@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/CStateJournal.h>
+
+
+// STL includes
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+// ACF includes
+#include <istd/CCrcCalculator.h>
+#include <istd/CBinaryDelta.h>
+
+
+namespace ifile
+{
+
+
+// public methods
+
+CStateJournal::CStateJournal(const QString& filePath)
+:	m_filePath(filePath),
+	m_baseFileSize(-1),
+	m_baseFileTime(0),
+	m_deltasSize(0),
+	m_isValid(false)
+{
+}
+
+
+const QString& CStateJournal::GetFilePath() const
+{
+	return m_filePath;
+}
+
+
+void CStateJournal::SetFilePath(const QString& filePath)
+{
+	if (filePath != m_filePath){
+		m_filePath = filePath;
+
+		m_lastState.clear();
+		m_deltasSize = 0;
+		m_isValid = false;
+	}
+}
+
+
+const QString& CStateJournal::GetBaseFilePath() const
+{
+	return m_baseFilePath;
+}
+
+
+void CStateJournal::SetBaseFilePath(const QString& filePath)
+{
+	if (filePath != m_baseFilePath){
+		m_baseFilePath = filePath;
+
+		m_lastState.clear();
+		m_deltasSize = 0;
+		m_isValid = false;
+	}
+}
+
+
+bool CStateJournal::IsBaseFileChanged() const
+{
+	JournalHeader header = CreateHeader();
+
+	return (header.baseFileSize != m_baseFileSize) || (header.baseFileTime != m_baseFileTime);
+}
+
+
+bool CStateJournal::UpdateBaseFileStamp()
+{
+	if (!m_isValid){
+		return false;
+	}
+
+	JournalHeader header = CreateHeader();
+
+	// the header has fixed size, so it can be overwritten in place
+	QFile file(m_filePath);
+	if (!file.open(QIODevice::ReadWrite)){
+		return false;
+	}
+
+	if ((file.write(reinterpret_cast<const char*>(&header), qint64(sizeof(header))) != qint64(sizeof(header))) || !file.flush()){
+		m_isValid = false;
+
+		return false;
+	}
+
+	m_baseFileSize = header.baseFileSize;
+	m_baseFileTime = header.baseFileTime;
+
+	return true;
+}
+
+
+bool CStateJournal::IsValid() const
+{
+	return m_isValid;
+}
+
+
+const QByteArray& CStateJournal::GetLastState() const
+{
+	return m_lastState;
+}
+
+
+qint64 CStateJournal::GetDeltasSize() const
+{
+	return m_deltasSize;
+}
+
+
+bool CStateJournal::Reset(const QByteArray& state)
+{
+	m_isValid = false;
+
+	if (m_filePath.isEmpty()){
+		return false;
+	}
+
+	JournalHeader header = CreateHeader();
+
+	QByteArray fileData(reinterpret_cast<const char*>(&header), int(sizeof(header)));
+	fileData += CreateRecord(RT_STATE, state);
+
+	// the previous journal is valid until the new one is completely written
+	QSaveFile saveFile(m_filePath);
+	if (!saveFile.open(QIODevice::WriteOnly)){
+		return false;
+	}
+
+	if (saveFile.write(fileData) != fileData.size()){
+		saveFile.cancelWriting();
+
+		return false;
+	}
+
+	if (!saveFile.commit()){
+		return false;
+	}
+
+	m_lastState = state;
+	m_lastState.detach();
+	m_deltasSize = 0;
+	m_baseFileSize = header.baseFileSize;
+	m_baseFileTime = header.baseFileTime;
+	m_isValid = true;
+
+	return true;
+}
+
+
+bool CStateJournal::Append(const QByteArray& state)
+{
+	if (!m_isValid){
+		return false;
+	}
+
+	QByteArray delta = istd::CBinaryDelta::CreateDelta(m_lastState.constData(), m_lastState.size(), state.constData(), state.size());
+	QByteArray record = CreateRecord(RT_DELTA, delta);
+
+	QFile file(m_filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)){
+		m_isValid = false;
+
+		return false;
+	}
+
+	if ((file.write(record) != record.size()) || !file.flush()){
+		// the journal end is undefined, it must be reset before the next append
+		m_isValid = false;
+
+		return false;
+	}
+
+	m_lastState = state;
+	m_lastState.detach();
+	m_deltasSize += record.size();
+
+	return true;
+}
+
+
+bool CStateJournal::Replay()
+{
+	m_lastState.clear();
+	m_deltasSize = 0;
+	m_isValid = false;
+
+	QFile file(m_filePath);
+	if (!file.open(QIODevice::ReadOnly)){
+		return false;
+	}
+
+	QByteArray fileData = file.readAll();
+
+	file.close();
+
+	JournalHeader header;
+	if (fileData.size() < int(sizeof(header))){
+		return false;
+	}
+
+	std::memcpy(&header, fileData.constData(), sizeof(header));
+	if ((header.magic != JOURNAL_MAGIC) || (header.version != JOURNAL_VERSION)){
+		return false;
+	}
+
+	m_baseFileSize = header.baseFileSize;
+	m_baseFileTime = header.baseFileTime;
+
+	// the base file was stored or edited after the last state of the journal
+	if (IsBaseFileChanged()){
+		Remove();
+
+		return false;
+	}
+
+	int position = int(sizeof(header));
+	bool hasState = false;
+
+	while (fileData.size() - position >= int(sizeof(RecordHeader))){
+		RecordHeader recordHeader;
+		std::memcpy(&recordHeader, fileData.constData() + position, sizeof(recordHeader));
+
+		int dataPosition = position + int(sizeof(recordHeader));
+		if (		(recordHeader.magic != RECORD_MAGIC) ||
+					(recordHeader.dataSize > quint32(fileData.size() - dataPosition))){
+			break;
+		}
+
+		const char* dataPtr = fileData.constData() + dataPosition;
+		int dataSize = int(recordHeader.dataSize);
+
+		if (istd::CCrcCalculator::GetCrcFromData(reinterpret_cast<const quint8*>(dataPtr), dataSize) != recordHeader.crc){
+			break;
+		}
+
+		if (recordHeader.type == RT_STATE){
+			m_lastState = QByteArray(dataPtr, dataSize);
+			m_deltasSize = 0;
+
+			hasState = true;
+		}
+		else if ((recordHeader.type == RT_DELTA) && hasState){
+			QByteArray nextState;
+			if (!istd::CBinaryDelta::ApplyDelta(m_lastState.constData(), m_lastState.size(), QByteArray::fromRawData(dataPtr, dataSize), nextState)){
+				break;
+			}
+
+			m_lastState = nextState;
+			m_deltasSize += int(sizeof(recordHeader)) + dataSize;
+		}
+		else{
+			break;
+		}
+
+		position = dataPosition + dataSize;
+	}
+
+	if (!hasState){
+		m_lastState.clear();
+
+		return false;
+	}
+
+	// the incomplete records must be removed, otherwise the appended records would be unreachable
+	if (position < fileData.size()){
+		if (!QFile::resize(m_filePath, position)){
+			return true;
+		}
+	}
+
+	m_isValid = true;
+
+	return true;
+}
+
+
+bool CStateJournal::Remove()
+{
+	m_lastState.clear();
+	m_deltasSize = 0;
+	m_isValid = false;
+
+	return !QFile::exists(m_filePath) || QFile::remove(m_filePath);
+}
+
+
+// protected static methods
+
+QByteArray CStateJournal::CreateRecord(RecordType type, const QByteArray& data)
+{
+	RecordHeader header;
+	header.magic = RECORD_MAGIC;
+	header.type = quint32(type);
+	header.dataSize = quint32(data.size());
+	header.crc = istd::CCrcCalculator::GetCrcFromData(reinterpret_cast<const quint8*>(data.constData()), data.size());
+
+	QByteArray retVal;
+	retVal.reserve(int(sizeof(header)) + data.size());
+	retVal.append(reinterpret_cast<const char*>(&header), int(sizeof(header)));
+	retVal.append(data);
+
+	return retVal;
+}
+
+
+// protected methods
+
+CStateJournal::JournalHeader CStateJournal::CreateHeader() const
+{
+	JournalHeader header;
+	header.magic = JOURNAL_MAGIC;
+	header.version = JOURNAL_VERSION;
+	header.baseFileSize = -1;
+	header.baseFileTime = 0;
+
+	if (!m_baseFilePath.isEmpty()){
+		QFileInfo fileInfo(m_baseFilePath);
+		if (fileInfo.exists()){
+			header.baseFileSize = fileInfo.size();
+			header.baseFileTime = fileInfo.lastModified().toMSecsSinceEpoch();
+		}
+	}
+
+	return header;
+}
+
+
+} // namespace ifile
+
+
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+
+namespace ifile
+{
+
+
+/**
+	Append-only journal of serialized object states.
+
+	The journal starts with a complete state, each next state is stored as binary difference to the previous one (see \c istd::CBinaryDelta).
+	Each record is protected by CRC, so incomplete records written during a crash are ignored by replaying of the journal.
+	The journal is compacted by \c Reset, which replaces the whole file atomically.
+
+	The journal continues the state of a base data file. Size and modification time of the base file are stored in the journal header,
+	the journal is replayed only if the base file was not changed since then, otherwise it would overwrite newer contents of the file.
+*/
+class CStateJournal
+{
+public:
+	explicit CStateJournal(const QString& filePath = QString());
+
+	const QString& GetFilePath() const;
+
+	/**
+		Set path of the journal file.
+		The journal has to be reset or replayed before the next state can be appended.
+	*/
+	void SetFilePath(const QString& filePath);
+
+	const QString& GetBaseFilePath() const;
+
+	/**
+		Set path of the data file continued by this journal.
+		If no base file is set, the journal is not bound to any file.
+	*/
+	void SetBaseFilePath(const QString& filePath);
+
+	/**
+		Check if the base file was changed since the journal was reset or its base file stamp was updated.
+	*/
+	bool IsBaseFileChanged() const;
+
+	/**
+		Store the current size and modification time of the base file in the journal header.
+		It should be called after the base file was written with the last journal state.
+	*/
+	bool UpdateBaseFileStamp();
+
+	/**
+		Check if the last state is known and new states can be appended.
+	*/
+	bool IsValid() const;
+
+	/**
+		Get the last stored state.
+	*/
+	const QByteArray& GetLastState() const;
+
+	/**
+		Get size of the stored differences since the last reset.
+	*/
+	qint64 GetDeltasSize() const;
+
+	/**
+		Replace the journal with a new one containing the given state only.
+		The journal is bound to the current state of the base file.
+	*/
+	bool Reset(const QByteArray& state);
+
+	/**
+		Append the next state to the journal, only the difference to the last state will be written.
+	*/
+	bool Append(const QByteArray& state);
+
+	/**
+		Reconstruct the last state from the journal file.
+		Damaged records at the end of the file are removed, so the journal can be continued.
+		If the base file was changed since the journal was bound to it, the journal is outdated and it will be removed.
+	*/
+	bool Replay();
+
+	/**
+		Remove the journal file.
+	*/
+	bool Remove();
+
+protected:
+	enum
+	{
+		JOURNAL_MAGIC = 0x4e524a41,
+		RECORD_MAGIC = 0x43524a41,
+		JOURNAL_VERSION = 2
+	};
+
+	enum RecordType
+	{
+		RT_STATE,
+		RT_DELTA
+	};
+
+	struct JournalHeader
+	{
+		quint32 magic;
+		quint32 version;
+		/**
+			Size of the base file or -1, if it did not exist.
+		*/
+		qint64 baseFileSize;
+		/**
+			Modification time of the base file in milliseconds since epoch.
+		*/
+		qint64 baseFileTime;
+	};
+
+	struct RecordHeader
+	{
+		quint32 magic;
+		quint32 type;
+		quint32 dataSize;
+		quint32 crc;
+	};
+
+	static QByteArray CreateRecord(RecordType type, const QByteArray& data);
+
+	/**
+		Create journal header containing the current stamp of the base file.
+	*/
+	JournalHeader CreateHeader() const;
+
+private:
+	QString m_filePath;
+	QString m_baseFilePath;
+	qint64 m_baseFileSize;
+	qint64 m_baseFileTime;
+	QByteArray m_lastState;
+	qint64 m_deltasSize;
+	bool m_isValid;
+};
+
+
+} // namespace ifile
+
+
@@ -11,6 +11,8 @@
 #include <istd/CSystem.h>
 #include <ibase/IProgressManager.h>
 #include <ifile/CFileSerializerCompBase.h>
+#include <ifile/CFileWriteArchive.h>
+#include <ifile/CBlockCompressedFileWriteArchive.h>
 
 
 namespace ifile
@@ -129,6 +131,15 @@ protected:
 	*/
 	virtual void OnReadError(const ReadArchive& archive, const istd::IChangeable& data, const QString& filePath) const;
 
+	/**
+		Finish writing of the archive before its destruction, so the write errors can be detected.
+		Binary file archives write their indices and close the file, other archives are finished on destruction.
+		\return	true, if the archive was successfully written.
+	*/
+	static bool CloseArchive(CFileWriteArchive& archive);
+	static bool CloseArchive(CBlockCompressedFileWriteArchive& archive);
+	static bool CloseArchive(iser::IArchive& archive);
+
 	I_ATTR(bool, m_autoCreateDirectoryAttrPtr);
 };
 
@@ -207,7 +218,7 @@ ifile::IFilePersistence::OperationState TFileSerializerComp<ReadArchive, WriteAr
 			SendWarningMessage(MI_UNSUPPORTED_VERSION, QObject::tr("Archive version is not supported, possible lost of data"));
 		}
 
-		if ((const_cast<iser::ISerializable*>(serializablePtr))->Serialize(archive)){
+		if ((const_cast<iser::ISerializable*>(serializablePtr))->Serialize(archive) && CloseArchive(archive)){
 			return OS_OK;
 		}
 		else{
@@ -231,5 +242,26 @@ void TFileSerializerComp<ReadArchive, WriteArchive>::OnReadError(
 }
 
 
+template <class ReadArchive, class WriteArchive>
+bool TFileSerializerComp<ReadArchive, WriteArchive>::CloseArchive(CFileWriteArchive& archive)
+{
+	return archive.Close();
+}
+
+
+template <class ReadArchive, class WriteArchive>
+bool TFileSerializerComp<ReadArchive, WriteArchive>::CloseArchive(CBlockCompressedFileWriteArchive& archive)
+{
+	return archive.Close();
+}
+
+
+template <class ReadArchive, class WriteArchive>
+bool TFileSerializerComp<ReadArchive, WriteArchive>::CloseArchive(iser::IArchive& /*archive*/)
+{
+	return true;
+}
+
+
 } // namespace ifile
 
@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/Test/CBlockCompressedFileArchiveTest.h>
+
+
+// Qt includes
+#include <QtCore/QFile>
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+#include <itest/CRandomDataGenerator.h>
+#include <ifile/CFileReadArchive.h>
+#include <ifile/CFileWriteArchive.h>
+#include <ifile/CBlockCompressedFileReadArchive.h>
+#include <ifile/CBlockCompressedFileWriteArchive.h>
+
+
+namespace
+{
+
+
+static const int s_skippedDataSize = 64 * 1024;
+static const int s_smallBlockSize = 1024;
+static const int s_benchmarkValuesCount = 4 * 1024 * 1024;
+
+static const iser::CArchiveTag s_dataTag("Data", "Skipped data", iser::CArchiveTag::TT_GROUP, NULL, true);
+static const iser::CArchiveTag s_nameTag("Name", "Name of the data", iser::CArchiveTag::TT_LEAF);
+static const iser::CArchiveTag s_countTag("Count", "Number of values", iser::CArchiveTag::TT_LEAF);
+
+
+enum ArchiveType
+{
+	AT_FILE,
+	AT_BLOCK_COMPRESSED
+};
+
+
+/**
+	Create data which cannot be compressed, so the skipped tag covers many blocks in the file.
+*/
+QByteArray CreateNoiseData(int size)
+{
+	return itest::CRandomDataGenerator(12345).CreateData(size);
+}
+
+
+bool WriteSkippedData(iser::IArchive& archive, const QString& name)
+{
+	QByteArray data = CreateNoiseData(s_skippedDataSize);
+	int size = data.size();
+
+	bool retVal = archive.BeginTag(s_dataTag);
+	retVal = retVal && archive.Process(size);
+	retVal = retVal && archive.ProcessData(data.data(), size);
+	retVal = retVal && archive.EndTag(s_dataTag);
+
+	QString nameCopy = name;
+
+	retVal = retVal && archive.BeginTag(s_nameTag);
+	retVal = retVal && archive.Process(nameCopy);
+	retVal = retVal && archive.EndTag(s_nameTag);
+
+	return retVal;
+}
+
+
+/**
+	Read only size of the data, the data self is skipped.
+*/
+bool ReadSkippedData(iser::IArchive& archive, QString& name)
+{
+	int size = 0;
+
+	bool retVal = archive.BeginTag(s_dataTag);
+	retVal = retVal && archive.Process(size);
+	retVal = retVal && (size == s_skippedDataSize);
+	retVal = retVal && archive.EndTag(s_dataTag);
+
+	retVal = retVal && archive.BeginTag(s_nameTag);
+	retVal = retVal && archive.Process(name);
+	retVal = retVal && archive.EndTag(s_nameTag);
+
+	return retVal;
+}
+
+
+bool WriteValues(iser::IArchive& archive, const QVector<double>& values)
+{
+	int count = values.size();
+
+	bool retVal = archive.BeginTag(s_countTag);
+	retVal = retVal && archive.Process(count);
+	retVal = retVal && archive.EndTag(s_countTag);
+
+	retVal = retVal && archive.ProcessData(const_cast<double*>(values.data()), count * int(sizeof(double)));
+
+	return retVal;
+}
+
+
+bool ReadValues(iser::IArchive& archive, QVector<double>& values)
+{
+	int count = 0;
+
+	bool retVal = archive.BeginTag(s_countTag);
+	retVal = retVal && archive.Process(count);
+	retVal = retVal && archive.EndTag(s_countTag);
+
+	if (retVal){
+		values.resize(count);
+
+		retVal = archive.ProcessData(values.data(), count * int(sizeof(double)));
+	}
+
+	return retVal;
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CBlockCompressedFileArchiveTest::initTestCase()
+{
+	QVERIFY(m_tempDir.isValid());
+}
+
+
+void CBlockCompressedFileArchiveTest::ReadWriteTest_data()
+{
+	QTest::addColumn<int>("blockSize");
+	QTest::addColumn<int>("valuesCount");
+
+	QTest::newRow("Empty") << int(ifile::CBlockCompressedFileWriteArchive::DEFAULT_BLOCK_SIZE) << 0;
+	QTest::newRow("Tiny blocks") << 16 << 1000;
+	QTest::newRow("Small blocks") << s_smallBlockSize << 100000;
+	QTest::newRow("Default blocks") << int(ifile::CBlockCompressedFileWriteArchive::DEFAULT_BLOCK_SIZE) << 100000;
+}
+
+
+void CBlockCompressedFileArchiveTest::ReadWriteTest()
+{
+	QFETCH(int, blockSize);
+	QFETCH(int, valuesCount);
+
+	QString filePath = m_tempDir.filePath(QString("ReadWrite%1.dat").arg(QTest::currentDataTag()));
+
+	QString name = "Block compressed archive äöü";
+	QVector<double> values(valuesCount);
+	for (int i = 0; i < values.size(); ++i){
+		values[i] = i * 0.5;
+	}
+
+	{
+		ifile::CBlockCompressedFileWriteArchive writeArchive(filePath, NULL, true, blockSize);
+		QVERIFY(writeArchive.IsArchiveValid());
+
+		QVERIFY(writeArchive.BeginTag(s_nameTag));
+		QVERIFY(writeArchive.Process(name));
+		QVERIFY(writeArchive.EndTag(s_nameTag));
+
+		QVERIFY(WriteValues(writeArchive, values));
+		QVERIFY(writeArchive.Close());
+	}
+
+	ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+	QVERIFY(readArchive.IsOpen());
+
+	QString readName;
+	QVERIFY(readArchive.BeginTag(s_nameTag));
+	QVERIFY(readArchive.Process(readName));
+	QVERIFY(readArchive.EndTag(s_nameTag));
+	QCOMPARE(readName, name);
+
+	QVector<double> readValues;
+	QVERIFY(ReadValues(readArchive, readValues));
+	QCOMPARE(readValues, values);
+
+	// no data behind the end of the archive
+	char value = 0;
+	QVERIFY(!readArchive.Process(value));
+}
+
+
+void CBlockCompressedFileArchiveTest::TagSkippingTest()
+{
+	QString filePath = m_tempDir.filePath("Skipping.dat");
+
+	{
+		ifile::CBlockCompressedFileWriteArchive writeArchive(filePath, NULL, true, s_smallBlockSize);
+		QVERIFY(WriteSkippedData(writeArchive, "First"));
+		QVERIFY(WriteSkippedData(writeArchive, "Second"));
+	}
+
+	ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+	QVERIFY(readArchive.IsOpen());
+
+	QString name;
+	QVERIFY(ReadSkippedData(readArchive, name));
+	QCOMPARE(name, QString("First"));
+
+	QVERIFY(ReadSkippedData(readArchive, name));
+	QCOMPARE(name, QString("Second"));
+
+	// blocks of the skipped data must not be decompressed
+	int blocksCount = int(readArchive.GetDataSize() / s_smallBlockSize);
+	QVERIFY(blocksCount > 2 * s_skippedDataSize / s_smallBlockSize);
+	QVERIFY(readArchive.GetDecompressedBlocksCount() < blocksCount / 4);
+}
+
+
+void CBlockCompressedFileArchiveTest::CorruptedBlockTest()
+{
+	QString filePath = m_tempDir.filePath("Corrupted.dat");
+
+	{
+		ifile::CBlockCompressedFileWriteArchive writeArchive(filePath, NULL, true, s_smallBlockSize);
+		QVERIFY(WriteSkippedData(writeArchive, "Name"));
+	}
+
+	// the middle of the file belongs to the skipped data, the noise data cannot be compressed
+	{
+		QFile file(filePath);
+		QVERIFY(file.open(QIODevice::ReadWrite));
+		QVERIFY(file.seek(file.size() / 2));
+		QVERIFY(file.write(QByteArray(16, '\x5a')) == 16);
+	}
+
+	{
+		ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+		QVERIFY(readArchive.IsOpen());
+
+		QString name;
+		QVERIFY(ReadSkippedData(readArchive, name));
+		QCOMPARE(name, QString("Name"));
+	}
+
+	// reading of the corrupted block itself must fail
+	ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+	QVERIFY(readArchive.IsOpen());
+
+	int size = 0;
+	QVERIFY(readArchive.BeginTag(s_dataTag));
+	QVERIFY(readArchive.Process(size));
+
+	QByteArray data(size, '\0');
+	QVERIFY(!readArchive.ProcessData(data.data(), size));
+}
+
+
+void CBlockCompressedFileArchiveTest::InvalidFileTest()
+{
+	ifile::CBlockCompressedFileReadArchive notExistingArchive(m_tempDir.filePath("NotExisting.dat"));
+	QVERIFY(!notExistingArchive.IsOpen());
+
+	// uncompressed binary archive has no block index
+	QString filePath = m_tempDir.filePath("Uncompressed.dat");
+	{
+		ifile::CFileWriteArchive writeArchive(filePath);
+		QVERIFY(WriteSkippedData(writeArchive, "Name"));
+	}
+
+	ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+	QVERIFY(!readArchive.IsOpen());
+
+	int value = 0;
+	QVERIFY(!readArchive.Process(value));
+}
+
+
+void CBlockCompressedFileArchiveTest::ReadWriteBenchmark_data()
+{
+	QTest::addColumn<int>("archiveType");
+
+	QTest::newRow("File") << int(AT_FILE);
+	QTest::newRow("Block compressed") << int(AT_BLOCK_COMPRESSED);
+}
+
+
+void CBlockCompressedFileArchiveTest::ReadWriteBenchmark()
+{
+	QFETCH(int, archiveType);
+
+	QString filePath = m_tempDir.filePath(QString("Benchmark%1.dat").arg(archiveType));
+
+	QVector<double> values(s_benchmarkValuesCount);
+	for (int i = 0; i < values.size(); ++i){
+		values[i] = (i % 1000) * 0.25;
+	}
+
+	QVector<double> readValues;
+	bool retVal = true;
+
+	QBENCHMARK{
+		if (archiveType == AT_FILE){
+			{
+				ifile::CFileWriteArchive writeArchive(filePath);
+				retVal = retVal && WriteValues(writeArchive, values);
+			}
+
+			ifile::CFileReadArchive readArchive(filePath);
+			retVal = retVal && ReadValues(readArchive, readValues);
+		}
+		else{
+			{
+				ifile::CBlockCompressedFileWriteArchive writeArchive(filePath);
+				retVal = retVal && WriteValues(writeArchive, values);
+			}
+
+			ifile::CBlockCompressedFileReadArchive readArchive(filePath);
+			retVal = retVal && ReadValues(readArchive, readValues);
+		}
+	}
+
+	QVERIFY(retVal);
+	QCOMPARE(readValues, values);
+}
+
+
+I_ADD_TEST(CBlockCompressedFileArchiveTest);
+
+
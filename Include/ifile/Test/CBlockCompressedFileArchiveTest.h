@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Tests of the block compressed file archives and benchmark compared to the uncompressed binary file archives.
+*/
+class CBlockCompressedFileArchiveTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void ReadWriteTest_data();
+	void ReadWriteTest();
+	void TagSkippingTest();
+	void CorruptedBlockTest();
+	void InvalidFileTest();
+
+	void ReadWriteBenchmark_data();
+	void ReadWriteBenchmark();
+
+private:
+	QTemporaryDir m_tempDir;
+};
+
+
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/Test/CChaChaEncoderTest.h>
+
+
+// ACF includes
+#include <ifile/CChaChaEncoder.h>
+#include <ifile/CSimpleEncoder.h>
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+enum EncoderType
+{
+	ET_SIMPLE,
+	ET_CHACHA20
+};
+
+
+static const int s_benchmarkBufferSize = 64 * 1024 * 1024;
+static const int s_benchmarkRepeatCount = 16;
+
+
+QByteArray CreateData(int size)
+{
+	return itest::CRandomDataGenerator().CreateData(size);
+}
+
+
+void SetTestKey(ifile::CChaChaEncoder& encoder)
+{
+	quint8 key[ifile::CChaChaEncoder::KEY_SIZE];
+	for (int i = 0; i < ifile::CChaChaEncoder::KEY_SIZE; ++i){
+		key[i] = quint8(i);
+	}
+
+	encoder.SetKey(key);
+}
+
+
+} // namespace
+
+
+void CChaChaEncoderTest::KnownKeyStreamTest()
+{
+	// test vector of RFC 7539 (section 2.4.2), the 96-bit nonce corresponds to the high counter word and the 64-bit nonce
+	ifile::CChaChaEncoder encoder;
+	SetTestKey(encoder);
+
+	const quint8 nonce[ifile::CChaChaEncoder::NONCE_SIZE] = {0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00};
+	encoder.SetNonce(nonce);
+
+	QByteArray plainText("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.");
+	QByteArray expected = QByteArray::fromHex(
+				"6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+				"f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+				"07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+				"5af90bbf74a35be6b40b8eedf2785e42874d");
+
+	QByteArray cipherText(plainText.size(), Qt::Uninitialized);
+
+	// the counter of the test vector begins with 1
+	encoder.Process(
+				reinterpret_cast<const quint8*>(plainText.constData()),
+				reinterpret_cast<quint8*>(cipherText.data()),
+				plainText.size(),
+				ifile::CChaChaEncoder::BLOCK_SIZE);
+
+	QCOMPARE(cipherText, expected);
+}
+
+
+void CChaChaEncoderTest::EncodeDecodeTest_data()
+{
+	QTest::addColumn<int>("dataSize");
+	QTest::addColumn<int>("streamPosition");
+
+	QTest::newRow("Single byte") << 1 << 0;
+	QTest::newRow("Partial block") << 37 << 11;
+	QTest::newRow("Four blocks") << 256 << 64;
+	QTest::newRow("Unaligned blocks") << 1000 << 63;
+	QTest::newRow("Multi-threaded") << 8 * 1024 * 1024 + 5 << 3;
+}
+
+
+void CChaChaEncoderTest::EncodeDecodeTest()
+{
+	QFETCH(int, dataSize);
+	QFETCH(int, streamPosition);
+
+	QByteArray data = CreateData(dataSize);
+
+	ifile::CChaChaEncoder encoder;
+
+	QByteArray encoded(dataSize, Qt::Uninitialized);
+	encoder.Process(reinterpret_cast<const quint8*>(data.constData()), reinterpret_cast<quint8*>(encoded.data()), dataSize, quint64(streamPosition));
+
+	QVERIFY(encoded != data);
+
+	// decoding in place
+	encoder.Process(reinterpret_cast<const quint8*>(encoded.constData()), reinterpret_cast<quint8*>(encoded.data()), dataSize, quint64(streamPosition));
+
+	QCOMPARE(encoded, data);
+}
+
+
+void CChaChaEncoderTest::StreamPositionTest()
+{
+	QByteArray data = CreateData(100000);
+	const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData());
+
+	ifile::CChaChaEncoder encoder;
+
+	QByteArray expected(data.size(), Qt::Uninitialized);
+	encoder.Process(dataPtr, reinterpret_cast<quint8*>(expected.data()), data.size(), 0);
+
+	// each part of the data can be encoded independently
+	QByteArray encoded(data.size(), Qt::Uninitialized);
+	quint8* encodedPtr = reinterpret_cast<quint8*>(encoded.data());
+
+	const int partSizes[] = {1, 7, 64, 65, 500, 4096, 30000};
+	int position = 0;
+	for (int partIndex = 0; position < data.size(); ++partIndex){
+		int partSize = qMin(partSizes[partIndex % 7], data.size() - position);
+
+		encoder.Process(dataPtr + position, encodedPtr + position, partSize, quint64(position));
+
+		position += partSize;
+	}
+
+	QCOMPARE(encoded, expected);
+
+	// other nonce gives other key stream
+	const quint8 nonce[ifile::CChaChaEncoder::NONCE_SIZE] = {1, 2, 3, 4, 5, 6, 7, 8};
+	encoder.SetNonce(nonce);
+
+	encoder.Process(dataPtr, encodedPtr, data.size(), 0);
+
+	QVERIFY(encoded != expected);
+}
+
+
+void CChaChaEncoderTest::CachedProcessingTest()
+{
+	QByteArray data = CreateData(50000);
+	const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData());
+
+	ifile::CChaChaEncoder encoder;
+
+	QByteArray expected(data.size(), Qt::Uninitialized);
+	encoder.Process(dataPtr, reinterpret_cast<quint8*>(expected.data()), data.size(), 17);
+
+	QByteArray encoded(data.size(), Qt::Uninitialized);
+	quint8* encodedPtr = reinterpret_cast<quint8*>(encoded.data());
+
+	// small values like in serialization, with some jumps back
+	const int partSizes[] = {4, 1, 8, 2, 33, 4, 8, 10000};
+	int position = 0;
+	for (int partIndex = 0; position < data.size(); ++partIndex){
+		int partSize = qMin(partSizes[partIndex % 8], data.size() - position);
+
+		encoder.ProcessCached(dataPtr + position, encodedPtr + position, partSize, quint64(position) + 17);
+
+		if ((partIndex % 50) == 49){
+			int previousPosition = position / 2;
+
+			encoder.ProcessCached(dataPtr + previousPosition, encodedPtr + previousPosition, 1, quint64(previousPosition) + 17);
+		}
+
+		position += partSize;
+	}
+
+	QCOMPARE(encoded, expected);
+}
+
+
+void CChaChaEncoderTest::EncoderBenchmark_data()
+{
+	QTest::addColumn<int>("encoderType");
+
+	QTest::newRow("Simple encoder") << int(ET_SIMPLE);
+	QTest::newRow("ChaCha20 encoder") << int(ET_CHACHA20);
+}
+
+
+void CChaChaEncoderTest::EncoderBenchmark()
+{
+	QFETCH(int, encoderType);
+
+	// 1 GB of data is processed using a smaller buffer
+	QByteArray data = CreateData(s_benchmarkBufferSize);
+	QByteArray result(s_benchmarkBufferSize, Qt::Uninitialized);
+
+	const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData());
+	quint8* resultPtr = reinterpret_cast<quint8*>(result.data());
+
+	ifile::CChaChaEncoder encoder;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_benchmarkRepeatCount; ++i){
+			if (encoderType == ET_SIMPLE){
+				ifile::CSimpleEncoder::Encode(dataPtr, resultPtr, s_benchmarkBufferSize);
+			}
+			else{
+				encoder.Process(dataPtr, resultPtr, s_benchmarkBufferSize, quint64(i) * s_benchmarkBufferSize);
+			}
+		}
+	}
+}
+
+
+I_ADD_TEST(CChaChaEncoderTest);
+
+
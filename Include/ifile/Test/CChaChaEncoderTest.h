@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+class CChaChaEncoderTest : public QObject
+{
+	Q_OBJECT
+
+private Q_SLOTS:
+	void KnownKeyStreamTest();
+	void EncodeDecodeTest_data();
+	void EncodeDecodeTest();
+	void StreamPositionTest();
+	void CachedProcessingTest();
+	void EncoderBenchmark_data();
+	void EncoderBenchmark();
+};
+
+
@@ -14,6 +14,7 @@
 #include <iser/ISerializable.h>
 #include <iser/IArchive.h>
 #include <iser/CArchiveTag.h>
+#include <iser/CBinaryWriteArchiveBase.h>
 
 
 class SimpleModel: virtual public iser::ISerializable
@@ -69,6 +70,115 @@ public:
 };
 
 
+/**
+	Model with skippable tags, the reading can be limited to the first values of each group.
+*/
+class SkippableModel: virtual public iser::ISerializable
+{
+public:
+	virtual bool Serialize(iser::IArchive& archive) override
+	{
+		static iser::CArchiveTag groupTag("Group", "Group of values", iser::CArchiveTag::TT_GROUP, NULL, true);
+		static iser::CArchiveTag itemTag("Item", "Item of the group", iser::CArchiveTag::TT_GROUP, &groupTag, true);
+		static iser::CArchiveTag lastValueTag("LastValue", "Value following the groups");
+
+		bool retVal = true;
+
+		for (int groupIndex = 0; groupIndex < 2; ++groupIndex){
+			retVal = retVal && archive.BeginTag(groupTag);
+
+			int itemsCount = archive.IsStoring()? itemsPerGroup: readItemsCount;
+			for (int itemIndex = 0; itemIndex < itemsCount; ++itemIndex){
+				retVal = retVal && archive.BeginTag(itemTag);
+
+				int value = groupIndex * 1000 + itemIndex;
+				retVal = retVal && archive.Process(value);
+
+				if (!archive.IsStoring()){
+					readValues.append(value);
+				}
+
+				retVal = retVal && archive.EndTag(itemTag);
+			}
+
+			retVal = retVal && archive.EndTag(groupTag);
+		}
+
+		retVal = retVal && archive.BeginTag(lastValueTag);
+		retVal = retVal && archive.Process(lastValue);
+		retVal = retVal && archive.EndTag(lastValueTag);
+
+		return retVal;
+	}
+
+	int itemsPerGroup = 100;
+	int readItemsCount = 100;
+	int lastValue = 0;
+	QList<int> readValues;
+};
+
+
+/**
+	Writer of binary files in the classic format, end positions of skippable tags are patched directly after the tag begin.
+*/
+class CClassicFileWriteArchive: public iser::CBinaryWriteArchiveBase
+{
+public:
+	typedef iser::CBinaryWriteArchiveBase BaseClass;
+
+	explicit CClassicFileWriteArchive(const QString& filePath)
+	:	BaseClass(NULL),
+		m_file(filePath)
+	{
+		if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+			SerializeAcfHeader();
+		}
+	}
+
+	// reimplemented (iser::IArchive)
+	virtual bool IsTagSkippingSupported() const override
+	{
+		return true;
+	}
+
+	virtual bool BeginTag(const iser::CArchiveTag& tag) override
+	{
+		bool retVal = BaseClass::BeginTag(tag);
+
+		m_endFieldPositions.push_back(tag.IsTagSkippingUsed()? quint32(m_file.pos()): quint32(0));
+
+		quint32 dummyPos = 0;
+
+		return retVal && Process(dummyPos);
+	}
+
+	virtual bool EndTag(const iser::CArchiveTag& tag) override
+	{
+		bool retVal = true;
+
+		quint32 endFieldPosition = m_endFieldPositions.takeLast();
+		if (endFieldPosition != 0){
+			quint32 endPosition = quint32(m_file.pos());
+
+			retVal = retVal && m_file.seek(endFieldPosition);
+			retVal = retVal && Process(endPosition);
+			retVal = retVal && m_file.seek(endPosition);
+		}
+
+		return retVal && BaseClass::EndTag(tag);
+	}
+
+	virtual bool ProcessData(void* data, int size) override
+	{
+		return (m_file.write(static_cast<const char*>(data), size) == size);
+	}
+
+private:
+	QFile m_file;
+	QList<quint32> m_endFieldPositions;
+};
+
+
 void CFileArchiveTest::BasicSerializationTest()
 {
 	// Create temporary file
@@ -212,6 +322,89 @@ void CFileArchiveTest::TagSkippingTest()
 }
 
 
+void CFileArchiveTest::SkipIndexTest_data()
+{
+	QTest::addColumn<bool>("serializeHeader");
+
+	QTest::newRow("with header") << true;
+	QTest::newRow("without header") << false;
+}
+
+
+void CFileArchiveTest::SkipIndexTest()
+{
+	QFETCH(bool, serializeHeader);
+
+	QTemporaryFile tempFile;
+	QVERIFY(tempFile.open());
+	QString filePath = tempFile.fileName();
+	tempFile.close();
+
+	{
+		SkippableModel writeModel;
+		writeModel.lastValue = 4242;
+
+		ifile::CFileWriteArchive writeArchive(filePath, NULL, true, serializeHeader);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	// read only first items of each group, the rest of the groups will be skipped
+	{
+		SkippableModel readModel;
+		readModel.readItemsCount = 3;
+
+		ifile::CFileReadArchive readArchive(filePath, true, serializeHeader);
+		QVERIFY(readModel.Serialize(readArchive));
+
+		QCOMPARE(readModel.readValues, QList<int>() << 0 << 1 << 2 << 1000 << 1001 << 1002);
+		QCOMPARE(readModel.lastValue, 4242);
+	}
+
+	// complete reading must be possible also without tag skipping
+	{
+		SkippableModel readModel;
+
+		ifile::CFileReadArchive readArchive(filePath, false, serializeHeader);
+		QVERIFY(readModel.Serialize(readArchive));
+
+		QCOMPARE(readModel.readValues.size(), 200);
+		QCOMPARE(readModel.lastValue, 4242);
+	}
+
+	QFile::remove(filePath);
+}
+
+
+void CFileArchiveTest::ClassicFormatCompatibilityTest()
+{
+	QTemporaryFile tempFile;
+	QVERIFY(tempFile.open());
+	QString filePath = tempFile.fileName();
+	tempFile.close();
+
+	{
+		SkippableModel writeModel;
+		writeModel.lastValue = 17;
+
+		CClassicFileWriteArchive writeArchive(filePath);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	{
+		SkippableModel readModel;
+		readModel.readItemsCount = 1;
+
+		ifile::CFileReadArchive readArchive(filePath);
+		QVERIFY(readModel.Serialize(readArchive));
+
+		QCOMPARE(readModel.readValues, QList<int>() << 0 << 1000);
+		QCOMPARE(readModel.lastValue, 17);
+	}
+
+	QFile::remove(filePath);
+}
+
+
 void CFileArchiveTest::InvalidFilePathTest()
 {
 	// Test writing to invalid path
@@ -221,6 +414,45 @@ void CFileArchiveTest::InvalidFilePathTest()
 }
 
 
+void CFileArchiveTest::CloseTest()
+{
+	// Create temporary file
+	QTemporaryFile tempFile;
+	QVERIFY(tempFile.open());
+	QString filePath = tempFile.fileName();
+	tempFile.close();
+
+	ifile::CFileWriteArchive writeArchive(filePath);
+	QVERIFY(writeArchive.IsArchiveValid());
+
+	SimpleModel writeModel;
+	writeModel.value = 42;
+	QVERIFY(writeModel.Serialize(writeArchive));
+
+	QVERIFY(writeArchive.Flush());
+	QVERIFY(writeArchive.Close());
+
+	// The file is complete before the archive destruction
+	{
+		ifile::CFileReadArchive readArchive(filePath);
+
+		SimpleModel readModel;
+		QVERIFY(readModel.Serialize(readArchive));
+		QCOMPARE(readModel.value, 42);
+	}
+
+	// No data can be written after closing
+	QVERIFY(!writeModel.Serialize(writeArchive));
+	QVERIFY(!writeArchive.Flush());
+	QVERIFY(writeArchive.Close());
+
+	ifile::CFileWriteArchive invalidArchive("/invalid/path/that/does/not/exist/test.dat");
+	QVERIFY(!invalidArchive.Close());
+
+	QFile::remove(filePath);
+}
+
+
 void CFileArchiveTest::OpenErrorDiagnosticTest()
 {
 	QTemporaryDir temporaryDirectory;
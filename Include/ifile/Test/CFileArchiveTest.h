@@ -19,7 +19,11 @@ private Q_SLOTS:
 	void PrimitiveTypesTest();
 	void StringSerializationTest();
 	void TagSkippingTest();
+	void SkipIndexTest_data();
+	void SkipIndexTest();
+	void ClassicFormatCompatibilityTest();
 	void InvalidFilePathTest();
+	void CloseTest();
 	void OpenErrorDiagnosticTest();
 	void MultipleObjectsTest();
 };
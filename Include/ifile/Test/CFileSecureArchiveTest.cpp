@@ -5,6 +5,7 @@
 // Qt includes
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 
 // ACF includes
 #include <ifile/CFileReadSecureArchive.h>
@@ -14,6 +15,7 @@
 #include <iser/ISerializable.h>
 #include <iser/IArchive.h>
 #include <iser/CArchiveTag.h>
+#include <iser/IVersionInfo.h>
 
 
 class SimpleModel: virtual public iser::ISerializable
@@ -317,6 +319,210 @@ void CFileSecureArchiveTest::MultipleObjectsSecureTest()
 }
 
 
+void CFileSecureArchiveTest::SimpleFormatCompatibilityTest()
+{
+	// Create temporary files
+	QTemporaryFile normalFile;
+	QVERIFY(normalFile.open());
+	QString normalPath = normalFile.fileName();
+	normalFile.close();
+
+	QTemporaryFile secureFile;
+	QVERIFY(secureFile.open());
+	QString securePath = secureFile.fileName();
+	secureFile.close();
+
+	ComplexModel writeModel;
+	writeModel.intValue = 321;
+	writeModel.doubleValue = 0.125;
+	writeModel.stringValue = "Simple format";
+
+	{
+		ifile::CFileWriteArchive normalArchive(normalPath);
+		QVERIFY(writeModel.Serialize(normalArchive));
+	}
+
+	// Data are written using the format of older versions by default
+	{
+		ifile::CFileWriteSecureArchive writeArchive(securePath);
+		QVERIFY(writeArchive.IsArchiveValid());
+		QCOMPARE(writeArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_SIMPLE);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	// The file layout is the same as of the not encoded file
+	QCOMPARE(QFileInfo(securePath).size(), QFileInfo(normalPath).size());
+
+	// The format is taken from the archive header on reading
+	{
+		ComplexModel readModel;
+		ifile::CFileReadSecureArchive readArchive(securePath);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_SIMPLE);
+
+		quint32 formatNumber = 0;
+		QVERIFY(!readArchive.GetVersionInfo().GetVersionNumber(iser::IVersionInfo::SecureFormatVersionId, formatNumber));
+
+		QVERIFY(readModel.Serialize(readArchive));
+		QVERIFY(readModel == writeModel);
+	}
+
+	{
+		ifile::CFileWriteSecureArchive writeArchive(securePath, NULL, true, true, ifile::CFileArchiveInfo::SF_CHACHA20);
+		QCOMPARE(writeArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_CHACHA20);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	{
+		ComplexModel readModel;
+		ifile::CFileReadSecureArchive readArchive(securePath);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_CHACHA20);
+
+		quint32 formatNumber = 0;
+		QVERIFY(readArchive.GetVersionInfo().GetVersionNumber(iser::IVersionInfo::SecureFormatVersionId, formatNumber));
+		QCOMPARE(formatNumber, quint32(ifile::CFileArchiveInfo::SF_CHACHA20));
+
+		QVERIFY(readModel.Serialize(readArchive));
+		QVERIFY(readModel == writeModel);
+	}
+
+	// Clean up
+	QFile::remove(normalPath);
+	QFile::remove(securePath);
+}
+
+
+void CFileSecureArchiveTest::FormatVersionInfoTest()
+{
+	// Create temporary files
+	QTemporaryFile chaChaFile;
+	QVERIFY(chaChaFile.open());
+	QString chaChaPath = chaChaFile.fileName();
+	chaChaFile.close();
+
+	QTemporaryFile simpleFile;
+	QVERIFY(simpleFile.open());
+	QString simplePath = simpleFile.fileName();
+	simpleFile.close();
+
+	ComplexModel writeModel;
+	writeModel.intValue = 654;
+	writeModel.doubleValue = 0.5;
+	writeModel.stringValue = "Format version";
+
+	{
+		ifile::CFileWriteSecureArchive writeArchive(chaChaPath, NULL, true, true, ifile::CFileArchiveInfo::SF_CHACHA20);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	// Version info of the read archive contains the format entry, it must not be taken over by the written archive
+	{
+		ifile::CFileReadSecureArchive readArchive(chaChaPath);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_CHACHA20);
+
+		ifile::CFileWriteSecureArchive writeArchive(simplePath, &readArchive.GetVersionInfo());
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	{
+		ComplexModel readModel;
+		ifile::CFileReadSecureArchive readArchive(simplePath);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_SIMPLE);
+		QVERIFY(readModel.Serialize(readArchive));
+		QVERIFY(readModel == writeModel);
+	}
+
+	// Without the archive header the format is recognized by the secure header
+	{
+		ifile::CFileWriteSecureArchive writeArchive(chaChaPath, NULL, true, false, ifile::CFileArchiveInfo::SF_CHACHA20);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	{
+		ComplexModel readModel;
+		ifile::CFileReadSecureArchive readArchive(chaChaPath, true, false);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_CHACHA20);
+		QVERIFY(readModel.Serialize(readArchive));
+		QVERIFY(readModel == writeModel);
+	}
+
+	{
+		ifile::CFileWriteSecureArchive writeArchive(simplePath, NULL, true, false);
+		QVERIFY(writeModel.Serialize(writeArchive));
+	}
+
+	{
+		ComplexModel readModel;
+		ifile::CFileReadSecureArchive readArchive(simplePath, true, false);
+		QCOMPARE(readArchive.GetSecureFormat(), ifile::CFileArchiveInfo::SF_SIMPLE);
+		QVERIFY(readModel.Serialize(readArchive));
+		QVERIFY(readModel == writeModel);
+	}
+
+	// Clean up
+	QFile::remove(chaChaPath);
+	QFile::remove(simplePath);
+}
+
+
+void CFileSecureArchiveTest::TagSkippingSecureTest()
+{
+	static iser::CArchiveTag groupTag("Group", "Skippable group", iser::CArchiveTag::TT_GROUP, NULL, true);
+	static iser::CArchiveTag nameTag("Name", "Name", iser::CArchiveTag::TT_LEAF);
+
+	// Create temporary file
+	QTemporaryFile tempFile;
+	QVERIFY(tempFile.open());
+	QString filePath = tempFile.fileName();
+	tempFile.close();
+
+	{
+		ifile::CFileWriteSecureArchive writeArchive(filePath, NULL, true, true, ifile::CFileArchiveInfo::SF_CHACHA20);
+		QVERIFY(writeArchive.IsArchiveValid());
+
+		for (int groupIndex = 0; groupIndex < 3; ++groupIndex){
+			QVERIFY(writeArchive.BeginTag(groupTag));
+
+			int value = groupIndex;
+			QVERIFY(writeArchive.Process(value));
+
+			QString text = QString("Skipped text %1").arg(groupIndex).repeated(100);
+			QVERIFY(writeArchive.Process(text));
+
+			QVERIFY(writeArchive.EndTag(groupTag));
+		}
+
+		QString name = "Last";
+		QVERIFY(writeArchive.BeginTag(nameTag));
+		QVERIFY(writeArchive.Process(name));
+		QVERIFY(writeArchive.EndTag(nameTag));
+	}
+
+	// Read only the first value of each group, the rest is skipped
+	{
+		ifile::CFileReadSecureArchive readArchive(filePath);
+
+		for (int groupIndex = 0; groupIndex < 3; ++groupIndex){
+			QVERIFY(readArchive.BeginTag(groupTag));
+
+			int value = -1;
+			QVERIFY(readArchive.Process(value));
+			QCOMPARE(value, groupIndex);
+
+			QVERIFY(readArchive.EndTag(groupTag));
+		}
+
+		QString name;
+		QVERIFY(readArchive.BeginTag(nameTag));
+		QVERIFY(readArchive.Process(name));
+		QVERIFY(readArchive.EndTag(nameTag));
+		QCOMPARE(name, QString("Last"));
+	}
+
+	// Clean up
+	QFile::remove(filePath);
+}
+
+
 I_ADD_TEST(CFileSecureArchiveTest);
 
 
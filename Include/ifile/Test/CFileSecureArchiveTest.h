@@ -21,6 +21,9 @@ private Q_SLOTS:
 	void SecureArchiveIntegrityTest();
 	void CompareSecureVsNormalTest();
 	void MultipleObjectsSecureTest();
+	void SimpleFormatCompatibilityTest();
+	void FormatVersionInfoTest();
+	void TagSkippingSecureTest();
 };
 
 
@@ -0,0 +1,355 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/Test/CMappedFileReadArchiveTest.h>
+
+
+// STL includes
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QFile>
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+#include <ifile/CFileReadArchive.h>
+#include <ifile/CFileWriteArchive.h>
+#include <ifile/CMappedFileReadArchive.h>
+
+
+namespace
+{
+
+
+static const int s_chunkValuesCount = 1024 * 1024;
+
+static const iser::CArchiveTag s_chunkTag("Chunk", "Chunk of values", iser::CArchiveTag::TT_GROUP, NULL, true);
+static const iser::CArchiveTag s_nameTag("Name", "Name of the data", iser::CArchiveTag::TT_LEAF);
+static const iser::CArchiveTag s_countTag("Count", "Number of values", iser::CArchiveTag::TT_LEAF);
+
+
+enum ReaderType
+{
+	RT_FILE,
+	RT_MAPPED,
+	RT_MAPPED_SPAN
+};
+
+
+bool WriteChunks(iser::IArchive& archive, int chunksCount)
+{
+	QVector<double> values(s_chunkValuesCount);
+
+	bool retVal = true;
+
+	for (int chunkIndex = 0; chunkIndex < chunksCount; ++chunkIndex){
+		for (int i = 0; i < s_chunkValuesCount; ++i){
+			values[i] = chunkIndex + i * 0.25;
+		}
+
+		int count = values.size();
+
+		retVal = retVal && archive.BeginTag(s_chunkTag);
+		retVal = retVal && archive.Process(count);
+		retVal = retVal && archive.ProcessData(values.data(), count * int(sizeof(double)));
+		retVal = retVal && archive.EndTag(s_chunkTag);
+	}
+
+	return retVal;
+}
+
+
+/**
+	Read all chunks, the values are copied to the destination buffer.
+*/
+bool ReadChunks(iser::IArchive& archive, int chunksCount, QVector<double>& values)
+{
+	bool retVal = true;
+
+	for (int chunkIndex = 0; retVal && (chunkIndex < chunksCount); ++chunkIndex){
+		int count = 0;
+
+		retVal = retVal && archive.BeginTag(s_chunkTag);
+		retVal = retVal && archive.Process(count);
+
+		values.resize(count);
+
+		retVal = retVal && archive.ProcessData(values.data(), count * int(sizeof(double)));
+		retVal = retVal && archive.EndTag(s_chunkTag);
+	}
+
+	return retVal;
+}
+
+
+/**
+	Read all chunks without copying, only the first value of each chunk is accessed.
+*/
+bool ReadChunkSpans(ifile::CMappedFileReadArchive& archive, int chunksCount, double& checkSum)
+{
+	bool retVal = true;
+
+	for (int chunkIndex = 0; retVal && (chunkIndex < chunksCount); ++chunkIndex){
+		int count = 0;
+
+		retVal = retVal && archive.BeginTag(s_chunkTag);
+		retVal = retVal && archive.Process(count);
+
+		const void* valuesPtr = archive.ProcessSpan(qint64(count) * qint64(sizeof(double)));
+		if (valuesPtr != NULL){
+			double firstValue;
+			std::memcpy(&firstValue, valuesPtr, sizeof(double));
+
+			checkSum += firstValue;
+		}
+		else{
+			retVal = false;
+		}
+
+		retVal = retVal && archive.EndTag(s_chunkTag);
+	}
+
+	return retVal;
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CMappedFileReadArchiveTest::initTestCase()
+{
+	QVERIFY(m_tempDir.isValid());
+}
+
+
+void CMappedFileReadArchiveTest::ReadCompatibilityTest()
+{
+	QString filePath = m_tempDir.filePath("Compatibility.dat");
+
+	QString name = "Mapped archive test äöü";
+	QVector<double> values(1000);
+	for (int i = 0; i < values.size(); ++i){
+		values[i] = i * 1.5;
+	}
+
+	{
+		ifile::CFileWriteArchive writeArchive(filePath);
+		QVERIFY(writeArchive.IsArchiveValid());
+
+		int count = values.size();
+
+		QVERIFY(writeArchive.BeginTag(s_nameTag));
+		QVERIFY(writeArchive.Process(name));
+		QVERIFY(writeArchive.EndTag(s_nameTag));
+
+		QVERIFY(writeArchive.BeginTag(s_countTag));
+		QVERIFY(writeArchive.Process(count));
+		QVERIFY(writeArchive.EndTag(s_countTag));
+
+		QVERIFY(writeArchive.ProcessArray(values.data(), values.size()));
+	}
+
+	ifile::CMappedFileReadArchive readArchive(filePath);
+	QVERIFY(readArchive.IsOpen());
+
+	QString readName;
+	int readCount = 0;
+
+	QVERIFY(readArchive.BeginTag(s_nameTag));
+	QVERIFY(readArchive.Process(readName));
+	QVERIFY(readArchive.EndTag(s_nameTag));
+
+	QVERIFY(readArchive.BeginTag(s_countTag));
+	QVERIFY(readArchive.Process(readCount));
+	QVERIFY(readArchive.EndTag(s_countTag));
+
+	QCOMPARE(readName, name);
+	QCOMPARE(readCount, values.size());
+
+	QVector<double> readValues(readCount);
+	QVERIFY(readArchive.ProcessArray(readValues.data(), readValues.size()));
+	QCOMPARE(readValues, values);
+}
+
+
+void CMappedFileReadArchiveTest::ProcessSpanTest()
+{
+	QString filePath = m_tempDir.filePath("Span.dat");
+
+	QByteArray data(4096, '\0');
+	for (int i = 0; i < data.size(); ++i){
+		data[i] = char(i % 251);
+	}
+
+	{
+		ifile::CFileWriteArchive writeArchive(filePath, NULL, false);
+		QVERIFY(writeArchive.ProcessData(data.data(), data.size()));
+	}
+
+	ifile::CMappedFileReadArchive readArchive(filePath, false);
+	QVERIFY(readArchive.IsOpen());
+	QCOMPARE(readArchive.GetAvailableSize(), qint64(data.size()));
+
+	const void* spanPtr = readArchive.ProcessSpan(1000);
+	QVERIFY(spanPtr != NULL);
+	QVERIFY(std::memcmp(spanPtr, data.constData(), 1000) == 0);
+	QCOMPARE(readArchive.GetAvailableSize(), qint64(data.size() - 1000));
+
+	// span outside of the data is not allowed and doesn't change the position
+	QVERIFY(readArchive.ProcessSpan(data.size()) == NULL);
+	QCOMPARE(readArchive.GetAvailableSize(), qint64(data.size() - 1000));
+
+	spanPtr = readArchive.ProcessSpan(data.size() - 1000);
+	QVERIFY(spanPtr != NULL);
+	QVERIFY(std::memcmp(spanPtr, data.constData() + 1000, data.size() - 1000) == 0);
+
+	char value = 0;
+	QVERIFY(!readArchive.Process(value));
+}
+
+
+void CMappedFileReadArchiveTest::TagSkippingTest()
+{
+	QString filePath = m_tempDir.filePath("Skipping.dat");
+
+	{
+		ifile::CFileWriteArchive writeArchive(filePath);
+		QVERIFY(WriteChunks(writeArchive, 3));
+
+		QString name = "Last";
+		QVERIFY(writeArchive.BeginTag(s_nameTag));
+		QVERIFY(writeArchive.Process(name));
+		QVERIFY(writeArchive.EndTag(s_nameTag));
+	}
+
+	ifile::CMappedFileReadArchive readArchive(filePath);
+	QVERIFY(readArchive.IsOpen());
+
+	// read only the value count of each chunk, the values are skipped
+	for (int chunkIndex = 0; chunkIndex < 3; ++chunkIndex){
+		int count = 0;
+		QVERIFY(readArchive.BeginTag(s_chunkTag));
+		QVERIFY(readArchive.Process(count));
+		QCOMPARE(count, s_chunkValuesCount);
+
+		double firstValue = 0;
+		QVERIFY(readArchive.Process(firstValue));
+		QCOMPARE(firstValue, double(chunkIndex));
+
+		QVERIFY(readArchive.EndTag(s_chunkTag));
+	}
+
+	QString name;
+	QVERIFY(readArchive.BeginTag(s_nameTag));
+	QVERIFY(readArchive.Process(name));
+	QVERIFY(readArchive.EndTag(s_nameTag));
+	QCOMPARE(name, QString("Last"));
+}
+
+
+void CMappedFileReadArchiveTest::InvalidFileTest()
+{
+	ifile::CMappedFileReadArchive readArchive(m_tempDir.filePath("NotExisting.dat"));
+	QVERIFY(!readArchive.IsOpen());
+
+	int value = 0;
+	QVERIFY(!readArchive.Process(value));
+}
+
+
+void CMappedFileReadArchiveTest::ReadBenchmark_data()
+{
+	QTest::addColumn<int>("megaBytes");
+	QTest::addColumn<int>("readerType");
+
+	QTest::newRow("100 MB, file") << 100 << int(RT_FILE);
+	QTest::newRow("100 MB, mapped") << 100 << int(RT_MAPPED);
+	QTest::newRow("100 MB, mapped span") << 100 << int(RT_MAPPED_SPAN);
+	QTest::newRow("2 GB, file") << 2048 << int(RT_FILE);
+	QTest::newRow("2 GB, mapped") << 2048 << int(RT_MAPPED);
+	QTest::newRow("2 GB, mapped span") << 2048 << int(RT_MAPPED_SPAN);
+}
+
+
+void CMappedFileReadArchiveTest::ReadBenchmark()
+{
+	QFETCH(int, megaBytes);
+	QFETCH(int, readerType);
+
+	if ((megaBytes > 100) && qEnvironmentVariableIsEmpty("ACF_LARGE_FILE_BENCHMARKS")){
+		QSKIP("Large file benchmarks are disabled, set ACF_LARGE_FILE_BENCHMARKS to enable them");
+	}
+
+	QString filePath = GetLargeFilePath(megaBytes);
+	QVERIFY(!filePath.isEmpty());
+
+	int chunksCount = megaBytes / int(s_chunkValuesCount * sizeof(double) / (1024 * 1024));
+
+	QVector<double> values;
+	double checkSum = 0;
+
+	bool retVal = true;
+
+	QBENCHMARK{
+		if (readerType == RT_FILE){
+			ifile::CFileReadArchive readArchive(filePath);
+
+			retVal = retVal && ReadChunks(readArchive, chunksCount, values);
+		}
+		else if (readerType == RT_MAPPED){
+			ifile::CMappedFileReadArchive readArchive(filePath);
+
+			retVal = retVal && ReadChunks(readArchive, chunksCount, values);
+		}
+		else{
+			ifile::CMappedFileReadArchive readArchive(filePath);
+
+			retVal = retVal && ReadChunkSpans(readArchive, chunksCount, checkSum);
+		}
+	}
+
+	QVERIFY(retVal);
+}
+
+
+void CMappedFileReadArchiveTest::cleanupTestCase()
+{
+	m_largeFilePaths.clear();
+}
+
+
+// private methods
+
+QString CMappedFileReadArchiveTest::GetLargeFilePath(int megaBytes)
+{
+	QMap<int, QString>::ConstIterator foundIter = m_largeFilePaths.constFind(megaBytes);
+	if (foundIter != m_largeFilePaths.constEnd()){
+		return foundIter.value();
+	}
+
+	QString filePath = m_tempDir.filePath(QString("Large%1.dat").arg(megaBytes));
+
+	int chunksCount = megaBytes / int(s_chunkValuesCount * sizeof(double) / (1024 * 1024));
+
+	bool retVal = false;
+	{
+		ifile::CFileWriteArchive writeArchive(filePath);
+
+		retVal = writeArchive.IsArchiveValid() && WriteChunks(writeArchive, chunksCount);
+	}
+
+	if (!retVal){
+		QFile::remove(filePath);
+
+		return QString();
+	}
+
+	m_largeFilePaths[megaBytes] = filePath;
+
+	return filePath;
+}
+
+
+I_ADD_TEST(CMappedFileReadArchiveTest);
+
+
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QMap>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Tests of the memory mapped file archive and benchmark of reading large files compared to \c ifile::CFileReadArchive.
+	The benchmark rows for 2 GB files are executed only if environment variable \c ACF_LARGE_FILE_BENCHMARKS is set.
+*/
+class CMappedFileReadArchiveTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void ReadCompatibilityTest();
+	void ProcessSpanTest();
+	void TagSkippingTest();
+	void InvalidFileTest();
+
+	void ReadBenchmark_data();
+	void ReadBenchmark();
+
+	void cleanupTestCase();
+
+private:
+	/**
+		Get path of file with large array data, the file will be created on demand.
+	*/
+	QString GetLargeFilePath(int megaBytes);
+
+	QTemporaryDir m_tempDir;
+	QMap<int, QString> m_largeFilePaths;
+};
+
+
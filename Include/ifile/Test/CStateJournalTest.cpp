@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ifile/Test/CStateJournalTest.h>
+
+
+// Qt includes
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+// ACF includes
+#include <ifile/CStateJournal.h>
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+static const int s_benchmarkStateSize = 16 * 1024 * 1024;
+
+
+QByteArray CreateState(int size)
+{
+	return itest::CRandomDataGenerator().CreateData(size);
+}
+
+
+/**
+	Change small part of the state, like a single parameter change.
+*/
+void ChangeState(QByteArray& state, int changeIndex)
+{
+	int position = (changeIndex * 7919) % (state.size() - 16);
+
+	state.replace(position, 16, QByteArray::number(changeIndex).rightJustified(16, '#'));
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CStateJournalTest::initTestCase()
+{
+	QVERIFY(m_tempDir.isValid());
+}
+
+
+void CStateJournalTest::AppendReplayTest()
+{
+	QString filePath = m_tempDir.filePath("AppendReplay.journal");
+
+	QByteArray state = CreateState(100000);
+
+	{
+		ifile::CStateJournal journal(filePath);
+		QVERIFY(!journal.IsValid());
+
+		// the journal must be started with complete state
+		QVERIFY(!journal.Append(state));
+
+		QVERIFY(journal.Reset(state));
+		QVERIFY(journal.IsValid());
+		QCOMPARE(journal.GetDeltasSize(), qint64(0));
+
+		for (int i = 0; i < 10; ++i){
+			ChangeState(state, i);
+
+			QVERIFY(journal.Append(state));
+		}
+
+		// only the changes are written
+		QVERIFY(journal.GetDeltasSize() < 1000);
+		QVERIFY(QFileInfo(filePath).size() < state.size() + 1000);
+	}
+
+	ifile::CStateJournal journal(filePath);
+	QVERIFY(journal.Replay());
+	QVERIFY(journal.IsValid());
+	QCOMPARE(journal.GetLastState(), state);
+
+	// the replayed journal can be continued
+	ChangeState(state, 10);
+	QVERIFY(journal.Append(state));
+
+	ifile::CStateJournal continuedJournal(filePath);
+	QVERIFY(continuedJournal.Replay());
+	QCOMPARE(continuedJournal.GetLastState(), state);
+}
+
+
+void CStateJournalTest::DamagedRecordTest()
+{
+	QString filePath = m_tempDir.filePath("Damaged.journal");
+
+	QByteArray state = CreateState(10000);
+
+	ifile::CStateJournal journal(filePath);
+	QVERIFY(journal.Reset(state));
+
+	ChangeState(state, 1);
+	QVERIFY(journal.Append(state));
+
+	QByteArray lastValidState = state;
+	qint64 validSize = QFileInfo(filePath).size();
+
+	ChangeState(state, 2);
+	QVERIFY(journal.Append(state));
+
+	// simulate crash during writing of the last record
+	QVERIFY(QFile::resize(filePath, QFileInfo(filePath).size() - 3));
+
+	ifile::CStateJournal replayedJournal(filePath);
+	QVERIFY(replayedJournal.Replay());
+	QCOMPARE(replayedJournal.GetLastState(), lastValidState);
+
+	// damaged end was removed
+	QCOMPARE(QFileInfo(filePath).size(), validSize);
+
+	QVERIFY(replayedJournal.Append(state));
+
+	ifile::CStateJournal continuedJournal(filePath);
+	QVERIFY(continuedJournal.Replay());
+	QCOMPARE(continuedJournal.GetLastState(), state);
+}
+
+
+void CStateJournalTest::ResetTest()
+{
+	QString filePath = m_tempDir.filePath("Reset.journal");
+
+	QByteArray state = CreateState(10000);
+
+	ifile::CStateJournal journal(filePath);
+	QVERIFY(journal.Reset(state));
+
+	for (int i = 0; i < 5; ++i){
+		ChangeState(state, i);
+
+		QVERIFY(journal.Append(state));
+	}
+
+	QVERIFY(journal.GetDeltasSize() > 0);
+
+	QByteArray newState = CreateState(5000);
+	QVERIFY(journal.Reset(newState));
+	QCOMPARE(journal.GetDeltasSize(), qint64(0));
+
+	ifile::CStateJournal replayedJournal(filePath);
+	QVERIFY(replayedJournal.Replay());
+	QCOMPARE(replayedJournal.GetLastState(), newState);
+
+	QVERIFY(journal.Remove());
+	QVERIFY(!QFile::exists(filePath));
+	QVERIFY(!journal.IsValid());
+}
+
+
+void CStateJournalTest::InvalidJournalTest()
+{
+	ifile::CStateJournal notExistingJournal(m_tempDir.filePath("NotExisting.journal"));
+	QVERIFY(!notExistingJournal.Replay());
+	QVERIFY(!notExistingJournal.IsValid());
+
+	QString filePath = m_tempDir.filePath("Invalid.journal");
+
+	QFile file(filePath);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	QVERIFY(file.write(CreateState(1000)) == 1000);
+	file.close();
+
+	ifile::CStateJournal journal(filePath);
+	QVERIFY(!journal.Replay());
+	QVERIFY(!journal.IsValid());
+}
+
+
+void CStateJournalTest::BaseFileTest()
+{
+	QString baseFilePath = m_tempDir.filePath("Base.dat");
+	QString filePath = m_tempDir.filePath("Base.journal");
+
+	QByteArray state = CreateState(10000);
+
+	QFile baseFile(baseFilePath);
+	QVERIFY(baseFile.open(QIODevice::WriteOnly));
+	QVERIFY(baseFile.write(state) == state.size());
+	baseFile.close();
+
+	ifile::CStateJournal journal(filePath);
+	journal.SetBaseFilePath(baseFilePath);
+	QVERIFY(journal.Reset(state));
+	QVERIFY(!journal.IsBaseFileChanged());
+
+	ChangeState(state, 1);
+	QVERIFY(journal.Append(state));
+
+	{
+		ifile::CStateJournal replayedJournal(filePath);
+		replayedJournal.SetBaseFilePath(baseFilePath);
+		QVERIFY(replayedJournal.Replay());
+		QCOMPARE(replayedJournal.GetLastState(), state);
+	}
+
+	// base file is stored with the last state, the journal must be bound to its new version
+	QVERIFY(baseFile.open(QIODevice::WriteOnly));
+	QVERIFY(baseFile.write(state + "new") == state.size() + 3);
+	baseFile.close();
+
+	QVERIFY(journal.IsBaseFileChanged());
+	QVERIFY(journal.UpdateBaseFileStamp());
+	QVERIFY(!journal.IsBaseFileChanged());
+
+	ChangeState(state, 2);
+	QVERIFY(journal.Append(state));
+
+	{
+		ifile::CStateJournal replayedJournal(filePath);
+		replayedJournal.SetBaseFilePath(baseFilePath);
+		QVERIFY(replayedJournal.Replay());
+		QCOMPARE(replayedJournal.GetLastState(), state);
+	}
+
+	// base file was changed after the journal, the outdated journal is discarded
+	QVERIFY(baseFile.open(QIODevice::WriteOnly));
+	QVERIFY(baseFile.write("external edit") > 0);
+	baseFile.close();
+
+	ifile::CStateJournal outdatedJournal(filePath);
+	outdatedJournal.SetBaseFilePath(baseFilePath);
+	QVERIFY(!outdatedJournal.Replay());
+	QVERIFY(!outdatedJournal.IsValid());
+	QVERIFY(!QFile::exists(filePath));
+}
+
+
+void CStateJournalTest::StoreBenchmark_data()
+{
+	QTest::addColumn<bool>("useJournal");
+
+	QTest::newRow("Complete file") << false;
+	QTest::newRow("Journal") << true;
+}
+
+
+void CStateJournalTest::StoreBenchmark()
+{
+	QFETCH(bool, useJournal);
+
+	QString filePath = m_tempDir.filePath(useJournal? "Benchmark.journal": "Benchmark.dat");
+
+	QByteArray state = CreateState(s_benchmarkStateSize);
+
+	ifile::CStateJournal journal(filePath);
+	QVERIFY(journal.Reset(state));
+
+	int changeIndex = 0;
+	bool retVal = true;
+
+	QBENCHMARK{
+		ChangeState(state, changeIndex++);
+
+		if (useJournal){
+			retVal = retVal && journal.Append(state);
+		}
+		else{
+			QSaveFile saveFile(filePath);
+
+			retVal = retVal && saveFile.open(QIODevice::WriteOnly);
+			retVal = retVal && (saveFile.write(state) == state.size());
+			retVal = retVal && saveFile.commit();
+		}
+	}
+
+	QVERIFY(retVal);
+}
+
+
+I_ADD_TEST(CStateJournalTest);
+
+
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Tests of the object state journal used by \c ifile::CAutoPersistenceComp and benchmark of appending compared to complete storing.
+*/
+class CStateJournalTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void AppendReplayTest();
+	void DamagedRecordTest();
+	void ResetTest();
+	void InvalidJournalTest();
+	void BaseFileTest();
+
+	void StoreBenchmark_data();
+	void StoreBenchmark();
+
+private:
+	QTemporaryDir m_tempDir;
+};
+
+
@@ -3,5 +3,7 @@ TARGET = ifileTest
 include(../../../../Config/QMake/TestConfig.pri)
 include(../../../../Config/QMake/QtBaseConfig.pri)
 
+QT += concurrent
+
 LIBS += -litest -licomp -lifile -lilog -liser -limod -listd
 
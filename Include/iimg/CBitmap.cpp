@@ -3,7 +3,7 @@
 
 
 // STL includes
-#include <cstring>// include std::memcpy
+#include <limits>
 
 // Qt includes
 #include <QtCore/QVector>
@@ -15,6 +15,7 @@
 #include <istd/CClassInfo.h>
 #include <icmm/CRgbColorModel.h>
 #include <icmm/CRgbaColorModel.h>
+#include <iimg/CPixelFormatConverter.h>
 
 
 namespace iimg
@@ -23,61 +24,6 @@ namespace iimg
 
 // global functions
 
-template <typename PixelType, typename WorkingType>
-bool ConvertToGrayImage(const IBitmap& inputBitmap, CBitmap& outputBitmap)
-{
-	istd::CIndex2d size = inputBitmap.GetImageSize();
-
-	if (outputBitmap.CreateBitmap(IBitmap::PF_GRAY, size)){
-		// do not copy empty image
-		if (size.IsSizeEmpty()){
-			return true;
-		}
-
-		PixelType minValue = std::numeric_limits<PixelType>::max();
-		PixelType maxValue = std::numeric_limits<PixelType>::lowest();
-
-		for (int y = 0; y < size.GetY(); ++y){
-			const PixelType* inputLinePtr = (const PixelType*)inputBitmap.GetLinePtr(y);
-
-			for (int x = 0; x < size.GetX(); ++x){
-				PixelType value = inputLinePtr[x];
-
-				if (!std::isnan(double(value))){
-					if (value < minValue){
-						minValue = value;
-					}
-
-					if (value > maxValue){
-						maxValue = value;
-					}
-				}
-			}
-		}
-
-		if (maxValue > minValue){
-			for (int y = 0; y < size.GetY(); ++y){
-				const PixelType* inputLinePtr = (const PixelType*)inputBitmap.GetLinePtr(y);
-				uint8_t* outputLinePtr = (uint8_t*)outputBitmap.GetLinePtr(y);
-
-				for (int x = 0; x < size.GetX(); ++x){
-					WorkingType value = inputLinePtr[x];
-
-					outputLinePtr[x] = uint8_t(255 * (value - minValue) / (maxValue - minValue));
-				}
-			}
-		}
-		else{
-			outputBitmap.ClearImage();
-		}
-
-		return true;
-	}
-
-	return false;
-}
-
-
 bool ConvertXyToRgb(const IBitmap& inputBitmap, CBitmap& outputBitmap)
 {
 	if (inputBitmap.GetPixelFormat() != IBitmap::PF_XY32){
@@ -496,50 +442,39 @@ bool CBitmap::CopyFrom(const istd::IChangeable& object, CompatibilityMode /*mode
 		return true;
 	}
 	else{
-		istd::CIndex2d size = sourcePtr->GetImageSize();
-
 		iimg::IBitmap::PixelFormat pixelFormat = sourcePtr->GetPixelFormat();
-		if (IsFormatSupported(pixelFormat)){
-			if (CreateBitmap(pixelFormat, size)){
-				// do not copy empty image
-				if (size.IsSizeEmpty()){
-					return true;
-				}
 
-				int lineBytesCount = qMin(GetLineBytesCount(), sourcePtr->GetLineBytesCount());
-				Q_ASSERT(lineBytesCount >= 0);
-				if (lineBytesCount <= 0){
-					return false;
-				}
+		switch (pixelFormat){
+		case PF_XYZ32:
+			return ConvertXyzToRgb(*sourcePtr, *this);
 
-				for (int y = 0; y < size.GetY(); ++y){
-					std::memcpy(GetLinePtr(y), sourcePtr->GetLinePtr(y), lineBytesCount);
-				}
+		case PF_XY32:
+			return ConvertXyToRgb(*sourcePtr, *this);
 
-				return true;
-			}
+		default:
+			break;
 		}
-		else{
-			switch (pixelFormat){
-			case PF_FLOAT32:
-				return ConvertToGrayImage<float, float>(*sourcePtr, *this);
-
-			case PF_FLOAT64:
-				return ConvertToGrayImage<double, double>(*sourcePtr, *this);
 
-			case PF_GRAY32:
-				return ConvertToGrayImage<quint32, quint64>(*sourcePtr, *this);
-
-			case PF_XYZ32:
-				return ConvertXyzToRgb(*sourcePtr, *this);
+		iimg::IBitmap::PixelFormat destFormat = CalcConvertedFormat(pixelFormat);
+		if (destFormat == PF_UNKNOWN){
+			return false;
+		}
 
-			case PF_XY32:
-				return ConvertXyToRgb(*sourcePtr, *this);
+		CPixelFormatConverter::ValueMapping mapping;
 
-			default:
-				break;
+		// values without fixed range are stretched to the whole range of gray values
+		if ((destFormat != pixelFormat) && ((pixelFormat == PF_GRAY32) || (pixelFormat == PF_FLOAT32) || (pixelFormat == PF_FLOAT64))){
+			double minValue = 0;
+			double maxValue = 0;
+			if (CPixelFormatConverter::CalcValueRange(*sourcePtr, minValue, maxValue)){
+				mapping = CPixelFormatConverter::ValueMapping::FromRange(minValue, maxValue);
+			}
+			else{
+				mapping = CPixelFormatConverter::ValueMapping(0.0, 0.0);
 			}
 		}
+
+		return CPixelFormatConverter::ConvertBitmap(*sourcePtr, destFormat, *this, mapping);
 	}
 
 	return false;
@@ -568,6 +503,30 @@ bool CBitmap::ResetData(CompatibilityMode /*mode*/)
 
 // protected methods
 
+iimg::IBitmap::PixelFormat CBitmap::CalcConvertedFormat(PixelFormat sourceFormat) const
+{
+	if (IsFormatSupported(sourceFormat)){
+		return sourceFormat;
+	}
+
+	switch (sourceFormat){
+	case PF_GRAY32:
+	case PF_FLOAT32:
+	case PF_FLOAT64:
+		return PF_GRAY;
+
+	case PF_RGB48:
+		return PF_RGB;
+
+	case PF_RGBA64:
+		return PF_RGBA;
+
+	default:
+		return PF_UNKNOWN;
+	}
+}
+
+
 QImage::Format CBitmap::CalcQtFormat(PixelFormat pixelFormat) const
 {
 	switch (pixelFormat){
@@ -67,6 +67,11 @@ public:
 	virtual bool ResetData(CompatibilityMode mode = CM_WITHOUT_REFS) override;
 
 protected:
+	/**
+		Get format used for conversion of bitmaps with given format.
+		For supported formats it is the same format, unsupported formats are converted to the nearest supported one.
+	*/
+	PixelFormat CalcConvertedFormat(PixelFormat sourceFormat) const;
 	QImage::Format CalcQtFormat(PixelFormat pixelFormat) const;
 	PixelFormat CalcFromQtFormat(QImage::Format imageFormat) const;
 	bool SetQImage(const QImage& image);
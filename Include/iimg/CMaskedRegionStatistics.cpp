@@ -0,0 +1,723 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <iimg/CMaskedRegionStatistics.h>
+
+
+// STL includes
+#include <limits>
+#include <type_traits>
+
+// Qt includes
+#include <QtCore/qmath.h>
+#include <QtCore/qnumeric.h>
+
+// ACF includes
+#include <iimg/TMaskedRegionProcessor.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define ACF_PIXEL_SSE2
+	#include <emmintrin.h>
+#endif
+
+
+namespace iimg
+{
+
+
+namespace
+{
+
+
+/**
+	Pixel consisting of components of the same type.
+*/
+template <typename ComponentType, int ComponentsCount>
+struct TPixel
+{
+	ComponentType components[ComponentsCount];
+};
+
+
+/**
+	Integer components up to 16 bits are summed exactly, other components are summed as floating point values.
+*/
+template <typename ComponentType>
+struct TIsSmallInteger: public std::integral_constant<bool, std::numeric_limits<ComponentType>::is_integer && (sizeof(ComponentType) <= 2)>
+{
+};
+
+
+/**
+	Get pointer to the evaluated component of the first pixel.
+*/
+template <typename ComponentType, int ComponentsCount>
+inline const ComponentType* GetComponentPtr(const TPixel<ComponentType, ComponentsCount>* pixelsPtr, int componentIndex)
+{
+	return reinterpret_cast<const ComponentType*>(pixelsPtr) + componentIndex;
+}
+
+
+/**
+	Summary of a set of values, summaries of disjoint sets are merged using the pairwise variance update of Chan et al.
+*/
+struct ValuesSummary
+{
+	ValuesSummary()
+	:	count(0),
+		minValue(0),
+		maxValue(0),
+		mean(0),
+		squaredDeviationsSum(0)
+	{
+	}
+
+	void Merge(qint64 otherCount, double otherMinValue, double otherMaxValue, double otherMean, double otherSquaredDeviationsSum)
+	{
+		if (otherCount <= 0){
+			return;
+		}
+
+		if (count <= 0){
+			count = otherCount;
+			minValue = otherMinValue;
+			maxValue = otherMaxValue;
+			mean = otherMean;
+			squaredDeviationsSum = otherSquaredDeviationsSum;
+
+			return;
+		}
+
+		const qint64 mergedCount = count + otherCount;
+		const double delta = otherMean - mean;
+
+		mean += delta * otherCount / mergedCount;
+		squaredDeviationsSum += otherSquaredDeviationsSum + delta * delta * (double(count) * otherCount / mergedCount);
+		minValue = qMin(minValue, otherMinValue);
+		maxValue = qMax(maxValue, otherMaxValue);
+		count = mergedCount;
+	}
+
+	void Merge(const ValuesSummary& summary)
+	{
+		Merge(summary.count, summary.minValue, summary.maxValue, summary.mean, summary.squaredDeviationsSum);
+	}
+
+	qint64 count;
+	double minValue;
+	double maxValue;
+	double mean;
+	double squaredDeviationsSum;
+};
+
+
+/**
+	Exact sums of integer values of a run.
+*/
+struct IntegerRunSums
+{
+	quint64 sum;
+	quint64 squaresSum;
+	quint32 minValue;
+	quint32 maxValue;
+};
+
+
+template <typename ComponentType, int Stride>
+void CalcIntegerRunSums(const ComponentType* valuesPtr, int count, IntegerRunSums& sums)
+{
+	quint64 sum = 0;
+	quint64 squaresSum = 0;
+	quint32 minValue = valuesPtr[0];
+	quint32 maxValue = valuesPtr[0];
+
+	for (int index = 0; index < count; ++index){
+		const quint32 value = valuesPtr[index * Stride];
+
+		sum += value;
+		squaresSum += quint64(value) * value;
+		minValue = qMin(minValue, value);
+		maxValue = qMax(maxValue, value);
+	}
+
+	sums.sum = sum;
+	sums.squaresSum = squaresSum;
+	sums.minValue = minValue;
+	sums.maxValue = maxValue;
+}
+
+
+#if defined(ACF_PIXEL_SSE2)
+
+/**
+	Sums of 8-bit gray values, 16 values are processed at once.
+*/
+template <>
+void CalcIntegerRunSums<quint8, 1>(const quint8* valuesPtr, int count, IntegerRunSums& sums)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i sumVector = zero;
+	__m128i squaresSumVector = zero;
+	__m128i minVector = _mm_set1_epi8(char(0xff));
+	__m128i maxVector = zero;
+
+	int index = 0;
+	while (count - index >= 16){
+		// 32-bit partial sums of squares cannot overflow for 8192 blocks of 16 values
+		const int blocksEnd = index + qMin((count - index) >> 4, 8192) * 16;
+
+		__m128i squaresPartialSum = zero;
+
+		for (; index < blocksEnd; index += 16){
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valuesPtr + index));
+
+			sumVector = _mm_add_epi64(sumVector, _mm_sad_epu8(values, zero));
+			minVector = _mm_min_epu8(minVector, values);
+			maxVector = _mm_max_epu8(maxVector, values);
+
+			const __m128i lowValues = _mm_unpacklo_epi8(values, zero);
+			const __m128i highValues = _mm_unpackhi_epi8(values, zero);
+			squaresPartialSum = _mm_add_epi32(squaresPartialSum, _mm_madd_epi16(lowValues, lowValues));
+			squaresPartialSum = _mm_add_epi32(squaresPartialSum, _mm_madd_epi16(highValues, highValues));
+		}
+
+		squaresSumVector = _mm_add_epi64(squaresSumVector, _mm_unpacklo_epi32(squaresPartialSum, zero));
+		squaresSumVector = _mm_add_epi64(squaresSumVector, _mm_unpackhi_epi32(squaresPartialSum, zero));
+	}
+
+	quint64 sumLanes[2];
+	quint64 squaresSumLanes[2];
+	quint8 minLanes[16];
+	quint8 maxLanes[16];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(sumLanes), sumVector);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(squaresSumLanes), squaresSumVector);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(minLanes), minVector);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(maxLanes), maxVector);
+
+	quint64 sum = sumLanes[0] + sumLanes[1];
+	quint64 squaresSum = squaresSumLanes[0] + squaresSumLanes[1];
+	quint32 minValue = 0xff;
+	quint32 maxValue = 0;
+
+	for (int laneIndex = 0; laneIndex < 16; ++laneIndex){
+		minValue = qMin(minValue, quint32(minLanes[laneIndex]));
+		maxValue = qMax(maxValue, quint32(maxLanes[laneIndex]));
+	}
+
+	for (; index < count; ++index){
+		const quint32 value = valuesPtr[index];
+
+		sum += value;
+		squaresSum += value * value;
+		minValue = qMin(minValue, value);
+		maxValue = qMax(maxValue, value);
+	}
+
+	sums.sum = sum;
+	sums.squaresSum = squaresSum;
+	sums.minValue = minValue;
+	sums.maxValue = maxValue;
+}
+
+#endif // ACF_PIXEL_SSE2
+
+
+template <typename ComponentType, int Stride>
+void AddRunValues(const ComponentType* valuesPtr, int count, ValuesSummary& summary, std::true_type /*isSmallInteger*/)
+{
+	IntegerRunSums sums;
+	CalcIntegerRunSums<ComponentType, Stride>(valuesPtr, count, sums);
+
+	const double mean = double(sums.sum) / count;
+	const double squaredDeviationsSum = qMax(0.0, double(sums.squaresSum) - double(sums.sum) * mean);
+
+	summary.Merge(count, sums.minValue, sums.maxValue, mean, squaredDeviationsSum);
+}
+
+
+template <typename ComponentType, int Stride>
+void AddRunValues(const ComponentType* valuesPtr, int count, ValuesSummary& summary, std::false_type /*isSmallInteger*/)
+{
+	qint64 validCount = 0;
+	double sum = 0;
+	double minValue = std::numeric_limits<double>::max();
+	double maxValue = -std::numeric_limits<double>::max();
+
+	for (int index = 0; index < count; ++index){
+		const double value = double(valuesPtr[index * Stride]);
+		if (qIsNaN(value)){
+			continue;
+		}
+
+		++validCount;
+		sum += value;
+		minValue = qMin(minValue, value);
+		maxValue = qMax(maxValue, value);
+	}
+
+	if (validCount <= 0){
+		return;
+	}
+
+	// deviations are summed in the second pass, the run is still in the cache
+	const double mean = sum / validCount;
+	double squaredDeviationsSum = 0;
+
+	for (int index = 0; index < count; ++index){
+		const double value = double(valuesPtr[index * Stride]);
+		if (!qIsNaN(value)){
+			const double deviation = value - mean;
+
+			squaredDeviationsSum += deviation * deviation;
+		}
+	}
+
+	summary.Merge(validCount, minValue, maxValue, mean, squaredDeviationsSum);
+}
+
+
+template <typename ComponentType, int ComponentsCount>
+class TStatisticsAccumulator
+{
+public:
+	explicit TStatisticsAccumulator(int componentIndex)
+	:	m_componentIndex(componentIndex)
+	{
+	}
+
+	void AddRun(const TPixel<ComponentType, ComponentsCount>* pixelsPtr, int /*x*/, int /*y*/, int pixelsCount)
+	{
+		AddRunValues<ComponentType, ComponentsCount>(
+					GetComponentPtr(pixelsPtr, m_componentIndex),
+					pixelsCount,
+					m_summary,
+					TIsSmallInteger<ComponentType>());
+	}
+
+	void Merge(const TStatisticsAccumulator& accumulator)
+	{
+		m_summary.Merge(accumulator.m_summary);
+	}
+
+	const ValuesSummary& GetSummary() const
+	{
+		return m_summary;
+	}
+
+private:
+	int m_componentIndex;
+	ValuesSummary m_summary;
+};
+
+
+template <typename ComponentType, int ComponentsCount>
+class THistogramAccumulator
+{
+public:
+	explicit THistogramAccumulator(int componentIndex)
+	:	m_componentIndex(componentIndex),
+		m_histogram(size_t(1) << (sizeof(ComponentType) * 8), 0)
+	{
+	}
+
+	void AddRun(const TPixel<ComponentType, ComponentsCount>* pixelsPtr, int /*x*/, int /*y*/, int pixelsCount)
+	{
+		const ComponentType* valuesPtr = GetComponentPtr(pixelsPtr, m_componentIndex);
+		qint64* binsPtr = m_histogram.data();
+
+		for (int index = 0; index < pixelsCount; ++index){
+			++binsPtr[valuesPtr[index * ComponentsCount]];
+		}
+	}
+
+	void Merge(const THistogramAccumulator& accumulator)
+	{
+		const int binsCount = int(m_histogram.size());
+		for (int binIndex = 0; binIndex < binsCount; ++binIndex){
+			m_histogram[binIndex] += accumulator.m_histogram[binIndex];
+		}
+	}
+
+	CMaskedRegionStatistics::Histogram& GetHistogramRef()
+	{
+		return m_histogram;
+	}
+
+private:
+	int m_componentIndex;
+	CMaskedRegionStatistics::Histogram m_histogram;
+};
+
+
+template <typename ComponentType, int ComponentsCount>
+class TMomentsAccumulator
+{
+public:
+	explicit TMomentsAccumulator(int componentIndex)
+	:	m_componentIndex(componentIndex)
+	{
+	}
+
+	void AddRun(const TPixel<ComponentType, ComponentsCount>* pixelsPtr, int x, int y, int pixelsCount)
+	{
+		const ComponentType* valuesPtr = GetComponentPtr(pixelsPtr, m_componentIndex);
+
+		// moments relative to the first pixel of the run
+		double sum = 0;
+		double firstOrderSum = 0;
+		double secondOrderSum = 0;
+
+		for (int index = 0; index < pixelsCount; ++index){
+			const double value = double(valuesPtr[index * ComponentsCount]);
+			if (qIsNaN(value)){
+				continue;
+			}
+
+			const double weightedPosition = value * index;
+
+			sum += value;
+			firstOrderSum += weightedPosition;
+			secondOrderSum += weightedPosition * index;
+		}
+
+		const double centerX = x + 0.5;
+		const double centerY = y + 0.5;
+		const double firstOrderX = firstOrderSum + centerX * sum;
+
+		m_moments.m00 += sum;
+		m_moments.m10 += firstOrderX;
+		m_moments.m01 += centerY * sum;
+		m_moments.m20 += secondOrderSum + centerX * (2 * firstOrderSum + centerX * sum);
+		m_moments.m11 += centerY * firstOrderX;
+		m_moments.m02 += centerY * centerY * sum;
+	}
+
+	void Merge(const TMomentsAccumulator& accumulator)
+	{
+		m_moments.m00 += accumulator.m_moments.m00;
+		m_moments.m10 += accumulator.m_moments.m10;
+		m_moments.m01 += accumulator.m_moments.m01;
+		m_moments.m20 += accumulator.m_moments.m20;
+		m_moments.m11 += accumulator.m_moments.m11;
+		m_moments.m02 += accumulator.m_moments.m02;
+	}
+
+	const CMaskedRegionStatistics::Moments& GetMoments() const
+	{
+		return m_moments;
+	}
+
+private:
+	int m_componentIndex;
+	CMaskedRegionStatistics::Moments m_moments;
+};
+
+
+struct StatisticsCalculator
+{
+	template <typename ComponentType, int ComponentsCount>
+	bool Calculate()
+	{
+		TStatisticsAccumulator<ComponentType, ComponentsCount> accumulator(componentIndex);
+		TMaskedRegionProcessor<TPixel<ComponentType, ComponentsCount> >::Reduce(*bitmapPtr, *maskPtr, accumulator);
+
+		const ValuesSummary& summary = accumulator.GetSummary();
+
+		resultPtr->pixelsCount = summary.count;
+		resultPtr->minValue = summary.minValue;
+		resultPtr->maxValue = summary.maxValue;
+		resultPtr->mean = summary.mean;
+		resultPtr->variance = (summary.count > 0)? summary.squaredDeviationsSum / summary.count: 0.0;
+
+		return true;
+	}
+
+	const IBitmap* bitmapPtr;
+	const CScanlineMask* maskPtr;
+	int componentIndex;
+	CMaskedRegionStatistics::Statistics* resultPtr;
+};
+
+
+struct HistogramCalculator
+{
+	template <typename ComponentType, int ComponentsCount>
+	bool Calculate()
+	{
+		return Calculate<ComponentType, ComponentsCount>(TIsSmallInteger<ComponentType>());
+	}
+
+	template <typename ComponentType, int ComponentsCount>
+	bool Calculate(std::true_type /*isSmallInteger*/)
+	{
+		THistogramAccumulator<ComponentType, ComponentsCount> accumulator(componentIndex);
+		TMaskedRegionProcessor<TPixel<ComponentType, ComponentsCount> >::Reduce(*bitmapPtr, *maskPtr, accumulator);
+
+		resultPtr->swap(accumulator.GetHistogramRef());
+
+		return true;
+	}
+
+	template <typename ComponentType, int ComponentsCount>
+	bool Calculate(std::false_type /*isSmallInteger*/)
+	{
+		return false;
+	}
+
+	const IBitmap* bitmapPtr;
+	const CScanlineMask* maskPtr;
+	int componentIndex;
+	CMaskedRegionStatistics::Histogram* resultPtr;
+};
+
+
+struct MomentsCalculator
+{
+	template <typename ComponentType, int ComponentsCount>
+	bool Calculate()
+	{
+		TMomentsAccumulator<ComponentType, ComponentsCount> accumulator(componentIndex);
+		TMaskedRegionProcessor<TPixel<ComponentType, ComponentsCount> >::Reduce(*bitmapPtr, *maskPtr, accumulator);
+
+		*resultPtr = accumulator.GetMoments();
+
+		return true;
+	}
+
+	const IBitmap* bitmapPtr;
+	const CScanlineMask* maskPtr;
+	int componentIndex;
+	CMaskedRegionStatistics::Moments* resultPtr;
+};
+
+
+/**
+	Get number of components, which can be evaluated.
+*/
+int GetEvaluatedComponentsCount(IBitmap::PixelFormat format)
+{
+	switch (format){
+		case IBitmap::PF_GRAY:
+		case IBitmap::PF_GRAY16:
+		case IBitmap::PF_GRAY32:
+		case IBitmap::PF_FLOAT32:
+		case IBitmap::PF_FLOAT64:
+			return 1;
+
+		case IBitmap::PF_RGB:	// alpha channel is not stored
+		case IBitmap::PF_RGB24:
+		case IBitmap::PF_RGB48:
+			return 3;
+
+		case IBitmap::PF_RGBA:
+		case IBitmap::PF_RGBA64:
+			return 4;
+
+		default:
+			return 0;
+	}
+}
+
+
+/**
+	Call the calculator with the component type and number of components of the bitmap format.
+*/
+template <typename Calculator>
+bool CalculateForFormat(IBitmap::PixelFormat format, Calculator& calculator)
+{
+	switch (format){
+		case IBitmap::PF_GRAY:
+			return calculator.template Calculate<quint8, 1>();
+
+		case IBitmap::PF_GRAY16:
+			return calculator.template Calculate<quint16, 1>();
+
+		case IBitmap::PF_GRAY32:
+			return calculator.template Calculate<quint32, 1>();
+
+		case IBitmap::PF_FLOAT32:
+			return calculator.template Calculate<float, 1>();
+
+		case IBitmap::PF_FLOAT64:
+			return calculator.template Calculate<double, 1>();
+
+		case IBitmap::PF_RGB:
+		case IBitmap::PF_RGBA:
+			return calculator.template Calculate<quint8, 4>();
+
+		case IBitmap::PF_RGB24:
+			return calculator.template Calculate<quint8, 3>();
+
+		case IBitmap::PF_RGB48:
+			return calculator.template Calculate<quint16, 3>();
+
+		case IBitmap::PF_RGBA64:
+			return calculator.template Calculate<quint16, 4>();
+
+		default:
+			return false;
+	}
+}
+
+
+} // namespace
+
+
+// public methods of embedded struct Statistics
+
+CMaskedRegionStatistics::Statistics::Statistics()
+:	pixelsCount(0),
+	minValue(0),
+	maxValue(0),
+	mean(0),
+	variance(0)
+{
+}
+
+
+double CMaskedRegionStatistics::Statistics::GetStandardDeviation() const
+{
+	return qSqrt(variance);
+}
+
+
+// public methods of embedded struct Moments
+
+CMaskedRegionStatistics::Moments::Moments()
+:	m00(0),
+	m10(0),
+	m01(0),
+	m20(0),
+	m11(0),
+	m02(0)
+{
+}
+
+
+i2d::CVector2d CMaskedRegionStatistics::Moments::GetCentroid() const
+{
+	if (m00 == 0){
+		return i2d::CVector2d(0, 0);
+	}
+
+	return i2d::CVector2d(m10 / m00, m01 / m00);
+}
+
+
+double CMaskedRegionStatistics::Moments::GetCentralMoment20() const
+{
+	return (m00 != 0)? m20 - m10 * m10 / m00: 0.0;
+}
+
+
+double CMaskedRegionStatistics::Moments::GetCentralMoment11() const
+{
+	return (m00 != 0)? m11 - m10 * m01 / m00: 0.0;
+}
+
+
+double CMaskedRegionStatistics::Moments::GetCentralMoment02() const
+{
+	return (m00 != 0)? m02 - m01 * m01 / m00: 0.0;
+}
+
+
+// public static methods
+
+bool CMaskedRegionStatistics::IsComponentSupported(IBitmap::PixelFormat format, int componentIndex)
+{
+	return (componentIndex >= 0) && (componentIndex < GetEvaluatedComponentsCount(format));
+}
+
+
+bool CMaskedRegionStatistics::CalcStatistics(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Statistics& result)
+{
+	const IBitmap::PixelFormat format = bitmap.GetPixelFormat();
+	if (!IsComponentSupported(format, componentIndex)){
+		return false;
+	}
+
+	StatisticsCalculator calculator;
+	calculator.bitmapPtr = &bitmap;
+	calculator.maskPtr = &mask;
+	calculator.componentIndex = componentIndex;
+	calculator.resultPtr = &result;
+
+	return CalculateForFormat(format, calculator);
+}
+
+
+bool CMaskedRegionStatistics::CalcHistogram(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Histogram& result)
+{
+	const IBitmap::PixelFormat format = bitmap.GetPixelFormat();
+	if (!IsComponentSupported(format, componentIndex)){
+		return false;
+	}
+
+	HistogramCalculator calculator;
+	calculator.bitmapPtr = &bitmap;
+	calculator.maskPtr = &mask;
+	calculator.componentIndex = componentIndex;
+	calculator.resultPtr = &result;
+
+	return CalculateForFormat(format, calculator);
+}
+
+
+bool CMaskedRegionStatistics::CalcWeightedMoments(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Moments& result)
+{
+	const IBitmap::PixelFormat format = bitmap.GetPixelFormat();
+	if (!IsComponentSupported(format, componentIndex)){
+		return false;
+	}
+
+	MomentsCalculator calculator;
+	calculator.bitmapPtr = &bitmap;
+	calculator.maskPtr = &mask;
+	calculator.componentIndex = componentIndex;
+	calculator.resultPtr = &result;
+
+	return CalculateForFormat(format, calculator);
+}
+
+
+void CMaskedRegionStatistics::CalcMoments(const CScanlineMask& mask, Moments& result)
+{
+	result = Moments();
+
+	const istd::CIntRange linesRange = mask.GetScanlinesRange();
+	for (int y = linesRange.GetMinValue(); y < linesRange.GetMaxValue(); ++y){
+		int pointsCount = 0;
+		const int* pointsPtr = mask.GetLineSwitchPoints(y, pointsCount);
+		if (pointsPtr == NULL){
+			continue;
+		}
+
+		// sums of the pixel centers of the line
+		double count = 0;
+		double firstOrderSum = 0;
+		double secondOrderSum = 0;
+
+		for (int index = 0; index < pointsCount; index += 2){
+			const double runCount = double(pointsPtr[index + 1]) - pointsPtr[index];
+			const double runCenter = (double(pointsPtr[index]) + pointsPtr[index + 1]) * 0.5;
+
+			count += runCount;
+			firstOrderSum += runCount * runCenter;
+			secondOrderSum += runCount * (runCenter * runCenter + (runCount * runCount - 1) / 12);
+		}
+
+		const double centerY = y + 0.5;
+
+		result.m00 += count;
+		result.m10 += firstOrderSum;
+		result.m01 += centerY * count;
+		result.m20 += secondOrderSum;
+		result.m11 += centerY * firstOrderSum;
+		result.m02 += centerY * centerY * count;
+	}
+}
+
+
+} // namespace iimg
+
+
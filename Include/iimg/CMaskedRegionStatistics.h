@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// STL includes
+#include <vector>
+
+// ACF includes
+#include <i2d/CVector2d.h>
+#include <iimg/IBitmap.h>
+#include <iimg/CScanlineMask.h>
+
+
+namespace iimg
+{
+
+
+/**
+	Statistics of bitmap pixels inside of a scanline mask.
+
+	Values of a single pixel component are evaluated, components are indexed in the memory order of the pixel format
+	(the same as in \c IRasterImage::GetColorAt).
+	Raw component values are used, for example 0 to 255 for 8-bit components.
+	Supported formats are \c PF_GRAY, \c PF_GRAY16, \c PF_GRAY32, \c PF_FLOAT32, \c PF_FLOAT64, \c PF_RGB (without alpha component),
+	\c PF_RGBA, \c PF_RGB24, \c PF_RGB48 and \c PF_RGBA64, NaN values of floating point formats are ignored.
+	Only pixels of the mask inside of the bitmap are evaluated.
+
+	The runs of the mask are processed directly in the bitmap memory using \c TMaskedRegionProcessor,
+	8-bit gray values are reduced using SSE2 on x86 processors.
+	Large regions are processed in bands of lines in parallel.
+
+	\ingroup ImageProcessing
+*/
+class CMaskedRegionStatistics
+{
+public:
+	/**
+		Histogram of component values, number of pixels for each value.
+	*/
+	typedef std::vector<qint64> Histogram;
+
+	/**
+		Basic statistics of values.
+	*/
+	struct Statistics
+	{
+		Statistics();
+
+		/**
+			Number of evaluated pixels.
+		*/
+		qint64 pixelsCount;
+		double minValue;
+		double maxValue;
+		double mean;
+		/**
+			Population variance of the values.
+		*/
+		double variance;
+
+		double GetStandardDeviation() const;
+	};
+
+	/**
+		Raw moments up to the second order.
+		Pixel at position (x, y) is represented by its center (x + 0.5, y + 0.5), the same as in \c CScanlineMask::GetCenter.
+	*/
+	struct Moments
+	{
+		Moments();
+
+		double m00;
+		double m10;
+		double m01;
+		double m20;
+		double m11;
+		double m02;
+
+		/**
+			Get center of mass, if the moment \c m00 is zero it returns null vector.
+		*/
+		i2d::CVector2d GetCentroid() const;
+		/**
+			Get central moments of the second order.
+		*/
+		double GetCentralMoment20() const;
+		double GetCentralMoment11() const;
+		double GetCentralMoment02() const;
+	};
+
+	/**
+		Check if the pixel format and component are supported.
+	*/
+	static bool IsComponentSupported(IBitmap::PixelFormat format, int componentIndex);
+
+	/**
+		Calculate basic statistics of pixel values inside of the mask.
+		\return	true, if the pixel format and component are supported.
+	*/
+	static bool CalcStatistics(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Statistics& result);
+
+	/**
+		Calculate histogram of pixel values inside of the mask.
+		Only components of 8 and 16 bits are supported, the histogram has one bin for each possible value.
+		\return	true, if the pixel format and component are supported.
+	*/
+	static bool CalcHistogram(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Histogram& result);
+
+	/**
+		Calculate moments of pixel values inside of the mask, the values are used as weights of the pixel positions.
+		\return	true, if the pixel format and component are supported.
+	*/
+	static bool CalcWeightedMoments(const IBitmap& bitmap, const CScanlineMask& mask, int componentIndex, Moments& result);
+
+	/**
+		Calculate moments of the mask region, each pixel has weight 1.
+		The moments are calculated from the runs of the mask, no pixels are visited.
+	*/
+	static void CalcMoments(const CScanlineMask& mask, Moments& result);
+};
+
+
+} // namespace iimg
+
+
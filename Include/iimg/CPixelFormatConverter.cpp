@@ -0,0 +1,1712 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <iimg/CPixelFormatConverter.h>
+
+
+// STL includes
+#include <cstring>
+#include <limits>
+
+// Qt includes
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+// ACF includes
+#include <istd/CParallelFor.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define ACF_PIXEL_SSE2
+	#include <emmintrin.h>
+
+	#if defined(_MSC_VER)
+		#define ACF_PIXEL_AVX2
+		#define ACF_PIXEL_AVX2_TARGET
+		#include <immintrin.h>
+		#include <intrin.h>
+	#elif defined(__GNUC__)
+		#define ACF_PIXEL_AVX2
+		#define ACF_PIXEL_AVX2_TARGET __attribute__((target("avx2")))
+		#include <immintrin.h>
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define ACF_PIXEL_NEON
+	#include <arm_neon.h>
+#endif
+
+
+namespace iimg
+{
+
+
+namespace
+{
+
+
+typedef CPixelFormatConverter::ValueMapping ValueMapping;
+
+/**
+	Direct conversion of a line of pixels.
+*/
+typedef void (*LineConverter)(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping);
+
+/**
+	Conversion of a line of pixels to the intermediate 16-bit RGBA values.
+*/
+typedef void (*LineDecoder)(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& mapping);
+
+/**
+	Conversion of the intermediate 16-bit RGBA values to a line of pixels.
+*/
+typedef void (*LineEncoder)(const quint16* rgbaPtr, void* destPtr, int pixelsCount);
+
+
+enum
+{
+	FORMATS_COUNT = IBitmap::PF_CMYK + 1,
+	INTERMEDIATE_PIXELS_COUNT = 256
+};
+
+
+int GetPixelBitsCount(IBitmap::PixelFormat format)
+{
+	switch (format){
+		case IBitmap::PF_MONO:
+			return 1;
+
+		case IBitmap::PF_GRAY:
+			return 8;
+
+		case IBitmap::PF_GRAY16:
+			return 16;
+
+		case IBitmap::PF_RGB24:
+			return 24;
+
+		case IBitmap::PF_RGB:
+		case IBitmap::PF_RGBA:
+		case IBitmap::PF_GRAY32:
+		case IBitmap::PF_FLOAT32:
+		case IBitmap::PF_CMYK:
+			return 32;
+
+		case IBitmap::PF_RGB48:
+			return 48;
+
+		case IBitmap::PF_RGBA64:
+		case IBitmap::PF_FLOAT64:
+		case IBitmap::PF_XY32:
+			return 64;
+
+		case IBitmap::PF_XYZ32:
+			return 96;
+
+		default:
+			return -1;
+	}
+}
+
+
+bool IsMappedFormat(IBitmap::PixelFormat format)
+{
+	return (format == IBitmap::PF_GRAY32) || (format == IBitmap::PF_FLOAT32) || (format == IBitmap::PF_FLOAT64);
+}
+
+
+bool IsIdentityMapping(const ValueMapping& mapping)
+{
+	return (mapping.scale == 1.0) && (mapping.offset == 0.0);
+}
+
+
+// scalar helpers
+
+inline quint8 CalcGray8(int red, int green, int blue)
+{
+	return quint8((red * 77 + green * 150 + blue * 29 + 128) >> 8);
+}
+
+
+inline quint16 CalcGray16(quint32 red, quint32 green, quint32 blue)
+{
+	return quint16((red * 19595 + green * 38470 + blue * 7471 + 32768) >> 16);
+}
+
+
+/**
+	Rounded division by 257, it converts 16-bit component to 8-bit one.
+*/
+inline quint8 Reduce16To8(quint32 value)
+{
+	return quint8((value - (value >> 8) + 0x80) >> 8);
+}
+
+
+inline quint16 MapTo16(double value)
+{
+	if (!(value > 0)){
+		return 0;
+	}
+
+	if (value >= 1){
+		return 65535;
+	}
+
+	return quint16(value * 65535 + 0.5);
+}
+
+
+template <typename ValueType>
+struct ValueTraits
+{
+	static double GetNormalizeFactor()
+	{
+		return 1.0;
+	}
+
+	static ValueType FromUnit(double value)
+	{
+		return ValueType(value);
+	}
+};
+
+
+template <>
+struct ValueTraits<quint32>
+{
+	static double GetNormalizeFactor()
+	{
+		return 1.0 / 4294967295.0;
+	}
+
+	static quint32 FromUnit(double value)
+	{
+		if (!(value > 0)){
+			return 0;
+		}
+
+		if (value >= 1){
+			return 0xffffffff;
+		}
+
+		return quint32(value * 4294967295.0 + 0.5);
+	}
+};
+
+
+// direct scalar kernels
+
+void ConvertGray8ToBgra8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const quint8 gray = sourceBytesPtr[x];
+
+		destBytesPtr[0] = gray;
+		destBytesPtr[1] = gray;
+		destBytesPtr[2] = gray;
+		destBytesPtr[3] = 255;
+		destBytesPtr += 4;
+	}
+}
+
+
+void ConvertGray8ToRgb24(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const quint8 gray = sourceBytesPtr[x];
+
+		destBytesPtr[0] = gray;
+		destBytesPtr[1] = gray;
+		destBytesPtr[2] = gray;
+		destBytesPtr += 3;
+	}
+}
+
+
+void ConvertBgra8ToGray8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[x] = CalcGray8(sourceBytesPtr[2], sourceBytesPtr[1], sourceBytesPtr[0]);
+		sourceBytesPtr += 4;
+	}
+}
+
+
+void ConvertRgb24ToGray8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[x] = CalcGray8(sourceBytesPtr[0], sourceBytesPtr[1], sourceBytesPtr[2]);
+		sourceBytesPtr += 3;
+	}
+}
+
+
+void ConvertBgra8ToRgb24(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[0] = sourceBytesPtr[2];
+		destBytesPtr[1] = sourceBytesPtr[1];
+		destBytesPtr[2] = sourceBytesPtr[0];
+		sourceBytesPtr += 4;
+		destBytesPtr += 3;
+	}
+}
+
+
+void ConvertRgb24ToBgra8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[0] = sourceBytesPtr[2];
+		destBytesPtr[1] = sourceBytesPtr[1];
+		destBytesPtr[2] = sourceBytesPtr[0];
+		destBytesPtr[3] = 255;
+		sourceBytesPtr += 3;
+		destBytesPtr += 4;
+	}
+}
+
+
+/**
+	Copy 32-bit color pixels, alpha channel is set to opaque.
+*/
+void ConvertBgra8ToBgrx8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[0] = sourceBytesPtr[0];
+		destBytesPtr[1] = sourceBytesPtr[1];
+		destBytesPtr[2] = sourceBytesPtr[2];
+		destBytesPtr[3] = 255;
+		sourceBytesPtr += 4;
+		destBytesPtr += 4;
+	}
+}
+
+
+void ConvertGray16ToGray8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[x] = Reduce16To8(sourceValuesPtr[x]);
+	}
+}
+
+
+void ConvertGray8ToGray16(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint16* destValuesPtr = static_cast<quint16*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = quint16(sourceBytesPtr[x] * 257);
+	}
+}
+
+
+void ConvertFloat32ToGray8(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const float* sourceValuesPtr = static_cast<const float*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const float scale = float(mapping.scale * 255);
+	const float offset = float(mapping.offset * 255);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const float value = sourceValuesPtr[x] * scale + offset;
+
+		if (!(value > 0)){
+			destBytesPtr[x] = 0;
+		}
+		else if (value >= 255){
+			destBytesPtr[x] = 255;
+		}
+		else{
+			destBytesPtr[x] = quint8(value + 0.5f);
+		}
+	}
+}
+
+
+void ConvertGray8ToFloat32(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	float* destValuesPtr = static_cast<float*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = float(sourceBytesPtr[x]) / 255.0f;
+	}
+}
+
+
+/**
+	Conversion between single channel formats with value mapping.
+*/
+template <typename SourceType, typename DestType>
+void ConvertMappedValues(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const SourceType* sourceValuesPtr = static_cast<const SourceType*>(sourcePtr);
+	DestType* destValuesPtr = static_cast<DestType*>(destPtr);
+
+	const double scale = mapping.scale * ValueTraits<SourceType>::GetNormalizeFactor();
+	const double offset = mapping.offset;
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = ValueTraits<DestType>::FromUnit(sourceValuesPtr[x] * scale + offset);
+	}
+}
+
+
+// decoders to intermediate RGBA values
+
+void DecodeGray8(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const quint16 gray = quint16(sourceBytesPtr[x] * 257);
+
+		rgbaPtr[0] = gray;
+		rgbaPtr[1] = gray;
+		rgbaPtr[2] = gray;
+		rgbaPtr[3] = 65535;
+		rgbaPtr += 4;
+	}
+}
+
+
+void DecodeGray16(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const quint16 gray = sourceValuesPtr[x];
+
+		rgbaPtr[0] = gray;
+		rgbaPtr[1] = gray;
+		rgbaPtr[2] = gray;
+		rgbaPtr[3] = 65535;
+		rgbaPtr += 4;
+	}
+}
+
+
+template <typename SourceType>
+void DecodeMappedValues(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const SourceType* sourceValuesPtr = static_cast<const SourceType*>(sourcePtr);
+
+	const double scale = mapping.scale * ValueTraits<SourceType>::GetNormalizeFactor();
+	const double offset = mapping.offset;
+
+	for (int x = 0; x < pixelsCount; ++x){
+		const quint16 gray = MapTo16(sourceValuesPtr[x] * scale + offset);
+
+		rgbaPtr[0] = gray;
+		rgbaPtr[1] = gray;
+		rgbaPtr[2] = gray;
+		rgbaPtr[3] = 65535;
+		rgbaPtr += 4;
+	}
+}
+
+
+template <bool HasAlpha>
+void DecodeBgra8(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		rgbaPtr[0] = quint16(sourceBytesPtr[2] * 257);
+		rgbaPtr[1] = quint16(sourceBytesPtr[1] * 257);
+		rgbaPtr[2] = quint16(sourceBytesPtr[0] * 257);
+		rgbaPtr[3] = HasAlpha? quint16(sourceBytesPtr[3] * 257): quint16(65535);
+		sourceBytesPtr += 4;
+		rgbaPtr += 4;
+	}
+}
+
+
+void DecodeRgb24(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		rgbaPtr[0] = quint16(sourceBytesPtr[0] * 257);
+		rgbaPtr[1] = quint16(sourceBytesPtr[1] * 257);
+		rgbaPtr[2] = quint16(sourceBytesPtr[2] * 257);
+		rgbaPtr[3] = 65535;
+		sourceBytesPtr += 3;
+		rgbaPtr += 4;
+	}
+}
+
+
+void DecodeRgb48(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		rgbaPtr[0] = sourceValuesPtr[0];
+		rgbaPtr[1] = sourceValuesPtr[1];
+		rgbaPtr[2] = sourceValuesPtr[2];
+		rgbaPtr[3] = 65535;
+		sourceValuesPtr += 3;
+		rgbaPtr += 4;
+	}
+}
+
+
+void DecodeRgba64(const void* sourcePtr, quint16* rgbaPtr, int pixelsCount, const ValueMapping& /*mapping*/)
+{
+	std::memcpy(rgbaPtr, sourcePtr, size_t(pixelsCount) * 4 * sizeof(quint16));
+}
+
+
+// encoders from intermediate RGBA values
+
+void EncodeGray8(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[x] = Reduce16To8(CalcGray16(rgbaPtr[0], rgbaPtr[1], rgbaPtr[2]));
+		rgbaPtr += 4;
+	}
+}
+
+
+void EncodeGray16(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint16* destValuesPtr = static_cast<quint16*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = CalcGray16(rgbaPtr[0], rgbaPtr[1], rgbaPtr[2]);
+		rgbaPtr += 4;
+	}
+}
+
+
+void EncodeGray32(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint32* destValuesPtr = static_cast<quint32*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = quint32(CalcGray16(rgbaPtr[0], rgbaPtr[1], rgbaPtr[2])) * 65537;
+		rgbaPtr += 4;
+	}
+}
+
+
+template <typename DestType>
+void EncodeFloat(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	DestType* destValuesPtr = static_cast<DestType*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[x] = DestType(CalcGray16(rgbaPtr[0], rgbaPtr[1], rgbaPtr[2])) / DestType(65535);
+		rgbaPtr += 4;
+	}
+}
+
+
+template <bool HasAlpha>
+void EncodeBgra8(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[0] = Reduce16To8(rgbaPtr[2]);
+		destBytesPtr[1] = Reduce16To8(rgbaPtr[1]);
+		destBytesPtr[2] = Reduce16To8(rgbaPtr[0]);
+		destBytesPtr[3] = HasAlpha? Reduce16To8(rgbaPtr[3]): quint8(255);
+		rgbaPtr += 4;
+		destBytesPtr += 4;
+	}
+}
+
+
+void EncodeRgb24(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destBytesPtr[0] = Reduce16To8(rgbaPtr[0]);
+		destBytesPtr[1] = Reduce16To8(rgbaPtr[1]);
+		destBytesPtr[2] = Reduce16To8(rgbaPtr[2]);
+		rgbaPtr += 4;
+		destBytesPtr += 3;
+	}
+}
+
+
+void EncodeRgb48(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	quint16* destValuesPtr = static_cast<quint16*>(destPtr);
+
+	for (int x = 0; x < pixelsCount; ++x){
+		destValuesPtr[0] = rgbaPtr[0];
+		destValuesPtr[1] = rgbaPtr[1];
+		destValuesPtr[2] = rgbaPtr[2];
+		rgbaPtr += 4;
+		destValuesPtr += 3;
+	}
+}
+
+
+void EncodeRgba64(const quint16* rgbaPtr, void* destPtr, int pixelsCount)
+{
+	std::memcpy(destPtr, rgbaPtr, size_t(pixelsCount) * 4 * sizeof(quint16));
+}
+
+
+#if defined(ACF_PIXEL_SSE2)
+
+/**
+	Calculate 8 gray values of 32-bit color pixels as 16-bit integers.
+*/
+inline __m128i CalcBgra8GraySse2(__m128i pixels0, __m128i pixels1)
+{
+	const __m128i byteMask = _mm_set1_epi32(0xff);
+
+	const __m128i blue = _mm_packs_epi32(_mm_and_si128(pixels0, byteMask), _mm_and_si128(pixels1, byteMask));
+	const __m128i green = _mm_packs_epi32(
+				_mm_and_si128(_mm_srli_epi32(pixels0, 8), byteMask),
+				_mm_and_si128(_mm_srli_epi32(pixels1, 8), byteMask));
+	const __m128i red = _mm_packs_epi32(
+				_mm_and_si128(_mm_srli_epi32(pixels0, 16), byteMask),
+				_mm_and_si128(_mm_srli_epi32(pixels1, 16), byteMask));
+
+	__m128i sum = _mm_add_epi16(_mm_mullo_epi16(red, _mm_set1_epi16(77)), _mm_mullo_epi16(green, _mm_set1_epi16(150)));
+	sum = _mm_add_epi16(sum, _mm_mullo_epi16(blue, _mm_set1_epi16(29)));
+	sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+
+	return _mm_srli_epi16(sum, 8);
+}
+
+
+/**
+	Rounded division of 16-bit values by 257.
+*/
+inline __m128i Reduce16To8Sse2(__m128i values)
+{
+	values = _mm_sub_epi16(values, _mm_srli_epi16(values, 8));
+
+	return _mm_srli_epi16(_mm_add_epi16(values, _mm_set1_epi16(0x80)), 8);
+}
+
+
+void ConvertGray8ToBgra8Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m128i alpha = _mm_set1_epi8(char(0xff));
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + x));
+		__m128i* outputPtr = reinterpret_cast<__m128i*>(destBytesPtr + x * 4);
+
+		__m128i grayGray = _mm_unpacklo_epi8(gray, gray);
+		__m128i grayAlpha = _mm_unpacklo_epi8(gray, alpha);
+		_mm_storeu_si128(outputPtr, _mm_unpacklo_epi16(grayGray, grayAlpha));
+		_mm_storeu_si128(outputPtr + 1, _mm_unpackhi_epi16(grayGray, grayAlpha));
+
+		grayGray = _mm_unpackhi_epi8(gray, gray);
+		grayAlpha = _mm_unpackhi_epi8(gray, alpha);
+		_mm_storeu_si128(outputPtr + 2, _mm_unpacklo_epi16(grayGray, grayAlpha));
+		_mm_storeu_si128(outputPtr + 3, _mm_unpackhi_epi16(grayGray, grayAlpha));
+	}
+
+	ConvertGray8ToBgra8(sourceBytesPtr + x, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+void ConvertBgra8ToGray8Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i* inputPtr = reinterpret_cast<const __m128i*>(sourceBytesPtr + x * 4);
+
+		const __m128i gray0 = CalcBgra8GraySse2(_mm_loadu_si128(inputPtr), _mm_loadu_si128(inputPtr + 1));
+		const __m128i gray1 = CalcBgra8GraySse2(_mm_loadu_si128(inputPtr + 2), _mm_loadu_si128(inputPtr + 3));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destBytesPtr + x), _mm_packus_epi16(gray0, gray1));
+	}
+
+	ConvertBgra8ToGray8(sourceBytesPtr + x * 4, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertBgra8ToBgrx8Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+
+	int x = 0;
+	for (; x + 4 <= pixelsCount; x += 4){
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + x * 4));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destBytesPtr + x * 4), _mm_or_si128(pixels, alpha));
+	}
+
+	ConvertBgra8ToBgrx8(sourceBytesPtr + x * 4, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+void ConvertGray16ToGray8Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i* inputPtr = reinterpret_cast<const __m128i*>(sourceValuesPtr + x);
+
+		const __m128i values0 = Reduce16To8Sse2(_mm_loadu_si128(inputPtr));
+		const __m128i values1 = Reduce16To8Sse2(_mm_loadu_si128(inputPtr + 1));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destBytesPtr + x), _mm_packus_epi16(values0, values1));
+	}
+
+	ConvertGray16ToGray8(sourceValuesPtr + x, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertGray8ToGray16Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint16* destValuesPtr = static_cast<quint16*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + x));
+		__m128i* outputPtr = reinterpret_cast<__m128i*>(destValuesPtr + x);
+
+		// duplicated byte is the value multiplied by 257
+		_mm_storeu_si128(outputPtr, _mm_unpacklo_epi8(gray, gray));
+		_mm_storeu_si128(outputPtr + 1, _mm_unpackhi_epi8(gray, gray));
+	}
+
+	ConvertGray8ToGray16(sourceBytesPtr + x, destValuesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertFloat32ToGray8Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const float* sourceValuesPtr = static_cast<const float*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m128 scale = _mm_set1_ps(float(mapping.scale * 255));
+	const __m128 offset = _mm_set1_ps(float(mapping.offset * 255));
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 maxValue = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		__m128i values[4];
+
+		for (int i = 0; i < 4; ++i){
+			__m128 value = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sourceValuesPtr + x + i * 4), scale), offset);
+
+			// maximum with the second operand zero replaces NaN values too
+			value = _mm_min_ps(_mm_max_ps(value, zero), maxValue);
+
+			values[i] = _mm_cvttps_epi32(_mm_add_ps(value, half));
+		}
+
+		const __m128i values01 = _mm_packs_epi32(values[0], values[1]);
+		const __m128i values23 = _mm_packs_epi32(values[2], values[3]);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destBytesPtr + x), _mm_packus_epi16(values01, values23));
+	}
+
+	ConvertFloat32ToGray8(sourceValuesPtr + x, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertGray8ToFloat32Sse2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	float* destValuesPtr = static_cast<float*>(destPtr);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 maxValue = _mm_set1_ps(255.0f);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + x));
+		const __m128i grayLow = _mm_unpacklo_epi8(gray, zero);
+		const __m128i grayHigh = _mm_unpackhi_epi8(gray, zero);
+
+		float* outputPtr = destValuesPtr + x;
+		_mm_storeu_ps(outputPtr, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(grayLow, zero)), maxValue));
+		_mm_storeu_ps(outputPtr + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(grayLow, zero)), maxValue));
+		_mm_storeu_ps(outputPtr + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(grayHigh, zero)), maxValue));
+		_mm_storeu_ps(outputPtr + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(grayHigh, zero)), maxValue));
+	}
+
+	ConvertGray8ToFloat32(sourceBytesPtr + x, destValuesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void CalcFloat32RangeSse2(const float* valuesPtr, int valuesCount, float& minValue, float& maxValue)
+{
+	int x = 0;
+
+	if (valuesCount >= 4){
+		__m128 minValues = _mm_set1_ps(minValue);
+		__m128 maxValues = _mm_set1_ps(maxValue);
+
+		for (; x + 4 <= valuesCount; x += 4){
+			const __m128 values = _mm_loadu_ps(valuesPtr + x);
+
+			// if any operand is NaN, the second one is returned
+			minValues = _mm_min_ps(values, minValues);
+			maxValues = _mm_max_ps(values, maxValues);
+		}
+
+		float minBuffer[4];
+		float maxBuffer[4];
+		_mm_storeu_ps(minBuffer, minValues);
+		_mm_storeu_ps(maxBuffer, maxValues);
+
+		for (int i = 0; i < 4; ++i){
+			minValue = qMin(minValue, minBuffer[i]);
+			maxValue = qMax(maxValue, maxBuffer[i]);
+		}
+	}
+
+	for (; x < valuesCount; ++x){
+		const float value = valuesPtr[x];
+
+		if (value < minValue){
+			minValue = value;
+		}
+
+		if (value > maxValue){
+			maxValue = value;
+		}
+	}
+}
+
+#endif // ACF_PIXEL_SSE2
+
+
+#if defined(ACF_PIXEL_AVX2)
+
+bool IsAvx2Supported()
+{
+#if defined(_MSC_VER)
+	int cpuInfo[4] = {0};
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7){
+		return false;
+	}
+
+	// the operating system has to save the AVX registers
+	__cpuid(cpuInfo, 1);
+	const int osxsaveBit = 1 << 27;
+	if (((cpuInfo[2] & osxsaveBit) == 0) || ((_xgetbv(0) & 0x6) != 0x6)){
+		return false;
+	}
+
+	__cpuidex(cpuInfo, 7, 0);
+	const int avx2Bit = 1 << 5;
+
+	return (cpuInfo[1] & avx2Bit) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+
+/**
+	Calculate 16 gray values of 32-bit color pixels as 16-bit integers.
+	The result is ordered per 128-bit lanes in the same way as \c _mm256_packs_epi32 does.
+*/
+ACF_PIXEL_AVX2_TARGET
+inline __m256i CalcBgra8GrayAvx2(__m256i pixels0, __m256i pixels1)
+{
+	const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+	const __m256i blue = _mm256_packs_epi32(_mm256_and_si256(pixels0, byteMask), _mm256_and_si256(pixels1, byteMask));
+	const __m256i green = _mm256_packs_epi32(
+				_mm256_and_si256(_mm256_srli_epi32(pixels0, 8), byteMask),
+				_mm256_and_si256(_mm256_srli_epi32(pixels1, 8), byteMask));
+	const __m256i red = _mm256_packs_epi32(
+				_mm256_and_si256(_mm256_srli_epi32(pixels0, 16), byteMask),
+				_mm256_and_si256(_mm256_srli_epi32(pixels1, 16), byteMask));
+
+	__m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(red, _mm256_set1_epi16(77)), _mm256_mullo_epi16(green, _mm256_set1_epi16(150)));
+	sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(blue, _mm256_set1_epi16(29)));
+	sum = _mm256_add_epi16(sum, _mm256_set1_epi16(128));
+
+	return _mm256_srli_epi16(sum, 8);
+}
+
+
+/**
+	Pack four vectors of 32-bit values in range [0, 255] to bytes keeping their order.
+*/
+ACF_PIXEL_AVX2_TARGET
+inline __m256i PackToBytesAvx2(__m256i values0, __m256i values1, __m256i values2, __m256i values3)
+{
+	const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(values0, values1), _mm256_packs_epi32(values2, values3));
+
+	return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+
+/**
+	Load 8 pixels of 24-bit color as 32-bit BGRA pixels.
+	The 4 bytes following the pixels are read too.
+*/
+ACF_PIXEL_AVX2_TARGET
+inline __m256i LoadRgb24AsBgra8Avx2(const quint8* sourceBytesPtr)
+{
+	const __m256i shuffleMask = _mm256_setr_epi8(
+				2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+				2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+
+	const __m256i pixels = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr))),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + 12)),
+				1);
+
+	return _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffleMask), _mm256_set1_epi32(int(0xff000000)));
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertGray8ToBgra8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m256i multiplier = _mm256_set1_epi32(0x010101);
+	const __m256i alpha = _mm256_set1_epi32(int(0xff000000));
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBytesPtr + x));
+		__m256i* outputPtr = reinterpret_cast<__m256i*>(destBytesPtr + x * 4);
+
+		const __m256i grayLow = _mm256_cvtepu8_epi32(gray);
+		const __m256i grayHigh = _mm256_cvtepu8_epi32(_mm_srli_si128(gray, 8));
+
+		_mm256_storeu_si256(outputPtr, _mm256_or_si256(_mm256_mullo_epi32(grayLow, multiplier), alpha));
+		_mm256_storeu_si256(outputPtr + 1, _mm256_or_si256(_mm256_mullo_epi32(grayHigh, multiplier), alpha));
+	}
+
+	ConvertGray8ToBgra8(sourceBytesPtr + x, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertBgra8ToGray8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 32 <= pixelsCount; x += 32){
+		const __m256i* inputPtr = reinterpret_cast<const __m256i*>(sourceBytesPtr + x * 4);
+
+		const __m256i gray0 = CalcBgra8GrayAvx2(_mm256_loadu_si256(inputPtr), _mm256_loadu_si256(inputPtr + 1));
+		const __m256i gray1 = CalcBgra8GrayAvx2(_mm256_loadu_si256(inputPtr + 2), _mm256_loadu_si256(inputPtr + 3));
+
+		// the gray values are already packed to 16-bit, so the same permutation as for 32-bit packing is used
+		const __m256i packed = _mm256_packus_epi16(gray0, gray1);
+
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(destBytesPtr + x),
+					_mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+	}
+
+	ConvertBgra8ToGray8(sourceBytesPtr + x * 4, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertRgb24ToBgra8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	// the last load reads 4 bytes after 8 pixels, so 2 more pixels have to be available
+	int x = 0;
+	for (; x + 10 <= pixelsCount; x += 8){
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destBytesPtr + x * 4), LoadRgb24AsBgra8Avx2(sourceBytesPtr + x * 3));
+	}
+
+	ConvertRgb24ToBgra8(sourceBytesPtr + x * 3, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertRgb24ToGray8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 34 <= pixelsCount; x += 32){
+		const quint8* inputPtr = sourceBytesPtr + x * 3;
+
+		const __m256i gray0 = CalcBgra8GrayAvx2(LoadRgb24AsBgra8Avx2(inputPtr), LoadRgb24AsBgra8Avx2(inputPtr + 24));
+		const __m256i gray1 = CalcBgra8GrayAvx2(LoadRgb24AsBgra8Avx2(inputPtr + 48), LoadRgb24AsBgra8Avx2(inputPtr + 72));
+
+		const __m256i packed = _mm256_packus_epi16(gray0, gray1);
+
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(destBytesPtr + x),
+					_mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+	}
+
+	ConvertRgb24ToGray8(sourceBytesPtr + x * 3, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertBgra8ToRgb24Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m256i shuffleMask = _mm256_setr_epi8(
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	// each store writes 4 bytes more, they are overwritten by the next pixels
+	int x = 0;
+	for (; x + 10 <= pixelsCount; x += 8){
+		const __m256i pixels = _mm256_shuffle_epi8(
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceBytesPtr + x * 4)),
+					shuffleMask);
+
+		quint8* outputPtr = destBytesPtr + x * 3;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputPtr), _mm256_castsi256_si128(pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputPtr + 12), _mm256_extracti128_si256(pixels, 1));
+	}
+
+	ConvertBgra8ToRgb24(sourceBytesPtr + x * 4, destBytesPtr + x * 3, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertGray16ToGray8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m256i rounding = _mm256_set1_epi16(0x80);
+
+	int x = 0;
+	for (; x + 32 <= pixelsCount; x += 32){
+		const __m256i* inputPtr = reinterpret_cast<const __m256i*>(sourceValuesPtr + x);
+
+		__m256i values0 = _mm256_loadu_si256(inputPtr);
+		__m256i values1 = _mm256_loadu_si256(inputPtr + 1);
+		values0 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_sub_epi16(values0, _mm256_srli_epi16(values0, 8)), rounding), 8);
+		values1 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_sub_epi16(values1, _mm256_srli_epi16(values1, 8)), rounding), 8);
+
+		_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(destBytesPtr + x),
+					_mm256_permute4x64_epi64(_mm256_packus_epi16(values0, values1), 0xd8));
+	}
+
+	ConvertGray16ToGray8(sourceValuesPtr + x, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+ACF_PIXEL_AVX2_TARGET
+void ConvertFloat32ToGray8Avx2(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const float* sourceValuesPtr = static_cast<const float*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	const __m256 scale = _mm256_set1_ps(float(mapping.scale * 255));
+	const __m256 offset = _mm256_set1_ps(float(mapping.offset * 255));
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 maxValue = _mm256_set1_ps(255.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	int x = 0;
+	for (; x + 32 <= pixelsCount; x += 32){
+		__m256i values[4];
+
+		for (int i = 0; i < 4; ++i){
+			__m256 value = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(sourceValuesPtr + x + i * 8), scale), offset);
+
+			// maximum with the second operand zero replaces NaN values too
+			value = _mm256_min_ps(_mm256_max_ps(value, zero), maxValue);
+
+			values[i] = _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destBytesPtr + x), PackToBytesAvx2(values[0], values[1], values[2], values[3]));
+	}
+
+	ConvertFloat32ToGray8(sourceValuesPtr + x, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+#endif // ACF_PIXEL_AVX2
+
+
+#if defined(ACF_PIXEL_NEON)
+
+inline uint8x8_t CalcGray8Neon(uint8x8_t red, uint8x8_t green, uint8x8_t blue)
+{
+	uint16x8_t sum = vmull_u8(red, vdup_n_u8(77));
+	sum = vmlal_u8(sum, green, vdup_n_u8(150));
+	sum = vmlal_u8(sum, blue, vdup_n_u8(29));
+
+	return vrshrn_n_u16(sum, 8);
+}
+
+
+void ConvertGray8ToBgra8Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const uint8x16_t gray = vld1q_u8(sourceBytesPtr + x);
+
+		uint8x16x4_t pixels;
+		pixels.val[0] = gray;
+		pixels.val[1] = gray;
+		pixels.val[2] = gray;
+		pixels.val[3] = vdupq_n_u8(255);
+
+		vst4q_u8(destBytesPtr + x * 4, pixels);
+	}
+
+	ConvertGray8ToBgra8(sourceBytesPtr + x, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+void ConvertBgra8ToGray8Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const uint8x16x4_t pixels = vld4q_u8(sourceBytesPtr + x * 4);
+
+		const uint8x8_t grayLow = CalcGray8Neon(vget_low_u8(pixels.val[2]), vget_low_u8(pixels.val[1]), vget_low_u8(pixels.val[0]));
+		const uint8x8_t grayHigh = CalcGray8Neon(vget_high_u8(pixels.val[2]), vget_high_u8(pixels.val[1]), vget_high_u8(pixels.val[0]));
+
+		vst1q_u8(destBytesPtr + x, vcombine_u8(grayLow, grayHigh));
+	}
+
+	ConvertBgra8ToGray8(sourceBytesPtr + x * 4, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertRgb24ToGray8Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const uint8x16x3_t pixels = vld3q_u8(sourceBytesPtr + x * 3);
+
+		const uint8x8_t grayLow = CalcGray8Neon(vget_low_u8(pixels.val[0]), vget_low_u8(pixels.val[1]), vget_low_u8(pixels.val[2]));
+		const uint8x8_t grayHigh = CalcGray8Neon(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]), vget_high_u8(pixels.val[2]));
+
+		vst1q_u8(destBytesPtr + x, vcombine_u8(grayLow, grayHigh));
+	}
+
+	ConvertRgb24ToGray8(sourceBytesPtr + x * 3, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+
+void ConvertRgb24ToBgra8Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const uint8x16x3_t rgbPixels = vld3q_u8(sourceBytesPtr + x * 3);
+
+		uint8x16x4_t pixels;
+		pixels.val[0] = rgbPixels.val[2];
+		pixels.val[1] = rgbPixels.val[1];
+		pixels.val[2] = rgbPixels.val[0];
+		pixels.val[3] = vdupq_n_u8(255);
+
+		vst4q_u8(destBytesPtr + x * 4, pixels);
+	}
+
+	ConvertRgb24ToBgra8(sourceBytesPtr + x * 3, destBytesPtr + x * 4, pixelsCount - x, mapping);
+}
+
+
+void ConvertBgra8ToRgb24Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint8* sourceBytesPtr = static_cast<const quint8*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		const uint8x16x4_t pixels = vld4q_u8(sourceBytesPtr + x * 4);
+
+		uint8x16x3_t rgbPixels;
+		rgbPixels.val[0] = pixels.val[2];
+		rgbPixels.val[1] = pixels.val[1];
+		rgbPixels.val[2] = pixels.val[0];
+
+		vst3q_u8(destBytesPtr + x * 3, rgbPixels);
+	}
+
+	ConvertBgra8ToRgb24(sourceBytesPtr + x * 4, destBytesPtr + x * 3, pixelsCount - x, mapping);
+}
+
+
+void ConvertGray16ToGray8Neon(const void* sourcePtr, void* destPtr, int pixelsCount, const ValueMapping& mapping)
+{
+	const quint16* sourceValuesPtr = static_cast<const quint16*>(sourcePtr);
+	quint8* destBytesPtr = static_cast<quint8*>(destPtr);
+
+	int x = 0;
+	for (; x + 16 <= pixelsCount; x += 16){
+		uint16x8_t values0 = vld1q_u16(sourceValuesPtr + x);
+		uint16x8_t values1 = vld1q_u16(sourceValuesPtr + x + 8);
+		values0 = vaddq_u16(vsubq_u16(values0, vshrq_n_u16(values0, 8)), vdupq_n_u16(0x80));
+		values1 = vaddq_u16(vsubq_u16(values1, vshrq_n_u16(values1, 8)), vdupq_n_u16(0x80));
+
+		vst1q_u8(destBytesPtr + x, vcombine_u8(vshrn_n_u16(values0, 8), vshrn_n_u16(values1, 8)));
+	}
+
+	ConvertGray16ToGray8(sourceValuesPtr + x, destBytesPtr + x, pixelsCount - x, mapping);
+}
+
+#endif // ACF_PIXEL_NEON
+
+
+/**
+	Table of conversion functions indexed by pixel format.
+	The kernels are selected once according to the processor features.
+*/
+struct ConversionTable
+{
+	ConversionTable();
+
+	LineConverter converters[FORMATS_COUNT][FORMATS_COUNT];
+	LineDecoder decoders[FORMATS_COUNT];
+	LineEncoder encoders[FORMATS_COUNT];
+
+private:
+	void SetColorConverter(IBitmap::PixelFormat sourceFormat, IBitmap::PixelFormat destFormat, LineConverter converter);
+};
+
+
+ConversionTable::ConversionTable()
+{
+	std::memset(converters, 0, sizeof(converters));
+	std::memset(decoders, 0, sizeof(decoders));
+	std::memset(encoders, 0, sizeof(encoders));
+
+	decoders[IBitmap::PF_GRAY] = DecodeGray8;
+	decoders[IBitmap::PF_GRAY16] = DecodeGray16;
+	decoders[IBitmap::PF_GRAY32] = DecodeMappedValues<quint32>;
+	decoders[IBitmap::PF_FLOAT32] = DecodeMappedValues<float>;
+	decoders[IBitmap::PF_FLOAT64] = DecodeMappedValues<double>;
+	decoders[IBitmap::PF_RGB] = DecodeBgra8<false>;
+	decoders[IBitmap::PF_RGBA] = DecodeBgra8<true>;
+	decoders[IBitmap::PF_RGB24] = DecodeRgb24;
+	decoders[IBitmap::PF_RGB48] = DecodeRgb48;
+	decoders[IBitmap::PF_RGBA64] = DecodeRgba64;
+
+	encoders[IBitmap::PF_GRAY] = EncodeGray8;
+	encoders[IBitmap::PF_GRAY16] = EncodeGray16;
+	encoders[IBitmap::PF_GRAY32] = EncodeGray32;
+	encoders[IBitmap::PF_FLOAT32] = EncodeFloat<float>;
+	encoders[IBitmap::PF_FLOAT64] = EncodeFloat<double>;
+	encoders[IBitmap::PF_RGB] = EncodeBgra8<false>;
+	encoders[IBitmap::PF_RGBA] = EncodeBgra8<true>;
+	encoders[IBitmap::PF_RGB24] = EncodeRgb24;
+	encoders[IBitmap::PF_RGB48] = EncodeRgb48;
+	encoders[IBitmap::PF_RGBA64] = EncodeRgba64;
+
+	// direct conversions of single channel formats with value mapping
+	converters[IBitmap::PF_GRAY32][IBitmap::PF_GRAY32] = ConvertMappedValues<quint32, quint32>;
+	converters[IBitmap::PF_GRAY32][IBitmap::PF_FLOAT32] = ConvertMappedValues<quint32, float>;
+	converters[IBitmap::PF_GRAY32][IBitmap::PF_FLOAT64] = ConvertMappedValues<quint32, double>;
+	converters[IBitmap::PF_FLOAT32][IBitmap::PF_GRAY32] = ConvertMappedValues<float, quint32>;
+	converters[IBitmap::PF_FLOAT32][IBitmap::PF_FLOAT32] = ConvertMappedValues<float, float>;
+	converters[IBitmap::PF_FLOAT32][IBitmap::PF_FLOAT64] = ConvertMappedValues<float, double>;
+	converters[IBitmap::PF_FLOAT64][IBitmap::PF_GRAY32] = ConvertMappedValues<double, quint32>;
+	converters[IBitmap::PF_FLOAT64][IBitmap::PF_FLOAT32] = ConvertMappedValues<double, float>;
+	converters[IBitmap::PF_FLOAT64][IBitmap::PF_FLOAT64] = ConvertMappedValues<double, double>;
+
+	// direct conversions of 8-bit formats
+	SetColorConverter(IBitmap::PF_GRAY, IBitmap::PF_RGB, ConvertGray8ToBgra8);
+	SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_GRAY, ConvertBgra8ToGray8);
+	SetColorConverter(IBitmap::PF_RGB24, IBitmap::PF_RGB, ConvertRgb24ToBgra8);
+	SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_RGB24, ConvertBgra8ToRgb24);
+	converters[IBitmap::PF_GRAY][IBitmap::PF_RGB24] = ConvertGray8ToRgb24;
+	converters[IBitmap::PF_RGB24][IBitmap::PF_GRAY] = ConvertRgb24ToGray8;
+	converters[IBitmap::PF_RGB][IBitmap::PF_RGBA] = ConvertBgra8ToBgrx8;
+	converters[IBitmap::PF_RGBA][IBitmap::PF_RGB] = ConvertBgra8ToBgrx8;
+	converters[IBitmap::PF_GRAY16][IBitmap::PF_GRAY] = ConvertGray16ToGray8;
+	converters[IBitmap::PF_GRAY][IBitmap::PF_GRAY16] = ConvertGray8ToGray16;
+	converters[IBitmap::PF_FLOAT32][IBitmap::PF_GRAY] = ConvertFloat32ToGray8;
+	converters[IBitmap::PF_GRAY][IBitmap::PF_FLOAT32] = ConvertGray8ToFloat32;
+
+#if defined(ACF_PIXEL_SSE2)
+	SetColorConverter(IBitmap::PF_GRAY, IBitmap::PF_RGB, ConvertGray8ToBgra8Sse2);
+	SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_GRAY, ConvertBgra8ToGray8Sse2);
+	converters[IBitmap::PF_RGB][IBitmap::PF_RGBA] = ConvertBgra8ToBgrx8Sse2;
+	converters[IBitmap::PF_RGBA][IBitmap::PF_RGB] = ConvertBgra8ToBgrx8Sse2;
+	converters[IBitmap::PF_GRAY16][IBitmap::PF_GRAY] = ConvertGray16ToGray8Sse2;
+	converters[IBitmap::PF_GRAY][IBitmap::PF_GRAY16] = ConvertGray8ToGray16Sse2;
+	converters[IBitmap::PF_FLOAT32][IBitmap::PF_GRAY] = ConvertFloat32ToGray8Sse2;
+	converters[IBitmap::PF_GRAY][IBitmap::PF_FLOAT32] = ConvertGray8ToFloat32Sse2;
+#endif
+
+#if defined(ACF_PIXEL_AVX2)
+	if (IsAvx2Supported()){
+		SetColorConverter(IBitmap::PF_GRAY, IBitmap::PF_RGB, ConvertGray8ToBgra8Avx2);
+		SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_GRAY, ConvertBgra8ToGray8Avx2);
+		SetColorConverter(IBitmap::PF_RGB24, IBitmap::PF_RGB, ConvertRgb24ToBgra8Avx2);
+		SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_RGB24, ConvertBgra8ToRgb24Avx2);
+		converters[IBitmap::PF_RGB24][IBitmap::PF_GRAY] = ConvertRgb24ToGray8Avx2;
+		converters[IBitmap::PF_GRAY16][IBitmap::PF_GRAY] = ConvertGray16ToGray8Avx2;
+		converters[IBitmap::PF_FLOAT32][IBitmap::PF_GRAY] = ConvertFloat32ToGray8Avx2;
+	}
+#endif
+
+#if defined(ACF_PIXEL_NEON)
+	SetColorConverter(IBitmap::PF_GRAY, IBitmap::PF_RGB, ConvertGray8ToBgra8Neon);
+	SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_GRAY, ConvertBgra8ToGray8Neon);
+	SetColorConverter(IBitmap::PF_RGB24, IBitmap::PF_RGB, ConvertRgb24ToBgra8Neon);
+	SetColorConverter(IBitmap::PF_RGB, IBitmap::PF_RGB24, ConvertBgra8ToRgb24Neon);
+	converters[IBitmap::PF_RGB24][IBitmap::PF_GRAY] = ConvertRgb24ToGray8Neon;
+	converters[IBitmap::PF_GRAY16][IBitmap::PF_GRAY] = ConvertGray16ToGray8Neon;
+#endif
+}
+
+
+/**
+	Set converter for both 32-bit color formats.
+	Alpha channel of \c PF_RGB pixels is always opaque, so the same kernels are used for \c PF_RGB and \c PF_RGBA formats.
+*/
+void ConversionTable::SetColorConverter(IBitmap::PixelFormat sourceFormat, IBitmap::PixelFormat destFormat, LineConverter converter)
+{
+	converters[sourceFormat][destFormat] = converter;
+
+	if (sourceFormat == IBitmap::PF_RGB){
+		converters[IBitmap::PF_RGBA][destFormat] = converter;
+	}
+
+	if (destFormat == IBitmap::PF_RGB){
+		converters[sourceFormat][IBitmap::PF_RGBA] = converter;
+	}
+}
+
+
+const ConversionTable& GetConversionTable()
+{
+	static const ConversionTable table;
+
+	return table;
+}
+
+
+/**
+	Convert pixels of formats already checked by \c CPixelFormatConverter::IsConversionSupported.
+*/
+void ConvertPixels(
+			const ConversionTable& table,
+			IBitmap::PixelFormat sourceFormat,
+			IBitmap::PixelFormat destFormat,
+			const void* sourcePtr,
+			void* destPtr,
+			int pixelsCount,
+			const ValueMapping& mapping)
+{
+	if ((sourceFormat == destFormat) && (!IsMappedFormat(sourceFormat) || IsIdentityMapping(mapping))){
+		std::memcpy(destPtr, sourcePtr, (size_t(pixelsCount) * size_t(GetPixelBitsCount(sourceFormat)) + 7) >> 3);
+
+		return;
+	}
+
+	LineConverter converter = table.converters[sourceFormat][destFormat];
+	if (converter != NULL){
+		converter(sourcePtr, destPtr, pixelsCount, mapping);
+
+		return;
+	}
+
+	LineDecoder decoder = table.decoders[sourceFormat];
+	LineEncoder encoder = table.encoders[destFormat];
+	Q_ASSERT(decoder != NULL);
+	Q_ASSERT(encoder != NULL);
+
+	const int sourcePixelBytes = GetPixelBitsCount(sourceFormat) >> 3;
+	const int destPixelBytes = GetPixelBitsCount(destFormat) >> 3;
+
+	quint16 rgbaBuffer[INTERMEDIATE_PIXELS_COUNT * 4];
+
+	for (int x = 0; x < pixelsCount; x += INTERMEDIATE_PIXELS_COUNT){
+		const int partPixelsCount = qMin(pixelsCount - x, int(INTERMEDIATE_PIXELS_COUNT));
+
+		decoder(static_cast<const quint8*>(sourcePtr) + x * sourcePixelBytes, rgbaBuffer, partPixelsCount, mapping);
+		encoder(rgbaBuffer, static_cast<quint8*>(destPtr) + x * destPixelBytes, partPixelsCount);
+	}
+}
+
+
+template <typename ValueType>
+void CalcRange(const void* valuesPtr, int valuesCount, double& minValue, double& maxValue)
+{
+	const ValueType* typedValuesPtr = static_cast<const ValueType*>(valuesPtr);
+
+	ValueType minTypedValue = std::numeric_limits<ValueType>::max();
+	ValueType maxTypedValue = std::numeric_limits<ValueType>::lowest();
+
+	// NaN values are ignored, because all comparisons with them fail
+	for (int x = 0; x < valuesCount; ++x){
+		const ValueType value = typedValuesPtr[x];
+
+		if (value < minTypedValue){
+			minTypedValue = value;
+		}
+
+		if (value > maxTypedValue){
+			maxTypedValue = value;
+		}
+	}
+
+	if (minTypedValue <= maxTypedValue){
+		minValue = qMin(minValue, double(minTypedValue));
+		maxValue = qMax(maxValue, double(maxTypedValue));
+	}
+}
+
+
+#if defined(ACF_PIXEL_SSE2)
+
+template <>
+void CalcRange<float>(const void* valuesPtr, int valuesCount, double& minValue, double& maxValue)
+{
+	float minTypedValue = std::numeric_limits<float>::max();
+	float maxTypedValue = std::numeric_limits<float>::lowest();
+
+	CalcFloat32RangeSse2(static_cast<const float*>(valuesPtr), valuesCount, minTypedValue, maxTypedValue);
+
+	if (minTypedValue <= maxTypedValue){
+		minValue = qMin(minValue, double(minTypedValue));
+		maxValue = qMax(maxValue, double(maxTypedValue));
+	}
+}
+
+#endif
+
+
+} // namespace
+
+
+// public methods of embedded struct ValueMapping
+
+CPixelFormatConverter::ValueMapping::ValueMapping(double scale, double offset)
+:	scale(scale),
+	offset(offset)
+{
+}
+
+
+CPixelFormatConverter::ValueMapping CPixelFormatConverter::ValueMapping::FromRange(double minValue, double maxValue)
+{
+	if (maxValue > minValue){
+		const double scale = 1.0 / (maxValue - minValue);
+
+		return ValueMapping(scale, -minValue * scale);
+	}
+
+	return ValueMapping(0.0, 0.0);
+}
+
+
+// public static methods
+
+bool CPixelFormatConverter::IsConversionSupported(IBitmap::PixelFormat sourceFormat, IBitmap::PixelFormat destFormat)
+{
+	if ((sourceFormat < 0) || (int(sourceFormat) >= FORMATS_COUNT) || (destFormat < 0) || (int(destFormat) >= FORMATS_COUNT)){
+		return false;
+	}
+
+	if (sourceFormat == destFormat){
+		return GetPixelBitsCount(sourceFormat) > 0;
+	}
+
+	const ConversionTable& table = GetConversionTable();
+
+	return (table.decoders[sourceFormat] != NULL) && (table.encoders[destFormat] != NULL);
+}
+
+
+bool CPixelFormatConverter::ConvertLine(
+			IBitmap::PixelFormat sourceFormat,
+			IBitmap::PixelFormat destFormat,
+			const void* sourcePtr,
+			void* destPtr,
+			int pixelsCount,
+			const ValueMapping& mapping)
+{
+	if (!IsConversionSupported(sourceFormat, destFormat)){
+		return false;
+	}
+
+	if (pixelsCount > 0){
+		ConvertPixels(GetConversionTable(), sourceFormat, destFormat, sourcePtr, destPtr, pixelsCount, mapping);
+	}
+
+	return true;
+}
+
+
+bool CPixelFormatConverter::ConvertLines(
+			IBitmap::PixelFormat sourceFormat,
+			IBitmap::PixelFormat destFormat,
+			const istd::CIndex2d& size,
+			const void* sourcePtr,
+			int sourceLinesDifference,
+			void* destPtr,
+			int destLinesDifference,
+			const ValueMapping& mapping)
+{
+	if (!IsConversionSupported(sourceFormat, destFormat)){
+		return false;
+	}
+
+	if (size.IsSizeEmpty()){
+		return true;
+	}
+
+	const ConversionTable& table = GetConversionTable();
+	const int width = size.GetX();
+
+	const int linesCount = size.GetY();
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, qint64(width) * linesCount);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+		const quint8* sourceLinePtr = static_cast<const quint8*>(sourcePtr) + qint64(beginLine) * sourceLinesDifference;
+		quint8* destLinePtr = static_cast<quint8*>(destPtr) + qint64(beginLine) * destLinesDifference;
+
+		for (int y = beginLine; y < endLine; ++y){
+			ConvertPixels(table, sourceFormat, destFormat, sourceLinePtr, destLinePtr, width, mapping);
+
+			sourceLinePtr += sourceLinesDifference;
+			destLinePtr += destLinesDifference;
+		}
+	});
+
+	return true;
+}
+
+
+bool CPixelFormatConverter::ConvertBitmap(
+			const IBitmap& sourceBitmap,
+			IBitmap::PixelFormat destFormat,
+			IBitmap& destBitmap,
+			const ValueMapping& mapping)
+{
+	const IBitmap::PixelFormat sourceFormat = sourceBitmap.GetPixelFormat();
+	if (!IsConversionSupported(sourceFormat, destFormat)){
+		return false;
+	}
+
+	// in-place conversion is not possible, because the destination bitmap is created again
+	if (&sourceBitmap == &destBitmap){
+		return (sourceFormat == destFormat) && (!IsMappedFormat(sourceFormat) || IsIdentityMapping(mapping));
+	}
+
+	const istd::CIndex2d size = sourceBitmap.GetImageSize();
+	if (!destBitmap.CreateBitmap(destFormat, size)){
+		return false;
+	}
+
+	if (size.IsSizeEmpty()){
+		return true;
+	}
+
+	return ConvertLines(
+				sourceFormat,
+				destFormat,
+				size,
+				sourceBitmap.GetLinePtr(0),
+				sourceBitmap.GetLinesDifference(),
+				destBitmap.GetLinePtr(0),
+				destBitmap.GetLinesDifference(),
+				mapping);
+}
+
+
+bool CPixelFormatConverter::ConvertUsingColorTable(
+			const IBitmap& sourceBitmap,
+			const quint32* colorTablePtr,
+			IBitmap::PixelFormat destFormat,
+			IBitmap& destBitmap)
+{
+	Q_ASSERT(colorTablePtr != NULL);
+
+	if ((sourceBitmap.GetPixelFormat() != IBitmap::PF_GRAY) || ((destFormat != IBitmap::PF_RGB) && (destFormat != IBitmap::PF_RGBA))){
+		return false;
+	}
+
+	if (&sourceBitmap == &destBitmap){
+		return false;
+	}
+
+	const istd::CIndex2d size = sourceBitmap.GetImageSize();
+	if (!destBitmap.CreateBitmap(destFormat, size)){
+		return false;
+	}
+
+	if (size.IsSizeEmpty()){
+		return true;
+	}
+
+	quint32 colorTable[256];
+	const quint32 alphaMask = (destFormat == IBitmap::PF_RGB)? 0xff000000: 0;
+	for (int i = 0; i < 256; ++i){
+		colorTable[i] = colorTablePtr[i] | alphaMask;
+	}
+
+	const int width = size.GetX();
+	const quint8* sourcePtr = static_cast<const quint8*>(sourceBitmap.GetLinePtr(0));
+	const int sourceLinesDifference = sourceBitmap.GetLinesDifference();
+	quint8* destPtr = static_cast<quint8*>(destBitmap.GetLinePtr(0));
+	const int destLinesDifference = destBitmap.GetLinesDifference();
+
+	const int linesCount = size.GetY();
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, qint64(width) * linesCount);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+		for (int y = beginLine; y < endLine; ++y){
+			const quint8* sourceLinePtr = sourcePtr + qint64(y) * sourceLinesDifference;
+			quint32* destLinePtr = reinterpret_cast<quint32*>(destPtr + qint64(y) * destLinesDifference);
+
+			for (int x = 0; x < width; ++x){
+				destLinePtr[x] = colorTable[sourceLinePtr[x]];
+			}
+		}
+	});
+
+	return true;
+}
+
+
+bool CPixelFormatConverter::CalcValueRange(const IBitmap& bitmap, double& minValue, double& maxValue)
+{
+	typedef void (*RangeFunction)(const void* valuesPtr, int valuesCount, double& minValue, double& maxValue);
+
+	RangeFunction rangeFunction = NULL;
+	double normalizeFactor = 1.0;
+
+	switch (bitmap.GetPixelFormat()){
+	case IBitmap::PF_GRAY:
+		rangeFunction = CalcRange<quint8>;
+		normalizeFactor = 1.0 / 255.0;
+		break;
+
+	case IBitmap::PF_GRAY16:
+		rangeFunction = CalcRange<quint16>;
+		normalizeFactor = 1.0 / 65535.0;
+		break;
+
+	case IBitmap::PF_GRAY32:
+		rangeFunction = CalcRange<quint32>;
+		normalizeFactor = ValueTraits<quint32>::GetNormalizeFactor();
+		break;
+
+	case IBitmap::PF_FLOAT32:
+		rangeFunction = CalcRange<float>;
+		break;
+
+	case IBitmap::PF_FLOAT64:
+		rangeFunction = CalcRange<double>;
+		break;
+
+	default:
+		return false;
+	}
+
+	const istd::CIndex2d size = bitmap.GetImageSize();
+	if (size.IsSizeEmpty()){
+		return false;
+	}
+
+	const int width = size.GetX();
+	const quint8* bitmapPtr = static_cast<const quint8*>(bitmap.GetLinePtr(0));
+	const int linesDifference = bitmap.GetLinesDifference();
+
+	double rawMinValue = std::numeric_limits<double>::max();
+	double rawMaxValue = std::numeric_limits<double>::lowest();
+	QMutex rangeLock;
+
+	const int linesCount = size.GetY();
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, qint64(width) * linesCount);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+		double bandMinValue = std::numeric_limits<double>::max();
+		double bandMaxValue = std::numeric_limits<double>::lowest();
+
+		for (int y = beginLine; y < endLine; ++y){
+			rangeFunction(bitmapPtr + qint64(y) * linesDifference, width, bandMinValue, bandMaxValue);
+		}
+
+		QMutexLocker lock(&rangeLock);
+
+		rawMinValue = qMin(rawMinValue, bandMinValue);
+		rawMaxValue = qMax(rawMaxValue, bandMaxValue);
+	});
+
+	if (rawMinValue > rawMaxValue){
+		return false;
+	}
+
+	minValue = rawMinValue * normalizeFactor;
+	maxValue = rawMaxValue * normalizeFactor;
+
+	return true;
+}
+
+
+} // namespace iimg
+
+
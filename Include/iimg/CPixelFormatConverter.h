@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// ACF includes
+#include <istd/CIndex2d.h>
+#include <iimg/IBitmap.h>
+
+
+namespace iimg
+{
+
+
+/**
+	Conversion of bitmap data between pixel formats.
+
+	The conversion is table driven, each pair of supported formats has its own line conversion.
+	Pairs used for the display of images (8-bit gray and color formats, 16-bit and floating point gray formats) are converted by direct kernels,
+	which are vectorized using SSE2 and AVX2 on x86 processors and using NEON on ARM processors.
+	The kernel set is selected once according to the processor features.
+	All other pairs are converted through an intermediate line of 16-bit RGBA values.
+	Large bitmaps are split into bands of scanlines processed by the global thread pool.
+
+	Supported formats are \c PF_GRAY, \c PF_GRAY16, \c PF_GRAY32, \c PF_FLOAT32, \c PF_FLOAT64, \c PF_RGB, \c PF_RGBA, \c PF_RGB24, \c PF_RGB48 and \c PF_RGBA64.
+	Data of other formats can be only copied to the same format.
+	The memory layout of components follows the Qt image formats:
+	\c PF_RGB and \c PF_RGBA pixels are stored as B, G, R, A bytes, \c PF_RGB24, \c PF_RGB48 and \c PF_RGBA64 as R, G, B (, A) components.
+	Gray values of color pixels are calculated using ITU-R BT.601 weights.
+	Floating point values are expected in range [0, 1], \c PF_GRAY32 values use the whole 32-bit range.
+
+	\ingroup ImageProcessing
+*/
+class CPixelFormatConverter
+{
+public:
+	/**
+		Linear mapping of source values, it is used for \c PF_GRAY32, \c PF_FLOAT32 and \c PF_FLOAT64 source formats only.
+		The mapping is applied to normalized source values (the same as returned by \c IBitmap::GetColorAt),
+		mapped value 1 corresponds to the maximal value of the destination format.
+		Mapped values out of range [0, 1] are clamped for integer destination formats, NaN values are converted to 0.
+	*/
+	struct ValueMapping
+	{
+		ValueMapping(double scale = 1.0, double offset = 0.0);
+
+		/**
+			Get mapping of given value range to range [0, 1].
+		*/
+		static ValueMapping FromRange(double minValue, double maxValue);
+
+		double scale;
+		double offset;
+	};
+
+	/**
+		Check if conversion between two formats is supported.
+	*/
+	static bool IsConversionSupported(IBitmap::PixelFormat sourceFormat, IBitmap::PixelFormat destFormat);
+
+	/**
+		Convert a single line of pixels.
+		\param	sourcePtr	pointer to the source pixels.
+		\param	destPtr		pointer to the destination pixels, it cannot overlap the source pixels.
+		\param	pixelsCount	number of pixels to convert.
+	*/
+	static bool ConvertLine(
+				IBitmap::PixelFormat sourceFormat,
+				IBitmap::PixelFormat destFormat,
+				const void* sourcePtr,
+				void* destPtr,
+				int pixelsCount,
+				const ValueMapping& mapping = ValueMapping());
+
+	/**
+		Convert block of lines.
+		\param	size					size of the converted block in pixels.
+		\param	sourcePtr				pointer to the first source line.
+		\param	sourceLinesDifference	address difference between next and previous source line.
+		\param	destPtr					pointer to the first destination line.
+		\param	destLinesDifference		address difference between next and previous destination line.
+	*/
+	static bool ConvertLines(
+				IBitmap::PixelFormat sourceFormat,
+				IBitmap::PixelFormat destFormat,
+				const istd::CIndex2d& size,
+				const void* sourcePtr,
+				int sourceLinesDifference,
+				void* destPtr,
+				int destLinesDifference,
+				const ValueMapping& mapping = ValueMapping());
+
+	/**
+		Convert bitmap to another pixel format.
+		The destination bitmap will be created with the source size and the destination format.
+	*/
+	static bool ConvertBitmap(
+				const IBitmap& sourceBitmap,
+				IBitmap::PixelFormat destFormat,
+				IBitmap& destBitmap,
+				const ValueMapping& mapping = ValueMapping());
+
+	/**
+		Convert 8-bit gray bitmap to color bitmap using color table.
+		\param	colorTablePtr	pointer to 256 colors in ARGB format (the same as \c QRgb).
+		\param	destFormat		format of the destination bitmap, it can be \c PF_RGB or \c PF_RGBA.
+	*/
+	static bool ConvertUsingColorTable(
+				const IBitmap& sourceBitmap,
+				const quint32* colorTablePtr,
+				IBitmap::PixelFormat destFormat,
+				IBitmap& destBitmap);
+
+	/**
+		Calculate range of normalized values of a single channel bitmap.
+		NaN values are ignored.
+		\return	true, if the format is supported and at least one valid value was found.
+	*/
+	static bool CalcValueRange(const IBitmap& bitmap, double& minValue, double& maxValue);
+};
+
+
+} // namespace iimg
+
+
@@ -4,7 +4,8 @@
 
 
 // STL includes
-#include <set>
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 // Qt includes
@@ -16,6 +17,7 @@
 #endif
 
 // ACF includes
+#include <istd/CParallelFor.h>
 #include <iser/CPrimitiveTypesSerializer.h>
 
 
@@ -23,10 +25,627 @@ namespace iimg
 {
 
 
+namespace
+{
+
+
+/**
+	Ratio of the costs of processing a single pixel by distance transformation and of processing a single switch point by the run based morphology.
+	Circular structuring elements are applied using distance transformation, if it is cheaper according to this ratio.
+*/
+static const qint64 s_distanceTransformCostRatio = 4;
+
+/**
+	Maximal radius of the circular structuring element applied using distance transformation (distances are stored as 16-bit values).
+*/
+static const int s_maxDistanceTransformRadius = 65533;
+
+/**
+	Maximal number of pixels of the area processed by distance transformation.
+*/
+static const qint64 s_maxDistanceTransformArea = qint64(1) << 30;
+
+/**
+	Coordinate limit closing the open runs stored by older versions.
+	It leaves enough space for translation and morphology without integer overflow.
+*/
+static const int s_openRunLimit = 1 << 28;
+
+
+/**
+	Remove unused space between lines.
+	\param	pointsCounts	real number of switch points of each line.
+	\param	switchPoints	switch points, each line begins at its offset.
+	\param	lineOffsets		offsets of lines, they will be updated to the compacted positions.
+*/
+void CompactLines(const std::vector<int>& pointsCounts, CScanlineMask::SwitchPoints& switchPoints, CScanlineMask::LineOffsets& lineOffsets)
+{
+	const int linesCount = int(pointsCounts.size());
+	Q_ASSERT(int(lineOffsets.size()) == linesCount + 1);
+
+	int writePosition = 0;
+	for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+		const int readPosition = lineOffsets[lineIndex];
+		const int pointsCount = pointsCounts[lineIndex];
+		Q_ASSERT(readPosition + pointsCount <= lineOffsets[lineIndex + 1]);
+
+		lineOffsets[lineIndex] = writePosition;
+
+		if ((writePosition != readPosition) && (pointsCount > 0)){
+			std::copy(switchPoints.begin() + readPosition, switchPoints.begin() + readPosition + pointsCount, switchPoints.begin() + writePosition);
+		}
+
+		writePosition += pointsCount;
+	}
+
+	lineOffsets[linesCount] = writePosition;
+	switchPoints.resize(writePosition);
+}
+
+
+/**
+	Build switch points of lines.
+	\param	boundFunction	function returning maximal number of switch points of the line.
+	\param	lineFunction	function calculating switch points of the line, it returns the real number of switch points.
+*/
+template <typename BoundFunction, typename LineFunction>
+void BuildLines(
+			int linesCount,
+			BoundFunction boundFunction,
+			LineFunction lineFunction,
+			CScanlineMask::SwitchPoints& switchPoints,
+			CScanlineMask::LineOffsets& lineOffsets)
+{
+	linesCount = qMax(linesCount, 0);
+
+	lineOffsets.resize(linesCount + 1);
+	lineOffsets[0] = 0;
+	for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+		lineOffsets[lineIndex + 1] = lineOffsets[lineIndex] + boundFunction(lineIndex);
+	}
+
+	switchPoints.resize(lineOffsets[linesCount]);
+
+	std::vector<int> pointsCounts(linesCount);
+
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, lineOffsets[linesCount]);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+		for (int lineIndex = beginLine; lineIndex < endLine; ++lineIndex){
+			pointsCounts[lineIndex] = lineFunction(lineIndex, switchPoints.data() + lineOffsets[lineIndex]);
+		}
+	});
+
+	CompactLines(pointsCounts, switchPoints, lineOffsets);
+}
+
+
+/**
+	Build switch points of lines calculated band by band, it is used if no usable bound of the line size is known.
+	\param	workAmount		estimated number of processed pixels or switch points.
+	\param	bandFunction	function calculating lines in range [beginLine, endLine),
+							it appends their switch points to the given container and stores number of switch points of each line.
+*/
+template <typename BandFunction>
+void BuildLinesInBands(
+			int linesCount,
+			qint64 workAmount,
+			BandFunction bandFunction,
+			CScanlineMask::SwitchPoints& switchPoints,
+			CScanlineMask::LineOffsets& lineOffsets)
+{
+	linesCount = qMax(linesCount, 0);
+
+	std::vector<CScanlineMask::SwitchPoints> bandsPoints(linesCount);
+	std::vector<int> pointsCounts(linesCount);
+
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, workAmount);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+		bandFunction(beginLine, endLine, bandsPoints[beginLine], pointsCounts);
+	});
+
+	lineOffsets.resize(linesCount + 1);
+	lineOffsets[0] = 0;
+	for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+		lineOffsets[lineIndex + 1] = lineOffsets[lineIndex] + pointsCounts[lineIndex];
+	}
+
+	switchPoints.resize(lineOffsets[linesCount]);
+
+	for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+		const CScanlineMask::SwitchPoints& bandPoints = bandsPoints[lineIndex];
+		if (!bandPoints.empty()){
+			std::copy(bandPoints.begin(), bandPoints.end(), switchPoints.begin() + lineOffsets[lineIndex]);
+		}
+	}
+}
+
+
+/**
+	Calculate union of the runs of two lines.
+	The result buffer must have place for \c pointsCount + \c points2Count elements.
+	\return	number of the result switch points.
+*/
+int UniteLines(const int* pointsPtr, int pointsCount, const int* points2Ptr, int points2Count, int* resultPtr)
+{
+	if ((points2Count <= 0) || ((pointsCount > 0) && (pointsPtr[pointsCount - 1] < points2Ptr[0]))){
+		std::copy(pointsPtr, pointsPtr + pointsCount, resultPtr);
+		std::copy(points2Ptr, points2Ptr + points2Count, resultPtr + pointsCount);
+
+		return pointsCount + points2Count;
+	}
+
+	if ((pointsCount <= 0) || (points2Ptr[points2Count - 1] < pointsPtr[0])){
+		std::copy(points2Ptr, points2Ptr + points2Count, resultPtr);
+		std::copy(pointsPtr, pointsPtr + pointsCount, resultPtr + points2Count);
+
+		return pointsCount + points2Count;
+	}
+
+	int resultCount = 0;
+	int index = 0;
+	int index2 = 0;
+
+	while ((index < pointsCount) || (index2 < points2Count)){
+		int begin;
+		int end;
+		if ((index2 >= points2Count) || ((index < pointsCount) && (pointsPtr[index] <= points2Ptr[index2]))){
+			begin = pointsPtr[index];
+			end = pointsPtr[index + 1];
+			index += 2;
+		}
+		else{
+			begin = points2Ptr[index2];
+			end = points2Ptr[index2 + 1];
+			index2 += 2;
+		}
+
+		// add all overlapping and touching runs
+		for (;;){
+			if ((index < pointsCount) && (pointsPtr[index] <= end)){
+				end = qMax(end, pointsPtr[index + 1]);
+				index += 2;
+			}
+			else if ((index2 < points2Count) && (points2Ptr[index2] <= end)){
+				end = qMax(end, points2Ptr[index2 + 1]);
+				index2 += 2;
+			}
+			else{
+				break;
+			}
+		}
+
+		resultPtr[resultCount++] = begin;
+		resultPtr[resultCount++] = end;
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Calculate intersection of the runs of two lines.
+	The result buffer must have place for \c pointsCount + \c points2Count elements.
+	\return	number of the result switch points.
+*/
+int IntersectLines(const int* pointsPtr, int pointsCount, const int* points2Ptr, int points2Count, int* resultPtr)
+{
+	if (		(pointsCount <= 0) ||
+				(points2Count <= 0) ||
+				(pointsPtr[pointsCount - 1] <= points2Ptr[0]) ||
+				(points2Ptr[points2Count - 1] <= pointsPtr[0])){
+		return 0;
+	}
+
+	int resultCount = 0;
+	int index = 0;
+	int index2 = 0;
+
+	while ((index < pointsCount) && (index2 < points2Count)){
+		const int begin = qMax(pointsPtr[index], points2Ptr[index2]);
+		const int end = qMin(pointsPtr[index + 1], points2Ptr[index2 + 1]);
+		if (begin < end){
+			resultPtr[resultCount++] = begin;
+			resultPtr[resultCount++] = end;
+		}
+
+		if (pointsPtr[index + 1] < points2Ptr[index2 + 1]){
+			index += 2;
+		}
+		else{
+			index2 += 2;
+		}
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Calculate inverted runs of a line inside of the clipping range.
+	The result buffer must have place for \c pointsCount + 2 elements.
+	\return	number of the result switch points.
+*/
+int InvertLine(const int* pointsPtr, int pointsCount, int clipBegin, int clipEnd, int* resultPtr)
+{
+	int resultCount = 0;
+	int position = clipBegin;
+
+	for (int index = 0; index < pointsCount; index += 2){
+		const int begin = pointsPtr[index];
+		const int end = pointsPtr[index + 1];
+		if (end <= position){
+			continue;
+		}
+
+		if (begin >= clipEnd){
+			break;
+		}
+
+		if (begin > position){
+			resultPtr[resultCount++] = position;
+			resultPtr[resultCount++] = begin;
+		}
+
+		position = end;
+	}
+
+	if (position < clipEnd){
+		resultPtr[resultCount++] = position;
+		resultPtr[resultCount++] = clipEnd;
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Calculate dilatation of runs of a line on place.
+	Negative values cause erosion, for values of different sign the calculation is done in two steps like in \c istd::TRanges.
+	\return	number of the result switch points.
+*/
+int DilateLine(int* pointsPtr, int pointsCount, int leftValue, int rightValue)
+{
+	if (((leftValue < 0) && (rightValue > 0)) || ((leftValue > 0) && (rightValue < 0))){
+		pointsCount = DilateLine(pointsPtr, pointsCount, leftValue, 0);
+
+		return DilateLine(pointsPtr, pointsCount, 0, rightValue);
+	}
+
+	int resultCount = 0;
+	for (int index = 0; index < pointsCount; index += 2){
+		const int begin = pointsPtr[index] - leftValue;
+		const int end = pointsPtr[index + 1] + rightValue;
+		if (begin >= end){
+			continue;	// run is smaller than the erosion kernel
+		}
+
+		if ((resultCount > 0) && (pointsPtr[resultCount - 1] >= begin)){
+			pointsPtr[resultCount - 1] = qMax(pointsPtr[resultCount - 1], end);
+		}
+		else{
+			pointsPtr[resultCount++] = begin;
+			pointsPtr[resultCount++] = end;
+		}
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Get range of lines containing both ranges.
+*/
+istd::CIntRange GetLinesUnion(const istd::CIntRange& linesRange, const istd::CIntRange& linesRange2)
+{
+	if (linesRange.GetLength() <= 0){
+		return linesRange2;
+	}
+
+	if (linesRange2.GetLength() <= 0){
+		return linesRange;
+	}
+
+	return istd::CIntRange(
+				qMin(linesRange.GetMinValue(), linesRange2.GetMinValue()),
+				qMax(linesRange.GetMaxValue(), linesRange2.GetMaxValue()));
+}
+
+
+/**
+	Calculate dilatation of runs of a line with a single run of structuring element.
+	Each run [begin, end) is mapped to [begin + elementBegin, end + elementEnd - 1).
+	The result buffer must have place for \c pointsCount elements.
+	\return	number of the result switch points.
+*/
+int DilateLineByRun(const int* pointsPtr, int pointsCount, int elementBegin, int elementEnd, int* resultPtr)
+{
+	const int extension = elementEnd - 1;
+
+	int resultCount = 0;
+	for (int index = 0; index < pointsCount; index += 2){
+		const int begin = pointsPtr[index] + elementBegin;
+		const int end = pointsPtr[index + 1] + extension;
+
+		if ((resultCount > 0) && (resultPtr[resultCount - 1] >= begin)){
+			resultPtr[resultCount - 1] = qMax(resultPtr[resultCount - 1], end);
+		}
+		else{
+			resultPtr[resultCount++] = begin;
+			resultPtr[resultCount++] = end;
+		}
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Calculate erosion of runs of a line with a single run of structuring element.
+	Each run [begin, end) is mapped to [begin - elementBegin, end - elementEnd + 1), runs shorter than the element are removed.
+	The result buffer must have place for \c pointsCount elements.
+	\return	number of the result switch points.
+*/
+int ErodeLineByRun(const int* pointsPtr, int pointsCount, int elementBegin, int elementEnd, int* resultPtr)
+{
+	const int reduction = elementEnd - 1;
+
+	int resultCount = 0;
+	for (int index = 0; index < pointsCount; index += 2){
+		const int begin = pointsPtr[index] - elementBegin;
+		const int end = pointsPtr[index + 1] - reduction;
+		if (begin < end){
+			resultPtr[resultCount++] = begin;
+			resultPtr[resultCount++] = end;
+		}
+	}
+
+	return resultCount;
+}
+
+
+/**
+	Line of structuring element.
+*/
+struct ElementRow
+{
+	int offsetY;
+	const int* pointsPtr;
+	int pointsCount;
+};
+
+
+/**
+	Working buffers of morphological operations, each thread uses its own instance.
+*/
+struct MorphologyBuffers
+{
+	std::vector<int> runPoints;
+	std::vector<int> resultPoints;
+	std::vector<int> tempPoints;
+};
+
+
+thread_local MorphologyBuffers s_morphologyBuffers;
+
+
+/**
+	Get pointer to the buffer enlarged to the given size.
+*/
+int* ReserveBuffer(std::vector<int>& buffer, int size)
+{
+	if (int(buffer.size()) < size){
+		buffer.resize(size);
+	}
+
+	return buffer.data();
+}
+
+
+/**
+	Calculate half widths of lines of ellipse centered at the origin.
+	Offset (dx, dy) belongs to the ellipse if (dx / radiusX)^2 + (dy / radiusY)^2 <= 1, for a circle it is dx^2 + dy^2 <= radius^2.
+	\return	maximal |dx| for each |dy| beginning from 0, or empty list if the ellipse contains no offset.
+*/
+std::vector<int> CalcEllipseWidths(double radiusX, double radiusY)
+{
+	std::vector<int> widths;
+
+	if (!(radiusX >= 0) || !(radiusY >= 0)){
+		return widths;
+	}
+
+	const double squaredRadiusX = radiusX * radiusX;
+	const double squaredRadiusY = radiusY * radiusY;
+	const bool isCircle = (radiusX == radiusY);
+
+	int width = int(radiusX);
+	for (int offsetY = 0; double(offsetY) * offsetY <= squaredRadiusY; ++offsetY){
+		const double squaredOffsetY = double(offsetY) * offsetY;
+
+		// widths are non increasing with the vertical offset
+		while (width >= 0){
+			const double squaredWidth = double(width) * width;
+			const bool isInside = isCircle?
+						(squaredWidth + squaredOffsetY <= squaredRadiusX):
+						(squaredWidth * squaredRadiusY + squaredOffsetY * squaredRadiusX <= squaredRadiusX * squaredRadiusY);
+			if (isInside){
+				break;
+			}
+
+			--width;
+		}
+
+		if (width < 0){
+			break;
+		}
+
+		widths.push_back(width);
+	}
+
+	return widths;
+}
+
+
+/**
+	Edge of a polygon crossing some scanlines.
+	Scanline with index i crosses the edge at the vertical position i + 0.5, the edge crosses lines in range [firstLine, endLine).
+*/
+struct PolygonEdge
+{
+	double positionX;	// horizontal position of the crossing with the current line
+	double deltaX;		// change of the horizontal position from line to line
+	int firstLine;
+	int endLine;
+	int direction;		// 1 if the edge goes downwards, -1 if it goes upwards
+};
+
+
+/**
+	Create table of the polygon edges crossing scanlines sorted by their first line.
+	\param	originY		vertical position of the top of line 0.
+	\param	lineHeight	height of a single line.
+*/
+void BuildPolygonEdgeTable(const i2d::CPolygon& polygon, double originY, double lineHeight, int linesCount, std::vector<PolygonEdge>& edges)
+{
+	edges.clear();
+
+	const int nodesCount = polygon.GetNodesCount();
+	edges.reserve(nodesCount);
+
+	for (int i = 0; i < nodesCount; ++i){
+		const i2d::CVector2d& startPoint = polygon.GetNodePos(i);
+		const i2d::CVector2d& endPoint = polygon.GetNodePos((i + 1) % nodesCount);
+
+		double y1 = (startPoint.GetY() - originY) / lineHeight;
+		double y2 = (endPoint.GetY() - originY) / lineHeight;
+
+		double x1 = startPoint.GetX();
+		double x2 = endPoint.GetX();
+
+		int direction = 1;
+		if (y2 < y1){
+			qSwap(y1, y2);
+			qSwap(x1, x2);
+
+			direction = -1;
+		}
+
+		// bounding before the conversion avoids overflow for far away points
+		const int firstLine = int(qBound(0.0, y1 + 0.5, double(linesCount)));
+		const int endLine = int(qBound(0.0, y2 + 0.5, double(linesCount)));
+
+		if (firstLine < endLine){
+			PolygonEdge edge;
+			edge.deltaX = (x2 - x1) / (y2 - y1);
+			edge.positionX = x1 + (firstLine + 0.5 - y1) * edge.deltaX;
+			edge.firstLine = firstLine;
+			edge.endLine = endLine;
+			edge.direction = direction;
+
+			edges.push_back(edge);
+		}
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const PolygonEdge& edge1, const PolygonEdge& edge2){
+		return edge1.firstLine < edge2.firstLine;
+	});
+}
+
+
+/**
+	Call the function for each scanline with the list of edges crossing it sorted by their horizontal position.
+	The list of active edges is updated incrementally, edges are added at their first line and removed after their last line.
+	Because the order of the edges changes only at their intersections, the list is kept sorted by insertion sort in nearly linear time.
+	\param	lineFunction	function called as \c lineFunction(int lineIndex, const std::vector<PolygonEdge*>& activeEdges).
+*/
+template <typename LineFunction>
+void ScanPolygonEdges(std::vector<PolygonEdge>& edges, int linesCount, LineFunction lineFunction)
+{
+	std::vector<PolygonEdge*> activeEdges;
+	int nextEdgeIndex = 0;
+	const int edgesCount = int(edges.size());
+
+	for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+		activeEdges.erase(
+					std::remove_if(activeEdges.begin(), activeEdges.end(), [lineIndex](const PolygonEdge* edgePtr){
+						return edgePtr->endLine <= lineIndex;
+					}),
+					activeEdges.end());
+
+		for (; (nextEdgeIndex < edgesCount) && (edges[nextEdgeIndex].firstLine <= lineIndex); ++nextEdgeIndex){
+			activeEdges.push_back(&edges[nextEdgeIndex]);
+		}
+
+		const int activeEdgesCount = int(activeEdges.size());
+		for (int i = 1; i < activeEdgesCount; ++i){
+			PolygonEdge* edgePtr = activeEdges[i];
+
+			int insertIndex = i;
+			for (; (insertIndex > 0) && (activeEdges[insertIndex - 1]->positionX > edgePtr->positionX); --insertIndex){
+				activeEdges[insertIndex] = activeEdges[insertIndex - 1];
+			}
+
+			activeEdges[insertIndex] = edgePtr;
+		}
+
+		lineFunction(lineIndex, activeEdges);
+
+		for (PolygonEdge* edgePtr : activeEdges){
+			edgePtr->positionX += edgePtr->deltaX;
+		}
+	}
+}
+
+
+/**
+	Check if the winding number of the outline belongs to the filled area.
+*/
+inline bool IsWindingInside(int winding, CScanlineMask::FillRule fillRule)
+{
+	return (fillRule == CScanlineMask::FR_NON_ZERO)? (winding != 0): ((winding & 1) != 0);
+}
+
+
+/**
+	Add horizontal span of the given weight to the coverage of a pixel line.
+	Fractional coverage of the border pixels is added to \c borderCoverage,
+	the full coverage of the inner pixels is added to \c innerCoverage as differences of neighbour pixels.
+	Both buffers have one element more than the line width.
+*/
+void AddCoverageSpan(double begin, double end, double weight, int width, double* borderCoverage, double* innerCoverage)
+{
+	begin = qMax(begin, 0.0);
+	end = qMin(end, double(width));
+	if (!(begin < end)){
+		return;
+	}
+
+	const int beginIndex = int(begin);
+	const int endIndex = int(end);
+
+	if (beginIndex == endIndex){
+		borderCoverage[beginIndex] += (end - begin) * weight;
+
+		return;
+	}
+
+	borderCoverage[beginIndex] += (beginIndex + 1 - begin) * weight;
+	borderCoverage[endIndex] += (end - endIndex) * weight;
+	innerCoverage[beginIndex + 1] += weight;
+	innerCoverage[endIndex] -= weight;
+}
+
+
+} // namespace
+
+
 // public methods
 
 CScanlineMask::CScanlineMask()
-:	m_firstLinePos(0),
+:	m_lineOffsets(1, 0),
+	m_firstLinePos(0),
 	m_isBoundingBoxValid(false)
 {
 }
@@ -34,7 +653,7 @@ CScanlineMask::CScanlineMask()
 
 bool CScanlineMask::IsBitmapRegionEmpty() const
 {
-	return m_rangesContainer.empty();
+	return m_switchPoints.empty();
 }
 
 
@@ -55,50 +674,70 @@ void CScanlineMask::ResetScanlines(const istd::CIntRange& verticalRange)
 	int linesCount = verticalRange.GetLength();
 	Q_ASSERT(linesCount >= 0);
 
-	m_rangesContainer.clear();
-	m_scanlines.resize(linesCount);
+	m_switchPoints.clear();
+	m_lineOffsets.assign(linesCount + 1, 0);
 
-	for (int i = 0; i < linesCount; ++i){
-		m_scanlines[i] = -1;
-	}
+	InvalidateCache();
+}
 
-	m_isBoundingBoxValid = false;
+
+istd::CIntRange CScanlineMask::GetScanlinesRange() const
+{
+	Q_ASSERT(!m_lineOffsets.empty());
+
+	return istd::CIntRange(m_firstLinePos, m_firstLinePos + int(m_lineOffsets.size()) - 1);
 }
 
 
-const istd::CIntRanges* CScanlineMask::GetPixelRanges(int lineIndex) const
+const int* CScanlineMask::GetLineSwitchPoints(int lineIndex, int& pointsCount) const
 {
 	int rangeIndex = lineIndex - m_firstLinePos;
 
-	if ((rangeIndex >= 0) && (rangeIndex < int(m_scanlines.size()))){
-		int containerIndex = m_scanlines[rangeIndex];
-		if (containerIndex >= 0){
-			Q_ASSERT(containerIndex < m_rangesContainer.size());
+	if ((rangeIndex >= 0) && (rangeIndex < int(m_lineOffsets.size()) - 1)){
+		int beginOffset = m_lineOffsets[rangeIndex];
 
-			return &m_rangesContainer[containerIndex];
+		pointsCount = m_lineOffsets[rangeIndex + 1] - beginOffset;
+		if (pointsCount > 0){
+			return &m_switchPoints[beginOffset];
 		}
 	}
 
+	pointsCount = 0;
+
 	return NULL;
 }
 
 
+bool CScanlineMask::GetPixelRanges(int lineIndex, istd::CIntRanges& result) const
+{
+	result.Reset();
+
+	int pointsCount = 0;
+	const int* pointsPtr = GetLineSwitchPoints(lineIndex, pointsCount);
+	if (pointsPtr == NULL){
+		return false;
+	}
+
+	istd::CIntRanges::SwitchPoints& rangesPoints = result.GetSwitchPointsRef();
+	for (int pointIndex = 0; pointIndex < pointsCount; ++pointIndex){
+		rangesPoints.insert(rangesPoints.end(), pointsPtr[pointIndex]);
+	}
+
+	return true;
+}
+
+
 void CScanlineMask::CreateFilled(const i2d::CRect& clipArea)
 {
-	m_firstLinePos = clipArea.GetTop();
-	int endLinePos = clipArea.GetBottom();
-	int linesCount = qMax(endLinePos - m_firstLinePos, 0);
-	Q_ASSERT(linesCount >= 0);
+	int linesCount = qMax(clipArea.GetBottom() - clipArea.GetTop(), 0);
+
+	BeginLines(clipArea.GetTop(), linesCount);
 
-	m_rangesContainer.clear();
-	m_rangesContainer.push_back(istd::CIntRanges());
-	istd::CIntRanges& rangeList = m_rangesContainer.back();
-	rangeList.InsertSwitchPoint(clipArea.GetLeft());
-	rangeList.InsertSwitchPoint(clipArea.GetRight());
+	m_switchPoints.reserve(linesCount * 2);
 
-	m_scanlines.resize(linesCount);
 	for (int i = 0; i < linesCount; ++i){
-		m_scanlines[i] = 0;	// set all lines to the same range
+		AppendRun(clipArea.GetLeft(), clipArea.GetRight());
+		FinishLine();
 	}
 
 	m_boundingBox = clipArea;
@@ -181,7 +820,7 @@ void CScanlineMask::CreateFromCircle(const i2d::CCircle& circle, const i2d::CRec
 
 	InitFromBoundingBox(recalibratedCircle.GetBoundingBox(), clipAreaPtr);
 
-	int linesCount = int(m_scanlines.size());
+	int linesCount = GetScanlinesRange().GetLength();
 
 	if (linesCount <= 0){
 		ResetImage();
@@ -193,13 +832,11 @@ void CScanlineMask::CreateFromCircle(const i2d::CCircle& circle, const i2d::CRec
 	double radius = recalibratedCircle.GetRadius();
 	double radius2 = radius * radius;
 
-#if QT_VERSION >= 0x040700
-	m_rangesContainer.reserve(linesCount);
-#endif
+	BeginLines(m_firstLinePos, linesCount);
 
-	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
-		m_scanlines[lineIndex] = -1;
+	m_switchPoints.reserve(linesCount * 2);
 
+	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
 		double y = (lineIndex + m_firstLinePos - center.GetY());
 		double radiusDiff2 = radius2 - y * y;
 
@@ -218,16 +855,10 @@ void CScanlineMask::CreateFromCircle(const i2d::CCircle& circle, const i2d::CRec
 				}
 			}
 
-			if (left < right){
-				m_rangesContainer.push_back(istd::CIntRanges());
-				istd::CIntRanges& rangeList = m_rangesContainer.back();
-
-				rangeList.InsertSwitchPoint(left);
-				rangeList.InsertSwitchPoint(right);
-
-				m_scanlines[lineIndex] = m_rangesContainer.size() - 1;
-			}
+			AppendRun(left, right);
 		}
+
+		FinishLine();
 	}
 }
 
@@ -240,7 +871,7 @@ void CScanlineMask::CreateFromRectangle(const i2d::CRectangle& rect, const i2d::
 
 	InitFromBoundingBox(recalibratedRect, clipAreaPtr);
 
-	int linesCount = int(m_scanlines.size());
+	int linesCount = GetScanlinesRange().GetLength();
 
 	istd::CIntRange horRange(int(recalibratedRect.GetLeft() + 0.5), int(recalibratedRect.GetRight() + 0.5));
 	if (clipAreaPtr != NULL){
@@ -253,13 +884,13 @@ void CScanlineMask::CreateFromRectangle(const i2d::CRectangle& rect, const i2d::
 		return;
 	}
 
-	m_rangesContainer.push_back(istd::CIntRanges());
-	istd::CIntRanges& rangeList = m_rangesContainer.back();
-	rangeList.InsertSwitchPoint(horRange.GetMinValue());
-	rangeList.InsertSwitchPoint(horRange.GetMaxValue());
+	BeginLines(m_firstLinePos, linesCount);
+
+	m_switchPoints.reserve(linesCount * 2);
 
 	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
-		m_scanlines[lineIndex] = 0;	// set all lines to the same range
+		AppendRun(horRange.GetMinValue(), horRange.GetMaxValue());
+		FinishLine();
 	}
 }
 
@@ -271,7 +902,7 @@ void CScanlineMask::CreateFromAnnulus(const i2d::CAnnulus& annulus, const i2d::C
 	recalibratedAnnulus.CopyFrom(annulus, istd::IChangeable::CM_CONVERT);
 
 	InitFromBoundingBox(recalibratedAnnulus.GetBoundingBox(), clipAreaPtr);
-	int linesCount = int(m_scanlines.size());
+	int linesCount = GetScanlinesRange().GetLength();
 
 	if (linesCount <= 0){
 		ResetImage();
@@ -289,21 +920,17 @@ void CScanlineMask::CreateFromAnnulus(const i2d::CAnnulus& annulus, const i2d::C
 	double centerX = center.GetX();
 	double centerY = center.GetY();
 
-	m_scanlines.resize(linesCount);
+	BeginLines(m_firstLinePos, linesCount);
 
-#if QT_VERSION >= 0x040700
-	m_rangesContainer.reserve(linesCount);
-#endif
+	m_switchPoints.reserve(linesCount * 4);
 
 	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
-		istd::CIntRanges rangeList;
-
 		double y = (lineIndex + m_firstLinePos - centerY);
 
 		double outputRadiusDiff2 = outerRadius2 - y * y;
 
 		if (outputRadiusDiff2 < 0){
-			m_scanlines[lineIndex] = -1;
+			FinishLine();
 
 			continue;
 		}
@@ -329,37 +956,26 @@ void CScanlineMask::CreateFromAnnulus(const i2d::CAnnulus& annulus, const i2d::C
 			int innerLeft = int(centerX - innerRadiusDiff + 0.5);
 			int innerRight = int(centerX + innerRadiusDiff + 0.5);
 
-			rangeList.InsertSwitchPoint(outerLeft);
-			rangeList.InsertSwitchPoint(innerLeft);
-
-			rangeList.InsertSwitchPoint(innerRight);
-			rangeList.InsertSwitchPoint(outerRight);
+			AppendRun(outerLeft, qMin(innerLeft, outerRight));
+			AppendRun(qMax(innerRight, outerLeft), outerRight);
 		}
 		else{
-			rangeList.InsertSwitchPoint(outerLeft);
-			rangeList.InsertSwitchPoint(outerRight);
+			AppendRun(outerLeft, outerRight);
 		}
 
-		if (!rangeList.IsEmpty()){
-			m_rangesContainer.push_back(rangeList);
-
-			m_scanlines[lineIndex] = m_rangesContainer.size() - 1;
-		}
-		else{
-			m_scanlines[lineIndex] = -1;
-		}
+		FinishLine();
 	}
 }
 
 
-void CScanlineMask::CreateFromPolygon(const i2d::CPolygon& polygon, const i2d::CRect* clipAreaPtr)
+void CScanlineMask::CreateFromPolygon(const i2d::CPolygon& polygon, const i2d::CRect* clipAreaPtr, FillRule fillRule)
 {
 	i2d::CPolygon recalibratedPolygon;
 	recalibratedPolygon.SetCalibration(GetCalibration());
 	recalibratedPolygon.CopyFrom(polygon, istd::IChangeable::CM_CONVERT);
 
 	InitFromBoundingBox(recalibratedPolygon.GetBoundingBox(), clipAreaPtr);
-	int linesCount = int(m_scanlines.size());
+	int linesCount = GetScanlinesRange().GetLength();
 
 	if (linesCount <= 0){
 		ResetImage();
@@ -367,101 +983,101 @@ void CScanlineMask::CreateFromPolygon(const i2d::CPolygon& polygon, const i2d::C
 		return;
 	}
 
-	// QVector of lines by Y coordinates;
-	// every line is QList of X coordinates of the polygon lines points 
-	std::vector< std::set<int> > scanVector(linesCount);
+	std::vector<PolygonEdge> edges;
+	BuildPolygonEdgeTable(recalibratedPolygon, m_firstLinePos, 1.0, linesCount, edges);
 
-	int nodesCount = recalibratedPolygon.GetNodesCount();
-	for (int i = 0; i < nodesCount; ++i){
-		int nextIndex = (i + 1) % nodesCount;
+	const int clipLeft = (clipAreaPtr != NULL)? clipAreaPtr->GetLeft(): std::numeric_limits<int>::min();
+	const int clipRight = (clipAreaPtr != NULL)? clipAreaPtr->GetRight(): std::numeric_limits<int>::max();
 
-		i2d::CVector2d startPoint = recalibratedPolygon.GetNodePos(i);
-		i2d::CVector2d endPoint = recalibratedPolygon.GetNodePos(nextIndex);
-
-		double y1 = startPoint.GetY() - m_firstLinePos;
-		double y2 = endPoint.GetY() - m_firstLinePos;
+	// build the scan ranges
+	BeginLines(m_firstLinePos, linesCount);
 
-		double x1 = startPoint.GetX();
-		double x2 = endPoint.GetX();
+	ScanPolygonEdges(edges, linesCount, [&](int /*lineIndex*/, const std::vector<PolygonEdge*>& activeEdges){
+		Q_ASSERT((fillRule != FR_EVEN_ODD) || ((activeEdges.size() % 2) == 0));	// pair number of crossings should be calculated
 
-		if (y2 < y1){
-			qSwap(y1, y2);
-			qSwap(x1, x2);
-		}
+		int winding = 0;
+		int left = 0;
 
-		int firstLine = qMax(int(y1 + 0.5), 0);
-		int lastLine = qMin(int(y2 + 0.5), linesCount);
+		for (const PolygonEdge* edgePtr : activeEdges){
+			const int x = int(edgePtr->positionX + 0.5);
 
-		if (firstLine < lastLine){
-			double deltaX = (x2 - x1) / (y2 - y1);
+			const bool wasInside = IsWindingInside(winding, fillRule);
+			winding += edgePtr->direction;
+			const bool isInside = IsWindingInside(winding, fillRule);
 
-			// add line to list of points
-			double positionX = x1 + (firstLine + 0.5 - y1) * deltaX;
-			for (int lineIndex = firstLine; lineIndex < lastLine; ++lineIndex){
-				int x = int(positionX + 0.5);
+			if (isInside && !wasInside){
+				left = x;
+			}
+			else if (wasInside && !isInside){
+				AppendRun(qMax(left, clipLeft), qMin(x, clipRight));
+			}
+		}
 
-				std::set<int>& points = scanVector[lineIndex];
+		FinishLine();
+	});
+}
 
-				std::set<int>::iterator foundIter = points.find(x);
-				
-				if (foundIter != points.end()){
-					points.erase(foundIter);
-				}
-				else{
-					points.insert(x);
-				}
 
-				positionX += deltaX;
-			}
-		}
+bool CScanlineMask::CalcPolygonCoverage(const i2d::CPolygon& polygon, iimg::IBitmap& coverageBitmap, FillRule fillRule, int subLinesCount)
+{
+	if ((coverageBitmap.GetPixelFormat() != iimg::IBitmap::PF_FLOAT32) || (subLinesCount < 1)){
+		return false;
 	}
 
-	// build the scan ranges
-	m_scanlines.resize(linesCount);
-
-#if QT_VERSION >= 0x040700
-	m_rangesContainer.reserve(linesCount);
-#endif
+	const istd::CIndex2d imageSize = coverageBitmap.GetImageSize();
+	const int width = imageSize.GetX();
+	const int height = imageSize.GetY();
+	if ((width <= 0) || (height <= 0)){
+		return true;
+	}
 
-	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
-		istd::CIntRanges rangeList;
+	const qint64 subLinesTotalCount = qint64(height) * subLinesCount;
+	if (subLinesTotalCount > std::numeric_limits<int>::max()){
+		return false;
+	}
 
-		const std::set<int>& lineList = scanVector.at(lineIndex);
-		Q_ASSERT((lineList.size() % 2) == 0);	// pair number of points should be calculated
+	std::vector<PolygonEdge> edges;
+	BuildPolygonEdgeTable(polygon, 0, 1.0 / subLinesCount, int(subLinesTotalCount), edges);
 
-		int rangesCount = int(lineList.size()) / 2;
+	std::vector<double> borderCoverage(width + 1, 0.0);
+	std::vector<double> innerCoverage(width + 1, 0.0);
+	const double subLineWeight = 1.0 / subLinesCount;
 
-		std::set<int>::const_iterator iter = lineList.begin();
-		for (int i = 0; i < rangesCount; ++i){
-			int left = *(iter++);
-			Q_ASSERT(iter != lineList.end());
-			int right = *(iter++);
+	ScanPolygonEdges(edges, int(subLinesTotalCount), [&](int subLineIndex, const std::vector<PolygonEdge*>& activeEdges){
+		int winding = 0;
+		double left = 0;
 
-			if (clipAreaPtr != NULL){
-				if (left < clipAreaPtr->GetLeft()){
-					left = clipAreaPtr->GetLeft();
-				}
+		for (const PolygonEdge* edgePtr : activeEdges){
+			const bool wasInside = IsWindingInside(winding, fillRule);
+			winding += edgePtr->direction;
+			const bool isInside = IsWindingInside(winding, fillRule);
 
-				if (right > clipAreaPtr->GetRight()){
-					right = clipAreaPtr->GetRight();
-				}
+			if (isInside && !wasInside){
+				left = edgePtr->positionX;
 			}
-
-			if (left < right){
-				rangeList.InsertSwitchPoint(left);
-				rangeList.InsertSwitchPoint(right);
+			else if (wasInside && !isInside){
+				AddCoverageSpan(left, edgePtr->positionX, subLineWeight, width, borderCoverage.data(), innerCoverage.data());
 			}
 		}
 
-		if (!rangeList.IsEmpty()){
-			m_rangesContainer.push_back(rangeList);
+		if ((subLineIndex % subLinesCount) == subLinesCount - 1){
+			// all sub-lines of the pixel line are accumulated
+			float* linePtr = static_cast<float*>(coverageBitmap.GetLinePtr(subLineIndex / subLinesCount));
+			Q_ASSERT(linePtr != NULL);
 
-			m_scanlines[lineIndex] = m_rangesContainer.size() - 1;
-		}
-		else{
-			m_scanlines[lineIndex] =  -1;
+			double innerValue = 0;
+			for (int x = 0; x < width; ++x){
+				innerValue += innerCoverage[x];
+
+				linePtr[x] = float(qBound(0.0, innerValue + borderCoverage[x], 1.0));
+			}
+
+			std::fill(borderCoverage.begin(), borderCoverage.end(), 0.0);
+			std::fill(innerCoverage.begin(), innerCoverage.end(), 0.0);
 		}
-	}
+	});
+
+	return true;
 }
 
 
@@ -537,94 +1153,46 @@ void CScanlineMask::CreateFromBitmap(const iimg::IBitmap& bitmap, const i2d::CRe
 
 void CScanlineMask::GetInverted(const i2d::CRect& clipArea, CScanlineMask& result) const
 {
-	result.m_rangesContainer.clear();
-	result.m_scanlines.clear();
-	result.m_firstLinePos = 0;
-	result.m_isBoundingBoxValid = false;
-
 	if (clipArea.IsEmpty()){
+		result.ResetImage();
+
 		return;
 	}
 
-	int scanLinesCount = clipArea.GetHeight();
-	result.m_scanlines.resize(scanLinesCount, 0);
-	result.m_firstLinePos = clipArea.GetTop();
+	const int firstLinePos = clipArea.GetTop();
+	const int clipLeft = clipArea.GetLeft();
+	const int clipRight = clipArea.GetRight();
 
-	istd::CIntRanges fullRange(clipArea.GetHorizontalRange());
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
 
-	result.m_rangesContainer.push_back(fullRange);
+	BuildLines(
+				clipArea.GetHeight(),
+				[&](int lineIndex){
+					int pointsCount = 0;
+					GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
 
-	for (int scanLineIndex = 0; scanLineIndex < scanLinesCount; ++scanLineIndex){
-		const istd::CIntRanges* lineRangesPtr = this->GetPixelRanges(clipArea.GetTop() + scanLineIndex);
-		if (lineRangesPtr != NULL){
-			istd::CIntRanges invRanges;
-			lineRangesPtr->GetInverted(invRanges, &clipArea.GetHorizontalRange());
-			if (invRanges.IsEmpty()){
-				result.m_scanlines[scanLineIndex] = -1;
-				continue;
-			}
+					return pointsCount + 2;
+				},
+				[&](int lineIndex, int* resultPtr){
+					int pointsCount = 0;
+					const int* pointsPtr = GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
 
-			if (invRanges != fullRange){
-				result.m_rangesContainer.push_back(invRanges);
-				result.m_scanlines[scanLineIndex] = result.m_rangesContainer.size() - 1;
-			}
-		}
-	}
+					return InvertLine(pointsPtr, pointsCount, clipLeft, clipRight, resultPtr);
+				},
+				switchPoints,
+				lineOffsets);
+
+	result.SetLines(firstLinePos, switchPoints, lineOffsets);
 }
 
 
 void CScanlineMask::Invert(const i2d::CRect& clipArea)
 {
-	if (clipArea.IsEmpty()){
-		ResetImage();
-	}
-
 	istd::CChangeNotifier notifier(this);
 	Q_UNUSED(notifier);
 
-	m_isBoundingBoxValid = false;
-
-	for (		RangesContainer::Iterator lineIter = m_rangesContainer.begin();
-				lineIter != m_rangesContainer.end();
-				++lineIter){
-		istd::CIntRanges& lineRanges = *lineIter;
-
-		lineRanges.Invert(&clipArea.GetHorizontalRange());
-	}
-
-	istd::CIntRanges fullRange(clipArea.GetHorizontalRange());
-	m_rangesContainer.append(fullRange);
-	int fullRangeIndex = m_rangesContainer.size() - 1;
-
-	int scanLinesCount = clipArea.GetHeight();
-	int vertShift = m_firstLinePos - clipArea.GetTop();
-	if (vertShift > 0){
-		int totalLines = qMin(scanLinesCount, int(m_scanlines.size()));
-		m_scanlines.resize(totalLines, fullRangeIndex);
-
-		for (int lineIndex = totalLines - 1; lineIndex >= vertShift; --lineIndex){
-			m_scanlines[lineIndex] = m_scanlines[lineIndex - vertShift];
-		}
-
-		for (int lineIndex = 0; lineIndex < vertShift; ++lineIndex){
-			m_scanlines[lineIndex] = fullRangeIndex;
-		}
-	}
-	else if (vertShift < 0){
-		int totalLines = qMin(scanLinesCount, int(m_scanlines.size()));
-		m_scanlines.resize(totalLines, fullRangeIndex);
-
-		for (int lineIndex = 0; lineIndex < totalLines + vertShift; ++lineIndex){
-			m_scanlines[lineIndex] = m_scanlines[lineIndex - vertShift];
-		}
-
-		for (int lineIndex = totalLines + vertShift; lineIndex < totalLines; ++lineIndex){
-			m_scanlines[lineIndex] = fullRangeIndex;
-		}
-	}
-	m_scanlines.resize(scanLinesCount, fullRangeIndex);
-
-	m_firstLinePos = clipArea.GetTop();
+	GetInverted(clipArea, *this);
 }
 
 
@@ -632,67 +1200,48 @@ CScanlineMask CScanlineMask::GetUnion(const CScanlineMask& mask) const
 {
 	CScanlineMask result;
 
-	GetUnion(mask, result);
-
-	return result;
-}
-
-
-void CScanlineMask::GetUnion(const CScanlineMask& mask, CScanlineMask& result) const
-{
-	result.m_isBoundingBoxValid = false;
-
-	result.m_firstLinePos = std::min(m_firstLinePos, mask.m_firstLinePos);
-	int endLineY = std::max(m_firstLinePos + int(m_scanlines.size()), mask.m_firstLinePos + int(mask.m_scanlines.size()));
-
-	result.m_scanlines.resize(endLineY - result.m_firstLinePos);
-
-	for (int resultLineIndex = 0; resultLineIndex < int(result.m_scanlines.size()); ++resultLineIndex){
-		int y = resultLineIndex + result.m_firstLinePos;
-
-		const istd::CIntRanges* rangesPtr = nullptr;
-		const istd::CIntRanges* maskRangesPtr = nullptr;
-
-		const int lineIndex = y - m_firstLinePos;
-		if ((lineIndex >= 0) && (lineIndex < int(m_scanlines.size()))){
-			const int containerIndex = m_scanlines[lineIndex];
-			if (containerIndex >= 0){
-				Q_ASSERT(containerIndex < m_rangesContainer.size());
-
-				rangesPtr = &m_rangesContainer[containerIndex];
-			}
-		}
-
-		const int maskLineIndex = y - mask.m_firstLinePos;
-		if ((maskLineIndex >= 0) && (maskLineIndex < int(mask.m_scanlines.size()))){
-			const int containerIndex = mask.m_scanlines[maskLineIndex];
-			if (containerIndex >= 0){
-				Q_ASSERT(containerIndex < mask.m_rangesContainer.size());
-
-				maskRangesPtr = &mask.m_rangesContainer[containerIndex];
-			}
-		}
-
-		if ((!rangesPtr || rangesPtr->IsEmpty()) && (!maskRangesPtr || maskRangesPtr->IsEmpty())){
-			result.m_scanlines[resultLineIndex] = -1;
-			continue;
-		}
+	GetUnion(mask, result);
+
+	return result;
+}
 
-		result.m_rangesContainer.append(istd::CIntRanges());
-		istd::CIntRanges& resultRanges = result.m_rangesContainer.back();
-		if (rangesPtr && maskRangesPtr)
-			rangesPtr->GetUnion(*maskRangesPtr, resultRanges);
-		else
-			resultRanges = rangesPtr ? *rangesPtr : *maskRangesPtr;
 
-		result.m_scanlines[resultLineIndex] = result.m_rangesContainer.size() - 1;
-	}
+void CScanlineMask::GetUnion(const CScanlineMask& mask, CScanlineMask& result) const
+{
+	const istd::CIntRange linesRange = GetLinesUnion(GetScanlinesRange(), mask.GetScanlinesRange());
+	const int firstLinePos = linesRange.GetMinValue();
+
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+
+	BuildLines(
+				linesRange.GetLength(),
+				[&](int lineIndex){
+					int pointsCount = 0;
+					int maskPointsCount = 0;
+					GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
+					mask.GetLineSwitchPoints(firstLinePos + lineIndex, maskPointsCount);
+
+					return pointsCount + maskPointsCount;
+				},
+				[&](int lineIndex, int* resultPtr){
+					int pointsCount = 0;
+					int maskPointsCount = 0;
+					const int* pointsPtr = GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
+					const int* maskPointsPtr = mask.GetLineSwitchPoints(firstLinePos + lineIndex, maskPointsCount);
+
+					return UniteLines(pointsPtr, pointsCount, maskPointsPtr, maskPointsCount, resultPtr);
+				},
+				switchPoints,
+				lineOffsets);
+
+	result.SetLines(firstLinePos, switchPoints, lineOffsets);
 }
 
 
 void CScanlineMask::Union(const CScanlineMask& mask)
 {
-	*this = GetUnion(mask);
+	GetUnion(mask, *this);
 }
 
 
@@ -708,54 +1257,49 @@ CScanlineMask CScanlineMask::GetIntersection(const CScanlineMask& mask) const
 
 void CScanlineMask::GetIntersection(const CScanlineMask& mask, CScanlineMask& result) const
 {
-	result.m_isBoundingBoxValid = false;
+	const istd::CIntRange linesRange = GetScanlinesRange();
+	const istd::CIntRange maskLinesRange = mask.GetScanlinesRange();
 
-	result.m_firstLinePos = qMax(m_firstLinePos, mask.m_firstLinePos);
-	int endLineY = qMin(m_firstLinePos + int(m_scanlines.size()), mask.m_firstLinePos + int(mask.m_scanlines.size()));
+	const int firstLinePos = qMax(linesRange.GetMinValue(), maskLinesRange.GetMinValue());
+	const int endLinePos = qMin(linesRange.GetMaxValue(), maskLinesRange.GetMaxValue());
 
-	if (result.m_firstLinePos >= endLineY){
+	if (firstLinePos >= endLinePos){
 		result.ResetImage();
 
 		return;
 	}
 
-	result.m_scanlines.resize(endLineY - m_firstLinePos);
-
-	for (int resultLineIndex = 0; resultLineIndex < int(result.m_scanlines.size()); ++resultLineIndex){
-		int y = result.m_firstLinePos + resultLineIndex;
-
-		istd::CIntRanges resultRanges;
-
-		int lineIndex = y - m_firstLinePos;
-		int maskLineIndex = y - mask.m_firstLinePos;
-		if (		(lineIndex >= 0) && (lineIndex < int(m_scanlines.size())) &&
-					(maskLineIndex >= 0) && (maskLineIndex < int(mask.m_scanlines.size()))){
-			int containerIndex = m_scanlines[lineIndex];
-			int maskContainerIndex = mask.m_scanlines[maskLineIndex];
-
-			if ((containerIndex >= 0) && (maskContainerIndex >= 0)){
-				const istd::CIntRanges& ranges = m_rangesContainer[containerIndex];
-				const istd::CIntRanges& maskRange = mask.m_rangesContainer[maskContainerIndex];
-
-				ranges.GetIntersection(maskRange, resultRanges);
-			}
-		}
-
-		if (!resultRanges.IsEmpty()){
-			result.m_rangesContainer.push_back(resultRanges);
-
-			result.m_scanlines[resultLineIndex] = result.m_rangesContainer.size() - 1;
-		}
-		else{
-			result.m_scanlines[resultLineIndex] = -1;
-		}
-	}
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+
+	BuildLines(
+				endLinePos - firstLinePos,
+				[&](int lineIndex){
+					int pointsCount = 0;
+					int maskPointsCount = 0;
+					GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
+					mask.GetLineSwitchPoints(firstLinePos + lineIndex, maskPointsCount);
+
+					return ((pointsCount > 0) && (maskPointsCount > 0))? pointsCount + maskPointsCount: 0;
+				},
+				[&](int lineIndex, int* resultPtr){
+					int pointsCount = 0;
+					int maskPointsCount = 0;
+					const int* pointsPtr = GetLineSwitchPoints(firstLinePos + lineIndex, pointsCount);
+					const int* maskPointsPtr = mask.GetLineSwitchPoints(firstLinePos + lineIndex, maskPointsCount);
+
+					return IntersectLines(pointsPtr, pointsCount, maskPointsPtr, maskPointsCount, resultPtr);
+				},
+				switchPoints,
+				lineOffsets);
+
+	result.SetLines(firstLinePos, switchPoints, lineOffsets);
 }
 
 
 void CScanlineMask::Intersection(const CScanlineMask& mask)
 {
-	*this = GetIntersection(mask);
+	GetIntersection(mask, *this);
 }
 
 
@@ -788,12 +1332,10 @@ void CScanlineMask::Translate(int dx, int dy)
 		m_boundingBox.SetLeft(m_boundingBox.GetLeft() + dx);
 		m_boundingBox.SetRight(m_boundingBox.GetRight() + dx);
 
-		for (		RangesContainer::Iterator lineIter = m_rangesContainer.begin();
-					lineIter != m_rangesContainer.end();
-					++lineIter){
-			istd::CIntRanges& lineRanges = *lineIter;
-
-			lineRanges.ShiftRanges(dx);
+		int* pointsPtr = m_switchPoints.data();
+		const int pointsCount = int(m_switchPoints.size());
+		for (int pointIndex = 0; pointIndex < pointsCount; ++pointIndex){
+			pointsPtr[pointIndex] += dx;
 		}
 	}
 }
@@ -807,83 +1349,115 @@ void CScanlineMask::Erode(int leftValue, int rightValue, int topValue, int botto
 
 void CScanlineMask::Dilate(int leftValue, int rightValue, int topValue, int bottomValue)
 {
-	int newScanLinesCount = int(m_scanlines.size()) + topValue + bottomValue;
+	int linesCount = int(m_lineOffsets.size()) - 1;
+
+	int newScanLinesCount = linesCount + topValue + bottomValue;
 	if (newScanLinesCount <= 0){
 		ResetImage();
 
 		return;
 	}
 
-	m_isBoundingBoxValid = false;
+	InvalidateCache();
+
+	if ((leftValue != 0) || (rightValue != 0)){
+		std::vector<int> pointsCounts(linesCount);
+
+		const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, qint64(m_switchPoints.size()));
 
-	for (		RangesContainer::Iterator lineIter = m_rangesContainer.begin();
-				lineIter != m_rangesContainer.end();
-				++lineIter){
-		istd::CIntRanges& lineRanges = *lineIter;
-		lineRanges.Dilate(leftValue, rightValue);
+		istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int /*bandIndex*/, int beginLine, int endLine){
+			for (int lineIndex = beginLine; lineIndex < endLine; ++lineIndex){
+				int lineOffset = m_lineOffsets[lineIndex];
+
+				pointsCounts[lineIndex] = DilateLine(
+							m_switchPoints.data() + lineOffset,
+							m_lineOffsets[lineIndex + 1] - lineOffset,
+							leftValue,
+							rightValue);
+			}
+		});
+
+		CompactLines(pointsCounts, m_switchPoints, m_lineOffsets);
 	}
 
 	m_firstLinePos -= topValue;
 
 	int dilLines = topValue + bottomValue;
 
-	if (dilLines == 0){
-		return;
+	if (dilLines > 0){
+		int restDilLines = dilLines;
+
+		for (int shiftY = 1; restDilLines > 0; restDilLines -= shiftY, shiftY <<= 1){
+			UniteShiftedLines(qMin(shiftY, restDilLines));
+		}
 	}
+	else if (dilLines < 0){
+		int restErodeLines = -dilLines;
 
-	if (m_rangesContainer.size() <= 1){	// special case: rectangles
-		m_scanlines.resize(newScanLinesCount, -1);
+		for (int shiftY = 1; restErodeLines > 0; restErodeLines -= shiftY, shiftY <<= 1){
+			IntersectShiftedLines(qMin(shiftY, restErodeLines));
+		}
+	}
+}
 
-		int downCounter = 0;
 
-		for (		Scanlines::iterator iter = m_scanlines.begin();
-					iter != m_scanlines.end();
-					++iter){
-			int rangeIndex = *iter;
-			if (rangeIndex < 0){
-				if (dilLines > 0){
-					if (downCounter-- > 0){
-						*iter = 0;	// set the range
-					}
-				}
-				else{
-					downCounter = -dilLines;
-				}
-			}
-			else{
-				if (dilLines > 0){
-					downCounter = dilLines;
-				}
-				else{
-					if (downCounter-- > 0){
-						*iter = -1;	// remove the range
-					}
-				}
-			}
-		}
+void CScanlineMask::Erode(const CScanlineMask& structuringElement)
+{
+	ApplyStructuringElement(structuringElement, true);
+}
+
+
+void CScanlineMask::Dilate(const CScanlineMask& structuringElement)
+{
+	ApplyStructuringElement(structuringElement, false);
+}
+
+
+void CScanlineMask::Open(const CScanlineMask& structuringElement)
+{
+	ApplyStructuringElement(structuringElement, true);
+	ApplyStructuringElement(structuringElement, false);
+}
+
+
+void CScanlineMask::Close(const CScanlineMask& structuringElement)
+{
+	ApplyStructuringElement(structuringElement, false);
+	ApplyStructuringElement(structuringElement, true);
+}
+
+
+void CScanlineMask::ErodeCircle(double radius)
+{
+	ApplyCircle(radius, true);
+}
+
+
+void CScanlineMask::DilateCircle(double radius)
+{
+	ApplyCircle(radius, false);
+}
+
+
+void CScanlineMask::CreateEllipseElement(double radiusX, double radiusY)
+{
+	const std::vector<int> widths = CalcEllipseWidths(radiusX, radiusY);
+	if (widths.empty()){
+		ResetImage();
 
 		return;
 	}
 
-	if (dilLines > 0){
-		int restDilLines = dilLines;
+	const int maxOffsetY = int(widths.size()) - 1;
 
-		for (int shiftY = 1; restDilLines > 0; restDilLines -= shiftY, shiftY <<= 1){
-			CScanlineMask shiftedMask;
-			GetTranslated(0, qMin(shiftY, restDilLines), shiftedMask);
+	BeginLines(-maxOffsetY, 2 * maxOffsetY + 1);
 
-			Union(shiftedMask);
-		}
-	}
-	else{
-		int restErodeLines = -dilLines;
+	for (int offsetY = -maxOffsetY; offsetY <= maxOffsetY; ++offsetY){
+		const int width = widths[qAbs(offsetY)];
 
-		for (int shiftY = 1; restErodeLines > 0; restErodeLines -= shiftY, shiftY <<= 1){
-			CScanlineMask shiftedMask;
-			GetTranslated(0, -qMin(shiftY, restErodeLines), shiftedMask);
+		AppendRun(-width, width + 1);
 
-			Intersection(shiftedMask);
-		}
+		FinishLine();
 	}
 }
 
@@ -924,8 +1498,8 @@ bool CScanlineMask::IsEmpty() const
 
 void CScanlineMask::ResetImage()
 {
-	m_rangesContainer.clear();
-	m_scanlines.clear();
+	m_switchPoints.clear();
+	m_lineOffsets.assign(1, 0);
 
 	m_boundingBox = i2d::CRect::GetEmpty();
 	m_isBoundingBoxValid = true;
@@ -954,16 +1528,13 @@ int CScanlineMask::GetComponentsCount() const
 
 icmm::CVarColor CScanlineMask::GetColorAt(const istd::CIndex2d& position) const
 {
-	int scanLineIndex = position.GetY() - m_firstLinePos;
-	if ((scanLineIndex >= 0) && (scanLineIndex < int(m_scanlines.size()))){
-		int containerIndex = m_scanlines[scanLineIndex];
-
-		if (containerIndex >= 0){
-			const istd::CIntRanges& scanLine = m_rangesContainer[containerIndex];
-
-			if (scanLine.IsInside(position.GetX())){
-				return icmm::CVarColor(1, 1);
-			}
+	int pointsCount = 0;
+	const int* pointsPtr = GetLineSwitchPoints(position.GetY(), pointsCount);
+	if (pointsPtr != NULL){
+		// position is inside of a run, if the number of switch points before it is odd
+		const int* foundPtr = std::upper_bound(pointsPtr, pointsPtr + pointsCount, position.GetX());
+		if (((foundPtr - pointsPtr) & 1) != 0){
+			return icmm::CVarColor(1, 1);
 		}
 	}
 
@@ -1000,13 +1571,48 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 	retVal = retVal && archive.EndTag(firstLineTag);
 
 	if (archive.IsStoring()){
-		int containerSize = m_rangesContainer.size();
+		int linesCount = int(m_lineOffsets.size()) - 1;
+
+		// identical neighbour lines share the same container element
+		std::vector<int> containerIndices(linesCount, -1);
+		std::vector<int> containerLines;
+
+		for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex){
+			int lineOffset = m_lineOffsets[lineIndex];
+			int pointsCount = m_lineOffsets[lineIndex + 1] - lineOffset;
+			if (pointsCount <= 0){
+				continue;
+			}
+
+			if (!containerLines.empty()){
+				int prevLineOffset = m_lineOffsets[containerLines.back()];
+				int prevPointsCount = m_lineOffsets[containerLines.back() + 1] - prevLineOffset;
+
+				if (		(prevPointsCount == pointsCount) &&
+							std::equal(m_switchPoints.begin() + lineOffset, m_switchPoints.begin() + lineOffset + pointsCount, m_switchPoints.begin() + prevLineOffset)){
+					containerIndices[lineIndex] = int(containerLines.size()) - 1;
+
+					continue;
+				}
+			}
+
+			containerLines.push_back(lineIndex);
+			containerIndices[lineIndex] = int(containerLines.size()) - 1;
+		}
+
+		int containerSize = int(containerLines.size());
 
 		retVal = retVal && archive.BeginMultiTag(lineContainerTag, scanLineTag, containerSize);
-		for (		RangesContainer::Iterator lineIter = m_rangesContainer.begin();
-					lineIter != m_rangesContainer.end();
+		for (		std::vector<int>::const_iterator lineIter = containerLines.begin();
+					lineIter != containerLines.end();
 					++lineIter){
-			istd::CIntRanges& scanLine = *lineIter;
+			int lineIndex = *lineIter;
+
+			istd::CIntRanges scanLine;
+			istd::CIntRanges::SwitchPoints& rangesPoints = scanLine.GetSwitchPointsRef();
+			for (int pointIndex = m_lineOffsets[lineIndex]; pointIndex < m_lineOffsets[lineIndex + 1]; ++pointIndex){
+				rangesPoints.insert(rangesPoints.end(), m_switchPoints[pointIndex]);
+			}
 
 			retVal = retVal && archive.BeginTag(scanLineTag);
 			retVal = retVal && iser::CPrimitiveTypesSerializer::SerializeIntRanges(archive, scanLine);
@@ -1015,11 +1621,9 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 
 		retVal = retVal && archive.EndTag(lineContainerTag);
 
-		int indicesCount = int(m_scanlines.size());
-
-		retVal = retVal && archive.BeginMultiTag(containerIndicesTag, indexTag, indicesCount);
-		for (		Scanlines::const_iterator indexIter = m_scanlines.begin();
-					indexIter != m_scanlines.end();
+		retVal = retVal && archive.BeginMultiTag(containerIndicesTag, indexTag, linesCount);
+		for (		std::vector<int>::const_iterator indexIter = containerIndices.begin();
+					indexIter != containerIndices.end();
 					++indexIter){
 			int containerIndex = *indexIter;
 
@@ -1031,9 +1635,9 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 		retVal = retVal && archive.EndTag(containerIndicesTag);
 	}
 	else{
-		m_isBoundingBoxValid = false;
-		m_rangesContainer.clear();
-		m_scanlines.clear();
+		int firstLinePos = m_firstLinePos;
+
+		ResetImage();
 
 		int containerSize = 0;
 
@@ -1042,13 +1646,28 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 			return false;
 		}
 
+		std::vector<SwitchPoints> container(containerSize);
+
 		for (int containerIndex = 0; containerIndex < containerSize; ++containerIndex){
-			m_rangesContainer.push_back(istd::CIntRanges());
-			istd::CIntRanges& scanLine = m_rangesContainer.last();
+			istd::CIntRanges scanLine;
 
 			retVal = retVal && archive.BeginTag(scanLineTag);
 			retVal = retVal && iser::CPrimitiveTypesSerializer::SerializeIntRanges(archive, scanLine);
 			retVal = retVal && archive.EndTag(scanLineTag);
+
+			const istd::CIntRanges::SwitchPoints& rangesPoints = scanLine.GetSwitchPoints();
+			SwitchPoints& linePoints = container[containerIndex];
+
+			// older versions stored runs reaching the right bitmap border as open ranges, they are closed at the finite limit
+			if (scanLine.GetBeginState()){
+				linePoints.push_back(rangesPoints.empty()? -s_openRunLimit: qMin(-s_openRunLimit, *rangesPoints.begin()));
+			}
+
+			linePoints.insert(linePoints.end(), rangesPoints.begin(), rangesPoints.end());
+
+			if ((linePoints.size() % 2) != 0){
+				linePoints.push_back(qMax(s_openRunLimit, linePoints.back()));
+			}
 		}
 
 		retVal = retVal && archive.EndTag(lineContainerTag);
@@ -1060,7 +1679,8 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 			return false;
 		}
 
-		m_scanlines.resize(indicesCount);
+		BeginLines(firstLinePos, indicesCount);
+
 		for (int lineIndex = 0; lineIndex < indicesCount; ++lineIndex){
 			int containerIndex = -1;
 			retVal = retVal && archive.BeginTag(indexTag);
@@ -1072,7 +1692,14 @@ bool CScanlineMask::Serialize(iser::IArchive& archive)
 				return false;
 			}
 
-			m_scanlines[lineIndex] = containerIndex;
+			if (containerIndex >= 0){
+				const SwitchPoints& linePoints = container[containerIndex];
+				for (int pointIndex = 0; pointIndex < int(linePoints.size()); pointIndex += 2){
+					AppendRun(linePoints[pointIndex], linePoints[pointIndex + 1]);
+				}
+			}
+
+			FinishLine();
 		}
 
 		retVal = retVal && archive.EndTag(containerIndicesTag);
@@ -1111,37 +1738,20 @@ bool CScanlineMask::ResetData(CompatibilityMode /*mode*/)
 
 bool CScanlineMask::operator==(const CScanlineMask& mask) const
 {
-	int firstLineIndex = qMin(m_firstLinePos, mask.m_firstLinePos);
-	int endLineIndex = qMax(int(m_firstLinePos + m_scanlines.size()), int(mask.m_firstLinePos + mask.m_scanlines.size()));
-	for (int lineIndex = firstLineIndex; lineIndex < endLineIndex; ++lineIndex){
-		int rangeIndex = -1;
-		if ((lineIndex >= m_firstLinePos) && (lineIndex < int(m_firstLinePos + m_scanlines.size()))){
-			rangeIndex = m_scanlines[lineIndex - m_firstLinePos];
-		}
+	const istd::CIntRange linesRange = GetLinesUnion(GetScanlinesRange(), mask.GetScanlinesRange());
 
-		int maskRangeIndex = -1;
-		if ((lineIndex >= mask.m_firstLinePos) && (lineIndex < int(mask.m_firstLinePos + mask.m_scanlines.size()))){
-			maskRangeIndex = mask.m_scanlines[lineIndex - mask.m_firstLinePos];
-		}
+	for (int lineIndex = linesRange.GetMinValue(); lineIndex < linesRange.GetMaxValue(); ++lineIndex){
+		int pointsCount = 0;
+		int maskPointsCount = 0;
+		const int* pointsPtr = GetLineSwitchPoints(lineIndex, pointsCount);
+		const int* maskPointsPtr = mask.GetLineSwitchPoints(lineIndex, maskPointsCount);
 
-		if (rangeIndex >= 0){
-			if (maskRangeIndex >= 0){
-				if (m_rangesContainer[rangeIndex] != mask.m_rangesContainer[maskRangeIndex]){
-					return false;
-				}
-			}
-			else{
-				if (!m_rangesContainer[rangeIndex].IsEmpty()){
-					return false;
-				}
-			}
+		if (pointsCount != maskPointsCount){
+			return false;
 		}
-		else{
-			if (maskRangeIndex >= 0){
-				if (!mask.m_rangesContainer[maskRangeIndex].IsEmpty()){
-					return false;
-				}
-			}
+
+		if ((pointsCount > 0) && !std::equal(pointsPtr, pointsPtr + pointsCount, maskPointsPtr)){
+			return false;
 		}
 	}
 
@@ -1153,48 +1763,35 @@ bool CScanlineMask::operator==(const CScanlineMask& mask) const
 
 void CScanlineMask::CalcBoundingBox() const
 {
-	istd::CIntRange rangeX = istd::CIntRange::GetInvalid();
+	int minX = std::numeric_limits<int>::max();
+	int maxX = std::numeric_limits<int>::min();
 
 	int firstActiveLine = -1;
 	int lastActiveLine = -1;
 
-	for (int i = 0; i < int(m_scanlines.size()); ++i){
-		int containerIndex = m_scanlines[i];
-
-		if (containerIndex >= 0){
-			const istd::CIntRanges& scanLine = m_rangesContainer[containerIndex];
-
-			if (scanLine.IsEmpty()){
-				continue;
-			}
-
-			if (firstActiveLine < 0){
-				firstActiveLine = i;
-			}
-
-			lastActiveLine = i;
+	int linesCount = int(m_lineOffsets.size()) - 1;
+	for (int i = 0; i < linesCount; ++i){
+		int lineOffset = m_lineOffsets[i];
+		int lineEndOffset = m_lineOffsets[i + 1];
+		if (lineOffset >= lineEndOffset){
+			continue;
+		}
 
-			const istd::CIntRanges::SwitchPoints& points = scanLine.GetSwitchPoints();
+		if (firstActiveLine < 0){
+			firstActiveLine = i;
+		}
 
-			if (!points.empty()){
-				int minX = *points.begin();
-				int maxX = *points.rbegin();
+		lastActiveLine = i;
 
-				if (rangeX.IsValid()){
-					rangeX.Unite(istd::CIntRange(minX, maxX));
-				}
-				else{
-					rangeX = istd::CIntRange(minX, maxX);
-				}
-			}
-		}
+		minX = qMin(minX, m_switchPoints[lineOffset]);
+		maxX = qMax(maxX, m_switchPoints[lineEndOffset - 1]);
 	}
 
-	if (rangeX.IsValid() && (firstActiveLine < lastActiveLine)){
+	if (firstActiveLine >= 0){
 		m_boundingBox.SetTop(m_firstLinePos + firstActiveLine);
-		m_boundingBox.SetLeft(rangeX.GetMinValue());
+		m_boundingBox.SetLeft(minX);
 		m_boundingBox.SetBottom(m_firstLinePos + lastActiveLine + 1);
-		m_boundingBox.SetRight(rangeX.GetMaxValue());
+		m_boundingBox.SetRight(maxX);
 	}
 	else{
 		m_boundingBox = i2d::CRect::GetEmpty();
@@ -1222,23 +1819,455 @@ void CScanlineMask::InitFromBoundingBox(const i2d::CRectangle& objectBoundingBox
 }
 
 
+void CScanlineMask::BeginLines(int firstLinePos, int linesCount)
+{
+	m_firstLinePos = firstLinePos;
+
+	m_switchPoints.clear();
+	m_lineOffsets.clear();
+	m_lineOffsets.reserve(linesCount + 1);
+	m_lineOffsets.push_back(0);
+
+	InvalidateCache();
+}
+
+
+void CScanlineMask::SetLines(int firstLinePos, SwitchPoints& switchPoints, LineOffsets& lineOffsets)
+{
+	Q_ASSERT(!lineOffsets.empty());
+	Q_ASSERT(lineOffsets.back() == int(switchPoints.size()));
+
+	m_firstLinePos = firstLinePos;
+
+	m_switchPoints.swap(switchPoints);
+	m_lineOffsets.swap(lineOffsets);
+
+	InvalidateCache();
+}
+
+
+void CScanlineMask::InvalidateCache()
+{
+	m_isBoundingBoxValid = false;
+}
+
+
+void CScanlineMask::UniteShiftedLines(int shiftY)
+{
+	Q_ASSERT(shiftY > 0);
+
+	const int linesCount = int(m_lineOffsets.size()) - 1;
+
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+
+	BuildLines(
+				linesCount + shiftY,
+				[&](int lineIndex){
+					int pointsCount = 0;
+					int shiftedPointsCount = 0;
+					GetLineSwitchPoints(m_firstLinePos + lineIndex, pointsCount);
+					GetLineSwitchPoints(m_firstLinePos + lineIndex - shiftY, shiftedPointsCount);
+
+					return pointsCount + shiftedPointsCount;
+				},
+				[&](int lineIndex, int* resultPtr){
+					int pointsCount = 0;
+					int shiftedPointsCount = 0;
+					const int* pointsPtr = GetLineSwitchPoints(m_firstLinePos + lineIndex, pointsCount);
+					const int* shiftedPointsPtr = GetLineSwitchPoints(m_firstLinePos + lineIndex - shiftY, shiftedPointsCount);
+
+					return UniteLines(pointsPtr, pointsCount, shiftedPointsPtr, shiftedPointsCount, resultPtr);
+				},
+				switchPoints,
+				lineOffsets);
+
+	SetLines(m_firstLinePos, switchPoints, lineOffsets);
+}
+
+
+void CScanlineMask::IntersectShiftedLines(int shiftY)
+{
+	Q_ASSERT(shiftY > 0);
+
+	const int linesCount = int(m_lineOffsets.size()) - 1 - shiftY;
+	if (linesCount <= 0){
+		ResetImage();
+
+		return;
+	}
+
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+
+	BuildLines(
+				linesCount,
+				[&](int lineIndex){
+					int pointsCount = 0;
+					int shiftedPointsCount = 0;
+					GetLineSwitchPoints(m_firstLinePos + lineIndex, pointsCount);
+					GetLineSwitchPoints(m_firstLinePos + lineIndex + shiftY, shiftedPointsCount);
+
+					return ((pointsCount > 0) && (shiftedPointsCount > 0))? pointsCount + shiftedPointsCount: 0;
+				},
+				[&](int lineIndex, int* resultPtr){
+					int pointsCount = 0;
+					int shiftedPointsCount = 0;
+					const int* pointsPtr = GetLineSwitchPoints(m_firstLinePos + lineIndex, pointsCount);
+					const int* shiftedPointsPtr = GetLineSwitchPoints(m_firstLinePos + lineIndex + shiftY, shiftedPointsCount);
+
+					return IntersectLines(pointsPtr, pointsCount, shiftedPointsPtr, shiftedPointsCount, resultPtr);
+				},
+				switchPoints,
+				lineOffsets);
+
+	SetLines(m_firstLinePos, switchPoints, lineOffsets);
+}
+
+
+void CScanlineMask::ApplyStructuringElement(const CScanlineMask& structuringElement, bool isErosion)
+{
+	std::vector<ElementRow> elementRows;
+
+	const istd::CIntRange elementLinesRange = structuringElement.GetScanlinesRange();
+	for (int offsetY = elementLinesRange.GetMinValue(); offsetY < elementLinesRange.GetMaxValue(); ++offsetY){
+		ElementRow row;
+		row.offsetY = offsetY;
+		row.pointsPtr = structuringElement.GetLineSwitchPoints(offsetY, row.pointsCount);
+
+		if (row.pointsPtr != NULL){
+			elementRows.push_back(row);
+		}
+	}
+
+	if (elementRows.empty() || IsBitmapRegionEmpty()){
+		ResetImage();
+
+		return;
+	}
+
+	const i2d::CRect boundingRect = GetBoundingRect();
+	const int firstOffsetY = elementRows.front().offsetY;
+	const int lastOffsetY = elementRows.back().offsetY;
+
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+	int firstLinePos;
+
+	if (isErosion){
+		// result line contains positions, for which all element runs moved to them lie inside of the source lines
+		firstLinePos = boundingRect.GetTop() - firstOffsetY;
+		const int endLinePos = boundingRect.GetBottom() - lastOffsetY;
+		if (firstLinePos >= endLinePos){
+			ResetImage();
+
+			return;
+		}
+
+		BuildLines(
+					endLinePos - firstLinePos,
+					[&](int lineIndex){
+						int boundCount = 0;
+						for (const ElementRow& row : elementRows){
+							int pointsCount = 0;
+							if (GetLineSwitchPoints(firstLinePos + lineIndex + row.offsetY, pointsCount) == NULL){
+								return 0;
+							}
+
+							boundCount += pointsCount * (row.pointsCount / 2);
+						}
+
+						return boundCount;
+					},
+					[&](int lineIndex, int* resultPtr){
+						const int linePos = firstLinePos + lineIndex;
+
+						MorphologyBuffers& buffers = s_morphologyBuffers;
+
+						int resultCount = -1;
+
+						for (const ElementRow& row : elementRows){
+							int pointsCount = 0;
+							const int* pointsPtr = GetLineSwitchPoints(linePos + row.offsetY, pointsCount);
+							if (pointsPtr == NULL){
+								return 0;
+							}
+
+							for (int runIndex = 0; runIndex < row.pointsCount; runIndex += 2){
+								int* runPointsPtr = ReserveBuffer(buffers.runPoints, pointsCount);
+								const int runPointsCount = ErodeLineByRun(pointsPtr, pointsCount, row.pointsPtr[runIndex], row.pointsPtr[runIndex + 1], runPointsPtr);
+
+								if (resultCount < 0){
+									std::swap(buffers.resultPoints, buffers.runPoints);
+
+									resultCount = runPointsCount;
+								}
+								else{
+									int* tempPointsPtr = ReserveBuffer(buffers.tempPoints, resultCount + runPointsCount);
+									resultCount = IntersectLines(buffers.resultPoints.data(), resultCount, runPointsPtr, runPointsCount, tempPointsPtr);
+
+									std::swap(buffers.resultPoints, buffers.tempPoints);
+								}
+
+								if (resultCount == 0){
+									return 0;
+								}
+							}
+						}
+
+						std::copy(buffers.resultPoints.begin(), buffers.resultPoints.begin() + resultCount, resultPtr);
+
+						return resultCount;
+					},
+					switchPoints,
+					lineOffsets);
+	}
+	else{
+		// result line is union of the source lines dilated by the element runs
+		firstLinePos = boundingRect.GetTop() + firstOffsetY;
+		const int endLinePos = boundingRect.GetBottom() + lastOffsetY;
+
+		BuildLines(
+					endLinePos - firstLinePos,
+					[&](int lineIndex){
+						int boundCount = 0;
+						for (const ElementRow& row : elementRows){
+							int pointsCount = 0;
+							GetLineSwitchPoints(firstLinePos + lineIndex - row.offsetY, pointsCount);
+
+							boundCount += pointsCount * (row.pointsCount / 2);
+						}
+
+						return boundCount;
+					},
+					[&](int lineIndex, int* resultPtr){
+						MorphologyBuffers& buffers = s_morphologyBuffers;
+
+						int resultCount = 0;
+
+						for (const ElementRow& row : elementRows){
+							int pointsCount = 0;
+							const int* pointsPtr = GetLineSwitchPoints(firstLinePos + lineIndex - row.offsetY, pointsCount);
+							if (pointsPtr == NULL){
+								continue;
+							}
+
+							for (int runIndex = 0; runIndex < row.pointsCount; runIndex += 2){
+								int* runPointsPtr = ReserveBuffer(buffers.runPoints, pointsCount);
+								const int runPointsCount = DilateLineByRun(pointsPtr, pointsCount, row.pointsPtr[runIndex], row.pointsPtr[runIndex + 1], runPointsPtr);
+
+								int* tempPointsPtr = ReserveBuffer(buffers.tempPoints, resultCount + runPointsCount);
+								resultCount = UniteLines(buffers.resultPoints.data(), resultCount, runPointsPtr, runPointsCount, tempPointsPtr);
+
+								std::swap(buffers.resultPoints, buffers.tempPoints);
+							}
+						}
+
+						std::copy(buffers.resultPoints.begin(), buffers.resultPoints.begin() + resultCount, resultPtr);
+
+						return resultCount;
+					},
+					switchPoints,
+					lineOffsets);
+	}
+
+	SetLines(firstLinePos, switchPoints, lineOffsets);
+}
+
+
+void CScanlineMask::ApplyCircle(double radius, bool isErosion)
+{
+	const std::vector<int> widths = CalcEllipseWidths(radius, radius);
+	if (widths.empty() || IsBitmapRegionEmpty()){
+		ResetImage();
+
+		return;
+	}
+
+	const int radiusY = int(widths.size()) - 1;
+	const int margin = isErosion? 1: radiusY;
+	const i2d::CRect boundingRect = GetBoundingRect();
+
+	// the mask can cover almost whole coordinate range, its size must be calculated without overflow
+	const qint64 gridWidth = qint64(boundingRect.GetRight()) - boundingRect.GetLeft() + 2 * qint64(margin);
+	const qint64 gridHeight = qint64(boundingRect.GetBottom()) - boundingRect.GetTop() + 2 * qint64(margin);
+	const qint64 area = gridWidth * gridHeight;
+	const qint64 runsCost = qint64(m_switchPoints.size()) * (2 * radiusY + 1);
+
+	if (		(radiusY <= s_maxDistanceTransformRadius) &&
+				(area <= s_maxDistanceTransformArea) &&
+				(runsCost > area * s_distanceTransformCostRatio)){
+		ApplyCircleUsingDistances(widths, isErosion);
+	}
+	else{
+		CScanlineMask structuringElement;
+		structuringElement.CreateEllipseElement(radius, radius);
+
+		ApplyStructuringElement(structuringElement, isErosion);
+	}
+}
+
+
+void CScanlineMask::ApplyCircleUsingDistances(const std::vector<int>& widths, bool isErosion)
+{
+	Q_ASSERT(!widths.empty());
+	Q_ASSERT(!IsBitmapRegionEmpty());
+
+	// distances greater than the radius are stored as radius + 1
+	const int radiusY = int(widths.size()) - 1;
+	const quint16 maxDistance = quint16(radiusY + 1);
+
+	// dilatation is calculated from distances to the mask, erosion from distances to the background,
+	// a single background line or column around the mask is enough to get the nearest background positions
+	const int margin = isErosion? 1: radiusY;
+	const i2d::CRect boundingRect = GetBoundingRect();
+	const int gridLeft = boundingRect.GetLeft() - margin;
+	const int gridTop = boundingRect.GetTop() - margin;
+	const qint64 area = (qint64(boundingRect.GetRight()) - boundingRect.GetLeft() + 2 * qint64(margin)) * (qint64(boundingRect.GetBottom()) - boundingRect.GetTop() + 2 * qint64(margin));
+	Q_ASSERT(area <= s_maxDistanceTransformArea);
+
+	const int gridWidth = boundingRect.GetWidth() + 2 * margin;
+	const int gridHeight = boundingRect.GetHeight() + 2 * margin;
+
+	// vertical distances, columns are independent
+	std::vector<quint16> distances(size_t(gridWidth) * gridHeight);
+
+	const int bandsCount = istd::CParallelFor::GetBandsCount(gridWidth, area);
+
+	istd::CParallelFor::ProcessBands(gridWidth, bandsCount, [&](int /*bandIndex*/, int beginColumn, int endColumn){
+		for (int y = 0; y < gridHeight; ++y){
+			quint16* distancesPtr = distances.data() + qint64(y) * gridWidth;
+			const quint16* prevDistancesPtr = (y > 0)? distancesPtr - gridWidth: NULL;
+
+			int pointsCount = 0;
+			const int* pointsPtr = GetLineSwitchPoints(gridTop + y, pointsCount);
+
+			if (isErosion){
+				std::fill(distancesPtr + beginColumn, distancesPtr + endColumn, quint16(0));
+			}
+			else if (y > 0){
+				for (int x = beginColumn; x < endColumn; ++x){
+					distancesPtr[x] = qMin(quint16(prevDistancesPtr[x] + 1), maxDistance);
+				}
+			}
+			else{
+				std::fill(distancesPtr + beginColumn, distancesPtr + endColumn, maxDistance);
+			}
+
+			for (int index = 0; index < pointsCount; index += 2){
+				const int begin = qMax(pointsPtr[index] - gridLeft, beginColumn);
+				const int end = qMin(pointsPtr[index + 1] - gridLeft, endColumn);
+
+				if (isErosion){
+					Q_ASSERT(y > 0);
+
+					for (int x = begin; x < end; ++x){
+						distancesPtr[x] = qMin(quint16(prevDistancesPtr[x] + 1), maxDistance);
+					}
+				}
+				else if (begin < end){
+					std::fill(distancesPtr + begin, distancesPtr + end, quint16(0));
+				}
+			}
+		}
+
+		for (int y = gridHeight - 2; y >= 0; --y){
+			quint16* distancesPtr = distances.data() + qint64(y) * gridWidth;
+			const quint16* nextDistancesPtr = distancesPtr + gridWidth;
+
+			for (int x = beginColumn; x < endColumn; ++x){
+				distancesPtr[x] = qMin(distancesPtr[x], quint16(nextDistancesPtr[x] + 1));
+			}
+		}
+	});
+
+	// each column in vertical distance d covers horizontally the circle width for d,
+	// the union of these ranges is the set of positions in the Euclidean distance not greater than the radius
+	const int firstGridLine = isErosion? 1: 0;
+
+	SwitchPoints switchPoints;
+	LineOffsets lineOffsets;
+
+	BuildLinesInBands(
+				gridHeight - 2 * firstGridLine,
+				area,
+				[&](int beginLine, int endLine, SwitchPoints& bandPoints, std::vector<int>& pointsCounts){
+					std::vector<int> rangeEnds(gridWidth);
+					std::vector<int> coveredPoints(gridWidth + 1);
+					std::vector<int> invertedPoints(gridWidth + 3);
+
+					for (int lineIndex = beginLine; lineIndex < endLine; ++lineIndex){
+						const quint16* distancesPtr = distances.data() + qint64(lineIndex + firstGridLine) * gridWidth;
+
+						// farthest end of ranges beginning at each position
+						std::fill(rangeEnds.begin(), rangeEnds.end(), -1);
+						for (int x = 0; x < gridWidth; ++x){
+							const int distance = distancesPtr[x];
+							if (distance < maxDistance){
+								const int width = widths[distance];
+								const int begin = qMax(x - width, 0);
+
+								rangeEnds[begin] = qMax(rangeEnds[begin], qMin(x + width + 1, gridWidth));
+							}
+						}
+
+						int pointsCount = 0;
+						for (int x = 0; x < gridWidth; ++x){
+							const int end = rangeEnds[x];
+							if (end < 0){
+								continue;
+							}
+
+							if ((pointsCount > 0) && (coveredPoints[pointsCount - 1] >= x)){
+								coveredPoints[pointsCount - 1] = qMax(coveredPoints[pointsCount - 1], end);
+							}
+							else{
+								coveredPoints[pointsCount++] = x;
+								coveredPoints[pointsCount++] = end;
+							}
+						}
+
+						const int* resultPtr = coveredPoints.data();
+						if (isErosion){
+							pointsCount = InvertLine(coveredPoints.data(), pointsCount, 1, gridWidth - 1, invertedPoints.data());
+							resultPtr = invertedPoints.data();
+						}
+
+						for (int index = 0; index < pointsCount; ++index){
+							bandPoints.push_back(resultPtr[index] + gridLeft);
+						}
+
+						pointsCounts[lineIndex] = pointsCount;
+					}
+				},
+				switchPoints,
+				lineOffsets);
+
+	SetLines(gridTop + firstGridLine, switchPoints, lineOffsets);
+}
+
+
 // related global functions
 
 uint qHash(const CScanlineMask& key, uint seed)
 {
 	uint retVal = seed;
 
-	int lineIndex = key.m_firstLinePos;
-	for (CScanlineMask::Scanlines::const_iterator iter = key.m_scanlines.begin(); iter != key.m_scanlines.end(); ++iter, ++lineIndex){
-		int containerIndex = *iter;
-
-		if (containerIndex >= 0){
-			const istd::CIntRanges& scanLine = key.m_rangesContainer[containerIndex];
+	int linesCount = int(key.m_lineOffsets.size()) - 1;
+	for (int i = 0; i < linesCount; ++i){
+		int lineOffset = key.m_lineOffsets[i];
+		int lineEndOffset = key.m_lineOffsets[i + 1];
+		if (lineOffset >= lineEndOffset){
+			continue;
+		}
 
-			if (!scanLine.IsEmpty()){
-				retVal = retVal ^ qHash(scanLine, seed) ^ uint(lineIndex);
-			}
+		// the same as hash value of istd::CIntRanges
+		uint lineHash = seed;
+		for (int pointIndex = lineOffset; pointIndex < lineEndOffset; ++pointIndex){
+			lineHash = lineHash ^ uint(key.m_switchPoints[pointIndex]);
 		}
+
+		retVal = retVal ^ lineHash ^ uint(key.m_firstLinePos + i);
 	}
 
 	return retVal;
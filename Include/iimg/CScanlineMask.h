@@ -5,9 +5,6 @@
 // STL includes
 #include <vector>
 
-// Qt includes
-#include <QtCore/QList>
-
 // ACF includes
 #include <istd/TRanges.h>
 #include <i2d/CObject2dBase.h>
@@ -26,6 +23,14 @@ namespace iimg
 /**
 	Representation of a 2D-region as container of bitmap line scans.
 
+	The runs of active pixels of all lines are stored in a single array of sorted switch points,
+	each run is described by a pair of its begin and end position.
+	Switch points of each line are strictly increasing, touching runs are always merged.
+	The lines are addressed using array of offsets of their first switch points.
+	Set operations merge the sorted switch points line by line, for large masks the lines are processed in parallel.
+	Morphological operations combine runs of the mask with runs of the structuring element lines,
+	circular structuring elements of large radii are applied using distance transformation.
+
 	\ingroup ImageProcessing
 	\ingroup Geometry
 */
@@ -35,8 +40,23 @@ class CScanlineMask:
 {
 public:
 	typedef i2d::CObject2dBase BaseClass;
-	typedef QList<istd::CIntRanges> RangesContainer;
-	typedef std::vector<int> Scanlines;	// Index of container element for each scan line, negative value for empty element
+	typedef std::vector<int> SwitchPoints;	// Sorted switch points of all lines, pairs of begin and end of the runs
+	typedef std::vector<int> LineOffsets;	// Index of the first switch point of each line, the last element is the end of the last line
+
+	/**
+		Rule deciding which areas of a self-intersecting or nested polygon outline are filled.
+	*/
+	enum FillRule
+	{
+		/**
+			Point is inside, if a ray from it crosses the outline odd number of times.
+		*/
+		FR_EVEN_ODD,
+		/**
+			Point is inside, if the outline winds around it nonzero number of times.
+		*/
+		FR_NON_ZERO
+	};
 
 	CScanlineMask();
 
@@ -57,10 +77,27 @@ public:
 	*/
 	void ResetScanlines(const istd::CIntRange& verticalRange);
 
+	/**
+		Get vertical range of lines stored in this mask.
+		Lines out of this range contain no pixels.
+	*/
+	istd::CIntRange GetScanlinesRange() const;
+
+	/**
+		Get switch points of the given line.
+		\param	lineIndex	position of the line.
+		\param	pointsCount	number of switch points of the line, it is always even.
+		\return	pointer to the sorted switch points, pairs of begin and end of the runs, or NULL if the line contains no pixels.
+	*/
+	const int* GetLineSwitchPoints(int lineIndex, int& pointsCount) const;
+
 	/**
 		Get the list of pixel ranges per given line.
+		The list is created from the switch points of the line, for fast access use \c GetLineSwitchPoints instead.
+		\param	result	will be filled with the ranges of the line.
+		\return	false, if the line contains no pixels.
 	*/
-	const istd::CIntRanges* GetPixelRanges(int lineIndex) const;
+	bool GetPixelRanges(int lineIndex, istd::CIntRanges& result) const;
 
 	/**
 		Create filled 2D-region clipped to rectangle area.
@@ -97,10 +134,14 @@ public:
 
 	/**
 		Create 2D-region from polygon.
+		Pixel belongs to the region if its center is inside of the polygon.
+		The polygon is rasterized using a sorted table of its edges and incrementally updated list of edges crossing the current line,
+		so the calculation time grows nearly linear with the number of nodes and lines.
 		\param	polygon		polygon object.
 		\param	clipAreaPtr	optional clipping area.
+		\param	fillRule	rule deciding which parts of a self-intersecting polygon are filled.
 	*/
-	void CreateFromPolygon(const i2d::CPolygon& polygon, const i2d::CRect* clipAreaPtr = NULL);
+	void CreateFromPolygon(const i2d::CPolygon& polygon, const i2d::CRect* clipAreaPtr = NULL, FillRule fillRule = FR_EVEN_ODD);
 
 	/**
 		Create 2D-region from tube.
@@ -116,6 +157,23 @@ public:
 	*/
 	void CreateFromBitmap(const iimg::IBitmap& bitmap, const i2d::CRect* clipAreaPtr = NULL);
 
+	/**
+		Calculate anti-aliased coverage of the bitmap pixels by a polygon.
+		Each pixel gets the covered part of its area in range [0, 1], the coverage is exact horizontally
+		and vertically it is sampled by the given number of sub-lines per pixel.
+		The polygon coordinates are in pixels of the bitmap, calibration is not used.
+		\param	polygon			polygon object.
+		\param	coverageBitmap	created bitmap of format \c IBitmap::PF_FLOAT32, all pixels will be overwritten.
+		\param	fillRule		rule deciding which parts of a self-intersecting polygon are filled.
+		\param	subLinesCount	number of vertical samples per pixel.
+		\return	true, if the bitmap format is supported.
+	*/
+	static bool CalcPolygonCoverage(
+				const i2d::CPolygon& polygon,
+				iimg::IBitmap& coverageBitmap,
+				FillRule fillRule = FR_EVEN_ODD,
+				int subLinesCount = 16);
+
 	/**
 		Get inverted mask.
 		\param	clipArea	clipping area.
@@ -191,6 +249,52 @@ public:
 	*/
 	void Dilate(int leftValue, int rightValue, int topValue, int bottomValue);
 
+	/**
+		Calculate erosion of this mask with structuring element.
+		Positions of the structuring element are offsets relative to the origin.
+		The result contains all positions p, for which p + s lies inside of this mask for each offset s of the element.
+		The calculation works on runs of both masks, its cost is proportional to the number of runs of this mask multiplied by the number of element runs.
+		If the structuring element is empty, the result is empty.
+	*/
+	void Erode(const CScanlineMask& structuringElement);
+
+	/**
+		Calculate dilatation of this mask with structuring element.
+		Positions of the structuring element are offsets relative to the origin.
+		The result contains all positions p + s, where p is position inside of this mask and s is offset of the element.
+		If the structuring element is empty, the result is empty.
+	*/
+	void Dilate(const CScanlineMask& structuringElement);
+
+	/**
+		Calculate morphological opening (erosion followed by dilatation) with structuring element.
+	*/
+	void Open(const CScanlineMask& structuringElement);
+
+	/**
+		Calculate morphological closing (dilatation followed by erosion) with structuring element.
+	*/
+	void Close(const CScanlineMask& structuringElement);
+
+	/**
+		Calculate erosion of this mask with circular structuring element.
+		The element contains all offsets with the distance to the origin not greater than the radius (the same as \c CreateEllipseElement(radius, radius)).
+		For large radii the result is calculated using Euclidean distance transformation, the cost is then proportional to the area of the mask.
+	*/
+	void ErodeCircle(double radius);
+
+	/**
+		Calculate dilatation of this mask with circular structuring element.
+		\sa ErodeCircle
+	*/
+	void DilateCircle(double radius);
+
+	/**
+		Create structuring element of an ellipse centered at the origin.
+		Offset (dx, dy) belongs to the element if (dx / radiusX)^2 + (dy / radiusY)^2 <= 1.
+	*/
+	void CreateEllipseElement(double radiusX, double radiusY);
+
 	// reimplemented (i2d::IObject2d)
 	virtual i2d::CVector2d GetCenter() const override;
 	virtual void MoveCenterTo(const i2d::CVector2d& position) override;
@@ -224,13 +328,57 @@ protected:
 	void CalcBoundingBox() const;
 	void InitFromBoundingBox(const i2d::CRectangle& objectBoundingBox, const i2d::CRect* clipAreaPtr);
 
+	/**
+		Start building of the lines beginning from the given position.
+		Lines will be added using \c AppendRun and \c FinishLine.
+	*/
+	void BeginLines(int firstLinePos, int linesCount);
+	/**
+		Add run of pixels to the currently built line.
+		The runs must be added in order of their positions, empty runs are ignored.
+	*/
+	void AppendRun(int begin, int end);
+	/**
+		Finish the currently built line.
+	*/
+	void FinishLine();
+	/**
+		Set new content of the mask.
+	*/
+	void SetLines(int firstLinePos, SwitchPoints& switchPoints, LineOffsets& lineOffsets);
+	/**
+		Mark all calculated data as invalid, it should be called after each change of the lines.
+	*/
+	void InvalidateCache();
+
+	/**
+		Unite each line with the line moved by the given number of lines down, the vertical range is extended by the shift.
+	*/
+	void UniteShiftedLines(int shiftY);
+	/**
+		Intersect each line with the line moved by the given number of lines up, the vertical range is reduced by the shift.
+	*/
+	void IntersectShiftedLines(int shiftY);
+	/**
+		Calculate erosion or dilatation with structuring element using runs of the element lines.
+	*/
+	void ApplyStructuringElement(const CScanlineMask& structuringElement, bool isErosion);
+	/**
+		Calculate erosion or dilatation with circular structuring element, it selects the cheaper calculation method.
+	*/
+	void ApplyCircle(double radius, bool isErosion);
+	/**
+		Calculate erosion or dilatation with circular structuring element using distance transformation.
+		\param	widths	half widths of the element lines for each absolute vertical offset.
+	*/
+	void ApplyCircleUsingDistances(const std::vector<int>& widths, bool isErosion);
+
 	template <typename PixelType>
 	void CalculateMaskFromBitmap(const iimg::IBitmap& bitmap, const i2d::CRect* clipAreaPtr = NULL);
 
 private:
-	RangesContainer m_rangesContainer;
-
-	Scanlines m_scanlines;
+	SwitchPoints m_switchPoints;
+	LineOffsets m_lineOffsets;
 
 	int m_firstLinePos;
 
@@ -257,6 +405,32 @@ inline void CScanlineMask::EnsureBoundingBoxValid() const
 }
 
 
+inline void CScanlineMask::AppendRun(int begin, int end)
+{
+	if (begin >= end){
+		return;
+	}
+
+	if ((int(m_switchPoints.size()) > m_lineOffsets.back()) && (m_switchPoints.back() >= begin)){
+		// run touches or overlaps the previous one
+		if (end > m_switchPoints.back()){
+			m_switchPoints.back() = end;
+		}
+
+		return;
+	}
+
+	m_switchPoints.push_back(begin);
+	m_switchPoints.push_back(end);
+}
+
+
+inline void CScanlineMask::FinishLine()
+{
+	m_lineOffsets.push_back(int(m_switchPoints.size()));
+}
+
+
 // protected methods
 
 template <typename PixelType>
@@ -264,70 +438,51 @@ void CScanlineMask::CalculateMaskFromBitmap(const iimg::IBitmap& bitmap, const i
 {
 	InitFromBoundingBox(bitmap.GetBoundingBox(), clipAreaPtr);
 
-	int linesCount = int(m_scanlines.size());
+	int linesCount = GetScanlinesRange().GetLength();
 	if (linesCount <= 0){
 		ResetImage();
 
 		return;
 	}
 
-#if QT_VERSION >= 0x040700
-	m_rangesContainer.reserve(linesCount);
-#endif
-
-	Q_ASSERT(bitmap.GetImageSize().GetY() == (linesCount));
+	Q_ASSERT(m_firstLinePos >= 0);
+	Q_ASSERT(bitmap.GetImageSize().GetY() >= m_firstLinePos + linesCount);
 
 	int imageWidth = bitmap.GetImageSize().GetX();
 
-	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
-		istd::CIntRanges rangeList;
+	int clipLeft = 0;
+	int clipRight = imageWidth;
+	if (clipAreaPtr != NULL){
+		clipLeft = qMax(clipLeft, clipAreaPtr->GetLeft());
+		clipRight = qMin(clipRight, clipAreaPtr->GetRight());
+	}
 
-		PixelType* imageLinePtr = (PixelType*)bitmap.GetLinePtr(lineIndex);
+	BeginLines(m_firstLinePos, linesCount);
+
+	for (int lineIndex = 0; lineIndex < linesCount; lineIndex++){
+		const PixelType* imageLinePtr = (const PixelType*)bitmap.GetLinePtr(m_firstLinePos + lineIndex);
 		Q_ASSERT(imageLinePtr != NULL);
 
 		int left = -1;
-		int right = -1;
 
-		for (int x = 0; x < imageWidth; ++x){
+		for (int x = clipLeft; x < clipRight; ++x){
 			PixelType pixel = *(imageLinePtr + x);
 			if ((pixel > 0) && (left < 0)){
 				left = x;
 			}
 
 			if ((pixel == 0) && (left >= 0)){
-				right = x;
-				if (clipAreaPtr != NULL){
-					if (left < clipAreaPtr->GetLeft()){
-						left = clipAreaPtr->GetLeft();
-					}
-
-					if (right > clipAreaPtr->GetRight()){
-						right = clipAreaPtr->GetRight();
-					}
-				}
-
-				if (left < right){
-					rangeList.InsertSwitchPoint(left);
-					rangeList.InsertSwitchPoint(right);
-				}
+				AppendRun(left, x);
 
 				left = -1;
-				right = -1;
 			}
 		}
 
-		if ((left >= 0) && (right < 0)){
-			rangeList.InsertSwitchPoint(left);
+		if (left >= 0){
+			AppendRun(left, clipRight);
 		}
 
-		if (!rangeList.IsEmpty()){
-			m_rangesContainer.push_back(rangeList);
-
-			m_scanlines[lineIndex] = m_rangesContainer.size() - 1;
-		}
-		else{
-			m_scanlines[lineIndex] =  -1;
-		}
+		FinishLine();
 	}
 }
 
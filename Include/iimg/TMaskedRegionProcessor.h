@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// STL includes
+#include <vector>
+
+// ACF includes
+#include <istd/CParallelFor.h>
+#include <iimg/IBitmap.h>
+#include <iimg/CScanlineMask.h>
+
+
+namespace iimg
+{
+
+
+/**
+	Processing of bitmap pixels inside of a scanline mask.
+
+	Runs of the mask are clipped to the bitmap and visited directly in the bitmap memory,
+	the processing function gets pointer to the first pixel of each run and can work on the whole run at once.
+	Reduction of large regions is split into bands of lines processed in parallel by the global thread pool.
+
+	\tparam	PixelType	type of a single pixel, its size must be equal to the pixel size of the processed bitmaps.
+
+	\ingroup ImageProcessing
+*/
+template <typename PixelType>
+class TMaskedRegionProcessor
+{
+public:
+	/**
+		Get range of lines of the mask inside of the bitmap.
+	*/
+	static istd::CIntRange GetLinesRange(const IBitmap& bitmap, const CScanlineMask& mask);
+
+	/**
+		Call the function for each run of the mask inside of the bitmap.
+		\param	runFunction	function called as \c runFunction(const PixelType* pixelsPtr, int x, int y, int pixelsCount),
+							\c pixelsPtr points to the first pixel of the run at position (x, y).
+	*/
+	template <typename RunFunction>
+	static void ProcessRuns(const IBitmap& bitmap, const CScanlineMask& mask, RunFunction runFunction);
+
+	/**
+		Call the function for each run of the mask inside of the bitmap for lines in range [beginLine, endLine).
+		\overload
+	*/
+	template <typename RunFunction>
+	static void ProcessRuns(const IBitmap& bitmap, const CScanlineMask& mask, int beginLine, int endLine, RunFunction& runFunction);
+
+	/**
+		Accumulate all pixels of the region.
+		The accumulator must provide methods \c AddRun(const PixelType* pixelsPtr, int x, int y, int pixelsCount)
+		and \c Merge(const Accumulator& accumulator).
+		Large regions are processed in bands of lines in parallel, each band uses its own copy of the given accumulator,
+		the results of the bands are merged into the given accumulator in order of the lines.
+		For this reason the given accumulator should be in its initial (empty) state.
+	*/
+	template <typename Accumulator>
+	static void Reduce(const IBitmap& bitmap, const CScanlineMask& mask, Accumulator& accumulator);
+};
+
+
+// public static methods
+
+template <typename PixelType>
+istd::CIntRange TMaskedRegionProcessor<PixelType>::GetLinesRange(const IBitmap& bitmap, const CScanlineMask& mask)
+{
+	const istd::CIntRange linesRange = mask.GetScanlinesRange();
+
+	const int beginLine = qMax(linesRange.GetMinValue(), 0);
+	const int endLine = qMin(linesRange.GetMaxValue(), bitmap.GetImageSize().GetY());
+
+	return istd::CIntRange(beginLine, qMax(beginLine, endLine));
+}
+
+
+template <typename PixelType>
+template <typename RunFunction>
+void TMaskedRegionProcessor<PixelType>::ProcessRuns(const IBitmap& bitmap, const CScanlineMask& mask, RunFunction runFunction)
+{
+	const istd::CIntRange linesRange = GetLinesRange(bitmap, mask);
+
+	ProcessRuns(bitmap, mask, linesRange.GetMinValue(), linesRange.GetMaxValue(), runFunction);
+}
+
+
+template <typename PixelType>
+template <typename RunFunction>
+void TMaskedRegionProcessor<PixelType>::ProcessRuns(const IBitmap& bitmap, const CScanlineMask& mask, int beginLine, int endLine, RunFunction& runFunction)
+{
+	const int imageWidth = bitmap.GetImageSize().GetX();
+
+	for (int y = beginLine; y < endLine; ++y){
+		int pointsCount = 0;
+		const int* pointsPtr = mask.GetLineSwitchPoints(y, pointsCount);
+		if (pointsPtr == NULL){
+			continue;
+		}
+
+		const PixelType* linePtr = static_cast<const PixelType*>(bitmap.GetLinePtr(y));
+		Q_ASSERT(linePtr != NULL);
+
+		for (int index = 0; index < pointsCount; index += 2){
+			const int begin = qMax(pointsPtr[index], 0);
+			const int end = qMin(pointsPtr[index + 1], imageWidth);
+			if (begin < end){
+				runFunction(linePtr + begin, begin, y, end - begin);
+			}
+		}
+	}
+}
+
+
+template <typename PixelType>
+template <typename Accumulator>
+void TMaskedRegionProcessor<PixelType>::Reduce(const IBitmap& bitmap, const CScanlineMask& mask, Accumulator& accumulator)
+{
+	const istd::CIntRange linesRange = GetLinesRange(bitmap, mask);
+	const int beginLine = linesRange.GetMinValue();
+	const int linesCount = linesRange.GetLength();
+	if (linesCount <= 0){
+		return;
+	}
+
+	// the mask can contain runs open to infinity, its width must be calculated without overflow
+	const i2d::CRect boundingRect = mask.GetBoundingRect();
+	const qint64 maskWidth = qint64(boundingRect.GetRight()) - boundingRect.GetLeft();
+	const qint64 pixelsCount = qMin(maskWidth, qint64(bitmap.GetImageSize().GetX())) * linesCount;
+
+	const int bandsCount = istd::CParallelFor::GetBandsCount(linesCount, pixelsCount);
+	if (bandsCount <= 1){
+		auto addRun = [&accumulator](const PixelType* pixelsPtr, int x, int y, int runPixelsCount){
+			accumulator.AddRun(pixelsPtr, x, y, runPixelsCount);
+		};
+
+		ProcessRuns(bitmap, mask, beginLine, beginLine + linesCount, addRun);
+
+		return;
+	}
+
+	std::vector<Accumulator> bandAccumulators(size_t(bandsCount), accumulator);
+
+	istd::CParallelFor::ProcessBands(linesCount, bandsCount, [&](int bandIndex, int bandBeginLine, int bandEndLine){
+		Accumulator& bandAccumulator = bandAccumulators[bandIndex];
+
+		auto addRun = [&bandAccumulator](const PixelType* pixelsPtr, int x, int y, int runPixelsCount){
+			bandAccumulator.AddRun(pixelsPtr, x, y, runPixelsCount);
+		};
+
+		ProcessRuns(bitmap, mask, beginLine + bandBeginLine, beginLine + bandEndLine, addRun);
+	});
+
+	for (const Accumulator& bandAccumulator : bandAccumulators){
+		accumulator.Merge(bandAccumulator);
+	}
+}
+
+
+} // namespace iimg
+
+
@@ -0,0 +1,459 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CMaskedRegionStatisticsTest.h"
+
+
+// STL includes
+#include <cmath>
+#include <limits>
+
+// ACF includes
+#include <iimg/CGeneralBitmap.h>
+#include <iimg/TMaskedRegionProcessor.h>
+
+
+namespace
+{
+
+
+typedef iimg::IBitmap::PixelFormat PixelFormat;
+
+
+static const int s_bitmapWidth = 70;
+static const int s_bitmapHeight = 50;
+static const int s_benchmarkImageSize = 4000;
+
+
+/**
+	Size of a single component and number of components stored in a pixel.
+*/
+void GetPixelLayout(PixelFormat format, int& componentBytesCount, int& componentsCount)
+{
+	switch (format){
+	case iimg::IBitmap::PF_GRAY16:
+		componentBytesCount = 2;
+		componentsCount = 1;
+		break;
+
+	case iimg::IBitmap::PF_GRAY32:
+	case iimg::IBitmap::PF_FLOAT32:
+		componentBytesCount = 4;
+		componentsCount = 1;
+		break;
+
+	case iimg::IBitmap::PF_FLOAT64:
+		componentBytesCount = 8;
+		componentsCount = 1;
+		break;
+
+	case iimg::IBitmap::PF_RGB:
+	case iimg::IBitmap::PF_RGBA:
+		componentBytesCount = 1;
+		componentsCount = 4;
+		break;
+
+	case iimg::IBitmap::PF_RGB24:
+		componentBytesCount = 1;
+		componentsCount = 3;
+		break;
+
+	case iimg::IBitmap::PF_RGB48:
+		componentBytesCount = 2;
+		componentsCount = 3;
+		break;
+
+	case iimg::IBitmap::PF_RGBA64:
+		componentBytesCount = 2;
+		componentsCount = 4;
+		break;
+
+	default:
+		componentBytesCount = 1;
+		componentsCount = 1;
+		break;
+	}
+}
+
+
+/**
+	Test value of the pixel component, some values of floating point formats are NaN.
+*/
+double GetTestValue(PixelFormat format, int x, int y, int componentIndex)
+{
+	if (((format == iimg::IBitmap::PF_FLOAT32) || (format == iimg::IBitmap::PF_FLOAT64)) && ((x * 7 + y * 3) % 23 == 0)){
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	return (x * x * 3 + y * 5 + componentIndex * 11) % 251;
+}
+
+
+void FillBitmap(iimg::IBitmap& bitmap)
+{
+	const PixelFormat format = bitmap.GetPixelFormat();
+
+	int componentBytesCount = 0;
+	int componentsCount = 0;
+	GetPixelLayout(format, componentBytesCount, componentsCount);
+
+	const istd::CIndex2d size = bitmap.GetImageSize();
+
+	for (int y = 0; y < size.GetY(); ++y){
+		quint8* linePtr = static_cast<quint8*>(bitmap.GetLinePtr(y));
+
+		for (int x = 0; x < size.GetX(); ++x){
+			for (int componentIndex = 0; componentIndex < componentsCount; ++componentIndex){
+				void* componentPtr = linePtr + (x * componentsCount + componentIndex) * componentBytesCount;
+				const double value = GetTestValue(format, x, y, componentIndex);
+
+				switch (format){
+				case iimg::IBitmap::PF_GRAY16:
+				case iimg::IBitmap::PF_RGB48:
+				case iimg::IBitmap::PF_RGBA64:
+					*static_cast<quint16*>(componentPtr) = quint16(value * 257);
+					break;
+
+				case iimg::IBitmap::PF_GRAY32:
+					*static_cast<quint32*>(componentPtr) = quint32(value * 16777216);
+					break;
+
+				case iimg::IBitmap::PF_FLOAT32:
+					*static_cast<float*>(componentPtr) = float(value / 4);
+					break;
+
+				case iimg::IBitmap::PF_FLOAT64:
+					*static_cast<double*>(componentPtr) = value / 4;
+					break;
+
+				default:
+					*static_cast<quint8*>(componentPtr) = quint8(value);
+					break;
+				}
+			}
+		}
+	}
+}
+
+
+/**
+	Get raw value of the component written by \c FillBitmap.
+*/
+double GetRawValue(PixelFormat format, int x, int y, int componentIndex)
+{
+	const double value = GetTestValue(format, x, y, componentIndex);
+
+	switch (format){
+	case iimg::IBitmap::PF_GRAY16:
+	case iimg::IBitmap::PF_RGB48:
+	case iimg::IBitmap::PF_RGBA64:
+		return value * 257;
+
+	case iimg::IBitmap::PF_GRAY32:
+		return value * 16777216;
+
+	case iimg::IBitmap::PF_FLOAT32:
+	case iimg::IBitmap::PF_FLOAT64:
+		return value / 4;
+
+	default:
+		return value;
+	}
+}
+
+
+bool IsPixelInside(const iimg::CScanlineMask& mask, int x, int y)
+{
+	return mask.GetColorAt(istd::CIndex2d(x, y)).GetElement(0) > 0;
+}
+
+
+/**
+	Create mask of a circle with a hole crossing the bitmap borders.
+*/
+void CreateTestMask(iimg::CScanlineMask& mask)
+{
+	mask.CreateFromCircle(i2d::CCircle(30, i2d::CVector2d(40, 20)));
+
+	iimg::CScanlineMask holeMask;
+	holeMask.CreateFilled(i2d::CRect(30, 10, 45, 18));
+
+	mask.Invert(i2d::CRect(-20, -20, 100, 100));
+	mask.Union(holeMask);
+	mask.Invert(i2d::CRect(-20, -20, 100, 100));
+}
+
+
+} // namespace
+
+
+// private slots
+
+void CMaskedRegionStatisticsTest::IsComponentSupportedTest()
+{
+	QVERIFY(iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_GRAY, 0));
+	QVERIFY(!iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_GRAY, 1));
+	QVERIFY(iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_RGB, 2));
+	QVERIFY(!iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_RGB, 3));
+	QVERIFY(iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_RGBA64, 3));
+	QVERIFY(!iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_MONO, 0));
+	QVERIFY(!iimg::CMaskedRegionStatistics::IsComponentSupported(iimg::IBitmap::PF_FLOAT32, -1));
+}
+
+
+void CMaskedRegionStatisticsTest::CalcStatisticsTest_data()
+{
+	QTest::addColumn<int>("format");
+	QTest::addColumn<int>("componentIndex");
+
+	QTest::newRow("Gray") << int(iimg::IBitmap::PF_GRAY) << 0;
+	QTest::newRow("Gray16") << int(iimg::IBitmap::PF_GRAY16) << 0;
+	QTest::newRow("Gray32") << int(iimg::IBitmap::PF_GRAY32) << 0;
+	QTest::newRow("Float32") << int(iimg::IBitmap::PF_FLOAT32) << 0;
+	QTest::newRow("Float64") << int(iimg::IBitmap::PF_FLOAT64) << 0;
+	QTest::newRow("RGB") << int(iimg::IBitmap::PF_RGB) << 1;
+	QTest::newRow("RGBA") << int(iimg::IBitmap::PF_RGBA) << 3;
+	QTest::newRow("RGB24") << int(iimg::IBitmap::PF_RGB24) << 2;
+	QTest::newRow("RGB48") << int(iimg::IBitmap::PF_RGB48) << 0;
+	QTest::newRow("RGBA64") << int(iimg::IBitmap::PF_RGBA64) << 3;
+}
+
+
+void CMaskedRegionStatisticsTest::CalcStatisticsTest()
+{
+	QFETCH(int, format);
+	QFETCH(int, componentIndex);
+
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(PixelFormat(format), istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	FillBitmap(bitmap);
+
+	iimg::CScanlineMask mask;
+	CreateTestMask(mask);
+
+	iimg::CMaskedRegionStatistics::Statistics statistics;
+	QVERIFY(iimg::CMaskedRegionStatistics::CalcStatistics(bitmap, mask, componentIndex, statistics));
+
+	qint64 pixelsCount = 0;
+	double sum = 0;
+	double minValue = std::numeric_limits<double>::max();
+	double maxValue = -std::numeric_limits<double>::max();
+
+	for (int y = 0; y < s_bitmapHeight; ++y){
+		for (int x = 0; x < s_bitmapWidth; ++x){
+			const double value = GetRawValue(PixelFormat(format), x, y, componentIndex);
+			if (IsPixelInside(mask, x, y) && !qIsNaN(value)){
+				++pixelsCount;
+				sum += value;
+				minValue = qMin(minValue, value);
+				maxValue = qMax(maxValue, value);
+			}
+		}
+	}
+
+	const double mean = sum / pixelsCount;
+
+	double squaredDeviationsSum = 0;
+	for (int y = 0; y < s_bitmapHeight; ++y){
+		for (int x = 0; x < s_bitmapWidth; ++x){
+			const double value = GetRawValue(PixelFormat(format), x, y, componentIndex);
+			if (IsPixelInside(mask, x, y) && !qIsNaN(value)){
+				squaredDeviationsSum += (value - mean) * (value - mean);
+			}
+		}
+	}
+
+	const double variance = squaredDeviationsSum / pixelsCount;
+
+	QCOMPARE(statistics.pixelsCount, pixelsCount);
+	QCOMPARE(statistics.minValue, minValue);
+	QCOMPARE(statistics.maxValue, maxValue);
+	QVERIFY(qAbs(statistics.mean - mean) <= 1e-9 * qAbs(mean));
+	QVERIFY(qAbs(statistics.variance - variance) <= 1e-9 * variance);
+	QVERIFY(qAbs(statistics.GetStandardDeviation() - std::sqrt(variance)) <= 1e-9 * std::sqrt(variance));
+
+	// unsupported component
+	QVERIFY(!iimg::CMaskedRegionStatistics::CalcStatistics(bitmap, mask, 4, statistics));
+}
+
+
+void CMaskedRegionStatisticsTest::CalcHistogramTest()
+{
+	iimg::CScanlineMask mask;
+	CreateTestMask(mask);
+
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	FillBitmap(bitmap);
+
+	iimg::CMaskedRegionStatistics::Histogram histogram;
+	QVERIFY(iimg::CMaskedRegionStatistics::CalcHistogram(bitmap, mask, 0, histogram));
+	QCOMPARE(int(histogram.size()), 256);
+
+	iimg::CGeneralBitmap bitmap16;
+	QVERIFY(bitmap16.CreateBitmap(iimg::IBitmap::PF_RGB48, istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	FillBitmap(bitmap16);
+
+	iimg::CMaskedRegionStatistics::Histogram histogram16;
+	QVERIFY(iimg::CMaskedRegionStatistics::CalcHistogram(bitmap16, mask, 2, histogram16));
+	QCOMPARE(int(histogram16.size()), 65536);
+
+	iimg::CMaskedRegionStatistics::Histogram expectedHistogram(256, 0);
+	iimg::CMaskedRegionStatistics::Histogram expectedHistogram16(65536, 0);
+
+	for (int y = 0; y < s_bitmapHeight; ++y){
+		for (int x = 0; x < s_bitmapWidth; ++x){
+			if (IsPixelInside(mask, x, y)){
+				++expectedHistogram[int(GetRawValue(iimg::IBitmap::PF_GRAY, x, y, 0))];
+				++expectedHistogram16[int(GetRawValue(iimg::IBitmap::PF_RGB48, x, y, 2))];
+			}
+		}
+	}
+
+	QVERIFY(histogram == expectedHistogram);
+	QVERIFY(histogram16 == expectedHistogram16);
+
+	// histogram is not supported for 32-bit and floating point values
+	iimg::CGeneralBitmap floatBitmap;
+	QVERIFY(floatBitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	QVERIFY(!iimg::CMaskedRegionStatistics::CalcHistogram(floatBitmap, mask, 0, histogram));
+}
+
+
+void CMaskedRegionStatisticsTest::CalcMomentsTest()
+{
+	iimg::CScanlineMask mask;
+	mask.CreateFilled(i2d::CRect(2, 3, 12, 8));
+
+	iimg::CMaskedRegionStatistics::Moments moments;
+	iimg::CMaskedRegionStatistics::CalcMoments(mask, moments);
+
+	QCOMPARE(moments.m00, 50.0);
+	QVERIFY(moments.GetCentroid() == i2d::CVector2d(7, 5.5));
+
+	// central moments of a rectangle of n x m pixels are n * m * (n^2 - 1) / 12 and n * m * (m^2 - 1) / 12
+	QVERIFY(qAbs(moments.GetCentralMoment20() - 50.0 * 99 / 12) < 1e-9);
+	QVERIFY(qAbs(moments.GetCentralMoment02() - 50.0 * 24 / 12) < 1e-9);
+	QVERIFY(qAbs(moments.GetCentralMoment11()) < 1e-9);
+
+	// irregular mask against pixel sums
+	CreateTestMask(mask);
+	iimg::CMaskedRegionStatistics::CalcMoments(mask, moments);
+
+	iimg::CMaskedRegionStatistics::Moments expectedMoments;
+	const i2d::CRect boundingRect = mask.GetBoundingRect();
+	for (int y = boundingRect.GetTop(); y < boundingRect.GetBottom(); ++y){
+		for (int x = boundingRect.GetLeft(); x < boundingRect.GetRight(); ++x){
+			if (IsPixelInside(mask, x, y)){
+				expectedMoments.m00 += 1;
+				expectedMoments.m10 += x + 0.5;
+				expectedMoments.m01 += y + 0.5;
+				expectedMoments.m20 += (x + 0.5) * (x + 0.5);
+				expectedMoments.m11 += (x + 0.5) * (y + 0.5);
+				expectedMoments.m02 += (y + 0.5) * (y + 0.5);
+			}
+		}
+	}
+
+	QCOMPARE(moments.m00, expectedMoments.m00);
+	QVERIFY(qAbs(moments.m10 - expectedMoments.m10) < 1e-6);
+	QVERIFY(qAbs(moments.m01 - expectedMoments.m01) < 1e-6);
+	QVERIFY(qAbs(moments.m20 - expectedMoments.m20) < 1e-6);
+	QVERIFY(qAbs(moments.m11 - expectedMoments.m11) < 1e-6);
+	QVERIFY(qAbs(moments.m02 - expectedMoments.m02) < 1e-6);
+}
+
+
+void CMaskedRegionStatisticsTest::CalcWeightedMomentsTest()
+{
+	iimg::CScanlineMask mask;
+	CreateTestMask(mask);
+
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	FillBitmap(bitmap);
+
+	iimg::CMaskedRegionStatistics::Moments moments;
+	QVERIFY(iimg::CMaskedRegionStatistics::CalcWeightedMoments(bitmap, mask, 0, moments));
+
+	iimg::CMaskedRegionStatistics::Moments expectedMoments;
+	for (int y = 0; y < s_bitmapHeight; ++y){
+		for (int x = 0; x < s_bitmapWidth; ++x){
+			const double value = GetRawValue(iimg::IBitmap::PF_FLOAT32, x, y, 0);
+			if (IsPixelInside(mask, x, y) && !qIsNaN(value)){
+				expectedMoments.m00 += value;
+				expectedMoments.m10 += value * (x + 0.5);
+				expectedMoments.m01 += value * (y + 0.5);
+				expectedMoments.m20 += value * (x + 0.5) * (x + 0.5);
+				expectedMoments.m11 += value * (x + 0.5) * (y + 0.5);
+				expectedMoments.m02 += value * (y + 0.5) * (y + 0.5);
+			}
+		}
+	}
+
+	QVERIFY(qAbs(moments.m00 - expectedMoments.m00) <= 1e-9 * expectedMoments.m00);
+	QVERIFY(qAbs(moments.m10 - expectedMoments.m10) <= 1e-9 * expectedMoments.m10);
+	QVERIFY(qAbs(moments.m01 - expectedMoments.m01) <= 1e-9 * expectedMoments.m01);
+	QVERIFY(qAbs(moments.m20 - expectedMoments.m20) <= 1e-9 * expectedMoments.m20);
+	QVERIFY(qAbs(moments.m11 - expectedMoments.m11) <= 1e-9 * expectedMoments.m11);
+	QVERIFY(qAbs(moments.m02 - expectedMoments.m02) <= 1e-9 * expectedMoments.m02);
+}
+
+
+void CMaskedRegionStatisticsTest::ProcessRunsTest()
+{
+	iimg::CScanlineMask mask;
+	CreateTestMask(mask);
+
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(s_bitmapWidth, s_bitmapHeight)));
+	FillBitmap(bitmap);
+
+	// runs are clipped to the bitmap and point to the bitmap memory
+	qint64 pixelsCount = 0;
+	bool arePointersValid = true;
+
+	iimg::TMaskedRegionProcessor<quint8>::ProcessRuns(bitmap, mask, [&](const quint8* pixelsPtr, int x, int y, int runPixelsCount){
+		arePointersValid = arePointersValid &&
+					(x >= 0) && (x + runPixelsCount <= s_bitmapWidth) &&
+					(y >= 0) && (y < s_bitmapHeight) &&
+					(pixelsPtr == static_cast<const quint8*>(bitmap.GetLinePtr(y)) + x);
+
+		pixelsCount += runPixelsCount;
+	});
+
+	qint64 expectedPixelsCount = 0;
+	for (int y = 0; y < s_bitmapHeight; ++y){
+		for (int x = 0; x < s_bitmapWidth; ++x){
+			if (IsPixelInside(mask, x, y)){
+				++expectedPixelsCount;
+			}
+		}
+	}
+
+	QVERIFY(arePointersValid);
+	QCOMPARE(pixelsCount, expectedPixelsCount);
+}
+
+
+void CMaskedRegionStatisticsTest::StatisticsBenchmark()
+{
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(s_benchmarkImageSize, s_benchmarkImageSize)));
+	FillBitmap(bitmap);
+
+	iimg::CScanlineMask mask;
+	mask.CreateFromCircle(i2d::CCircle(s_benchmarkImageSize * 0.45, i2d::CVector2d(s_benchmarkImageSize * 0.5, s_benchmarkImageSize * 0.5)));
+
+	bool retVal = true;
+
+	QBENCHMARK{
+		iimg::CMaskedRegionStatistics::Statistics statistics;
+		retVal = retVal && iimg::CMaskedRegionStatistics::CalcStatistics(bitmap, mask, 0, statistics);
+	}
+
+	QVERIFY(retVal);
+}
+
+
+I_ADD_TEST(CMaskedRegionStatisticsTest);
+
+
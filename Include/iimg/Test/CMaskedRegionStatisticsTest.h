@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <iimg/CMaskedRegionStatistics.h>
+#include <itest/CStandardTestExecutor.h>
+
+class CMaskedRegionStatisticsTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void IsComponentSupportedTest();
+	void CalcStatisticsTest_data();
+	void CalcStatisticsTest();
+	void CalcHistogramTest();
+	void CalcMomentsTest();
+	void CalcWeightedMomentsTest();
+	void ProcessRunsTest();
+	void StatisticsBenchmark();
+};
+
+
@@ -0,0 +1,583 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CPixelFormatConverterTest.h"
+
+
+// STL includes
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// ACF includes
+#include <iimg/CBitmap.h>
+#include <iimg/CGeneralBitmap.h>
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+typedef iimg::IBitmap::PixelFormat PixelFormat;
+
+
+static const PixelFormat s_convertedFormats[] = {
+			iimg::IBitmap::PF_GRAY,
+			iimg::IBitmap::PF_GRAY16,
+			iimg::IBitmap::PF_GRAY32,
+			iimg::IBitmap::PF_FLOAT32,
+			iimg::IBitmap::PF_FLOAT64,
+			iimg::IBitmap::PF_RGB,
+			iimg::IBitmap::PF_RGBA,
+			iimg::IBitmap::PF_RGB24,
+			iimg::IBitmap::PF_RGB48,
+			iimg::IBitmap::PF_RGBA64};
+
+static const int s_convertedFormatsCount = int(sizeof(s_convertedFormats) / sizeof(s_convertedFormats[0]));
+
+static const int s_benchmarkImageSize = 2048;
+
+
+QString GetFormatName(PixelFormat format)
+{
+	switch (format){
+	case iimg::IBitmap::PF_GRAY:
+		return "Gray";
+
+	case iimg::IBitmap::PF_GRAY16:
+		return "Gray16";
+
+	case iimg::IBitmap::PF_GRAY32:
+		return "Gray32";
+
+	case iimg::IBitmap::PF_FLOAT32:
+		return "Float32";
+
+	case iimg::IBitmap::PF_FLOAT64:
+		return "Float64";
+
+	case iimg::IBitmap::PF_RGB:
+		return "RGB";
+
+	case iimg::IBitmap::PF_RGBA:
+		return "RGBA";
+
+	case iimg::IBitmap::PF_RGB24:
+		return "RGB24";
+
+	case iimg::IBitmap::PF_RGB48:
+		return "RGB48";
+
+	case iimg::IBitmap::PF_RGBA64:
+		return "RGBA64";
+
+	default:
+		return "Unknown";
+	}
+}
+
+
+int GetPixelBytesCount(PixelFormat format)
+{
+	switch (format){
+	case iimg::IBitmap::PF_GRAY:
+		return 1;
+
+	case iimg::IBitmap::PF_GRAY16:
+		return 2;
+
+	case iimg::IBitmap::PF_RGB24:
+		return 3;
+
+	case iimg::IBitmap::PF_RGB48:
+		return 6;
+
+	case iimg::IBitmap::PF_FLOAT64:
+	case iimg::IBitmap::PF_RGBA64:
+		return 8;
+
+	default:
+		return 4;
+	}
+}
+
+
+bool IsGrayFormat(PixelFormat format)
+{
+	return (format == iimg::IBitmap::PF_GRAY) ||
+				(format == iimg::IBitmap::PF_GRAY16) ||
+				(format == iimg::IBitmap::PF_GRAY32) ||
+				(format == iimg::IBitmap::PF_FLOAT32) ||
+				(format == iimg::IBitmap::PF_FLOAT64);
+}
+
+
+bool IsFloatFormat(PixelFormat format)
+{
+	return (format == iimg::IBitmap::PF_FLOAT32) || (format == iimg::IBitmap::PF_FLOAT64);
+}
+
+
+bool Is8BitFormat(PixelFormat format)
+{
+	return (format == iimg::IBitmap::PF_GRAY) ||
+				(format == iimg::IBitmap::PF_RGB) ||
+				(format == iimg::IBitmap::PF_RGBA) ||
+				(format == iimg::IBitmap::PF_RGB24);
+}
+
+
+template <typename ValueType>
+ValueType ReadValue(const char* dataPtr, int index = 0)
+{
+	ValueType value;
+	std::memcpy(&value, dataPtr + index * int(sizeof(ValueType)), sizeof(ValueType));
+
+	return value;
+}
+
+
+/**
+	Reference decoding of a pixel to normalized red, green, blue and alpha values.
+*/
+void DecodePixel(PixelFormat format, const char* pixelPtr, double* rgbaPtr)
+{
+	const quint8* bytesPtr = reinterpret_cast<const quint8*>(pixelPtr);
+
+	rgbaPtr[3] = 1;
+
+	switch (format){
+	case iimg::IBitmap::PF_GRAY:
+		rgbaPtr[0] = rgbaPtr[1] = rgbaPtr[2] = bytesPtr[0] / 255.0;
+		break;
+
+	case iimg::IBitmap::PF_GRAY16:
+		rgbaPtr[0] = rgbaPtr[1] = rgbaPtr[2] = ReadValue<quint16>(pixelPtr) / 65535.0;
+		break;
+
+	case iimg::IBitmap::PF_GRAY32:
+		rgbaPtr[0] = rgbaPtr[1] = rgbaPtr[2] = ReadValue<quint32>(pixelPtr) / 4294967295.0;
+		break;
+
+	case iimg::IBitmap::PF_FLOAT32:
+		rgbaPtr[0] = rgbaPtr[1] = rgbaPtr[2] = ReadValue<float>(pixelPtr);
+		break;
+
+	case iimg::IBitmap::PF_FLOAT64:
+		rgbaPtr[0] = rgbaPtr[1] = rgbaPtr[2] = ReadValue<double>(pixelPtr);
+		break;
+
+	case iimg::IBitmap::PF_RGB:
+	case iimg::IBitmap::PF_RGBA:
+		rgbaPtr[0] = bytesPtr[2] / 255.0;
+		rgbaPtr[1] = bytesPtr[1] / 255.0;
+		rgbaPtr[2] = bytesPtr[0] / 255.0;
+		if (format == iimg::IBitmap::PF_RGBA){
+			rgbaPtr[3] = bytesPtr[3] / 255.0;
+		}
+		break;
+
+	case iimg::IBitmap::PF_RGB24:
+		rgbaPtr[0] = bytesPtr[0] / 255.0;
+		rgbaPtr[1] = bytesPtr[1] / 255.0;
+		rgbaPtr[2] = bytesPtr[2] / 255.0;
+		break;
+
+	case iimg::IBitmap::PF_RGB48:
+	case iimg::IBitmap::PF_RGBA64:
+		for (int i = 0; i < 3; ++i){
+			rgbaPtr[i] = ReadValue<quint16>(pixelPtr, i) / 65535.0;
+		}
+		if (format == iimg::IBitmap::PF_RGBA64){
+			rgbaPtr[3] = ReadValue<quint16>(pixelPtr, 3) / 65535.0;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+
+QByteArray CreateRandomLine(PixelFormat format, int pixelsCount, quint32 seed)
+{
+	itest::CRandomDataGenerator generator(seed);
+
+	QByteArray retVal = generator.CreateData(pixelsCount * GetPixelBytesCount(format));
+
+	// floating point values are in range [0, 1] with some special values
+	for (int x = 0; x < pixelsCount; ++x){
+		double value = (generator.GetNextValue() >> 16) / 65535.0;
+
+		if (x % 13 == 5){
+			value = std::numeric_limits<double>::quiet_NaN();
+		}
+		else if (x % 17 == 3){
+			value = 1.5;
+		}
+		else if (x % 19 == 2){
+			value = -0.25;
+		}
+
+		if (format == iimg::IBitmap::PF_FLOAT32){
+			float floatValue = float(value);
+			std::memcpy(retVal.data() + x * sizeof(float), &floatValue, sizeof(float));
+		}
+		else if (format == iimg::IBitmap::PF_FLOAT64){
+			std::memcpy(retVal.data() + x * sizeof(double), &value, sizeof(double));
+		}
+	}
+
+	return retVal;
+}
+
+
+void FillBitmap(iimg::IBitmap& bitmap)
+{
+	const PixelFormat format = bitmap.GetPixelFormat();
+	const istd::CIndex2d size = bitmap.GetImageSize();
+
+	for (int y = 0; y < size.GetY(); ++y){
+		QByteArray line = CreateRandomLine(format, size.GetX(), quint32(y));
+
+		std::memcpy(bitmap.GetLinePtr(y), line.constData(), line.size());
+	}
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CPixelFormatConverterTest::IsConversionSupportedTest()
+{
+	for (int sourceIndex = 0; sourceIndex < s_convertedFormatsCount; ++sourceIndex){
+		for (int destIndex = 0; destIndex < s_convertedFormatsCount; ++destIndex){
+			QVERIFY(iimg::CPixelFormatConverter::IsConversionSupported(s_convertedFormats[sourceIndex], s_convertedFormats[destIndex]));
+		}
+	}
+
+	// other formats can be only copied
+	QVERIFY(iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_MONO, iimg::IBitmap::PF_MONO));
+	QVERIFY(iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_XYZ32, iimg::IBitmap::PF_XYZ32));
+	QVERIFY(!iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_MONO, iimg::IBitmap::PF_GRAY));
+	QVERIFY(!iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_GRAY, iimg::IBitmap::PF_CMYK));
+	QVERIFY(!iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_UNKNOWN, iimg::IBitmap::PF_UNKNOWN));
+	QVERIFY(!iimg::CPixelFormatConverter::IsConversionSupported(iimg::IBitmap::PF_USER, iimg::IBitmap::PF_GRAY));
+}
+
+
+void CPixelFormatConverterTest::ConversionMatrixTest_data()
+{
+	QTest::addColumn<int>("sourceFormat");
+	QTest::addColumn<int>("destFormat");
+
+	for (int sourceIndex = 0; sourceIndex < s_convertedFormatsCount; ++sourceIndex){
+		for (int destIndex = 0; destIndex < s_convertedFormatsCount; ++destIndex){
+			PixelFormat sourceFormat = s_convertedFormats[sourceIndex];
+			PixelFormat destFormat = s_convertedFormats[destIndex];
+
+			QTest::newRow(qPrintable(GetFormatName(sourceFormat) + " to " + GetFormatName(destFormat))) << int(sourceFormat) << int(destFormat);
+		}
+	}
+}
+
+
+void CPixelFormatConverterTest::ConversionMatrixTest()
+{
+	QFETCH(int, sourceFormat);
+	QFETCH(int, destFormat);
+
+	const PixelFormat source = PixelFormat(sourceFormat);
+	const PixelFormat dest = PixelFormat(destFormat);
+
+	const int sourcePixelBytes = GetPixelBytesCount(source);
+	const int destPixelBytes = GetPixelBytesCount(dest);
+
+	// integer destination formats are clamped, floating point values are only converted
+	const bool isFloatCopy = IsFloatFormat(source) && IsFloatFormat(dest);
+
+	double tolerance = (Is8BitFormat(source) || Is8BitFormat(dest))? 1.01 / 255: 2.5 / 65535;
+	if (IsGrayFormat(dest) && !IsGrayFormat(source)){
+		// rounding of gray weights
+		tolerance += 0.002;
+	}
+
+	const int componentsCount = ((dest == iimg::IBitmap::PF_RGBA) || (dest == iimg::IBitmap::PF_RGBA64))? 4: 3;
+
+	// different widths test the tails of vectorized kernels
+	static const int widths[] = {1, 3, 15, 16, 17, 31, 33, 35, 64, 65, 1000};
+
+	for (int width : widths){
+		QByteArray sourceLine = CreateRandomLine(source, width, quint32(width));
+
+		// guard bytes after the line must not be overwritten
+		QByteArray destLine(width * destPixelBytes + 64, char(0xcd));
+
+		QVERIFY(iimg::CPixelFormatConverter::ConvertLine(source, dest, sourceLine.constData(), destLine.data(), width));
+
+		for (int i = width * destPixelBytes; i < destLine.size(); ++i){
+			QCOMPARE(destLine.at(i), char(0xcd));
+		}
+
+		for (int x = 0; x < width; ++x){
+			double expected[4];
+			DecodePixel(source, sourceLine.constData() + x * sourcePixelBytes, expected);
+
+			if (!isFloatCopy){
+				for (int i = 0; i < 4; ++i){
+					expected[i] = std::isnan(expected[i])? 0.0: qBound(0.0, expected[i], 1.0);
+				}
+			}
+
+			if (IsGrayFormat(dest)){
+				expected[0] = expected[1] = expected[2] = 0.299 * expected[0] + 0.587 * expected[1] + 0.114 * expected[2];
+			}
+
+			double result[4];
+			DecodePixel(dest, destLine.constData() + x * destPixelBytes, result);
+
+			// hidden alpha channel is opaque, only copy of the same format keeps it
+			if ((dest == iimg::IBitmap::PF_RGB) && (source != iimg::IBitmap::PF_RGB)){
+				QCOMPARE(quint8(destLine.at(x * destPixelBytes + 3)), quint8(255));
+			}
+
+			for (int i = 0; i < componentsCount; ++i){
+				if (isFloatCopy && std::isnan(expected[i])){
+					QVERIFY(std::isnan(result[i]));
+				}
+				else if (!(std::fabs(result[i] - expected[i]) <= tolerance)){
+					QFAIL(qPrintable(QString("Wrong value %1 instead of %2 at pixel %3 of %4").arg(result[i]).arg(expected[i]).arg(x).arg(width)));
+				}
+			}
+		}
+	}
+}
+
+
+void CPixelFormatConverterTest::ValueMappingTest()
+{
+	float values[40];
+	for (int i = 0; i < 40; ++i){
+		values[i] = 10.0f + i * 0.5f;
+	}
+
+	quint8 grayValues[40];
+	iimg::CPixelFormatConverter::ValueMapping mapping = iimg::CPixelFormatConverter::ValueMapping::FromRange(10.0, 29.5);
+	QVERIFY(iimg::CPixelFormatConverter::ConvertLine(iimg::IBitmap::PF_FLOAT32, iimg::IBitmap::PF_GRAY, values, grayValues, 40, mapping));
+
+	QCOMPARE(grayValues[0], quint8(0));
+	QCOMPARE(grayValues[39], quint8(255));
+	for (int i = 1; i < 40; ++i){
+		QVERIFY(grayValues[i] >= grayValues[i - 1]);
+	}
+
+	// the same mapping for double values
+	double doubleValues[40];
+	for (int i = 0; i < 40; ++i){
+		doubleValues[i] = values[i];
+	}
+
+	quint8 doubleGrayValues[40];
+	QVERIFY(iimg::CPixelFormatConverter::ConvertLine(iimg::IBitmap::PF_FLOAT64, iimg::IBitmap::PF_GRAY, doubleValues, doubleGrayValues, 40, mapping));
+	for (int i = 0; i < 40; ++i){
+		QVERIFY(qAbs(int(doubleGrayValues[i]) - int(grayValues[i])) <= 1);
+	}
+
+	// mapping of the same format
+	float mappedValues[40];
+	QVERIFY(iimg::CPixelFormatConverter::ConvertLine(iimg::IBitmap::PF_FLOAT32, iimg::IBitmap::PF_FLOAT32, values, mappedValues, 40, mapping));
+	QCOMPARE(mappedValues[0], 0.0f);
+	QCOMPARE(mappedValues[39], 1.0f);
+
+	// empty range gives zero values
+	mapping = iimg::CPixelFormatConverter::ValueMapping::FromRange(1.0, 1.0);
+	QVERIFY(iimg::CPixelFormatConverter::ConvertLine(iimg::IBitmap::PF_FLOAT32, iimg::IBitmap::PF_GRAY, values, grayValues, 40, mapping));
+	for (int i = 0; i < 40; ++i){
+		QCOMPARE(grayValues[i], quint8(0));
+	}
+}
+
+
+void CPixelFormatConverterTest::CalcValueRangeTest()
+{
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(301, 257)));
+
+	for (int y = 0; y < 257; ++y){
+		float* linePtr = static_cast<float*>(bitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 301; ++x){
+			linePtr[x] = 2.0f + float((x * y) % 1000) * 0.01f;
+		}
+	}
+
+	static_cast<float*>(bitmap.GetLinePtr(7))[5] = std::numeric_limits<float>::quiet_NaN();
+	static_cast<float*>(bitmap.GetLinePtr(200))[300] = -3.0f;
+
+	double minValue = 0;
+	double maxValue = 0;
+	QVERIFY(iimg::CPixelFormatConverter::CalcValueRange(bitmap, minValue, maxValue));
+	QCOMPARE(minValue, -3.0);
+	QVERIFY(qAbs(maxValue - 11.99) < 1e-5);
+
+	// normalized values of integer formats
+	iimg::CGeneralBitmap grayBitmap;
+	QVERIFY(grayBitmap.CreateBitmap(iimg::IBitmap::PF_GRAY16, istd::CIndex2d(10, 10)));
+	for (int y = 0; y < 10; ++y){
+		quint16* linePtr = static_cast<quint16*>(grayBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 10; ++x){
+			linePtr[x] = quint16(1000 + x * y * 100);
+		}
+	}
+
+	QVERIFY(iimg::CPixelFormatConverter::CalcValueRange(grayBitmap, minValue, maxValue));
+	QCOMPARE(minValue, 1000 / 65535.0);
+	QCOMPARE(maxValue, 9100 / 65535.0);
+
+	// color formats are not supported
+	iimg::CGeneralBitmap colorBitmap;
+	QVERIFY(colorBitmap.CreateBitmap(iimg::IBitmap::PF_RGB, istd::CIndex2d(10, 10)));
+	QVERIFY(!iimg::CPixelFormatConverter::CalcValueRange(colorBitmap, minValue, maxValue));
+}
+
+
+void CPixelFormatConverterTest::ConvertBitmapTest()
+{
+	// the bitmap is large enough to be converted in parallel bands
+	iimg::CGeneralBitmap sourceBitmap;
+	QVERIFY(sourceBitmap.CreateBitmap(iimg::IBitmap::PF_RGB, istd::CIndex2d(1001, 703)));
+	FillBitmap(sourceBitmap);
+
+	iimg::CGeneralBitmap destBitmap;
+	QVERIFY(iimg::CPixelFormatConverter::ConvertBitmap(sourceBitmap, iimg::IBitmap::PF_GRAY, destBitmap));
+	QCOMPARE(destBitmap.GetPixelFormat(), iimg::IBitmap::PF_GRAY);
+	QCOMPARE(destBitmap.GetImageSize().GetX(), 1001);
+	QCOMPARE(destBitmap.GetImageSize().GetY(), 703);
+
+	QByteArray lineBuffer(1001, '\0');
+	for (int y = 0; y < 703; ++y){
+		QVERIFY(iimg::CPixelFormatConverter::ConvertLine(iimg::IBitmap::PF_RGB, iimg::IBitmap::PF_GRAY, sourceBitmap.GetLinePtr(y), lineBuffer.data(), 1001));
+		QVERIFY(std::memcmp(destBitmap.GetLinePtr(y), lineBuffer.constData(), 1001) == 0);
+	}
+
+	// conversion to Qt bitmap uses its line alignment
+	iimg::CBitmap qtBitmap;
+	QVERIFY(iimg::CPixelFormatConverter::ConvertBitmap(destBitmap, iimg::IBitmap::PF_GRAY, qtBitmap));
+	for (int y = 0; y < 703; ++y){
+		QVERIFY(std::memcmp(qtBitmap.GetLinePtr(y), destBitmap.GetLinePtr(y), 1001) == 0);
+	}
+
+	// unsupported conversion
+	iimg::CGeneralBitmap cmykBitmap;
+	QVERIFY(!iimg::CPixelFormatConverter::ConvertBitmap(sourceBitmap, iimg::IBitmap::PF_CMYK, cmykBitmap));
+}
+
+
+void CPixelFormatConverterTest::ConvertUsingColorTableTest()
+{
+	iimg::CGeneralBitmap grayBitmap;
+	QVERIFY(grayBitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(256, 3)));
+	for (int y = 0; y < 3; ++y){
+		quint8* linePtr = static_cast<quint8*>(grayBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 256; ++x){
+			linePtr[x] = quint8(x);
+		}
+	}
+
+	quint32 colorTable[256];
+	for (int i = 0; i < 256; ++i){
+		colorTable[i] = quint32(255 - i) << 16 | quint32(i);
+	}
+
+	iimg::CBitmap colorBitmap;
+	QVERIFY(iimg::CPixelFormatConverter::ConvertUsingColorTable(grayBitmap, colorTable, iimg::IBitmap::PF_RGB, colorBitmap));
+	QCOMPARE(colorBitmap.GetPixelFormat(), iimg::IBitmap::PF_RGB);
+
+	const QImage& image = colorBitmap.GetQImage();
+	QCOMPARE(image.pixel(0, 0), qRgb(255, 0, 0));
+	QCOMPARE(image.pixel(255, 2), qRgb(0, 0, 255));
+	QCOMPARE(image.pixel(100, 1), qRgb(155, 0, 100));
+
+	// only gray bitmaps are supported
+	QVERIFY(!iimg::CPixelFormatConverter::ConvertUsingColorTable(colorBitmap, colorTable, iimg::IBitmap::PF_RGB, grayBitmap));
+}
+
+
+void CPixelFormatConverterTest::CopyFromConversionTest()
+{
+	iimg::CGeneralBitmap floatBitmap;
+	QVERIFY(floatBitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(100, 50)));
+	for (int y = 0; y < 50; ++y){
+		float* linePtr = static_cast<float*>(floatBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 100; ++x){
+			linePtr[x] = -5.0f + x * 0.1f;
+		}
+	}
+	static_cast<float*>(floatBitmap.GetLinePtr(10))[10] = std::numeric_limits<float>::quiet_NaN();
+
+	// values are stretched to the whole gray range
+	iimg::CBitmap bitmap;
+	QVERIFY(bitmap.CopyFrom(floatBitmap, istd::IChangeable::CM_CONVERT));
+	QCOMPARE(bitmap.GetPixelFormat(), iimg::IBitmap::PF_GRAY);
+	QCOMPARE(bitmap.GetImageSize().GetX(), 100);
+	QCOMPARE(bitmap.GetImageSize().GetY(), 50);
+
+	const quint8* linePtr = static_cast<const quint8*>(bitmap.GetLinePtr(20));
+	QCOMPARE(linePtr[0], quint8(0));
+	QCOMPARE(linePtr[99], quint8(255));
+	QCOMPARE(static_cast<const quint8*>(bitmap.GetLinePtr(10))[10], quint8(0));
+
+	// 64-bit color is converted to 32-bit color
+	iimg::CGeneralBitmap colorBitmap;
+	QVERIFY(colorBitmap.CreateBitmap(iimg::IBitmap::PF_RGBA64, istd::CIndex2d(20, 10)));
+	for (int y = 0; y < 10; ++y){
+		quint16* colorLinePtr = static_cast<quint16*>(colorBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 20; ++x){
+			colorLinePtr[x * 4] = 65535;
+			colorLinePtr[x * 4 + 1] = 257 * 128;
+			colorLinePtr[x * 4 + 2] = 0;
+			colorLinePtr[x * 4 + 3] = 65535;
+		}
+	}
+
+	QVERIFY(bitmap.CopyFrom(colorBitmap, istd::IChangeable::CM_CONVERT));
+	QCOMPARE(bitmap.GetPixelFormat(), iimg::IBitmap::PF_RGBA);
+	QCOMPARE(bitmap.GetQImage().pixel(5, 5), qRgba(255, 128, 0, 255));
+}
+
+
+void CPixelFormatConverterTest::ConversionBenchmark_data()
+{
+	ConversionMatrixTest_data();
+}
+
+
+void CPixelFormatConverterTest::ConversionBenchmark()
+{
+	QFETCH(int, sourceFormat);
+	QFETCH(int, destFormat);
+
+	iimg::CGeneralBitmap sourceBitmap;
+	QVERIFY(sourceBitmap.CreateBitmap(PixelFormat(sourceFormat), istd::CIndex2d(s_benchmarkImageSize, s_benchmarkImageSize)));
+	FillBitmap(sourceBitmap);
+
+	iimg::CGeneralBitmap destBitmap;
+
+	bool retVal = true;
+
+	QBENCHMARK{
+		retVal = retVal && iimg::CPixelFormatConverter::ConvertBitmap(sourceBitmap, PixelFormat(destFormat), destBitmap);
+	}
+
+	QVERIFY(retVal);
+}
+
+
+I_ADD_TEST(CPixelFormatConverterTest);
+
+
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <iimg/CPixelFormatConverter.h>
+#include <itest/CStandardTestExecutor.h>
+
+class CPixelFormatConverterTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void IsConversionSupportedTest();
+	void ConversionMatrixTest_data();
+	void ConversionMatrixTest();
+	void ValueMappingTest();
+	void CalcValueRangeTest();
+	void ConvertBitmapTest();
+	void ConvertUsingColorTableTest();
+	void CopyFromConversionTest();
+	void ConversionBenchmark_data();
+	void ConversionBenchmark();
+};
+
+
@@ -2,8 +2,163 @@
 #include "CScanlineMaskTest.h"
 
 
+// STL includes
+#include <limits>
+
+// Qt includes
+#include <QtCore/QtMath>
+
 // ACF includes
 #include <i2d/CPosition2d.h>
+#include <i2d/CAnnulus.h>
+#include <iimg/CGeneralBitmap.h>
+#include <iser/CMemoryReadArchive.h>
+#include <iser/CMemoryWriteArchive.h>
+#include <iser/CPrimitiveTypesSerializer.h>
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+static const int s_benchmarkRegionSize = 4000;
+
+
+bool IsPixelInside(const iimg::CScanlineMask& mask, int x, int y)
+{
+	return mask.GetColorAt(istd::CIndex2d(x, y)).GetElement(0) > 0;
+}
+
+
+/**
+	Create mask from random bitmap, some lines are left empty.
+*/
+void CreateRandomMask(iimg::CScanlineMask& mask, quint32 seed, int offsetX, int offsetY)
+{
+	iimg::CGeneralBitmap bitmap;
+	bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(60, 50));
+
+	itest::CRandomDataGenerator generator(seed);
+
+	for (int y = 0; y < 50; ++y){
+		quint8* linePtr = static_cast<quint8*>(bitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 60; ++x){
+			linePtr[x] = ((y % 7) != 3) && (generator.GetNextByte() < 160)? 255: 0;
+		}
+	}
+
+	mask.CreateFromBitmap(bitmap);
+	mask.Translate(offsetX, offsetY);
+}
+
+
+/**
+	Check if the switch points of each line are strictly increasing.
+*/
+bool AreSwitchPointsSorted(const iimg::CScanlineMask& mask)
+{
+	const istd::CIntRange linesRange = mask.GetScanlinesRange();
+	for (int lineIndex = linesRange.GetMinValue(); lineIndex < linesRange.GetMaxValue(); ++lineIndex){
+		int pointsCount = 0;
+		const int* pointsPtr = mask.GetLineSwitchPoints(lineIndex, pointsCount);
+		if ((pointsPtr == NULL) && (pointsCount > 0)){
+			return false;
+		}
+
+		if ((pointsCount % 2) != 0){
+			return false;
+		}
+
+		for (int pointIndex = 1; pointIndex < pointsCount; ++pointIndex){
+			if (pointsPtr[pointIndex - 1] >= pointsPtr[pointIndex]){
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+/**
+	Write mask archive in the format of older versions, each line is stored as separated range list.
+	\param	containerIndices	index of the range list for each line or -1 for empty lines.
+*/
+bool WriteLegacyMaskArchive(
+			iser::IArchive& archive,
+			int firstLinePos,
+			QList<istd::CIntRanges> rangesContainer,
+			QList<int> containerIndices)
+{
+	static iser::CArchiveTag firstLineTag("FirstLine", "First line (top position)", iser::CArchiveTag::TT_LEAF);
+	static iser::CArchiveTag lineContainerTag("LineContainer", "Container of scan lines", iser::CArchiveTag::TT_MULTIPLE);
+	static iser::CArchiveTag scanLineTag("Line", "Single scan line", iser::CArchiveTag::TT_GROUP, &lineContainerTag);
+	static iser::CArchiveTag containerIndicesTag("ContainerIndices", "List of container indices for each line", iser::CArchiveTag::TT_MULTIPLE);
+	static iser::CArchiveTag indexTag("Index", "Container index", iser::CArchiveTag::TT_LEAF, &containerIndicesTag);
+
+	bool retVal = true;
+
+	retVal = retVal && archive.BeginTag(firstLineTag);
+	retVal = retVal && archive.Process(firstLinePos);
+	retVal = retVal && archive.EndTag(firstLineTag);
+
+	int containerSize = rangesContainer.size();
+
+	retVal = retVal && archive.BeginMultiTag(lineContainerTag, scanLineTag, containerSize);
+	for (int i = 0; i < containerSize; ++i){
+		retVal = retVal && archive.BeginTag(scanLineTag);
+		retVal = retVal && iser::CPrimitiveTypesSerializer::SerializeIntRanges(archive, rangesContainer[i]);
+		retVal = retVal && archive.EndTag(scanLineTag);
+	}
+
+	retVal = retVal && archive.EndTag(lineContainerTag);
+
+	int indicesCount = containerIndices.size();
+
+	retVal = retVal && archive.BeginMultiTag(containerIndicesTag, indexTag, indicesCount);
+	for (int i = 0; i < indicesCount; ++i){
+		retVal = retVal && archive.BeginTag(indexTag);
+		retVal = retVal && archive.Process(containerIndices[i]);
+		retVal = retVal && archive.EndTag(indexTag);
+	}
+
+	retVal = retVal && archive.EndTag(containerIndicesTag);
+
+	return retVal;
+}
+
+
+/**
+	Check if the pixel belongs to erosion or dilatation of the mask calculated pixel by pixel.
+*/
+bool IsPixelInMorphology(const iimg::CScanlineMask& mask, const iimg::CScanlineMask& structuringElement, bool isErosion, int x, int y)
+{
+	i2d::CRect elementRect = structuringElement.GetBoundingRect();
+
+	for (int offsetY = elementRect.GetTop(); offsetY < elementRect.GetBottom(); ++offsetY){
+		for (int offsetX = elementRect.GetLeft(); offsetX < elementRect.GetRight(); ++offsetX){
+			if (!IsPixelInside(structuringElement, offsetX, offsetY)){
+				continue;
+			}
+
+			if (isErosion){
+				if (!IsPixelInside(mask, x + offsetX, y + offsetY)){
+					return false;
+				}
+			}
+			else if (IsPixelInside(mask, x - offsetX, y - offsetY)){
+				return true;
+			}
+		}
+	}
+
+	return isErosion && !structuringElement.IsBitmapRegionEmpty();
+}
+
+
+} // namespace
 
 
 // protected slots
@@ -152,17 +307,19 @@ void CScanlineMaskTest::GetPixelRangesTest()
 	mask.CreateFilled(clipArea);
 	
 	// Get pixel ranges for a line within the region
-	const istd::CIntRanges* ranges = mask.GetPixelRanges(20);
-	QVERIFY(ranges != nullptr);
+	istd::CIntRanges ranges;
+	QVERIFY(mask.GetPixelRanges(20, ranges));
 	
-	// For filled region, should have at least one range
-	// Check if ranges is not empty
-	QVERIFY(!ranges->IsEmpty());
+	// For filled region, the range of the filled area is returned
+	QVERIFY(!ranges.IsEmpty());
+	QVERIFY(ranges.IsInside(10));
+	QVERIFY(ranges.IsInside(49));
+	QVERIFY(!ranges.IsInside(50));
 	
 	// Get pixel ranges for a line outside the region
-	const istd::CIntRanges* outsideRanges = mask.GetPixelRanges(5);
-	// Should be nullptr or empty for line outside region
-	QVERIFY(outsideRanges == nullptr || outsideRanges->IsEmpty());
+	istd::CIntRanges outsideRanges;
+	QVERIFY(!mask.GetPixelRanges(5, outsideRanges));
+	QVERIFY(outsideRanges.IsEmpty());
 }
 
 
@@ -356,6 +513,654 @@ void CScanlineMaskTest::InequalityOperatorTest()
 }
 
 
+void CScanlineMaskTest::GetLineSwitchPointsTest()
+{
+	iimg::CScanlineMask mask;
+	mask.CreateFilled(i2d::CRect(10, 10, 50, 30));
+
+	QCOMPARE(mask.GetScanlinesRange().GetMinValue(), 10);
+	QCOMPARE(mask.GetScanlinesRange().GetMaxValue(), 30);
+
+	int pointsCount = 0;
+	const int* pointsPtr = mask.GetLineSwitchPoints(20, pointsCount);
+	QVERIFY(pointsPtr != nullptr);
+	QCOMPARE(pointsCount, 2);
+	QCOMPARE(pointsPtr[0], 10);
+	QCOMPARE(pointsPtr[1], 50);
+
+	QVERIFY(mask.GetLineSwitchPoints(5, pointsCount) == nullptr);
+	QCOMPARE(pointsCount, 0);
+
+	// touching runs are merged
+	iimg::CScanlineMask mask2;
+	mask2.CreateFilled(i2d::CRect(50, 15, 70, 25));
+	mask.Union(mask2);
+
+	pointsPtr = mask.GetLineSwitchPoints(20, pointsCount);
+	QVERIFY(pointsPtr != nullptr);
+	QCOMPARE(pointsCount, 2);
+	QCOMPARE(pointsPtr[0], 10);
+	QCOMPARE(pointsPtr[1], 70);
+}
+
+
+void CScanlineMaskTest::CreateFromBitmapTest()
+{
+	iimg::CGeneralBitmap bitmap;
+	QVERIFY(bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(20, 4)));
+
+	for (int y = 0; y < 4; ++y){
+		quint8* linePtr = static_cast<quint8*>(bitmap.GetLinePtr(y));
+		for (int x = 0; x < 20; ++x){
+			linePtr[x] = ((x >= 2) && (x < 5)) || (x >= 15)? 1: 0;
+		}
+	}
+
+	iimg::CScanlineMask mask;
+	mask.CreateFromBitmap(bitmap);
+
+	// run touching the right border is closed at the bitmap width
+	int pointsCount = 0;
+	const int* pointsPtr = mask.GetLineSwitchPoints(1, pointsCount);
+	QVERIFY(pointsPtr != nullptr);
+	QCOMPARE(pointsCount, 4);
+	QCOMPARE(pointsPtr[0], 2);
+	QCOMPARE(pointsPtr[1], 5);
+	QCOMPARE(pointsPtr[2], 15);
+	QCOMPARE(pointsPtr[3], 20);
+
+	i2d::CRect clipArea(3, 1, 18, 3);
+	mask.CreateFromBitmap(bitmap, &clipArea);
+
+	QVERIFY(mask.GetLineSwitchPoints(0, pointsCount) == nullptr);
+	pointsPtr = mask.GetLineSwitchPoints(2, pointsCount);
+	QVERIFY(pointsPtr != nullptr);
+	QCOMPARE(pointsCount, 4);
+	QCOMPARE(pointsPtr[0], 3);
+	QCOMPARE(pointsPtr[1], 5);
+	QCOMPARE(pointsPtr[2], 15);
+	QCOMPARE(pointsPtr[3], 18);
+
+	i2d::CRect boundingRect = mask.GetBoundingRect();
+	QCOMPARE(boundingRect.GetLeft(), 3);
+	QCOMPARE(boundingRect.GetTop(), 1);
+	QCOMPARE(boundingRect.GetRight(), 18);
+	QCOMPARE(boundingRect.GetBottom(), 3);
+}
+
+
+void CScanlineMaskTest::SetOperationsTest()
+{
+	for (int testIndex = 0; testIndex < 10; ++testIndex){
+		iimg::CScanlineMask mask1;
+		CreateRandomMask(mask1, testIndex * 2 + 1, -5, testIndex - 5);
+
+		iimg::CScanlineMask mask2;
+		CreateRandomMask(mask2, testIndex * 2 + 2, 7, 3);
+
+		iimg::CScanlineMask unionMask = mask1.GetUnion(mask2);
+		iimg::CScanlineMask intersectionMask = mask1.GetIntersection(mask2);
+
+		i2d::CRect clipArea(-2, -3, 50, 40);
+		iimg::CScanlineMask invertedMask;
+		mask1.GetInverted(clipArea, invertedMask);
+
+		iimg::CScanlineMask dilatedMask(mask1);
+		dilatedMask.Dilate(1, 2, 1, 0);
+
+		for (int y = -15; y < 65; ++y){
+			for (int x = -15; x < 75; ++x){
+				bool isInside1 = IsPixelInside(mask1, x, y);
+				bool isInside2 = IsPixelInside(mask2, x, y);
+				bool isInClip = (x >= clipArea.GetLeft()) && (x < clipArea.GetRight()) && (y >= clipArea.GetTop()) && (y < clipArea.GetBottom());
+
+				QCOMPARE(IsPixelInside(unionMask, x, y), isInside1 || isInside2);
+				QCOMPARE(IsPixelInside(intersectionMask, x, y), isInside1 && isInside2);
+				QCOMPARE(IsPixelInside(invertedMask, x, y), isInClip && !isInside1);
+
+				bool isDilated =
+							isInside1 ||
+							IsPixelInside(mask1, x + 1, y) ||
+							IsPixelInside(mask1, x - 1, y) ||
+							IsPixelInside(mask1, x - 2, y) ||
+							IsPixelInside(mask1, x, y + 1) ||
+							IsPixelInside(mask1, x + 1, y + 1) ||
+							IsPixelInside(mask1, x - 1, y + 1) ||
+							IsPixelInside(mask1, x - 2, y + 1);
+				QCOMPARE(IsPixelInside(dilatedMask, x, y), isDilated);
+			}
+		}
+
+		// operations on place give the same results
+		iimg::CScanlineMask mask(mask1);
+		mask.Union(mask2);
+		QVERIFY(mask == unionMask);
+		QCOMPARE(qHash(mask), qHash(unionMask));
+
+		mask = mask1;
+		mask.Intersection(mask2);
+		QVERIFY(mask == intersectionMask);
+
+		mask = mask1;
+		mask.Invert(clipArea);
+		QVERIFY(mask == invertedMask);
+	}
+}
+
+
+void CScanlineMaskTest::SerializationTest()
+{
+	iimg::CScanlineMask mask;
+	CreateRandomMask(mask, 17, 3, -4);
+
+	iimg::CScanlineMask rectMask;
+	rectMask.CreateFilled(i2d::CRect(0, 60, 30, 90));
+	mask.Union(rectMask);
+
+	iser::CMemoryWriteArchive writeArchive;
+	QVERIFY(mask.Serialize(writeArchive));
+
+	iser::CMemoryReadArchive readArchive(writeArchive);
+	iimg::CScanlineMask restoredMask;
+	QVERIFY(restoredMask.Serialize(readArchive));
+
+	QVERIFY(restoredMask == mask);
+	QCOMPARE(qHash(restoredMask), qHash(mask));
+}
+
+
+void CScanlineMaskTest::LegacySerializationTest()
+{
+	// closed runs
+	istd::CIntRanges closedRanges;
+	closedRanges.InsertSwitchPoint(1);
+	closedRanges.InsertSwitchPoint(4);
+
+	// run reaching the right border of the bitmap was stored without its end
+	istd::CIntRanges openEndRanges;
+	openEndRanges.InsertSwitchPoint(3);
+
+	// inverted range list beginning with an active run
+	istd::CIntRanges openBeginRanges;
+	openBeginRanges.SetBeginState(true);
+	openBeginRanges.InsertSwitchPoint(2);
+	openBeginRanges.InsertSwitchPoint(6);
+	openBeginRanges.InsertSwitchPoint(9);
+
+	iser::CMemoryWriteArchive writeArchive;
+	QVERIFY(WriteLegacyMaskArchive(
+				writeArchive,
+				5,
+				QList<istd::CIntRanges>() << closedRanges << openEndRanges << openBeginRanges,
+				QList<int>() << 0 << 1 << -1 << 2));
+
+	iser::CMemoryReadArchive readArchive(writeArchive);
+	iimg::CScanlineMask mask;
+	QVERIFY(mask.Serialize(readArchive));
+
+	QVERIFY(mask.GetScanlinesRange() == istd::CIntRange(5, 9));
+
+	int pointsCount = 0;
+	const int* pointsPtr = mask.GetLineSwitchPoints(5, pointsCount);
+	QVERIFY(pointsPtr != NULL);
+	QCOMPARE(pointsCount, 2);
+	QCOMPARE(pointsPtr[0], 1);
+	QCOMPARE(pointsPtr[1], 4);
+
+	// open runs are closed at a finite limit far outside of the bitmap
+	pointsPtr = mask.GetLineSwitchPoints(6, pointsCount);
+	QVERIFY(pointsPtr != NULL);
+	QCOMPARE(pointsCount, 2);
+	QCOMPARE(pointsPtr[0], 3);
+	QVERIFY(pointsPtr[1] > 1000000);
+	QVERIFY(pointsPtr[1] < std::numeric_limits<int>::max() / 2);
+
+	pointsPtr = mask.GetLineSwitchPoints(7, pointsCount);
+	QVERIFY((pointsPtr == NULL) || (pointsCount == 0));
+
+	pointsPtr = mask.GetLineSwitchPoints(8, pointsCount);
+	QVERIFY(pointsPtr != NULL);
+	QCOMPARE(pointsCount, 4);
+	QVERIFY(pointsPtr[0] < -1000000);
+	QVERIFY(pointsPtr[0] > std::numeric_limits<int>::min() / 2);
+	QCOMPARE(pointsPtr[1], 2);
+	QCOMPARE(pointsPtr[2], 6);
+	QCOMPARE(pointsPtr[3], 9);
+
+	QVERIFY(IsPixelInside(mask, 1000000, 6));
+	QVERIFY(IsPixelInside(mask, -1000000, 8));
+	QVERIFY(!IsPixelInside(mask, 4, 8));
+}
+
+
+void CScanlineMaskTest::LegacyGeometryTest()
+{
+	istd::CIntRanges openEndRanges;
+	openEndRanges.InsertSwitchPoint(3);
+
+	istd::CIntRanges openBeginRanges;
+	openBeginRanges.SetBeginState(true);
+	openBeginRanges.InsertSwitchPoint(2);
+	openBeginRanges.InsertSwitchPoint(6);
+	openBeginRanges.InsertSwitchPoint(9);
+
+	iser::CMemoryWriteArchive writeArchive;
+	QVERIFY(WriteLegacyMaskArchive(
+				writeArchive,
+				0,
+				QList<istd::CIntRanges>() << openEndRanges << openBeginRanges,
+				QList<int>() << 0 << 1));
+
+	iimg::CScanlineMask legacyMask;
+	iser::CMemoryReadArchive readArchive(writeArchive);
+	QVERIFY(legacyMask.Serialize(readArchive));
+
+	const i2d::CRect boundingRect = legacyMask.GetBoundingRect();
+	QVERIFY(boundingRect.GetWidth() > 2000000);
+
+	iimg::CScanlineMask translatedMask = legacyMask.GetTranslated(-5, 1);
+	QVERIFY(AreSwitchPointsSorted(translatedMask));
+	QVERIFY(translatedMask.GetBoundingRect() == i2d::CRect(boundingRect.GetLeft() - 5, 1, boundingRect.GetRight() - 5, 3));
+	QVERIFY(IsPixelInside(translatedMask, -2, 1));
+	QVERIFY(IsPixelInside(translatedMask, 1000000, 1));
+	QVERIFY(!IsPixelInside(translatedMask, -3, 1));
+	QVERIFY(IsPixelInside(translatedMask, -1000000, 2));
+	QVERIFY(!IsPixelInside(translatedMask, -3, 2));
+
+	iimg::CScanlineMask dilatedMask = legacyMask;
+	dilatedMask.Dilate(2, 2, 0, 0);
+	QVERIFY(AreSwitchPointsSorted(dilatedMask));
+	QVERIFY(IsPixelInside(dilatedMask, 1, 0));
+	QVERIFY(IsPixelInside(dilatedMask, 1000000, 0));
+	QVERIFY(!IsPixelInside(dilatedMask, 0, 0));
+	QVERIFY(IsPixelInside(dilatedMask, -1000000, 1));
+	QVERIFY(IsPixelInside(dilatedMask, 5, 1));
+	QVERIFY(IsPixelInside(dilatedMask, 10, 1));
+	QVERIFY(!IsPixelInside(dilatedMask, 11, 1));
+
+	iimg::CScanlineMask erodedMask = legacyMask;
+	erodedMask.Erode(2, 2, 0, 0);
+	QVERIFY(AreSwitchPointsSorted(erodedMask));
+	QVERIFY(IsPixelInside(erodedMask, 5, 0));
+	QVERIFY(IsPixelInside(erodedMask, 1000000, 0));
+	QVERIFY(!IsPixelInside(erodedMask, 4, 0));
+	QVERIFY(IsPixelInside(erodedMask, -1000000, 1));
+	QVERIFY(!IsPixelInside(erodedMask, 0, 1));
+	QVERIFY(!IsPixelInside(erodedMask, 7, 1));
+
+	// the run based morphology with structuring element uses the same switch points
+	iimg::CScanlineMask crossElement;
+	crossElement.CreateFilled(i2d::CRect(-1, 0, 2, 1));
+	iimg::CScanlineMask verticalElement;
+	verticalElement.CreateFilled(i2d::CRect(0, -1, 1, 2));
+	crossElement.Union(verticalElement);
+
+	iimg::CScanlineMask elementDilatedMask = legacyMask;
+	elementDilatedMask.Dilate(crossElement);
+	QVERIFY(AreSwitchPointsSorted(elementDilatedMask));
+	QVERIFY(IsPixelInside(elementDilatedMask, 2, 0));
+	QVERIFY(IsPixelInside(elementDilatedMask, 1000000, -1));
+	QVERIFY(IsPixelInside(elementDilatedMask, -1000000, 2));
+
+	iimg::CScanlineMask elementErodedMask = legacyMask;
+	elementErodedMask.Erode(crossElement);
+	QVERIFY(AreSwitchPointsSorted(elementErodedMask));
+	QVERIFY(!IsPixelInside(elementErodedMask, 1000000, 0));
+	QVERIFY(!IsPixelInside(elementErodedMask, -1000000, 1));
+}
+
+
+void CScanlineMaskTest::SetOperationsBenchmark()
+{
+	iimg::CScanlineMask circleMask;
+	circleMask.CreateFromCircle(i2d::CCircle(s_benchmarkRegionSize * 0.45, i2d::CVector2d(s_benchmarkRegionSize * 0.5, s_benchmarkRegionSize * 0.5)));
+
+	iimg::CScanlineMask annulusMask;
+	annulusMask.CreateFromAnnulus(i2d::CAnnulus(i2d::CVector2d(s_benchmarkRegionSize * 0.6, s_benchmarkRegionSize * 0.4), s_benchmarkRegionSize * 0.1, s_benchmarkRegionSize * 0.4));
+
+	QBENCHMARK{
+		iimg::CScanlineMask resultMask = circleMask.GetUnion(annulusMask);
+		resultMask.Intersection(annulusMask);
+		resultMask.Invert(i2d::CRect(0, 0, s_benchmarkRegionSize, s_benchmarkRegionSize));
+		resultMask.Translate(3, 5);
+	}
+}
+
+
+void CScanlineMaskTest::StructuringElementTest()
+{
+	iimg::CScanlineMask ellipseElement;
+	ellipseElement.CreateEllipseElement(2.5, 1.5);
+	QVERIFY(ellipseElement.GetBoundingRect() == i2d::CRect(-2, -1, 3, 2));
+	QVERIFY(IsPixelInside(ellipseElement, 2, 0));
+	QVERIFY(IsPixelInside(ellipseElement, 1, 1));
+	QVERIFY(!IsPixelInside(ellipseElement, 2, 1));
+
+	iimg::CScanlineMask crossElement;
+	crossElement.CreateFilled(i2d::CRect(-1, 0, 2, 1));
+	iimg::CScanlineMask verticalElement;
+	verticalElement.CreateFilled(i2d::CRect(0, -1, 1, 2));
+	crossElement.Union(verticalElement);
+
+	// irregular element not containing the origin
+	iimg::CScanlineMask irregularElement;
+	CreateRandomMask(irregularElement, 5, 0, 0);
+	iimg::CScanlineMask clipElement;
+	clipElement.CreateFilled(i2d::CRect(2, 1, 6, 4));
+	irregularElement.Intersection(clipElement);
+	irregularElement.Union(ellipseElement.GetTranslated(4, -3));
+
+	const iimg::CScanlineMask* elements[] = {&ellipseElement, &crossElement, &irregularElement};
+
+	for (int testIndex = 0; testIndex < 6; ++testIndex){
+		iimg::CScanlineMask mask;
+		CreateRandomMask(mask, testIndex + 31, testIndex - 3, 2);
+
+		const iimg::CScanlineMask& structuringElement = *elements[testIndex % 3];
+
+		iimg::CScanlineMask erodedMask(mask);
+		erodedMask.Erode(structuringElement);
+
+		iimg::CScanlineMask dilatedMask(mask);
+		dilatedMask.Dilate(structuringElement);
+
+		for (int y = -10; y < 65; ++y){
+			for (int x = -15; x < 70; ++x){
+				QCOMPARE(IsPixelInside(erodedMask, x, y), IsPixelInMorphology(mask, structuringElement, true, x, y));
+				QCOMPARE(IsPixelInside(dilatedMask, x, y), IsPixelInMorphology(mask, structuringElement, false, x, y));
+			}
+		}
+
+		iimg::CScanlineMask openedMask(mask);
+		openedMask.Open(structuringElement);
+		erodedMask.Dilate(structuringElement);
+		QVERIFY(openedMask == erodedMask);
+
+		iimg::CScanlineMask closedMask(mask);
+		closedMask.Close(structuringElement);
+		dilatedMask.Erode(structuringElement);
+		QVERIFY(closedMask == dilatedMask);
+	}
+
+	// rectangular element gives the same result as the rectangle kernel
+	iimg::CScanlineMask mask;
+	CreateRandomMask(mask, 7, 0, 0);
+
+	iimg::CScanlineMask rectElement;
+	rectElement.CreateFilled(i2d::CRect(-1, -3, 3, 1));
+
+	iimg::CScanlineMask dilatedMask(mask);
+	dilatedMask.Dilate(1, 2, 3, 0);
+	iimg::CScanlineMask elementDilatedMask(mask);
+	elementDilatedMask.Dilate(rectElement);
+	QVERIFY(dilatedMask == elementDilatedMask);
+
+	iimg::CScanlineMask erodedMask(mask);
+	erodedMask.Erode(1, 2, 3, 0);
+	iimg::CScanlineMask elementErodedMask(mask);
+	elementErodedMask.Erode(rectElement);
+	QVERIFY(erodedMask == elementErodedMask);
+
+	// empty element gives empty result
+	erodedMask = mask;
+	erodedMask.Erode(iimg::CScanlineMask());
+	QVERIFY(erodedMask.IsBitmapRegionEmpty());
+}
+
+
+void CScanlineMaskTest::CircleMorphologyTest()
+{
+	for (int testIndex = 0; testIndex <= 20; ++testIndex){
+		// both run based calculation (small radii) and distance transformation (large radii) are used
+		const double radius = testIndex * 0.5;
+
+		iimg::CScanlineMask mask;
+		CreateRandomMask(mask, testIndex + 11, 4, -2);
+
+		iimg::CScanlineMask structuringElement;
+		structuringElement.CreateEllipseElement(radius, radius);
+
+		iimg::CScanlineMask erodedMask(mask);
+		erodedMask.ErodeCircle(radius);
+		iimg::CScanlineMask elementErodedMask(mask);
+		elementErodedMask.Erode(structuringElement);
+		QVERIFY(erodedMask == elementErodedMask);
+
+		iimg::CScanlineMask dilatedMask(mask);
+		dilatedMask.DilateCircle(radius);
+		iimg::CScanlineMask elementDilatedMask(mask);
+		elementDilatedMask.Dilate(structuringElement);
+		QVERIFY(dilatedMask == elementDilatedMask);
+
+		if ((testIndex % 5) == 0){
+			for (int y = -15; y < 65; ++y){
+				for (int x = -10; x < 80; ++x){
+					QCOMPARE(IsPixelInside(dilatedMask, x, y), IsPixelInMorphology(mask, structuringElement, false, x, y));
+				}
+			}
+		}
+	}
+
+	// mask wider than the int range must be processed without distance transformation
+	iimg::CScanlineMask wideMask;
+	wideMask.CreateFilled(i2d::CRect(-1500000000, 0, -1499999990, 3));
+	iimg::CScanlineMask rightMask;
+	rightMask.CreateFilled(i2d::CRect(1499999990, 0, 1500000000, 3));
+	wideMask.Union(rightMask);
+
+	iimg::CScanlineMask structuringElement;
+	structuringElement.CreateEllipseElement(20, 20);
+
+	iimg::CScanlineMask dilatedMask(wideMask);
+	dilatedMask.DilateCircle(20);
+	iimg::CScanlineMask elementDilatedMask(wideMask);
+	elementDilatedMask.Dilate(structuringElement);
+	QVERIFY(dilatedMask == elementDilatedMask);
+	QVERIFY(IsPixelInside(dilatedMask, -1500000020, 1));
+	QVERIFY(IsPixelInside(dilatedMask, 1500000019, 1));
+
+	iimg::CScanlineMask erodedMask(wideMask);
+	erodedMask.ErodeCircle(1);
+	iimg::CScanlineMask elementErodedMask(wideMask);
+	structuringElement.CreateEllipseElement(1, 1);
+	elementErodedMask.Erode(structuringElement);
+	QVERIFY(erodedMask == elementErodedMask);
+	QVERIFY(IsPixelInside(erodedMask, -1499999995, 1));
+	QVERIFY(!IsPixelInside(erodedMask, -1499999995, 0));
+}
+
+
+void CScanlineMaskTest::CircleMorphologyBenchmark_data()
+{
+	QTest::addColumn<int>("radius");
+
+	QTest::newRow("radius 1") << 1;
+	QTest::newRow("radius 3") << 3;
+	QTest::newRow("radius 10") << 10;
+	QTest::newRow("radius 30") << 30;
+	QTest::newRow("radius 100") << 100;
+}
+
+
+void CScanlineMaskTest::CircleMorphologyBenchmark()
+{
+	QFETCH(int, radius);
+
+	// large circle with a lot of small holes
+	iimg::CGeneralBitmap bitmap;
+	bitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(s_benchmarkRegionSize, s_benchmarkRegionSize));
+
+	const int center = s_benchmarkRegionSize / 2;
+	const qint64 squaredRadius = qint64(center) * center * 4 / 5;
+	itest::CRandomDataGenerator generator;
+
+	for (int y = 0; y < s_benchmarkRegionSize; ++y){
+		quint8* linePtr = static_cast<quint8*>(bitmap.GetLinePtr(y));
+
+		for (int x = 0; x < s_benchmarkRegionSize; ++x){
+			const quint8 randomValue = generator.GetNextByte();
+			const qint64 squaredDistance = qint64(x - center) * (x - center) + qint64(y - center) * (y - center);
+
+			linePtr[x] = (squaredDistance < squaredRadius) && (randomValue >= 16)? 255: 0;
+		}
+	}
+
+	iimg::CScanlineMask mask;
+	mask.CreateFromBitmap(bitmap);
+
+	QBENCHMARK{
+		iimg::CScanlineMask resultMask(mask);
+		resultMask.ErodeCircle(radius);
+		resultMask.DilateCircle(radius);
+	}
+}
+
+
+void CScanlineMaskTest::CreateFromPolygonTest()
+{
+	i2d::CPolygon square;
+	square.InsertNode(i2d::CVector2d(2, 2));
+	square.InsertNode(i2d::CVector2d(8, 2));
+	square.InsertNode(i2d::CVector2d(8, 6));
+	square.InsertNode(i2d::CVector2d(2, 6));
+
+	iimg::CScanlineMask expectedMask;
+	expectedMask.CreateFilled(i2d::CRect(2, 2, 8, 6));
+
+	iimg::CScanlineMask mask;
+	mask.CreateFromPolygon(square);
+	QVERIFY(mask == expectedMask);
+
+	mask.CreateFromPolygon(square, NULL, iimg::CScanlineMask::FR_NON_ZERO);
+	QVERIFY(mask == expectedMask);
+
+	// clipping
+	i2d::CRect clipArea(4, 0, 20, 5);
+	mask.CreateFromPolygon(square, &clipArea);
+	expectedMask.CreateFilled(i2d::CRect(4, 2, 8, 5));
+	QVERIFY(mask == expectedMask);
+
+	// outline going twice around the square cancels itself out only using even-odd rule
+	i2d::CPolygon doubleSquare;
+	for (int i = 0; i < 8; ++i){
+		doubleSquare.InsertNode(square.GetNodePos(i % 4));
+	}
+
+	mask.CreateFromPolygon(doubleSquare);
+	QVERIFY(mask.IsBitmapRegionEmpty());
+
+	mask.CreateFromPolygon(doubleSquare, NULL, iimg::CScanlineMask::FR_NON_ZERO);
+	expectedMask.CreateFilled(i2d::CRect(2, 2, 8, 6));
+	QVERIFY(mask == expectedMask);
+
+	// pentagram has the inner pentagon filled only using non-zero rule
+	i2d::CPolygon pentagram;
+	for (int i = 0; i < 5; ++i){
+		const double angle = i * 4 * M_PI / 5;
+
+		pentagram.InsertNode(i2d::CVector2d(50 + 40 * qSin(angle), 50 - 40 * qCos(angle)));
+	}
+
+	iimg::CScanlineMask evenOddMask;
+	evenOddMask.CreateFromPolygon(pentagram, NULL, iimg::CScanlineMask::FR_EVEN_ODD);
+
+	iimg::CScanlineMask nonZeroMask;
+	nonZeroMask.CreateFromPolygon(pentagram, NULL, iimg::CScanlineMask::FR_NON_ZERO);
+
+	QVERIFY(!IsPixelInside(evenOddMask, 50, 50));
+	QVERIFY(IsPixelInside(nonZeroMask, 50, 50));
+	QVERIFY(IsPixelInside(evenOddMask, 50, 15));
+	QVERIFY(IsPixelInside(nonZeroMask, 50, 15));
+	QVERIFY(!IsPixelInside(nonZeroMask, 50, 95));
+
+	iimg::CScanlineMask differenceMask(evenOddMask);
+	differenceMask.Invert(nonZeroMask.GetBoundingRect());
+	differenceMask.Intersection(nonZeroMask);
+
+	QVERIFY(!differenceMask.IsBitmapRegionEmpty());
+	QVERIFY(differenceMask.GetBoundingRect().GetWidth() < 40);
+}
+
+
+void CScanlineMaskTest::PolygonCoverageTest()
+{
+	i2d::CPolygon rectangle;
+	rectangle.InsertNode(i2d::CVector2d(1.25, 2));
+	rectangle.InsertNode(i2d::CVector2d(3.75, 2));
+	rectangle.InsertNode(i2d::CVector2d(3.75, 4.5));
+	rectangle.InsertNode(i2d::CVector2d(1.25, 4.5));
+
+	iimg::CGeneralBitmap coverageBitmap;
+	QVERIFY(coverageBitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(6, 6)));
+	QVERIFY(iimg::CScanlineMask::CalcPolygonCoverage(rectangle, coverageBitmap, iimg::CScanlineMask::FR_EVEN_ODD, 2));
+
+	static const float expectedCoverage[6][6] = {
+				{0, 0, 0, 0, 0, 0},
+				{0, 0, 0, 0, 0, 0},
+				{0, 0.75f, 1, 0.75f, 0, 0},
+				{0, 0.75f, 1, 0.75f, 0, 0},
+				{0, 0.375f, 0.5f, 0.375f, 0, 0},
+				{0, 0, 0, 0, 0, 0}};
+
+	for (int y = 0; y < 6; ++y){
+		const float* linePtr = static_cast<const float*>(coverageBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 6; ++x){
+			QVERIFY(qAbs(linePtr[x] - expectedCoverage[y][x]) < 1e-6);
+		}
+	}
+
+	// sum of the coverage is the area of the polygon
+	i2d::CPolygon triangle;
+	triangle.InsertNode(i2d::CVector2d(1, 1));
+	triangle.InsertNode(i2d::CVector2d(31, 1));
+	triangle.InsertNode(i2d::CVector2d(1, 21));
+
+	QVERIFY(coverageBitmap.CreateBitmap(iimg::IBitmap::PF_FLOAT32, istd::CIndex2d(40, 30)));
+	QVERIFY(iimg::CScanlineMask::CalcPolygonCoverage(triangle, coverageBitmap));
+
+	double coverageSum = 0;
+	for (int y = 0; y < 30; ++y){
+		const float* linePtr = static_cast<const float*>(coverageBitmap.GetLinePtr(y));
+
+		for (int x = 0; x < 40; ++x){
+			QVERIFY((linePtr[x] >= 0) && (linePtr[x] <= 1));
+
+			coverageSum += linePtr[x];
+		}
+	}
+
+	QVERIFY(qAbs(coverageSum - 300) < 1e-3);
+
+	iimg::CGeneralBitmap grayBitmap;
+	QVERIFY(grayBitmap.CreateBitmap(iimg::IBitmap::PF_GRAY, istd::CIndex2d(6, 6)));
+	QVERIFY(!iimg::CScanlineMask::CalcPolygonCoverage(rectangle, grayBitmap));
+}
+
+
+void CScanlineMaskTest::PolygonBenchmark()
+{
+	// traced contour with a lot of nodes
+	static const int nodesCount = 100000;
+
+	i2d::CPolygon polygon;
+	polygon.SetNodesCount(nodesCount);
+
+	const double center = s_benchmarkRegionSize * 0.5;
+	for (int i = 0; i < nodesCount; ++i){
+		const double angle = i * 2 * M_PI / nodesCount;
+		const double radius = center * (0.8 + 0.1 * qSin(angle * 300));
+
+		polygon.SetNodePos(i, i2d::CVector2d(center + radius * qCos(angle), center + radius * qSin(angle)));
+	}
+
+	QBENCHMARK{
+		iimg::CScanlineMask mask;
+		mask.CreateFromPolygon(polygon);
+	}
+}
+
+
 void CScanlineMaskTest::cleanupTestCase()
 {
 	delete m_maskPtr;
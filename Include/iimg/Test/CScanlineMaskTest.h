@@ -11,6 +11,7 @@
 #include <i2d/CRect.h>
 #include <i2d/CCircle.h>
 #include <i2d/CRectangle.h>
+#include <i2d/CPolygon.h>
 #include <itest/CStandardTestExecutor.h>
 
 class CScanlineMaskTest: public QObject
@@ -35,6 +36,20 @@ private slots:
 	void ErodeTest();
 	void EqualityOperatorTest();
 	void InequalityOperatorTest();
+	void GetLineSwitchPointsTest();
+	void CreateFromBitmapTest();
+	void SetOperationsTest();
+	void SerializationTest();
+	void LegacySerializationTest();
+	void LegacyGeometryTest();
+	void SetOperationsBenchmark();
+	void StructuringElementTest();
+	void CircleMorphologyTest();
+	void CircleMorphologyBenchmark_data();
+	void CircleMorphologyBenchmark();
+	void CreateFromPolygonTest();
+	void PolygonCoverageTest();
+	void PolygonBenchmark();
 
 	void cleanupTestCase();
 
@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <imod/CAsyncObserverProxy.h>
+
+
+// Qt includes
+#include <QtCore/QThread>
+
+
+namespace imod
+{
+
+
+// public methods
+
+CAsyncObserverProxy::CAsyncObserverProxy(IObserver* observerPtr, QThread* targetThreadPtr, int maxUpdateRate)
+:	m_observerPtr(observerPtr),
+	m_isDeliveryRequested(false),
+	m_maxUpdateRate(qMax(maxUpdateRate, 0)),
+	m_deliveryTimer(this),
+	m_receivedUpdatesCount(0),
+	m_deliveredUpdatesCount(0),
+	m_coalescedUpdatesCount(0)
+#if QT_VERSION < 0x060000
+	,m_deliveryMutex(QMutex::Recursive)
+#endif
+{
+	Q_ASSERT(m_observerPtr != NULL);
+
+	m_deliveryTimer.setSingleShot(true);
+
+	if (targetThreadPtr != NULL){
+		moveToThread(targetThreadPtr);
+	}
+
+	connect(this, SIGNAL(EmitDeliveryRequested()), this, SLOT(OnDeliveryRequested()), Qt::QueuedConnection);
+	connect(&m_deliveryTimer, SIGNAL(timeout()), this, SLOT(OnDeliveryTimer()));
+}
+
+
+CAsyncObserverProxy::~CAsyncObserverProxy()
+{
+	EnsureModelsDetached();
+}
+
+
+IObserver* CAsyncObserverProxy::GetObserver() const
+{
+	return m_observerPtr;
+}
+
+
+int CAsyncObserverProxy::GetMaxUpdateRate() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_maxUpdateRate;
+}
+
+
+void CAsyncObserverProxy::SetMaxUpdateRate(int maxUpdateRate)
+{
+	QMutexLocker lock(&m_mutex);
+
+	m_maxUpdateRate = qMax(maxUpdateRate, 0);
+}
+
+
+qint64 CAsyncObserverProxy::GetReceivedUpdatesCount() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_receivedUpdatesCount;
+}
+
+
+qint64 CAsyncObserverProxy::GetDeliveredUpdatesCount() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_deliveredUpdatesCount;
+}
+
+
+qint64 CAsyncObserverProxy::GetCoalescedUpdatesCount() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_coalescedUpdatesCount;
+}
+
+
+void CAsyncObserverProxy::ResetCounters()
+{
+	QMutexLocker lock(&m_mutex);
+
+	m_receivedUpdatesCount = 0;
+	m_deliveredUpdatesCount = 0;
+	m_coalescedUpdatesCount = 0;
+}
+
+
+void CAsyncObserverProxy::FlushPendingUpdates()
+{
+	Q_ASSERT(QThread::currentThread() == thread());
+
+	m_deliveryTimer.stop();
+
+	DeliverPendingUpdates();
+}
+
+
+void CAsyncObserverProxy::EnsureModelsDetached()
+{
+	Models models;
+	{
+		QMutexLocker lock(&m_mutex);
+		models = m_models;
+	}
+
+	for (Models::iterator it = models.begin(); it != models.end(); ++it){
+		(*it)->DetachObserver(this);
+	}
+}
+
+
+// reimplemented (imod::IObserver)
+
+bool CAsyncObserverProxy::IsModelAttached(const imod::IModel* modelPtr) const
+{
+	QMutexLocker lock(&m_mutex);
+
+	if (modelPtr != NULL){
+		return m_models.contains(const_cast<imod::IModel*>(modelPtr));
+	}
+
+	return !m_models.isEmpty();
+}
+
+
+bool CAsyncObserverProxy::OnModelAttached(imod::IModel* modelPtr, istd::IChangeable::ChangeSet& changeMask)
+{
+	Q_ASSERT(modelPtr != NULL);
+
+	if (IsModelAttached(modelPtr)){
+		return false;
+	}
+
+	if (!m_observerPtr->OnModelAttached(modelPtr, changeMask)){
+		return false;
+	}
+
+	QMutexLocker lock(&m_mutex);
+
+	m_models.push_back(modelPtr);
+
+	return true;
+}
+
+
+bool CAsyncObserverProxy::OnModelDetached(imod::IModel* modelPtr)
+{
+	// wait for running delivery, it could use the model
+	QMutexLocker deliveryLock(&m_deliveryMutex);
+	QMutexLocker lock(&m_mutex);
+
+	int modelIndex = m_models.indexOf(modelPtr);
+	if (modelIndex < 0){
+		return false;
+	}
+
+	m_models.remove(modelIndex);
+
+	// pending changes of detached model will be never delivered
+	m_pendingChanges.remove(modelPtr);
+
+	lock.unlock();
+
+	return m_observerPtr->OnModelDetached(modelPtr);
+}
+
+
+void CAsyncObserverProxy::BeforeUpdate(imod::IModel* /*modelPtr*/)
+{
+	// target observer gets BeforeUpdate directly before the delivery of collected changes
+}
+
+
+void CAsyncObserverProxy::AfterUpdate(imod::IModel* modelPtr, const istd::IChangeable::ChangeSet& changeSet)
+{
+	QMutexLocker lock(&m_mutex);
+
+	if (!m_models.contains(modelPtr)){
+		return;
+	}
+
+	m_receivedUpdatesCount++;
+
+	PendingChangesMap::Iterator pendingIter = m_pendingChanges.find(modelPtr);
+	if (pendingIter != m_pendingChanges.end()){
+		pendingIter.value() += changeSet;
+
+		m_coalescedUpdatesCount++;
+	}
+	else{
+		m_pendingChanges.insert(modelPtr, changeSet);
+	}
+
+	if (m_isDeliveryRequested){
+		return;
+	}
+
+	m_isDeliveryRequested = true;
+
+	lock.unlock();
+
+	Q_EMIT EmitDeliveryRequested();
+}
+
+
+// protected slots
+
+void CAsyncObserverProxy::OnDeliveryRequested()
+{
+	if (m_deliveryTimer.isActive()){
+		return;
+	}
+
+	int maxUpdateRate = GetMaxUpdateRate();
+	if ((maxUpdateRate > 0) && m_lastDeliveryTimer.isValid()){
+		qint64 minInterval = 1000 / maxUpdateRate;
+		qint64 elapsedTime = m_lastDeliveryTimer.elapsed();
+		if (elapsedTime < minInterval){
+			m_deliveryTimer.start(int(minInterval - elapsedTime));
+
+			return;
+		}
+	}
+
+	DeliverPendingUpdates();
+}
+
+
+void CAsyncObserverProxy::OnDeliveryTimer()
+{
+	DeliverPendingUpdates();
+}
+
+
+// private methods
+
+void CAsyncObserverProxy::DeliverPendingUpdates()
+{
+	QMutexLocker deliveryLock(&m_deliveryMutex);
+	QMutexLocker lock(&m_mutex);
+
+	PendingChangesMap pendingChanges;
+	pendingChanges.swap(m_pendingChanges);
+
+	m_isDeliveryRequested = false;
+	m_deliveredUpdatesCount += pendingChanges.size();
+
+	lock.unlock();
+
+	if (pendingChanges.isEmpty()){
+		return;
+	}
+
+	m_lastDeliveryTimer.start();
+
+	for (PendingChangesMap::ConstIterator iter = pendingChanges.constBegin(); iter != pendingChanges.constEnd(); ++iter){
+		imod::IModel* modelPtr = iter.key();
+
+		m_observerPtr->BeforeUpdate(modelPtr);
+		m_observerPtr->AfterUpdate(modelPtr, iter.value());
+	}
+}
+
+
+} // namespace imod
+
+
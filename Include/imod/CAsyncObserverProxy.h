@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+
+// ACF includes
+#include <istd/IChangeable.h>
+#include <imod/IModel.h>
+#include <imod/IObserver.h>
+
+
+namespace imod
+{
+
+
+/**
+	Observer proxy delivering model updates asynchronously to another observer.
+	The proxy is attached to the models instead of the target observer.
+	Update notifications coming from the model thread are only collected in a coalescing queue (change sets are merged using \c operator+=),
+	the delivery to the target observer is done later in the thread of this proxy object, optionally limited to a maximal update rate.
+	In this way, a producer changing the model in a fast loop does not pay for the update of slow observers, e.g. GUI views.
+
+	The target observer gets one pair of \c BeforeUpdate and \c AfterUpdate per delivery containing all collected changes.
+	\c OnModelAttached and \c OnModelDetached are forwarded synchronously.
+	\note Proxy must be destroyed in its own thread.
+
+	\sa imod::CModelUpdateBridge
+
+	\ingroup ModelObserver
+*/
+class CAsyncObserverProxy: public QObject, virtual public IObserver
+{
+	Q_OBJECT
+
+public:
+	/**
+		Construct the proxy.
+		\param	observerPtr			target observer. It cannot be \c NULL.
+		\param	targetThreadPtr		thread where the updates will be delivered. If it is \c NULL, the current thread will be used.
+		\param	maxUpdateRate		maximal number of deliveries per second. If it is 0, updates are delivered as soon as the target thread processes its events.
+	*/
+	explicit CAsyncObserverProxy(IObserver* observerPtr, QThread* targetThreadPtr = NULL, int maxUpdateRate = 0);
+	virtual ~CAsyncObserverProxy();
+
+	/**
+		Get the target observer.
+	*/
+	IObserver* GetObserver() const;
+
+	/**
+		Get maximal number of update deliveries per second, 0 means unlimited.
+	*/
+	int GetMaxUpdateRate() const;
+	/**
+		Set maximal number of update deliveries per second, 0 means unlimited.
+	*/
+	void SetMaxUpdateRate(int maxUpdateRate);
+
+	/**
+		Get number of updates received from the models.
+	*/
+	qint64 GetReceivedUpdatesCount() const;
+	/**
+		Get number of updates delivered to the target observer.
+	*/
+	qint64 GetDeliveredUpdatesCount() const;
+	/**
+		Get number of updates merged into other updates and not delivered separately.
+	*/
+	qint64 GetCoalescedUpdatesCount() const;
+	/**
+		Reset update counters.
+	*/
+	void ResetCounters();
+
+	/**
+		Deliver all pending updates immediately.
+		It must be called in the thread of this object.
+	*/
+	void FlushPendingUpdates();
+
+	/**
+		Remove all observed models from this proxy.
+	*/
+	void EnsureModelsDetached();
+
+	// reimplemented (imod::IObserver)
+	virtual bool IsModelAttached(const imod::IModel* modelPtr) const override;
+	virtual bool OnModelAttached(imod::IModel* modelPtr, istd::IChangeable::ChangeSet& changeMask) override;
+	virtual bool OnModelDetached(imod::IModel* modelPtr) override;
+	virtual void BeforeUpdate(imod::IModel* modelPtr) override;
+	virtual void AfterUpdate(imod::IModel* modelPtr, const istd::IChangeable::ChangeSet& changeSet) override;
+
+Q_SIGNALS:
+	void EmitDeliveryRequested();
+
+protected Q_SLOTS:
+	void OnDeliveryRequested();
+	void OnDeliveryTimer();
+
+private:
+	void DeliverPendingUpdates();
+
+private:
+	IObserver* m_observerPtr;
+
+	typedef QVector<imod::IModel*> Models;
+	Models m_models;
+
+	typedef QMap<imod::IModel*, istd::IChangeable::ChangeSet> PendingChangesMap;
+	PendingChangesMap m_pendingChanges;
+
+	bool m_isDeliveryRequested;
+
+	int m_maxUpdateRate;
+	QTimer m_deliveryTimer;
+	QElapsedTimer m_lastDeliveryTimer;
+
+	qint64 m_receivedUpdatesCount;
+	qint64 m_deliveredUpdatesCount;
+	qint64 m_coalescedUpdatesCount;
+
+	/**
+		Protects model list, pending changes and counters.
+	*/
+	mutable QMutex m_mutex;
+
+	/**
+		Held during delivery, detaching of a model waits for the running delivery.
+		Therefore the target observer should not attach or detach models of this proxy from other threads inside of its update.
+	*/
+#if QT_VERSION >= 0x060000
+	QRecursiveMutex m_deliveryMutex;
+#else
+	QMutex m_deliveryMutex;
+#endif
+};
+
+
+} // namespace imod
+
+
@@ -4,17 +4,78 @@
 
 // Qt includes
 #include <QtCore/QSet>
+#include <QtCore/QThread>
 
 
 namespace imod
 {
 
 
+namespace
+{
+
+
+/**
+	Snapshot entries, whose observers are currently called by this thread.
+	It allows an observer to detach itself from inside of its own notification without waiting for the notification end.
+*/
+thread_local QVector<const void*> s_threadRunningCalls;
+
+
+/**
+	Register running observer call of snapshot entry.
+	\return	\c true if the call can be done, or \c false if the observer was already detached.
+*/
+bool BeginObserverCall(const void* entryPtr, QAtomicInt& isDetached, QAtomicInt& runningCallsCount)
+{
+	runningCallsCount.ref();
+
+	if (isDetached.loadAcquire() != 0){
+		runningCallsCount.deref();
+
+		return false;
+	}
+
+	s_threadRunningCalls.append(entryPtr);
+
+	return true;
+}
+
+
+void EndObserverCall(const void* entryPtr, QAtomicInt& runningCallsCount)
+{
+	int index = s_threadRunningCalls.lastIndexOf(entryPtr);
+	Q_ASSERT(index >= 0);
+
+	s_threadRunningCalls.remove(index);
+
+	runningCallsCount.deref();
+}
+
+
+/**
+	Wait until all calls of the observer done by other threads are finished.
+*/
+void WaitForObserverCalls(const void* entryPtr, QAtomicInt& runningCallsCount)
+{
+	int ownCallsCount = s_threadRunningCalls.count(entryPtr);
+
+	while (runningCallsCount.loadAcquire() > ownCallsCount){
+		QThread::yieldCurrentThread();
+	}
+}
+
+
+} // namespace
+
+
 CModelBase::CModelBase()
-:	m_blockCounter(0),
+:	m_dispatchMode(DM_LOCKED),
+	m_blockCounter(0),
 	m_isDuringChanges(false)
 #if QT_VERSION < 0x060000
 	,m_mutex(QMutex::Recursive)
+	,m_dispatchMutex(QMutex::Recursive)
 #endif
 {
 }
@@ -34,10 +95,32 @@ CModelBase::~CModelBase()
 }
 
 
+bool CModelBase::SetDispatchMode(DispatchMode mode)
+{
+	QMutexLocker lock(&m_mutex);
+
+	if (mode == m_dispatchMode){
+		return true;
+	}
+
+	if (!m_observers.isEmpty() || !m_observersSnapshot.isEmpty() || (m_blockCounter > 0)){
+		return false;
+	}
+
+	m_dispatchMode = mode;
+
+	return true;
+}
+
+
 int CModelBase::GetObserverCount() const
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		return m_observersSnapshot.size();
+	}
+
 	return m_observers.size();
 }
 
@@ -46,6 +129,16 @@ CModelBase::Observers CModelBase::GetObservers() const
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		Observers retVal;
+
+		for (const SnapshotEntryPtr& entryPtr: m_observersSnapshot){
+			retVal.insert(entryPtr->observerPtr);
+		}
+
+		return retVal;
+	}
+
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
 	QList<IObserver*> keys = m_observers.keys();
 
@@ -66,6 +159,12 @@ bool CModelBase::AttachObserver(IObserver* observerPtr)
 		return false;
 	}
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		lock.unlock();
+
+		return AttachSnapshotObserver(observerPtr);
+	}
+
 	Q_ASSERT_X(!m_observers.contains(observerPtr) || (m_observers[observerPtr].state >= AS_DETACHING), "Attaching observer", "Observer is already connected to this model");
 
 	ObserverInfo& info = m_observers[observerPtr];
@@ -98,6 +197,14 @@ void CModelBase::DetachObserver(IObserver* observerPtr)
 
 	Q_ASSERT(observerPtr != NULL);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		lock.unlock();
+
+		DetachSnapshotObserver(observerPtr);
+
+		return;
+	}
+
 	// try to remove from current observer list
 	ObserversMap::Iterator findIter = m_observers.find(observerPtr);
 	if (findIter != m_observers.end()){
@@ -131,6 +238,14 @@ void CModelBase::DetachAllObservers()
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		lock.unlock();
+
+		DetachAllSnapshotObservers();
+
+		return;
+	}
+
 	for (ObserversMap::Iterator iter = m_observers.begin(); iter != m_observers.end(); ++iter){
 		IObserver* observerPtr = iter.key();
 		Q_ASSERT(observerPtr != NULL);
@@ -160,6 +275,16 @@ bool CModelBase::IsAttached(const IObserver* observerPtr) const
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		for (const SnapshotEntryPtr& entryPtr: m_observersSnapshot){
+			if (entryPtr->observerPtr == observerPtr){
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	ObserversMap::ConstIterator findIter = m_observers.constFind(const_cast<IObserver*>(observerPtr));
 	if (findIter != m_observers.end()){
 		const ObserverInfo& info = findIter.value();
@@ -176,13 +301,21 @@ void CModelBase::NotifyBeforeChange(const istd::IChangeable::ChangeSet& changeSe
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		lock.unlock();
+
+		NotifySnapshotBeforeChange(changeSet, isGroup);
+
+		return;
+	}
+
 	Q_ASSERT(m_blockCounter >= 0);
 	Q_ASSERT((m_blockCounter > 0) || !m_isDuringChanges);
 
 	if (changeSet.Contains(istd::IChangeable::CF_ALL_DATA)){
 		const istd::IChangeable::ChangeInfoMap emptyInfoMap;
 		m_cumulatedChangeIds.SetChangeInfoMap(emptyInfoMap);
-		m_cumulatedChangeIds += changeSet.GetIds();
+		m_cumulatedChangeIds.UniteIds(changeSet);
 	}
 
 	m_blockCounter++;
@@ -220,6 +353,14 @@ void CModelBase::NotifyAfterChange(const istd::IChangeable::ChangeSet& changeSet
 {
 	QMutexLocker lock(&m_mutex);
 
+	if (m_dispatchMode == DM_SNAPSHOT){
+		lock.unlock();
+
+		NotifySnapshotAfterChange(changeSet);
+
+		return;
+	}
+
 	Q_ASSERT(m_blockCounter > 0);
 
 	if (changeSet.Contains(istd::IChangeable::CF_ALL_DATA)){
@@ -232,7 +373,7 @@ void CModelBase::NotifyAfterChange(const istd::IChangeable::ChangeSet& changeSet
 		m_cumulatedChangeIds += changeSet;
 	}
 	else{
-		m_cumulatedChangeIds += changeSet.GetIds();
+		m_cumulatedChangeIds.UniteIds(changeSet);
 	}
 
 	// check if we are at end of outer change block
@@ -282,6 +423,230 @@ void CModelBase::CleanupObserverState()
 }
 
 
+bool CModelBase::AttachSnapshotObserver(IObserver* observerPtr)
+{
+	Q_ASSERT_X(!IsAttached(observerPtr), "Attaching observer", "Observer is already connected to this model");
+
+	SnapshotEntryPtr entryPtr(new SnapshotEntry(observerPtr));
+
+	// entry is not published yet, the observer mask can be filled without holding the lock
+	if (!observerPtr->OnModelAttached(this, entryPtr->mask)){
+		return false;
+	}
+
+	// locks are taken in the same order as by notifications,
+	// the dispatch lock is held until the end to be sure that the end of transaction cannot overtake the begin notification
+	QMutexLocker dispatchLock(&m_dispatchMutex);
+	QMutexLocker lock(&m_mutex);
+
+	// published snapshot is shared with running notifications, so appending creates a new copy of the list
+	m_observersSnapshot.append(entryPtr);
+
+	// If the model already sent a notification about the begin of the transaction, do it also for the newly connected observer.
+	bool isUpdating = m_isDuringChanges && m_cumulatedChangeIds.ContainsAny(entryPtr->mask);
+
+	lock.unlock();
+
+	SnapshotEntry& entry = *entryPtr;
+	if (isUpdating && BeginObserverCall(&entry, entry.isDetached, entry.runningCallsCount)){
+		if (entry.isUpdating.testAndSetOrdered(0, 1)){
+			observerPtr->BeforeUpdate(this);
+		}
+
+		EndObserverCall(&entry, entry.runningCallsCount);
+	}
+
+	return true;
+}
+
+
+void CModelBase::DetachSnapshotObserver(IObserver* observerPtr)
+{
+	QMutexLocker lock(&m_mutex);
+
+	SnapshotEntryPtr entryPtr;
+
+	for (int i = 0; i < m_observersSnapshot.size(); ++i){
+		if (m_observersSnapshot.at(i)->observerPtr == observerPtr){
+			entryPtr = m_observersSnapshot.at(i);
+
+			m_observersSnapshot.remove(i);
+
+			break;
+		}
+	}
+
+	if (entryPtr.isNull()){
+		return;
+	}
+
+	entryPtr->isDetached.fetchAndStoreOrdered(1);
+
+	istd::IChangeable::ChangeSet cumulatedChanges = m_cumulatedChangeIds;
+
+	lock.unlock();
+
+	FinishSnapshotObserverDetaching(*entryPtr, cumulatedChanges);
+}
+
+
+void CModelBase::DetachAllSnapshotObservers()
+{
+	QMutexLocker lock(&m_mutex);
+
+	const ObserversSnapshot observers = m_observersSnapshot;
+	m_observersSnapshot.clear();
+
+	for (const SnapshotEntryPtr& entryPtr: observers){
+		entryPtr->isDetached.fetchAndStoreOrdered(1);
+	}
+
+	istd::IChangeable::ChangeSet cumulatedChanges = m_cumulatedChangeIds;
+
+	lock.unlock();
+
+	for (const SnapshotEntryPtr& entryPtr: observers){
+		FinishSnapshotObserverDetaching(*entryPtr, cumulatedChanges);
+	}
+}
+
+
+void CModelBase::NotifySnapshotBeforeChange(const istd::IChangeable::ChangeSet& changeSet, bool isGroup)
+{
+	QMutexLocker dispatchLock(&m_dispatchMutex);
+	QMutexLocker lock(&m_mutex);
+
+	Q_ASSERT(m_blockCounter >= 0);
+
+	if (changeSet.Contains(istd::IChangeable::CF_ALL_DATA)){
+		const istd::IChangeable::ChangeInfoMap emptyInfoMap;
+		m_cumulatedChangeIds.SetChangeInfoMap(emptyInfoMap);
+		m_cumulatedChangeIds.UniteIds(changeSet);
+	}
+
+	m_blockCounter++;
+
+	if (changeSet.IsEmpty() || isGroup){
+		return;
+	}
+
+	bool isFirstChange = !m_isDuringChanges;
+	m_isDuringChanges = true;
+
+	const ObserversSnapshot observers = m_observersSnapshot;
+
+	lock.unlock();
+
+	for (const SnapshotEntryPtr& entryPtr: observers){
+		SnapshotEntry& entry = *entryPtr;
+
+		if (changeSet.ContainsAny(entry.mask) && BeginObserverCall(&entry, entry.isDetached, entry.runningCallsCount)){
+			if (entry.isUpdating.testAndSetOrdered(0, 1)){
+				entry.observerPtr->BeforeUpdate(this);
+			}
+
+			EndObserverCall(&entry, entry.runningCallsCount);
+		}
+	}
+
+	if (isFirstChange){
+		OnBeginGlobalChanges();
+	}
+}
+
+
+void CModelBase::NotifySnapshotAfterChange(const istd::IChangeable::ChangeSet& changeSet)
+{
+	QMutexLocker dispatchLock(&m_dispatchMutex);
+	QMutexLocker lock(&m_mutex);
+
+	Q_ASSERT(m_blockCounter > 0);
+
+	if (changeSet.Contains(istd::IChangeable::CF_ALL_DATA)){
+		const istd::IChangeable::ChangeInfoMap emptyInfoMap;
+		m_cumulatedChangeIds.SetChangeInfoMap(emptyInfoMap);
+		m_cumulatedChangeIds += istd::IChangeable::CF_ALL_DATA;
+	}
+
+	if (!m_cumulatedChangeIds.Contains(istd::IChangeable::CF_ALL_DATA)){
+		m_cumulatedChangeIds += changeSet;
+	}
+	else{
+		m_cumulatedChangeIds.UniteIds(changeSet);
+	}
+
+	// check if we are at end of outer change block
+	if (--m_blockCounter > 0){
+		return;	// no, it is not outer change block, nothing to do
+	}
+
+	const istd::IChangeable::ChangeSet cumulatedChanges = m_cumulatedChangeIds;
+	bool wasDuringChanges = m_isDuringChanges;
+
+	// we leave the outer block with clean state, so the observers can start new transactions
+	m_isDuringChanges = false;
+	m_cumulatedChangeIds.Reset();
+
+	if (!wasDuringChanges){
+		return;
+	}
+
+	const ObserversSnapshot observers = m_observersSnapshot;
+
+	lock.unlock();
+
+	OnEndGlobalChanges(cumulatedChanges);
+
+	// Claim all pending updates first, so a transaction started from an observer callback sees clean observer states.
+	QVector<SnapshotEntry*> updatingEntries;
+	for (const SnapshotEntryPtr& entryPtr: observers){
+		SnapshotEntry& entry = *entryPtr;
+
+		if (BeginObserverCall(&entry, entry.isDetached, entry.runningCallsCount)){
+			if (entry.isUpdating.testAndSetOrdered(1, 0)){
+				updatingEntries.append(&entry);
+			}
+			else{
+				EndObserverCall(&entry, entry.runningCallsCount);
+			}
+		}
+	}
+
+	for (SnapshotEntry* entryPtr: updatingEntries){
+		// skip observers detached from other callbacks in this thread, they were already informed about detaching
+		if (entryPtr->isDetached.loadAcquire() == 0){
+			entryPtr->observerPtr->AfterUpdate(this, cumulatedChanges);
+		}
+
+		EndObserverCall(entryPtr, entryPtr->runningCallsCount);
+	}
+}
+
+
+void CModelBase::FinishSnapshotObserverDetaching(SnapshotEntry& entry, const istd::IChangeable::ChangeSet& changeSet)
+{
+	// grace period: notifications of this observer started before detaching must be finished
+	WaitForObserverCalls(&entry, entry.runningCallsCount);
+
+	if (entry.isUpdating.testAndSetOrdered(1, 0)){
+		entry.observerPtr->AfterUpdate(this, changeSet);
+	}
+
+	entry.observerPtr->OnModelDetached(this);
+}
+
+
+// public methods of embedded class SnapshotEntry
+
+CModelBase::SnapshotEntry::SnapshotEntry(IObserver* observerPtr)
+:	observerPtr(observerPtr),
+	isDetached(0),
+	isUpdating(0),
+	runningCallsCount(0)
+{
+}
+
+
 } // namespace imod
 
 
@@ -5,6 +5,9 @@
 // Qt includes
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
+#include <QtCore/QVector>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QAtomicInt>
 
 // ACF includes
 #include <imod/imod.h>
@@ -19,6 +22,14 @@ namespace imod
 /**
 	Basic implementation of a model.
 
+	The model supports two dispatch modes of the observer notifications:
+	- \c DM_LOCKED (default) holds the model lock during the whole notification.
+	- \c DM_SNAPSHOT publishes the observer list as an immutable, reference-counted snapshot.
+	Notifications iterate over the snapshot without holding the model lock,
+	attaching and detaching of observers is a copy-on-write replacement of the published snapshot.
+	\c DetachObserver waits until the notifications of the detached observer still running in other threads are finished (grace period),
+	so the observer can be safely destroyed after detaching.
+
 	\ingroup ModelObserver
 */
 class CModelBase: virtual public imod::IModel
@@ -26,9 +37,35 @@ class CModelBase: virtual public imod::IModel
 public:
 	typedef QSet<IObserver*> Observers;
 
+	/**
+		Mode of observer notification dispatching.
+	*/
+	enum DispatchMode
+	{
+		/**
+			Observers are notified under the model lock.
+		*/
+		DM_LOCKED,
+		/**
+			Observers are notified using a snapshot of the observer list without holding the model lock.
+		*/
+		DM_SNAPSHOT
+	};
+
 	CModelBase();
 	virtual ~CModelBase();
 
+	/**
+		Get current dispatch mode of observer notifications.
+	*/
+	DispatchMode GetDispatchMode() const;
+	/**
+		Set dispatch mode of observer notifications.
+		Dispatch mode can be changed only if no observer is connected and no change transaction is running.
+		\return	\c true, if the mode was set.
+	*/
+	bool SetDispatchMode(DispatchMode mode);
+
 	/**
 		Returns count of connected observers.
 	*/
@@ -73,6 +110,16 @@ private:
 
 	void CleanupObserverState();
 
+	struct SnapshotEntry;
+
+	// snapshot dispatch mode implementation
+	bool AttachSnapshotObserver(imod::IObserver* observerPtr);
+	void DetachSnapshotObserver(imod::IObserver* observerPtr);
+	void DetachAllSnapshotObservers();
+	void NotifySnapshotBeforeChange(const istd::IChangeable::ChangeSet& changeSet, bool isGroup);
+	void NotifySnapshotAfterChange(const istd::IChangeable::ChangeSet& changeSet);
+	void FinishSnapshotObserverDetaching(SnapshotEntry& entry, const istd::IChangeable::ChangeSet& changeSet);
+
 private:
 	/**
 		Observer connection state.
@@ -112,20 +159,69 @@ private:
 	typedef QMap<IObserver*, ObserverInfo> ObserversMap;
 	ObserversMap m_observers;
 
+	/**
+		Observer connection used in snapshot dispatch mode.
+		Entries are shared between published snapshots, only the atomic members can be changed after publishing.
+	*/
+	struct SnapshotEntry
+	{
+		SnapshotEntry(IObserver* observerPtr);
+
+		IObserver* const observerPtr;
+		istd::IChangeable::ChangeSet mask;
+		/**
+			Set to 1 when the observer was detached, no new notifications will be started then.
+		*/
+		QAtomicInt isDetached;
+		/**
+			Set to 1 when \c BeforeUpdate was sent and the matching \c AfterUpdate is pending.
+			The party resetting it to 0 is responsible for sending \c AfterUpdate.
+		*/
+		QAtomicInt isUpdating;
+		/**
+			Number of observer notification calls currently running for this entry.
+		*/
+		QAtomicInt runningCallsCount;
+	};
+
+	typedef QSharedPointer<SnapshotEntry> SnapshotEntryPtr;
+	/**
+		Published list of observers.
+		It is implicitly shared and never modified in place, each change creates a new list.
+	*/
+	typedef QVector<SnapshotEntryPtr> ObserversSnapshot;
+
+	DispatchMode m_dispatchMode;
+	ObserversSnapshot m_observersSnapshot;
+
 	int m_blockCounter;
 	bool m_isDuringChanges;
 	istd::IChangeable::ChangeSet m_cumulatedChangeIds;
 
 #if QT_VERSION >= 0x060000
 	mutable QRecursiveMutex m_mutex;
+	/**
+		Serializes notification phases in snapshot mode, it is locked before \c m_mutex.
+		Attaching of observers locks it to get consistent begin notification, detaching never locks it.
+	*/
+	QRecursiveMutex m_dispatchMutex;
 #else
 	mutable QMutex m_mutex;
+	QMutex m_dispatchMutex;
 #endif
 };
 
 
 // public inline methods
 
+inline CModelBase::DispatchMode CModelBase::GetDispatchMode() const
+{
+	QMutexLocker lock(&m_mutex);
+
+	return m_dispatchMode;
+}
+
+
 inline istd::IChangeable::ChangeSet CModelBase::GetCumulatedChanges() const
 {
 	QMutexLocker lock(&m_mutex);
@@ -105,6 +105,12 @@ bool CPackagesLoaderComp::LoadPackages(const QString& configFilePath)
 	qDeleteAll(m_ownedPackageInfos);
 	m_ownedPackageInfos.clear();
 
+	{
+		QMutexLocker lock(&m_lazyLoadingMutex);
+
+		m_lazyPackageIds.clear();
+	}
+
 	bool retVal = LoadConfigFile(m_configFilePath);
 
 	return retVal;
@@ -235,6 +241,24 @@ icomp::IComponentListProvider::ComponentAddresses CPackagesLoaderComp::GetCompon
 }
 
 
+// reimplemented (icomp::IMetaInfoManager)
+
+const icomp::IComponentStaticInfo* CPackagesLoaderComp::GetComponentMetaInfo(const icomp::CComponentAddress& address) const
+{
+	if (!IsLazyLoadingEnabled()){
+		return BaseClass2::GetComponentMetaInfo(address);
+	}
+
+	QMutexLocker lock(&m_lazyLoadingMutex);
+
+	if (m_lazyPackageIds.contains(address.GetPackageId())){
+		const_cast<CPackagesLoaderComp*>(this)->EnsurePackageLoaded(address.GetPackageId());
+	}
+
+	return BaseClass2::GetComponentMetaInfo(address);
+}
+
+
 // reimplemented (icomp::CComponentBase)
 
 void CPackagesLoaderComp::OnComponentCreated()
@@ -267,7 +291,13 @@ bool CPackagesLoaderComp::RegisterPackageFile(const QString& file)
 		RealPackagesMap::ConstIterator foundIter = m_realPackagesMap.constFind(packageId);
 		if (foundIter == m_realPackagesMap.constEnd()){
 			// Try loading from cache first to avoid DLL loading
-			if (m_cacheEnabledAttrPtr.IsValid() && *m_cacheEnabledAttrPtr && TryLoadFromCache(fileInfo, packageId)){
+			if (IsCacheUsed() && TryLoadFromCache(fileInfo, packageId)){
+				if (IsLazyLoadingEnabled()){
+					QMutexLocker lock(&m_lazyLoadingMutex);
+
+					m_lazyPackageIds.insert(packageId);
+				}
+
 				return true;
 			}
 
@@ -280,7 +310,7 @@ bool CPackagesLoaderComp::RegisterPackageFile(const QString& file)
 					RegisterEmbeddedComponentInfo(packageId, infoPtr);
 
 					// Save to cache for next time
-					if (m_cacheEnabledAttrPtr.IsValid() && *m_cacheEnabledAttrPtr){
+					if (IsCacheUsed()){
 						SavePackageToCache(fileInfo, infoPtr);
 					}
 
@@ -498,6 +528,46 @@ icomp::GetPackageInfoFunc CPackagesLoaderComp::GetPackageFunction(const QFileInf
 }
 
 
+bool CPackagesLoaderComp::IsCacheUsed() const
+{
+	return (m_cacheEnabledAttrPtr.IsValid() && *m_cacheEnabledAttrPtr) || IsLazyLoadingEnabled();
+}
+
+
+bool CPackagesLoaderComp::IsLazyLoadingEnabled() const
+{
+	return m_lazyLoadingEnabledAttrPtr.IsValid() && *m_lazyLoadingEnabledAttrPtr;
+}
+
+
+bool CPackagesLoaderComp::EnsurePackageLoaded(const QByteArray& packageId)
+{
+	PackageIds::Iterator foundIter = m_lazyPackageIds.find(packageId);
+	if (foundIter == m_lazyPackageIds.end()){
+		return true;
+	}
+
+	m_lazyPackageIds.erase(foundIter);
+
+	QFileInfo fileInfo(m_realPackagesMap.value(packageId));
+
+	icomp::GetPackageInfoFunc getInfoPtr = GetPackageFunction(fileInfo);
+	if (getInfoPtr != NULL){
+		icomp::CPackageStaticInfo* infoPtr = getInfoPtr();
+		if (infoPtr != NULL){
+			// cached meta-info stays owned by this component, because it can still be referenced
+			RegisterEmbeddedComponentInfo(packageId, infoPtr);
+
+			SendVerboseMessage(tr("Package library loaded on demand: %1").arg(fileInfo.canonicalFilePath()));
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
 // public methods of embedded class LogingRegistry
 
 CPackagesLoaderComp::LogingRegistry::LogingRegistry(CPackagesLoaderComp* parentPtr)
@@ -561,7 +631,7 @@ bool CPackagesLoaderComp::TryLoadFromCache(const QFileInfo& fileInfo, const QByt
 				canonicalPath,
 				cacheDir);
 
-	// Strategy 1: Combined validation + loading in a single file read
+	// Cache file is mapped into memory and validated, component meta-info is read in place on demand
 	icomp::CPackageStaticInfo* cachedInfo = icomp::CPackageMetaInfoCache::LoadFromCacheIfValid(canonicalPath, cacheFilePath);
 	if (cachedInfo == NULL){
 		return false;
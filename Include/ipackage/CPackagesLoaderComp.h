@@ -7,6 +7,8 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
 #include <QtCore/QLibrary>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
 
 // ACF includes
 #include <istd/TDelPtr.h>
@@ -27,6 +29,10 @@ namespace ipackage
 
 /**
 	Loads component packages from dynamic link libraries.
+
+	If lazy loading is enabled, the meta-information of the packages having a valid cache file is taken from the cache
+	and the package library is loaded first time some component of this package is requested using \c GetComponentMetaInfo.
+	This mode reduces start time and memory usage of applications using only small part of the configured packages.
 */
 class CPackagesLoaderComp:
 			public QObject,
@@ -57,6 +63,7 @@ public:
 		I_ASSIGN(m_configFilePathCompPtr, "ConfigFilePath", "Path of packages configuration file will be loaded, if enabled", false, "ConfigFilePath");
 		I_ASSIGN(m_cacheEnabledAttrPtr, "CacheEnabled", "Enable package meta-info caching to avoid loading DLLs for meta-info extraction", true, false);
 		I_ASSIGN(m_cacheDirAttrPtr, "CacheDir", "Directory for cache files, if empty cache files are stored in .acf.cache subdirectory next to the packages", false, "");
+		I_ASSIGN(m_lazyLoadingEnabledAttrPtr, "LazyLoadingEnabled", "Use cached package meta-info and load package libraries first when some of its components is needed", true, false);
 	I_END_COMPONENT;
 
 	// reimplemented (icomp::IRegistryLoader)
@@ -78,6 +85,9 @@ public:
 	// reimplemented (icomp::IComponentListProvider)
 	virtual ComponentAddresses GetComponentAddresses(int typeFlag = CTF_ALL) const override;
 
+	// reimplemented (icomp::IMetaInfoManager)
+	virtual const icomp::IComponentStaticInfo* GetComponentMetaInfo(const icomp::CComponentAddress& address) const override;
+
 	// reimplemented (icomp::CComponentBase)
 	virtual void OnComponentCreated() override;
 
@@ -121,6 +131,24 @@ protected:
 	*/
 	void SavePackageToCache(const QFileInfo& fileInfo, const icomp::CPackageStaticInfo* packageInfo);
 
+	/**
+		Check if package meta-info cache should be used.
+	*/
+	bool IsCacheUsed() const;
+
+	/**
+		Check if lazy loading of packages is enabled.
+	*/
+	bool IsLazyLoadingEnabled() const;
+
+	/**
+		Load library of package registered using cached meta-info only.
+		Meta-info of the package is replaced by the one provided by the package library.
+		It must be called with locked \c m_lazyLoadingMutex.
+		\return	true, if the package library is loaded or it was not registered lazily.
+	*/
+	bool EnsurePackageLoaded(const QByteArray& packageId);
+
 private:
 	typedef QMap<QString, icomp::GetPackageInfoFunc> LibraryToInfoFuncMap;
 	LibraryToInfoFuncMap m_libraryToInfoFuncMap;
@@ -166,12 +194,24 @@ private:
 
 	I_ATTR(bool, m_cacheEnabledAttrPtr);
 	I_ATTR(QString, m_cacheDirAttrPtr);
+	I_ATTR(bool, m_lazyLoadingEnabledAttrPtr);
 
 	/**
 		Owned package static info objects created from cache.
 	*/
 	typedef QList<icomp::CPackageStaticInfo*> OwnedPackageInfos;
 	OwnedPackageInfos m_ownedPackageInfos;
+
+	/**
+		IDs of packages registered from cache, whose libraries were not loaded yet.
+	*/
+	typedef QSet<QByteArray> PackageIds;
+	PackageIds m_lazyPackageIds;
+
+	/**
+		Protects loading of lazy packages.
+	*/
+	mutable QMutex m_lazyLoadingMutex;
 };
 
 
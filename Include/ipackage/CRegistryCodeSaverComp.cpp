@@ -444,6 +444,12 @@ bool CRegistryCodeSaverComp::WriteHeader(
 
 	NextLine(stream);
 	stream << "using BaseClass::EnsureAutoInitComponentsCreated;";
+	NextLine(stream);
+	stream << "using BaseClass::SetParallelInstantiationEnabled;";
+	NextLine(stream);
+	stream << "using BaseClass::IsParallelInstantiationEnabled;";
+	NextLine(stream);
+	stream << "using BaseClass::GetCreationProfile;";
 	stream << "\n";
 
 	ChangeIndent(-1);
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <ipackage/Test/CPackagesLoaderBenchmarkTest.h>
+
+
+// Qt includes
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+// ACF includes
+#include <icomp/TSimComponentWrap.h>
+#include <icomp/IRealComponentStaticInfo.h>
+#include <ifile/TFileSerializerComp.h>
+#include <ifile/CCompactXmlFileReadArchive.h>
+#include <ifile/CCompactXmlFileWriteArchive.h>
+#include <ipackage/CPackagesLoaderComp.h>
+
+
+namespace
+{
+
+
+typedef ifile::TFileSerializerComp<ifile::CCompactXmlFileReadArchive, ifile::CCompactXmlFileWriteArchive> CompactXmlSerializer;
+
+
+/**
+	Packages loader with all components needed for its work.
+*/
+struct PackagesLoader
+{
+	icomp::TSimSharedComponentPtr<CompactXmlSerializer> registrySerializerComp;
+	icomp::TSimSharedComponentPtr<ipackage::CPackagesLoaderComp> packagesLoaderComp;
+
+	PackagesLoader(const QString& cacheDir, bool isLazy)
+	{
+		registrySerializerComp->InsertMultiAttr("FileExtensions", QString("acc"));
+		registrySerializerComp->InitComponent();
+
+		packagesLoaderComp->SetRef("RegistryLoader", registrySerializerComp);
+		packagesLoaderComp->SetBoolAttr("CacheEnabled", true);
+		packagesLoaderComp->SetStringAttr("CacheDir", cacheDir);
+		packagesLoaderComp->SetBoolAttr("LazyLoadingEnabled", isLazy);
+		packagesLoaderComp->InitComponent();
+	}
+};
+
+
+} // namespace
+
+
+// protected slots
+
+void CPackagesLoaderBenchmarkTest::initTestCase()
+{
+	QVERIFY(m_tempDir.isValid());
+
+	QDir packagesDir(QCoreApplication::applicationDirPath());
+	m_arePackagesFound = !packagesDir.entryList(QStringList() << "*.arp", QDir::Files).isEmpty();
+
+	m_configFilePath = m_tempDir.filePath("PackagesLoaderTest.awc");
+
+	QFile configFile(m_configFilePath);
+	QVERIFY(configFile.open(QIODevice::WriteOnly | QIODevice::Text));
+
+	QTextStream stream(&configFile);
+	stream << "<Acf>\n";
+	stream << "\t<ConfigFiles/>\n";
+	stream << "\t<PackageDirs>\n";
+	stream << "\t\t<Dir>" << packagesDir.absolutePath() << "</Dir>\n";
+	stream << "\t</PackageDirs>\n";
+	stream << "\t<PackageFiles/>\n";
+	stream << "\t<RegistryFiles/>\n";
+	stream << "</Acf>\n";
+}
+
+
+void CPackagesLoaderBenchmarkTest::LazyLoadingTest()
+{
+	if (!m_arePackagesFound){
+		QSKIP("No component packages found next to the test executable");
+	}
+
+	QString cacheDir = m_tempDir.filePath("LazyLoadingCache");
+
+	// eager loading creates the cache files
+	PackagesLoader eagerLoader(cacheDir, false);
+	QVERIFY(eagerLoader.packagesLoaderComp->LoadPackages(m_configFilePath));
+
+	icomp::IComponentListProvider::ComponentAddresses eagerAddresses = eagerLoader.packagesLoaderComp->GetComponentAddresses(icomp::IComponentListProvider::CTF_REAL);
+	QVERIFY(!eagerAddresses.isEmpty());
+
+	PackagesLoader lazyLoader(cacheDir, true);
+	QVERIFY(lazyLoader.packagesLoaderComp->LoadPackages(m_configFilePath));
+
+	// component index is built from the cache only
+	icomp::IComponentListProvider::ComponentAddresses lazyAddresses = lazyLoader.packagesLoaderComp->GetComponentAddresses(icomp::IComponentListProvider::CTF_REAL);
+	QCOMPARE(lazyAddresses, eagerAddresses);
+
+	// package library is loaded when meta-info of some component is needed
+	const icomp::CComponentAddress& address = *lazyAddresses.constBegin();
+	QCOMPARE(lazyLoader.packagesLoaderComp->GetPackageType(address.GetPackageId()), int(icomp::IPackagesManager::PT_REAL));
+
+	const icomp::IComponentStaticInfo* componentInfoPtr = lazyLoader.packagesLoaderComp->GetComponentMetaInfo(address);
+	QVERIFY(componentInfoPtr != NULL);
+	QVERIFY(dynamic_cast<const icomp::IRealComponentStaticInfo*>(componentInfoPtr) != NULL);
+}
+
+
+void CPackagesLoaderBenchmarkTest::LoadPackagesBenchmark_data()
+{
+	QTest::addColumn<bool>("isLazy");
+
+	QTest::newRow("eager") << false;
+	QTest::newRow("lazy") << true;
+}
+
+
+void CPackagesLoaderBenchmarkTest::LoadPackagesBenchmark()
+{
+	if (!m_arePackagesFound){
+		QSKIP("No component packages found next to the test executable");
+	}
+
+	QFETCH(bool, isLazy);
+
+	PackagesLoader loader(m_tempDir.filePath("BenchmarkCache"), isLazy);
+
+	// first loading writes the cache
+	QVERIFY(loader.packagesLoaderComp->LoadPackages(m_configFilePath));
+
+	QBENCHMARK{
+		loader.packagesLoaderComp->LoadPackages(m_configFilePath);
+	}
+}
+
+
+void CPackagesLoaderBenchmarkTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CPackagesLoaderBenchmarkTest);
+
+
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Comparison of eager and lazy loading of component packages.
+	Packages placed next to the test executable are used, the test is skipped if there are no packages.
+*/
+class CPackagesLoaderBenchmarkTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void LazyLoadingTest();
+	void LoadPackagesBenchmark_data();
+	void LoadPackagesBenchmark();
+
+	void cleanupTestCase();
+
+private:
+	QTemporaryDir m_tempDir;
+	QString m_configFilePath;
+	bool m_arePackagesFound = false;
+};
+
+
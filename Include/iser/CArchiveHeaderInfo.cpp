@@ -25,12 +25,26 @@ static const CArchiveTag s_versionNumberTag("Number", "Version number", CArchive
 static const CArchiveTag s_versionDescriptionTag("Description", "Version description", CArchiveTag::TT_LEAF, &s_versionInfoTag);
 
 
+CArchiveHeaderInfo::CArchiveHeaderInfo()
+:	m_archiveFormatVersion(AFV_CLASSIC)
+{
+}
+
+
+quint32 CArchiveHeaderInfo::GetArchiveFormatVersion() const
+{
+	return m_archiveFormatVersion;
+}
+
+
 void CArchiveHeaderInfo::Reset()
 {
 	istd::CChangeNotifier notifier(this, &versionChangeIds);
 	Q_UNUSED(notifier);
 
 	m_versionIdList.clear();
+
+	m_archiveFormatVersion = AFV_CLASSIC;
 }
 
 
@@ -59,9 +73,11 @@ bool CArchiveHeaderInfo::RemoveVersionId(int versionId)
 bool CArchiveHeaderInfo::SerializeArchiveHeader(IArchive& archive)
 {
 	if (archive.IsStoring()){
-		return WriteArchiveHeader(archive, this);
+		return WriteArchiveHeader(archive, this, m_archiveFormatVersion);
 	}
 
+	m_archiveFormatVersion = AFV_CLASSIC;
+
 	bool retVal = archive.BeginTag(s_headerTag);
 
 	int versionIdsCount = 0;
@@ -92,7 +108,12 @@ bool CArchiveHeaderInfo::SerializeArchiveHeader(IArchive& archive)
 			return false;
 		}
 
-		InsertVersionId(id, version, description);
+		if (id == ArchiveFormatVersionId){
+			m_archiveFormatVersion = version;
+		}
+		else{
+			InsertVersionId(id, version, description);
+		}
 
 		retVal = retVal && archive.EndTag(s_versionInfoTag);
 	}
@@ -105,7 +126,7 @@ bool CArchiveHeaderInfo::SerializeArchiveHeader(IArchive& archive)
 }
 
 
-bool CArchiveHeaderInfo::WriteArchiveHeader(IArchive& archive, const IVersionInfo* versionInfoPtr)
+bool CArchiveHeaderInfo::WriteArchiveHeader(IArchive& archive, const IVersionInfo* versionInfoPtr, quint32 archiveFormatVersion)
 {
 	Q_ASSERT(archive.IsStoring());
 	if (!archive.IsStoring()){
@@ -120,7 +141,15 @@ bool CArchiveHeaderInfo::WriteArchiveHeader(IArchive& archive, const IVersionInf
 		ids = versionInfoPtr->GetVersionIds();
 	}
 
+	// reserved ID, it is written only for non classic formats
+	ids.remove(ArchiveFormatVersionId);
+
+	bool writeFormatVersion = (archiveFormatVersion > AFV_CLASSIC);
+
 	int versionIdsCount = int(ids.size());
+	if (writeFormatVersion){
+		++versionIdsCount;
+	}
 
 	retVal = retVal && archive.BeginMultiTag(s_versionInfosTag, s_versionInfoTag, versionIdsCount);
 
@@ -164,6 +193,28 @@ bool CArchiveHeaderInfo::WriteArchiveHeader(IArchive& archive, const IVersionInf
 		retVal = retVal && archive.EndTag(s_versionInfoTag);
 	}
 
+	if (writeFormatVersion){
+		int id = ArchiveFormatVersionId;
+		quint32 versionNumber = archiveFormatVersion;
+		QString description = "ACF archive format";
+
+		retVal = retVal && archive.BeginTag(s_versionInfoTag);
+
+		retVal = retVal && archive.BeginTag(s_versionIdTag);
+		retVal = retVal && archive.Process(id);
+		retVal = retVal && archive.EndTag(s_versionIdTag);
+
+		retVal = retVal && archive.BeginTag(s_versionNumberTag);
+		retVal = retVal && archive.Process(versionNumber);
+		retVal = retVal && archive.EndTag(s_versionNumberTag);
+
+		retVal = retVal && archive.BeginTag(s_versionDescriptionTag);
+		retVal = retVal && archive.Process(description);
+		retVal = retVal && archive.EndTag(s_versionDescriptionTag);
+
+		retVal = retVal && archive.EndTag(s_versionInfoTag);
+	}
+
 	retVal = retVal && archive.EndTag(s_versionInfosTag);
 
 	retVal = retVal && archive.EndTag(s_headerTag);
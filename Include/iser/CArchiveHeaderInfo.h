@@ -30,6 +30,32 @@ public:
 		CF_VERSIONS_UPDATED = 0xb6eca0
 	};
 
+	/**
+		Version of the archive container format.
+		It is stored in the header using the reserved version ID \c iser::IVersionInfo::ArchiveFormatVersionId,
+		archives without this entry have the classic format.
+		The format version is not part of the version list provided by this object.
+	*/
+	enum ArchiveFormatVersion
+	{
+		/**
+			Classic format, binary archives store tag end positions as 32-bit offsets directly after the tag begin.
+		*/
+		AFV_CLASSIC = 1,
+		/**
+			Binary archives store tag end positions as 64-bit offsets in a skip index at the end of the archive.
+		*/
+		AFV_SKIP_INDEX = 2
+	};
+
+	CArchiveHeaderInfo();
+
+	/**
+		Get version of the archive container format read from the header.
+		\sa ArchiveFormatVersion.
+	*/
+	quint32 GetArchiveFormatVersion() const;
+
 	/**
 		Remove all stored version infos.
 	*/
@@ -49,7 +75,12 @@ public:
 	bool RemoveVersionId(int versionId);
 
 	bool SerializeArchiveHeader(IArchive& archive);
-	static bool WriteArchiveHeader(IArchive& archive, const IVersionInfo* versionInfoPtr);
+	/**
+		Write the archive header.
+		\param	archiveFormatVersion	version of the archive container format, \sa ArchiveFormatVersion.
+										For the classic format no format entry will be written.
+	*/
+	static bool WriteArchiveHeader(IArchive& archive, const IVersionInfo* versionInfoPtr, quint32 archiveFormatVersion = AFV_CLASSIC);
 
 	// reimplemented (iser::IVersionInfo)
 	virtual VersionIds GetVersionIds() const override;
@@ -71,6 +102,8 @@ private:
 	typedef QMap<int, VersionIdElement> VersionElements;
 
 	VersionElements m_versionIdList;
+
+	quint32 m_archiveFormatVersion;
 };
 
 
@@ -2,6 +2,9 @@
 #pragma once
 
 
+// STL includes
+#include <type_traits>
+
 // ACF includes
 #include <iser/CReadArchiveBase.h>
 
@@ -23,6 +26,16 @@ public:
 		MI_STRING_TOO_LONG = 0x3f320b0
 	};
 
+	/**
+		Read array of values of plain data type as one contiguous block.
+		Only the data is read, the number of elements must be known by the caller.
+		The binary representation is identical to the representation of the elements processed one by one.
+		\param	valuesPtr	pointer to the first element of the destination array.
+		\param	count		number of elements.
+	*/
+	template <typename Value>
+	bool ProcessArray(Value* valuesPtr, int count);
+
 	// reimplemented (iser::IArchive)
 	virtual bool BeginTag(const CArchiveTag& tag) override;
 	virtual bool EndTag(const CArchiveTag& tag) override;
@@ -49,6 +62,25 @@ protected:
 };
 
 
+// public template methods
+
+template <typename Value>
+bool CBinaryReadArchiveBase::ProcessArray(Value* valuesPtr, int count)
+{
+	static_assert(std::is_trivially_copyable<Value>::value, "Only plain data types can be processed as array");
+
+	if (count <= 0){
+		return true;
+	}
+
+	if (valuesPtr == NULL){
+		return false;
+	}
+
+	return ProcessData((void*)valuesPtr, count * int(sizeof(Value)));
+}
+
+
 } // namespace iser
 
 
@@ -2,6 +2,9 @@
 #pragma once
 
 
+// STL includes
+#include <type_traits>
+
 // ACF includes
 #include <iser/CWriteArchiveBase.h>
 
@@ -18,6 +21,16 @@ class CBinaryWriteArchiveBase: public CWriteArchiveBase
 public:
 	typedef CWriteArchiveBase BaseClass;
 
+	/**
+		Write array of values of plain data type as one contiguous block.
+		Only the data is written, the number of elements must be stored separately, if needed.
+		The binary representation is identical to the representation of the elements processed one by one.
+		\param	valuesPtr	pointer to the first element.
+		\param	count		number of elements.
+	*/
+	template <typename Value>
+	bool ProcessArray(Value* valuesPtr, int count);
+
 	// reimplemented (iser::IArchive)
 	virtual bool BeginTag(const CArchiveTag& tag) override;
 	virtual bool EndTag(const CArchiveTag& tag) override;
@@ -41,6 +54,25 @@ protected:
 };
 
 
+// public template methods
+
+template <typename Value>
+bool CBinaryWriteArchiveBase::ProcessArray(Value* valuesPtr, int count)
+{
+	static_assert(std::is_trivially_copyable<Value>::value, "Only plain data types can be processed as array");
+
+	if (count <= 0){
+		return true;
+	}
+
+	if (valuesPtr == NULL){
+		return false;
+	}
+
+	return ProcessData((void*)valuesPtr, count * int(sizeof(Value)));
+}
+
+
 } // namespace iser
 
 
@@ -16,6 +16,9 @@ CBitMemoryReadArchive::CBitMemoryReadArchive(const QVector<quint8>& data, bool s
 :	BaseClass(&data[0], data.size(), serializeHeader)	
 {
 	m_bitPosition = 0;
+
+	// bits are read using own ProcessData
+	m_isDirectReadEnabled = false;
 }
 
 
@@ -23,6 +26,9 @@ CBitMemoryReadArchive::CBitMemoryReadArchive(const void* bufferPtr, int bufferSi
 	:BaseClass(bufferPtr, bufferSize, serializeHeader)	
 {
 	m_bitPosition = 0;
+
+	// bits are read using own ProcessData
+	m_isDirectReadEnabled = false;
 }
 
 
@@ -30,6 +36,9 @@ CBitMemoryReadArchive::CBitMemoryReadArchive(const CMemoryWriteArchive& writeArc
 	:BaseClass(writeArchive, serializeHeader)	
 {
 	m_bitPosition = 0;
+
+	// bits are read using own ProcessData
+	m_isDirectReadEnabled = false;
 }
 
 
@@ -2,13 +2,6 @@
 #include <iser/CCompactXmlMemReadArchive.h>
 
 
-// include STL
-#include <cstring>
-
-// Qt includes
-#include <QtCore/QFile>
-#include <QtXml/QDomNodeList>
-
 
 namespace iser
 {
@@ -42,7 +35,7 @@ void CCompactXmlMemReadArchive::DecorateMessage(
 {
 	BaseClass::DecorateMessage(category, id, flags, message, messageSource);
 
-	int lineNumber = m_currentParent.lineNumber();
+	int lineNumber = GetCurrentLineNumber();
 	if (lineNumber >= 0){
 		message = QObject::tr("%1 (Line: %2)").arg(message).arg(lineNumber);
 	}
@@ -4,8 +4,6 @@
 
 // Qt includes
 #include <QtCore/QBuffer>
-#include <QtXml/QDomDocument>
-#include <QtXml/QDomNode>
 
 // ACF includes
 #include <iser/CCompactXmlReadArchiveBase.h>
@@ -2,12 +2,8 @@
 #include <iser/CCompactXmlReadArchiveBase.h>
 
 
-// include STL
-#include <cstring>
-
 // Qt includes
-#include <QtCore/QFile>
-#include <QtXml/QDomNodeList>
+#include <QtCore/QStringList>
 
 
 namespace iser
@@ -17,7 +13,9 @@ namespace iser
 CCompactXmlReadArchiveBase::CCompactXmlReadArchiveBase(
 			bool serializeHeader,
 			const iser::CArchiveTag& rootTag)
-:	m_serializeHeader(serializeHeader),
+:	m_nextElementIndex(0),
+	m_isDocumentScanned(false),
+	m_serializeHeader(serializeHeader),
 	m_rootTag(rootTag),
 	m_isNewFormat(true),
 	m_allowAttribute(false)
@@ -57,11 +55,7 @@ bool CCompactXmlReadArchiveBase::BeginTag(const iser::CArchiveTag& tag)
 		}
 	}
 
-	QDomElement element = m_currentParent.firstChildElement(tagId);
-	if (!element.isNull()){
-		m_currentParent = element;
-	}
-	else{
+	if (!OpenChildElement(tagId)){
 		if (IsLogConsumed()){
 			SendLogMessage(
 						istd::IInformationProvider::IC_ERROR,
@@ -86,11 +80,7 @@ bool CCompactXmlReadArchiveBase::BeginMultiTag(const iser::CArchiveTag& tag, con
 {
 	QString tagId(tag.GetId());
 
-	QDomElement element = m_currentParent.firstChildElement(tagId);
-	if (!element.isNull()){
-		m_currentParent = element;
-	}
-	else{
+	if (!OpenChildElement(tagId)){
 		if (IsLogConsumed()){
 			SendLogMessage(
 						istd::IInformationProvider::IC_ERROR,
@@ -103,19 +93,13 @@ bool CCompactXmlReadArchiveBase::BeginMultiTag(const iser::CArchiveTag& tag, con
 		return false;
 	}
 
-	int tempCount = 0;
-	for (		QDomElement child = element.firstChildElement(QString(subTag.GetId()));
-				!child.isNull();
-				child = child.nextSiblingElement(QString(subTag.GetId()))){
-		tempCount++;
-	}
-	count = tempCount;
+	count = CountChildElements(*m_openedElements.back(), QString(subTag.GetId()));
 
 	m_tagsStack.push_back(&tag);
 
 	m_allowAttribute = true;
 
-	return !element.isNull();
+	return true;
 }
 
 
@@ -145,19 +129,26 @@ bool CCompactXmlReadArchiveBase::EndTag(const iser::CArchiveTag& tag)
 		return false;
 	}
 
-	Q_ASSERT (lastTagPtr->GetId() == m_currentParent.tagName().toLatin1());
+	if (m_openedElements.isEmpty()){
+		return false;
+	}
+
+	Q_ASSERT(lastTagPtr->GetId() == m_openedElements.back()->name.toLatin1());
+
+	bool retVal = true;
 
-	QDomNode parent = m_currentParent.parentNode();
-	
-	parent.removeChild(m_currentParent);
+	// not consumed content will be dropped
+	if (m_openedElements.back()->isStreamed){
+		retVal = SkipStreamedContent();
+	}
 
-	m_currentParent = parent.toElement();
+	m_openedElements.pop_back();
 
 	if (m_isNewFormat){
 		m_allowAttribute = false;
 	}
 
-	return !m_currentParent.isNull();
+	return retVal && !m_openedElements.isEmpty();
 }
 
 
@@ -171,22 +162,52 @@ bool CCompactXmlReadArchiveBase::Process(QString& value)
 
 bool CCompactXmlReadArchiveBase::ReadStringNode(QString& text)
 {
+	if (m_openedElements.isEmpty()){
+		return false;
+	}
+
+	Element& element = *m_openedElements.back();
+
 	if (m_currentAttribute.isEmpty()){
-		// check if the node is separator
-		QDomNode node = m_currentParent.firstChild();
-		while (!node.isNull() && ((node.nodeName() == GetElementSeparator()) || (node.nodeType() != QDomNode::TextNode))){
-			QDomNode brNode = node;
-			node = node.nextSibling();
-			m_currentParent.removeChild(brNode);
+		text.clear();
+
+		// elements placed before the text (e.g. separators) are dropped
+		while (!element.content.isEmpty()){
+			ContentItem item = element.content.takeFirst();
+			if (item.elementPtr.isNull()){
+				text = item.text;
+
+				return true;
+			}
 		}
-	
-		text = node.nodeValue();
 
-		m_currentParent.removeChild(node);
+		while (element.isStreamed){
+			StreamToken token = ReadNextToken();
+			if (token == ST_TEXT){
+				text = m_reader.text().toString();
+
+				return true;
+			}
+			else if (token == ST_START_ELEMENT){
+				++m_nextElementIndex;
+
+				if (!SkipStreamedContent()){
+					return false;
+				}
+			}
+			else if (token == ST_END_ELEMENT){
+				element.isStreamed = false;
+			}
+			else{
+				return false;
+			}
+		}
 	}
 	else{
-		if (m_currentParent.hasAttribute(m_currentAttribute)){
-			text = m_currentParent.attribute(m_currentAttribute);
+		QString attributeName(m_currentAttribute);
+
+		if (element.attributes.hasAttribute(attributeName)){
+			text = element.attributes.value(attributeName).toString();
 		}
 		else{
 			if (IsLogConsumed()){
@@ -202,35 +223,78 @@ bool CCompactXmlReadArchiveBase::ReadStringNode(QString& text)
 		}
 	}
 
-	return !m_currentParent.isNull();
+	return true;
 }
 
 
 bool CCompactXmlReadArchiveBase::SetContent(QIODevice* devicePtr)
 {
-	bool retVal = false;
-
-	if (m_document.setContent(devicePtr)){
-		m_currentParent = m_document.documentElement();
+	m_reader.clear();
+	m_openedElements.clear();
+	m_tagsStack.clear();
+	m_currentAttribute.clear();
+	m_childrenInfos.clear();
+	m_nextElementIndex = 0;
+	m_isDocumentScanned = false;
 
-		retVal = !m_currentParent.isNull();
+	if (devicePtr == NULL){
+		return false;
+	}
 
-		m_allowAttribute = true;
+	if (!devicePtr->isOpen() && !devicePtr->open(QIODevice::ReadOnly)){
+		return false;
+	}
 
-		if (m_serializeHeader){
-			retVal = retVal && SerializeAcfHeader();
+	if (!devicePtr->isSequential()){
+		// the scan validates also the whole document
+		if (!ScanDocument(devicePtr)){
+			return false;
 		}
 
-		quint32 frameworkVersion = quint32(-1);
-		GetVersionInfo().GetVersionNumber(iser::IVersionInfo::AcfVersionId, frameworkVersion);
+		m_isDocumentScanned = true;
+	}
+
+	m_reader.setDevice(devicePtr);
+
+	while (!m_reader.atEnd() && (m_reader.readNext() != QXmlStreamReader::StartElement)){
+	}
+
+	if (!m_reader.isStartElement()){
+		return false;
+	}
+
+	ElementPtr rootElementPtr = CreateElement();
+	rootElementPtr->isStreamed = true;
+
+	m_openedElements.push_back(rootElementPtr);
+
+	m_allowAttribute = true;
+
+	bool retVal = true;
 
-		m_isNewFormat = (frameworkVersion >= 4052);
+	if (m_serializeHeader){
+		retVal = retVal && SerializeAcfHeader();
 	}
 
+	quint32 frameworkVersion = quint32(-1);
+	GetVersionInfo().GetVersionNumber(iser::IVersionInfo::AcfVersionId, frameworkVersion);
+
+	m_isNewFormat = (frameworkVersion >= 4052);
+
 	return retVal;
 }
 
 
+int CCompactXmlReadArchiveBase::GetCurrentLineNumber() const
+{
+	if (m_openedElements.isEmpty()){
+		return -1;
+	}
+
+	return m_openedElements.back()->lineNumber;
+}
+
+
 // reimplemented (iser::CTextReadArchiveBase)
 
 bool CCompactXmlReadArchiveBase::ReadTextNode(QByteArray& text)
@@ -258,8 +322,10 @@ void CCompactXmlReadArchiveBase::DecorateMessage(
 
 	QStringList nodesList;
 
-	for (QDomNode el = m_currentParent; el.isElement(); el = el.parentNode()){
-		nodesList.push_front(el.nodeName());
+	for (		ElementsStack::ConstIterator iter = m_openedElements.constBegin();
+				iter != m_openedElements.constEnd();
+				++iter){
+		nodesList.push_back((*iter)->name);
 	}
 
 	QString nodePath = nodesList.join("/");
@@ -271,6 +337,288 @@ void CCompactXmlReadArchiveBase::DecorateMessage(
 }
 
 
+// private methods
+
+bool CCompactXmlReadArchiveBase::ScanDocument(QIODevice* devicePtr)
+{
+	qint64 startPosition = devicePtr->pos();
+
+	QXmlStreamReader reader(devicePtr);
+
+	QVector<int> parentIndices;
+
+	while (!reader.atEnd()){
+		QXmlStreamReader::TokenType tokenType = reader.readNext();
+		if (tokenType == QXmlStreamReader::StartElement){
+			int nameId = GetNameId(reader.name().toString());
+
+			if (!parentIndices.isEmpty()){
+				ChildrenInfo& parentInfo = m_childrenInfos[parentIndices.back()];
+				if (parentInfo.count == 0){
+					parentInfo.firstChildNameId = nameId;
+				}
+
+				if (parentInfo.firstChildNameId == nameId){
+					++parentInfo.count;
+				}
+			}
+
+			ChildrenInfo info;
+			info.firstChildNameId = -1;
+			info.count = 0;
+
+			parentIndices.push_back(m_childrenInfos.size());
+			m_childrenInfos.push_back(info);
+		}
+		else if ((tokenType == QXmlStreamReader::EndElement) && !parentIndices.isEmpty()){
+			parentIndices.pop_back();
+		}
+	}
+
+	bool retVal = !reader.hasError() && !m_childrenInfos.isEmpty();
+
+	if (!retVal){
+		m_childrenInfos.clear();
+	}
+
+	return devicePtr->seek(startPosition) && retVal;
+}
+
+
+int CCompactXmlReadArchiveBase::GetNameId(const QString& name)
+{
+	NameIds::ConstIterator foundIter = m_nameIds.constFind(name);
+	if (foundIter != m_nameIds.constEnd()){
+		return foundIter.value();
+	}
+
+	int nameId = m_nameIds.size();
+
+	m_nameIds.insert(name, nameId);
+
+	return nameId;
+}
+
+
+CCompactXmlReadArchiveBase::StreamToken CCompactXmlReadArchiveBase::ReadNextToken()
+{
+	while (!m_reader.atEnd()){
+		switch (m_reader.readNext()){
+		case QXmlStreamReader::StartElement:
+			return ST_START_ELEMENT;
+
+		case QXmlStreamReader::EndElement:
+			return ST_END_ELEMENT;
+
+		case QXmlStreamReader::Characters:
+			if (!m_reader.isWhitespace()){
+				return ST_TEXT;
+			}
+			break;
+
+		case QXmlStreamReader::Invalid:
+		case QXmlStreamReader::EndDocument:
+			return ST_ERROR;
+
+		default:
+			break;
+		}
+	}
+
+	return ST_ERROR;
+}
+
+
+CCompactXmlReadArchiveBase::ElementPtr CCompactXmlReadArchiveBase::CreateElement()
+{
+	Q_ASSERT(m_reader.isStartElement());
+
+	ElementPtr elementPtr(new Element);
+
+	// the names are shared with the name table
+	QString name = m_reader.name().toString();
+	NameIds::ConstIterator foundIter = m_nameIds.constFind(name);
+	if (foundIter == m_nameIds.constEnd()){
+		foundIter = m_nameIds.insert(name, m_nameIds.size());
+	}
+
+	elementPtr->name = foundIter.key();
+	elementPtr->attributes = m_reader.attributes();
+	elementPtr->index = m_nextElementIndex++;
+	elementPtr->lineNumber = int(m_reader.lineNumber());
+	elementPtr->isStreamed = false;
+
+	return elementPtr;
+}
+
+
+CCompactXmlReadArchiveBase::ElementPtr CCompactXmlReadArchiveBase::ReadBufferedElement()
+{
+	ElementPtr elementPtr = CreateElement();
+	elementPtr->isStreamed = true;
+
+	if (!ReadStreamedContent(*elementPtr)){
+		return ElementPtr();
+	}
+
+	return elementPtr;
+}
+
+
+bool CCompactXmlReadArchiveBase::ReadStreamedContent(Element& element)
+{
+	while (element.isStreamed){
+		StreamToken token = ReadNextToken();
+		if (token == ST_START_ELEMENT){
+			ContentItem item;
+			item.elementPtr = ReadBufferedElement();
+			if (item.elementPtr.isNull()){
+				element.isStreamed = false;
+
+				return false;
+			}
+
+			element.content.push_back(item);
+		}
+		else if (token == ST_TEXT){
+			ContentItem item;
+			item.text = m_reader.text().toString();
+
+			element.content.push_back(item);
+		}
+		else if (token == ST_END_ELEMENT){
+			element.isStreamed = false;
+		}
+		else{
+			element.isStreamed = false;
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+bool CCompactXmlReadArchiveBase::SkipStreamedContent()
+{
+	int depth = 1;
+
+	while (depth > 0){
+		switch (m_reader.readNext()){
+		case QXmlStreamReader::StartElement:
+			++depth;
+			++m_nextElementIndex;
+			break;
+
+		case QXmlStreamReader::EndElement:
+			--depth;
+			break;
+
+		case QXmlStreamReader::Invalid:
+		case QXmlStreamReader::EndDocument:
+			return false;
+
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+
+bool CCompactXmlReadArchiveBase::OpenChildElement(const QString& name)
+{
+	if (m_openedElements.isEmpty()){
+		return false;
+	}
+
+	Element& parent = *m_openedElements.back();
+
+	// elements read ahead are placed before the rest of the stream
+	for (		ContentItems::Iterator iter = parent.content.begin();
+				iter != parent.content.end();
+				++iter){
+		if (!iter->elementPtr.isNull() && (iter->elementPtr->name == name)){
+			ElementPtr elementPtr = iter->elementPtr;
+
+			parent.content.erase(iter);
+
+			m_openedElements.push_back(elementPtr);
+
+			return true;
+		}
+	}
+
+	while (parent.isStreamed){
+		StreamToken token = ReadNextToken();
+		if (token == ST_START_ELEMENT){
+			if (m_reader.name() == name){
+				ElementPtr elementPtr = CreateElement();
+				elementPtr->isStreamed = true;
+
+				m_openedElements.push_back(elementPtr);
+
+				return true;
+			}
+
+			ContentItem item;
+			item.elementPtr = ReadBufferedElement();
+			if (item.elementPtr.isNull()){
+				parent.isStreamed = false;
+
+				return false;
+			}
+
+			parent.content.push_back(item);
+		}
+		else if (token == ST_TEXT){
+			ContentItem item;
+			item.text = m_reader.text().toString();
+
+			parent.content.push_back(item);
+		}
+		else{
+			parent.isStreamed = false;
+		}
+	}
+
+	return false;
+}
+
+
+int CCompactXmlReadArchiveBase::CountChildElements(Element& element, const QString& name)
+{
+	if (element.isStreamed && element.content.isEmpty() && m_isDocumentScanned && (element.index < m_childrenInfos.size())){
+		const ChildrenInfo& info = m_childrenInfos[element.index];
+		if (info.count == 0){
+			return 0;
+		}
+
+		NameIds::ConstIterator foundIter = m_nameIds.constFind(name);
+		if ((foundIter != m_nameIds.constEnd()) && (foundIter.value() == info.firstChildNameId)){
+			return info.count;
+		}
+	}
+
+	// the number of elements is not known, the content must be buffered
+	ReadStreamedContent(element);
+
+	int retVal = 0;
+
+	for (		ContentItems::ConstIterator iter = element.content.constBegin();
+				iter != element.content.constEnd();
+				++iter){
+		if (!iter->elementPtr.isNull() && (iter->elementPtr->name == name)){
+			++retVal;
+		}
+	}
+
+	return retVal;
+}
+
+
 } // namespace iser
 
 
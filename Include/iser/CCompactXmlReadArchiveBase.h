@@ -3,8 +3,12 @@
 
 
 // Qt includes
-#include <QtXml/QDomDocument>
-#include <QtXml/QDomNode>
+#include <QtCore/QHash>
+#include <QtCore/QIODevice>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+#include <QtCore/QXmlStreamReader>
 
 // ACF includes
 #include <iser/CXmlDocumentInfoBase.h>
@@ -20,6 +24,11 @@ namespace iser
 /**
 	Qt-based implementation of archive reading from XML file.
 
+	The document is parsed on demand using \c QXmlStreamReader, elements read in the document order are never stored.
+	Only the content skipped by looking for an element out of order is buffered, so it can be read later.
+	The number of elements in multi tags is taken from the scan of the whole document done once on opening,
+	for sequential devices the content of multi tags is buffered instead.
+
 	\ingroup Persistence
 */
 class CCompactXmlReadArchiveBase: public iser::CTextReadArchiveBase, public iser::CXmlDocumentInfoBase
@@ -40,8 +49,17 @@ public:
 protected:
 	bool ReadStringNode(QString& text);
 
+	/**
+		Start reading of the document from some device.
+		The device must stay valid during the whole reading, the document is read on demand.
+	*/
 	bool SetContent(QIODevice* devicePtr);
 
+	/**
+		Get line number of the currently opened element or -1, if no element is opened.
+	*/
+	int GetCurrentLineNumber() const;
+
 	// reimplemented (iser::CTextReadArchiveBase)
 	virtual bool ReadTextNode(QByteArray& text) override;
 
@@ -52,10 +70,115 @@ protected:
 				QString& message,
 				QString& messageSource) const override;
 
-	QDomDocument m_document;
-	QDomElement m_currentParent;
-
 private:
+	struct Element;
+	typedef QSharedPointer<Element> ElementPtr;
+
+	/**
+		Item of the element content, it is a text or a child element.
+	*/
+	struct ContentItem
+	{
+		QString text;
+		ElementPtr elementPtr;
+	};
+
+	typedef QList<ContentItem> ContentItems;
+
+	struct Element
+	{
+		QString name;
+		QXmlStreamAttributes attributes;
+		/**
+			Content read ahead of the stream position, for completely buffered elements it is the whole not consumed content.
+		*/
+		ContentItems content;
+		/**
+			Index of the element in document order.
+		*/
+		int index;
+		int lineNumber;
+		/**
+			If it is true, the rest of the element content was not read from the stream yet.
+		*/
+		bool isStreamed;
+	};
+
+	/**
+		Information about child elements collected by the document scan.
+	*/
+	struct ChildrenInfo
+	{
+		/**
+			Name ID of the first child element.
+		*/
+		int firstChildNameId;
+		/**
+			Number of child elements having the same name as the first one.
+		*/
+		int count;
+	};
+
+	enum StreamToken
+	{
+		ST_TEXT,
+		ST_START_ELEMENT,
+		ST_END_ELEMENT,
+		ST_ERROR
+	};
+
+	bool ScanDocument(QIODevice* devicePtr);
+	int GetNameId(const QString& name);
+
+	/**
+		Read next token of the innermost streamed element.
+		Whitespace text, comments and processing instructions are ignored.
+	*/
+	StreamToken ReadNextToken();
+
+	/**
+		Create element for the current start element token.
+	*/
+	ElementPtr CreateElement();
+
+	/**
+		Read whole element from the stream, the reader must be placed at its start element token.
+	*/
+	ElementPtr ReadBufferedElement();
+
+	/**
+		Read the rest of the streamed element into its content.
+	*/
+	bool ReadStreamedContent(Element& element);
+
+	/**
+		Skip the rest of the current element in the stream.
+	*/
+	bool SkipStreamedContent();
+
+	/**
+		Find the first child element with the given name in the current element and open it.
+	*/
+	bool OpenChildElement(const QString& name);
+
+	int CountChildElements(Element& element, const QString& name);
+
+	QXmlStreamReader m_reader;
+
+	typedef QList<ElementPtr> ElementsStack;
+
+	ElementsStack m_openedElements;
+	int m_nextElementIndex;
+
+	typedef QHash<QString, int> NameIds;
+
+	NameIds m_nameIds;
+
+	typedef QVector<ChildrenInfo> ChildrenInfos;
+
+	ChildrenInfos m_childrenInfos;
+	bool m_isDocumentScanned;
+
 	QByteArray m_currentAttribute;
 
 	bool m_serializeHeader;
@@ -72,5 +195,3 @@ private:
 } // namespace iser
 
 
-
-
@@ -2,10 +2,77 @@
 #include <iser/CJsonReadArchiveBase.h>
 
 
+// Qt includes
+#include <QtCore/QLocale>
+
+
 namespace iser
 {
 
 
+namespace
+{
+
+
+static const int s_readBlockSize = 64 * 1024;
+
+
+inline bool IsWhitespace(char character)
+{
+	return (character == ' ') || (character == '\t') || (character == '\n') || (character == '\r');
+}
+
+
+inline bool IsLiteralEnd(char character)
+{
+	return IsWhitespace(character) || (character == ',') || (character == '}') || (character == ']') || (character == ':');
+}
+
+
+int GetHexValue(char character)
+{
+	if ((character >= '0') && (character <= '9')){
+		return character - '0';
+	}
+
+	if ((character >= 'a') && (character <= 'f')){
+		return character - 'a' + 10;
+	}
+
+	if ((character >= 'A') && (character <= 'F')){
+		return character - 'A' + 10;
+	}
+
+	return -1;
+}
+
+
+void AppendUtf8(QByteArray& text, uint codePoint)
+{
+	if (codePoint < 0x80){
+		text += char(codePoint);
+	}
+	else if (codePoint < 0x800){
+		text += char(0xc0 | (codePoint >> 6));
+		text += char(0x80 | (codePoint & 0x3f));
+	}
+	else if (codePoint < 0x10000){
+		text += char(0xe0 | (codePoint >> 12));
+		text += char(0x80 | ((codePoint >> 6) & 0x3f));
+		text += char(0x80 | (codePoint & 0x3f));
+	}
+	else{
+		text += char(0xf0 | (codePoint >> 18));
+		text += char(0x80 | ((codePoint >> 12) & 0x3f));
+		text += char(0x80 | ((codePoint >> 6) & 0x3f));
+		text += char(0x80 | (codePoint & 0x3f));
+	}
+}
+
+
+} // namespace
+
+
 // public methods
 
 CJsonReadArchiveBase::CJsonReadArchiveBase(
@@ -13,7 +80,13 @@ CJsonReadArchiveBase::CJsonReadArchiveBase(
 			const iser::CArchiveTag& /*rootTag*/)
 	:m_rootTag("", "", iser::CArchiveTag::TT_GROUP),
 	m_rootTagEnabled(false),
-	m_serializeHeader(serializeHeader)
+	m_serializeHeader(serializeHeader),
+	m_isRootOpened(false),
+	m_devicePtr(nullptr),
+	m_readPosition(0),
+	m_hasStreamError(false),
+	m_isDocumentScanned(false),
+	m_nextArrayIndex(0)
 {
 }
 
@@ -25,7 +98,7 @@ bool CJsonReadArchiveBase::BeginTag(const iser::CArchiveTag& tag)
 	QString tagId(tag.GetId());
 	int tagType = tag.GetTagType();
 
-	if (m_iterators.isEmpty() && !tagId.isEmpty()){
+	if (m_frames.isEmpty() && !tagId.isEmpty()){
 		if (!BeginTag(m_rootTag)){
 			return false;
 		}
@@ -33,46 +106,60 @@ bool CJsonReadArchiveBase::BeginTag(const iser::CArchiveTag& tag)
 		m_rootTagEnabled = true;
 	}
 
-	if (m_iterators.isEmpty()){
-		HelperIterator newHelperIterator;
-		QJsonObject jsonObject = m_document.object();
-		newHelperIterator.SetValue(jsonObject);
-		newHelperIterator.SetKey(tagId);
-		QString value = newHelperIterator.GetValue();
-		m_iterators.push_back(newHelperIterator);
-		m_tags.push_back(&tag);
+	if (m_frames.isEmpty()){
+		Frame rootFrame;
+		if (!OpenRootFrame(rootFrame)){
+			return false;
+		}
+
+		rootFrame.key = tagId;
+		rootFrame.tagPtr = &tag;
+
+		m_frames.push_back(rootFrame);
 
 		return true;
 	}
 
-	HelperIterator helperIterator = m_iterators.last();
+	if (IsArray(m_frames.last())){
+		Frame elementFrame;
+		if (!OpenArrayElement(m_frames.last(), elementFrame)){
+			return false;
+		}
+
+		elementFrame.key = tagId;
+		elementFrame.tagPtr = &tag;
 
-	if (helperIterator.isArray()){
 		if (tagType == iser::CArchiveTag::TT_LEAF){
-			HelperIterator newHelperIterator;
-			newHelperIterator.SetKey(tagId);
-			QString value = helperIterator.GetValue();
-			newHelperIterator.SetValue(value);
-			m_iterators.push_back(newHelperIterator);
-			m_tags.push_back(&tag);
+			// only the text of the element is used
+			if (elementFrame.isStreamed){
+				SkipStreamedContent(elementFrame);
+			}
+
+			ValuePtr textValuePtr(new Value);
+			textValuePtr->type = VT_STRING;
+			textValuePtr->text = GetValueText(elementFrame);
+
+			elementFrame.valuePtr = textValuePtr;
 		}
-		else{
-			QJsonObject jsonObject = helperIterator.GetObject();
-			HelperIterator newHelperIterator;
-			newHelperIterator.SetValue(jsonObject);
-			newHelperIterator.SetKey(tagId);
-			m_iterators.push_back(newHelperIterator);
-			m_tags.push_back(&tag);
+		else if (!IsObject(elementFrame)){
+			if (elementFrame.isStreamed){
+				SkipStreamedContent(elementFrame);
+			}
+
+			ValuePtr objectValuePtr(new Value);
+			objectValuePtr->type = VT_OBJECT;
+
+			elementFrame.valuePtr = objectValuePtr;
 		}
+
+		m_frames.push_back(elementFrame);
 	}
 	else {
-		QJsonObject jsonObject = helperIterator.GetObject();
-		if (jsonObject.contains(tagId)){
-			HelperIterator newHelperIterator;
-			newHelperIterator.SetValue(jsonObject.value(tagId));
-			newHelperIterator.SetKey(tagId);
-			m_iterators.push_back(newHelperIterator);
-			m_tags.push_back(&tag);
+		Frame memberFrame;
+		if (OpenObjectMember(m_frames.last(), tagId, memberFrame)){
+			memberFrame.tagPtr = &tag;
+
+			m_frames.push_back(memberFrame);
 		}
 		else{
 			if (IsLogConsumed()){
@@ -96,73 +183,106 @@ bool CJsonReadArchiveBase::BeginMultiTag(const iser::CArchiveTag& tag, const ise
 {
 	QString tagId(tag.GetId());
 
-	if (m_iterators.isEmpty()){
+	if (m_frames.isEmpty()){
 		return false;
 	}
 
-	HelperIterator helperIterator = m_iterators.last();
+	bool isObjectOpened = IsObject(m_frames.last());
 
-	QJsonValue jsonValue = helperIterator.GetJsonValue();
+	if (!isObjectOpened){
+		Frame valueFrame;
+		if (IsArray(m_frames.last())){
+			if (!OpenArrayElement(m_frames.last(), valueFrame)){
+				return false;
+			}
+		}
+		else{
+			ValuePtr nullValuePtr(new Value);
+			nullValuePtr->type = VT_NULL;
 
-	if (jsonValue.isObject()){
-		QJsonObject jsonObject;
-		jsonObject = jsonValue.toObject();
+			valueFrame = CreateFrame(tagId, &tag, nullValuePtr);
+		}
 
-		if (jsonObject.contains(tagId)){
-			QJsonValue value = jsonObject.value(tagId);
-			if (value.isArray()){
-				HelperIterator newHelperIterator;
-				newHelperIterator.SetValue(value);
-				newHelperIterator.SetKey(tagId);
+		if (IsObject(valueFrame)){
+			// the array is a member of the current array element
+			valueFrame.isImplicit = true;
 
-				m_iterators.push_back(newHelperIterator);
-				m_tags.push_back(&tag);
+			m_frames.push_back(valueFrame);
 
-				count = value.toArray().count();
-			}
+			isObjectOpened = true;
 		}
 		else{
-			if (IsLogConsumed()){
-				SendLogMessage(
-					istd::IInformationProvider::IC_ERROR,
-					MI_TAG_ERROR,
-					QString("Tag '%1' not found!").arg(QString(tagId)),
-					"CJsonStringReadArchive",
-					istd::IInformationProvider::ITF_SYSTEM);
-			}
+			valueFrame.key = tagId;
+			valueFrame.tagPtr = &tag;
 
-			return false;
+			m_frames.push_back(valueFrame);
+
+			count = GetArrayCount(m_frames.last());
+
+			return true;
 		}
+	}
 
-		return true;
+	Q_ASSERT(isObjectOpened);
+
+	Frame memberFrame;
+	if (!OpenObjectMember(m_frames.last(), tagId, memberFrame)){
+		if (m_frames.last().isImplicit){
+			CloseFrame(m_frames.last());
+
+			m_frames.pop_back();
+		}
+
+		if (IsLogConsumed()){
+			SendLogMessage(
+				istd::IInformationProvider::IC_ERROR,
+				MI_TAG_ERROR,
+				QString("Tag '%1' not found!").arg(QString(tagId)),
+				"CJsonStringReadArchive",
+				istd::IInformationProvider::ITF_SYSTEM);
+		}
+
+		return false;
+	}
+
+	if (IsArray(memberFrame)){
+		memberFrame.tagPtr = &tag;
+
+		m_frames.push_back(memberFrame);
+
+		count = GetArrayCount(m_frames.last());
 	}
 	else{
-		HelperIterator newHelperIterator;
-		newHelperIterator.SetValue(jsonValue);
-		newHelperIterator.SetKey(tagId);
-		m_iterators.push_back(newHelperIterator);
-		m_tags.push_back(&tag);
-		count = jsonValue.toArray().count();
+		CloseFrame(memberFrame);
 
-		return true;
+		if (m_frames.last().isImplicit){
+			CloseFrame(m_frames.last());
+
+			m_frames.pop_back();
+		}
 	}
 
-	return false;
+	return true;
 }
 
 
 bool CJsonReadArchiveBase::EndTag(const iser::CArchiveTag& tag)
 {
-	if (m_iterators.isEmpty()){
+	if (m_frames.isEmpty()){
 		return false;
 	}
 
-	HelperIterator helperIterator = m_iterators.last();
-	if (helperIterator.GetKey() == tag.GetId()){
-		m_iterators.pop_back();
-		m_tags.pop_back();
-		if (!m_iterators.isEmpty() && m_iterators.last().isArray()){
-			m_iterators.last().NextElementArray();
+	if (m_frames.last().key == tag.GetId()){
+		CloseFrame(m_frames.last());
+		m_frames.pop_back();
+
+		if (!m_frames.isEmpty() && m_frames.last().isImplicit){
+			CloseFrame(m_frames.last());
+			m_frames.pop_back();
+		}
+
+		if (!m_frames.isEmpty() && IsArray(m_frames.last()) && !m_frames.last().isStreamed){
+			m_frames.last().activeIndex++;
 		}
 	}
 	else{
@@ -192,21 +312,43 @@ bool CJsonReadArchiveBase::SetContent(QIODevice* devicePtr)
 {
 	Q_ASSERT(devicePtr != nullptr);
 
-	QByteArray jsonData = devicePtr->readAll();
+	m_frames.clear();
+	m_isRootOpened = false;
+	m_rootTagEnabled = false;
+	m_readBuffer.clear();
+	m_readPosition = 0;
+	m_hasStreamError = false;
+	m_arrayCounts.clear();
+	m_isDocumentScanned = false;
+	m_nextArrayIndex = 0;
+	m_devicePtr = nullptr;
+
+	if (!devicePtr->isOpen() && !devicePtr->open(QIODevice::ReadOnly)){
+		return false;
+	}
 
-	QJsonParseError error;
-	m_document = QJsonDocument::fromJson(jsonData, &error);
+	if (!devicePtr->isSequential()){
+		if (!ScanDocument(devicePtr)){
+			if (IsLogConsumed()) {
+				SendLogMessage(
+					istd::IInformationProvider::IC_ERROR,
+					MI_TAG_ERROR,
+					"Invalid JSON document",
+					"CJsonReadArchiveBase",
+					istd::IInformationProvider::ITF_SYSTEM);
+			}
 
-	if (error.error != QJsonParseError::NoError) {
-		if (IsLogConsumed()) {
-			SendLogMessage(
-				istd::IInformationProvider::IC_ERROR,
-				MI_TAG_ERROR,
-				error.errorString(),
-				"CJsonReadArchiveBase",
-				istd::IInformationProvider::ITF_SYSTEM);
+			return false;
 		}
 
+		m_isDocumentScanned = true;
+	}
+
+	m_devicePtr = devicePtr;
+
+	if (PeekChar() == 0){
+		SetStreamError("Empty JSON document");
+
 		return false;
 	}
 
@@ -222,33 +364,32 @@ bool CJsonReadArchiveBase::ReadStringNode(QString &text)
 {
 	bool openFakeTag = false;
 
-	if (m_iterators.isEmpty() || m_tags.isEmpty()){
+	if (m_frames.isEmpty()){
 		return false;
 	}
 
-	if (m_iterators.last().isObject()){
-		if (!BeginTag(*m_tags.last())){
+	if (IsObject(m_frames.last())){
+		if (!BeginTag(*m_frames.last().tagPtr)){
 			return false;
 		}
 
 		openFakeTag = true;
 	}
 
-	HelperIterator helperIterator = m_iterators.last();
-	QJsonObject jsonObject;
+	const Frame& frame = m_frames.last();
 
-	if (!helperIterator.isObject() && !helperIterator.isArray()){
-		text = helperIterator.GetValue();
+	if (!IsObject(frame) && !IsArray(frame)){
+		text = GetValueText(frame);
 	}
 	else{
 		if (openFakeTag){
-			EndTag(*m_tags.last());
+			EndTag(*m_frames.last().tagPtr);
 		}
 		return false;
 	}
 
 	if (openFakeTag){
-		EndTag(*m_tags.last());
+		EndTag(*m_frames.last().tagPtr);
 	}
 	return true;
 }
@@ -267,119 +408,690 @@ bool CJsonReadArchiveBase::ReadTextNode(QByteArray &text)
 	return false;
 }
 
-CJsonReadArchiveBase::HelperIterator::HelperIterator()
-			: activeArrayIndex(0)
+
+// private methods
+
+CJsonReadArchiveBase::Frame CJsonReadArchiveBase::CreateFrame(
+			const QString& key,
+			const iser::CArchiveTag* tagPtr,
+			const ValuePtr& valuePtr) const
 {
+	Frame frame;
+	frame.key = key;
+	frame.tagPtr = tagPtr;
+	frame.valuePtr = valuePtr;
+	frame.isStreamed = false;
+	frame.isFirstItem = false;
+	frame.arrayIndex = -1;
+	frame.activeIndex = 0;
+	frame.isImplicit = false;
+
+	return frame;
+}
 
+
+bool CJsonReadArchiveBase::IsObject(const Frame& frame) const
+{
+	return frame.valuePtr->type == VT_OBJECT;
 }
 
-void CJsonReadArchiveBase::HelperIterator::SetKey(const QString &key)
+
+bool CJsonReadArchiveBase::IsArray(const Frame& frame) const
 {
-	m_key = key;
+	return frame.valuePtr->type == VT_ARRAY;
 }
 
 
-const QString CJsonReadArchiveBase::HelperIterator::GetKey()
+QString CJsonReadArchiveBase::GetValueText(const Frame& frame) const
 {
-	return m_key;
+	ValueType type = frame.valuePtr->type;
+	if ((type == VT_OBJECT) || (type == VT_ARRAY)){
+		return QString();
+	}
+
+	return frame.valuePtr->text;
 }
 
 
-QString CJsonReadArchiveBase::HelperIterator::GetValue()
+bool CJsonReadArchiveBase::OpenRootFrame(Frame& frame)
 {
-	QString retVal;
-	if (m_value.isBool()){
-		retVal = m_value.toBool() ? "true" : "false";
+	if (!m_isRootOpened && (m_devicePtr != nullptr) && (PeekChar() == '{')){
+		m_isRootOpened = true;
+
+		return OpenStreamedValue(frame);
+	}
+
+	// the document was already consumed or it is not an object
+	ValuePtr objectValuePtr(new Value);
+	objectValuePtr->type = VT_OBJECT;
+
+	frame = CreateFrame(QString(), nullptr, objectValuePtr);
+
+	return true;
+}
+
+
+bool CJsonReadArchiveBase::OpenObjectMember(Frame& objectFrame, const QString& key, Frame& memberFrame)
+{
+	if (!IsObject(objectFrame)){
+		return false;
+	}
+
+	Members& members = objectFrame.valuePtr->members;
+
+	// members read ahead are placed before the rest of the stream
+	for (Members::Iterator iter = members.begin(); iter != members.end(); ++iter){
+		if (iter->key == key){
+			memberFrame = CreateFrame(key, nullptr, iter->valuePtr);
+
+			members.erase(iter);
+
+			return true;
+		}
+	}
+
+	while (objectFrame.isStreamed){
+		if (!ReadNextItem(objectFrame)){
+			return false;
+		}
+
+		Member member;
+		if (!ReadStringToken(member.key) || !ReadExpectedChar(':')){
+			objectFrame.isStreamed = false;
+
+			return false;
+		}
+
+		if (member.key == key){
+			if (!OpenStreamedValue(memberFrame)){
+				objectFrame.isStreamed = false;
+
+				return false;
+			}
+
+			memberFrame.key = key;
+
+			return true;
+		}
+
+		member.valuePtr = ReadValue();
+		if (member.valuePtr.isNull()){
+			objectFrame.isStreamed = false;
+
+			return false;
+		}
+
+		members.push_back(member);
+	}
+
+	return false;
+}
+
+
+bool CJsonReadArchiveBase::OpenArrayElement(Frame& arrayFrame, Frame& elementFrame)
+{
+	Q_ASSERT(IsArray(arrayFrame));
+
+	if (arrayFrame.isStreamed){
+		if (ReadNextItem(arrayFrame)){
+			if (OpenStreamedValue(elementFrame)){
+				return true;
+			}
+
+			arrayFrame.isStreamed = false;
+
+			return false;
+		}
 	}
 	else{
-		if (m_value.isArray() && activeArrayIndex > -1 && activeArrayIndex < m_array.count()){
-			retVal = m_array[activeArrayIndex].toVariant().toString();
+		const Members& members = arrayFrame.valuePtr->members;
+		if (arrayFrame.activeIndex < members.size()){
+			elementFrame = CreateFrame(QString(), nullptr, members[arrayFrame.activeIndex].valuePtr);
+
+			return true;
 		}
-		else{
-			retVal = m_value.toVariant().toString();
+	}
+
+	if (m_hasStreamError){
+		return false;
+	}
+
+	// there are no more elements
+	ValuePtr nullValuePtr(new Value);
+	nullValuePtr->type = VT_NULL;
+
+	elementFrame = CreateFrame(QString(), nullptr, nullValuePtr);
+
+	return true;
+}
+
+
+int CJsonReadArchiveBase::GetArrayCount(Frame& arrayFrame)
+{
+	if (!IsArray(arrayFrame)){
+		return 0;
+	}
+
+	if (arrayFrame.isStreamed){
+		if (		arrayFrame.isFirstItem &&
+					m_isDocumentScanned &&
+					(arrayFrame.arrayIndex >= 0) &&
+					(arrayFrame.arrayIndex < m_arrayCounts.size())){
+			return m_arrayCounts[arrayFrame.arrayIndex];
 		}
+
+		// the number of elements is not known, the array must be buffered
+		ReadStreamedContent(arrayFrame);
+
+		arrayFrame.activeIndex = 0;
 	}
 
-	return retVal;
+	return int(arrayFrame.valuePtr->members.size()) - arrayFrame.activeIndex;
 }
 
 
-QJsonObject CJsonReadArchiveBase::HelperIterator::GetObject()
+void CJsonReadArchiveBase::CloseFrame(Frame& frame)
 {
-	if (m_value.isObject()){
+	// not consumed content will be dropped
+	if (frame.isStreamed){
+		SkipStreamedContent(frame);
+	}
+}
 
-		return m_value.toObject();
+
+bool CJsonReadArchiveBase::ScanDocument(QIODevice* devicePtr)
+{
+	qint64 startPosition = devicePtr->pos();
+
+	// for arrays the index of the counter, for objects -1
+	QVector<int> containers;
+	bool isInString = false;
+	bool isEscaped = false;
+	bool isValueFound = false;
+	bool retVal = true;
+
+	while (retVal){
+		QByteArray block = devicePtr->read(s_readBlockSize);
+		if (block.isEmpty()){
+			break;
+		}
+
+		const char* dataPtr = block.constData();
+		int blockSize = block.size();
+
+		for (int i = 0; (i < blockSize) && retVal; ++i){
+			char character = dataPtr[i];
+
+			if (isInString){
+				if (isEscaped){
+					isEscaped = false;
+				}
+				else if (character == '\\'){
+					isEscaped = true;
+				}
+				else if (character == '"'){
+					isInString = false;
+				}
+
+				continue;
+			}
+
+			if (IsWhitespace(character)){
+				continue;
+			}
+
+			isValueFound = true;
+
+			int arrayIndex = containers.isEmpty()? -1: containers.last();
+
+			if ((arrayIndex >= 0) && (m_arrayCounts[arrayIndex] == 0) && (character != ']')){
+				m_arrayCounts[arrayIndex] = 1;
+			}
+
+			switch (character){
+			case '"':
+				isInString = true;
+				break;
+
+			case '{':
+				containers.push_back(-1);
+				break;
+
+			case '[':
+				containers.push_back(m_arrayCounts.size());
+				m_arrayCounts.push_back(0);
+				break;
+
+			case '}':
+			case ']':
+				if (containers.isEmpty() || ((containers.last() >= 0) != (character == ']'))){
+					retVal = false;
+				}
+				else{
+					containers.pop_back();
+				}
+				break;
+
+			case ',':
+				if (arrayIndex >= 0){
+					++m_arrayCounts[arrayIndex];
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
 	}
 
-	if (m_value.isArray() && activeArrayIndex > -1 && activeArrayIndex < m_array.count()){
+	retVal = retVal && isValueFound && containers.isEmpty() && !isInString;
 
-		return m_array[activeArrayIndex].toObject();
+	if (!retVal){
+		m_arrayCounts.clear();
 	}
 
-	return QJsonObject();
+	return devicePtr->seek(startPosition) && retVal;
 }
 
 
-QJsonValue CJsonReadArchiveBase::HelperIterator::GetJsonValue()
+bool CJsonReadArchiveBase::FillReadBuffer()
 {
-	if (m_value.isObject()){
+	if (m_readPosition < m_readBuffer.size()){
+		return true;
+	}
 
-		return m_value;
+	if ((m_devicePtr == nullptr) || m_hasStreamError){
+		return false;
 	}
 
-	if (m_value.isArray() && activeArrayIndex > -1 && activeArrayIndex < m_array.count()){
+	m_readBuffer = m_devicePtr->read(s_readBlockSize);
+	m_readPosition = 0;
+
+	return !m_readBuffer.isEmpty();
+}
+
+
+char CJsonReadArchiveBase::PeekChar()
+{
+	while (FillReadBuffer()){
+		char character = m_readBuffer.at(m_readPosition);
+		if (!IsWhitespace(character)){
+			return character;
+		}
 
-		return m_array[activeArrayIndex];
+		++m_readPosition;
 	}
 
-	return QJsonValue();
+	return 0;
 }
 
 
-QJsonArray CJsonReadArchiveBase::HelperIterator::GetArray()
+bool CJsonReadArchiveBase::ReadExpectedChar(char expectedChar)
 {
-	if (isArray()){
+	if (PeekChar() != expectedChar){
+		SetStreamError(QString("'%1' expected").arg(QChar(expectedChar)));
 
-		return m_array;
+		return false;
 	}
 
-	return QJsonArray();
+	++m_readPosition;
+
+	return true;
 }
 
 
-bool CJsonReadArchiveBase::HelperIterator::NextElementArray()
+bool CJsonReadArchiveBase::ReadNextItem(Frame& containerFrame)
 {
-	if (isArray()){
-		activeArrayIndex++;
+	Q_ASSERT(containerFrame.isStreamed);
+
+	char closingChar = IsArray(containerFrame)? ']': '}';
+
+	char character = PeekChar();
+	if (character == closingChar){
+		++m_readPosition;
+
+		containerFrame.isStreamed = false;
+
+		return false;
+	}
+
+	if (!containerFrame.isFirstItem && !ReadExpectedChar(',')){
+		containerFrame.isStreamed = false;
+
+		return false;
+	}
+
+	containerFrame.isFirstItem = false;
+
+	return true;
+}
+
+
+bool CJsonReadArchiveBase::OpenStreamedValue(Frame& frame)
+{
+	char character = PeekChar();
+
+	if ((character == '{') || (character == '[')){
+		++m_readPosition;
+
+		ValuePtr valuePtr(new Value);
+		valuePtr->type = (character == '{')? VT_OBJECT: VT_ARRAY;
+
+		frame = CreateFrame(QString(), nullptr, valuePtr);
+		frame.isStreamed = true;
+		frame.isFirstItem = true;
+
+		if (character == '['){
+			frame.arrayIndex = m_nextArrayIndex++;
+		}
+
+		return true;
+	}
+
+	ValuePtr valuePtr = ReadScalarValue();
+	if (valuePtr.isNull()){
+		return false;
+	}
+
+	frame = CreateFrame(QString(), nullptr, valuePtr);
+
+	return true;
+}
+
+
+CJsonReadArchiveBase::ValuePtr CJsonReadArchiveBase::ReadScalarValue()
+{
+	ValuePtr valuePtr(new Value);
+
+	if (PeekChar() == '"'){
+		valuePtr->type = VT_STRING;
+
+		if (!ReadStringToken(valuePtr->text)){
+			return ValuePtr();
+		}
+
+		return valuePtr;
+	}
+
+	QByteArray literal;
+	while (FillReadBuffer()){
+		char character = m_readBuffer.at(m_readPosition);
+		if (IsLiteralEnd(character)){
+			break;
+		}
 
-		return activeArrayIndex < m_array.count();
+		literal += character;
+		++m_readPosition;
 	}
 
+	if (literal == "true" || literal == "false"){
+		valuePtr->type = VT_BOOL;
+		valuePtr->text = QString::fromLatin1(literal);
+	}
+	else if (literal == "null"){
+		valuePtr->type = VT_NULL;
+	}
+	else{
+		bool isNumber = false;
+		double number = literal.toDouble(&isNumber);
+		if (!isNumber){
+			SetStreamError(QString("Invalid value '%1'").arg(QString::fromLatin1(literal)));
+
+			return ValuePtr();
+		}
+
+		valuePtr->type = VT_NUMBER;
+
+		// integer values are kept as written to preserve the full precision
+		bool isInteger = true;
+		for (char character : literal){
+			if ((character == '.') || (character == 'e') || (character == 'E')){
+				isInteger = false;
+				break;
+			}
+		}
+
+		if (isInteger){
+			valuePtr->text = QString::fromLatin1(literal);
+		}
+		else{
+			valuePtr->text = QString::number(number, 'g', QLocale::FloatingPointShortest);
+		}
+	}
+
+	return valuePtr;
+}
+
+
+CJsonReadArchiveBase::ValuePtr CJsonReadArchiveBase::ReadValue()
+{
+	Frame frame;
+	if (!OpenStreamedValue(frame)){
+		return ValuePtr();
+	}
+
+	if (frame.isStreamed && !ReadStreamedContent(frame)){
+		return ValuePtr();
+	}
+
+	return frame.valuePtr;
+}
+
+
+bool CJsonReadArchiveBase::ReadStringToken(QString& text)
+{
+	if (!ReadExpectedChar('"')){
+		return false;
+	}
+
+	QByteArray utf8Text;
+
+	while (FillReadBuffer()){
+		const char* dataPtr = m_readBuffer.constData();
+		int bufferSize = m_readBuffer.size();
+
+		// characters without escaping are copied as a block
+		int blockStart = m_readPosition;
+		while ((m_readPosition < bufferSize) && (dataPtr[m_readPosition] != '"') && (dataPtr[m_readPosition] != '\\')){
+			++m_readPosition;
+		}
+
+		utf8Text.append(dataPtr + blockStart, m_readPosition - blockStart);
+
+		if (m_readPosition >= bufferSize){
+			continue;
+		}
+
+		if (dataPtr[m_readPosition++] == '"'){
+			text = QString::fromUtf8(utf8Text);
+
+			return true;
+		}
+
+		if (!FillReadBuffer()){
+			break;
+		}
+
+		char escapedChar = m_readBuffer.at(m_readPosition++);
+		switch (escapedChar){
+		case '"':
+		case '\\':
+		case '/':
+			utf8Text += escapedChar;
+			break;
+		case 'b':
+			utf8Text += '\b';
+			break;
+		case 'f':
+			utf8Text += '\f';
+			break;
+		case 'n':
+			utf8Text += '\n';
+			break;
+		case 'r':
+			utf8Text += '\r';
+			break;
+		case 't':
+			utf8Text += '\t';
+			break;
+		case 'u':
+			{
+				uint codePoint = 0;
+				for (int digitIndex = 0; digitIndex < 4; ++digitIndex){
+					int digit = FillReadBuffer()? GetHexValue(m_readBuffer.at(m_readPosition++)): -1;
+					if (digit < 0){
+						SetStreamError("Invalid unicode escape sequence");
+
+						return false;
+					}
+
+					codePoint = (codePoint << 4) | uint(digit);
+				}
+
+				if ((codePoint >= 0xd800) && (codePoint < 0xdc00)){
+					// the high surrogate must be followed by the low one
+					uint lowSurrogate = 0;
+					bool isPairValid = FillReadBuffer() && (m_readBuffer.at(m_readPosition) == '\\');
+					if (isPairValid){
+						++m_readPosition;
+
+						isPairValid = FillReadBuffer() && (m_readBuffer.at(m_readPosition++) == 'u');
+					}
+
+					for (int digitIndex = 0; isPairValid && (digitIndex < 4); ++digitIndex){
+						int digit = FillReadBuffer()? GetHexValue(m_readBuffer.at(m_readPosition++)): -1;
+
+						isPairValid = (digit >= 0);
+
+						lowSurrogate = (lowSurrogate << 4) | uint(digit);
+					}
+
+					if (!isPairValid || (lowSurrogate < 0xdc00) || (lowSurrogate >= 0xe000)){
+						SetStreamError("Invalid unicode surrogate pair");
+
+						return false;
+					}
+
+					codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+				}
+
+				AppendUtf8(utf8Text, codePoint);
+			}
+			break;
+		default:
+			SetStreamError("Invalid escape sequence");
+
+			return false;
+		}
+	}
+
+	SetStreamError("Unterminated string");
+
 	return false;
 }
 
 
-void CJsonReadArchiveBase::HelperIterator::SetValue(const QJsonValue value)
+bool CJsonReadArchiveBase::ReadStreamedContent(Frame& frame)
 {
-	m_value = value;
+	bool isObject = IsObject(frame);
+
+	while (frame.isStreamed){
+		if (!ReadNextItem(frame)){
+			break;
+		}
 
-	if (m_value.isArray()){
-		m_array = m_value.toArray();
-		activeArrayIndex = 0;
+		Member member;
+		if (isObject && (!ReadStringToken(member.key) || !ReadExpectedChar(':'))){
+			frame.isStreamed = false;
+
+			return false;
+		}
+
+		member.valuePtr = ReadValue();
+		if (member.valuePtr.isNull()){
+			frame.isStreamed = false;
+
+			return false;
+		}
+
+		frame.valuePtr->members.push_back(member);
 	}
+
+	return !m_hasStreamError;
 }
 
 
-bool CJsonReadArchiveBase::HelperIterator::isObject()
+bool CJsonReadArchiveBase::SkipStreamedContent(Frame& frame)
 {
-	return m_value.isObject();
+	int depth = 1;
+	bool isInString = false;
+	bool isEscaped = false;
+
+	while ((depth > 0) && FillReadBuffer()){
+		const char* dataPtr = m_readBuffer.constData();
+		int bufferSize = m_readBuffer.size();
+
+		for (; (m_readPosition < bufferSize) && (depth > 0); ++m_readPosition){
+			char character = dataPtr[m_readPosition];
+
+			if (isInString){
+				if (isEscaped){
+					isEscaped = false;
+				}
+				else if (character == '\\'){
+					isEscaped = true;
+				}
+				else if (character == '"'){
+					isInString = false;
+				}
+			}
+			else if (character == '"'){
+				isInString = true;
+			}
+			else if ((character == '{') || (character == '[')){
+				++depth;
+
+				if (character == '['){
+					++m_nextArrayIndex;
+				}
+			}
+			else if ((character == '}') || (character == ']')){
+				--depth;
+			}
+		}
+	}
+
+	frame.isStreamed = false;
+
+	if (depth > 0){
+		SetStreamError("Unexpected end of document");
+
+		return false;
+	}
+
+	return true;
 }
 
 
-bool CJsonReadArchiveBase::HelperIterator::isArray()
+void CJsonReadArchiveBase::SetStreamError(const QString& message)
 {
-	return m_value.isArray();
+	if (m_hasStreamError){
+		return;
+	}
+
+	m_hasStreamError = true;
+
+	if (IsLogConsumed()){
+		SendLogMessage(
+					istd::IInformationProvider::IC_ERROR,
+					MI_TAG_ERROR,
+					message,
+					"CJsonReadArchiveBase",
+					istd::IInformationProvider::ITF_SYSTEM);
+	}
 }
 
 
 } // namespace iser
+
+
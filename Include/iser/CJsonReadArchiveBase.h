@@ -3,10 +3,9 @@
 
 
 // Qt includes
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonObject>
-#include <QtCore/QJsonArray>
 #include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QIODevice>
 
 // ACF includes
@@ -20,6 +19,11 @@ namespace iser
 /**
 	Implementation of an ACF archive deserializing from a JSON string
 
+	The document is tokenized on demand directly from the device, values read in the document order are not stored.
+	Only the values skipped by looking for a key out of order are buffered, so they can be read later.
+	The number of array elements is taken from the scan of the whole document done once on opening,
+	for sequential devices the arrays are buffered instead.
+
 	\note	As to simplify decoding of some more complicated data structures support
 			for special annotation tags was added. They are used for guiding the 
 			deserialization algorithm in some special cases.
@@ -48,35 +52,118 @@ protected:
 	virtual bool ReadTextNode(QByteArray& text) override;
 
 protected:
-	QJsonDocument m_document;
+	iser::CArchiveTag m_rootTag;
+	bool m_rootTagEnabled;
+	bool m_serializeHeader;
 
-	class HelperIterator
+private:
+	enum ValueType
 	{
-	public:
-		HelperIterator();
-		void SetKey(const QString& key);
-		const QString GetKey();
-		QString GetValue();
-		QJsonObject GetObject();
-		QJsonValue GetJsonValue();
-		QJsonArray GetArray();
-		bool NextElementArray();
-		void SetValue(const QJsonValue value);
-		bool isObject();
-		bool isArray();
-	private:
-		QJsonArray m_array;
-		QJsonArray::ConstIterator m_arrayIterator;
-		QJsonValue m_value;
-		QString m_key;
-		int activeArrayIndex;
+		VT_NULL,
+		VT_BOOL,
+		VT_NUMBER,
+		VT_STRING,
+		VT_OBJECT,
+		VT_ARRAY
 	};
 
-	QList<HelperIterator> m_iterators;
-	QList<const iser::CArchiveTag*> m_tags;
-	iser::CArchiveTag m_rootTag;
-	bool m_rootTagEnabled;
-	bool m_serializeHeader;
+	struct Value;
+	typedef QSharedPointer<Value> ValuePtr;
+
+	/**
+		Object member or array element, for array elements the key is empty.
+	*/
+	struct Member
+	{
+		QString key;
+		ValuePtr valuePtr;
+	};
+
+	typedef QList<Member> Members;
+
+	struct Value
+	{
+		ValueType type;
+		/**
+			Text representation of scalar values.
+		*/
+		QString text;
+		/**
+			Buffered items of the container, for streamed objects the members read ahead of the stream position.
+		*/
+		Members members;
+	};
+
+	/**
+		Opened JSON value.
+	*/
+	struct Frame
+	{
+		QString key;
+		const iser::CArchiveTag* tagPtr;
+		ValuePtr valuePtr;
+		/**
+			If it is true, the rest of the container was not read from the stream yet.
+		*/
+		bool isStreamed;
+		/**
+			If it is true, no item of the streamed container was read yet.
+		*/
+		bool isFirstItem;
+		/**
+			Index of the streamed array in document order.
+		*/
+		int arrayIndex;
+		/**
+			Index of the active element of the buffered array.
+		*/
+		int activeIndex;
+		/**
+			If it is true, the frame was opened implicitly and it will be closed together with the next one.
+		*/
+		bool isImplicit;
+	};
+
+	typedef QList<Frame> Frames;
+
+	Frame CreateFrame(const QString& key, const iser::CArchiveTag* tagPtr, const ValuePtr& valuePtr) const;
+	bool IsObject(const Frame& frame) const;
+	bool IsArray(const Frame& frame) const;
+	QString GetValueText(const Frame& frame) const;
+	bool OpenRootFrame(Frame& frame);
+	bool OpenObjectMember(Frame& objectFrame, const QString& key, Frame& memberFrame);
+	bool OpenArrayElement(Frame& arrayFrame, Frame& elementFrame);
+	int GetArrayCount(Frame& arrayFrame);
+	void CloseFrame(Frame& frame);
+
+	// stream reading
+	bool ScanDocument(QIODevice* devicePtr);
+	bool FillReadBuffer();
+	char PeekChar();
+	bool ReadExpectedChar(char expectedChar);
+	bool ReadNextItem(Frame& containerFrame);
+	bool OpenStreamedValue(Frame& frame);
+	ValuePtr ReadScalarValue();
+	ValuePtr ReadValue();
+	bool ReadStringToken(QString& text);
+	bool ReadStreamedContent(Frame& frame);
+	bool SkipStreamedContent(Frame& frame);
+	void SetStreamError(const QString& message);
+
+	Frames m_frames;
+	bool m_isRootOpened;
+
+	QIODevice* m_devicePtr;
+	QByteArray m_readBuffer;
+	int m_readPosition;
+	bool m_hasStreamError;
+
+	/**
+		Number of elements of all arrays in document order, collected by the document scan.
+	*/
+	QVector<int> m_arrayCounts;
+	bool m_isDocumentScanned;
+	int m_nextArrayIndex;
 };
 
 
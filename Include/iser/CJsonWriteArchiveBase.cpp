@@ -2,10 +2,6 @@
 #include <iser/CJsonWriteArchiveBase.h>
 
 
-// Qt includes
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonObject>
-
 // ACF includes
 #include <iser/CArchiveHeaderInfo.h>
 
@@ -18,53 +14,67 @@ namespace
 {
 
 
-QByteArray EscapeJsonString(const QByteArray& value)
+static const int s_outputBlockSize = 64 * 1024;
+static const int s_numberBufferSize = 32;
+
+
+/**
+	Format integer number at the end of the buffer.
+	\return	Pointer to the first character of the number.
+*/
+char* FormatInteger(char* bufferEndPtr, quint64 value, bool isNegative)
 {
-	QByteArray escapedValue;
-	escapedValue.reserve(value.size() * 2);
+	char* positionPtr = bufferEndPtr;
 
-	static const char hexDigits[] = "0123456789ABCDEF";
+	do{
+		*--positionPtr = char('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
 
-	for (char currentByte : value){
-		const unsigned char byte = static_cast<unsigned char>(currentByte);
+	if (isNegative){
+		*--positionPtr = '-';
+	}
 
-		switch (currentByte){
-			case '\\':
-				escapedValue += "\\\\";
-				break;
-			case '\"':
-				escapedValue += "\\\"";
-				break;
-			case '\b':
-				escapedValue += "\\b";
-				break;
-			case '\f':
-				escapedValue += "\\f";
-				break;
-			case '\n':
-				escapedValue += "\\n";
-				break;
-			case '\r':
-				escapedValue += "\\r";
-				break;
-			case '\t':
-				escapedValue += "\\t";
-				break;
-			default:
-				// Escape ASCII control characters (0x00-0x1F).
-				if (byte < 0x20){
-					escapedValue += "\\u00";
-					escapedValue += hexDigits[byte >> 4];
-					escapedValue += hexDigits[byte & 0x0F];
-				}
-				else{
-					escapedValue += currentByte;
-				}
-				break;
+	return positionPtr;
+}
+
+
+QByteArray FormatSigned(char* bufferPtr, qint64 value)
+{
+	char* bufferEndPtr = bufferPtr + s_numberBufferSize;
+	quint64 absValue = (value < 0)? (quint64(0) - quint64(value)): quint64(value);
+
+	char* numberPtr = FormatInteger(bufferEndPtr, absValue, value < 0);
+
+	return QByteArray::fromRawData(numberPtr, int(bufferEndPtr - numberPtr));
+}
+
+
+QByteArray FormatUnsigned(char* bufferPtr, quint64 value)
+{
+	char* bufferEndPtr = bufferPtr + s_numberBufferSize;
+
+	char* numberPtr = FormatInteger(bufferEndPtr, value, false);
+
+	return QByteArray::fromRawData(numberPtr, int(bufferEndPtr - numberPtr));
+}
+
+
+QByteArray FormatReal(char* bufferPtr, double value, int precision)
+{
+	int size = qsnprintf(bufferPtr, s_numberBufferSize, "%.*g", precision, value);
+	if ((size <= 0) || (size >= s_numberBufferSize)){
+		return QByteArray::number(value, 'g', precision);
+	}
+
+	// the output must not depend on the C locale
+	for (int i = 0; i < size; ++i){
+		if (bufferPtr[i] == ','){
+			bufferPtr[i] = '.';
 		}
 	}
 
-	return escapedValue;
+	return QByteArray::fromRawData(bufferPtr, size);
 }
 
 
@@ -78,6 +88,7 @@ CJsonWriteArchiveBase::CJsonWriteArchiveBase(
 			bool serializeHeader,
 			const iser::CArchiveTag& /*rootTag*/)
 	:BaseClass(versionInfoPtr),
+	m_devicePtr(nullptr),
 	m_serializeHeader(serializeHeader),
 	m_jsonFormat(QJsonDocument::Indented),
 	m_rootTag("", "", iser::CArchiveTag::TT_GROUP)
@@ -162,13 +173,13 @@ bool CJsonWriteArchiveBase::EndTag(const CArchiveTag& /*tag*/)
 	int tagType = lastItem.m_tagPtr->GetTagType();
 
 	if (lastItem.m_isMultiTag){
-		m_stream << "]";
+		WriteRaw("]", 1);
 	}
 	else if (
 				tagType == iser::CArchiveTag::TT_GROUP
 				|| tagType == iser::CArchiveTag::TT_WEAK
 				|| tagType == iser::CArchiveTag::TT_UNKNOWN){
-		m_stream << "}";
+		WriteRaw("}", 1);
 	}
 	m_firstTag = false;
 
@@ -176,6 +187,94 @@ bool CJsonWriteArchiveBase::EndTag(const CArchiveTag& /*tag*/)
 }
 
 
+bool CJsonWriteArchiveBase::Process(char& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatSigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(quint8& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatUnsigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(qint8& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatSigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(quint16& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatUnsigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(qint16& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatSigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(quint32& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatUnsigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(qint32& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatSigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(quint64& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatUnsigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(qint64& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatSigned(buffer, value));
+}
+
+
+bool CJsonWriteArchiveBase::Process(float& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatReal(buffer, value, 6));
+}
+
+
+bool CJsonWriteArchiveBase::Process(double& value)
+{
+	char buffer[s_numberBufferSize];
+
+	return WriteTextNode(FormatReal(buffer, value, 12));
+}
+
+
 bool CJsonWriteArchiveBase::Process(QString &value)
 {
 	QByteArray valueData = value.toUtf8();
@@ -186,9 +285,10 @@ bool CJsonWriteArchiveBase::Process(QString &value)
 
 bool CJsonWriteArchiveBase::Process(QByteArray &value)
 {
+	m_isEscapingRequired = true;
 	m_quotationMarksRequired = true;
 
-	return WriteTextNode(EscapeJsonString(value));
+	return WriteTextNode(value);
 }
 
 
@@ -204,9 +304,9 @@ bool CJsonWriteArchiveBase::ProcessData(void* dataPtr, int size)
 
 bool CJsonWriteArchiveBase::InitStream(bool serializeHeader)
 {
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-	m_stream.setCodec("UTF-8");
-#endif
+	m_outputBuffer.clear();
+	m_outputBuffer.reserve(s_outputBlockSize);
+
 	m_firstTag = true;
 
 	WriteJsonHeader();
@@ -221,8 +321,8 @@ bool CJsonWriteArchiveBase::InitStream(bool serializeHeader)
 
 bool CJsonWriteArchiveBase::InitArchive(QIODevice* devicePtr)
 {
-	m_stream.setDevice(devicePtr);
-	
+	m_devicePtr = devicePtr;
+
 	return InitStream(m_serializeHeader);
 }
 
@@ -231,17 +331,17 @@ bool CJsonWriteArchiveBase::InitArchive(QByteArray& inputString)
 {
 	m_buffer.setBuffer(&inputString);
 	if (m_buffer.open(QIODevice::WriteOnly | QIODevice::Text)){
-		m_stream.setDevice(&m_buffer);
+		m_devicePtr = &m_buffer;
 	}
 	
 	return InitStream(m_serializeHeader);
 }
 
 
-bool CJsonWriteArchiveBase::WriteTag(const CArchiveTag &tag, QString separator)
+bool CJsonWriteArchiveBase::WriteTag(const CArchiveTag &tag, const char* separator)
 {
 	if (!m_firstTag){
-		m_stream << ",";
+		WriteRaw(",", 1);
 	}
 
 	bool isWritePrefix = true;
@@ -255,10 +355,12 @@ bool CJsonWriteArchiveBase::WriteTag(const CArchiveTag &tag, QString separator)
 	}
 
 	if (!tag.GetId().isEmpty() && isWritePrefix){
-		m_stream << "\"" << tag.GetId() << "\":";
+		const QByteArray& prefix = GetTagPrefix(tag);
+
+		WriteRaw(prefix.constData(), prefix.size());
 	}
 
-	m_stream << separator;
+	WriteRaw(separator, int(qstrlen(separator)));
 
 	m_firstTag = false;
 
@@ -274,11 +376,13 @@ bool CJsonWriteArchiveBase::WriteJsonHeader()
 
 bool CJsonWriteArchiveBase::Flush()
 {
-	QIODevice* devicePtr = m_stream.device();
+	QIODevice* devicePtr = m_devicePtr;
 	if (devicePtr != nullptr){
 		if (devicePtr->isOpen()){
 			bool retVal = EndTag(m_rootTag);
 
+			retVal = FlushBuffer() && retVal;
+
 			devicePtr->close();
 
 			return retVal;
@@ -289,6 +393,86 @@ bool CJsonWriteArchiveBase::Flush()
 }
 
 
+void CJsonWriteArchiveBase::WriteRaw(const char* dataPtr, int size)
+{
+	m_outputBuffer.append(dataPtr, size);
+
+	if (m_outputBuffer.size() >= s_outputBlockSize){
+		FlushBuffer();
+	}
+}
+
+
+void CJsonWriteArchiveBase::WriteEscaped(const char* dataPtr, int size)
+{
+	static const char hexDigits[] = "0123456789ABCDEF";
+
+	int blockStart = 0;
+
+	for (int i = 0; i < size; ++i){
+		const unsigned char byte = static_cast<unsigned char>(dataPtr[i]);
+		if ((byte >= 0x20) && (byte != '\\') && (byte != '\"')){
+			continue;
+		}
+
+		// characters not requiring escaping are copied as a block
+		if (i > blockStart){
+			m_outputBuffer.append(dataPtr + blockStart, i - blockStart);
+		}
+
+		blockStart = i + 1;
+
+		switch (byte){
+			case '\\':
+				m_outputBuffer.append("\\\\", 2);
+				break;
+			case '\"':
+				m_outputBuffer.append("\\\"", 2);
+				break;
+			case '\b':
+				m_outputBuffer.append("\\b", 2);
+				break;
+			case '\f':
+				m_outputBuffer.append("\\f", 2);
+				break;
+			case '\n':
+				m_outputBuffer.append("\\n", 2);
+				break;
+			case '\r':
+				m_outputBuffer.append("\\r", 2);
+				break;
+			case '\t':
+				m_outputBuffer.append("\\t", 2);
+				break;
+			default:
+				{
+					// Escape ASCII control characters (0x00-0x1F).
+					char escapedControl[6] = {'\\', 'u', '0', '0', hexDigits[byte >> 4], hexDigits[byte & 0x0F]};
+
+					m_outputBuffer.append(escapedControl, 6);
+				}
+				break;
+		}
+	}
+
+	WriteRaw(dataPtr + blockStart, size - blockStart);
+}
+
+
+bool CJsonWriteArchiveBase::FlushBuffer()
+{
+	if (m_outputBuffer.isEmpty()){
+		return true;
+	}
+
+	bool retVal = (m_devicePtr != nullptr) && (m_devicePtr->write(m_outputBuffer) == m_outputBuffer.size());
+
+	m_outputBuffer.resize(0);
+
+	return retVal;
+}
+
+
 // reimplemented (iser::CTextWriteArchiveBase)
 
 bool CJsonWriteArchiveBase::WriteTextNode(const QByteArray &text)
@@ -301,23 +485,66 @@ bool CJsonWriteArchiveBase::WriteTextNode(const QByteArray &text)
 				|| tagType == iser::CArchiveTag::TT_UNKNOWN);
 
 	if (createFakeTag){
-		m_stream << "\"" << m_tagsStack.last().m_tagPtr->GetId() << "\": ";
+		if (!m_firstTag){
+			WriteRaw(",", 1);
+		}
+
+		const QByteArray& prefix = GetTagPrefix(*m_tagsStack.last().m_tagPtr);
+
+		WriteRaw(prefix.constData(), prefix.size());
+		WriteRaw(" ", 1);
+
+		m_firstTag = false;
 	}
 
 	if (m_quotationMarksRequired){
-		m_stream << "\"";
+		WriteRaw("\"", 1);
+	}
+
+	if (m_isEscapingRequired){
+		WriteEscaped(text.constData(), text.size());
+	}
+	else{
+		WriteRaw(text.constData(), text.size());
 	}
 
-	m_stream << text;
-	
 	if (m_quotationMarksRequired){
-		m_stream << "\"";
+		WriteRaw("\"", 1);
 	}
 
 	m_quotationMarksRequired = false;
+	m_isEscapingRequired = false;
 
 	return true;
 }
 
 
+// private methods
+
+const QByteArray& CJsonWriteArchiveBase::GetTagPrefix(const iser::CArchiveTag& tag)
+{
+	TagPrefix& tagPrefix = m_tagPrefixes[&tag];
+
+	// the tag objects can be temporary, the cached prefix is valid only for the same ID
+	const QByteArray& tagId = tag.GetId();
+	if (tagPrefix.prefix.isEmpty() || (tagPrefix.tagId != tagId)){
+		tagPrefix.tagId = tagId;
+
+		tagPrefix.prefix.clear();
+		tagPrefix.prefix.reserve(tagId.size() + 3);
+		tagPrefix.prefix += '"';
+		for (char currentChar : tagId){
+			if ((currentChar == '"') || (currentChar == '\\')){
+				tagPrefix.prefix += '\\';
+			}
+
+			tagPrefix.prefix += currentChar;
+		}
+		tagPrefix.prefix += "\":";
+	}
+
+	return tagPrefix.prefix;
+}
+
+
 } // namespace iser
@@ -7,6 +7,7 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
 #include <QtCore/QVector>
+#include <QtCore/QHash>
 #include <QtCore/QDataStream>
 #include <QtCore/QBuffer>
 
@@ -21,6 +22,10 @@ namespace iser
 
 /**
 	Implementation of an ACF Archive serializing to JSON string
+
+	The output is collected in an internal buffer and written to the device in blocks,
+	so the memory usage does not depend on the document size.
+	Escaped tag names are cached and numbers are formatted without temporary allocations.
 */
 class CJsonWriteArchiveBase: public iser::CTextWriteArchiveBase
 {
@@ -36,6 +41,17 @@ public:
 	virtual bool BeginTag(const iser::CArchiveTag& tag) override;
 	virtual bool BeginMultiTag(const iser::CArchiveTag& tag, const iser::CArchiveTag& subTag, int& count) override;
 	virtual bool EndTag(const iser::CArchiveTag& tag) override;
+	virtual bool Process(char& value) override;
+	virtual bool Process(quint8& value) override;
+	virtual bool Process(qint8& value) override;
+	virtual bool Process(quint16& value) override;
+	virtual bool Process(qint16& value) override;
+	virtual bool Process(quint32& value) override;
+	virtual bool Process(qint32& value) override;
+	virtual bool Process(quint64& value) override;
+	virtual bool Process(qint64& value) override;
+	virtual bool Process(float& value) override;
+	virtual bool Process(double& value) override;
 	virtual bool Process(QString& value) override;
 	virtual bool Process(QByteArray& value) override;
 	virtual bool ProcessData(void* dataPtr, int size) override;
@@ -51,15 +67,31 @@ protected:
 	bool InitStream(bool serializeHeader);
 	bool InitArchive(QIODevice* devicePtr);
 	bool InitArchive(QByteArray& inputString);
-	bool WriteTag(const iser::CArchiveTag& tag, QString separator);
+	bool WriteTag(const iser::CArchiveTag& tag, const char* separator);
 	bool WriteJsonHeader();
 	bool Flush();
 
+	/**
+		Append raw data to the output buffer.
+	*/
+	void WriteRaw(const char* dataPtr, int size);
+
+	/**
+		Append data to the output buffer escaping all characters not allowed in JSON strings.
+	*/
+	void WriteEscaped(const char* dataPtr, int size);
+
+	/**
+		Write the content of the output buffer to the device.
+	*/
+	bool FlushBuffer();
+
 	// reimplemented (iser::CTextWriteArchiveBase)
 	virtual bool WriteTextNode(const QByteArray& text) override;
 
 protected:
-	QTextStream m_stream;
+	QIODevice* m_devicePtr;
+	QByteArray m_outputBuffer;
 	QBuffer m_buffer;
 	bool m_firstTag;
 	QJsonDocument::JsonFormat m_jsonFormat;
@@ -76,8 +108,25 @@ protected:
 	};
 
 	bool m_quotationMarksRequired = false;
+	bool m_isEscapingRequired = false;
 
 	QList<TagsStackItem> m_tagsStack;
+
+private:
+	/**
+		Get escaped tag name with the quotation marks and the key separator.
+	*/
+	const QByteArray& GetTagPrefix(const iser::CArchiveTag& tag);
+
+	struct TagPrefix
+	{
+		QByteArray tagId;
+		QByteArray prefix;
+	};
+
+	typedef QHash<const iser::CArchiveTag*, TagPrefix> TagPrefixes;
+
+	TagPrefixes m_tagPrefixes;
 };
 
 
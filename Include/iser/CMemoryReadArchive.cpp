@@ -22,10 +22,14 @@ CMemoryReadArchive::CMemoryReadArchive(
 :	m_bufferPtr((const quint8*)bufferPtr),
 	m_bufferSize(bufferSize),
 	m_readPosition(0),
-	m_isValid(true)
+	m_isValid(true),
+	m_startPosition(0),
+	m_isDirectReadEnabled(true)
 {
 	if (serializeHeader){
 		m_isValid = SerializeAcfHeader();
+
+		m_startPosition = m_readPosition;
 	}
 }
 
@@ -36,8 +40,9 @@ CMemoryReadArchive::CMemoryReadArchive(
 :	m_bufferPtr((const quint8*)writeArchive.GetBuffer()),
 	m_bufferSize(writeArchive.GetBufferSize()),
 	m_readPosition(0),
+	m_isValid(true),
 	m_startPosition(0),
-	m_isValid(true)
+	m_isDirectReadEnabled(true)
 {
 	if (serializeHeader){
 		m_isValid = SerializeAcfHeader();
@@ -65,6 +70,78 @@ bool CMemoryReadArchive::IsValid() const
 
 // reimplemented (iser::IArchive)
 
+bool CMemoryReadArchive::Process(bool& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(char& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(quint8& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(qint8& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(quint16& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(qint16& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(quint32& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(qint32& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(quint64& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(qint64& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(float& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryReadArchive::Process(double& value)
+{
+	return ProcessValue(value);
+}
+
+
 bool CMemoryReadArchive::ProcessData(void* data, int size)
 {
 	if (m_readPosition + size > m_bufferSize){
@@ -2,6 +2,9 @@
 #pragma once
 
 
+// STL includes
+#include <cstring>
+
 // ACF includes
 #include <iser/CBinaryReadArchiveBase.h>
 
@@ -18,6 +21,9 @@ class CMemoryWriteArchive;
 	Implementation of archive using memory buffer to read the persistent objects.
 	Internal format of this buffer is compatible with class \c iser::CMemoryWriteArchive.
 
+	Primitive values are copied directly from the buffer without dispatching through \c ProcessData.
+	Derived classes reimplementing \c ProcessData have to disable it using \c m_isDirectReadEnabled.
+
 	\ingroup Persistence
 */
 class CMemoryReadArchive: public CBinaryReadArchiveBase
@@ -45,6 +51,18 @@ public:
 	virtual bool IsValid() const;
 
 	// reimplemented (iser::IArchive)
+	virtual bool Process(bool& value) override;
+	virtual bool Process(char& value) override;
+	virtual bool Process(quint8& value) override;
+	virtual bool Process(qint8& value) override;
+	virtual bool Process(quint16& value) override;
+	virtual bool Process(qint16& value) override;
+	virtual bool Process(quint32& value) override;
+	virtual bool Process(qint32& value) override;
+	virtual bool Process(quint64& value) override;
+	virtual bool Process(qint64& value) override;
+	virtual bool Process(float& value) override;
+	virtual bool Process(double& value) override;
 	virtual bool ProcessData(void* data, int size) override;
 
 	// static methods
@@ -81,9 +99,41 @@ protected:
 		Start position of actual data in the buffer (after header, if any)
 	*/
 	int m_startPosition;
+
+	/**
+		Indicates whether primitive values are copied directly from the buffer.
+		Derived classes reimplementing \c ProcessData (e.g. bit archives) must reset it in their constructor.
+	*/
+	bool m_isDirectReadEnabled;
+
+private:
+	template <typename Value>
+	bool ProcessValue(Value& value);
 };
 
 
+// private template methods
+
+template <typename Value>
+inline bool CMemoryReadArchive::ProcessValue(Value& value)
+{
+	if (m_isDirectReadEnabled){
+		if (!m_isValid || (m_readPosition + int(sizeof(Value)) > m_bufferSize)){
+			m_isValid = false;
+
+			return false;
+		}
+
+		std::memcpy(&value, m_bufferPtr + m_readPosition, sizeof(Value));
+		m_readPosition += int(sizeof(Value));
+
+		return true;
+	}
+
+	return ProcessData(&value, int(sizeof(Value)));
+}
+
+
 } // namespace iser
 
 
@@ -13,9 +13,15 @@ namespace iser
 CMemoryWriteArchive::CMemoryWriteArchive(
 			const IVersionInfo* versionInfoPtr,
 			bool serializeHeader)
-:	BaseClass(versionInfoPtr), m_serializeHeader(serializeHeader)
+:	BaseClass(versionInfoPtr),
+	m_serializeHeader(serializeHeader),
+	m_reservedSize(0),
+	m_directWriteState(DWS_UNKNOWN)
 {
 	Reset();
+
+	// the dynamic type is not known during construction, it will be checked on first write
+	m_directWriteState = DWS_UNKNOWN;
 }
 
 
@@ -31,10 +37,24 @@ int CMemoryWriteArchive::GetBufferSize() const
 }
 
 
+void CMemoryWriteArchive::Reserve(int size)
+{
+	m_reservedSize = qMax(size, 0);
+
+	if (m_reservedSize > int(m_dataBuffer.capacity())){
+		m_dataBuffer.reserve(m_reservedSize);
+	}
+}
+
+
 void CMemoryWriteArchive::Reset()
 {
 	m_dataBuffer.clear();
 
+	if (m_reservedSize > 0){
+		m_dataBuffer.reserve(m_reservedSize);
+	}
+
 	if (m_serializeHeader){
 		SerializeAcfHeader();
 	}
@@ -43,6 +63,78 @@ void CMemoryWriteArchive::Reset()
 
 // reimplemented (iser::IArchive)
 
+bool CMemoryWriteArchive::Process(bool& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(char& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(quint8& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(qint8& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(quint16& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(qint16& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(quint32& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(qint32& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(quint64& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(qint64& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(float& value)
+{
+	return ProcessValue(value);
+}
+
+
+bool CMemoryWriteArchive::Process(double& value)
+{
+	return ProcessValue(value);
+}
+
+
 bool CMemoryWriteArchive::ProcessData(void* data, int size)
 {
 	if (size <= 0){
@@ -53,7 +145,7 @@ bool CMemoryWriteArchive::ProcessData(void* data, int size)
 		return false;
 	}
 
-	m_dataBuffer.append((const char*)data, size);
+	AppendData(data, size);
 
 	return true;
 }
@@ -2,6 +2,9 @@
 #pragma once
 
 
+// STL includes
+#include <typeinfo>
+
 // Qt includes
 #include <QtCore/QByteArray>
 
@@ -17,6 +20,10 @@ namespace iser
 	Implementation of archive using memory buffer to store the persistent objects.
 	Internal format of this buffer is compatible with class \c iser::CMemoryReadArchive.
 
+	The data is stored in one contiguous buffer growing geometrically.
+	Primitive values are appended directly to the buffer without dispatching through \c ProcessData.
+	Derived classes reimplementing \c ProcessData are detected automatically and use the generic path.
+
 	\ingroup Persistence
 */
 class CMemoryWriteArchive: public CBinaryWriteArchiveBase
@@ -31,6 +38,13 @@ public:
 	const void* GetBuffer() const;
 	int GetBufferSize() const;
 
+	/**
+		Reserve memory for the internal buffer.
+		The reserved capacity is kept also after \c Reset, so the archive can be reused without reallocation.
+		\param	size	expected size of the stored data in bytes.
+	*/
+	void Reserve(int size);
+
 	/**
 		Reset internal buffer.
 	*/
@@ -40,14 +54,51 @@ public:
 	bool operator!=(const CMemoryWriteArchive& archive) const;
 
 	// reimplemented (iser::IArchive)
+	virtual bool Process(bool& value) override;
+	virtual bool Process(char& value) override;
+	virtual bool Process(quint8& value) override;
+	virtual bool Process(qint8& value) override;
+	virtual bool Process(quint16& value) override;
+	virtual bool Process(qint16& value) override;
+	virtual bool Process(quint32& value) override;
+	virtual bool Process(qint32& value) override;
+	virtual bool Process(quint64& value) override;
+	virtual bool Process(qint64& value) override;
+	virtual bool Process(float& value) override;
+	virtual bool Process(double& value) override;
 	virtual bool ProcessData(void* data, int size) override;
 	
 protected:
 	typedef QByteArray DataBuffer;
 
+	/**
+		Append data to the buffer, the buffer capacity will be grown geometrically.
+	*/
+	void AppendData(const void* dataPtr, int size);
+
 	DataBuffer m_dataBuffer;
 
 	bool m_serializeHeader;
+
+private:
+	enum DirectWriteState
+	{
+		DWS_UNKNOWN,
+		DWS_ENABLED,
+		DWS_DISABLED
+	};
+
+	/**
+		Check if the primitive values can be appended directly to the buffer.
+		It is possible only if \c ProcessData is not reimplemented, it means for this class itself.
+	*/
+	bool IsDirectWriteEnabled() const;
+
+	template <typename Value>
+	bool ProcessValue(const Value& value);
+
+	int m_reservedSize;
+	mutable DirectWriteState m_directWriteState;
 };
 
 
@@ -65,8 +116,47 @@ inline bool CMemoryWriteArchive::operator!=(const CMemoryWriteArchive& archive)
 }
 
 
-} // namespace iser
+// protected inline methods
 
+inline void CMemoryWriteArchive::AppendData(const void* dataPtr, int size)
+{
+	int requiredSize = int(m_dataBuffer.size()) + size;
+	if (requiredSize > int(m_dataBuffer.capacity())){
+		m_dataBuffer.reserve(qMax(requiredSize, int(m_dataBuffer.capacity()) * 2));
+	}
 
+	m_dataBuffer.append(static_cast<const char*>(dataPtr), size);
+}
+
+
+// private inline methods
+
+inline bool CMemoryWriteArchive::IsDirectWriteEnabled() const
+{
+	if (m_directWriteState == DWS_UNKNOWN){
+		// derived classes can reimplement ProcessData (e.g. bit or network archives)
+		m_directWriteState = (typeid(*this) == typeid(CMemoryWriteArchive)) ? DWS_ENABLED : DWS_DISABLED;
+	}
+
+	return (m_directWriteState == DWS_ENABLED);
+}
+
+
+// private template methods
+
+template <typename Value>
+inline bool CMemoryWriteArchive::ProcessValue(const Value& value)
+{
+	if (IsDirectWriteEnabled()){
+		AppendData(&value, int(sizeof(Value)));
+
+		return true;
+	}
+
+	return ProcessData(const_cast<Value*>(&value), int(sizeof(Value)));
+}
+
+
+} // namespace iser
 
 
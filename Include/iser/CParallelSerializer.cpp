@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <iser/CParallelSerializer.h>
+
+
+// Qt includes
+#include <QtCore/QVector>
+
+// ACF includes
+#include <istd/CParallelFor.h>
+#include <iser/CMemoryReadArchive.h>
+#include <iser/CMemoryWriteArchive.h>
+
+
+namespace
+{
+
+
+/**
+	Memory archive reading data of a single element, the version information is taken from the parent archive.
+*/
+class CElementReadArchive: public iser::CMemoryReadArchive
+{
+public:
+	typedef iser::CMemoryReadArchive BaseClass;
+
+	CElementReadArchive(const QByteArray& data, const iser::IVersionInfo& versionInfo)
+	:	BaseClass(data.constData(), int(data.size()), false),
+		m_versionInfo(versionInfo)
+	{
+	}
+
+	// reimplemented (iser::IArchive)
+	virtual const iser::IVersionInfo& GetVersionInfo() const override
+	{
+		return m_versionInfo;
+	}
+
+private:
+	const iser::IVersionInfo& m_versionInfo;
+};
+
+
+} // namespace
+
+
+namespace iser
+{
+
+
+// public static methods
+
+bool CParallelSerializer::SerializeElements(
+			IArchive& archive,
+			const CArchiveTag& elementTag,
+			int elementsCount,
+			const ElementSerializer& elementSerializer)
+{
+	if (elementsCount <= 0){
+		return true;
+	}
+
+	const IVersionInfo& versionInfo = archive.GetVersionInfo();
+
+	QVector<QByteArray> buffers(elementsCount);
+
+	bool retVal = true;
+
+	if (archive.IsStoring()){
+		retVal = istd::CParallelFor::ProcessInParallel(elementsCount, [&buffers, &versionInfo, &elementSerializer](int index){
+			CMemoryWriteArchive elementArchive(&versionInfo, false);
+			if (!elementSerializer(index, elementArchive)){
+				return false;
+			}
+
+			buffers[index] = QByteArray(static_cast<const char*>(elementArchive.GetBuffer()), elementArchive.GetBufferSize());
+
+			return true;
+		});
+
+		for (int i = 0; retVal && (i < elementsCount); ++i){
+			retVal = retVal && archive.BeginTag(elementTag);
+			retVal = retVal && archive.Process(buffers[i]);
+			retVal = retVal && archive.EndTag(elementTag);
+
+			buffers[i].clear();
+		}
+	}
+	else{
+		for (int i = 0; retVal && (i < elementsCount); ++i){
+			retVal = retVal && archive.BeginTag(elementTag);
+			retVal = retVal && archive.Process(buffers[i]);
+			retVal = retVal && archive.EndTag(elementTag);
+		}
+
+		retVal = retVal && istd::CParallelFor::ProcessInParallel(elementsCount, [&buffers, &versionInfo, &elementSerializer](int index){
+			CElementReadArchive elementArchive(buffers[index], versionInfo);
+
+			return elementSerializer(index, elementArchive);
+		});
+	}
+
+	return retVal;
+}
+
+
+} // namespace iser
+
+
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// STL includes
+#include <functional>
+
+// ACF includes
+#include <iser/IArchive.h>
+#include <iser/CArchiveTag.h>
+
+
+namespace iser
+{
+
+
+/**
+	Helper for parallel serialization of independent elements of containers.
+
+	Each element is serialized into its own memory archive using the global thread pool.
+	The buffers are stored in the parent archive in order of the elements, each as a byte array enclosed by the element tag.
+	In text based archives the element data is stored in the encoded binary form.
+	On reading all buffers are loaded first and the elements are deserialized in parallel.
+	This layout differs from the layout of elements serialized one after another, so the same mode must be used for writing and reading.
+	Serialization of different elements must be thread-safe, it means it must not change any shared state.
+
+	\ingroup Persistence
+*/
+class CParallelSerializer
+{
+public:
+	/**
+		Function serializing the element with the given index.
+	*/
+	typedef std::function<bool (int elementIndex, IArchive& archive)> ElementSerializer;
+
+	/**
+		Serialize all elements of a container.
+		The elements tag should be already opened using \c IArchive::BeginMultiTag.
+		\param	elementTag			tag enclosing data of each element.
+		\param	elementsCount		number of elements. On reading the container must already contain this number of elements.
+		\param	elementSerializer	function serializing a single element, it is called from multiple threads.
+	*/
+	static bool SerializeElements(
+				IArchive& archive,
+				const CArchiveTag& elementTag,
+				int elementsCount,
+				const ElementSerializer& elementSerializer);
+};
+
+
+} // namespace iser
+
+
@@ -5,6 +5,7 @@
 // STL includes
 #include <typeinfo>
 #include <memory>
+#include <vector>
 
 // Qt includes
 #include <QtCore/QDateTime>
@@ -19,6 +20,7 @@
 #include <istd/TIndex.h>
 #include <iser/IArchive.h>
 #include <iser/CArchiveTag.h>
+#include <iser/CParallelSerializer.h>
 
 
 namespace iser
@@ -99,12 +101,18 @@ public:
 				const QByteArray& containerTagName = "Elements",
 				const QByteArray& elementTagName = "Element");
 
+	/**
+		Serialize container of serializable objects.
+		\param	useParallelSerialization	if it is true, the elements are serialized in parallel using iser::CParallelSerializer.
+											The archive layout differs in this mode, it must be the same for writing and reading.
+	*/
 	template <typename ContainterType>
 	static bool SerializeObjectContainer(
 				iser::IArchive& archive,
 				ContainterType& container,
 				const QByteArray& containerTagName = "Elements",
-				const QByteArray& elementTagName = "Element");
+				const QByteArray& elementTagName = "Element",
+				bool useParallelSerialization = false);
 
 	/**
 		Method for serialization of the enumerated value using ACF's meta information extensions for the C++ enums.
@@ -254,7 +262,8 @@ bool CPrimitiveTypesSerializer::SerializeObjectContainer(
 	iser::IArchive& archive,
 	ContainerType& container,
 	const QByteArray& containerTagName,
-	const QByteArray& elementTagName)
+	const QByteArray& elementTagName,
+	bool useParallelSerialization)
 {
 	iser::CArchiveTag elementsTag(containerTagName, "List of elements", iser::CArchiveTag::TT_MULTIPLE);
 	iser::CArchiveTag elementTag(elementTagName, "Single element", iser::CArchiveTag::TT_GROUP, &elementsTag);
@@ -269,6 +278,37 @@ bool CPrimitiveTypesSerializer::SerializeObjectContainer(
 		return false;
 	}
 
+	if (useParallelSerialization){
+		typedef typename ContainerType::value_type Element;
+
+		if (isStoring){
+			const ContainerType& constContainer = container;
+
+			retVal = CParallelSerializer::SerializeElements(archive, elementTag, elementsCount, [&constContainer](int index, iser::IArchive& elementArchive){
+				Element element = constContainer[index];
+
+				return element.Serialize(elementArchive);
+			});
+		}
+		else{
+			container.clear();
+
+			std::vector<Element> elements(elementsCount > 0 ? elementsCount : 0);
+
+			retVal = CParallelSerializer::SerializeElements(archive, elementTag, elementsCount, [&elements](int index, iser::IArchive& elementArchive){
+				return elements[index].Serialize(elementArchive);
+			});
+
+			if (retVal){
+				for (int i = 0; i < elementsCount; ++i){
+					container.push_back(elements[i]);
+				}
+			}
+		}
+
+		return retVal && archive.EndTag(elementsTag);
+	}
+
 	if (isStoring){
 		for (int i = 0; i < elementsCount; ++i){
 			typename ContainerType::value_type element = container[i];
@@ -48,6 +48,12 @@ bool CReadArchiveBase::SerializeAcfHeader()
 }
 
 
+quint32 CReadArchiveBase::GetArchiveFormatVersion() const
+{
+	return m_versionInfo.GetArchiveFormatVersion();
+}
+
+
 } // namespace iser
 
 
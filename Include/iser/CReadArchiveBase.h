@@ -30,6 +30,12 @@ protected:
 	*/
 	bool SerializeAcfHeader();
 
+	/**
+		Get version of the archive container format loaded from the header.
+		\sa iser::CArchiveHeaderInfo::ArchiveFormatVersion.
+	*/
+	quint32 GetArchiveFormatVersion() const;
+
 private:
 	CArchiveHeaderInfo m_versionInfo;
 };
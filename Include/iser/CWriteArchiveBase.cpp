@@ -57,9 +57,9 @@ CWriteArchiveBase::CWriteArchiveBase(const IVersionInfo* versionInfoPtr)
 }
 
 
-bool CWriteArchiveBase::SerializeAcfHeader()
+bool CWriteArchiveBase::SerializeAcfHeader(quint32 archiveFormatVersion)
 {
-	return CArchiveHeaderInfo::WriteArchiveHeader(*this, m_versionInfoPtr);
+	return CArchiveHeaderInfo::WriteArchiveHeader(*this, m_versionInfoPtr, archiveFormatVersion);
 }
 
 
@@ -5,6 +5,7 @@
 // ACF includes
 #include <iser/IVersionInfo.h>
 #include <iser/CArchiveBase.h>
+#include <iser/CArchiveHeaderInfo.h>
 
 
 namespace iser
@@ -36,8 +37,9 @@ protected:
 	/**
 		Serialize standard header.
 		During serialization of header list of known versions will be loaded.
+		\param	archiveFormatVersion	version of the archive container format, \sa iser::CArchiveHeaderInfo::ArchiveFormatVersion.
 	*/
-	bool SerializeAcfHeader();
+	bool SerializeAcfHeader(quint32 archiveFormatVersion = CArchiveHeaderInfo::AFV_CLASSIC);
 
 	class EmptyVersionInfo: virtual public IVersionInfo
 	{
@@ -31,6 +31,16 @@ public:
 	enum VersionId
 	{
 		AcfVersionId = 0,
+		/**
+			Reserved ID used in the archive header of secure file archives to store the encoding of the archive data.
+			\sa ifile::CFileArchiveInfo::SecureFormat.
+		*/
+		SecureFormatVersionId = 1021,
+		/**
+			Reserved ID used in the archive header to store the version of the archive container format.
+			\sa iser::CArchiveHeaderInfo::ArchiveFormatVersion.
+		*/
+		ArchiveFormatVersionId = 1022,
 		QtVersionId = 1023,
 		UserVersionId = 1024
 	};
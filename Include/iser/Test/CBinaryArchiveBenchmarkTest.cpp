@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <iser/Test/CBinaryArchiveBenchmarkTest.h>
+
+
+// ACF includes
+#include <iser/CArchiveTag.h>
+#include <iser/CBitMemoryReadArchive.h>
+#include <iser/CBitMemoryWriteArchive.h>
+
+
+namespace
+{
+
+
+static const int s_valuesCount = 1000000;
+static const int s_tagsDepth = 16;
+static const int s_tagsRepeatCount = 20000;
+
+
+bool SerializeNestedTags(iser::IArchive& archive, int depth)
+{
+	static iser::CArchiveTag nodeTag("Node", "Node of the hierarchy");
+
+	bool retVal = archive.BeginTag(nodeTag);
+
+	qint32 level = depth;
+	retVal = retVal && archive.Process(level);
+
+	if (depth > 0){
+		retVal = retVal && SerializeNestedTags(archive, depth - 1);
+	}
+
+	retVal = retVal && archive.EndTag(nodeTag);
+
+	return retVal;
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CBinaryArchiveBenchmarkTest::initTestCase()
+{
+	m_values.resize(s_valuesCount);
+	for (int i = 0; i < s_valuesCount; ++i){
+		m_values[i] = i * 0.5;
+	}
+}
+
+
+void CBinaryArchiveBenchmarkTest::ArrayCompatibilityTest()
+{
+	QVector<double> values = m_values.mid(0, 1000);
+
+	iser::CMemoryWriteArchive valuesArchive;
+	for (int i = 0; i < values.size(); ++i){
+		QVERIFY(valuesArchive.Process(values[i]));
+	}
+
+	iser::CMemoryWriteArchive arrayArchive;
+	QVERIFY(arrayArchive.ProcessArray(values.data(), values.size()));
+
+	QVERIFY(valuesArchive == arrayArchive);
+
+	QVector<double> readValues(values.size());
+	iser::CMemoryReadArchive readArchive(valuesArchive);
+	QVERIFY(readArchive.ProcessArray(readValues.data(), readValues.size()));
+	QCOMPARE(readValues, values);
+
+	double extraValue = 0;
+	QVERIFY(!readArchive.Process(extraValue));
+	QVERIFY(!readArchive.IsValid());
+
+	// derived archives reimplementing ProcessData must not be bypassed
+	iser::CBitMemoryWriteArchive bitWriteArchive;
+	QVERIFY(bitWriteArchive.ProcessArray(values.data(), 10));
+	quint16 shortValue = 0x1234;
+	QVERIFY(bitWriteArchive.Process(shortValue));
+
+	iser::CBitMemoryReadArchive bitReadArchive(bitWriteArchive);
+	QVERIFY(bitReadArchive.ProcessArray(readValues.data(), 10));
+	QVERIFY(bitReadArchive.Process(shortValue));
+	QCOMPARE(readValues.mid(0, 10), values.mid(0, 10));
+	QCOMPARE(shortValue, quint16(0x1234));
+}
+
+
+void CBinaryArchiveBenchmarkTest::ReserveTest()
+{
+	iser::CMemoryWriteArchive archive(NULL, false);
+	archive.Reserve(s_valuesCount * int(sizeof(double)));
+
+	const void* bufferPtr = archive.GetBuffer();
+
+	QVERIFY(archive.ProcessArray(m_values.data(), m_values.size()));
+	QCOMPARE(archive.GetBufferSize(), s_valuesCount * int(sizeof(double)));
+	QVERIFY(archive.GetBuffer() == bufferPtr);
+
+	archive.Reset();
+	QCOMPARE(archive.GetBufferSize(), 0);
+
+	QVERIFY(archive.ProcessArray(m_values.data(), m_values.size()));
+	QCOMPARE(archive.GetBufferSize(), s_valuesCount * int(sizeof(double)));
+}
+
+
+void CBinaryArchiveBenchmarkTest::WriteDoublesBenchmark_data()
+{
+	QTest::addColumn<bool>("useArray");
+
+	QTest::newRow("values") << false;
+	QTest::newRow("array") << true;
+}
+
+
+void CBinaryArchiveBenchmarkTest::WriteDoublesBenchmark()
+{
+	QFETCH(bool, useArray);
+
+	iser::CMemoryWriteArchive archive(NULL, false);
+
+	QBENCHMARK{
+		archive.Reset();
+
+		if (useArray){
+			archive.ProcessArray(m_values.data(), m_values.size());
+		}
+		else{
+			for (int i = 0; i < s_valuesCount; ++i){
+				archive.Process(m_values[i]);
+			}
+		}
+	}
+
+	QCOMPARE(archive.GetBufferSize(), s_valuesCount * int(sizeof(double)));
+}
+
+
+void CBinaryArchiveBenchmarkTest::ReadDoublesBenchmark_data()
+{
+	QTest::addColumn<bool>("useArray");
+
+	QTest::newRow("values") << false;
+	QTest::newRow("array") << true;
+}
+
+
+void CBinaryArchiveBenchmarkTest::ReadDoublesBenchmark()
+{
+	QFETCH(bool, useArray);
+
+	iser::CMemoryWriteArchive writeArchive(NULL, false);
+	QVERIFY(writeArchive.ProcessArray(m_values.data(), m_values.size()));
+
+	QVector<double> readValues(s_valuesCount);
+
+	QBENCHMARK{
+		iser::CMemoryReadArchive readArchive(writeArchive, false);
+
+		if (useArray){
+			readArchive.ProcessArray(readValues.data(), readValues.size());
+		}
+		else{
+			for (int i = 0; i < s_valuesCount; ++i){
+				readArchive.Process(readValues[i]);
+			}
+		}
+	}
+
+	QCOMPARE(readValues, m_values);
+}
+
+
+void CBinaryArchiveBenchmarkTest::NestedTagsBenchmark()
+{
+	iser::CMemoryWriteArchive writeArchive(NULL, false);
+
+	QBENCHMARK{
+		writeArchive.Reset();
+
+		for (int i = 0; i < s_tagsRepeatCount; ++i){
+			SerializeNestedTags(writeArchive, s_tagsDepth);
+		}
+	}
+
+	iser::CMemoryReadArchive readArchive(writeArchive, false);
+	for (int i = 0; i < s_tagsRepeatCount; ++i){
+		QVERIFY(SerializeNestedTags(readArchive, s_tagsDepth));
+	}
+}
+
+
+void CBinaryArchiveBenchmarkTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CBinaryArchiveBenchmarkTest);
+
+
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <iser/CMemoryReadArchive.h>
+#include <iser/CMemoryWriteArchive.h>
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Throughput benchmark of the binary memory archives.
+	Results are reported in bytes per second for one million doubles stored value by value and as one array,
+	and for a deep hierarchy of nested tags.
+*/
+class CBinaryArchiveBenchmarkTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void ArrayCompatibilityTest();
+	void ReserveTest();
+
+	void WriteDoublesBenchmark_data();
+	void WriteDoublesBenchmark();
+	void ReadDoublesBenchmark_data();
+	void ReadDoublesBenchmark();
+	void NestedTagsBenchmark();
+
+	void cleanupTestCase();
+
+private:
+	QVector<double> m_values;
+};
+
+
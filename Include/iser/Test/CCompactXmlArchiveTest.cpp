@@ -6,6 +6,16 @@
 #include <itest/CStandardTestExecutor.h>
 
 
+namespace
+{
+
+
+static const int s_largeDocumentSize = 200000;
+
+
+} // namespace
+
+
 void CCompactXmlArchiveTest::BasicCompactXmlSerializationTest()
 {
 	// Write data
@@ -70,4 +80,78 @@ void CCompactXmlArchiveTest::CompactXmlArrayTest()
 }
 
 
+void CCompactXmlArchiveTest::OutOfOrderTagsTest()
+{
+	QByteArray xmlData(
+				"<Acf>\n"
+				"\t<StringValue>Reordered</StringValue>\n"
+				"\t<Unknown><IntValue>1</IntValue></Unknown>\n"
+				"\t<DoubleValue>2.5</DoubleValue>\n"
+				"\t<IntValue>42</IntValue>\n"
+				"</Acf>\n");
+
+	ComplexModel readModel;
+	iser::CCompactXmlMemReadArchive readArchive(xmlData, false);
+	QVERIFY(readModel.Serialize(readArchive));
+
+	QCOMPARE(readModel.intValue, 42);
+	QCOMPARE(readModel.doubleValue, 2.5);
+	QCOMPARE(readModel.stringValue, QString("Reordered"));
+}
+
+
+void CCompactXmlArchiveTest::MultiTagCountTest_data()
+{
+	QTest::addColumn<QByteArray>("xmlData");
+	QTest::addColumn<int>("expectedCount");
+
+	QTest::newRow("empty") << QByteArray("<Acf><Numbers/></Acf>") << 0;
+	QTest::newRow("in order") << QByteArray("<Acf><Numbers><Number>1</Number><Number>2</Number><Number>3</Number></Numbers></Acf>") << 3;
+	QTest::newRow("after skipped element")
+				<< QByteArray("<Acf><Other><Numbers><Number>9</Number></Numbers></Other><Numbers><Number>1</Number><Number>2</Number></Numbers></Acf>")
+				<< 2;
+	QTest::newRow("mixed children")
+				<< QByteArray("<Acf><Numbers><Separator/><Number>1</Number><Number>2</Number></Numbers></Acf>")
+				<< 2;
+}
+
+
+void CCompactXmlArchiveTest::MultiTagCountTest()
+{
+	QFETCH(QByteArray, xmlData);
+	QFETCH(int, expectedCount);
+
+	ArrayModel readModel;
+	iser::CCompactXmlMemReadArchive readArchive(xmlData, false);
+	QVERIFY(readModel.Serialize(readArchive));
+
+	QCOMPARE(int(readModel.numbers.size()), expectedCount);
+	for (int i = 0; i < expectedCount; ++i){
+		QCOMPARE(readModel.numbers[i], double(i + 1));
+	}
+}
+
+
+void CCompactXmlArchiveTest::LargeDocumentReadBenchmark()
+{
+	ArrayModel writeModel;
+	for (int i = 0; i < s_largeDocumentSize; ++i){
+		writeModel.numbers.push_back(i * 0.5);
+	}
+
+	iser::CCompactXmlMemWriteArchive writeArchive;
+	QVERIFY(writeModel.Serialize(writeArchive));
+	QByteArray xmlData = writeArchive.GetString();
+
+	ArrayModel readModel;
+
+	QBENCHMARK{
+		iser::CCompactXmlMemReadArchive readArchive(xmlData);
+		QVERIFY(readModel.Serialize(readArchive));
+	}
+
+	QVERIFY(readModel == writeModel);
+}
+
+
 I_ADD_TEST(CCompactXmlArchiveTest);
@@ -22,6 +22,10 @@ private Q_SLOTS:
 	void BasicCompactXmlSerializationTest();
 	void CompactXmlComplexDataTest();
 	void CompactXmlArrayTest();
+	void OutOfOrderTagsTest();
+	void MultiTagCountTest_data();
+	void MultiTagCountTest();
+	void LargeDocumentReadBenchmark();
 
 private:
 	class SimpleModel: virtual public iser::ISerializable
@@ -9,6 +9,17 @@
 #include <itest/CStandardTestExecutor.h>
 
 
+namespace
+{
+
+
+static const int s_largeDocumentRowsCount = 1000;
+static const int s_largeDocumentColumnsCount = 100;
+
+
+} // namespace
+
+
 void CJsonMemoryReadArchiveTest::DoTest()
 {
 	Model model;
@@ -47,4 +58,74 @@ void CJsonMemoryReadArchiveTest::DoArrayTest()
 	QVERIFY(model2 == model);
 }
 
+void CJsonMemoryReadArchiveTest::OutOfOrderKeysTest_data()
+{
+	QTest::addColumn<bool>("isSequential");
+
+	QTest::newRow("seekable device") << false;
+	QTest::newRow("sequential device") << true;
+}
+
+
+void CJsonMemoryReadArchiveTest::OutOfOrderKeysTest()
+{
+	QFETCH(bool, isSequential);
+
+	static iser::CArchiveTag rootTag("Root", "Root object");
+
+	QByteArray data(
+				"{\"Root\": {\n"
+				"\t\"Other\": [[9, 9, 9], {\"Data\": [\"x\"]}],\n"
+				"\t\"Data\": [[1, 1.5], [2e1]]\n"
+				"}}");
+
+	istd::TDelPtr<iser::CJsonReadArchiveBase> readArchivePtr;
+	if (isSequential){
+		readArchivePtr.SetPtr(new SequentialReadArchive(data));
+	}
+	else{
+		readArchivePtr.SetPtr(new iser::CJsonMemReadArchive(data, false));
+	}
+
+	NestedArray model;
+	QVERIFY(readArchivePtr->BeginTag(rootTag));
+	QVERIFY(model.Serialize(*readArchivePtr));
+	QVERIFY(readArchivePtr->EndTag(rootTag));
+
+	QList<QList<double>> expectedData;
+	expectedData << (QList<double>() << 1.0 << 1.5) << (QList<double>() << 20.0);
+
+	QVERIFY(model == NestedArray(expectedData));
+}
+
+
+void CJsonMemoryReadArchiveTest::LargeDocumentBenchmark()
+{
+	QList<QList<double>> modelData;
+	for (int i = 0; i < s_largeDocumentRowsCount; ++i){
+		QList<double> row;
+		for (int j = 0; j < s_largeDocumentColumnsCount; ++j){
+			row.push_back(i + j * 0.25);
+		}
+
+		modelData.push_back(row);
+	}
+
+	NestedArray model(modelData);
+
+	iser::CJsonMemWriteArchive writeArchive;
+	QVERIFY(model.Serialize(writeArchive));
+	QByteArray data = writeArchive.GetData();
+
+	NestedArray model2;
+
+	QBENCHMARK{
+		iser::CJsonMemReadArchive readArchive(data);
+		QVERIFY(model2.Serialize(readArchive));
+	}
+
+	QVERIFY(model2 == model);
+}
+
+
 I_ADD_TEST(CJsonMemoryReadArchiveTest);
@@ -20,8 +20,39 @@ class CJsonMemoryReadArchiveTest: public QObject
 private Q_SLOTS:
 	void DoTest();
 	void DoArrayTest();
+	void OutOfOrderKeysTest_data();
+	void OutOfOrderKeysTest();
+	void LargeDocumentBenchmark();
 
 private:
+	/**
+		Archive reading from a buffer reported as a sequential device.
+	*/
+	class SequentialReadArchive: public iser::CJsonReadArchiveBase
+	{
+	public:
+		explicit SequentialReadArchive(const QByteArray& data)
+			:iser::CJsonReadArchiveBase(false)
+		{
+			m_buffer.setData(data);
+			m_buffer.open(QIODevice::ReadOnly);
+
+			SetContent(&m_buffer);
+		}
+
+	private:
+		class SequentialBuffer: public QBuffer
+		{
+		public:
+			virtual bool isSequential() const override
+			{
+				return true;
+			}
+		};
+
+		SequentialBuffer m_buffer;
+	};
+
 	class Model: virtual public iser::ISerializable
 	{
 	public:
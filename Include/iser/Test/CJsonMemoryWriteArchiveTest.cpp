@@ -2,6 +2,9 @@
 #include <iser/Test/CJsonMemoryWriteArchiveTest.h>
 
 
+// STL includes
+#include <limits>
+
 // ACF includes
 #include <istd/TDelPtr.h>
 #include <imod/TModelWrap.h>
@@ -177,6 +180,56 @@ void CJsonMemoryWriteArchiveTest::InvalidReadStateTest()
 }
 
 
+void CJsonMemoryWriteArchiveTest::NumberFormattingTest()
+{
+	static iser::CArchiveTag int64Tag("Int64", "Signed 64-bit value", iser::CArchiveTag::TT_LEAF);
+	static iser::CArchiveTag uint64Tag("UInt64", "Unsigned 64-bit value", iser::CArchiveTag::TT_LEAF);
+	static iser::CArchiveTag int32Tag("Int32", "Signed 32-bit value", iser::CArchiveTag::TT_LEAF);
+	static iser::CArchiveTag floatTag("Float", "Float value", iser::CArchiveTag::TT_LEAF);
+	static iser::CArchiveTag doubleTag("Double", "Double value", iser::CArchiveTag::TT_LEAF);
+
+	qint64 int64Value = std::numeric_limits<qint64>::min();
+	quint64 uint64Value = std::numeric_limits<quint64>::max();
+	qint32 int32Value = -123;
+	float floatValue = 1.5f;
+	double doubleValue = 0.1;
+
+	iser::CJsonMemWriteArchive writeArchive(nullptr, false);
+	QVERIFY(writeArchive.BeginTag(int64Tag) && writeArchive.Process(int64Value) && writeArchive.EndTag(int64Tag));
+	QVERIFY(writeArchive.BeginTag(uint64Tag) && writeArchive.Process(uint64Value) && writeArchive.EndTag(uint64Tag));
+	QVERIFY(writeArchive.BeginTag(int32Tag) && writeArchive.Process(int32Value) && writeArchive.EndTag(int32Tag));
+	QVERIFY(writeArchive.BeginTag(floatTag) && writeArchive.Process(floatValue) && writeArchive.EndTag(floatTag));
+	QVERIFY(writeArchive.BeginTag(doubleTag) && writeArchive.Process(doubleValue) && writeArchive.EndTag(doubleTag));
+
+	const QByteArray buffer = writeArchive.GetData();
+	QVERIFY(buffer.contains("\"Int64\":-9223372036854775808"));
+	QVERIFY(buffer.contains("\"UInt64\":18446744073709551615"));
+	QVERIFY(buffer.contains("\"Int32\":-123"));
+	QVERIFY(buffer.contains("\"Float\":1.5"));
+	QVERIFY(buffer.contains("\"Double\":0.1"));
+
+	qint64 restoredInt64 = 0;
+	quint64 restoredUInt64 = 0;
+	qint32 restoredInt32 = 0;
+	float restoredFloat = 0;
+	double restoredDouble = 0;
+
+	// integers must be read without the conversion to double
+	iser::CJsonMemReadArchive readArchive(buffer, false);
+	QVERIFY(readArchive.BeginTag(int64Tag) && readArchive.Process(restoredInt64) && readArchive.EndTag(int64Tag));
+	QVERIFY(readArchive.BeginTag(uint64Tag) && readArchive.Process(restoredUInt64) && readArchive.EndTag(uint64Tag));
+	QVERIFY(readArchive.BeginTag(int32Tag) && readArchive.Process(restoredInt32) && readArchive.EndTag(int32Tag));
+	QVERIFY(readArchive.BeginTag(floatTag) && readArchive.Process(restoredFloat) && readArchive.EndTag(floatTag));
+	QVERIFY(readArchive.BeginTag(doubleTag) && readArchive.Process(restoredDouble) && readArchive.EndTag(doubleTag));
+
+	QCOMPARE(restoredInt64, int64Value);
+	QCOMPARE(restoredUInt64, uint64Value);
+	QCOMPARE(restoredInt32, int32Value);
+	QCOMPARE(restoredFloat, floatValue);
+	QCOMPARE(restoredDouble, doubleValue);
+}
+
+
 void CJsonMemoryWriteArchiveTest::DoTest()
 {
 	m_buffer.clear();
@@ -43,6 +43,7 @@ private slots:
 	void ObjectContainerSerializeTest();
 	void EscapingTest();
 	void InvalidReadStateTest();
+	void NumberFormattingTest();
 	void DoTest();
 
 private:
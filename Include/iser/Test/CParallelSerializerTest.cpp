@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <iser/Test/CParallelSerializerTest.h>
+
+
+// Qt includes
+#include <QtCore/QVector>
+
+// ACF includes
+#include <iser/CParallelSerializer.h>
+#include <iser/CPrimitiveTypesSerializer.h>
+#include <iser/CMemoryReadArchive.h>
+#include <iser/CMemoryWriteArchive.h>
+#include <iser/CCompactXmlMemReadArchive.h>
+#include <iser/CCompactXmlMemWriteArchive.h>
+#include <iser/ISerializable.h>
+
+
+namespace
+{
+
+
+enum ArchiveType
+{
+	AT_MEMORY,
+	AT_COMPACT_XML
+};
+
+
+static const int s_benchmarkElementsCount = 2000;
+
+
+class CTestElement: virtual public iser::ISerializable
+{
+public:
+	CTestElement()
+	:	id(0)
+	{
+	}
+
+	// reimplemented (iser::ISerializable)
+	virtual bool Serialize(iser::IArchive& archive) override
+	{
+		static iser::CArchiveTag idTag("Id", "Element ID", iser::CArchiveTag::TT_LEAF);
+		static iser::CArchiveTag textTag("Text", "Element text", iser::CArchiveTag::TT_LEAF);
+		static iser::CArchiveTag valuesTag("Values", "Element values", iser::CArchiveTag::TT_MULTIPLE);
+		static iser::CArchiveTag valueTag("Value", "Single value", iser::CArchiveTag::TT_LEAF, &valuesTag);
+
+		bool retVal = archive.BeginTag(idTag);
+		retVal = retVal && archive.Process(id);
+		retVal = retVal && archive.EndTag(idTag);
+
+		retVal = retVal && archive.BeginTag(textTag);
+		retVal = retVal && archive.Process(text);
+		retVal = retVal && archive.EndTag(textTag);
+
+		int valuesCount = values.size();
+		retVal = retVal && archive.BeginMultiTag(valuesTag, valueTag, valuesCount);
+		if (!archive.IsStoring()){
+			values.resize(valuesCount);
+		}
+
+		for (int i = 0; retVal && (i < valuesCount); ++i){
+			retVal = retVal && archive.BeginTag(valueTag);
+			retVal = retVal && archive.Process(values[i]);
+			retVal = retVal && archive.EndTag(valueTag);
+		}
+
+		retVal = retVal && archive.EndTag(valuesTag);
+
+		return retVal;
+	}
+
+	bool operator==(const CTestElement& other) const
+	{
+		return (id == other.id) && (text == other.text) && (values == other.values);
+	}
+
+	int id;
+	QString text;
+	QVector<double> values;
+};
+
+
+QList<CTestElement> CreateElements(int count, int valuesCount)
+{
+	QList<CTestElement> retVal;
+
+	for (int i = 0; i < count; ++i){
+		CTestElement element;
+		element.id = i;
+		element.text = QString("Element %1").arg(i);
+
+		for (int valueIndex = 0; valueIndex < valuesCount; ++valueIndex){
+			element.values.push_back(i + valueIndex * 0.5);
+		}
+
+		retVal.push_back(element);
+	}
+
+	return retVal;
+}
+
+
+bool WriteElements(int archiveType, QList<CTestElement>& elements, bool useParallelSerialization, QByteArray& data)
+{
+	bool retVal = false;
+
+	if (archiveType == AT_MEMORY){
+		iser::CMemoryWriteArchive writeArchive;
+		retVal = iser::CPrimitiveTypesSerializer::SerializeObjectContainer(writeArchive, elements, "Elements", "Element", useParallelSerialization);
+
+		data = QByteArray(static_cast<const char*>(writeArchive.GetBuffer()), writeArchive.GetBufferSize());
+	}
+	else{
+		iser::CCompactXmlMemWriteArchive writeArchive;
+		retVal = iser::CPrimitiveTypesSerializer::SerializeObjectContainer(writeArchive, elements, "Elements", "Element", useParallelSerialization);
+
+		data = writeArchive.GetString();
+	}
+
+	return retVal;
+}
+
+
+bool ReadElements(int archiveType, const QByteArray& data, bool useParallelSerialization, QList<CTestElement>& elements)
+{
+	if (archiveType == AT_MEMORY){
+		iser::CMemoryReadArchive readArchive(data.constData(), int(data.size()));
+
+		return iser::CPrimitiveTypesSerializer::SerializeObjectContainer(readArchive, elements, "Elements", "Element", useParallelSerialization);
+	}
+
+	iser::CCompactXmlMemReadArchive readArchive(data);
+
+	return iser::CPrimitiveTypesSerializer::SerializeObjectContainer(readArchive, elements, "Elements", "Element", useParallelSerialization);
+}
+
+
+} // namespace
+
+
+void CParallelSerializerTest::FailedProcessingTest()
+{
+	// failure of an element is reported
+	QList<CTestElement> elements = CreateElements(10, 1);
+
+	iser::CMemoryWriteArchive writeArchive;
+	static iser::CArchiveTag elementTag("Element", "Single element", iser::CArchiveTag::TT_GROUP);
+
+	bool retVal = iser::CParallelSerializer::SerializeElements(writeArchive, elementTag, elements.size(), [](int index, iser::IArchive& /*archive*/){
+		return index != 3;
+	});
+
+	QVERIFY(!retVal);
+}
+
+
+void CParallelSerializerTest::ObjectContainerTest_data()
+{
+	QTest::addColumn<int>("archiveType");
+	QTest::addColumn<int>("elementsCount");
+
+	QTest::newRow("Memory, empty") << int(AT_MEMORY) << 0;
+	QTest::newRow("Memory, single element") << int(AT_MEMORY) << 1;
+	QTest::newRow("Memory, 1000 elements") << int(AT_MEMORY) << 1000;
+	QTest::newRow("Compact XML, 100 elements") << int(AT_COMPACT_XML) << 100;
+}
+
+
+void CParallelSerializerTest::ObjectContainerTest()
+{
+	QFETCH(int, archiveType);
+	QFETCH(int, elementsCount);
+
+	QList<CTestElement> elements = CreateElements(elementsCount, 10);
+
+	QByteArray data;
+	QVERIFY(WriteElements(archiveType, elements, true, data));
+
+	QList<CTestElement> readElements = CreateElements(3, 1);
+	QVERIFY(ReadElements(archiveType, data, true, readElements));
+
+	QCOMPARE(readElements.size(), elements.size());
+	for (int i = 0; i < elements.size(); ++i){
+		QVERIFY(readElements[i] == elements[i]);
+	}
+
+	// the serialization is deterministic
+	QByteArray secondData;
+	QVERIFY(WriteElements(archiveType, elements, true, secondData));
+	QCOMPARE(secondData, data);
+}
+
+
+void CParallelSerializerTest::ObjectContainerBenchmark_data()
+{
+	QTest::addColumn<bool>("useParallelSerialization");
+
+	QTest::newRow("Sequential") << false;
+	QTest::newRow("Parallel") << true;
+}
+
+
+void CParallelSerializerTest::ObjectContainerBenchmark()
+{
+	QFETCH(bool, useParallelSerialization);
+
+	QList<CTestElement> elements = CreateElements(s_benchmarkElementsCount, 200);
+
+	bool retVal = true;
+
+	QBENCHMARK{
+		QByteArray data;
+		retVal = retVal && WriteElements(AT_COMPACT_XML, elements, useParallelSerialization, data);
+
+		QList<CTestElement> readElements;
+		retVal = retVal && ReadElements(AT_COMPACT_XML, data, useParallelSerialization, readElements);
+		retVal = retVal && (readElements.size() == elements.size());
+	}
+
+	QVERIFY(retVal);
+}
+
+
+I_ADD_TEST(CParallelSerializerTest);
+
+
@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <istd/CBinaryDelta.h>
+
+
+// STL includes
+#include <climits>
+#include <cstring>
+
+// Qt includes
+#include <QtCore/QHash>
+
+
+namespace istd
+{
+
+
+namespace
+{
+
+
+/**
+	Size of the blocks used for matching of the moved data.
+*/
+static const int s_blockSize = 32;
+
+/**
+	Multiplier of the polynomial rolling hash.
+*/
+static const quint32 s_hashFactor = 0x01000193;
+
+
+quint32 CalculateHash(const quint8* dataPtr)
+{
+	quint32 retVal = 0;
+
+	for (int i = 0; i < s_blockSize; ++i){
+		retVal = retVal * s_hashFactor + dataPtr[i];
+	}
+
+	return retVal;
+}
+
+
+} // namespace
+
+
+// public static methods
+
+QByteArray CBinaryDelta::CreateDelta(const void* basePtr, int baseSize, const void* targetPtr, int targetSize)
+{
+	const quint8* base = static_cast<const quint8*>(basePtr);
+	const quint8* target = static_cast<const quint8*>(targetPtr);
+
+	QByteArray retVal;
+
+	WriteNumber(quint32(baseSize), retVal);
+	WriteNumber(quint32(targetSize), retVal);
+
+	int maxCommonSize = qMin(baseSize, targetSize);
+
+	int prefixSize = 0;
+	while ((prefixSize < maxCommonSize) && (base[prefixSize] == target[prefixSize])){
+		++prefixSize;
+	}
+
+	int suffixSize = 0;
+	while ((suffixSize < maxCommonSize - prefixSize) && (base[baseSize - suffixSize - 1] == target[targetSize - suffixSize - 1])){
+		++suffixSize;
+	}
+
+	WriteCopy(0, prefixSize, retVal);
+
+	int baseEnd = baseSize - suffixSize;
+	int targetEnd = targetSize - suffixSize;
+
+	int literalBegin = prefixSize;
+
+	if ((baseEnd - prefixSize >= s_blockSize) && (targetEnd - prefixSize >= s_blockSize)){
+		// index of non-overlapping blocks of the changed base data
+		QHash<quint32, int> blockIndex;
+		blockIndex.reserve((baseEnd - prefixSize) / s_blockSize);
+
+		for (int position = prefixSize; position + s_blockSize <= baseEnd; position += s_blockSize){
+			quint32 hash = CalculateHash(base + position);
+			if (!blockIndex.contains(hash)){
+				blockIndex.insert(hash, position);
+			}
+		}
+
+		// factor of the byte leaving the rolling window
+		quint32 leavingFactor = 1;
+		for (int i = 1; i < s_blockSize; ++i){
+			leavingFactor *= s_hashFactor;
+		}
+
+		int position = prefixSize;
+		quint32 hash = CalculateHash(target + position);
+
+		while (position + s_blockSize <= targetEnd){
+			QHash<quint32, int>::ConstIterator foundIter = blockIndex.constFind(hash);
+			if ((foundIter != blockIndex.constEnd()) && (std::memcmp(base + foundIter.value(), target + position, s_blockSize) == 0)){
+				int matchBase = foundIter.value();
+				int matchTarget = position;
+				int matchSize = s_blockSize;
+
+				while ((matchTarget > literalBegin) && (matchBase > 0) && (base[matchBase - 1] == target[matchTarget - 1])){
+					--matchBase;
+					--matchTarget;
+					++matchSize;
+				}
+
+				while ((matchTarget + matchSize < targetEnd) && (matchBase + matchSize < baseSize) && (base[matchBase + matchSize] == target[matchTarget + matchSize])){
+					++matchSize;
+				}
+
+				WriteInsert(reinterpret_cast<const char*>(target + literalBegin), matchTarget - literalBegin, retVal);
+				WriteCopy(matchBase, matchSize, retVal);
+
+				position = matchTarget + matchSize;
+				literalBegin = position;
+
+				if (position + s_blockSize <= targetEnd){
+					hash = CalculateHash(target + position);
+				}
+			}
+			else{
+				if (position + s_blockSize < targetEnd){
+					hash = (hash - target[position] * leavingFactor) * s_hashFactor + target[position + s_blockSize];
+				}
+
+				++position;
+			}
+		}
+	}
+
+	WriteInsert(reinterpret_cast<const char*>(target + literalBegin), targetEnd - literalBegin, retVal);
+	WriteCopy(baseEnd, suffixSize, retVal);
+
+	return retVal;
+}
+
+
+bool CBinaryDelta::ApplyDelta(const void* basePtr, int baseSize, const QByteArray& delta, QByteArray& result)
+{
+	const char* base = static_cast<const char*>(basePtr);
+
+	int position = 0;
+	quint32 deltaBaseSize = 0;
+	quint32 targetSize = 0;
+
+	if (!ReadNumber(delta, position, deltaBaseSize) || !ReadNumber(delta, position, targetSize)){
+		return false;
+	}
+
+	if ((deltaBaseSize != quint32(baseSize)) || (targetSize > quint32(INT_MAX))){
+		return false;
+	}
+
+	result.clear();
+	result.reserve(int(targetSize));
+
+	while (position < delta.size()){
+		quint8 operation = quint8(delta[position++]);
+
+		quint32 offset = 0;
+		quint32 size = 0;
+
+		if (operation == OT_COPY){
+			if (		!ReadNumber(delta, position, offset) ||
+						!ReadNumber(delta, position, size) ||
+						(quint64(offset) + size > quint64(baseSize))){
+				return false;
+			}
+
+			result.append(base + offset, int(size));
+		}
+		else if (operation == OT_INSERT){
+			if (!ReadNumber(delta, position, size) || (quint64(position) + size > quint64(delta.size()))){
+				return false;
+			}
+
+			result.append(delta.constData() + position, int(size));
+
+			position += int(size);
+		}
+		else{
+			return false;
+		}
+
+		if (quint32(result.size()) > targetSize){
+			return false;
+		}
+	}
+
+	return (quint32(result.size()) == targetSize);
+}
+
+
+// protected static methods
+
+void CBinaryDelta::WriteNumber(quint32 value, QByteArray& delta)
+{
+	// 7 bits per byte, the highest bit marks continuation
+	while (value >= 0x80){
+		delta.append(char((value & 0x7f) | 0x80));
+
+		value >>= 7;
+	}
+
+	delta.append(char(value));
+}
+
+
+bool CBinaryDelta::ReadNumber(const QByteArray& delta, int& position, quint32& value)
+{
+	value = 0;
+
+	for (int shift = 0; shift < 32; shift += 7){
+		if (position >= delta.size()){
+			return false;
+		}
+
+		quint8 byte = quint8(delta[position++]);
+
+		value |= quint32(byte & 0x7f) << shift;
+
+		if ((byte & 0x80) == 0){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void CBinaryDelta::WriteCopy(int offset, int size, QByteArray& delta)
+{
+	if (size > 0){
+		delta.append(char(OT_COPY));
+
+		WriteNumber(quint32(offset), delta);
+		WriteNumber(quint32(size), delta);
+	}
+}
+
+
+void CBinaryDelta::WriteInsert(const char* dataPtr, int size, QByteArray& delta)
+{
+	if (size > 0){
+		delta.append(char(OT_INSERT));
+
+		WriteNumber(quint32(size), delta);
+
+		delta.append(dataPtr, size);
+	}
+}
+
+
+} // namespace istd
+
+
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+
+
+namespace istd
+{
+
+
+/**
+	Helper class for calculation of binary differences between two memory blocks.
+
+	The delta consists of copy operations referencing the base data and of inserted literal bytes.
+	Common prefix and suffix are detected directly, the remaining data is matched using rolling hash of fixed-size blocks,
+	so the size of the delta is roughly proportional to the size of the changed data.
+*/
+class CBinaryDelta
+{
+public:
+	/**
+		Create delta transforming the base data to the target data.
+	*/
+	static QByteArray CreateDelta(const void* basePtr, int baseSize, const void* targetPtr, int targetSize);
+
+	/**
+		Reconstruct the target data from the base data and delta.
+		\return	\c false if the delta is corrupted or it was not created for this base data.
+	*/
+	static bool ApplyDelta(const void* basePtr, int baseSize, const QByteArray& delta, QByteArray& result);
+
+protected:
+	enum OperationType
+	{
+		OT_COPY,
+		OT_INSERT
+	};
+
+	static void WriteNumber(quint32 value, QByteArray& delta);
+	static bool ReadNumber(const QByteArray& delta, int& position, quint32& value);
+	static void WriteCopy(int offset, int size, QByteArray& delta);
+	static void WriteInsert(const char* dataPtr, int size, QByteArray& delta);
+};
+
+
+} // namespace istd
+
+
@@ -2,6 +2,12 @@
 #include <istd/CClassInfo.h>
 
 
+// Qt includes
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QReadWriteLock>
+
+
 #ifndef _MSC_VER
 
 #include <cxxabi.h>
@@ -235,6 +241,138 @@ QByteArray ParseRecursive(const QByteArray& rawName, QByteArray ns, int& positio
 #endif //!_MSC_VER
 
 
+namespace
+{
+
+
+/**
+	Global registry of interned class names.
+	RTTI types are cached using the address of their raw name, so demangling is done only once per type.
+*/
+class CTypeRegistry
+{
+public:
+	CTypeRegistry()
+	{
+		// ID 0 is reserved for invalid type
+		m_names.append(QByteArray());
+
+		// void must be always registered as the first type, see istd::CClassInfo::VOID_TYPE_ID
+		int voidTypeId = InternName(istd::CClassInfo::GetUndecoratedName(typeid(void).name()));
+		Q_ASSERT(voidTypeId == 1);
+		Q_UNUSED(voidTypeId);
+	}
+
+	/**
+		Get interned ID and name of the RTTI type.
+	*/
+	int GetTypeInfoId(const std::type_info& info, QByteArray& name)
+	{
+		const void* rawNamePtr = info.name();
+
+		{
+			QReadLocker readLock(&m_lock);
+
+			RawNameIds::ConstIterator foundIter = m_rawNameIds.constFind(rawNamePtr);
+			if (foundIter != m_rawNameIds.constEnd()){
+				int typeId = foundIter.value();
+
+				name = m_names[typeId];
+
+				return typeId;
+			}
+		}
+
+		// demangling is done without lock
+		QByteArray undecoratedName = istd::CClassInfo::GetUndecoratedName(info.name());
+
+		QWriteLocker writeLock(&m_lock);
+
+		int typeId = InternNameUnlocked(undecoratedName);
+
+		m_rawNameIds.insert(rawNamePtr, typeId);
+
+		name = m_names[typeId];
+
+		return typeId;
+	}
+
+	/**
+		Get interned ID of the undecorated name.
+		\param	internedNamePtr	optional pointer to interned name sharing the data with the registry.
+	*/
+	int InternName(const QByteArray& name, QByteArray* internedNamePtr = NULL)
+	{
+		if (name.isEmpty()){
+			if (internedNamePtr != NULL){
+				*internedNamePtr = QByteArray();
+			}
+
+			return 0;
+		}
+
+		{
+			QReadLocker readLock(&m_lock);
+
+			NameIds::ConstIterator foundIter = m_nameIds.constFind(name);
+			if (foundIter != m_nameIds.constEnd()){
+				if (internedNamePtr != NULL){
+					*internedNamePtr = m_names[foundIter.value()];
+				}
+
+				return foundIter.value();
+			}
+		}
+
+		QWriteLocker writeLock(&m_lock);
+
+		int typeId = InternNameUnlocked(name);
+
+		if (internedNamePtr != NULL){
+			*internedNamePtr = m_names[typeId];
+		}
+
+		return typeId;
+	}
+
+private:
+	int InternNameUnlocked(const QByteArray& name)
+	{
+		NameIds::ConstIterator foundIter = m_nameIds.constFind(name);
+		if (foundIter != m_nameIds.constEnd()){
+			return foundIter.value();
+		}
+
+		int typeId = int(m_names.size());
+
+		m_names.append(name);
+		m_nameIds.insert(name, typeId);
+
+		return typeId;
+	}
+
+	typedef QHash<QByteArray, int> NameIds;
+	typedef QHash<const void*, int> RawNameIds;
+
+	NameIds m_nameIds;
+	RawNameIds m_rawNameIds;
+	QVector<QByteArray> m_names;
+
+	QReadWriteLock m_lock;
+};
+
+
+static CTypeRegistry& GetTypeRegistry()
+{
+	static CTypeRegistry registry;
+
+	return registry;
+}
+
+
+} // namespace
+
+
 namespace istd
 {
 
@@ -247,18 +385,11 @@ bool CClassInfo::IsConst() const
 
 CClassInfo CClassInfo::GetConstCasted(bool enableConst) const
 {
-	if (enableConst){
-		if (!IsConst()){
-			return CClassInfo("const " + m_name);
-		}
-	}
-	else{
-		if (IsConst()){
-			return CClassInfo(m_name.mid(6));
-		}
-	}
+	CClassInfo retVal(*this);
 
-	return *this;
+	retVal.ConstCast(enableConst);
+
+	return retVal;
 }
 
 
@@ -266,14 +397,14 @@ bool CClassInfo::ConstCast(bool enableConst)
 {
 	if (enableConst){
 		if (!IsConst()){
-			m_name = "const " + m_name;
+			SetUndecoratedName("const " + m_name);
 
 			return true;
 		}
 	}
 	else{
 		if (IsConst()){
-			m_name = m_name.mid(6);
+			SetUndecoratedName(m_name.mid(6));
 
 			return true;
 		}
@@ -339,13 +470,17 @@ CClassInfo CClassInfo::GetTemplateParam(int paramIndex) const
 
 QByteArray CClassInfo::GetName(const std::type_info& info)
 {
-	return GetUndecoratedName(info.name());
+	QByteArray retVal;
+
+	GetTypeRegistry().GetTypeInfoId(info, retVal);
+
+	return retVal;
 }
 
 
 QByteArray CClassInfo::GetName(const istd::IPolymorphic& object)
 {
-	return GetUndecoratedName(typeid(object).name());
+	return GetName(typeid(object));
 }
 
 
@@ -364,6 +499,11 @@ QByteArray CClassInfo::GetUndecoratedName(const QByteArray& rawName)
 #else
 	int status = 0;
 	char* demangledName = abi::__cxa_demangle(rawName.constData(), NULL, NULL, &status);
+	if (demangledName == NULL){
+		// name is not mangled
+		return rawName;
+	}
+
 	QByteArray retVal(demangledName);
 
 	::free(demangledName);
@@ -373,6 +513,26 @@ QByteArray CClassInfo::GetUndecoratedName(const QByteArray& rawName)
 }
 
 
+int CClassInfo::GetTypeId(const QByteArray& name)
+{
+	return GetTypeRegistry().InternName(name);
+}
+
+
+// private methods
+
+void CClassInfo::SetTypeInfo(const std::type_info& info)
+{
+	m_typeId = GetTypeRegistry().GetTypeInfoId(info, m_name);
+}
+
+
+void CClassInfo::SetUndecoratedName(const QByteArray& name)
+{
+	m_typeId = GetTypeRegistry().InternName(name, &m_name);
+}
+
+
 } // namespace istd
 
 
@@ -18,6 +18,8 @@ namespace istd
 
 /**
 	Represents platform independent type info and provide set of static class manipulation functions.
+	All class names are interned in a global type registry, the undecorated name of each RTTI type is computed only once.
+	Each interned name has its own stable type ID, which is used for fast comparison of class info objects.
 */
 class CClassInfo: virtual public istd::IPolymorphic
 {
@@ -40,6 +42,13 @@ public:
 	*/
 	const QByteArray& GetName() const;
 
+	/**
+		Get interned ID of this type.
+		Class info objects with the same name have always the same ID during the whole process lifetime.
+		\return	type ID or 0, if this class info is invalid.
+	*/
+	int GetTypeId() const;
+
 	/**
 		Check if this class information represents void type.
 	*/
@@ -115,33 +124,55 @@ public:
 	*/
 	static QByteArray GetUndecoratedName(const QByteArray& rawName);
 
+	/**
+		Get interned ID of the undecorated class name.
+		\return	type ID or 0, if the name is empty.
+	*/
+	static int GetTypeId(const QByteArray& name);
+
 private:
+	enum
+	{
+		/**
+			Type ID of void type, it is registered as the first type in the type registry.
+		*/
+		VOID_TYPE_ID = 1
+	};
+
+	void SetTypeInfo(const std::type_info& info);
+	void SetUndecoratedName(const QByteArray& name);
+
 	QByteArray m_name;
+	int m_typeId;
 };
 
 
 // inline methods
 
 inline CClassInfo::CClassInfo()
+:	m_typeId(0)
 {
 }
 
 
 inline CClassInfo::CClassInfo(const std::type_info& info)
-:	m_name(GetName(info))
+:	m_typeId(0)
 {
+	SetTypeInfo(info);
 }
 
 
 inline CClassInfo::CClassInfo(const QByteArray& name)
-:	m_name(GetUndecoratedName(name))
+:	m_typeId(0)
 {
+	SetUndecoratedName(GetUndecoratedName(name));
 }
 
 
 inline CClassInfo::CClassInfo(const istd::IPolymorphic& object)
-:	m_name(GetUndecoratedName(typeid(object).name()))
+:	m_typeId(0)
 {
+	SetTypeInfo(typeid(object));
 }
 
 
@@ -157,22 +188,28 @@ inline const QByteArray& CClassInfo::GetName() const
 }
 
 
+inline int CClassInfo::GetTypeId() const
+{
+	return m_typeId;
+}
+
+
 inline bool CClassInfo::IsVoid() const
 {
-	return *this == istd::CClassInfo::GetInfo<void>();
+	return m_typeId == VOID_TYPE_ID;
 }
 
 
 template <class C>
 inline bool CClassInfo::IsType() const
 {
-	return m_name == GetName(typeid(C));
+	return m_typeId == GetInfo<C>().m_typeId;
 }
 
 
 inline CClassInfo& CClassInfo::operator=(const std::type_info& info)
 {
-	m_name = GetName(info);
+	SetTypeInfo(info);
 
 	return *this;
 }
@@ -181,6 +218,7 @@ inline CClassInfo& CClassInfo::operator=(const std::type_info& info)
 inline CClassInfo& CClassInfo::operator=(const CClassInfo& info)
 {
 	m_name = info.m_name;
+	m_typeId = info.m_typeId;
 
 	return *this;
 }
@@ -188,13 +226,13 @@ inline CClassInfo& CClassInfo::operator=(const CClassInfo& info)
 
 inline bool CClassInfo::operator==(const CClassInfo& info) const
 {
-	return m_name == info.m_name;
+	return m_typeId == info.m_typeId;
 }
 
 
 inline bool CClassInfo::operator!=(const CClassInfo& info) const
 {
-	return m_name != info.m_name;
+	return m_typeId != info.m_typeId;
 }
 
 
@@ -224,7 +262,7 @@ CClassInfo CClassInfo::GetInfo()
 template <class C>
 QByteArray CClassInfo::GetName()
 {
-	return GetUndecoratedName(typeid(C).name());
+	return GetName(typeid(C));
 }
 
 
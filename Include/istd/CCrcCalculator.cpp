@@ -1,61 +1,364 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
 #include <istd/CCrcCalculator.h>
 
+// STL includes
+#include <cstring>
+
 // Qt includes
+#include <QtCore/QByteArray>
 #include <QtCore/QFile>
 #include <QtCore/QString>
 
+#if defined(Q_PROCESSOR_X86) && (defined(__GNUC__) || defined(_MSC_VER))
+	#define ACF_CRC_PCLMUL
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+	#include <arm_acle.h>
+#endif
+
 
 namespace istd
 {
 
 
-// public methods
+namespace
+{
 
-quint32 CCrcCalculator::GetCrcFromData(const quint8* dataPtr, int dataSize)
+
+static const quint32 s_crcPolynomial = 0xEDB88320;
+static const qint64 s_fileMappingSize = 64 * 1024 * 1024;
+static const int s_fileBufferSize = 1024 * 1024;
+
+
+/**
+	Lookup tables for slicing-by-8 calculation.
+	Table \c k contains CRC values of each byte followed by \c k zero bytes.
+*/
+struct SlicingTables
 {
-	quint32 crcValue = 0xFFFFFFFF;
+	SlicingTables()
+	{
+		for (int i = 0; i < 256; ++i){
+			quint32 crcValue = quint32(i);
+			for (int bitIndex = 0; bitIndex < 8; ++bitIndex){
+				crcValue = (crcValue & 1)? (crcValue >> 1) ^ s_crcPolynomial: (crcValue >> 1);
+			}
+
+			values[0][i] = crcValue;
+		}
 
-	for (		int i = 0; i < dataSize; ++i){
-		UpdateCrc(dataPtr[i], crcValue);
+		for (int i = 0; i < 256; ++i){
+			for (int tableIndex = 1; tableIndex < 8; ++tableIndex){
+				quint32 prevValue = values[tableIndex - 1][i];
+
+				values[tableIndex][i] = (prevValue >> 8) ^ values[0][prevValue & 0xFF];
+			}
+		}
 	}
 
-	return ~crcValue;
+	quint32 values[8][256];
+};
+
+
+const SlicingTables& GetSlicingTables()
+{
+	static const SlicingTables tables;
+
+	return tables;
 }
 
 
-quint32 CCrcCalculator::GetCrcFromStream(const ByteStream& byteStream)
+quint32 UpdateCrcSlicing(quint32 crcValue, const quint8* dataPtr, qint64 dataSize)
+{
+	const SlicingTables& tables = GetSlicingTables();
+
+	while (dataSize >= 8){
+		quint32 low = crcValue ^ (quint32(dataPtr[0]) | (quint32(dataPtr[1]) << 8) | (quint32(dataPtr[2]) << 16) | (quint32(dataPtr[3]) << 24));
+		quint32 high = quint32(dataPtr[4]) | (quint32(dataPtr[5]) << 8) | (quint32(dataPtr[6]) << 16) | (quint32(dataPtr[7]) << 24);
+
+		crcValue =
+					tables.values[7][low & 0xFF] ^
+					tables.values[6][(low >> 8) & 0xFF] ^
+					tables.values[5][(low >> 16) & 0xFF] ^
+					tables.values[4][low >> 24] ^
+					tables.values[3][high & 0xFF] ^
+					tables.values[2][(high >> 8) & 0xFF] ^
+					tables.values[1][(high >> 16) & 0xFF] ^
+					tables.values[0][high >> 24];
+
+		dataPtr += 8;
+		dataSize -= 8;
+	}
+
+	for (qint64 i = 0; i < dataSize; ++i){
+		crcValue = (crcValue >> 8) ^ tables.values[0][(crcValue ^ dataPtr[i]) & 0xFF];
+	}
+
+	return crcValue;
+}
+
+
+#if defined(ACF_CRC_PCLMUL)
+
+bool IsPclmulSupported()
+{
+	unsigned int ecx = 0;
+
+#if defined(_MSC_VER)
+	int cpuInfo[4] = {0};
+	__cpuid(cpuInfo, 1);
+	ecx = unsigned(cpuInfo[2]);
+#else
+	unsigned int eax = 0;
+	unsigned int ebx = 0;
+	unsigned int edx = 0;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0){
+		return false;
+	}
+#endif
+
+	const unsigned int pclmulBit = 1 << 1;
+	const unsigned int sse41Bit = 1 << 19;
+
+	return ((ecx & pclmulBit) != 0) && ((ecx & sse41Bit) != 0);
+}
+
+
+/**
+	Fold the data using carry-less multiplication (Intel: "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction").
+	The size of data must be at least 64 bytes and a multiple of 16.
+*/
+#if !defined(_MSC_VER)
+__attribute__((target("pclmul,sse4.1")))
+#endif
+quint32 UpdateCrcPclmul(quint32 crcValue, const quint8* dataPtr, qint64 dataSize)
+{
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+	const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+	__m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x00));
+	__m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x10));
+	__m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x20));
+	__m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x30));
+
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(int(crcValue)));
+
+	dataPtr += 64;
+	dataSize -= 64;
+
+	// fold four 128-bit lanes in parallel
+	while (dataSize >= 64){
+		__m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		__m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		__m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		__m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr + 0x30)));
+
+		dataPtr += 64;
+		dataSize -= 64;
+	}
+
+	// fold the lanes into a single one
+	__m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	while (dataSize >= 16){
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataPtr))), x5);
+
+		dataPtr += 16;
+		dataSize -= 16;
+	}
+
+	// reduce 128 bits to 64 bits
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, mask32);
+	x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32 bits
+	x2 = _mm_and_si128(x1, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+	x2 = _mm_and_si128(x2, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return quint32(_mm_extract_epi32(x1, 1));
+}
+
+
+static const bool s_isPclmulSupported = IsPclmulSupported();
+
+#endif // ACF_CRC_PCLMUL
+
+
+#if defined(__ARM_FEATURE_CRC32)
+
+quint32 UpdateCrcArm(quint32 crcValue, const quint8* dataPtr, qint64 dataSize)
 {
-	quint32 crcValue = 0xFFFFFFFF;
+	while (dataSize >= 8){
+		quint64 value = 0;
+		memcpy(&value, dataPtr, sizeof(value));
+
+		crcValue = __crc32d(crcValue, value);
+
+		dataPtr += 8;
+		dataSize -= 8;
+	}
 
-	for (		ByteStream::const_iterator iterBeg = byteStream.begin();
-				iterBeg != byteStream.end();
-				++iterBeg){
-		UpdateCrc(*iterBeg, crcValue);
+	for (qint64 i = 0; i < dataSize; ++i){
+		crcValue = __crc32b(crcValue, dataPtr[i]);
 	}
 
-	return ~crcValue;
+	return crcValue;
 }
 
+#endif // __ARM_FEATURE_CRC32
+
+
+} // namespace
+
+
+// public methods
+
+CCrcCalculator::CCrcCalculator()
+:	m_crcValue(0xFFFFFFFF)
+{
+}
+
+
+void CCrcCalculator::Reset()
+{
+	m_crcValue = 0xFFFFFFFF;
+}
+
+
+void CCrcCalculator::Update(const void* dataPtr, qint64 dataSize)
+{
+	if ((dataPtr != NULL) && (dataSize > 0)){
+		m_crcValue = UpdateCrcBlock(m_crcValue, static_cast<const quint8*>(dataPtr), dataSize);
+	}
+}
+
+
+quint32 CCrcCalculator::GetCrc() const
+{
+	return ~m_crcValue;
+}
+
+
+quint32 CCrcCalculator::GetCrcFromData(const quint8* dataPtr, int dataSize)
+{
+	CCrcCalculator calculator;
+
+	calculator.Update(dataPtr, dataSize);
+
+	return calculator.GetCrc();
+}
+
+
+quint32 CCrcCalculator::GetCrcFromStream(const ByteStream& byteStream)
+{
+	return GetCrcFromData(byteStream.constData(), byteStream.size());
+}
 
 
 quint32 CCrcCalculator::GetCrcFromFile(const QString& fileName)
 {
 	QFile file(fileName);
 
-	quint32 crcValue = 0xFFFFFFFF;
+	CCrcCalculator calculator;
 
 	if (file.open(QIODevice::ReadOnly)){
-		char buffer[1024];
-		while (!file.atEnd()){
-			int readBytes = int(file.read(buffer, sizeof(buffer)));
-			for (int byteIndex = 0; byteIndex < readBytes; ++byteIndex){
-				UpdateCrc(buffer[byteIndex], crcValue);
+		qint64 fileSize = file.size();
+		qint64 position = 0;
+
+		// map the file in windows, if mapping is not possible read the rest using large buffer
+		while (position < fileSize){
+			qint64 windowSize = qMin(s_fileMappingSize, fileSize - position);
+
+			uchar* mappedPtr = file.map(position, windowSize);
+			if (mappedPtr == NULL){
+				break;
+			}
+
+			calculator.Update(mappedPtr, windowSize);
+
+			file.unmap(mappedPtr);
+
+			position += windowSize;
+		}
+
+		if ((position < fileSize) || file.isSequential()){
+			if (!file.isSequential()){
+				file.seek(position);
+			}
+
+			QByteArray buffer(s_fileBufferSize, Qt::Uninitialized);
+
+			qint64 readBytes = 0;
+			while ((readBytes = file.read(buffer.data(), buffer.size())) > 0){
+				calculator.Update(buffer.constData(), readBytes);
 			}
 		}
 	}
 
-	return ~crcValue;
+	return calculator.GetCrc();
+}
+
+
+// protected static methods
+
+quint32 CCrcCalculator::UpdateCrcBlock(quint32 crcValue, const quint8* dataPtr, qint64 dataSize)
+{
+#if defined(__ARM_FEATURE_CRC32)
+	return UpdateCrcArm(crcValue, dataPtr, dataSize);
+#else
+#if defined(ACF_CRC_PCLMUL)
+	if (s_isPclmulSupported && (dataSize >= 64)){
+		qint64 foldedSize = dataSize & ~qint64(15);
+
+		crcValue = UpdateCrcPclmul(crcValue, dataPtr, foldedSize);
+
+		dataPtr += foldedSize;
+		dataSize -= foldedSize;
+	}
+#endif
+
+	return UpdateCrcSlicing(crcValue, dataPtr, dataSize);
+#endif
 }
 
 
@@ -13,12 +13,33 @@ namespace istd
 
 /**
 	Helper class for CRC-32 checksum calculation.
+
+	The checksum can be calculated at once using static methods or incrementally using \c Update.
+	Memory blocks are processed using carry-less multiplication (PCLMULQDQ) or CRC instructions (ARMv8) if available,
+	otherwise slicing-by-8 tables are used. All implementations return the same values as the byte-wise table calculation.
 */
 class CCrcCalculator
 {
 public:
 	typedef QVector<quint8> ByteStream;
 
+	CCrcCalculator();
+
+	/**
+		Reset the calculation to the initial state.
+	*/
+	void Reset();
+
+	/**
+		Update CRC value with the next data block.
+	*/
+	void Update(const void* dataPtr, qint64 dataSize);
+
+	/**
+		Get 32-bit CRC value of all data since the last reset.
+	*/
+	quint32 GetCrc() const;
+
 	/**
 		Get 32-bit CRC value for the given memory block.
 	*/
@@ -40,7 +61,14 @@ protected:
 	*/
 	static void UpdateCrc(const quint8& byte, quint32& dwCrc32);
 
+	/**
+		Update CRC value for the memory block using the fastest available implementation.
+	*/
+	static quint32 UpdateCrcBlock(quint32 crcValue, const quint8* dataPtr, qint64 dataSize);
+
 private:
+	quint32 m_crcValue;
+
 	static quint32 s_crcTable[256];
 };
 
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <istd/CParallelFor.h>
+
+
+// STL includes
+#include <memory>
+
+// Qt includes
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+
+namespace
+{
+
+
+/**
+	State shared by the calling thread and the helper runnables.
+	Helpers started after the calling thread has finished don't access the processing function anymore.
+*/
+struct ParallelState
+{
+	ParallelState(int count, const istd::CParallelFor::IndexFunction& function)
+	:	functionPtr(&function),
+		count(count),
+		nextIndex(0),
+		isFailed(0),
+		activeHelpersCount(0),
+		isClosed(false)
+	{
+	}
+
+	const istd::CParallelFor::IndexFunction* functionPtr;
+	int count;
+	QAtomicInt nextIndex;
+	QAtomicInt isFailed;
+
+	QMutex mutex;
+	QWaitCondition helpersFinishedCondition;
+	int activeHelpersCount;
+	bool isClosed;
+};
+
+
+void ProcessIndices(ParallelState& state)
+{
+	for (		int index = state.nextIndex.fetchAndAddRelaxed(1);
+				index < state.count;
+				index = state.nextIndex.fetchAndAddRelaxed(1)){
+		if (!(*state.functionPtr)(index)){
+			state.isFailed.fetchAndStoreRelaxed(1);
+
+			// stop processing of the rest
+			state.nextIndex.fetchAndStoreRelaxed(state.count);
+		}
+	}
+}
+
+
+class CHelperRunnable: public QRunnable
+{
+public:
+	explicit CHelperRunnable(const std::shared_ptr<ParallelState>& statePtr)
+	:	m_statePtr(statePtr)
+	{
+	}
+
+	// reimplemented (QRunnable)
+	virtual void run() override
+	{
+		ParallelState& state = *m_statePtr;
+
+		{
+			QMutexLocker lock(&state.mutex);
+			if (state.isClosed){
+				return;
+			}
+
+			++state.activeHelpersCount;
+		}
+
+		ProcessIndices(state);
+
+		QMutexLocker lock(&state.mutex);
+
+		if (--state.activeHelpersCount == 0){
+			state.helpersFinishedCondition.wakeAll();
+		}
+	}
+
+private:
+	std::shared_ptr<ParallelState> m_statePtr;
+};
+
+
+} // namespace
+
+
+namespace istd
+{
+
+
+// public static methods
+
+bool CParallelFor::ProcessInParallel(int count, const IndexFunction& function)
+{
+	int helpersCount = qMin(QThread::idealThreadCount() - 1, count - 1);
+	if (helpersCount <= 0){
+		bool retVal = true;
+
+		for (int i = 0; retVal && (i < count); ++i){
+			retVal = function(i);
+		}
+
+		return retVal;
+	}
+
+	std::shared_ptr<ParallelState> statePtr(new ParallelState(count, function));
+
+	QThreadPool* threadPoolPtr = QThreadPool::globalInstance();
+	for (int i = 0; i < helpersCount; ++i){
+		threadPoolPtr->start(new CHelperRunnable(statePtr));
+	}
+
+	ProcessIndices(*statePtr);
+
+	QMutexLocker lock(&statePtr->mutex);
+
+	statePtr->isClosed = true;
+
+	while (statePtr->activeHelpersCount > 0){
+		statePtr->helpersFinishedCondition.wait(&statePtr->mutex);
+	}
+
+	return (statePtr->isFailed.loadAcquire() == 0);
+}
+
+
+int CParallelFor::GetBandsCount(int itemsCount, qint64 workAmount)
+{
+	if (itemsCount <= 0){
+		return 0;
+	}
+
+	qint64 bandsCount = qMin(workAmount / MIN_BAND_WORK_AMOUNT, qint64(QThread::idealThreadCount()) * 4);
+
+	return int(qBound(qint64(1), bandsCount, qint64(itemsCount)));
+}
+
+
+void CParallelFor::ProcessBands(int itemsCount, int bandsCount, const BandFunction& function)
+{
+	if (itemsCount <= 0){
+		return;
+	}
+
+	if (bandsCount <= 1){
+		function(0, 0, itemsCount);
+
+		return;
+	}
+
+	bandsCount = qMin(bandsCount, itemsCount);
+
+	ProcessInParallel(bandsCount, [&function, itemsCount, bandsCount](int bandIndex){
+		const int beginIndex = int(qint64(bandIndex) * itemsCount / bandsCount);
+		const int endIndex = int(qint64(bandIndex + 1) * itemsCount / bandsCount);
+
+		function(bandIndex, beginIndex, endIndex);
+
+		return true;
+	});
+}
+
+
+} // namespace istd
+
+
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// STL includes
+#include <functional>
+
+// Qt includes
+#include <QtCore/QtGlobal>
+
+
+namespace istd
+{
+
+
+/**
+	Helper for parallel processing of independent work items using the global thread pool.
+
+	The calling thread takes part in the processing, so the methods can be also called from a thread of the pool
+	and nested calls cannot block the pool.
+	Large ranges of lines (or columns) can be split into bands, the number of bands is derived from the amount of work.
+
+	\ingroup Main
+*/
+class CParallelFor
+{
+public:
+	enum
+	{
+		/**
+			Minimal amount of work (e.g. number of pixels) processed by a single band.
+		*/
+		MIN_BAND_WORK_AMOUNT = 65536
+	};
+
+	/**
+		Function processing the item with the given index.
+		\return	false, if processing failed and the rest should be cancelled.
+	*/
+	typedef std::function<bool (int index)> IndexFunction;
+	/**
+		Function processing the band of items in range [beginIndex, endIndex).
+	*/
+	typedef std::function<void (int bandIndex, int beginIndex, int endIndex)> BandFunction;
+
+	/**
+		Call the function for all indices in range [0, count) using the global thread pool.
+		\return	true, if all calls were successful.
+	*/
+	static bool ProcessInParallel(int count, const IndexFunction& function);
+
+	/**
+		Get number of bands the range of items should be split into.
+		\param	itemsCount	number of items (e.g. lines), no band will be empty.
+		\param	workAmount	estimated amount of work of all items, e.g. number of processed pixels.
+		\return	number of bands, it is 1 if the work is too small for parallel processing and 0 for empty range.
+	*/
+	static int GetBandsCount(int itemsCount, qint64 workAmount);
+
+	/**
+		Split range [0, itemsCount) into consecutive bands of nearly the same size and call the function for each of them.
+		If there is only one band, the function is called directly in the calling thread.
+		\param	bandsCount	number of bands, usually calculated using \c GetBandsCount.
+	*/
+	static void ProcessBands(int itemsCount, int bandsCount, const BandFunction& function);
+};
+
+
+} // namespace istd
+
+
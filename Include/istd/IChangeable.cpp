@@ -2,187 +2,196 @@
 #include <istd/IChangeable.h>
 
 
+// Qt includes
+#include <QtCore/QtAlgorithms>
+
+
 namespace istd
 {
 
 
 IChangeable::ChangeSet::ChangeSet()
+:	m_inlineIds(0)
 {
 }
 
 
 IChangeable::ChangeSet::ChangeSet(const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
+	InsertId(id1);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
+	InsertId(id1);
+	InsertId(id2);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
-	m_ids << id6;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
+	InsertId(id6);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
-	m_ids << id6;
-	m_ids << id7;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
+	InsertId(id6);
+	InsertId(id7);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
-	m_ids << id6;
-	m_ids << id7;
-	m_ids << id8;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
+	InsertId(id6);
+	InsertId(id7);
+	InsertId(id8);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
-	m_ids << id6;
-	m_ids << id7;
-	m_ids << id8;
-	m_ids << id9;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
+	InsertId(id6);
+	InsertId(id7);
+	InsertId(id8);
+	InsertId(id9);
 }
 
 
 IChangeable::ChangeSet::ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, int id10, const QString& description)
-:	m_description(description)
+:	m_inlineIds(0),
+	m_description(description)
 {
-	m_ids << id1;
-	m_ids << id2;
-	m_ids << id3;
-	m_ids << id4;
-	m_ids << id5;
-	m_ids << id6;
-	m_ids << id7;
-	m_ids << id8;
-	m_ids << id9;
-	m_ids << id10;
+	InsertId(id1);
+	InsertId(id2);
+	InsertId(id3);
+	InsertId(id4);
+	InsertId(id5);
+	InsertId(id6);
+	InsertId(id7);
+	InsertId(id8);
+	InsertId(id9);
+	InsertId(id10);
 }
 
 
 void IChangeable::ChangeSet::Reset()
 {
-	m_ids.clear();
+	m_inlineIds = 0;
+	m_extraIds.clear();
 	m_infoMap.clear();
 	m_description.clear();
 }
 
 
-bool IChangeable::ChangeSet::IsEmpty() const
-{
-	return m_ids.empty();
-}
-
-
-bool IChangeable::ChangeSet::Contains(int changeId) const
-{
-	if (m_ids.contains(CF_ALL_DATA)){
-		return true;
-	}
-
-	return m_ids.contains(changeId);
-}
-
-
 bool IChangeable::ChangeSet::ContainsExplicit(int changeId, bool singleOnly) const
 {
-	if (singleOnly && (m_ids.size() != 1)){
+	if (singleOnly && (GetIdsCount() != 1)){
 		return false;
 	}
 
-	return m_ids.contains(changeId);
+	return HasId(changeId);
 }
 
 
 bool IChangeable::ChangeSet::ContainsAny(const ChangeSet& changeSet) const
 {
-	if (m_ids.contains(CF_ALL_DATA) && !changeSet.m_ids.isEmpty()){
+	if (HasId(CF_ALL_DATA) && !changeSet.IsEmpty()){
+		return true;
+	}
+
+	if (changeSet.HasId(CF_ALL_DATA) && !IsEmpty()){
 		return true;
 	}
 
-	if (changeSet.m_ids.contains(CF_ALL_DATA) && !m_ids.isEmpty()){
+	if ((m_inlineIds & changeSet.m_inlineIds) != 0){
 		return true;
 	}
 
-	return !(m_ids & changeSet.m_ids).empty();
+	return !m_extraIds.isEmpty() && !changeSet.m_extraIds.isEmpty() && m_extraIds.intersects(changeSet.m_extraIds);
 }
 
 
 void IChangeable::ChangeSet::MaskOut(const ChangeSet& changeSet)
 {
-	m_ids -= m_ids & changeSet.m_ids;
+	m_inlineIds &= ~changeSet.m_inlineIds;
+
+	if (!m_extraIds.isEmpty() && !changeSet.m_extraIds.isEmpty()){
+		m_extraIds.subtract(changeSet.m_extraIds);
+	}
 }
 
 
@@ -194,7 +203,13 @@ const QString& IChangeable::ChangeSet::GetDescription() const
 
 QSet<int> IChangeable::ChangeSet::GetIds() const
 {
-	return m_ids;
+	QSet<int> retVal = m_extraIds;
+
+	for (quint64 bits = m_inlineIds; bits != 0; bits &= bits - 1){
+		retVal.insert(qCountTrailingZeroBits(bits));
+	}
+
+	return retVal;
 }
 
 
@@ -226,9 +241,9 @@ IChangeable::ChangeSet IChangeable::ChangeSet::operator+(const ChangeSet& change
 {
 	ChangeSet retVal;
 
-	retVal.m_ids += m_ids;
-	retVal.m_ids += changeSet.m_ids;
-	retVal.m_infoMap += changeSet.m_infoMap;
+	retVal.UniteIds(*this);
+	retVal.UniteIds(changeSet);
+	retVal.m_infoMap = changeSet.m_infoMap;
 
 	if (!changeSet.m_description.isEmpty()){
 		retVal.m_description = changeSet.m_description;
@@ -241,32 +256,50 @@ IChangeable::ChangeSet IChangeable::ChangeSet::operator+(const ChangeSet& change
 }
 
 
-IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(int changeId)
+IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(const QSet<int>& ids)
 {
-	m_ids << changeId;
+	for (int changeId: ids){
+		InsertId(changeId);
+	}
 
 	return *this;
 }
 
 
-IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(const QSet<int>& ids)
+IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(const ChangeSet& changeSet)
 {
-	m_ids += ids;
+	UniteIds(changeSet);
+
+	if (m_infoMap.isEmpty()){
+		m_infoMap = changeSet.m_infoMap;
+	}
+	else if (!changeSet.m_infoMap.isEmpty()){
+		m_infoMap += changeSet.m_infoMap;
+	}
+
+	if (!changeSet.m_description.isEmpty()){
+		m_description = changeSet.m_description;
+	}
 
 	return *this;
 }
 
 
-IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(const ChangeSet& changeSet)
+void IChangeable::ChangeSet::UniteIds(const ChangeSet& changeSet)
 {
-	m_ids += changeSet.m_ids;
-	m_infoMap += changeSet.m_infoMap;
+	m_inlineIds |= changeSet.m_inlineIds;
 
-	if (!changeSet.m_description.isEmpty()){
-		m_description = changeSet.m_description;
+	if (!changeSet.m_extraIds.isEmpty()){
+		m_extraIds.unite(changeSet.m_extraIds);
 	}
+}
 
-	return *this;
+
+// private methods of embedded class ChangeSet
+
+int IChangeable::ChangeSet::GetIdsCount() const
+{
+	return int(qPopulationCount(m_inlineIds)) + int(m_extraIds.size());
 }
 
 
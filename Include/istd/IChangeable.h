@@ -31,22 +31,25 @@ public:
 
 	/**
 		Set of change flags (its IDs).
+		Change sets are created and copied for each change notification, therefore the representation is kept allocation-free for the common case:
+		IDs lower than \c INLINE_IDS_COUNT are stored in an inline bit mask, only larger (or negative) IDs are stored in an additional set.
+		Change info and description are implicitly shared, so copying of a change set never copies its payload.
 	*/
 	class ChangeSet
 	{
 	public:
 		ChangeSet();
 		explicit ChangeSet(const QString& description);
-		explicit ChangeSet(int id1, const QString& description = "");
-		ChangeSet(int id1, int id2, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, const QString& description = "");
-		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, int id10, const QString& description = "");
+		explicit ChangeSet(int id1, const QString& description = QString());
+		ChangeSet(int id1, int id2, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, const QString& description = QString());
+		ChangeSet(int id1, int id2, int id3, int id4, int id5, int id6, int id7, int id8, int id9, int id10, const QString& description = QString());
 
 		/**
 			Remove all IDs.
@@ -129,8 +132,34 @@ public:
 		*/
 		ChangeSet& operator+=(const ChangeSet& changeSet);
 
+		/**
+			Add change IDs of another set.
+			In contrast to \c operator+= the change info and description of the second set will be ignored.
+		*/
+		void UniteIds(const ChangeSet& changeSet);
+
 	private:
-		QSet<int> m_ids;
+		enum
+		{
+			/**
+				Number of the low IDs stored in the inline bit mask.
+			*/
+			INLINE_IDS_COUNT = 64
+		};
+
+		static bool IsInlineId(int changeId);
+		bool HasId(int changeId) const;
+		int GetIdsCount() const;
+		void InsertId(int changeId);
+
+		/**
+			Bit mask of all IDs in range [0, INLINE_IDS_COUNT).
+		*/
+		quint64 m_inlineIds;
+		/**
+			IDs outside of the inline range, normally it stays empty.
+		*/
+		QSet<int> m_extraIds;
 
 		ChangeInfoMap m_infoMap;
 
@@ -346,6 +375,63 @@ private:
 };
 
 
+// public inline methods of embedded class ChangeSet
+
+inline bool IChangeable::ChangeSet::IsEmpty() const
+{
+	return (m_inlineIds == 0) && m_extraIds.isEmpty();
+}
+
+
+inline bool IChangeable::ChangeSet::Contains(int changeId) const
+{
+	if ((m_inlineIds & (quint64(1) << CF_ALL_DATA)) != 0){
+		return true;
+	}
+
+	return HasId(changeId);
+}
+
+
+inline IChangeable::ChangeSet& IChangeable::ChangeSet::operator+=(int changeId)
+{
+	InsertId(changeId);
+
+	return *this;
+}
+
+
+// private static inline methods of embedded class ChangeSet
+
+inline bool IChangeable::ChangeSet::IsInlineId(int changeId)
+{
+	return (changeId >= 0) && (changeId < INLINE_IDS_COUNT);
+}
+
+
+// private inline methods of embedded class ChangeSet
+
+inline bool IChangeable::ChangeSet::HasId(int changeId) const
+{
+	if (IsInlineId(changeId)){
+		return (m_inlineIds & (quint64(1) << changeId)) != 0;
+	}
+
+	return m_extraIds.contains(changeId);
+}
+
+
+inline void IChangeable::ChangeSet::InsertId(int changeId)
+{
+	if (IsInlineId(changeId)){
+		m_inlineIds |= quint64(1) << changeId;
+	}
+	else{
+		m_extraIds.insert(changeId);
+	}
+}
+
+
 // public inline methods
 
 inline int IChangeable::GetSupportedOperations() const
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CBinaryDeltaTest.h"
+
+
+// ACF includes
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+QByteArray CreateData(int size, quint32 seed)
+{
+	return itest::CRandomDataGenerator(seed).CreateData(size);
+}
+
+
+} // namespace
+
+
+// protected slots
+
+void CBinaryDeltaTest::initTestCase()
+{
+}
+
+
+void CBinaryDeltaTest::ReconstructionTest_data()
+{
+	QTest::addColumn<QByteArray>("base");
+	QTest::addColumn<QByteArray>("target");
+
+	QByteArray data = CreateData(10000, 1);
+
+	QByteArray changed = data;
+	changed[5000] = char(changed[5000] ^ 0xff);
+
+	QByteArray inserted = data;
+	inserted.insert(3000, CreateData(100, 2));
+
+	QByteArray removed = data;
+	removed.remove(2000, 3000);
+
+	QByteArray moved = data.mid(6000) + data.left(6000);
+
+	QTest::newRow("Empty") << QByteArray() << QByteArray();
+	QTest::newRow("Empty base") << QByteArray() << data;
+	QTest::newRow("Empty target") << data << QByteArray();
+	QTest::newRow("Equal") << data << data;
+	QTest::newRow("Changed byte") << data << changed;
+	QTest::newRow("Inserted data") << data << inserted;
+	QTest::newRow("Removed data") << data << removed;
+	QTest::newRow("Moved data") << data << moved;
+	QTest::newRow("Different data") << data << CreateData(5000, 3);
+	QTest::newRow("Repeated data") << QByteArray(1000, 'a') << QByteArray(1500, 'a');
+}
+
+
+void CBinaryDeltaTest::ReconstructionTest()
+{
+	QFETCH(QByteArray, base);
+	QFETCH(QByteArray, target);
+
+	QByteArray delta = istd::CBinaryDelta::CreateDelta(base.constData(), base.size(), target.constData(), target.size());
+
+	QByteArray result;
+	QVERIFY(istd::CBinaryDelta::ApplyDelta(base.constData(), base.size(), delta, result));
+	QCOMPARE(result, target);
+}
+
+
+void CBinaryDeltaTest::DeltaSizeTest()
+{
+	QByteArray base = CreateData(1 << 20, 4);
+
+	// small change in the middle
+	QByteArray target = base;
+	target.replace(500000, 10, "0123456789");
+
+	QByteArray delta = istd::CBinaryDelta::CreateDelta(base.constData(), base.size(), target.constData(), target.size());
+	QVERIFY(delta.size() < 64);
+
+	// two moved parts are found by the block matching
+	QByteArray movedTarget = base.mid(700000) + base.left(700000);
+
+	QByteArray movedDelta = istd::CBinaryDelta::CreateDelta(base.constData(), base.size(), movedTarget.constData(), movedTarget.size());
+	QVERIFY(movedDelta.size() < 256);
+
+	QByteArray result;
+	QVERIFY(istd::CBinaryDelta::ApplyDelta(base.constData(), base.size(), movedDelta, result));
+	QCOMPARE(result, movedTarget);
+}
+
+
+void CBinaryDeltaTest::InvalidDeltaTest()
+{
+	QByteArray base = CreateData(1000, 5);
+	QByteArray target = CreateData(1000, 6);
+
+	QByteArray delta = istd::CBinaryDelta::CreateDelta(base.constData(), base.size(), target.constData(), target.size());
+
+	QByteArray result;
+
+	// the delta was created for the other base data
+	QVERIFY(!istd::CBinaryDelta::ApplyDelta(base.constData(), base.size() - 1, delta, result));
+
+	// truncated delta
+	QVERIFY(!istd::CBinaryDelta::ApplyDelta(base.constData(), base.size(), delta.left(delta.size() / 2), result));
+
+	// unknown operation, the first operation follows both sizes
+	QByteArray corruptedDelta = delta;
+	corruptedDelta[4] = char(0x7f);
+	QVERIFY(!istd::CBinaryDelta::ApplyDelta(base.constData(), base.size(), corruptedDelta, result));
+}
+
+
+void CBinaryDeltaTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CBinaryDeltaTest);
+
+
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CChangeNotifierBenchmarkTest.h"
+
+
+// ACF includes
+#include <istd/CChangeNotifier.h>
+
+
+namespace
+{
+
+
+static const int s_notificationsCount = 10000;
+
+
+/**
+	Changeable object cumulating all changes like the model implementations do.
+*/
+class CCumulatingChangeable: public istd::IChangeable
+{
+public:
+	CCumulatingChangeable()
+	:	m_counter(0)
+	{
+	}
+
+	int GetCounter() const
+	{
+		return m_counter;
+	}
+
+	// reimplemented (istd::IChangeable)
+	virtual void BeginChanges(const ChangeSet& changeSet) override
+	{
+		m_lastChangeSet = changeSet;
+	}
+
+	virtual void EndChanges(const ChangeSet& changeSet) override
+	{
+		m_cumulatedChanges += changeSet;
+		if (m_cumulatedChanges.Contains(CF_ANY)){
+			++m_counter;
+		}
+
+		m_cumulatedChanges.Reset();
+	}
+
+private:
+	ChangeSet m_lastChangeSet;
+	ChangeSet m_cumulatedChanges;
+	int m_counter;
+};
+
+
+/**
+	Reference copy of the former change set representation.
+*/
+struct LegacyChangeSet
+{
+	QSet<int> ids;
+	istd::IChangeable::ChangeInfoMap infoMap;
+	QString description;
+
+	LegacyChangeSet& operator+=(const LegacyChangeSet& changeSet)
+	{
+		ids += changeSet.ids;
+		infoMap += changeSet.infoMap;
+
+		if (!changeSet.description.isEmpty()){
+			description = changeSet.description;
+		}
+
+		return *this;
+	}
+};
+
+
+/**
+	Reference notifier using \c LegacyChangeSet.
+*/
+class CLegacyNotifier
+{
+public:
+	CLegacyNotifier(LegacyChangeSet& lastChangeSet, LegacyChangeSet& cumulatedChanges, const LegacyChangeSet& changeSet)
+	:	m_cumulatedChanges(cumulatedChanges),
+		m_changeSet(changeSet)
+	{
+		lastChangeSet = m_changeSet;
+	}
+
+	~CLegacyNotifier()
+	{
+		m_cumulatedChanges += m_changeSet;
+		m_cumulatedChanges.ids.clear();
+	}
+
+private:
+	LegacyChangeSet& m_cumulatedChanges;
+	const LegacyChangeSet m_changeSet;
+};
+
+
+} // namespace
+
+
+// protected slots
+
+void CChangeNotifierBenchmarkTest::initTestCase()
+{
+}
+
+
+void CChangeNotifierBenchmarkTest::NotifierRoundTripBenchmark()
+{
+	CCumulatingChangeable changeable;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			istd::IChangeable::ChangeSet changeSet(istd::IChangeable::CF_ANY, 10, 20);
+			istd::CChangeNotifier notifier(&changeable, &changeSet);
+		}
+	}
+
+	QVERIFY(changeable.GetCounter() >= s_notificationsCount);
+}
+
+
+void CChangeNotifierBenchmarkTest::NotifierRoundTripWithDescriptionBenchmark()
+{
+	CCumulatingChangeable changeable;
+
+	static const istd::IChangeable::ChangeSet changeSet(istd::IChangeable::CF_ANY, 10, 20, "Parameter changed");
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			istd::CChangeNotifier notifier(&changeable, &changeSet);
+		}
+	}
+
+	QVERIFY(changeable.GetCounter() >= s_notificationsCount);
+}
+
+
+void CChangeNotifierBenchmarkTest::NotifierRoundTripWithExtraIdsBenchmark()
+{
+	CCumulatingChangeable changeable;
+
+	static const istd::IChangeable::ChangeSet changeSet(istd::IChangeable::CF_ANY, 1000, 2000);
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			istd::CChangeNotifier notifier(&changeable, &changeSet);
+		}
+	}
+
+	QVERIFY(changeable.GetCounter() >= s_notificationsCount);
+}
+
+
+void CChangeNotifierBenchmarkTest::CumulateChangesBenchmark()
+{
+	istd::IChangeable::ChangeSet cumulatedChanges;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			cumulatedChanges += istd::IChangeable::ChangeSet(istd::IChangeable::CF_ANY, i % 32);
+		}
+	}
+
+	QVERIFY(cumulatedChanges.Contains(istd::IChangeable::CF_ANY));
+}
+
+
+void CChangeNotifierBenchmarkTest::LegacyNotifierRoundTripBenchmark()
+{
+	LegacyChangeSet lastChangeSet;
+	LegacyChangeSet cumulatedChanges;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			LegacyChangeSet changeSet;
+			changeSet.ids << istd::IChangeable::CF_ANY << 10 << 20;
+
+			CLegacyNotifier notifier(lastChangeSet, cumulatedChanges, changeSet);
+		}
+	}
+
+	QVERIFY(lastChangeSet.ids.contains(istd::IChangeable::CF_ANY));
+}
+
+
+void CChangeNotifierBenchmarkTest::LegacyCumulateChangesBenchmark()
+{
+	LegacyChangeSet cumulatedChanges;
+
+	QBENCHMARK{
+		for (int i = 0; i < s_notificationsCount; ++i){
+			LegacyChangeSet changeSet;
+			changeSet.ids << istd::IChangeable::CF_ANY << i % 32;
+
+			cumulatedChanges += changeSet;
+		}
+	}
+
+	QVERIFY(cumulatedChanges.ids.contains(istd::IChangeable::CF_ANY));
+}
+
+
+void CChangeNotifierBenchmarkTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CChangeNotifierBenchmarkTest);
+
+
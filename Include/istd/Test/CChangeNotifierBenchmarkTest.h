@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <istd/IChangeable.h>
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Micro-benchmark of the change notification round-trip (\c CChangeNotifier construction and destruction).
+	The \c Legacy* cases measure the same round-trip using the former \c QSet based change set representation as reference.
+*/
+class CChangeNotifierBenchmarkTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void NotifierRoundTripBenchmark();
+	void NotifierRoundTripWithDescriptionBenchmark();
+	void NotifierRoundTripWithExtraIdsBenchmark();
+	void CumulateChangesBenchmark();
+
+	void LegacyNotifierRoundTripBenchmark();
+	void LegacyCumulateChangesBenchmark();
+
+	void cleanupTestCase();
+};
+
+
@@ -144,6 +144,58 @@ void CChangeSetTest::MaskOutTest()
 }
 
 
+void CChangeSetTest::ExtraIdsTest()
+{
+	// IDs outside of the inline bit mask range must behave like the low ones
+	istd::IChangeable::ChangeSet changeSet1(10, 63, 64, 1000, -5);
+	istd::IChangeable::ChangeSet changeSet2(1000);
+	istd::IChangeable::ChangeSet changeSet3(64, -5);
+
+	QVERIFY(changeSet1.Contains(63));
+	QVERIFY(changeSet1.Contains(64));
+	QVERIFY(changeSet1.Contains(1000));
+	QVERIFY(changeSet1.Contains(-5));
+	QVERIFY(!changeSet1.Contains(65));
+	QVERIFY(!changeSet1.Contains(-1));
+
+	QCOMPARE(changeSet1.GetIds(), QSet<int>({10, 63, 64, 1000, -5}));
+
+	QVERIFY(changeSet1.ContainsAny(changeSet2));
+	QVERIFY(changeSet2.ContainsAny(changeSet1));
+	QVERIFY(!changeSet2.ContainsAny(changeSet3));
+
+	changeSet1.MaskOut(changeSet3);
+	QVERIFY(changeSet1.Contains(1000));
+	QVERIFY(!changeSet1.Contains(64));
+	QVERIFY(!changeSet1.Contains(-5));
+
+	changeSet1.MaskOut(istd::IChangeable::ChangeSet(10, 63, 1000));
+	QVERIFY(changeSet1.IsEmpty());
+
+	// CF_ALL_DATA matches also extra IDs
+	istd::IChangeable::ChangeSet allChanges(istd::IChangeable::CF_ALL_DATA);
+	QVERIFY(allChanges.Contains(1000));
+	QVERIFY(allChanges.ContainsAny(changeSet2));
+	QVERIFY(changeSet2.ContainsAny(allChanges));
+
+	istd::IChangeable::ChangeSet unitedSet = changeSet2 + changeSet3;
+	QCOMPARE(unitedSet.GetIds(), QSet<int>({64, 1000, -5}));
+}
+
+
+void CChangeSetTest::ContainsExplicitTest()
+{
+	istd::IChangeable::ChangeSet singleSet(1000);
+	QVERIFY(singleSet.ContainsExplicit(1000, true));
+
+	istd::IChangeable::ChangeSet mixedSet(istd::IChangeable::CF_ALL_DATA, 1000);
+	QVERIFY(mixedSet.Contains(20));
+	QVERIFY(!mixedSet.ContainsExplicit(20));
+	QVERIFY(mixedSet.ContainsExplicit(1000));
+	QVERIFY(!mixedSet.ContainsExplicit(1000, true));
+}
+
+
 void CChangeSetTest::cleanupTestCase()
 {
 }
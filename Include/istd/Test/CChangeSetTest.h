@@ -26,6 +26,8 @@ private slots:
 	void GetIdsTest();
 	void ResetTest();
 	void MaskOutTest();
+	void ExtraIdsTest();
+	void ContainsExplicitTest();
 
 	void cleanupTestCase();
 };
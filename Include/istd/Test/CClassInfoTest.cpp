@@ -94,6 +94,51 @@ void CClassInfoTest::GetInfoStaticTest()
 }
 
 
+void CClassInfoTest::TypeIdTest()
+{
+	istd::CClassInfo invalidInfo;
+	QCOMPARE(invalidInfo.GetTypeId(), 0);
+
+	istd::CClassInfo info1(typeid(QString));
+	istd::CClassInfo info2 = istd::CClassInfo::GetInfo<QString>();
+	istd::CClassInfo info3(typeid(int));
+	QVERIFY(info1.GetTypeId() != 0);
+	QCOMPARE(info1.GetTypeId(), info2.GetTypeId());
+	QVERIFY(info1.GetTypeId() != info3.GetTypeId());
+
+	// interned name gives the same ID as RTTI type
+	QCOMPARE(istd::CClassInfo::GetTypeId(info1.GetName()), info1.GetTypeId());
+
+	istd::CClassInfo namedInfo(info1.GetName());
+	QVERIFY(namedInfo == info1);
+}
+
+
+void CClassInfoTest::ConstCastTest()
+{
+	istd::CClassInfo info(typeid(QString));
+	QVERIFY(!info.IsConst());
+
+	istd::CClassInfo constInfo = info.GetConstCasted(true);
+	QVERIFY(constInfo.IsConst());
+	QVERIFY(constInfo != info);
+	QCOMPARE(constInfo.GetName(), "const " + info.GetName());
+
+	istd::CClassInfo nonConstInfo = constInfo.GetConstCasted(false);
+	QVERIFY(!nonConstInfo.IsConst());
+	QVERIFY(nonConstInfo == info);
+	QCOMPARE(nonConstInfo.GetTypeId(), info.GetTypeId());
+}
+
+
+void CClassInfoTest::IsVoidTest()
+{
+	QVERIFY(istd::CClassInfo::GetInfo<void>().IsVoid());
+	QVERIFY(!istd::CClassInfo::GetInfo<int>().IsVoid());
+	QVERIFY(!istd::CClassInfo().IsVoid());
+}
+
+
 void CClassInfoTest::cleanupTestCase()
 {
 }
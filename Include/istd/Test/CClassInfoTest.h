@@ -24,6 +24,9 @@ private slots:
 	void ComparisonOperatorsTest();
 	void IsTypeTest();
 	void GetInfoStaticTest();
+	void TypeIdTest();
+	void ConstCastTest();
+	void IsVoidTest();
 
 	void cleanupTestCase();
 };
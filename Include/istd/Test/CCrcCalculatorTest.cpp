@@ -2,6 +2,20 @@
 #include "CCrcCalculatorTest.h"
 
 
+// ACF includes
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace
+{
+
+
+static const int s_benchmarkRepeatCount = 8;
+
+
+} // namespace
+
+
 // protected slots
 
 void CCrcCalculatorTest::initTestCase()
@@ -87,9 +101,150 @@ void CCrcCalculatorTest::CrcConsistencyTest()
 }
 
 
+void CCrcCalculatorTest::KnownValueTest()
+{
+	// Standard check value of CRC-32 (IEEE 802.3)
+	const char* testData = "123456789";
+
+	QCOMPARE(istd::CCrcCalculator::GetCrcFromData(reinterpret_cast<const quint8*>(testData), 9), quint32(0xCBF43926));
+	QCOMPARE(istd::CCrcCalculator::GetCrcFromData(nullptr, 0), quint32(0));
+}
+
+
+void CCrcCalculatorTest::ReferenceCompatibilityTest_data()
+{
+	QTest::addColumn<int>("dataSize");
+
+	QTest::newRow("1 byte") << 1;
+	QTest::newRow("15 bytes") << 15;
+	QTest::newRow("63 bytes") << 63;
+	QTest::newRow("64 bytes") << 64;
+	QTest::newRow("79 bytes") << 79;
+	QTest::newRow("257 bytes") << 257;
+	QTest::newRow("4099 bytes") << 4099;
+	QTest::newRow("1 MB + 7 bytes") << 1024 * 1024 + 7;
+}
+
+
+void CCrcCalculatorTest::ReferenceCompatibilityTest()
+{
+	QFETCH(int, dataSize);
+
+	QByteArray data = CreateRandomData(dataSize + 16);
+
+	// accelerated paths must give the same result for all alignments
+	for (int offset = 0; offset < 16; ++offset){
+		const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData()) + offset;
+
+		QCOMPARE(istd::CCrcCalculator::GetCrcFromData(dataPtr, dataSize), CalculateReferenceCrc(dataPtr, dataSize));
+	}
+}
+
+
+void CCrcCalculatorTest::IncrementalUpdateTest()
+{
+	QByteArray data = CreateRandomData(100000);
+	const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData());
+
+	quint32 expectedCrc = istd::CCrcCalculator::GetCrcFromData(dataPtr, data.size());
+
+	const int chunkSizes[] = {1, 3, 16, 63, 64, 1000, 65536};
+	for (int chunkSize : chunkSizes){
+		istd::CCrcCalculator calculator;
+
+		for (int position = 0; position < data.size(); position += chunkSize){
+			calculator.Update(dataPtr + position, qMin(chunkSize, data.size() - position));
+		}
+
+		QCOMPARE(calculator.GetCrc(), expectedCrc);
+	}
+
+	istd::CCrcCalculator calculator;
+	calculator.Update(dataPtr, 100);
+	calculator.Reset();
+	calculator.Update(dataPtr, data.size());
+
+	QCOMPARE(calculator.GetCrc(), expectedCrc);
+}
+
+
+void CCrcCalculatorTest::GetCrcFromFileTest()
+{
+	QVERIFY(m_tempDir.isValid());
+
+	QByteArray data = CreateRandomData(3 * 1024 * 1024 + 11);
+
+	QString filePath = m_tempDir.filePath("CrcTest.bin");
+	QFile file(filePath);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	QCOMPARE(file.write(data), qint64(data.size()));
+	file.close();
+
+	quint32 expectedCrc = istd::CCrcCalculator::GetCrcFromData(reinterpret_cast<const quint8*>(data.constData()), data.size());
+
+	QCOMPARE(istd::CCrcCalculator::GetCrcFromFile(filePath), expectedCrc);
+	QCOMPARE(istd::CCrcCalculator::GetCrcFromFile(m_tempDir.filePath("NotExisting.bin")), quint32(0));
+}
+
+
+void CCrcCalculatorTest::GetCrcFromDataBenchmark_data()
+{
+	QTest::addColumn<int>("dataSize");
+
+	QTest::newRow("4 KB") << 4 * 1024;
+	QTest::newRow("1 MB") << 1024 * 1024;
+	QTest::newRow("64 MB") << 64 * 1024 * 1024;
+}
+
+
+void CCrcCalculatorTest::GetCrcFromDataBenchmark()
+{
+	QFETCH(int, dataSize);
+
+	QByteArray data = CreateRandomData(dataSize);
+	const quint8* dataPtr = reinterpret_cast<const quint8*>(data.constData());
+
+	int repeatCount = qMax(s_benchmarkRepeatCount, (64 * 1024 * 1024) / dataSize);
+
+	quint32 crcValue = 0;
+
+	QBENCHMARK{
+		for (int i = 0; i < repeatCount; ++i){
+			crcValue = istd::CCrcCalculator::GetCrcFromData(dataPtr, dataSize);
+		}
+	}
+
+	QCOMPARE(crcValue, CalculateReferenceCrc(dataPtr, dataSize));
+}
+
+
 void CCrcCalculatorTest::cleanupTestCase()
 {
 }
 
 
+// private static methods
+
+quint32 CCrcCalculatorTest::CalculateReferenceCrc(const quint8* dataPtr, int dataSize)
+{
+	quint32 crcValue = 0xFFFFFFFF;
+
+	for (int i = 0; i < dataSize; ++i){
+		crcValue ^= dataPtr[i];
+
+		for (int bitIndex = 0; bitIndex < 8; ++bitIndex){
+			crcValue = (crcValue & 1)? (crcValue >> 1) ^ 0xEDB88320: (crcValue >> 1);
+		}
+	}
+
+	return ~crcValue;
+}
+
+
+QByteArray CCrcCalculatorTest::CreateRandomData(int dataSize)
+{
+	return itest::CRandomDataGenerator(quint32(dataSize)).CreateData(dataSize);
+}
+
+
 I_ADD_TEST(CCrcCalculatorTest);
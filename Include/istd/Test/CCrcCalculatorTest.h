@@ -4,6 +4,7 @@
 
 // Qt includes
 #include <QtCore/QObject>
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QtTest>
 
 // ACF includes
@@ -19,8 +20,21 @@ private slots:
 	void GetCrcFromDataTest();
 	void GetCrcFromStreamTest();
 	void CrcConsistencyTest();
+	void KnownValueTest();
+	void ReferenceCompatibilityTest_data();
+	void ReferenceCompatibilityTest();
+	void IncrementalUpdateTest();
+	void GetCrcFromFileTest();
+	void GetCrcFromDataBenchmark_data();
+	void GetCrcFromDataBenchmark();
 
 	void cleanupTestCase();
+
+private:
+	static quint32 CalculateReferenceCrc(const quint8* dataPtr, int dataSize);
+	static QByteArray CreateRandomData(int dataSize);
+
+	QTemporaryDir m_tempDir;
 };
 
 
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <istd/Test/CParallelForTest.h>
+
+
+// STL includes
+#include <limits>
+
+// Qt includes
+#include <QtCore/QAtomicInt>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+// ACF includes
+#include <istd/CParallelFor.h>
+
+
+void CParallelForTest::ProcessInParallelTest()
+{
+	const int count = 10000;
+
+	QVector<int> results(count, 0);
+	QAtomicInt callsCount(0);
+
+	bool retVal = istd::CParallelFor::ProcessInParallel(count, [&results, &callsCount](int index){
+		results[index] = index * 2;
+		callsCount.fetchAndAddRelaxed(1);
+
+		return true;
+	});
+
+	QVERIFY(retVal);
+	QCOMPARE(callsCount.loadAcquire(), count);
+
+	for (int i = 0; i < count; ++i){
+		QCOMPARE(results[i], i * 2);
+	}
+
+	QVERIFY(istd::CParallelFor::ProcessInParallel(0, [](int){ return false; }));
+}
+
+
+void CParallelForTest::FailedProcessingTest()
+{
+	bool retVal = istd::CParallelFor::ProcessInParallel(1000, [](int index){
+		return index != 500;
+	});
+
+	QVERIFY(!retVal);
+}
+
+
+void CParallelForTest::NestedProcessingTest()
+{
+	// the calling threads take part in the processing, so nested calls cannot block the thread pool
+	const int outerCount = 64;
+	const int innerCount = 100;
+
+	QVector<int> sums(outerCount, 0);
+
+	bool retVal = istd::CParallelFor::ProcessInParallel(outerCount, [&sums, innerCount](int outerIndex){
+		QVector<int> values(innerCount, 0);
+
+		bool innerRetVal = istd::CParallelFor::ProcessInParallel(innerCount, [&values](int innerIndex){
+			values[innerIndex] = innerIndex;
+
+			return true;
+		});
+
+		for (int i = 0; i < innerCount; ++i){
+			sums[outerIndex] += values[i];
+		}
+
+		return innerRetVal;
+	});
+
+	QVERIFY(retVal);
+
+	for (int i = 0; i < outerCount; ++i){
+		QCOMPARE(sums[i], innerCount * (innerCount - 1) / 2);
+	}
+}
+
+
+void CParallelForTest::GetBandsCountTest()
+{
+	QCOMPARE(istd::CParallelFor::GetBandsCount(0, 1000000000), 0);
+	QCOMPARE(istd::CParallelFor::GetBandsCount(-5, 1000000000), 0);
+
+	// small work is not split
+	QCOMPARE(istd::CParallelFor::GetBandsCount(1000, istd::CParallelFor::MIN_BAND_WORK_AMOUNT - 1), 1);
+
+	// bands are never empty
+	QCOMPARE(istd::CParallelFor::GetBandsCount(1, std::numeric_limits<qint64>::max()), 1);
+
+	const int bandsCount = istd::CParallelFor::GetBandsCount(100000, std::numeric_limits<qint64>::max());
+	QCOMPARE(bandsCount, QThread::idealThreadCount() * 4);
+}
+
+
+void CParallelForTest::ProcessBandsTest()
+{
+	const int itemsCount = 1001;
+	const int bandsCount = 7;
+
+	QVector<int> itemBands(itemsCount, -1);
+	QVector<int> bandSizes(bandsCount, 0);
+
+	istd::CParallelFor::ProcessBands(itemsCount, bandsCount, [&itemBands, &bandSizes](int bandIndex, int beginIndex, int endIndex){
+		for (int i = beginIndex; i < endIndex; ++i){
+			itemBands[i] = bandIndex;
+		}
+
+		bandSizes[bandIndex] = endIndex - beginIndex;
+	});
+
+	// the bands are consecutive and cover the whole range
+	for (int i = 1; i < itemsCount; ++i){
+		QVERIFY(itemBands[i] >= 0);
+		QVERIFY(itemBands[i] - itemBands[i - 1] >= 0);
+		QVERIFY(itemBands[i] - itemBands[i - 1] <= 1);
+	}
+
+	QCOMPARE(itemBands[0], 0);
+	QCOMPARE(itemBands[itemsCount - 1], bandsCount - 1);
+
+	for (int i = 0; i < bandsCount; ++i){
+		QVERIFY(bandSizes[i] >= itemsCount / bandsCount);
+		QVERIFY(bandSizes[i] <= itemsCount / bandsCount + 1);
+	}
+
+	// single band is processed in the calling thread
+	Qt::HANDLE callingThreadId = QThread::currentThreadId();
+	Qt::HANDLE bandThreadId = NULL;
+	int processedCount = 0;
+
+	istd::CParallelFor::ProcessBands(itemsCount, 1, [&bandThreadId, &processedCount](int /*bandIndex*/, int beginIndex, int endIndex){
+		bandThreadId = QThread::currentThreadId();
+		processedCount += endIndex - beginIndex;
+	});
+
+	QVERIFY(bandThreadId == callingThreadId);
+	QCOMPARE(processedCount, itemsCount);
+}
+
+
+I_ADD_TEST(CParallelForTest);
+
+
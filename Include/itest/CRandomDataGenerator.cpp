@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include <itest/CRandomDataGenerator.h>
+
+
+namespace itest
+{
+
+
+CRandomDataGenerator::CRandomDataGenerator(quint32 seed)
+:	m_state(seed)
+{
+}
+
+
+quint32 CRandomDataGenerator::GetNextValue()
+{
+	m_state = m_state * 1103515245 + 12345;
+
+	return m_state;
+}
+
+
+quint8 CRandomDataGenerator::GetNextByte()
+{
+	return quint8(GetNextValue() >> 24);
+}
+
+
+QByteArray CRandomDataGenerator::CreateData(int size)
+{
+	QByteArray retVal(size, '\0');
+
+	char* dataPtr = retVal.data();
+	for (int i = 0; i < size; ++i){
+		dataPtr[i] = char(GetNextByte());
+	}
+
+	return retVal;
+}
+
+
+} // namespace itest
+
+
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QByteArray>
+
+
+namespace itest
+{
+
+
+/**
+	Generator of reproducible pseudo-random test data.
+	The same seed always produces the same sequence, independent of the platform and Qt version.
+*/
+class CRandomDataGenerator
+{
+public:
+	explicit CRandomDataGenerator(quint32 seed = 1);
+
+	/**
+		Get next 32-bit value of the sequence, the higher bits have better random properties.
+	*/
+	quint32 GetNextValue();
+
+	/**
+		Get next random byte.
+	*/
+	quint8 GetNextByte();
+
+	/**
+		Create buffer of random bytes.
+	*/
+	QByteArray CreateData(int size);
+
+private:
+	quint32 m_state;
+};
+
+
+} // namespace itest
+
+
@@ -13,6 +13,7 @@
 #include <icmm/CRgb.h>
 #include <icmm/CHsv.h>
 #include <iimg/CBitmap.h>
+#include <iimg/CPixelFormatConverter.h>
 #include <iview/CScreenTransform.h>
 
 
@@ -83,36 +84,35 @@ void CImageShape::AfterUpdate(imod::IModel* modelPtr, const istd::IChangeable::C
 		m_pixmapOffset = providerPtr->GetQImage().offset();
 	}
 
-	if (m_colorTransformationPtr != NULL){
-		QImage image = providerPtr->GetQImage().copy();
-
-		if (!image.text("Error").isEmpty()) {
-			m_ignoreTransformation = true;
-		}
+	const QImage& sourceImage = providerPtr->GetQImage();
 
-		SetLookupTableToImage(image, *m_colorTransformationPtr);
-		if (!image.isNull()){
-			m_pixmap = QPixmap::fromImage(image, Qt::AutoColor);
-		}
-		else{
-			m_pixmap = QPixmap();
-		}
+	if (!sourceImage.text("Error").isEmpty()){
+		m_ignoreTransformation = true;
 	}
-	else{
-		const QImage& image = providerPtr->GetQImage();
 
-		if (!image.text("Error").isEmpty()) {
-			m_ignoreTransformation = true;
+	QImage transformedImage;
+	if (m_colorTransformationPtr != NULL){
+		const iimg::IBitmap* sourceBitmapPtr = dynamic_cast<const iimg::IBitmap*>(providerPtr);
+		if ((sourceBitmapPtr != NULL) && (sourceBitmapPtr->GetPixelFormat() == iimg::IBitmap::PF_GRAY)){
+			transformedImage = CreateTransformedImage(*sourceBitmapPtr, *m_colorTransformationPtr);
 		}
 
-		if (!image.isNull()){
-			m_pixmap = QPixmap::fromImage(image, Qt::AutoColor);
-		}
-		else{
-			m_pixmap = QPixmap();
+		// only the color table of grayscale images can be changed, other images are shown without copying
+		if (transformedImage.isNull() && sourceImage.isGrayscale()){
+			transformedImage = sourceImage.copy();
+
+			SetLookupTableToImage(transformedImage, *m_colorTransformationPtr);
 		}
 	}
 
+	const QImage& image = transformedImage.isNull()? sourceImage: transformedImage;
+	if (!image.isNull()){
+		m_pixmap = QPixmap::fromImage(image, Qt::AutoColor);
+	}
+	else{
+		m_pixmap = QPixmap();
+	}
+
 	BaseClass::AfterUpdate(modelPtr, changeSet);
 }
 
@@ -355,30 +355,52 @@ void CImageShape::DrawPixmap(
 
 // private methods
 
-void CImageShape::SetLookupTableToImage(QImage& image, const icmm::IColorTransformation& colorTransformation)
+QVector<QRgb> CImageShape::CalcColorTable(const icmm::IColorTransformation& colorTransformation)
 {
-	if (image.isGrayscale()){
-		QVector<QRgb> rgbTable;
-		for (int colorIndex = 0; colorIndex < 256; colorIndex++){
-			icmm::CVarColor argumentColor;
-			argumentColor.SetElementsCount(1);
-			argumentColor.SetElement(0, colorIndex / 255.0);
-
-			icmm::CVarColor result = colorTransformation.GetValueAt(argumentColor);
-			if (result.GetElementsCount() == 3){
-				rgbTable.append(qRgb(result[0] * 255, result[1] * 255, result[2] * 255));
-			}
-			else{
-				rgbTable.append(qRgb(colorIndex, colorIndex, colorIndex));
-			}
+	QVector<QRgb> rgbTable;
+	rgbTable.reserve(256);
+
+	for (int colorIndex = 0; colorIndex < 256; colorIndex++){
+		icmm::CVarColor argumentColor;
+		argumentColor.SetElementsCount(1);
+		argumentColor.SetElement(0, colorIndex / 255.0);
+
+		icmm::CVarColor result = colorTransformation.GetValueAt(argumentColor);
+		if (result.GetElementsCount() == 3){
+			rgbTable.append(qRgb(result[0] * 255, result[1] * 255, result[2] * 255));
+		}
+		else{
+			rgbTable.append(qRgb(colorIndex, colorIndex, colorIndex));
 		}
+	}
+
+	return rgbTable;
+}
+
+
+QImage CImageShape::CreateTransformedImage(const iimg::IBitmap& bitmap, const icmm::IColorTransformation& colorTransformation) const
+{
+	const QVector<QRgb> colorTable = CalcColorTable(colorTransformation);
+
+	iimg::CBitmap colorBitmap;
+	if (!iimg::CPixelFormatConverter::ConvertUsingColorTable(bitmap, colorTable.constData(), iimg::IBitmap::PF_RGB, colorBitmap)){
+		return QImage();
+	}
+
+	return colorBitmap.GetQImage();
+}
+
+
+void CImageShape::SetLookupTableToImage(QImage& image, const icmm::IColorTransformation& colorTransformation)
+{
+	Q_ASSERT(image.isGrayscale());
+
 #if QT_VERSION < 0x050000
-		image.setNumColors(256);
+	image.setNumColors(256);
 #else
-		image.setColorCount(256);
+	image.setColorCount(256);
 #endif
-		image.setColorTable(rgbTable);
-	}
+	image.setColorTable(CalcColorTable(colorTransformation));
 }
 
 
@@ -48,6 +48,18 @@ protected:
 				const i2d::CRect& bitmapArea,
 				const i2d::CAffine2d& destTransform) const;
 private:
+	/**
+		Calculate lookup table of 256 colors for the gray values from the color transformation.
+	*/
+	static QVector<QRgb> CalcColorTable(const icmm::IColorTransformation& colorTransformation);
+	/**
+		Create color image of 8-bit gray bitmap using lookup table calculated from the color transformation.
+	*/
+	QImage CreateTransformedImage(const iimg::IBitmap& bitmap, const icmm::IColorTransformation& colorTransformation) const;
+	/**
+		Set lookup table calculated from the color transformation to the grayscale image.
+		It is used for images not provided as 8-bit gray bitmaps.
+	*/
 	void SetLookupTableToImage(QImage& image, const icmm::IColorTransformation& colorTransformation);
 
 private:
@@ -194,6 +194,69 @@ void CIdocCompTest::testUndoManagerMultipleSteps()
 }
 
 
+void CIdocCompTest::testUndoManagerLargeDocument()
+{
+	imod::IObserver* observer = dynamic_cast<imod::IObserver*>(m_undoManagerPtr);
+	QVERIFY(observer != nullptr);
+
+	imod::IModel* model = dynamic_cast<imod::IModel*>(m_textDocumentPtr);
+	QVERIFY(model != nullptr);
+	model->AttachObserver(observer);
+
+	m_undoManagerPtr->ResetUndo();
+
+	// large document with small changes, each undo step stores only the changed part
+	QString text;
+	for (int i = 0; i < 20000; ++i){
+		text += QString("Line %1\n").arg(i);
+	}
+
+	m_textDocumentPtr->SetText(text);
+
+	QStringList texts;
+	texts.append(text);
+
+	for (int stepIndex = 0; stepIndex < 20; ++stepIndex){
+		text.replace(stepIndex * 1000, 4, QString("Step"));
+		text.insert(stepIndex * 3000, QString("Inserted %1").arg(stepIndex));
+
+		m_textDocumentPtr->SetText(text);
+
+		texts.append(text);
+	}
+
+	QVERIFY(m_undoManagerPtr->GetAvailableUndoSteps() >= 20);
+
+	// undo the steps one by one and at once
+	QVERIFY(m_undoManagerPtr->DoUndo());
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[19]);
+
+	QVERIFY(m_undoManagerPtr->DoUndo(10));
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[9]);
+
+	QVERIFY(m_undoManagerPtr->DoRedo(5));
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[14]);
+
+	QVERIFY(m_undoManagerPtr->DoUndo(14));
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[0]);
+
+	QVERIFY(m_undoManagerPtr->DoRedo(20));
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[20]);
+	QCOMPARE(m_undoManagerPtr->GetAvailableRedoSteps(), 0);
+
+	// new change removes the redo steps
+	QVERIFY(m_undoManagerPtr->DoUndo(2));
+	m_textDocumentPtr->SetText("New text");
+	QCOMPARE(m_undoManagerPtr->GetAvailableRedoSteps(), 0);
+
+	QVERIFY(m_undoManagerPtr->DoUndo());
+	QCOMPARE(m_textDocumentPtr->GetText(), texts[18]);
+
+	model->DetachObserver(observer);
+	m_undoManagerPtr->ResetUndo();
+}
+
+
 void CIdocCompTest::testUndoManagerMaxBufferSize()
 {
 	// Verify that the small buffer undo manager was created
@@ -29,6 +29,7 @@ private slots:
 	void testUndoManagerCreation();
 	void testUndoManagerUndoRedo();
 	void testUndoManagerMultipleSteps();
+	void testUndoManagerLargeDocument();
 	void testUndoManagerMaxBufferSize();
 	void testUndoManagerReset();
 	void testUndoManagerStateComparison();
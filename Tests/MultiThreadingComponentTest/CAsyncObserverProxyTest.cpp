@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CAsyncObserverProxyTest.h"
+
+
+// Qt includes
+#include <QtCore/QThread>
+
+// ACF includes
+#include <imod/CModelBase.h>
+
+
+namespace
+{
+
+
+class CProducerModel: public imod::CModelBase
+{
+public:
+	void Change(int changeId)
+	{
+		const istd::IChangeable::ChangeSet changeSet(changeId);
+
+		NotifyBeforeChange(changeSet, false);
+		NotifyAfterChange(changeSet);
+	}
+
+protected:
+	// reimplemented (imod::CModelBase)
+	virtual void OnBeginGlobalChanges() override
+	{
+	}
+
+	virtual void OnEndGlobalChanges(const istd::IChangeable::ChangeSet& /*changeSet*/) override
+	{
+	}
+};
+
+
+class CRecordingObserver: public imod::IObserver
+{
+public:
+	int GetAfterUpdateCount() const
+	{
+		return m_afterUpdateCount.loadAcquire();
+	}
+
+	istd::IChangeable::ChangeSet GetLastChangeSet() const
+	{
+		return m_lastChangeSet;
+	}
+
+	// reimplemented (imod::IObserver)
+	virtual bool IsModelAttached(const imod::IModel* /*modelPtr*/ = NULL) const override
+	{
+		return m_isAttached;
+	}
+
+	virtual bool OnModelAttached(imod::IModel* /*modelPtr*/, istd::IChangeable::ChangeSet& changeMask) override
+	{
+		changeMask = istd::IChangeable::GetAllChanges();
+
+		m_isAttached = true;
+
+		return true;
+	}
+
+	virtual bool OnModelDetached(imod::IModel* /*modelPtr*/) override
+	{
+		m_isAttached = false;
+
+		return true;
+	}
+
+	virtual void BeforeUpdate(imod::IModel* /*modelPtr*/) override
+	{
+		Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+	}
+
+	virtual void AfterUpdate(imod::IModel* /*modelPtr*/, const istd::IChangeable::ChangeSet& changeSet) override
+	{
+		m_lastChangeSet = changeSet;
+
+		m_afterUpdateCount.ref();
+	}
+
+private:
+	bool m_isAttached = false;
+	istd::IChangeable::ChangeSet m_lastChangeSet;
+	QAtomicInt m_afterUpdateCount;
+};
+
+
+class CProducerThread: public QThread
+{
+public:
+	CProducerThread(CProducerModel& model, int durationTime)
+	:	m_model(model),
+		m_durationTime(durationTime)
+	{
+	}
+
+protected:
+	// reimplemented (QThread)
+	virtual void run() override
+	{
+		QElapsedTimer timer;
+		timer.start();
+
+		int counter = 0;
+		while (timer.elapsed() < m_durationTime){
+			m_model.Change(10 + counter++ % 10);
+		}
+	}
+
+private:
+	CProducerModel& m_model;
+	int m_durationTime;
+};
+
+
+} // namespace
+
+
+// protected slots
+
+void CAsyncObserverProxyTest::initTestCase()
+{
+}
+
+
+void CAsyncObserverProxyTest::CoalescingTest()
+{
+	CProducerModel model;
+	CRecordingObserver observer;
+	imod::CAsyncObserverProxy proxy(&observer);
+
+	QVERIFY(model.AttachObserver(&proxy));
+	QVERIFY(observer.IsModelAttached());
+
+	for (int i = 0; i < 1000; ++i){
+		model.Change(10 + i % 3);
+	}
+
+	// nothing is delivered before the events are processed
+	QCOMPARE(observer.GetAfterUpdateCount(), 0);
+	QCOMPARE(proxy.GetReceivedUpdatesCount(), qint64(1000));
+
+	QTRY_COMPARE(observer.GetAfterUpdateCount(), 1);
+
+	QCOMPARE(proxy.GetDeliveredUpdatesCount(), qint64(1));
+	QCOMPARE(proxy.GetCoalescedUpdatesCount(), qint64(999));
+
+	istd::IChangeable::ChangeSet lastChangeSet = observer.GetLastChangeSet();
+	QVERIFY(lastChangeSet.Contains(10));
+	QVERIFY(lastChangeSet.Contains(11));
+	QVERIFY(lastChangeSet.Contains(12));
+	QVERIFY(!lastChangeSet.Contains(13));
+
+	model.DetachAllObservers();
+	QVERIFY(!observer.IsModelAttached());
+}
+
+
+void CAsyncObserverProxyTest::RateLimitTest()
+{
+	CProducerModel model;
+	CRecordingObserver observer;
+	imod::CAsyncObserverProxy proxy(&observer, NULL, 20);
+
+	QVERIFY(model.AttachObserver(&proxy));
+
+	CProducerThread producer(model, 500);
+	producer.start();
+
+	while (!producer.wait(10)){
+		QCoreApplication::processEvents();
+	}
+
+	QTest::qWait(100);
+	proxy.FlushPendingUpdates();
+
+	// 20 deliveries per second for 0.5 s, some tolerance for the timer resolution
+	QVERIFY(observer.GetAfterUpdateCount() > 0);
+	QVERIFY(observer.GetAfterUpdateCount() <= 15);
+	QVERIFY(proxy.GetReceivedUpdatesCount() > proxy.GetDeliveredUpdatesCount());
+	QCOMPARE(proxy.GetReceivedUpdatesCount(), proxy.GetDeliveredUpdatesCount() + proxy.GetCoalescedUpdatesCount());
+
+	qInfo("received: %lld, delivered: %lld, coalesced: %lld", proxy.GetReceivedUpdatesCount(), proxy.GetDeliveredUpdatesCount(), proxy.GetCoalescedUpdatesCount());
+
+	model.DetachAllObservers();
+}
+
+
+void CAsyncObserverProxyTest::DetachDropsPendingUpdatesTest()
+{
+	CProducerModel model;
+	CRecordingObserver observer;
+	imod::CAsyncObserverProxy proxy(&observer);
+
+	QVERIFY(model.AttachObserver(&proxy));
+
+	model.Change(10);
+	model.DetachObserver(&proxy);
+
+	QVERIFY(!observer.IsModelAttached());
+
+	QTest::qWait(50);
+
+	QCOMPARE(observer.GetAfterUpdateCount(), 0);
+}
+
+
+void CAsyncObserverProxyTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CAsyncObserverProxyTest);
+
+
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <imod/CAsyncObserverProxy.h>
+#include <itest/CStandardTestExecutor.h>
+
+
+class CAsyncObserverProxyTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void CoalescingTest();
+	void RateLimitTest();
+	void DetachDropsPendingUpdatesTest();
+
+	void cleanupTestCase();
+};
+
+
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CModelDispatchStressTest.h"
+
+
+// Qt includes
+#include <QtCore/QThread>
+#include <QtCore/QAtomicPointer>
+
+// ACF includes
+#include <imod/IObserver.h>
+
+
+namespace
+{
+
+
+static const int s_valueChangeId = 20;
+
+
+/**
+	Simple model producing one change notification per value change.
+*/
+class CStressTestModel: public imod::CModelBase
+{
+public:
+	void SetValue(int value)
+	{
+		static const istd::IChangeable::ChangeSet s_changeSet(s_valueChangeId);
+
+		NotifyBeforeChange(s_changeSet, false);
+
+		m_value = value;
+
+		NotifyAfterChange(s_changeSet);
+	}
+
+protected:
+	// reimplemented (imod::CModelBase)
+	virtual void OnBeginGlobalChanges() override
+	{
+	}
+
+	virtual void OnEndGlobalChanges(const istd::IChangeable::ChangeSet& /*changeSet*/) override
+	{
+	}
+
+private:
+	int m_value = 0;
+};
+
+
+/**
+	Observer counting notifications and notifications received while not attached.
+*/
+class CCountingObserver: public imod::IObserver
+{
+public:
+	int GetBeforeUpdateCount() const
+	{
+		return m_beforeUpdateCount.loadAcquire();
+	}
+
+	int GetAfterUpdateCount() const
+	{
+		return m_afterUpdateCount.loadAcquire();
+	}
+
+	int GetViolationsCount() const
+	{
+		return m_violationsCount.loadAcquire();
+	}
+
+	// reimplemented (imod::IObserver)
+	virtual bool IsModelAttached(const imod::IModel* modelPtr = NULL) const override
+	{
+		imod::IModel* attachedModelPtr = m_modelPtr.loadAcquire();
+
+		return (modelPtr == NULL) ? (attachedModelPtr != NULL) : (attachedModelPtr == modelPtr);
+	}
+
+	virtual bool OnModelAttached(imod::IModel* modelPtr, istd::IChangeable::ChangeSet& changeMask) override
+	{
+		changeMask += s_valueChangeId;
+
+		m_modelPtr.storeRelease(modelPtr);
+
+		return true;
+	}
+
+	virtual bool OnModelDetached(imod::IModel* /*modelPtr*/) override
+	{
+		m_modelPtr.storeRelease(NULL);
+
+		return true;
+	}
+
+	virtual void BeforeUpdate(imod::IModel* modelPtr) override
+	{
+		if (m_modelPtr.loadAcquire() != modelPtr){
+			m_violationsCount.ref();
+		}
+
+		m_beforeUpdateCount.ref();
+	}
+
+	virtual void AfterUpdate(imod::IModel* modelPtr, const istd::IChangeable::ChangeSet& /*changeSet*/) override
+	{
+		if (m_modelPtr.loadAcquire() != modelPtr){
+			m_violationsCount.ref();
+		}
+
+		m_afterUpdateCount.ref();
+	}
+
+private:
+	QAtomicPointer<imod::IModel> m_modelPtr;
+	QAtomicInt m_beforeUpdateCount;
+	QAtomicInt m_afterUpdateCount;
+	QAtomicInt m_violationsCount;
+};
+
+
+/**
+	Thread attaching and detaching its own observers until it is stopped.
+*/
+class CChurnThread: public QThread
+{
+public:
+	CChurnThread(imod::IModel& model, const QAtomicInt& stopFlag)
+	:	m_model(model),
+		m_stopFlag(stopFlag),
+		m_cyclesCount(0)
+	{
+	}
+
+	int GetCyclesCount() const
+	{
+		return m_cyclesCount;
+	}
+
+	bool IsBalanced() const
+	{
+		return m_isBalanced;
+	}
+
+protected:
+	// reimplemented (QThread)
+	virtual void run() override
+	{
+		m_isBalanced = true;
+
+		while (m_stopFlag.loadAcquire() == 0){
+			CCountingObserver observer;
+
+			if (m_model.AttachObserver(&observer)){
+				QThread::yieldCurrentThread();
+
+				m_model.DetachObserver(&observer);
+			}
+
+			if ((observer.GetBeforeUpdateCount() != observer.GetAfterUpdateCount()) || (observer.GetViolationsCount() != 0)){
+				m_isBalanced = false;
+			}
+
+			++m_cyclesCount;
+		}
+	}
+
+private:
+	imod::IModel& m_model;
+	const QAtomicInt& m_stopFlag;
+	int m_cyclesCount;
+	bool m_isBalanced = true;
+};
+
+
+} // namespace
+
+
+// protected slots
+
+void CModelDispatchStressTest::initTestCase()
+{
+}
+
+
+void CModelDispatchStressTest::NotificationThroughputTest_data()
+{
+	CreateModeRows();
+}
+
+
+void CModelDispatchStressTest::NotificationThroughputTest()
+{
+	QFETCH(int, dispatchMode);
+	QFETCH(int, observersCount);
+
+	CStressTestModel model;
+	QVERIFY(model.SetDispatchMode(imod::CModelBase::DispatchMode(dispatchMode)));
+
+	QVector<CCountingObserver*> observers;
+	for (int i = 0; i < observersCount; ++i){
+		CCountingObserver* observerPtr = new CCountingObserver;
+		QVERIFY(model.AttachObserver(observerPtr));
+
+		observers.append(observerPtr);
+	}
+
+	QCOMPARE(model.GetObserverCount(), observersCount);
+
+	QBENCHMARK{
+		for (int i = 0; i < 1000; ++i){
+			model.SetValue(i);
+		}
+	}
+
+	model.DetachAllObservers();
+
+	for (CCountingObserver* observerPtr: observers){
+		QVERIFY(observerPtr->GetAfterUpdateCount() >= 1000);
+		QCOMPARE(observerPtr->GetBeforeUpdateCount(), observerPtr->GetAfterUpdateCount());
+		QCOMPARE(observerPtr->GetViolationsCount(), 0);
+
+		delete observerPtr;
+	}
+}
+
+
+void CModelDispatchStressTest::AttachDetachChurnTest_data()
+{
+	CreateModeRows();
+}
+
+
+void CModelDispatchStressTest::AttachDetachChurnTest()
+{
+	QFETCH(int, dispatchMode);
+	QFETCH(int, observersCount);
+
+	CStressTestModel model;
+	QVERIFY(model.SetDispatchMode(imod::CModelBase::DispatchMode(dispatchMode)));
+
+	QVector<CCountingObserver*> observers;
+	for (int i = 0; i < observersCount; ++i){
+		CCountingObserver* observerPtr = new CCountingObserver;
+		QVERIFY(model.AttachObserver(observerPtr));
+
+		observers.append(observerPtr);
+	}
+
+	QAtomicInt stopFlag;
+	QVector<CChurnThread*> churnThreads;
+	for (int i = 0; i < 4; ++i){
+		CChurnThread* threadPtr = new CChurnThread(model, stopFlag);
+		threadPtr->start();
+
+		churnThreads.append(threadPtr);
+	}
+
+	static const int notificationsCount = 20000;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int i = 0; i < notificationsCount; ++i){
+		model.SetValue(i);
+	}
+
+	qint64 elapsedTime = qMax(timer.elapsed(), qint64(1));
+
+	stopFlag.storeRelease(1);
+
+	int churnCyclesCount = 0;
+	for (CChurnThread* threadPtr: churnThreads){
+		threadPtr->wait();
+
+		QVERIFY(threadPtr->IsBalanced());
+
+		churnCyclesCount += threadPtr->GetCyclesCount();
+
+		delete threadPtr;
+	}
+
+	qInfo("%d observers: %lld notifications/s, %d attach/detach cycles", observersCount, notificationsCount * qint64(1000) / elapsedTime, churnCyclesCount);
+
+	QCOMPARE(model.GetObserverCount(), observersCount);
+
+	model.DetachAllObservers();
+
+	for (CCountingObserver* observerPtr: observers){
+		QCOMPARE(observerPtr->GetAfterUpdateCount(), notificationsCount);
+		QCOMPARE(observerPtr->GetBeforeUpdateCount(), notificationsCount);
+		QCOMPARE(observerPtr->GetViolationsCount(), 0);
+
+		delete observerPtr;
+	}
+}
+
+
+void CModelDispatchStressTest::cleanupTestCase()
+{
+}
+
+
+// private methods
+
+void CModelDispatchStressTest::CreateModeRows()
+{
+	QTest::addColumn<int>("dispatchMode");
+	QTest::addColumn<int>("observersCount");
+
+	static const int observersCounts[] = {1, 4, 16, 64};
+
+	for (int observersCount: observersCounts){
+		QTest::newRow(qPrintable(QString("locked, %1 observers").arg(observersCount))) << int(imod::CModelBase::DM_LOCKED) << observersCount;
+		QTest::newRow(qPrintable(QString("snapshot, %1 observers").arg(observersCount))) << int(imod::CModelBase::DM_SNAPSHOT) << observersCount;
+	}
+}
+
+
+I_ADD_TEST(CModelDispatchStressTest);
+
+
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <imod/CModelBase.h>
+#include <itest/CStandardTestExecutor.h>
+
+
+/**
+	Stress test of the observer dispatching in \c imod::CModelBase.
+	Notification throughput is measured for both dispatch modes with 1 to 64 observers,
+	with and without concurrent attaching and detaching of observers from other threads.
+*/
+class CModelDispatchStressTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void NotificationThroughputTest_data();
+	void NotificationThroughputTest();
+	void AttachDetachChurnTest_data();
+	void AttachDetachChurnTest();
+
+	void cleanupTestCase();
+
+private:
+	void CreateModeRows();
+};
+
+
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#include "CParallelInstantiationBenchmarkTest.h"
+
+
+// ACF includes
+#include <iprm/ISelectionParam.h>
+#include <iprm/IOptionsManager.h>
+
+
+// protected slots
+
+void CParallelInstantiationBenchmarkTest::initTestCase()
+{
+}
+
+
+void CParallelInstantiationBenchmarkTest::ParallelInstantiationTest()
+{
+	CMultiThreadingComponentTest serialComposition(NULL, true);
+	serialComposition.EnsureAutoInitComponentsCreated();
+
+	CMultiThreadingComponentTest parallelComposition(NULL, true);
+	parallelComposition.SetParallelInstantiationEnabled(true, 4);
+	QVERIFY(parallelComposition.IsParallelInstantiationEnabled());
+	parallelComposition.EnsureAutoInitComponentsCreated();
+
+	// both compositions must provide the same set of interfaces
+	QVERIFY(serialComposition.GetInterface<iprm::ISelectionParam>("Selection") != nullptr);
+	QVERIFY(parallelComposition.GetInterface<iprm::ISelectionParam>("Selection") != nullptr);
+	QVERIFY(parallelComposition.GetInterface<iprm::ISelectionParam>("SelectionWithConstraints") != nullptr);
+	QVERIFY(parallelComposition.GetInterface<iprm::IOptionsManager>("SelectionConstraints") != nullptr);
+
+	// repeated initialization must be a no-op
+	int profileSize = parallelComposition.GetCreationProfile().size();
+	parallelComposition.EnsureAutoInitComponentsCreated();
+	QCOMPARE(parallelComposition.GetCreationProfile().size(), profileSize);
+}
+
+
+void CParallelInstantiationBenchmarkTest::CreationProfileTest()
+{
+	CMultiThreadingComponentTest serialComposition(NULL, true);
+	serialComposition.EnsureAutoInitComponentsCreated();
+
+	icomp::CCompositeComponent::CreationProfile serialProfile = serialComposition.GetCreationProfile();
+	QVERIFY(!serialProfile.isEmpty());
+	for (const icomp::CCompositeComponent::CreationProfileEntry& entry: serialProfile){
+		QVERIFY(!entry.componentId.isEmpty());
+		QVERIFY(entry.creationTime >= 0);
+		QCOMPARE(entry.dependencyLevel, -1);
+	}
+
+	CMultiThreadingComponentTest parallelComposition(NULL, true);
+	parallelComposition.SetParallelInstantiationEnabled(true);
+	parallelComposition.EnsureAutoInitComponentsCreated();
+
+	icomp::CCompositeComponent::CreationProfile parallelProfile = parallelComposition.GetCreationProfile();
+	QVERIFY(!parallelProfile.isEmpty());
+
+	bool isAnyLeveled = false;
+	for (const icomp::CCompositeComponent::CreationProfileEntry& entry: parallelProfile){
+		QVERIFY(!entry.componentId.isEmpty());
+		QVERIFY(entry.creationTime >= 0);
+		if (entry.dependencyLevel >= 0){
+			isAnyLeveled = true;
+		}
+	}
+
+	QVERIFY(isAnyLeveled);
+}
+
+
+void CParallelInstantiationBenchmarkTest::InstantiationBenchmark_data()
+{
+	QTest::addColumn<bool>("isParallel");
+
+	QTest::newRow("serial") << false;
+	QTest::newRow("parallel") << true;
+}
+
+
+void CParallelInstantiationBenchmarkTest::InstantiationBenchmark()
+{
+	QFETCH(bool, isParallel);
+
+	QBENCHMARK{
+		CMultiThreadingComponentTest composition(NULL, true);
+		composition.SetParallelInstantiationEnabled(isParallel);
+		composition.EnsureAutoInitComponentsCreated();
+	}
+}
+
+
+void CParallelInstantiationBenchmarkTest::cleanupTestCase()
+{
+}
+
+
+I_ADD_TEST(CParallelInstantiationBenchmarkTest);
+
+
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later OR GPL-2.0-or-later OR GPL-3.0-or-later OR LicenseRef-ACF-Commercial
+#pragma once
+
+
+// Qt includes
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+// ACF includes
+#include <itest/CStandardTestExecutor.h>
+#include <GeneratedFiles/MultiThreadingComponentTest/CMultiThreadingComponentTest.h>
+
+
+/**
+	Benchmark of the creation of auto-init components in serial and in parallel mode.
+*/
+class CParallelInstantiationBenchmarkTest: public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase();
+
+	void ParallelInstantiationTest();
+	void CreationProfileTest();
+	void InstantiationBenchmark_data();
+	void InstantiationBenchmark();
+
+	void cleanupTestCase();
+};
+
+
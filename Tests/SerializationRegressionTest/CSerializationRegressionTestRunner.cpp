@@ -452,7 +452,7 @@ bool CSerializationRegressionTestRunner::SaveReferenceData(const T& object, cons
 	// File archives don't have IsOpen() method - they throw exceptions on failure
 	
 	T temp = object;
-	return temp.Serialize(archive);
+	return temp.Serialize(archive) && archive.Close();
 }
 
 